@@ -13,12 +13,40 @@
 #ifndef BRICK_COMMON_REFERENCECOUNT_HH
 #define BRICK_COMMON_REFERENCECOUNT_HH
 
+#include <atomic>
 #include <cstddef>
 
+/**
+ ** If this macro is defined to a nonzero value, ReferenceCount
+ ** instances are thread-safe (see ReferenceCount::setThreadSafe())
+ ** by default.  The CMake option BRICK_THREADSAFE_REFERENCE_COUNT
+ ** sets it for the whole build.
+ **/
+#ifndef BRICK_COMMON_THREADSAFE_REFERENCECOUNT
+#define BRICK_COMMON_THREADSAFE_REFERENCECOUNT 0
+#endif
+
 namespace brick {
 
   namespace common {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // The count shared by all copies of a ReferenceCount instance.
+      // In thread-safe mode it is updated using atomic
+      // read-modify-write operations.  Otherwise it is updated using
+      // relaxed loads and stores, which compile to the same code as
+      // operations on a plain int.
+      struct ReferenceCountBlock {
+        std::atomic<int> count;
+        bool isThreadSafe;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** The ReferenceCount class provides a convenient way to track a
      ** shared resource so you know when to delete it.  ReferenceCount
@@ -98,8 +126,21 @@ namespace brick {
      ** this count until, when the very last copy is destroyed,
      ** m_vectorPtr will be deleted.
      **
-     ** One note regarding thread safety: if you use ReferenceCount as
-     ** a member of a class that is shared between threads, and this
+     ** By default, the count is not thread-safe: copies that share a
+     ** count must not be copied or destroyed concurrently by
+     ** different threads.  Calling setThreadSafe() (or building with
+     ** BRICK_COMMON_THREADSAFE_REFERENCECOUNT set to a nonzero value)
+     ** makes the count use atomic operations, so that copies sharing
+     ** it can be freely created and destroyed by different threads.
+     ** In this mode, use release() rather than isShared() to decide
+     ** whether to delete the shared resource, since the answer from
+     ** isShared() may be out of date as soon as it is returned.  Note
+     ** that this protects only the count, not the shared resource or
+     ** the ReferenceCount instance itself.
+     **
+     ** One further note regarding thread safety: if you use
+     ** ReferenceCount in non-thread-safe mode as a member of a class
+     ** that is shared between threads, and this
      ** class manages its own mutex locking (such as
      ** brick::thread::Monitor), construction and destruction of the
      ** members of the containing class will most likely happen
@@ -130,10 +171,16 @@ namespace brick {
        * should be set to 1.  Setting this argument to zero indicates
        * that no reference counting should be done (until a subsequent
        * call to the reset() method).
+       *
+       * @param isThreadSafe This argument specifies whether the count
+       * should be updated using atomic operations.  See
+       * setThreadSafe().
        */
-      ReferenceCount(size_t count=1)
+      ReferenceCount(size_t count=1,
+                     bool isThreadSafe=(
+                       BRICK_COMMON_THREADSAFE_REFERENCECOUNT != 0))
         : m_countPtr(0) {
-        this->reset(count);
+        this->reset(count, isThreadSafe);
       }
 
 
@@ -152,13 +199,26 @@ namespace brick {
       }
 
 
+      /**
+       * The move constructor takes over the count of its argument,
+       * leaving the argument in the uncounted state.  The count is
+       * not changed, so this costs no atomic operations, even in
+       * thread-safe mode.
+       *
+       * @param other The ReferenceCount instance to be moved from.
+       */
+      ReferenceCount(ReferenceCount&& other) noexcept
+        : m_countPtr(other.m_countPtr) {
+        other.m_countPtr = 0;
+      }
+
+
       /**
        * Decrements the count (if the ReferenceCount instance is in
        * the counted state) and destroys the ReferenceCount instance.
        */
       ~ReferenceCount() {
-        --(*this);
-        this->deleteIfNecessary();
+        this->release();
       }
 
 
@@ -171,7 +231,7 @@ namespace brick {
        */
       ReferenceCount&
       operator++() {
-        if(m_countPtr != 0) {++(*m_countPtr);}
+        this->increment(1);
         return *this;
       }
 
@@ -196,7 +256,7 @@ namespace brick {
        */
       ReferenceCount&
       operator--() {
-        if(m_countPtr != 0) {--(*m_countPtr);}
+        this->decrement(1);
         return *this;
       }
 
@@ -221,7 +281,7 @@ namespace brick {
        */
       ReferenceCount&
       operator+=(size_t offset) {
-        if(m_countPtr != 0) {(*m_countPtr) += offset;}
+        this->increment(static_cast<int>(offset));
         return *this;
       }
 
@@ -235,7 +295,7 @@ namespace brick {
        */
       ReferenceCount&
       operator-=(size_t offset) {
-        if(m_countPtr != 0) {(*m_countPtr) -= offset;}
+        this->decrement(static_cast<int>(offset));
         return *this;
       }
 
@@ -256,8 +316,7 @@ namespace brick {
         // Check for self-assignment.
         if (this != &source) {
           // Release the count that was previously tracked by *this.
-          --(*this);
-          this->deleteIfNecessary();
+          this->release();
 
           // Adopt the new count and increment it.
           m_countPtr = source.m_countPtr;
@@ -267,6 +326,25 @@ namespace brick {
       }
 
 
+      /**
+       * The move assignment operator releases the count previously
+       * tracked by *this, then takes over the count of its argument,
+       * leaving the argument in the uncounted state.
+       *
+       * @param source The ReferenceCount instance to be moved from.
+       * @return A reference to *this.
+       */
+      ReferenceCount&
+      operator=(ReferenceCount&& source) noexcept {
+        if (this != &source) {
+          this->release();
+          m_countPtr = source.m_countPtr;
+          source.m_countPtr = 0;
+        }
+        return *this;
+      }
+
+
       /**
        * This member function returns the current count if the
        * ReferenceCount instance is in the counted state, or 0
@@ -276,7 +354,11 @@ namespace brick {
        */
       int
       getCount() const {
-        if(this->isCounted()) {return *m_countPtr;}
+        if(this->isCounted()) {
+          return m_countPtr->count.load(
+            m_countPtr->isThreadSafe ? std::memory_order_acquire
+            : std::memory_order_relaxed);
+        }
         return 0;
       }
 
@@ -304,6 +386,45 @@ namespace brick {
       isShared() const {return (this->getCount() > 1);}
 
 
+      /**
+       * This member function returns true if the count is updated
+       * using atomic operations.  See setThreadSafe().
+       *
+       * @return true if *this is in the counted state, and the count
+       * is thread-safe.
+       */
+      bool
+      isThreadSafe() const {
+        return this->isCounted() && m_countPtr->isThreadSafe;
+      }
+
+
+      /**
+       * This member function decrements the count (if *this is in the
+       * counted state) and puts *this into the uncounted state.  It
+       * reports whether the reference held by *this was the last one,
+       * so that the caller can delete the shared resource.  Unlike a
+       * call to isShared() followed by destruction, this is safe even
+       * if other threads are releasing copies at the same time, as
+       * long as the count is thread-safe.
+       *
+       * @return true if *this was in the counted state, and no other
+       * ReferenceCount instances share the count.
+       */
+      bool
+      release() {
+        if(m_countPtr == 0) {
+          return false;
+        }
+        bool isLast = (this->decrement(1) <= 0);
+        if(isLast) {
+          delete m_countPtr;
+        }
+        m_countPtr = 0;
+        return isLast;
+      }
+
+
       /**
        * This member function decrements the count and releases the
        * reference, then reinitializes with a fresh count.  Use this
@@ -313,36 +434,82 @@ namespace brick {
        * @param count This argument specifies to what value the count
        * should be reinitialized.  For most applications, this argument
        * should be set to 1.
+       *
+       * @param isThreadSafe This argument specifies whether the new
+       * count should be updated using atomic operations.  See
+       * setThreadSafe().
        */
       void
-      reset(size_t count=1) {
-        --(*this);
-        this->deleteIfNecessary();
+      reset(size_t count=1,
+            bool isThreadSafe=(BRICK_COMMON_THREADSAFE_REFERENCECOUNT != 0)) {
+        this->release();
         if(count != 0) {
-          m_countPtr = new int;
-          *m_countPtr = count;
+          m_countPtr = new privateCode::ReferenceCountBlock;
+          m_countPtr->count.store(static_cast<int>(count),
+                                  std::memory_order_relaxed);
+          m_countPtr->isThreadSafe = isThreadSafe;
         }
       }
 
 
-    private:
-
       /**
-       * This member function deletes the internal count pointer
-       * pointer if no references remain, and (always) resets the
-       * pointer to 0.
+       * This member function selects whether the count (which is
+       * shared with all copies of *this) is updated using atomic
+       * operations.  Thread-safe counts cost an atomic
+       * read-modify-write each time a copy is made or destroyed, but
+       * allow copies to be made and destroyed by several threads at
+       * once.  The mode must be selected before the count is shared
+       * with other threads, for example before handing a copy of an
+       * array to a worker thread.  In the uncounted state, this
+       * member function has no effect.
+       *
+       * @param isThreadSafe This argument specifies whether the count
+       * should be thread-safe.
        */
-      void deleteIfNecessary() {
+      void
+      setThreadSafe(bool isThreadSafe=true) {
         if(m_countPtr != 0) {
-          if((*m_countPtr) <= 0) {
-            delete m_countPtr;
+          m_countPtr->isThreadSafe = isThreadSafe;
+        }
+      }
+
+
+    private:
+
+      // Adds offset to the count, if *this is in the counted state.
+      void increment(int offset) {
+        if(m_countPtr != 0) {
+          if(m_countPtr->isThreadSafe) {
+            m_countPtr->count.fetch_add(offset, std::memory_order_relaxed);
+          } else {
+            m_countPtr->count.store(
+              m_countPtr->count.load(std::memory_order_relaxed) + offset,
+              std::memory_order_relaxed);
           }
-          m_countPtr = 0;
         }
       }
 
 
-      int* m_countPtr;
+      // Subtracts offset from the count, if *this is in the counted
+      // state, and returns the new count.  In thread-safe mode, the
+      // decrement both publishes this thread's writes to the shared
+      // resource and acquires those of other threads, so that the
+      // thread that sees the count reach zero can safely delete it.
+      int decrement(int offset) {
+        if(m_countPtr == 0) {
+          return 0;
+        }
+        if(m_countPtr->isThreadSafe) {
+          return m_countPtr->count.fetch_sub(
+            offset, std::memory_order_acq_rel) - offset;
+        }
+        int count = m_countPtr->count.load(std::memory_order_relaxed) - offset;
+        m_countPtr->count.store(count, std::memory_order_relaxed);
+        return count;
+      }
+
+
+      privateCode::ReferenceCountBlock* m_countPtr;
     };
 
   } // namespace common
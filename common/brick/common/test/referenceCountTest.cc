@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include <limits>
+#include <thread>
 #include <vector>
 #include <brick/common/referenceCount.hh>
 #include <brick/common/types.hh>
@@ -150,6 +151,109 @@ namespace brick {
       return true;
     }
 
+
+
+    bool
+    testRelease()
+    {
+      std::cout << "Testing ReferenceCount::release()..." << std::endl;
+
+      ReferenceCount count0(0);
+      if(count0.release()) {
+        return false;
+      }
+
+      ReferenceCount count1(1);
+      ReferenceCount count2(count1);
+      if(count2.release()) {
+        return false;
+      }
+      if(!checkState(count2, false, false, 0)) {
+        return false;
+      }
+      if(!checkState(count1, true, false, 1)) {
+        return false;
+      }
+      if(!count1.release()) {
+        return false;
+      }
+      if(!checkState(count1, false, false, 0)) {
+        return false;
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
+
+    void
+    copyRepeatedly(ReferenceCount const* countPtr, int* numberOfLastPtr)
+    {
+      for(int ii = 0; ii < 100000; ++ii) {
+        ReferenceCount count0(*countPtr);
+        ReferenceCount count1;
+        count1 = count0;
+        if(count0.release()) {
+          ++(*numberOfLastPtr);
+        }
+      }
+    }
+
+
+    bool
+    testThreadSafe()
+    {
+      std::cout << "Testing ReferenceCount::setThreadSafe()..." << std::endl;
+
+      ReferenceCount count0(0);
+      count0.setThreadSafe();
+      if(count0.isThreadSafe()) {
+        return false;
+      }
+
+      ReferenceCount count1(1, false);
+      ReferenceCount count2(count1);
+      if(count2.isThreadSafe()) {
+        return false;
+      }
+      count1.setThreadSafe();
+      if(!count2.isThreadSafe()) {
+        return false;
+      }
+      count2.release();
+
+      ReferenceCount count3(1, true);
+      if(!count3.isThreadSafe()) {
+        return false;
+      }
+      count3.reset(1, false);
+      if(count3.isThreadSafe()) {
+        return false;
+      }
+
+      // Copies made and destroyed concurrently must balance, and
+      // none of them may be mistaken for the last reference.
+      const int numberOfThreads = 4;
+      std::vector<std::thread> threads;
+      std::vector<int> numberOfLast(numberOfThreads, 0);
+      for(int ii = 0; ii < numberOfThreads; ++ii) {
+        threads.push_back(
+          std::thread(copyRepeatedly, &count1, &(numberOfLast[ii])));
+      }
+      for(int ii = 0; ii < numberOfThreads; ++ii) {
+        threads[ii].join();
+        if(numberOfLast[ii] != 0) {
+          return false;
+        }
+      }
+      if(!checkState(count1, true, false, 1)) {
+        return false;
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
   } // namespace common
 
 } // namespace brick
@@ -162,5 +266,7 @@ int main(int, char**)
   result &= brick::common::testConstructor();
   result &= brick::common::testCopyConstructor();
   result &= brick::common::testDestructor();
+  result &= brick::common::testRelease();
+  result &= brick::common::testThreadSafe();
   return (result ? 0 : 1);
 }
@@ -0,0 +1,197 @@
+/**
+***************************************************************************
+* @file threadPoolTest.cc
+*
+* Source file defining tests for the ThreadPool class.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <brick/common/threadPool.hh>
+
+namespace brick {
+
+  namespace common {
+
+    // We don't want to introduce a dependency on non-brick code for
+    // unit testing, and the brick::test library is not available in
+    // this context, so we just hack up some test functions.
+
+
+    bool
+    testConstructor()
+    {
+      std::cout << "Testing ThreadPool::ThreadPool()..." << std::endl;
+
+      ThreadPool pool0(1);
+      if(pool0.getNumberOfThreads() != 1) {
+        return false;
+      }
+
+      ThreadPool pool1(3);
+      if(pool1.getNumberOfThreads() != 3) {
+        return false;
+      }
+
+      ThreadPool pool2;
+      if(pool2.getNumberOfThreads() < 1) {
+        return false;
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
+
+    bool
+    testParallelFor()
+    {
+      std::cout << "Testing ThreadPool::parallelFor()..." << std::endl;
+
+      for(std::size_t numberOfThreads = 1; numberOfThreads < 6;
+          ++numberOfThreads) {
+        ThreadPool pool(numberOfThreads);
+
+        // Repeat several times to make sure the pool can be reused.
+        for(std::size_t trial = 0; trial < 20; ++trial) {
+          std::size_t const numberOfTasks = 1 + trial * 7;
+          std::vector<std::size_t> visitCounts(numberOfTasks, 0);
+          pool.parallelFor(
+            numberOfTasks, [&](std::size_t index) {++(visitCounts[index]);});
+          for(std::size_t ii = 0; ii < numberOfTasks; ++ii) {
+            if(visitCounts[ii] != 1) {
+              return false;
+            }
+          }
+        }
+
+        // Zero tasks should be a no-op.
+        pool.parallelFor(0, [](std::size_t) {throw std::logic_error("");});
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
+
+    bool
+    testNestedParallelFor()
+    {
+      std::cout << "Testing nested ThreadPool::parallelFor()..." << std::endl;
+
+      ThreadPool pool(4);
+      std::vector<std::size_t> visitCounts(64, 0);
+      pool.parallelFor(
+        8, [&](std::size_t outer) {
+          pool.parallelFor(
+            8, [&](std::size_t inner) {
+              ++(visitCounts[outer * 8 + inner]);});
+        });
+      for(std::size_t ii = 0; ii < visitCounts.size(); ++ii) {
+        if(visitCounts[ii] != 1) {
+          return false;
+        }
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
+
+    bool
+    testExceptions()
+    {
+      std::cout << "Testing ThreadPool exception propagation..." << std::endl;
+
+      // A single-thread pool runs tasks serially, but should handle
+      // exceptions just like a multi-thread pool: every task still
+      // runs, and then the first exception is rethrown.
+      for(std::size_t numberOfThreads = 1; numberOfThreads <= 4;
+          numberOfThreads += 3) {
+        ThreadPool pool(numberOfThreads);
+        std::vector<std::size_t> visitCounts(100, 0);
+        std::string message;
+        try {
+          pool.parallelFor(
+            100, [&](std::size_t index) {
+              ++(visitCounts[index]);
+              if(index == 37) {throw std::runtime_error("task 37");}
+              if(index == 52) {throw std::runtime_error("task 52");}
+            });
+        } catch(std::runtime_error const& caughtException) {
+          message = caughtException.what();
+        }
+        if(message.empty()) {
+          return false;
+        }
+        if(numberOfThreads == 1 && message != "task 37") {
+          return false;
+        }
+        for(std::size_t ii = 0; ii < visitCounts.size(); ++ii) {
+          if(visitCounts[ii] != 1) {
+            return false;
+          }
+        }
+
+        // The pool should still be usable after an exception.
+        visitCounts.assign(10, 0);
+        pool.parallelFor(
+          10, [&](std::size_t index) {++(visitCounts[index]);});
+        for(std::size_t ii = 0; ii < visitCounts.size(); ++ii) {
+          if(visitCounts[ii] != 1) {
+            return false;
+          }
+        }
+      }
+
+      // Nested calls also run serially.
+      ThreadPool pool(4);
+      std::vector<std::size_t> visitCounts(64, 0);
+      bool caughtException = false;
+      try {
+        pool.parallelFor(
+          8, [&](std::size_t outer) {
+            pool.parallelFor(
+              8, [&](std::size_t inner) {
+                ++(visitCounts[outer * 8 + inner]);
+                if(inner == 0) {throw std::runtime_error("inner");}
+              });
+          });
+      } catch(std::runtime_error const&) {
+        caughtException = true;
+      }
+      if(!caughtException) {
+        return false;
+      }
+      for(std::size_t ii = 0; ii < visitCounts.size(); ++ii) {
+        if(visitCounts[ii] != 1) {
+          return false;
+        }
+      }
+
+      // If we get this far, then all is well.
+      return true;
+    }
+
+  } // namespace common
+
+} // namespace brick
+
+
+// int main(int argc, char** argv)
+int main(int, char**)
+{
+  bool result = true;
+  result &= brick::common::testConstructor();
+  result &= brick::common::testParallelFor();
+  result &= brick::common::testNestedParallelFor();
+  result &= brick::common::testExceptions();
+  return (result ? 0 : 1);
+}
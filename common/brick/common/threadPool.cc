@@ -0,0 +1,200 @@
+/**
+***************************************************************************
+* @file brick/common/threadPool.cc
+*
+* Source file defining the ThreadPool class.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#include <brick/common/threadPool.hh>
+
+namespace {
+
+  // Set while the current thread is executing a ThreadPool task, so
+  // that nested calls to ThreadPool::run() can fall back to serial
+  // execution instead of deadlocking.
+  thread_local bool t_isInsideTask = false;
+
+
+  // Restores t_isInsideTask on scope exit, even if a task throws.
+  class InsideTaskGuard {
+  public:
+    InsideTaskGuard() : m_previousValue(t_isInsideTask) {
+      t_isInsideTask = true;
+    }
+    ~InsideTaskGuard() {t_isInsideTask = m_previousValue;}
+  private:
+    bool m_previousValue;
+  };
+
+} // namespace
+
+
+namespace brick {
+
+  namespace common {
+
+    ThreadPool::
+    ThreadPool(std::size_t numberOfThreads)
+      : m_workers(),
+        m_runMutex(),
+        m_mutex(),
+        m_workAvailableCondition(),
+        m_workDoneCondition(),
+        m_taskPtr(0),
+        m_numberOfTasks(0),
+        m_nextTask(0),
+        m_tasksRemaining(0),
+        m_generation(0),
+        m_isShuttingDown(false),
+        m_exceptionPtr()
+    {
+      if(numberOfThreads == 0) {
+        numberOfThreads = std::thread::hardware_concurrency();
+        if(numberOfThreads == 0) {
+          numberOfThreads = 1;
+        }
+      }
+      m_workers.reserve(numberOfThreads - 1);
+      for(std::size_t ii = 1; ii < numberOfThreads; ++ii) {
+        m_workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+      }
+    }
+
+
+    ThreadPool::
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+      }
+      m_workAvailableCondition.notify_all();
+      for(std::size_t ii = 0; ii < m_workers.size(); ++ii) {
+        m_workers[ii].join();
+      }
+    }
+
+
+    void
+    ThreadPool::
+    run(std::size_t numberOfTasks,
+        std::function<void (std::size_t)> const& task)
+    {
+      if(numberOfTasks == 0) {
+        return;
+      }
+
+      // Serial fallback for single-threaded pools, trivial jobs, and
+      // nested calls.  Exceptions are handled just as they are by
+      // processTasks(), so that behavior doesn't depend on the
+      // number of threads.
+      if(m_workers.empty() || numberOfTasks == 1 || t_isInsideTask) {
+        std::exception_ptr exceptionPtr;
+        InsideTaskGuard guard;
+        for(std::size_t ii = 0; ii < numberOfTasks; ++ii) {
+          try {
+            task(ii);
+          } catch(...) {
+            if(!exceptionPtr) {
+              exceptionPtr = std::current_exception();
+            }
+          }
+        }
+        if(exceptionPtr) {
+          std::rethrow_exception(exceptionPtr);
+        }
+        return;
+      }
+
+      // Only one job at a time may occupy the workers.
+      std::lock_guard<std::mutex> runLock(m_runMutex);
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_taskPtr = &task;
+      m_numberOfTasks = numberOfTasks;
+      m_nextTask = 0;
+      m_tasksRemaining = numberOfTasks;
+      m_exceptionPtr = std::exception_ptr();
+      ++m_generation;
+      m_workAvailableCondition.notify_all();
+
+      // The calling thread helps out, then waits for stragglers.
+      this->processTasks(lock);
+      while(m_tasksRemaining != 0) {
+        m_workDoneCondition.wait(lock);
+      }
+      m_taskPtr = 0;
+
+      std::exception_ptr exceptionPtr = m_exceptionPtr;
+      m_exceptionPtr = std::exception_ptr();
+      lock.unlock();
+      if(exceptionPtr) {
+        std::rethrow_exception(exceptionPtr);
+      }
+    }
+
+
+    ThreadPool&
+    ThreadPool::
+    getDefault()
+    {
+      static ThreadPool defaultPool(0);
+      return defaultPool;
+    }
+
+
+    // This member function must be called with m_mutex locked (via
+    // argument lock), and returns with m_mutex locked.
+    void
+    ThreadPool::
+    processTasks(std::unique_lock<std::mutex>& lock)
+    {
+      while(m_nextTask < m_numberOfTasks) {
+        std::size_t taskIndex = m_nextTask;
+        ++m_nextTask;
+        std::function<void (std::size_t)> const* taskPtr = m_taskPtr;
+        lock.unlock();
+        try {
+          InsideTaskGuard guard;
+          (*taskPtr)(taskIndex);
+        } catch(...) {
+          lock.lock();
+          if(!m_exceptionPtr) {
+            m_exceptionPtr = std::current_exception();
+          }
+          lock.unlock();
+        }
+        lock.lock();
+        --m_tasksRemaining;
+        if(m_tasksRemaining == 0) {
+          m_workDoneCondition.notify_all();
+        }
+      }
+    }
+
+
+    void
+    ThreadPool::
+    workerLoop()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      std::size_t lastGeneration = 0;
+      while(true) {
+        while(!m_isShuttingDown && m_generation == lastGeneration) {
+          m_workAvailableCondition.wait(lock);
+        }
+        if(m_isShuttingDown) {
+          return;
+        }
+        lastGeneration = m_generation;
+        this->processTasks(lock);
+      }
+    }
+
+  } // namespace common
+
+} // namespace brick
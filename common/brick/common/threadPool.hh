@@ -0,0 +1,167 @@
+/**
+***************************************************************************
+* @file brick/common/threadPool.hh
+*
+* Header file declaring the ThreadPool class.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_COMMON_THREADPOOL_HH
+#define BRICK_COMMON_THREADPOOL_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace brick {
+
+  namespace common {
+
+    /**
+     ** The ThreadPool class keeps a fixed set of worker threads
+     ** alive so that data-parallel loops can be dispatched without
+     ** paying for thread creation on every call.  Work is submitted
+     ** as a number of independent tasks, each identified by its
+     ** index, and the calling thread participates in the work.
+     ** Tasks are handed out in no particular order, so callers that
+     ** need deterministic results should write each task's output to
+     ** its own storage and combine the results after parallelFor()
+     ** returns.  Here's an example:
+     **
+     ** @code
+     **   ThreadPool threadPool(4);
+     **   std::vector<double> partialSums(numberOfBands, 0.0);
+     **   threadPool.parallelFor(
+     **     numberOfBands,
+     **     [&](size_t band) {partialSums[band] = sumBand(band);});
+     **   double total = std::accumulate(
+     **     partialSums.begin(), partialSums.end(), 0.0);
+     ** @endcode
+     **
+     ** Calls to parallelFor() from within a running task are legal,
+     ** and simply execute serially in the calling thread.
+     **/
+    class ThreadPool {
+    public:
+
+      /**
+       * The constructor starts the worker threads.
+       *
+       * @param numberOfThreads This argument specifies how many
+       * threads (including the thread that calls parallelFor()) will
+       * share the work.  Setting this argument to 0 selects the
+       * number of hardware threads reported by the system.  Setting
+       * it to 1 makes parallelFor() run serially, with no worker
+       * threads at all.
+       */
+      explicit
+      ThreadPool(std::size_t numberOfThreads = 0);
+
+
+      /**
+       * The destructor waits for the worker threads to finish and
+       * then destroys them.
+       */
+      ~ThreadPool();
+
+
+      /**
+       * This member function returns the number of threads that
+       * share the work of each parallelFor() call, including the
+       * calling thread.
+       *
+       * @return The return value is always greater than zero.
+       */
+      std::size_t
+      getNumberOfThreads() const {return m_workers.size() + 1;}
+
+
+      /**
+       * This member function calls functor(ii) once for each ii in
+       * [0, numberOfTasks), distributing the calls across the
+       * threads of the pool, and returns when all calls have
+       * completed.  If any call throws, the remaining tasks are
+       * still run, and then the first exception caught is rethrown
+       * in the calling thread.
+       *
+       * @param numberOfTasks This argument specifies how many times
+       * functor should be called.
+       *
+       * @param functor This argument is the callable to be run.  It
+       * must be safe to call concurrently from multiple threads.
+       */
+      template <class Functor>
+      void
+      parallelFor(std::size_t numberOfTasks, Functor const& functor) {
+        std::function<void (std::size_t)> task(std::cref(functor));
+        this->run(numberOfTasks, task);
+      }
+
+
+      /**
+       * This member function is the non-template workhorse behind
+       * parallelFor().
+       *
+       * @param numberOfTasks This argument specifies how many times
+       * task should be called.
+       *
+       * @param task This argument is the callable to be run.
+       */
+      void
+      run(std::size_t numberOfTasks,
+          std::function<void (std::size_t)> const& task);
+
+
+      /**
+       * This static member function returns a ThreadPool instance
+       * that is shared by all callers in the process, and that uses
+       * every hardware thread.  It is constructed the first time
+       * it's requested.
+       *
+       * @return The return value is a reference to the shared pool.
+       */
+      static ThreadPool&
+      getDefault();
+
+    private:
+
+      // Not copyable.
+      ThreadPool(ThreadPool const&);
+      ThreadPool& operator=(ThreadPool const&);
+
+      void
+      processTasks(std::unique_lock<std::mutex>& lock);
+
+      void
+      workerLoop();
+
+
+      std::vector<std::thread> m_workers;
+
+      std::mutex m_runMutex;
+      std::mutex m_mutex;
+      std::condition_variable m_workAvailableCondition;
+      std::condition_variable m_workDoneCondition;
+
+      std::function<void (std::size_t)> const* m_taskPtr;
+      std::size_t m_numberOfTasks;
+      std::size_t m_nextTask;
+      std::size_t m_tasksRemaining;
+      std::size_t m_generation;
+      bool m_isShuttingDown;
+      std::exception_ptr m_exceptionPtr;
+    };
+
+  } // namespace common
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_COMMON_THREADPOOL_HH */
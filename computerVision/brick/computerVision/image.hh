@@ -13,6 +13,7 @@
 #ifndef BRICK_COMPUTERVISION_IMAGE_HH
 #define BRICK_COMPUTERVISION_IMAGE_HH
 
+#include <utility>
 #include <brick/computerVision/imageFormatTraits.hh>
 #include <brick/numeric/array2D.hh>
 #include <brick/numeric/index2D.hh>
@@ -112,6 +113,16 @@ namespace brick {
         : brick::numeric::Array2D<PixelType>(source) {}
 
 
+      /**
+       * The move constructor takes over the data of source, leaving
+       * source empty, without any reference count traffic.
+       *
+       * @param source The Image instance to be moved from.
+       */
+      Image(Image<FORMAT>&& source) noexcept
+        : brick::numeric::Array2D<PixelType>(std::move(source)) {}
+
+
       /**
        * This constructor allows us to implicitly make an Image instance
        * from an Array2D.  As with the copy constructor, the newly
@@ -123,6 +134,31 @@ namespace brick {
         : brick::numeric::Array2D<PixelType>(source) {}
 
 
+      /**
+       * This constructor allows us to implicitly make an Image
+       * instance from a temporary Array2D, such as the return value
+       * of numeric::correlate2D(), by taking over its data.
+       *
+       * @param source The Array2D instance to be moved from.
+       */
+      Image(brick::numeric::Array2D<PixelType>&& source) noexcept
+        : brick::numeric::Array2D<PixelType>(std::move(source)) {}
+
+
+      /**
+       * This constructor allows us to implicitly make an Image
+       * instance from an elementwise arithmetic expression, such as
+       * (image0 + image1).  The expression is evaluated into newly
+       * allocated memory.
+       *
+       * @param expression The expression to be evaluated.
+       */
+      template <class Derived>
+      Image(const brick::numeric::Array2DExpression<PixelType, Derived>&
+            expression)
+        : brick::numeric::Array2D<PixelType>(expression) {}
+
+
       /**
        * Construct an image around external data.  Images constructed in
        * this way will not implement reference counting, and will not
@@ -190,6 +226,20 @@ namespace brick {
       }
 
 
+      /**
+       * The move assignment operator takes over the data of source,
+       * leaving source empty.
+       *
+       * @param source The Image instance to be moved from.
+       */
+      Image<FORMAT>&
+      operator=(Image<FORMAT>&& source) noexcept
+      {
+          brick::numeric::Array2D<PixelType>::operator=(std::move(source));
+          return *this;
+      }
+
+
       /**
        * This copy assignment operator allows us to implicitly make an
        * Image instance from an Array2D.  As with the copy assignment
@@ -206,6 +256,37 @@ namespace brick {
       }
 
 
+      /**
+       * This move assignment operator takes over the data of a
+       * temporary Array2D, leaving source empty.
+       *
+       * @param source The Array2D instance to be moved from.
+       */
+      Image&
+      operator=(brick::numeric::Array2D<PixelType>&& source) noexcept
+      {
+          brick::numeric::Array2D<PixelType>::operator=(std::move(source));
+          return *this;
+      }
+
+
+      /**
+       * This assignment operator evaluates an elementwise arithmetic
+       * expression, such as (image0 + image1), into *this.  Please
+       * see Array2D::operator=(const Array2DExpression&) for details.
+       *
+       * @param expression The expression to be evaluated.
+       */
+      template <class Derived>
+      Image&
+      operator=(const brick::numeric::Array2DExpression<PixelType, Derived>&
+                expression)
+      {
+          brick::numeric::Array2D<PixelType>::operator=(expression);
+          return *this;
+      }
+
+
       /**
        * Returns an image that references only a rectangular region of
        * interest drawn from *this.  The returned image will reference
@@ -488,7 +488,10 @@ namespace brick {
       const typename ImageFormatTraits<OutputFormat>::PixelType fillValue,
       ConvolutionStrategy convolutionStrategy)
     {
-      Image<OutputFormat> returnImage(image.rows(), image.columns());
+      // The call below replaces the contents of returnImage with
+      // the (moved) result of correlate2D(), so there's no point in
+      // allocating it here.
+      Image<OutputFormat> returnImage;
       filter2D<OutputFormat, ImageFormat, KernelType>(
 	returnImage, kernel, image, fillValue, convolutionStrategy);
       return returnImage;
@@ -0,0 +1,453 @@
+/**
+***************************************************************************
+* @file brick/computerVision/imageWarper.cc
+*
+* Source file defining the fixed-point interpolation routines used by
+* the ImageWarper class template.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <brick/computerVision/imageWarper.hh>
+#include <brick/numeric/simdKernels.hh>
+
+// Pixels are interpolated using AVX2 only when building with GCC or
+// Clang for x86, which let us compile the AVX2 code without
+// requiring AVX2 for the rest of the library.
+#if (defined(__x86_64__) || defined(__i386__)) \
+  && defined(__GNUC__) && defined(__SSE2__)
+#define BRICK_COMPUTERVISION_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BRICK_COMPUTERVISION_SIMD_X86 0
+#endif
+
+namespace {
+
+  using brick::common::Int32;
+  using brick::common::UInt8;
+  using brick::common::UInt32;
+  using brick::computerVision::ImageWarperCompactSample;
+  using brick::computerVision::PixelRGB8;
+  using brick::computerVision::imageWarperOutOfBounds;
+
+  // Bilinear interpolation in fixed point.  The horizontal pass
+  // uses the full 16 bit xFraction and keeps 16 bits of the result
+  // (8 integer, 8 fractional).  The vertical pass drops one bit of
+  // yFraction so that its products fit in a signed 32-bit integer,
+  // which lets the AVX2 code below use exactly the same arithmetic.
+  inline UInt8
+  interpolate(Int32 p00, Int32 p01, Int32 p10, Int32 p11,
+              Int32 xFraction, Int32 yFraction)
+  {
+    Int32 top = (p00 << 16) + (p01 - p00) * xFraction;
+    Int32 bottom = (p10 << 16) + (p11 - p10) * xFraction;
+    top = (top + 128) >> 8;
+    bottom = (bottom + 128) >> 8;
+    Int32 value = (top << 15) + (bottom - top) * (yFraction >> 1);
+    return static_cast<UInt8>((value + (1 << 22)) >> 23);
+  }
+
+
+  void
+  warpGray8Scalar(ImageWarperCompactSample const* table,
+                  std::size_t begin, std::size_t end,
+                  UInt8 const* inputData, std::size_t inputColumns,
+                  UInt8* outputData, UInt8 defaultValue)
+  {
+    for(std::size_t ii = begin; ii < end; ++ii) {
+      ImageWarperCompactSample const& sample = table[ii];
+      if(sample.index00 & imageWarperOutOfBounds) {
+        outputData[ii] = defaultValue;
+        continue;
+      }
+      UInt8 const* topPtr = inputData + sample.index00;
+      UInt8 const* bottomPtr = topPtr + inputColumns;
+      outputData[ii] = interpolate(topPtr[0], topPtr[1],
+                                   bottomPtr[0], bottomPtr[1],
+                                   sample.xFraction, sample.yFraction);
+    }
+  }
+
+
+  void
+  warpRGB8Scalar(ImageWarperCompactSample const* table,
+                 std::size_t begin, std::size_t end,
+                 PixelRGB8 const* inputData, std::size_t inputColumns,
+                 PixelRGB8* outputData, PixelRGB8 const& defaultValue)
+  {
+    for(std::size_t ii = begin; ii < end; ++ii) {
+      ImageWarperCompactSample const& sample = table[ii];
+      if(sample.index00 & imageWarperOutOfBounds) {
+        outputData[ii] = defaultValue;
+        continue;
+      }
+      PixelRGB8 const* topPtr = inputData + sample.index00;
+      PixelRGB8 const* bottomPtr = topPtr + inputColumns;
+      PixelRGB8& outputPixel = outputData[ii];
+      outputPixel.red = interpolate(
+        topPtr[0].red, topPtr[1].red, bottomPtr[0].red, bottomPtr[1].red,
+        sample.xFraction, sample.yFraction);
+      outputPixel.green = interpolate(
+        topPtr[0].green, topPtr[1].green,
+        bottomPtr[0].green, bottomPtr[1].green,
+        sample.xFraction, sample.yFraction);
+      outputPixel.blue = interpolate(
+        topPtr[0].blue, topPtr[1].blue, bottomPtr[0].blue, bottomPtr[1].blue,
+        sample.xFraction, sample.yFraction);
+    }
+  }
+
+
+#if BRICK_COMPUTERVISION_SIMD_X86
+
+  // Loads eight table entries, returning their index00 members in
+  // indices, and their packed xFraction/yFraction members in
+  // fractions.
+  __attribute__((target("avx2"))) inline void
+  loadSamplesAVX2(ImageWarperCompactSample const* table,
+                  __m256i& indices, __m256i& fractions)
+  {
+    __m256 first = _mm256_loadu_ps(reinterpret_cast<float const*>(table));
+    __m256 second = _mm256_loadu_ps(
+      reinterpret_cast<float const*>(table + 4));
+    __m256 evens = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 odds = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+    indices = _mm256_permute4x64_epi64(
+      _mm256_castps_si256(evens), _MM_SHUFFLE(3, 1, 2, 0));
+    fractions = _mm256_permute4x64_epi64(
+      _mm256_castps_si256(odds), _MM_SHUFFLE(3, 1, 2, 0));
+  }
+
+
+  // Eight-lane version of interpolate(), except that yFraction must
+  // already have been shifted right by one bit.
+  __attribute__((target("avx2"))) inline __m256i
+  interpolateAVX2(__m256i p00, __m256i p01, __m256i p10, __m256i p11,
+                  __m256i xFraction, __m256i yFraction)
+  {
+    __m256i const horizontalRound = _mm256_set1_epi32(128);
+    __m256i const verticalRound = _mm256_set1_epi32(1 << 22);
+    __m256i top = _mm256_add_epi32(
+      _mm256_slli_epi32(p00, 16),
+      _mm256_mullo_epi32(_mm256_sub_epi32(p01, p00), xFraction));
+    __m256i bottom = _mm256_add_epi32(
+      _mm256_slli_epi32(p10, 16),
+      _mm256_mullo_epi32(_mm256_sub_epi32(p11, p10), xFraction));
+    top = _mm256_srai_epi32(_mm256_add_epi32(top, horizontalRound), 8);
+    bottom = _mm256_srai_epi32(_mm256_add_epi32(bottom, horizontalRound), 8);
+    __m256i value = _mm256_add_epi32(
+      _mm256_slli_epi32(top, 15),
+      _mm256_mullo_epi32(_mm256_sub_epi32(bottom, top), yFraction));
+    return _mm256_srli_epi32(_mm256_add_epi32(value, verticalRound), 23);
+  }
+
+
+  __attribute__((target("avx2"))) void
+  warpGray8AVX2(ImageWarperCompactSample const* table, std::size_t tableSize,
+                UInt8 const* inputData, std::size_t inputColumns,
+                UInt8* outputData, UInt8 defaultValue)
+  {
+    int const* basePtr = reinterpret_cast<int const*>(inputData);
+    __m256i const byteMask = _mm256_set1_epi32(0xff);
+    __m256i const xMask = _mm256_set1_epi32(0xffff);
+    __m256i const defaults = _mm256_set1_epi32(defaultValue);
+    __m256i const minusOne = _mm256_set1_epi32(-1);
+    __m256i const bottomOffset = _mm256_set1_epi32(
+      static_cast<int>(inputColumns) - 2);
+
+    std::size_t ii = 0;
+    for(; ii + 8 <= tableSize; ii += 8) {
+      __m256i indices;
+      __m256i fractions;
+      loadSamplesAVX2(table + ii, indices, fractions);
+
+      // Out-of-bounds entries have their sign bit set.  Only the
+      // in-bounds lanes are gathered, so out-of-bounds indices are
+      // never dereferenced.
+      __m256i inBounds = _mm256_cmpgt_epi32(indices, minusOne);
+
+      // One 32-bit load per row picks up both horizontal
+      // neighbors.  The bottom row load is shifted left by two
+      // bytes so that it never reads past the end of the image.
+      __m256i topWords = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), basePtr, indices, inBounds, 1);
+      __m256i bottomWords = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), basePtr,
+        _mm256_add_epi32(indices, bottomOffset), inBounds, 1);
+
+      __m256i p00 = _mm256_and_si256(topWords, byteMask);
+      __m256i p01 = _mm256_and_si256(_mm256_srli_epi32(topWords, 8), byteMask);
+      __m256i p10 = _mm256_and_si256(
+        _mm256_srli_epi32(bottomWords, 16), byteMask);
+      __m256i p11 = _mm256_srli_epi32(bottomWords, 24);
+      __m256i result = interpolateAVX2(
+        p00, p01, p10, p11, _mm256_and_si256(fractions, xMask),
+        _mm256_srli_epi32(fractions, 17));
+      result = _mm256_blendv_epi8(defaults, result, inBounds);
+
+      // Narrow to bytes.  Each 128-bit lane ends up holding its four
+      // results in its low 32 bits.
+      result = _mm256_packus_epi32(result, result);
+      result = _mm256_packus_epi16(result, result);
+      UInt32 low = static_cast<UInt32>(
+        _mm_cvtsi128_si32(_mm256_castsi256_si128(result)));
+      UInt32 high = static_cast<UInt32>(
+        _mm_cvtsi128_si32(_mm256_extracti128_si256(result, 1)));
+      std::memcpy(outputData + ii, &low, sizeof(low));
+      std::memcpy(outputData + ii + 4, &high, sizeof(high));
+    }
+    warpGray8Scalar(table, ii, tableSize, inputData, inputColumns,
+                    outputData, defaultValue);
+  }
+
+
+
+  // Interpolates one color channel of eight RGB8 pixels.  The
+  // arguments topIndices and bottomIndices are byte offsets of the
+  // first pixel of each pair.
+  __attribute__((target("avx2"))) inline __m256i
+  interpolateChannelAVX2(UInt8 const* channelPtr,
+                         __m256i topIndices, __m256i bottomIndices,
+                         __m256i inBounds,
+                         __m256i xFraction, __m256i yFraction)
+  {
+    // Each 32-bit load starts at the channel of interest in the left
+    // pixel, and ends at the same channel in the right pixel.
+    int const* basePtr = reinterpret_cast<int const*>(channelPtr);
+    __m256i const byteMask = _mm256_set1_epi32(0xff);
+    __m256i topWords = _mm256_mask_i32gather_epi32(
+      _mm256_setzero_si256(), basePtr, topIndices, inBounds, 1);
+    __m256i bottomWords = _mm256_mask_i32gather_epi32(
+      _mm256_setzero_si256(), basePtr, bottomIndices, inBounds, 1);
+    return interpolateAVX2(
+      _mm256_and_si256(topWords, byteMask), _mm256_srli_epi32(topWords, 24),
+      _mm256_and_si256(bottomWords, byteMask),
+      _mm256_srli_epi32(bottomWords, 24), xFraction, yFraction);
+  }
+
+
+  __attribute__((target("avx2"))) void
+  warpRGB8AVX2(ImageWarperCompactSample const* table, std::size_t tableSize,
+               PixelRGB8 const* inputData, std::size_t inputColumns,
+               PixelRGB8* outputData, PixelRGB8 const& defaultValue)
+  {
+    UInt8 const* bytePtr = reinterpret_cast<UInt8 const*>(inputData);
+    __m256i const xMask = _mm256_set1_epi32(0xffff);
+    __m256i const minusOne = _mm256_set1_epi32(-1);
+    __m256i const three = _mm256_set1_epi32(3);
+    __m256i const bottomOffset = _mm256_set1_epi32(
+      3 * static_cast<int>(inputColumns));
+    __m256i const redDefaults = _mm256_set1_epi32(defaultValue.red);
+    __m256i const greenDefaults = _mm256_set1_epi32(defaultValue.green);
+    __m256i const blueDefaults = _mm256_set1_epi32(defaultValue.blue);
+
+    std::size_t ii = 0;
+    for(; ii + 8 <= tableSize; ii += 8) {
+      __m256i indices;
+      __m256i fractions;
+      loadSamplesAVX2(table + ii, indices, fractions);
+      __m256i inBounds = _mm256_cmpgt_epi32(indices, minusOne);
+      __m256i topIndices = _mm256_mullo_epi32(indices, three);
+      __m256i bottomIndices = _mm256_add_epi32(topIndices, bottomOffset);
+      __m256i xFraction = _mm256_and_si256(fractions, xMask);
+      __m256i yFraction = _mm256_srli_epi32(fractions, 17);
+
+      __m256i red = _mm256_blendv_epi8(
+        redDefaults,
+        interpolateChannelAVX2(bytePtr, topIndices, bottomIndices,
+                               inBounds, xFraction, yFraction),
+        inBounds);
+      __m256i green = _mm256_blendv_epi8(
+        greenDefaults,
+        interpolateChannelAVX2(bytePtr + 1, topIndices, bottomIndices,
+                               inBounds, xFraction, yFraction),
+        inBounds);
+      __m256i blue = _mm256_blendv_epi8(
+        blueDefaults,
+        interpolateChannelAVX2(bytePtr + 2, topIndices, bottomIndices,
+                               inBounds, xFraction, yFraction),
+        inBounds);
+
+      // Interleaving three channels of 32-bit lanes into 24 bytes
+      // costs more shuffles than it saves, so go through memory.
+      Int32 reds[8];
+      Int32 greens[8];
+      Int32 blues[8];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(reds), red);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(greens), green);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(blues), blue);
+      PixelRGB8* outputPtr = outputData + ii;
+      for(unsigned int jj = 0; jj < 8; ++jj) {
+        outputPtr[jj].red = static_cast<UInt8>(reds[jj]);
+        outputPtr[jj].green = static_cast<UInt8>(greens[jj]);
+        outputPtr[jj].blue = static_cast<UInt8>(blues[jj]);
+      }
+    }
+    warpRGB8Scalar(table, ii, tableSize, inputData, inputColumns,
+                   outputData, defaultValue);
+  }
+
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+
+} // namespace
+
+
+namespace brick {
+
+  namespace computerVision {
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Magic number at the start of every lookup table file.
+      const char imageWarperFileMagic[8] = {
+        'B', 'R', 'K', 'W', 'A', 'R', 'P', '\0'};
+
+      // Written in native byte order, so that load() can detect
+      // files from machines with a different byte order.
+      const brick::common::UInt32 imageWarperByteOrderMark = 0x01020304U;
+
+
+      void
+      encodeImageWarperFileHeader(ImageWarperFileHeader const& header,
+                                  char* outputBuffer)
+      {
+        // Fields are copied one at a time so that the layout doesn't
+        // depend on struct padding.
+        std::memset(outputBuffer, 0, imageWarperFileHeaderSize);
+        std::memcpy(outputBuffer, imageWarperFileMagic, 8);
+        std::memcpy(outputBuffer + 8, &imageWarperByteOrderMark, 4);
+        std::memcpy(outputBuffer + 12, &header.version, 4);
+        std::memcpy(outputBuffer + 16, &header.tableFormat, 4);
+        std::memcpy(outputBuffer + 20, &header.numericDigits, 4);
+        std::memcpy(outputBuffer + 24, &header.entrySize, 4);
+        std::memcpy(outputBuffer + 32, &header.inputRows, 8);
+        std::memcpy(outputBuffer + 40, &header.inputColumns, 8);
+        std::memcpy(outputBuffer + 48, &header.outputRows, 8);
+        std::memcpy(outputBuffer + 56, &header.outputColumns, 8);
+        std::memcpy(outputBuffer + 64, &header.dataOffset, 8);
+      }
+
+
+      ImageWarperFileHeader
+      decodeImageWarperFileHeader(char const* inputBuffer,
+                                  std::size_t fileSize,
+                                  std::string const& fileName)
+      {
+        std::ostringstream message;
+        message << "File " << fileName;
+        if(fileSize < imageWarperFileHeaderSize
+           || std::memcmp(inputBuffer, imageWarperFileMagic, 8) != 0) {
+          message << " is not an ImageWarper lookup table file.";
+          BRICK_THROW(brick::common::IOException,
+                      "decodeImageWarperFileHeader()", message.str().c_str());
+        }
+        UInt32 byteOrderMark;
+        std::memcpy(&byteOrderMark, inputBuffer + 8, 4);
+        if(byteOrderMark != imageWarperByteOrderMark) {
+          message << " was written on a machine with a different byte order.";
+          BRICK_THROW(brick::common::IOException,
+                      "decodeImageWarperFileHeader()", message.str().c_str());
+        }
+
+        ImageWarperFileHeader header;
+        std::memcpy(&header.version, inputBuffer + 12, 4);
+        std::memcpy(&header.tableFormat, inputBuffer + 16, 4);
+        std::memcpy(&header.numericDigits, inputBuffer + 20, 4);
+        std::memcpy(&header.entrySize, inputBuffer + 24, 4);
+        std::memcpy(&header.inputRows, inputBuffer + 32, 8);
+        std::memcpy(&header.inputColumns, inputBuffer + 40, 8);
+        std::memcpy(&header.outputRows, inputBuffer + 48, 8);
+        std::memcpy(&header.outputColumns, inputBuffer + 56, 8);
+        std::memcpy(&header.dataOffset, inputBuffer + 64, 8);
+        if(header.version != imageWarperFileVersion) {
+          message << " has version " << header.version << ", but only version "
+                  << imageWarperFileVersion << " is supported.";
+          BRICK_THROW(brick::common::IOException,
+                      "decodeImageWarperFileHeader()", message.str().c_str());
+        }
+        if(header.tableFormat != BRICK_CV_WARPER_TABLE_FULL
+           && header.tableFormat != BRICK_CV_WARPER_TABLE_COMPACT) {
+          message << " has unrecognized table format "
+                  << header.tableFormat << ".";
+          BRICK_THROW(brick::common::IOException,
+                      "decodeImageWarperFileHeader()", message.str().c_str());
+        }
+
+        // Check the table size without risking overflow.
+        brick::common::UInt64 available =
+          (header.dataOffset < imageWarperFileHeaderSize
+           || header.dataOffset > fileSize)
+          ? 0 : fileSize - header.dataOffset;
+        brick::common::UInt64 maximumEntries =
+          (header.entrySize == 0) ? 0 : available / header.entrySize;
+        if(header.dataOffset < imageWarperFileHeaderSize
+           || header.dataOffset % 8 != 0
+           || (header.outputRows != 0
+               && header.outputColumns > maximumEntries / header.outputRows)) {
+          message << " is truncated or corrupt.";
+          BRICK_THROW(brick::common::IOException,
+                      "decodeImageWarperFileHeader()", message.str().c_str());
+        }
+        return header;
+      }
+
+
+      void
+      warpImageCompactGray8(ImageWarperCompactSample const* table,
+                            std::size_t tableSize,
+                            brick::common::UInt8 const* inputData,
+                            std::size_t /* inputRows */,
+                            std::size_t inputColumns,
+                            brick::common::UInt8* outputData,
+                            brick::common::UInt8 defaultValue)
+      {
+#if BRICK_COMPUTERVISION_SIMD_X86
+        if(numeric::getSimdLevel() == numeric::BRICK_SIMD_AVX2) {
+          warpGray8AVX2(table, tableSize, inputData, inputColumns,
+                        outputData, defaultValue);
+          return;
+        }
+#endif
+        warpGray8Scalar(table, 0, tableSize, inputData, inputColumns,
+                        outputData, defaultValue);
+      }
+
+
+      void
+      warpImageCompactRGB8(ImageWarperCompactSample const* table,
+                           std::size_t tableSize,
+                           PixelRGB8 const* inputData,
+                           std::size_t inputRows,
+                           std::size_t inputColumns,
+                           PixelRGB8* outputData,
+                           PixelRGB8 const& defaultValue)
+      {
+#if BRICK_COMPUTERVISION_SIMD_X86
+        // The gathers address the input in bytes using 32-bit
+        // signed offsets, and assume tightly packed pixels.
+        if(numeric::getSimdLevel() == numeric::BRICK_SIMD_AVX2
+           && sizeof(PixelRGB8) == 3
+           && 3 * inputRows * inputColumns < imageWarperOutOfBounds) {
+          warpRGB8AVX2(table, tableSize, inputData, inputColumns,
+                       outputData, defaultValue);
+          return;
+        }
+#endif
+        warpRGB8Scalar(table, 0, tableSize, inputData, inputColumns,
+                       outputData, defaultValue);
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+  } // namespace computerVision
+
+} // namespace brick
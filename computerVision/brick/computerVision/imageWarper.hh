@@ -13,13 +13,134 @@
 #ifndef BRICK_COMPUTERVISION_IMAGEWARPER_HH
 #define BRICK_COMPUTERVISION_IMAGEWARPER_HH
 
+#include <cstddef>
+#include <string>
+#include <brick/common/threadPool.hh>
+#include <brick/common/types.hh>
 #include <brick/computerVision/image.hh>
 #include <brick/numeric/array2D.hh>
+#include <brick/numeric/vector2D.hh>
+#include <brick/portability/memoryMappedFile.hh>
 
 namespace brick {
 
   namespace computerVision {
 
+    /**
+     * This enum lists the lookup table formats supported by
+     * ImageWarper.
+     */
+    enum ImageWarperTableFormat {
+      /** Each table entry holds four NumericType interpolation
+          weights, the index of the upper-left input pixel, and a flag
+          indicating whether the input coordinate is in bounds. */
+      BRICK_CV_WARPER_TABLE_FULL,
+
+      /** Each table entry holds a 32-bit input pixel index and two
+          16-bit fixed-point fractional offsets, for a total of 8
+          bytes.  See ImageWarperCompactSample. */
+      BRICK_CV_WARPER_TABLE_COMPACT
+    };
+
+
+    /**
+     ** This struct is one entry of an ImageWarper lookup table in
+     ** BRICK_CV_WARPER_TABLE_COMPACT format.  Member index00 is the
+     ** index of the upper-left of the four input pixels that
+     ** contribute to the output pixel, or has its high bit set
+     ** (imageWarperOutOfBounds) if the output pixel maps to a point
+     ** outside the input image.  Members xFraction and yFraction are
+     ** the fractional parts of the input coordinate, scaled by 2^16.
+     **/
+    struct ImageWarperCompactSample {
+      brick::common::UInt32 index00;
+      brick::common::UInt16 xFraction;
+      brick::common::UInt16 yFraction;
+    };
+
+
+    /**
+     * Entries of a BRICK_CV_WARPER_TABLE_COMPACT lookup table that
+     * map outside the input image have this bit set in their
+     * index00 member.  It follows that compact tables can only be
+     * used with input images of fewer than 2^31 pixels.
+     */
+    const brick::common::UInt32 imageWarperOutOfBounds = 0x80000000U;
+
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Contents of the fixed-size header at the start of files
+      // written by ImageWarper::save().  The table entries follow,
+      // starting at dataOffset, in native byte order.
+      struct ImageWarperFileHeader {
+        brick::common::UInt32 version;
+        brick::common::UInt32 tableFormat;
+        brick::common::UInt32 numericDigits;
+        brick::common::UInt32 entrySize;
+        brick::common::UInt64 inputRows;
+        brick::common::UInt64 inputColumns;
+        brick::common::UInt64 outputRows;
+        brick::common::UInt64 outputColumns;
+        brick::common::UInt64 dataOffset;
+      };
+
+
+      // Size of the encoded header, which is also where the table
+      // entries start.  It's a multiple of the cache line size so
+      // that entries are well aligned when the file is mapped.
+      const std::size_t imageWarperFileHeaderSize = 128;
+
+
+      // Increment this whenever the file format changes.
+      const brick::common::UInt32 imageWarperFileVersion = 1;
+
+
+      // Encode header into imageWarperFileHeaderSize bytes, starting
+      // at outputBuffer.  Defined in imageWarper.cc.
+      void
+      encodeImageWarperFileHeader(ImageWarperFileHeader const& header,
+                                  char* outputBuffer);
+
+
+      // Decode the header at the start of a file of fileSize bytes,
+      // throwing IOException if the magic number, version, or byte
+      // order is wrong, or if the file is too short to hold the
+      // table.  Argument inputBuffer must point to at least
+      // imageWarperFileHeaderSize bytes.  Defined in imageWarper.cc.
+      ImageWarperFileHeader
+      decodeImageWarperFileHeader(char const* inputBuffer,
+                                  std::size_t fileSize,
+                                  std::string const& fileName);
+
+
+      // Warp GRAY8 images using a compact table.  These use AVX2,
+      // if available, and are defined in imageWarper.cc.  Both give
+      // identical results regardless of SIMD level.
+      void
+      warpImageCompactGray8(ImageWarperCompactSample const* table,
+                            std::size_t tableSize,
+                            brick::common::UInt8 const* inputData,
+                            std::size_t inputRows,
+                            std::size_t inputColumns,
+                            brick::common::UInt8* outputData,
+                            brick::common::UInt8 defaultValue);
+
+
+      // Same as warpImageCompactGray8(), but for RGB8 images.
+      void
+      warpImageCompactRGB8(ImageWarperCompactSample const* table,
+                           std::size_t tableSize,
+                           PixelRGB8 const* inputData,
+                           std::size_t inputRows,
+                           std::size_t inputColumns,
+                           PixelRGB8* outputData,
+                           PixelRGB8 const& defaultValue);
+
+    } // namespace privateCode
+    /// @endcond
+
     /**
      ** This class does lookup-table-based warping of images.  Image
      ** resampling is done using bilinear interpolation.
@@ -33,6 +154,33 @@ namespace brick {
      ** which the output pixel should take it's color.  It must take a
      ** single Vector2D<NumericType> instance as its argument, and
      ** return a Vector2D<NumericType> instance.
+     **
+     ** By default, the lookup table holds four NumericType weights
+     ** per output pixel, which makes it large (about 90MB for a
+     ** 1920x1080 output image with NumericType = double), and makes
+     ** warpImage() memory-bandwidth bound.  Passing
+     ** BRICK_CV_WARPER_TABLE_COMPACT to the constructor selects an 8
+     ** byte per pixel table format that stores the interpolation
+     ** weights in 16-bit fixed point.  With a compact table, GRAY8 to
+     ** GRAY8 and RGB8 to RGB8 warps are done in integer arithmetic,
+     ** using AVX2 where available (see
+     ** brick::numeric::getSimdLevel()), and round to the nearest
+     ** output value.
+     **
+     ** Building the lookup table means calling the transform functor
+     ** once for every output pixel, which can take seconds for
+     ** expensive transforms, such as reverse projection through
+     ** CameraIntrinsicsPlumbBob.  The constructor can spread this
+     ** work across the threads of a ThreadPool.  It can also
+     ** evaluate the transform only on a coarse grid, filling in the
+     ** remaining pixels by bilinear interpolation, wherever doing so
+     ** stays within a caller-specified error bound.
+     **
+     ** Member function warpImage() processes the output image in
+     ** tiles (see setTileSize()), so that input pixels fetched for
+     ** one output row are reused by the next, even for strongly
+     ** rotated warps.  Horizontal bands of tiles can be processed in
+     ** parallel using a ThreadPool (see setThreadPool()).
      **/
     template <class NumericType, class TransformFunctor>
     class ImageWarper
@@ -68,10 +216,48 @@ namespace brick {
        * @param transformer This argument is a functor that defines
        * the warp.  Please see the documentation for class ImageWarper
        * for more information.
+       *
+       * @param tableFormat This argument specifies how the lookup
+       * table should be stored.  If it is
+       * BRICK_CV_WARPER_TABLE_COMPACT, the input image must have
+       * fewer than 2^31 pixels.
+       *
+       * @param threadPoolPtr If this argument is not 0, the lookup
+       * table is built in horizontal bands, using the threads of the
+       * specified ThreadPool.  Each band works with its own copy of
+       * transformer, so copies of transformer must be safe to call
+       * concurrently.  The resulting table does not depend on the
+       * number of threads.
+       *
+       * @param maximumError If this argument is greater than zero,
+       * the transform is evaluated only at the corners of a grid of
+       * gridSpacing x gridSpacing pixel cells, and the input
+       * coordinates of the remaining pixels in each cell are
+       * bilinearly interpolated from the corners.  Before
+       * interpolating a cell, the transform is evaluated at the
+       * center of the cell and at the midpoint of each edge, and the
+       * interpolation error there is used to bound the error over
+       * the whole cell.  This bound is exact for transforms that are
+       * quadratic over the cell, and a close estimate for smooth
+       * transforms.  Cells for which it exceeds maximumError (in
+       * input pixels), or for which the transform returns a
+       * non-finite coordinate, are evaluated exactly at every
+       * pixel.  If this argument is zero, every pixel is evaluated
+       * exactly.
+       *
+       * @param gridSpacing This argument sets the size of the grid
+       * cells used when maximumError is greater than zero, and the
+       * height of the bands processed by each thread.  It must be
+       * greater than zero.
        */
       ImageWarper(size_t inputRows, size_t inputColumns,
                   size_t outputRows, size_t outputColumns,
-                  TransformFunctor transformer);
+                  TransformFunctor transformer,
+                  ImageWarperTableFormat tableFormat
+                  = BRICK_CV_WARPER_TABLE_FULL,
+                  brick::common::ThreadPool* threadPoolPtr = 0,
+                  NumericType maximumError = NumericType(0),
+                  size_t gridSpacing = 16);
 
 
       /**
@@ -82,6 +268,62 @@ namespace brick {
       ~ImageWarper();
 
 
+      /**
+       * This member function reports which lookup table format is
+       * in use.
+       *
+       * @return The return value is the tableFormat argument passed
+       * to the constructor, or the format of the table read by
+       * load().
+       */
+      ImageWarperTableFormat
+      getTableFormat() const {return m_tableFormat;}
+
+
+      /**
+       * This member function replaces the lookup table with one
+       * previously written by save(), so that the (possibly slow)
+       * transform functor need not be evaluated again.  The file
+       * format is versioned, and stores the table in native byte
+       * order, so files can only be loaded on machines with the same
+       * byte order as the one that saved them.  Tables in
+       * BRICK_CV_WARPER_TABLE_FULL format can only be loaded by
+       * ImageWarper instances with the same NumericType as the one
+       * that saved them.  BRICK_CV_WARPER_TABLE_COMPACT tables can
+       * be loaded regardless of NumericType.
+       *
+       * @param fileName This argument is the name of the file to
+       * read.
+       *
+       * @param isMemoryMapped If this argument is true, the file is
+       * mapped into memory read-only instead of being copied.  Pages
+       * are then read from disk only as they are used, and every
+       * process that loads the same file shares one physical copy of
+       * the table.  Copies of *this share the mapping, which is
+       * released when the last of them is destroyed.  The file must
+       * not be modified while it is mapped.  Tables that are read
+       * into memory (isMemoryMapped == false) are checked for entries
+       * that refer to pixels outside the input image, but memory
+       * mapped tables are not, since that would mean reading the
+       * whole file immediately.  Only map files from a trusted
+       * source; a corrupt mapped table can make warpImage() read
+       * out of bounds.
+       */
+      void
+      load(std::string const& fileName, bool isMemoryMapped = true);
+
+
+      /**
+       * This member function writes the lookup table to a binary
+       * file that can be read by load().
+       *
+       * @param fileName This argument is the name of the file to
+       * write.  Any existing file is overwritten.
+       */
+      void
+      save(std::string const& fileName) const;
+
+
       /**
        * Warps a single image using the pre-computed lookup table.
        *
@@ -98,8 +340,105 @@ namespace brick {
       warpImage(Image<InputFormat> const& inputImage,
                 typename Image<OutputFormat>::PixelType defaultValue) const;
 
+
+      /**
+       * Warps a single image using the pre-computed lookup table,
+       * writing the result into an existing image.  This avoids
+       * allocating a new output image for each call.
+       *
+       * @param inputImage This argument is the image to be warped.
+       *
+       * @param outputImage This argument is the image into which the
+       * result will be written.  It must already have the output
+       * dimensions passed to the constructor, and must not share
+       * data with inputImage.  It may be a region of a larger image,
+       * such as one returned by Image::getROI().
+       *
+       * @param defaultValue This argument specifies what pixel value
+       * to use for pixels in the output image that map to input-image
+       * pixels that lie outside the boundaries of the input image.
+       */
+      template <ImageFormat InputFormat, ImageFormat OutputFormat>
+      void
+      warpImage(Image<InputFormat> const& inputImage,
+                Image<OutputFormat>& outputImage,
+                typename Image<OutputFormat>::PixelType defaultValue) const;
+
+
+      /**
+       * This member function makes subsequent calls to warpImage()
+       * split the output image into horizontal bands of tiles, and
+       * process the bands using the threads of the specified
+       * ThreadPool.  Each output pixel is computed the same way
+       * regardless of the number of threads.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use.  It is not deleted by *this, and must remain valid
+       * until it is replaced by a subsequent call to setThreadPool().
+       * Pass 0 to warp images in the calling thread only.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr);
+
+
+      /**
+       * This member function sets the size of the blocks of output
+       * pixels processed by warpImage().  All of the pixels in one
+       * tile are warped before moving on to the next tile.  Each
+       * horizontal band of tiles is one unit of work for the
+       * ThreadPool, if one has been set.
+       *
+       * @param tileRows This argument specifies the height of each
+       * tile.  It must be greater than zero.  The default is 16.
+       *
+       * @param tileColumns This argument specifies the width of each
+       * tile.  Setting it to zero makes each tile span the full width
+       * of the output image.  The default is 64.
+       */
+      void
+      setTileSize(size_t tileRows, size_t tileColumns);
+
     private:
 
+      // Functor that fills in one band of rows of the lookup table.
+      // The constructor passes it to ThreadPool::parallelFor().
+      class TableBuilder;
+
+      // Functor that warps one band of tiles.  Member function
+      // warpImage() passes it to ThreadPool::parallelFor().
+      template <ImageFormat InputFormat, ImageFormat OutputFormat>
+      class WarpTask;
+
+      // Dimensions of the output image.
+      size_t
+      getOutputColumns() const;
+
+      size_t
+      getOutputRows() const;
+
+      // Warp the tiles in rows [band * m_tileRows, (band + 1) *
+      // m_tileRows) of the output image.
+      template <ImageFormat InputFormat, ImageFormat OutputFormat>
+      void
+      warpBand(Image<InputFormat> const& inputImage,
+               Image<OutputFormat>& outputImage,
+               typename Image<OutputFormat>::PixelType const& defaultValue,
+               size_t band) const;
+
+      // Warp count consecutive output pixels of the specified row,
+      // starting at the specified column.
+      template <ImageFormat InputFormat, ImageFormat OutputFormat>
+      void
+      warpSpan(Image<InputFormat> const& inputImage,
+               Image<OutputFormat>& outputImage,
+               typename Image<OutputFormat>::PixelType const& defaultValue,
+               size_t row, size_t column, size_t count) const;
+
+      // Fill in one entry of each kind of lookup table.
+      void
+      setSample(size_t row, size_t column,
+                brick::numeric::Vector2D<NumericType> const& inputCoord);
+
       struct SampleInfo {
         NumericType c00;
         NumericType c01;
@@ -109,9 +448,15 @@ namespace brick {
         bool isInBounds;
       };
 
+      brick::numeric::Array2D<ImageWarperCompactSample> m_compactTable;
       size_t m_inputColumns;
       size_t m_inputRows;
       brick::numeric::Array2D<SampleInfo> m_lookupTable;
+      brick::portability::MemoryMappedFile m_mappedFile;
+      ImageWarperTableFormat m_tableFormat;
+      brick::common::ThreadPool* m_threadPoolPtr;
+      size_t m_tileColumns;
+      size_t m_tileRows;
 
     };
 
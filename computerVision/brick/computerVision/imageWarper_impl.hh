@@ -19,20 +19,333 @@
 //
 // #include <brick/computerVision/imageWarper.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
 #include <brick/numeric/vector2D.hh>
+#include <brick/common/exception.hh>
 #include <brick/common/mathFunctions.hh>
 
 namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Warps a run of count consecutive output pixels of any
+      // format using a compact lookup table.  The interpolation
+      // weights are converted back to NumericType, and combined just
+      // as they are for a full lookup table.
+      template <class NumericType,
+                ImageFormat InputFormat, ImageFormat OutputFormat>
+      struct ImageWarperCompactKernel {
+        static void
+        warp(ImageWarperCompactSample const* table, size_t count,
+             Image<InputFormat> const& inputImage,
+             typename Image<OutputFormat>::PixelType* outputImage,
+             typename Image<OutputFormat>::PixelType const& defaultValue)
+        {
+          NumericType const scale = NumericType(1.0) / NumericType(65536.0);
+          size_t const inputColumns = inputImage.columns();
+          for(size_t ii = 0; ii < count; ++ii) {
+            ImageWarperCompactSample const& sample = table[ii];
+            if(sample.index00 & imageWarperOutOfBounds) {
+              outputImage[ii] = defaultValue;
+              continue;
+            }
+            NumericType xFrac = sample.xFraction * scale;
+            NumericType yFrac = sample.yFraction * scale;
+            NumericType oneMinusXFrac = NumericType(1.0) - xFrac;
+            NumericType oneMinusYFrac = NumericType(1.0) - yFrac;
+
+            typename Image<OutputFormat>::PixelType& outputPixel =
+              outputImage[ii];
+            size_t inputIndex = sample.index00;
+            outputPixel = (oneMinusXFrac * oneMinusYFrac)
+              * inputImage[inputIndex];
+            ++inputIndex;
+            outputPixel += (xFrac * oneMinusYFrac) * inputImage[inputIndex];
+            inputIndex += inputColumns;
+            outputPixel += (xFrac * yFrac) * inputImage[inputIndex];
+            --inputIndex;
+            outputPixel += (oneMinusXFrac * yFrac) * inputImage[inputIndex];
+          }
+        }
+      };
+
+
+      // GRAY8 images get a fixed-point, and possibly vectorized,
+      // implementation.
+      template <class NumericType>
+      struct ImageWarperCompactKernel<NumericType, GRAY8, GRAY8> {
+        static void
+        warp(ImageWarperCompactSample const* table, size_t count,
+             Image<GRAY8> const& inputImage,
+             brick::common::UInt8* outputImage,
+             brick::common::UInt8 const& defaultValue)
+        {
+          warpImageCompactGray8(table, count,
+                                inputImage.data(), inputImage.rows(),
+                                inputImage.columns(),
+                                outputImage, defaultValue);
+        }
+      };
+
+
+      // As are RGB8 images.
+      template <class NumericType>
+      struct ImageWarperCompactKernel<NumericType, RGB8, RGB8> {
+        static void
+        warp(ImageWarperCompactSample const* table, size_t count,
+             Image<RGB8> const& inputImage,
+             PixelRGB8* outputImage,
+             PixelRGB8 const& defaultValue)
+        {
+          warpImageCompactRGB8(table, count,
+                               inputImage.data(), inputImage.rows(),
+                               inputImage.columns(),
+                               outputImage, defaultValue);
+        }
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
+    /// @cond privateCode
+    template<class NumericType, class TransformFunctor>
+    class ImageWarper<NumericType, TransformFunctor>::TableBuilder {
+    public:
+
+      TableBuilder(ImageWarper* warperPtr,
+                   TransformFunctor const& transformer,
+                   size_t outputRows, size_t outputColumns,
+                   NumericType maximumError, size_t gridSpacing)
+        : m_gridSpacing(gridSpacing),
+          m_maximumError(maximumError),
+          m_outputColumns(outputColumns),
+          m_outputRows(outputRows),
+          m_transformer(transformer),
+          m_warperPtr(warperPtr)
+        {}
+
+
+      size_t
+      getNumberOfBands() const {
+        return (m_outputRows + m_gridSpacing - 1) / m_gridSpacing;
+      }
+
+
+      // Fill in rows [band * gridSpacing, (band + 1) * gridSpacing).
+      void
+      operator()(size_t band) const {
+        // Each band gets its own copy of the transform, so that
+        // transforms with internal state don't race.
+        TransformFunctor transformer(m_transformer);
+        size_t rowBegin = band * m_gridSpacing;
+        size_t rowEnd = std::min(rowBegin + m_gridSpacing, m_outputRows);
+        if(m_maximumError <= NumericType(0)) {
+          this->fillExact(transformer, rowBegin, rowEnd, 0, m_outputColumns);
+          return;
+        }
+
+        // Transform the grid corners along the top and bottom of the
+        // band.  The last grid row and column are clamped to the
+        // edge of the output image.
+        NumericType y0 = NumericType(rowBegin);
+        NumericType y1 = NumericType(std::min(rowEnd, m_outputRows - 1));
+        size_t numberOfCells =
+          (m_outputColumns + m_gridSpacing - 1) / m_gridSpacing;
+        std::vector< brick::numeric::Vector2D<NumericType> > topCorners;
+        std::vector< brick::numeric::Vector2D<NumericType> > bottomCorners;
+        topCorners.reserve(numberOfCells + 1);
+        bottomCorners.reserve(numberOfCells + 1);
+        for(size_t cell = 0; cell <= numberOfCells; ++cell) {
+          NumericType x = NumericType(
+            std::min(cell * m_gridSpacing, m_outputColumns - 1));
+          topCorners.push_back(
+            transformer(brick::numeric::Vector2D<NumericType>(x, y0)));
+          bottomCorners.push_back(
+            transformer(brick::numeric::Vector2D<NumericType>(x, y1)));
+        }
+
+        for(size_t cell = 0; cell < numberOfCells; ++cell) {
+          size_t columnBegin = cell * m_gridSpacing;
+          size_t columnEnd = std::min(columnBegin + m_gridSpacing,
+                                      m_outputColumns);
+          NumericType x0 = NumericType(columnBegin);
+          NumericType x1 = NumericType(
+            std::min(columnEnd, m_outputColumns - 1));
+          if(this->isInterpolationAccurate(
+               transformer, x0, x1, y0, y1,
+               topCorners[cell], topCorners[cell + 1],
+               bottomCorners[cell], bottomCorners[cell + 1])) {
+            this->fillInterpolated(
+              rowBegin, rowEnd, columnBegin, columnEnd, x0, x1, y0, y1,
+              topCorners[cell], topCorners[cell + 1],
+              bottomCorners[cell], bottomCorners[cell + 1]);
+          } else {
+            this->fillExact(transformer, rowBegin, rowEnd,
+                            columnBegin, columnEnd);
+          }
+        }
+      }
+
+    private:
+
+      // Returns the distance between the transform of (x, y) and the
+      // specified estimate, or infinity if the transform isn't finite.
+      NumericType
+      getError(TransformFunctor& transformer, NumericType x, NumericType y,
+               brick::numeric::Vector2D<NumericType> const& estimate) const {
+        brick::numeric::Vector2D<NumericType> exact =
+          transformer(brick::numeric::Vector2D<NumericType>(x, y));
+        NumericType dx = exact.x() - estimate.x();
+        NumericType dy = exact.y() - estimate.y();
+        NumericType error = std::sqrt(dx * dx + dy * dy);
+        if(!(error <= std::numeric_limits<NumericType>::max())) {
+          return std::numeric_limits<NumericType>::infinity();
+        }
+        return error;
+      }
+
+
+      // The bilinear interpolation error of a quadratic transform is
+      // at most the sum of the worst horizontal edge midpoint error
+      // and the worst vertical edge midpoint error.  The center is
+      // checked too, since not every transform is quadratic.
+      bool
+      isInterpolationAccurate(
+        TransformFunctor& transformer,
+        NumericType x0, NumericType x1, NumericType y0, NumericType y1,
+        brick::numeric::Vector2D<NumericType> const& c00,
+        brick::numeric::Vector2D<NumericType> const& c01,
+        brick::numeric::Vector2D<NumericType> const& c10,
+        brick::numeric::Vector2D<NumericType> const& c11) const {
+        NumericType const half(0.5);
+        NumericType xMid = half * (x0 + x1);
+        NumericType yMid = half * (y0 + y1);
+        NumericType horizontalError = std::max(
+          this->getError(transformer, xMid, y0, half * (c00 + c01)),
+          this->getError(transformer, xMid, y1, half * (c10 + c11)));
+        NumericType verticalError = std::max(
+          this->getError(transformer, x0, yMid, half * (c00 + c10)),
+          this->getError(transformer, x1, yMid, half * (c01 + c11)));
+        NumericType centerError = this->getError(
+          transformer, xMid, yMid, NumericType(0.25) * (c00 + c01 + c10 + c11));
+        return (horizontalError + verticalError <= m_maximumError
+                && centerError <= m_maximumError
+                && this->isFinite(c00) && this->isFinite(c01)
+                && this->isFinite(c10) && this->isFinite(c11));
+      }
+
+
+      void
+      fillExact(TransformFunctor& transformer,
+                size_t rowBegin, size_t rowEnd,
+                size_t columnBegin, size_t columnEnd) const {
+        for(size_t row = rowBegin; row < rowEnd; ++row) {
+          for(size_t column = columnBegin; column < columnEnd; ++column) {
+            brick::numeric::Vector2D<NumericType> outputCoord(column, row);
+            m_warperPtr->setSample(row, column, transformer(outputCoord));
+          }
+        }
+      }
+
+
+      void
+      fillInterpolated(
+        size_t rowBegin, size_t rowEnd, size_t columnBegin, size_t columnEnd,
+        NumericType x0, NumericType x1, NumericType y0, NumericType y1,
+        brick::numeric::Vector2D<NumericType> const& c00,
+        brick::numeric::Vector2D<NumericType> const& c01,
+        brick::numeric::Vector2D<NumericType> const& c10,
+        brick::numeric::Vector2D<NumericType> const& c11) const {
+        // Cells at the edge of the image may be only one pixel wide.
+        NumericType xScale = (x1 > x0) ? NumericType(1) / (x1 - x0)
+          : NumericType(0);
+        NumericType yScale = (y1 > y0) ? NumericType(1) / (y1 - y0)
+          : NumericType(0);
+        for(size_t row = rowBegin; row < rowEnd; ++row) {
+          NumericType yFrac = (NumericType(row) - y0) * yScale;
+          brick::numeric::Vector2D<NumericType> left =
+            c00 + yFrac * (c10 - c00);
+          brick::numeric::Vector2D<NumericType> right =
+            c01 + yFrac * (c11 - c01);
+          for(size_t column = columnBegin; column < columnEnd; ++column) {
+            NumericType xFrac = (NumericType(column) - x0) * xScale;
+            m_warperPtr->setSample(row, column,
+                                   left + xFrac * (right - left));
+          }
+        }
+      }
+
+
+      bool
+      isFinite(brick::numeric::Vector2D<NumericType> const& point) const {
+        return (std::fabs(point.x()) <= std::numeric_limits<NumericType>::max()
+                && std::fabs(point.y())
+                <= std::numeric_limits<NumericType>::max());
+      }
+
+
+      size_t m_gridSpacing;
+      NumericType m_maximumError;
+      size_t m_outputColumns;
+      size_t m_outputRows;
+      TransformFunctor m_transformer;
+      ImageWarper* m_warperPtr;
+    };
+
+
+    template<class NumericType, class TransformFunctor>
+    template <ImageFormat InputFormat, ImageFormat OutputFormat>
+    class ImageWarper<NumericType, TransformFunctor>::WarpTask {
+    public:
+
+      WarpTask(ImageWarper const* warperPtr,
+               Image<InputFormat> const& inputImage,
+               Image<OutputFormat>& outputImage,
+               typename Image<OutputFormat>::PixelType const& defaultValue)
+        : m_defaultValue(defaultValue),
+          m_inputImage(inputImage),
+          m_outputImage(outputImage),
+          m_warperPtr(warperPtr)
+        {}
+
+
+      void
+      operator()(size_t band) const {
+        m_warperPtr->template warpBand<InputFormat, OutputFormat>(
+          m_inputImage, m_outputImage, m_defaultValue, band);
+      }
+
+    private:
+
+      typename Image<OutputFormat>::PixelType m_defaultValue;
+      Image<InputFormat> const& m_inputImage;
+      Image<OutputFormat>& m_outputImage;
+      ImageWarper const* m_warperPtr;
+    };
+    /// @endcond
+
 
     template<class NumericType, class TransformFunctor>
     ImageWarper<NumericType, TransformFunctor>::
     ImageWarper()
-      : m_inputColumns(0),
+      : m_compactTable(),
+        m_inputColumns(0),
         m_inputRows(0),
-        m_lookupTable()
+        m_lookupTable(),
+        m_mappedFile(),
+        m_tableFormat(BRICK_CV_WARPER_TABLE_FULL),
+        m_threadPoolPtr(0),
+        m_tileColumns(64),
+        m_tileRows(16)
     {
       // Empty.
     }
@@ -42,43 +355,50 @@ namespace brick {
     ImageWarper<NumericType, TransformFunctor>::
     ImageWarper(size_t inputRows, size_t inputColumns,
                 size_t outputRows, size_t outputColumns,
-                TransformFunctor transformer)
-      : m_inputColumns(inputColumns),
+                TransformFunctor transformer,
+                ImageWarperTableFormat tableFormat,
+                brick::common::ThreadPool* threadPoolPtr,
+                NumericType maximumError,
+                size_t gridSpacing)
+      : m_compactTable(),
+        m_inputColumns(inputColumns),
         m_inputRows(inputRows),
-        m_lookupTable(outputRows, outputColumns)
+        m_lookupTable(),
+        m_mappedFile(),
+        m_tableFormat(tableFormat),
+        m_threadPoolPtr(0),
+        m_tileColumns(64),
+        m_tileRows(16)
     {
-      for(size_t row = 0; row < outputRows; ++row) {
-        for(size_t column = 0; column < outputColumns; ++column) {
-          brick::numeric::Vector2D<NumericType> outputCoord(column, row);
-          brick::numeric::Vector2D<NumericType> inputCoord =
-            transformer(outputCoord);
-          SampleInfo& sampleInfo = m_lookupTable(row, column);
-          if((inputCoord.y() >= 0.0)
-             && (inputCoord.x() >= 0.0)
-             && (inputCoord.y() < static_cast<NumericType>(inputRows - 1))
-             && (inputCoord.x() < static_cast<NumericType>(inputColumns - 1))) {
-
-            NumericType intPart;
-            NumericType xFrac;
-            NumericType yFrac;
-
-            brick::common::splitFraction(inputCoord.x(), intPart, xFrac);
-            size_t i0 = static_cast<size_t>(intPart);
-
-            brick::common::splitFraction(inputCoord.y(), intPart, yFrac);
-            size_t j0 = static_cast<size_t>(intPart);
-
-            NumericType oneMinusXFrac = 1.0 - xFrac;
-            NumericType oneMinusYFrac = 1.0 - yFrac;
-            sampleInfo.c00 = oneMinusXFrac * oneMinusYFrac;
-            sampleInfo.c01 = xFrac * oneMinusYFrac;
-            sampleInfo.c10 = oneMinusXFrac * yFrac;
-            sampleInfo.c11 = xFrac * yFrac;
-            sampleInfo.index00 = inputColumns * j0 + i0;
-            sampleInfo.isInBounds = true;
-          } else {
-            sampleInfo.isInBounds = false;
-          }
+      if(gridSpacing == 0) {
+        BRICK_THROW(brick::common::ValueException,
+                    "ImageWarper::ImageWarper()",
+                    "Argument gridSpacing must be greater than zero.");
+      }
+      if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+        if(inputRows * inputColumns >= imageWarperOutOfBounds) {
+          BRICK_THROW(brick::common::ValueException,
+                      "ImageWarper::ImageWarper()",
+                      "Compact lookup tables require input images of "
+                      "fewer than 2^31 pixels.");
+        }
+        m_compactTable.reinit(outputRows, outputColumns);
+      } else {
+        m_lookupTable.reinit(outputRows, outputColumns);
+      }
+
+      if(outputRows == 0 || outputColumns == 0) {
+        return;
+      }
+      TableBuilder tableBuilder(this, transformer, outputRows, outputColumns,
+                                maximumError, gridSpacing);
+      if(threadPoolPtr) {
+        threadPoolPtr->parallelFor(tableBuilder.getNumberOfBands(),
+                                   tableBuilder);
+      } else {
+        for(size_t band = 0; band < tableBuilder.getNumberOfBands();
+            ++band) {
+          tableBuilder(band);
         }
       }
     }
@@ -94,6 +414,201 @@ namespace brick {
     }
 
 
+    template<class NumericType, class TransformFunctor>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    load(std::string const& fileName, bool isMemoryMapped)
+    {
+      brick::portability::MemoryMappedFile mappedFile;
+      std::ifstream inputStream;
+      char headerBuffer[privateCode::imageWarperFileHeaderSize];
+      std::size_t fileSize = 0;
+      if(isMemoryMapped) {
+        mappedFile = brick::portability::MemoryMappedFile(fileName);
+        fileSize = mappedFile.getSize();
+        if(fileSize >= privateCode::imageWarperFileHeaderSize) {
+          std::copy(static_cast<char const*>(mappedFile.getData()),
+                    static_cast<char const*>(mappedFile.getData())
+                    + privateCode::imageWarperFileHeaderSize,
+                    headerBuffer);
+        }
+      } else {
+        inputStream.open(fileName.c_str(), std::ios::binary);
+        if(!inputStream) {
+          std::ostringstream message;
+          message << "Couldn't open file " << fileName << " for reading.";
+          BRICK_THROW(brick::common::IOException, "ImageWarper::load()",
+                      message.str().c_str());
+        }
+        inputStream.seekg(0, std::ios::end);
+        fileSize = static_cast<std::size_t>(inputStream.tellg());
+        inputStream.seekg(0, std::ios::beg);
+        if(fileSize >= privateCode::imageWarperFileHeaderSize) {
+          inputStream.read(headerBuffer,
+                           privateCode::imageWarperFileHeaderSize);
+        }
+      }
+      privateCode::ImageWarperFileHeader header =
+        privateCode::decodeImageWarperFileHeader(
+          headerBuffer, fileSize, fileName);
+
+      // Full tables store NumericType weights.  Compact tables don't
+      // depend on NumericType at all.
+      ImageWarperTableFormat tableFormat =
+        static_cast<ImageWarperTableFormat>(header.tableFormat);
+      std::size_t expectedEntrySize = sizeof(ImageWarperCompactSample);
+      if(tableFormat == BRICK_CV_WARPER_TABLE_FULL) {
+        expectedEntrySize = sizeof(SampleInfo);
+        if(header.numericDigits
+           != static_cast<brick::common::UInt32>(
+             std::numeric_limits<NumericType>::digits)) {
+          std::ostringstream message;
+          message << "File " << fileName << " holds a table with a "
+                  << "different NumericType.";
+          BRICK_THROW(brick::common::IOException, "ImageWarper::load()",
+                      message.str().c_str());
+        }
+      }
+      if(header.entrySize != expectedEntrySize) {
+        std::ostringstream message;
+        message << "File " << fileName << " has table entries of "
+                << header.entrySize << " bytes, but " << expectedEntrySize
+                << " bytes were expected.";
+        BRICK_THROW(brick::common::IOException, "ImageWarper::load()",
+                    message.str().c_str());
+      }
+
+      std::size_t outputRows = static_cast<std::size_t>(header.outputRows);
+      std::size_t outputColumns =
+        static_cast<std::size_t>(header.outputColumns);
+      brick::numeric::Array2D<ImageWarperCompactSample> compactTable;
+      brick::numeric::Array2D<SampleInfo> lookupTable;
+      if(isMemoryMapped) {
+        // The tables are never modified after construction, so it's
+        // safe to point them at read-only memory.
+        char* dataPtr = const_cast<char*>(
+          static_cast<char const*>(mappedFile.getData()))
+          + header.dataOffset;
+        if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+          compactTable = brick::numeric::Array2D<ImageWarperCompactSample>(
+            outputRows, outputColumns,
+            reinterpret_cast<ImageWarperCompactSample*>(dataPtr));
+        } else {
+          lookupTable = brick::numeric::Array2D<SampleInfo>(
+            outputRows, outputColumns, reinterpret_cast<SampleInfo*>(dataPtr));
+        }
+      } else {
+        char* dataPtr = 0;
+        if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+          compactTable.reinit(outputRows, outputColumns);
+          dataPtr = reinterpret_cast<char*>(compactTable.data());
+        } else {
+          lookupTable.reinit(outputRows, outputColumns);
+          dataPtr = reinterpret_cast<char*>(lookupTable.data());
+        }
+        inputStream.seekg(static_cast<std::streamoff>(header.dataOffset));
+        inputStream.read(dataPtr, outputRows * outputColumns
+                         * header.entrySize);
+        if(!inputStream) {
+          std::ostringstream message;
+          message << "Couldn't read lookup table from file " << fileName
+                  << ".";
+          BRICK_THROW(brick::common::IOException, "ImageWarper::load()",
+                      message.str().c_str());
+        }
+
+        // warpImage() doesn't check its input indices, so make sure
+        // that every in-bounds entry refers to a 2x2 neighborhood
+        // that lies entirely inside the input image.  Memory mapped
+        // tables are trusted, since checking them would mean reading
+        // the whole file up front.
+        std::size_t inputColumns =
+          static_cast<std::size_t>(header.inputColumns);
+        std::size_t inputRows = static_cast<std::size_t>(header.inputRows);
+        std::size_t indexLimit =
+          (inputRows == 0) ? 0 : (inputRows - 1) * inputColumns;
+        std::size_t numberOfEntries = outputRows * outputColumns;
+        for(std::size_t ii = 0; ii < numberOfEntries; ++ii) {
+          std::size_t index00 = 0;
+          if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+            if(compactTable[ii].index00 & imageWarperOutOfBounds) {
+              continue;
+            }
+            index00 = static_cast<std::size_t>(compactTable[ii].index00);
+          } else {
+            if(!lookupTable[ii].isInBounds) {
+              continue;
+            }
+            index00 = lookupTable[ii].index00;
+          }
+          if(index00 >= indexLimit
+             || index00 % inputColumns == inputColumns - 1) {
+            std::ostringstream message;
+            message << "File " << fileName << " has a table entry that "
+                    << "refers to pixels outside the "
+                    << inputRows << "x" << inputColumns << " input image.";
+            BRICK_THROW(brick::common::IOException, "ImageWarper::load()",
+                        message.str().c_str());
+          }
+        }
+      }
+
+      m_compactTable = compactTable;
+      m_inputColumns = static_cast<std::size_t>(header.inputColumns);
+      m_inputRows = static_cast<std::size_t>(header.inputRows);
+      m_lookupTable = lookupTable;
+      m_mappedFile = mappedFile;
+      m_tableFormat = tableFormat;
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    save(std::string const& fileName) const
+    {
+      privateCode::ImageWarperFileHeader header;
+      header.version = privateCode::imageWarperFileVersion;
+      header.tableFormat = static_cast<brick::common::UInt32>(m_tableFormat);
+      header.numericDigits = static_cast<brick::common::UInt32>(
+        std::numeric_limits<NumericType>::digits);
+      header.inputRows = m_inputRows;
+      header.inputColumns = m_inputColumns;
+      header.dataOffset = privateCode::imageWarperFileHeaderSize;
+      char const* dataPtr = 0;
+      if(m_tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+        header.entrySize = sizeof(ImageWarperCompactSample);
+        header.outputRows = m_compactTable.rows();
+        header.outputColumns = m_compactTable.columns();
+        dataPtr = reinterpret_cast<char const*>(m_compactTable.data());
+      } else {
+        header.entrySize = sizeof(SampleInfo);
+        header.outputRows = m_lookupTable.rows();
+        header.outputColumns = m_lookupTable.columns();
+        dataPtr = reinterpret_cast<char const*>(m_lookupTable.data());
+      }
+      char headerBuffer[privateCode::imageWarperFileHeaderSize];
+      privateCode::encodeImageWarperFileHeader(header, headerBuffer);
+
+      std::ofstream outputStream(fileName.c_str(), std::ios::binary);
+      if(!outputStream) {
+        std::ostringstream message;
+        message << "Couldn't open file " << fileName << " for writing.";
+        BRICK_THROW(brick::common::IOException, "ImageWarper::save()",
+                    message.str().c_str());
+      }
+      outputStream.write(headerBuffer, privateCode::imageWarperFileHeaderSize);
+      outputStream.write(dataPtr, header.outputRows * header.outputColumns
+                         * header.entrySize);
+      if(!outputStream) {
+        std::ostringstream message;
+        message << "Couldn't write lookup table to file " << fileName << ".";
+        BRICK_THROW(brick::common::IOException, "ImageWarper::save()",
+                    message.str().c_str());
+      }
+    }
+
+
 
     template<class NumericType, class TransformFunctor>
     template <ImageFormat InputFormat, ImageFormat OutputFormat>
@@ -101,6 +616,22 @@ namespace brick {
     ImageWarper<NumericType, TransformFunctor>::
     warpImage(Image<InputFormat> const& inputImage,
               typename Image<OutputFormat>::PixelType defaultValue) const
+    {
+      Image<OutputFormat> outputImage(this->getOutputRows(),
+                                      this->getOutputColumns());
+      this->warpImage<InputFormat, OutputFormat>(
+        inputImage, outputImage, defaultValue);
+      return outputImage;
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    template <ImageFormat InputFormat, ImageFormat OutputFormat>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    warpImage(Image<InputFormat> const& inputImage,
+              Image<OutputFormat>& outputImage,
+              typename Image<OutputFormat>::PixelType defaultValue) const
     {
       if((inputImage.rows() != m_inputRows)
          || (inputImage.columns() != m_inputColumns)) {
@@ -112,13 +643,133 @@ namespace brick {
         BRICK_THROW(brick::common::ValueException, "ImageWarper::warpImage()",
                     message.str().c_str());
       }
-      Image<OutputFormat> outputImage(
-        m_lookupTable.rows(), m_lookupTable.columns());
-      for(size_t ii = 0; ii < m_lookupTable.size(); ++ii) {
-        SampleInfo const& sampleInfo = m_lookupTable(ii);
+      if((outputImage.rows() != this->getOutputRows())
+         || (outputImage.columns() != this->getOutputColumns())) {
+        std::ostringstream message;
+        message
+          << "OutputImage (" << outputImage.rows() << "x"
+          << outputImage.columns() << ") doesn't match expected dimensions ("
+          << this->getOutputRows() << "x" << this->getOutputColumns() << ").";
+        BRICK_THROW(brick::common::ValueException, "ImageWarper::warpImage()",
+                    message.str().c_str());
+      }
+
+      WarpTask<InputFormat, OutputFormat> warpTask(
+        this, inputImage, outputImage, defaultValue);
+      size_t numberOfBands =
+        (this->getOutputRows() + m_tileRows - 1) / m_tileRows;
+      if(m_threadPoolPtr && numberOfBands > 1) {
+        m_threadPoolPtr->parallelFor(numberOfBands, warpTask);
+      } else {
+        for(size_t band = 0; band < numberOfBands; ++band) {
+          warpTask(band);
+        }
+      }
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr)
+    {
+      m_threadPoolPtr = threadPoolPtr;
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    setTileSize(size_t tileRows, size_t tileColumns)
+    {
+      if(tileRows == 0) {
+        BRICK_THROW(brick::common::ValueException,
+                    "ImageWarper::setTileSize()",
+                    "Argument tileRows must be greater than zero.");
+      }
+      m_tileColumns = tileColumns;
+      m_tileRows = tileRows;
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    size_t
+    ImageWarper<NumericType, TransformFunctor>::
+    getOutputColumns() const
+    {
+      return (m_tableFormat == BRICK_CV_WARPER_TABLE_COMPACT)
+        ? m_compactTable.columns() : m_lookupTable.columns();
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    size_t
+    ImageWarper<NumericType, TransformFunctor>::
+    getOutputRows() const
+    {
+      return (m_tableFormat == BRICK_CV_WARPER_TABLE_COMPACT)
+        ? m_compactTable.rows() : m_lookupTable.rows();
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    template <ImageFormat InputFormat, ImageFormat OutputFormat>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    warpBand(Image<InputFormat> const& inputImage,
+             Image<OutputFormat>& outputImage,
+             typename Image<OutputFormat>::PixelType const& defaultValue,
+             size_t band) const
+    {
+      size_t outputColumns = this->getOutputColumns();
+      size_t rowBegin = band * m_tileRows;
+      size_t rowEnd = std::min(rowBegin + m_tileRows, this->getOutputRows());
+      size_t tileColumns = (m_tileColumns == 0) ? outputColumns : m_tileColumns;
+
+      // Finish each tile before moving right to the next one, so
+      // that input pixels fetched for one row of the tile are still
+      // in cache for the next.
+      for(size_t columnBegin = 0; columnBegin < outputColumns;
+          columnBegin += tileColumns) {
+        size_t count = std::min(tileColumns, outputColumns - columnBegin);
+        for(size_t row = rowBegin; row < rowEnd; ++row) {
+          this->warpSpan<InputFormat, OutputFormat>(
+            inputImage, outputImage, defaultValue, row, columnBegin, count);
+        }
+      }
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    template <ImageFormat InputFormat, ImageFormat OutputFormat>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    warpSpan(Image<InputFormat> const& inputImage,
+             Image<OutputFormat>& outputImage,
+             typename Image<OutputFormat>::PixelType const& defaultValue,
+             size_t row, size_t column, size_t count) const
+    {
+      // The lookup table is always contiguous, but outputImage may
+      // have padding at the end of each row (for example, if it was
+      // returned by Image::getROI()), so the two are indexed
+      // separately.
+      size_t tableIndex = row * this->getOutputColumns() + column;
+      typename Image<OutputFormat>::PixelType* outputPtr =
+        outputImage.data() + row * outputImage.getRowStep() + column;
+
+      if(m_tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+        privateCode::ImageWarperCompactKernel<
+          NumericType, InputFormat, OutputFormat>::warp(
+            m_compactTable.data() + tableIndex, count, inputImage,
+            outputPtr, defaultValue);
+        return;
+      }
+
+      for(size_t ii = 0; ii < count; ++ii) {
+        SampleInfo const& sampleInfo = m_lookupTable(tableIndex + ii);
         if(sampleInfo.isInBounds) {
           typename Image<OutputFormat>::PixelType& outputPixel =
-            outputImage[ii];
+            outputPtr[ii];
           size_t inputIndex = sampleInfo.index00;
 
           outputPixel = sampleInfo.c00 * inputImage[inputIndex];
@@ -129,10 +780,72 @@ namespace brick {
           --inputIndex;
           outputPixel += sampleInfo.c10 * inputImage[inputIndex];
         } else {
-          outputImage[ii] = defaultValue;
+          outputPtr[ii] = defaultValue;
         }
       }
-      return outputImage;
+    }
+
+
+    template<class NumericType, class TransformFunctor>
+    void
+    ImageWarper<NumericType, TransformFunctor>::
+    setSample(size_t row, size_t column,
+              brick::numeric::Vector2D<NumericType> const& inputCoord)
+    {
+      bool isInBounds =
+        ((inputCoord.y() >= 0.0)
+         && (inputCoord.x() >= 0.0)
+         && (inputCoord.y() < static_cast<NumericType>(m_inputRows - 1))
+         && (inputCoord.x() < static_cast<NumericType>(m_inputColumns - 1)));
+
+      NumericType intPart;
+      NumericType xFrac = 0.0;
+      NumericType yFrac = 0.0;
+      size_t i0 = 0;
+      size_t j0 = 0;
+      if(isInBounds) {
+        brick::common::splitFraction(inputCoord.x(), intPart, xFrac);
+        i0 = static_cast<size_t>(intPart);
+
+        brick::common::splitFraction(inputCoord.y(), intPart, yFrac);
+        j0 = static_cast<size_t>(intPart);
+      }
+
+      if(m_tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+        ImageWarperCompactSample& sample = m_compactTable(row, column);
+        if(isInBounds) {
+          // Round to the nearest 1/65536 of a pixel, but don't let
+          // rounding carry into the next pixel, which might be
+          // outside the image.
+          sample.index00 =
+            static_cast<brick::common::UInt32>(m_inputColumns * j0 + i0);
+          sample.xFraction = static_cast<brick::common::UInt16>(
+            std::min(xFrac * NumericType(65536.0) + NumericType(0.5),
+                     NumericType(65535.0)));
+          sample.yFraction = static_cast<brick::common::UInt16>(
+            std::min(yFrac * NumericType(65536.0) + NumericType(0.5),
+                     NumericType(65535.0)));
+        } else {
+          sample.index00 = ~brick::common::UInt32(0);
+          sample.xFraction = 0;
+          sample.yFraction = 0;
+        }
+        return;
+      }
+
+      SampleInfo& sampleInfo = m_lookupTable(row, column);
+      if(isInBounds) {
+        NumericType oneMinusXFrac = 1.0 - xFrac;
+        NumericType oneMinusYFrac = 1.0 - yFrac;
+        sampleInfo.c00 = oneMinusXFrac * oneMinusYFrac;
+        sampleInfo.c01 = xFrac * oneMinusYFrac;
+        sampleInfo.c10 = oneMinusXFrac * yFrac;
+        sampleInfo.c11 = xFrac * yFrac;
+        sampleInfo.index00 = m_inputColumns * j0 + i0;
+        sampleInfo.isInBounds = true;
+      } else {
+        sampleInfo.isInBounds = false;
+      }
     }
 
   } // namespace computerVision
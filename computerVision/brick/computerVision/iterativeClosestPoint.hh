@@ -14,13 +14,53 @@
 #ifndef BRICK_COMPUTERVISION_ITERATIVECLOSESTPOINT_HH
 #define BRICK_COMPUTERVISION_ITERATIVECLOSESTPOINT_HH
 
+#include<brick/common/threadPool.hh>
+#include<brick/common/types.hh>
 #include<brick/computerVision/kdTree.hh>
 #include<brick/numeric/transform3D.hh>
+#include<brick/numeric/vector3D.hh>
 
 namespace brick {
 
   namespace computerVision {
 
+    /**
+     ** This enum is used by IterativeClosestPoint to select between
+     ** the various ways of choosing which query points take part in
+     ** the registration.  See
+     ** IterativeClosestPoint::setQuerySelectionStrategy().
+     **/
+    enum IcpSelectionStrategy {
+      BRICK_CV_ICP_SELECT_ALL,
+      BRICK_CV_ICP_SELECT_RANDOM,
+      BRICK_CV_ICP_SELECT_NORMAL_SPACE,
+      BRICK_CV_ICP_SELECT_VOXEL_GRID
+    };
+
+
+    /**
+     ** This enum is used by IterativeClosestPoint to select the error
+     ** that each iteration minimizes.  See
+     ** IterativeClosestPoint::setErrorMetric().
+     **/
+    enum IcpErrorMetric {
+      BRICK_CV_ICP_POINT_TO_POINT,
+      BRICK_CV_ICP_POINT_TO_PLANE
+    };
+
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Matches one block of query points.  Defined in
+      // iterativeClosestPoint_impl.hh.
+      template <unsigned int Dimension, class Type, class FloatType>
+      class IcpMatchFunctor;
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** This class implements a basic ICP algorithm of Besl and McKay
      ** [1].  Template argument Dimension specifies how many
@@ -77,6 +117,30 @@ namespace brick {
         = brick::numeric::Transform3D<FloatType>());
 
 
+      /**
+       * This member function selects the error that each iteration
+       * of registerPoints() minimizes.
+       *
+       * @param errorMetric This argument specifies the error.
+       * BRICK_CV_ICP_POINT_TO_POINT (the default) minimizes the sum
+       * of squared distances between matched points, using the
+       * closed form solution of registerPoints3D().
+       * BRICK_CV_ICP_POINT_TO_PLANE minimizes the sum of squared
+       * distances between each transformed query point and the plane
+       * through its matching model point, perpendicular to the
+       * model surface normal there.  Each iteration takes one
+       * Gauss-Newton step, linearizing the rotation around the
+       * current estimate.  Model normals are estimated from the 8
+       * nearest neighbors of each model point the first time they
+       * are needed, and kept until the next call to
+       * setModelPoints().  This mode requires Dimension == 3, and
+       * usually converges in far fewer iterations on scenes that are
+       * made up of large smooth or planar regions.
+       */
+      void
+      setErrorMetric(IcpErrorMetric errorMetric);
+
+
       template <class Iter>
       void
       setModelPoints(Iter beginIter, Iter endIter);
@@ -87,8 +151,77 @@ namespace brick {
                           modelFromQueryEstimate);
 
 
+      /**
+       * This member function controls which of the query points
+       * passed to registerPoints() take part in the registration.
+       * The selection is made once per call to registerPoints(), and
+       * the selected points are used for every iteration, so that
+       * the cost of each iteration depends only on the number of
+       * points selected, not the size of the query cloud.
+       *
+       * @param strategy This argument specifies how points are
+       * selected.  BRICK_CV_ICP_SELECT_ALL (the default) uses every
+       * query point.  BRICK_CV_ICP_SELECT_RANDOM picks a uniform
+       * random subset.  BRICK_CV_ICP_SELECT_NORMAL_SPACE estimates a
+       * surface normal for each query point from its neighbors, and
+       * picks points so that the selected normals are spread as
+       * evenly as possible over the sphere, which helps to
+       * constrain sliding along large flat regions.  It requires
+       * Dimension == 3.  BRICK_CV_ICP_SELECT_VOXEL_GRID divides space
+       * into cubes of side voxelSize and keeps the query point
+       * closest to the center of each occupied cube.
+       *
+       * @param numberOfQueryPoints This argument specifies how many
+       * points BRICK_CV_ICP_SELECT_RANDOM and
+       * BRICK_CV_ICP_SELECT_NORMAL_SPACE should select.  If it is
+       * zero, or if the query cloud has fewer points, all of the
+       * query points are used.
+       *
+       * @param voxelSize This argument specifies the grid spacing for
+       * BRICK_CV_ICP_SELECT_VOXEL_GRID, and must be greater than zero
+       * if that strategy is selected.
+       *
+       * @param randomSeed This argument seeds the random choices of
+       * BRICK_CV_ICP_SELECT_RANDOM and
+       * BRICK_CV_ICP_SELECT_NORMAL_SPACE, so that registrations are
+       * repeatable.
+       */
+      void
+      setQuerySelectionStrategy(IcpSelectionStrategy strategy,
+                                size_t numberOfQueryPoints = 0,
+                                FloatType voxelSize = FloatType(0),
+                                brick::common::Int64 randomSeed = 0);
+
+
+      /**
+       * This member function makes subsequent calls to
+       * registerPoints() find nearest neighbors using the threads of
+       * the specified ThreadPool.  The query points are matched in
+       * fixed-size blocks, and per-block statistics are combined in
+       * block order, so the result does not depend on the number of
+       * threads.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use, which must outlive *this or be replaced by a
+       * subsequent call to setThreadPool().  Pass 0 to match points
+       * in the calling thread.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr);
+
+
     protected:
 
+      friend class privateCode::IcpMatchFunctor<Dimension, Type, FloatType>;
+
+      template <class Iter>
+      void
+      estimateNormals(
+        KDTree<Dimension, Type, FloatType> const& tree,
+        Iter beginIter, Iter endIter,
+        std::vector< brick::numeric::Vector3D<FloatType> >& normals);
+
+
       brick::numeric::Transform3D<FloatType>
       estimateTransformModelFromQuery(
         std::vector<Type> const& selectedQueryPoints,
@@ -96,6 +229,15 @@ namespace brick {
         std::vector<FloatType> const& weights);
 
 
+      brick::numeric::Transform3D<FloatType>
+      estimateTransformPointToPlane(
+        std::vector<Type> const& selectedQueryPoints,
+        std::vector<Type const*> const& matchingModelPointAddresses,
+        std::vector<FloatType> const& weights,
+        brick::numeric::Transform3D<FloatType> const& modelFromQuery,
+        FloatType& stepSize);
+
+
       bool
       findMatches(std::vector<Type const*>& matchingModelPointAddresses,
                   std::vector<FloatType>& weights,
@@ -110,10 +252,32 @@ namespace brick {
                         std::vector<Type> const& allQueryPoints);
 
 
+      void
+      selectQueryPointsNormalSpace(std::vector<Type>& selectedQueryPoints,
+                                   std::vector<Type> const& allQueryPoints);
+
+
+      void
+      selectQueryPointsRandom(std::vector<Type>& selectedQueryPoints,
+                              std::vector<Type> const& allQueryPoints);
+
+
+      void
+      selectQueryPointsVoxelGrid(std::vector<Type>& selectedQueryPoints,
+                                 std::vector<Type> const& allQueryPoints);
+
+
       FloatType                          m_convergenceThreshold;
       FloatType                          m_distanceThreshold;
+      IcpErrorMetric                     m_errorMetric;
       unsigned int                       m_iterationCount;
+      std::vector< brick::numeric::Vector3D<FloatType> > m_modelNormals;
       KDTree<Dimension, Type, FloatType> m_modelTree;
+      size_t                             m_numberOfQueryPoints;
+      brick::common::Int64               m_randomSeed;
+      IcpSelectionStrategy               m_selectionStrategy;
+      brick::common::ThreadPool*         m_threadPoolPtr;
+      FloatType                          m_voxelSize;
 
     };
 
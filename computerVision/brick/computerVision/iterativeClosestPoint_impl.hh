@@ -14,9 +14,18 @@
 #ifndef BRICK_COMPUTERVISION_ITERATIVECLOSESTPOINT_IMPL_HH
 #define BRICK_COMPUTERVISION_ITERATIVECLOSESTPOINT_IMPL_HH
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <brick/common/exception.hh>
 #include <brick/common/mathFunctions.hh>
 #include <brick/computerVision/registerPoints3D.hh>
+#include <brick/linearAlgebra/linearAlgebra.hh>
+#include <brick/numeric/array1D.hh>
+#include <brick/numeric/array2D.hh>
+#include <brick/numeric/rotations.hh>
 #include <brick/numeric/utilities.hh>
+#include <brick/random/pseudoRandom.hh>
 
 // This file is included by iterativeClosestPoint.hh, and should not
 // be directly included by user code, so no need to include
@@ -28,14 +37,169 @@ namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Query points are matched in blocks of this size, whether or
+      // not a ThreadPool is in use, so that the per-block sums, and
+      // therefore the results, don't depend on the number of threads.
+      const size_t icpMatchBlockSize = 256;
+
+
+      // Point-to-plane registration stops once the correspondences
+      // are stable and a Gauss-Newton step moves the estimate by less
+      // than this much (rotation in radians plus translation), or
+      // after this many steps without a change in correspondences.
+      const double icpPointToPlaneStepThreshold = 1.0E-10;
+      const unsigned int icpPointToPlaneMaximumStableSteps = 50;
+
+
+      // Surface normals are estimated from this many neighbors.
+      const size_t icpNumberOfNormalNeighbors = 8;
+
+
+      template <unsigned int Dimension, class Type, class FloatType>
+      class IcpMatchFunctor {
+      public:
+
+        IcpMatchFunctor(
+          IterativeClosestPoint<Dimension, Type, FloatType> const& icp,
+          std::vector<Type> const& queryPoints,
+          brick::numeric::Transform3D<FloatType> const& modelFromQuery,
+          std::vector<Type const*>& matchingModelPointAddresses,
+          std::vector<FloatType>& weights,
+          std::vector<unsigned int>& blockCounts,
+          std::vector<FloatType>& blockSquaredErrors,
+          std::vector<char>& blockChangeFlags)
+          : m_icp(icp),
+            m_queryPoints(queryPoints),
+            m_modelFromQuery(modelFromQuery),
+            m_matchingModelPointAddresses(matchingModelPointAddresses),
+            m_weights(weights),
+            m_blockCounts(blockCounts),
+            m_blockSquaredErrors(blockSquaredErrors),
+            m_blockChangeFlags(blockChangeFlags) {}
+
+
+        void
+        operator()(size_t block) const
+        {
+          size_t beginIndex = block * icpMatchBlockSize;
+          size_t endIndex = std::min(beginIndex + icpMatchBlockSize,
+                                     m_queryPoints.size());
+          unsigned int count = 0;
+          FloatType squaredError(0);
+          bool isMatchingSetChanged = false;
+          for(size_t ii = beginIndex; ii < endIndex; ++ii) {
+
+            // Transform the query point using our best-so-far
+            // estimate of the final coordinate transformation.
+            brick::numeric::Vector3D<FloatType> transformedQueryPoint =
+              m_modelFromQuery * m_queryPoints[ii];
+
+            // Find the model point that is nearest to the current
+            // transformed query point.  Note that distance is the
+            // squared distance between the two.
+            FloatType distance;
+            Type const* matchingPointPtr = &(m_icp.m_modelTree.findNearest(
+                                               transformedQueryPoint,
+                                               distance));
+
+            // Notice if this particular point match has changed since
+            // the last ICP iteration, and remember the match.
+            isMatchingSetChanged |= (matchingPointPtr
+                                     != m_matchingModelPointAddresses[ii]);
+            m_matchingModelPointAddresses[ii] = matchingPointPtr;
+
+            // Checks of normals, etc., go here.
+            if(distance < m_icp.m_distanceThreshold) {
+              m_weights[ii] = 1.0;
+              squaredError += distance;
+              ++count;
+            } else {
+              m_weights[ii] = 0.0;
+            }
+          }
+          m_blockCounts[block] = count;
+          m_blockSquaredErrors[block] = squaredError;
+          m_blockChangeFlags[block] = isMatchingSetChanged;
+        }
+
+      private:
+
+        IterativeClosestPoint<Dimension, Type, FloatType> const& m_icp;
+        std::vector<Type> const& m_queryPoints;
+        brick::numeric::Transform3D<FloatType> const& m_modelFromQuery;
+        std::vector<Type const*>& m_matchingModelPointAddresses;
+        std::vector<FloatType>& m_weights;
+        std::vector<unsigned int>& m_blockCounts;
+        std::vector<FloatType>& m_blockSquaredErrors;
+        std::vector<char>& m_blockChangeFlags;
+      };
+
+
+      // Orders point indices by the voxel that contains each point.
+      // Argument keys holds dimension integer voxel coordinates per
+      // point.
+      class IcpVoxelLess {
+      public:
+
+        IcpVoxelLess(std::vector<brick::common::Int64> const& keys,
+                     unsigned int dimension)
+          : m_keys(keys), m_dimension(dimension) {}
+
+        bool
+        operator()(size_t index0, size_t index1) const {
+          brick::common::Int64 const* key0Ptr = &(m_keys[index0 * m_dimension]);
+          brick::common::Int64 const* key1Ptr = &(m_keys[index1 * m_dimension]);
+          return std::lexicographical_compare(
+            key0Ptr, key0Ptr + m_dimension, key1Ptr, key1Ptr + m_dimension);
+        }
+
+        bool
+        isSameVoxel(size_t index0, size_t index1) const {
+          brick::common::Int64 const* key0Ptr = &(m_keys[index0 * m_dimension]);
+          return std::equal(key0Ptr, key0Ptr + m_dimension,
+                            &(m_keys[index1 * m_dimension]));
+        }
+
+      private:
+
+        std::vector<brick::common::Int64> const& m_keys;
+        unsigned int m_dimension;
+      };
+
+
+      // Shuffles a sequence of indices in place.
+      inline void
+      icpShuffle(std::vector<size_t>& indices,
+                 brick::random::PseudoRandom& pRandom)
+      {
+        for(size_t ii = indices.size(); ii > 1; --ii) {
+          size_t jj = static_cast<size_t>(pRandom.uniformInt(0, int(ii)));
+          std::swap(indices[ii - 1], indices[jj]);
+        }
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+
     // The default constructor.
     template <unsigned int Dimension, class Type, class FloatType>
     IterativeClosestPoint<Dimension, Type, FloatType>::
     IterativeClosestPoint()
       : m_convergenceThreshold(0.1), // TBD: set this and add better term crit.
         m_distanceThreshold(1.0),    // TBD: set this and add better criterion.
+        m_errorMetric(BRICK_CV_ICP_POINT_TO_POINT),
         m_iterationCount(0),
-        m_modelTree()
+        m_modelNormals(),
+        m_modelTree(),
+        m_numberOfQueryPoints(0),
+        m_randomSeed(0),
+        m_selectionStrategy(BRICK_CV_ICP_SELECT_ALL),
+        m_threadPoolPtr(0),
+        m_voxelSize(0)
     {
       // Empty.
     }
@@ -81,8 +245,15 @@ namespace brick {
       brick::numeric::Transform3D<FloatType> modelFromQuery =
         modelFromQueryEstimate;
 
+      if(m_errorMetric == BRICK_CV_ICP_POINT_TO_PLANE
+         && m_modelNormals.size() != m_modelTree.getSize()) {
+        this->estimateNormals(m_modelTree, m_modelTree.begin(),
+                              m_modelTree.end(), m_modelNormals);
+      }
+
       m_iterationCount = 0;
       unsigned int pointCount = 0;
+      unsigned int numberOfStableSteps = 0;
       FloatType rmsError(0);
       bool isConverged = false;
       while(!isConverged) {
@@ -99,16 +270,35 @@ namespace brick {
           matchingModelPointAddresses, weights, pointCount, rmsError,
           selectedQueryPoints, modelFromQueryHypothesis);
 
-        // Check for convergence.
-        if(!isQuerySetChanged && !isMatchingSetChanged) {
-          isConverged = true;
-          continue;
+        bool isSetChanged = isQuerySetChanged || isMatchingSetChanged;
+
+        if(m_errorMetric == BRICK_CV_ICP_POINT_TO_PLANE) {
+          // Unchanged correspondences don't mean we're done, because
+          // each iteration only takes a single linearized step.
+          FloatType stepSize;
+          modelFromQuery = this->estimateTransformPointToPlane(
+            selectedQueryPoints, matchingModelPointAddresses, weights,
+            modelFromQueryHypothesis, stepSize);
+          numberOfStableSteps = isSetChanged ? 0 : (numberOfStableSteps + 1);
+          if(!isSetChanged
+             && (stepSize < privateCode::icpPointToPlaneStepThreshold
+                 || (numberOfStableSteps
+                     >= privateCode::icpPointToPlaneMaximumStableSteps))) {
+            isConverged = true;
+            continue;
+          }
+        } else {
+          // Check for convergence.
+          if(!isSetChanged) {
+            isConverged = true;
+            continue;
+          }
+
+          // Re-estimate coordinate transformation.
+          modelFromQuery = this->estimateTransformModelFromQuery(
+            selectedQueryPoints, matchingModelPointAddresses, weights);
         }
 
-        // Re-estimate coordinate transformation.
-        modelFromQuery = this->estimateTransformModelFromQuery(
-          selectedQueryPoints, matchingModelPointAddresses, weights);
-
         ++m_iterationCount;
       }
 
@@ -117,6 +307,20 @@ namespace brick {
 
 
 
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    setErrorMetric(IcpErrorMetric errorMetric)
+    {
+      if(errorMetric == BRICK_CV_ICP_POINT_TO_PLANE && Dimension != 3) {
+        BRICK_THROW(brick::common::ValueException,
+                    "IterativeClosestPoint::setErrorMetric()",
+                    "Point-to-plane registration requires Dimension == 3.");
+      }
+      m_errorMetric = errorMetric;
+    }
+
+
     template <unsigned int Dimension, class Type, class FloatType>
       template <class Iter>
       void
@@ -125,11 +329,113 @@ namespace brick {
     {
       this->m_modelTree.clear();
       this->m_modelTree.addSamples(beginIter, endIter);
+      this->m_modelNormals.clear();
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    setQuerySelectionStrategy(IcpSelectionStrategy strategy,
+                              size_t numberOfQueryPoints,
+                              FloatType voxelSize,
+                              brick::common::Int64 randomSeed)
+    {
+      if(strategy == BRICK_CV_ICP_SELECT_VOXEL_GRID
+         && !(voxelSize > FloatType(0))) {
+        BRICK_THROW(brick::common::ValueException,
+                    "IterativeClosestPoint::setQuerySelectionStrategy()",
+                    "Argument voxelSize must be greater than zero.");
+      }
+      if(strategy == BRICK_CV_ICP_SELECT_NORMAL_SPACE && Dimension != 3) {
+        BRICK_THROW(brick::common::ValueException,
+                    "IterativeClosestPoint::setQuerySelectionStrategy()",
+                    "Normal space sampling requires Dimension == 3.");
+      }
+      m_selectionStrategy = strategy;
+      m_numberOfQueryPoints = numberOfQueryPoints;
+      m_voxelSize = voxelSize;
+      m_randomSeed = randomSeed;
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr)
+    {
+      m_threadPoolPtr = threadPoolPtr;
     }
 
 
     /* ================ Protected ================= */
 
+    // Estimates the surface normal at each point in [beginIter,
+    // endIter) from the covariance of its nearest neighbors in
+    // argument tree.  The sign of each normal is arbitrary.
+    template <unsigned int Dimension, class Type, class FloatType>
+    template <class Iter>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    estimateNormals(
+      KDTree<Dimension, Type, FloatType> const& tree,
+      Iter beginIter, Iter endIter,
+      std::vector< brick::numeric::Vector3D<FloatType> >& normals)
+    {
+      size_t const numberOfPoints = endIter - beginIter;
+      size_t const numberOfNeighbors = std::min(
+        privateCode::icpNumberOfNormalNeighbors, tree.getSize());
+      std::vector<Type const*> neighbors;
+      std::vector<FloatType> distances;
+      if(m_threadPoolPtr != 0) {
+        tree.findKNearest(beginIter, endIter, numberOfNeighbors,
+                          neighbors, distances, *m_threadPoolPtr);
+      } else {
+        tree.findKNearest(beginIter, endIter, numberOfNeighbors,
+                          neighbors, distances);
+      }
+
+      normals.resize(numberOfPoints);
+      brick::numeric::Array2D<brick::common::Float64> covariance(3, 3);
+      brick::numeric::Array1D<brick::common::Float64> eigenvalues;
+      brick::numeric::Array2D<brick::common::Float64> eigenvectors;
+      for(size_t ii = 0; ii < numberOfPoints; ++ii) {
+        Type const* const* neighborPtrs = &(neighbors[ii * numberOfNeighbors]);
+        brick::common::Float64 mean[3] = {0.0, 0.0, 0.0};
+        for(size_t nn = 0; nn < numberOfNeighbors; ++nn) {
+          for(size_t rr = 0; rr < 3; ++rr) {
+            mean[rr] += (*(neighborPtrs[nn]))[rr];
+          }
+        }
+        for(size_t rr = 0; rr < 3; ++rr) {
+          mean[rr] /= numberOfNeighbors;
+        }
+        covariance = 0.0;
+        for(size_t nn = 0; nn < numberOfNeighbors; ++nn) {
+          for(size_t rr = 0; rr < 3; ++rr) {
+            brick::common::Float64 rowTerm =
+              (*(neighborPtrs[nn]))[rr] - mean[rr];
+            for(size_t cc = rr; cc < 3; ++cc) {
+              covariance(rr, cc) +=
+                rowTerm * ((*(neighborPtrs[nn]))[cc] - mean[cc]);
+            }
+          }
+        }
+        covariance(1, 0) = covariance(0, 1);
+        covariance(2, 0) = covariance(0, 2);
+        covariance(2, 1) = covariance(1, 2);
+
+        // Eigenvalues are returned in descending order, so the
+        // normal is the last eigenvector.
+        brick::linearAlgebra::eigenvectorsSymmetric(
+          covariance, eigenvalues, eigenvectors);
+        normals[ii].setValue(static_cast<FloatType>(eigenvectors(0, 2)),
+                             static_cast<FloatType>(eigenvectors(1, 2)),
+                             static_cast<FloatType>(eigenvectors(2, 2)));
+      }
+    }
+
+
 
     template <unsigned int Dimension, class Type, class FloatType>
     brick::numeric::Transform3D<FloatType>
@@ -152,6 +458,90 @@ namespace brick {
     }
 
 
+    // One Gauss-Newton step of point-to-plane registration.  With
+    // p = modelFromQuery * q, and the incremental rotation linearized
+    // as R ~= I + [omega]_x, each match contributes the residual
+    //
+    //   r = n . (p + omega x p + t - m)
+    //     = n . (p - m) + (p x n) . omega + n . t,
+    //
+    // which is linear in (omega, t).
+    template <unsigned int Dimension, class Type, class FloatType>
+    brick::numeric::Transform3D<FloatType>
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    estimateTransformPointToPlane(
+      std::vector<Type> const& selectedQueryPoints,
+      std::vector<Type const*> const& matchingModelPointAddresses,
+      std::vector<FloatType> const& weights,
+      brick::numeric::Transform3D<FloatType> const& modelFromQuery,
+      FloatType& stepSize)
+    {
+      brick::numeric::Array2D<brick::common::Float64> AA(6, 6);
+      brick::numeric::Array1D<brick::common::Float64> bb(6);
+      AA = 0.0;
+      bb = 0.0;
+      Type const* modelBeginPtr = &(*(m_modelTree.begin()));
+      size_t numberOfMatches = 0;
+      for(size_t ii = 0; ii < selectedQueryPoints.size(); ++ii) {
+        if(weights[ii] == FloatType(0)) {
+          continue;
+        }
+        brick::numeric::Vector3D<FloatType> transformedQueryPoint =
+          modelFromQuery * selectedQueryPoints[ii];
+        Type const& modelPoint = *(matchingModelPointAddresses[ii]);
+        brick::numeric::Vector3D<FloatType> const& normal =
+          m_modelNormals[matchingModelPointAddresses[ii] - modelBeginPtr];
+        brick::numeric::Vector3D<FloatType> offset(
+          transformedQueryPoint.x() - modelPoint[0],
+          transformedQueryPoint.y() - modelPoint[1],
+          transformedQueryPoint.z() - modelPoint[2]);
+        brick::numeric::Vector3D<FloatType> rotationTerm =
+          brick::numeric::cross(transformedQueryPoint, normal);
+
+        brick::common::Float64 jacobian[6] = {
+          rotationTerm.x(), rotationTerm.y(), rotationTerm.z(),
+          normal.x(), normal.y(), normal.z()};
+        brick::common::Float64 residual =
+          weights[ii] * brick::numeric::dot<FloatType>(offset, normal);
+        for(size_t rr = 0; rr < 6; ++rr) {
+          for(size_t cc = rr; cc < 6; ++cc) {
+            AA(rr, cc) += weights[ii] * jacobian[rr] * jacobian[cc];
+          }
+          bb[rr] -= jacobian[rr] * residual;
+        }
+        ++numberOfMatches;
+      }
+
+      // Too few matches to constrain all six degrees of freedom.
+      if(numberOfMatches < 6) {
+        stepSize = FloatType(0);
+        return modelFromQuery;
+      }
+
+      for(size_t rr = 1; rr < 6; ++rr) {
+        for(size_t cc = 0; cc < rr; ++cc) {
+          AA(rr, cc) = AA(cc, rr);
+        }
+      }
+      brick::linearAlgebra::linearSolveInPlace(AA, bb);
+
+      brick::numeric::Vector3D<FloatType> rodrigues(
+        static_cast<FloatType>(bb[0]), static_cast<FloatType>(bb[1]),
+        static_cast<FloatType>(bb[2]));
+      brick::numeric::Transform3D<FloatType> incrementalTransform =
+        brick::numeric::rodriguesToTransform3D<FloatType>(
+          rodrigues, FloatType(1.0E-30));
+      incrementalTransform.setValue(0, 3, static_cast<FloatType>(bb[3]));
+      incrementalTransform.setValue(1, 3, static_cast<FloatType>(bb[4]));
+      incrementalTransform.setValue(2, 3, static_cast<FloatType>(bb[5]));
+      stepSize = static_cast<FloatType>(
+        brick::common::squareRoot(bb[0] * bb[0] + bb[1] * bb[1] + bb[2] * bb[2])
+        + brick::common::squareRoot(bb[3] * bb[3] + bb[4] * bb[4]
+                                    + bb[5] * bb[5]));
+      return incrementalTransform * modelFromQuery;
+    }
+
+
     template <unsigned int Dimension, class Type, class FloatType>
     bool
     IterativeClosestPoint<Dimension, Type, FloatType>::
@@ -176,36 +566,31 @@ namespace brick {
         isMatchingSetChanged = true;
       }
 
-      // Iterate over all query points.
-      for(unsigned int ii = 0; ii < queryPoints.size(); ++ii) {
-
-        // Transform the query point using our best-so-far estimate of
-        // the final coordinate transformation.
-        brick::numeric::Vector3D<FloatType> transformedQueryPoint =
-          modelFromQuery * queryPoints[ii];
-
-        // Find the model point that is nearest to the current
-        // transformed query point.
-        FloatType distance;
-        Type const* matchingPointPtr = &(this->m_modelTree.findNearest(
-                                           transformedQueryPoint, distance));
-
-        // Notice if this particular point match has changed since the
-        // last ICP iteration, and remember the match.
-        isMatchingSetChanged |= (matchingPointPtr
-                                 != matchingModelPointAddresses[ii]);
-        matchingModelPointAddresses[ii] = matchingPointPtr;
-
-        // Checks of normals, etc., go here.
-        if(distance < this->m_distanceThreshold) {
-          weights[ii] = 1.0;
-          rmsError += distance * distance;
-          ++count;
-        } else {
-          weights[ii] = 0.0;
+      // Match all query points, one block at a time.
+      size_t numberOfBlocks =
+        ((queryPoints.size() + privateCode::icpMatchBlockSize - 1)
+         / privateCode::icpMatchBlockSize);
+      std::vector<unsigned int> blockCounts(numberOfBlocks, 0);
+      std::vector<FloatType> blockSquaredErrors(numberOfBlocks, FloatType(0));
+      std::vector<char> blockChangeFlags(numberOfBlocks, 0);
+      privateCode::IcpMatchFunctor<Dimension, Type, FloatType> matchFunctor(
+        *this, queryPoints, modelFromQuery, matchingModelPointAddresses,
+        weights, blockCounts, blockSquaredErrors, blockChangeFlags);
+      if(m_threadPoolPtr != 0 && numberOfBlocks > 1) {
+        m_threadPoolPtr->parallelFor(numberOfBlocks, matchFunctor);
+      } else {
+        for(size_t block = 0; block < numberOfBlocks; ++block) {
+          matchFunctor(block);
         }
       }
 
+      // Combine the per-block results in a fixed order.
+      for(size_t block = 0; block < numberOfBlocks; ++block) {
+        count += blockCounts[block];
+        rmsError += blockSquaredErrors[block];
+        isMatchingSetChanged |= (blockChangeFlags[block] != 0);
+      }
+
       // std::sort(distances.begin(), distance.end());
       typedef unsigned int UInt;
       count = std::max(count, UInt(1));
@@ -223,10 +608,188 @@ namespace brick {
     selectQueryPoints(std::vector<Type>& selectedQueryPoints,
                       std::vector<Type> const& allQueryPoints)
     {
-      selectedQueryPoints = allQueryPoints;
+      // The selection is made once, on the first iteration, and
+      // then held fixed so that the iteration can converge.
+      if(m_iterationCount != 0) {
+        return false;
+      }
+
+      switch(m_selectionStrategy) {
+      case BRICK_CV_ICP_SELECT_RANDOM:
+        this->selectQueryPointsRandom(selectedQueryPoints, allQueryPoints);
+        break;
+      case BRICK_CV_ICP_SELECT_NORMAL_SPACE:
+        this->selectQueryPointsNormalSpace(selectedQueryPoints, allQueryPoints);
+        break;
+      case BRICK_CV_ICP_SELECT_VOXEL_GRID:
+        this->selectQueryPointsVoxelGrid(selectedQueryPoints, allQueryPoints);
+        break;
+      default:
+        selectedQueryPoints = allQueryPoints;
+        break;
+      }
       return false;
     }
 
+
+    // Normal space sampling, after Rusinkiewicz and Levoy, "Efficient
+    // Variants of the ICP Algorithm," 3DIM 2001.  Normals are binned
+    // by direction, and points are drawn from the bins in turn.
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    selectQueryPointsNormalSpace(std::vector<Type>& selectedQueryPoints,
+                                 std::vector<Type> const& allQueryPoints)
+    {
+      size_t const numberOfPoints = allQueryPoints.size();
+      if(m_numberOfQueryPoints == 0
+         || m_numberOfQueryPoints >= numberOfPoints) {
+        selectedQueryPoints = allQueryPoints;
+        return;
+      }
+
+      // Estimate the normal of every query point, and sort the normals
+      // into binsPerAxis^3 bins according to the quantized value of
+      // each of their elements.  Normals have no preferred sign, so
+      // flip them to make the largest element positive.
+      KDTree<Dimension, Type, FloatType> queryTree(
+        allQueryPoints.begin(), allQueryPoints.end());
+      std::vector< brick::numeric::Vector3D<FloatType> > normals;
+      this->estimateNormals(queryTree, allQueryPoints.begin(),
+                            allQueryPoints.end(), normals);
+
+      size_t const binsPerAxis = 4;
+      std::vector< std::vector<size_t> > bins(
+        binsPerAxis * binsPerAxis * binsPerAxis);
+      for(size_t ii = 0; ii < numberOfPoints; ++ii) {
+        FloatType normal[3] = {normals[ii].x(), normals[ii].y(), normals[ii].z()};
+        size_t largestIndex = 0;
+        for(size_t rr = 1; rr < 3; ++rr) {
+          if(std::fabs(normal[rr]) > std::fabs(normal[largestIndex])) {
+            largestIndex = rr;
+          }
+        }
+        FloatType sign = (normal[largestIndex] < FloatType(0)) ? -1.0 : 1.0;
+        size_t binIndex = 0;
+        for(size_t rr = 0; rr < 3; ++rr) {
+          size_t axisBin = static_cast<size_t>(
+            (sign * normal[rr] + 1.0) * 0.5 * binsPerAxis);
+          binIndex = binIndex * binsPerAxis + std::min(axisBin, binsPerAxis - 1);
+        }
+        bins[binIndex].push_back(ii);
+      }
+
+      // Draw points from each bin in turn, in random order within
+      // each bin, so that sparsely populated orientations are
+      // represented as well as the common ones.
+      brick::random::PseudoRandom pRandom(m_randomSeed);
+      for(size_t bin = 0; bin < bins.size(); ++bin) {
+        privateCode::icpShuffle(bins[bin], pRandom);
+      }
+      std::vector<size_t> selectedIndices;
+      selectedIndices.reserve(m_numberOfQueryPoints);
+      for(size_t level = 0; selectedIndices.size() < m_numberOfQueryPoints;
+          ++level) {
+        for(size_t bin = 0;
+            bin < bins.size() && selectedIndices.size() < m_numberOfQueryPoints;
+            ++bin) {
+          if(level < bins[bin].size()) {
+            selectedIndices.push_back(bins[bin][level]);
+          }
+        }
+      }
+
+      std::sort(selectedIndices.begin(), selectedIndices.end());
+      selectedQueryPoints.resize(selectedIndices.size());
+      for(size_t ii = 0; ii < selectedIndices.size(); ++ii) {
+        selectedQueryPoints[ii] = allQueryPoints[selectedIndices[ii]];
+      }
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    selectQueryPointsRandom(std::vector<Type>& selectedQueryPoints,
+                            std::vector<Type> const& allQueryPoints)
+    {
+      size_t const numberOfPoints = allQueryPoints.size();
+      if(m_numberOfQueryPoints == 0
+         || m_numberOfQueryPoints >= numberOfPoints) {
+        selectedQueryPoints = allQueryPoints;
+        return;
+      }
+
+      // Partial Fisher-Yates shuffle.  The chosen points are then
+      // put back in their original order, which keeps neighboring
+      // queries close together in memory.
+      brick::random::PseudoRandom pRandom(m_randomSeed);
+      std::vector<size_t> indices(numberOfPoints);
+      for(size_t ii = 0; ii < numberOfPoints; ++ii) {
+        indices[ii] = ii;
+      }
+      for(size_t ii = 0; ii < m_numberOfQueryPoints; ++ii) {
+        size_t jj = static_cast<size_t>(
+          pRandom.uniformInt(int(ii), int(numberOfPoints)));
+        std::swap(indices[ii], indices[jj]);
+      }
+      std::sort(indices.begin(), indices.begin() + m_numberOfQueryPoints);
+
+      selectedQueryPoints.resize(m_numberOfQueryPoints);
+      for(size_t ii = 0; ii < m_numberOfQueryPoints; ++ii) {
+        selectedQueryPoints[ii] = allQueryPoints[indices[ii]];
+      }
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    IterativeClosestPoint<Dimension, Type, FloatType>::
+    selectQueryPointsVoxelGrid(std::vector<Type>& selectedQueryPoints,
+                               std::vector<Type> const& allQueryPoints)
+    {
+      size_t const numberOfPoints = allQueryPoints.size();
+      std::vector<brick::common::Int64> keys(numberOfPoints * Dimension);
+      std::vector<size_t> indices(numberOfPoints);
+      for(size_t ii = 0; ii < numberOfPoints; ++ii) {
+        indices[ii] = ii;
+        for(unsigned int dd = 0; dd < Dimension; ++dd) {
+          keys[ii * Dimension + dd] = static_cast<brick::common::Int64>(
+            std::floor(allQueryPoints[ii][dd] / m_voxelSize));
+        }
+      }
+      privateCode::IcpVoxelLess voxelLess(keys, Dimension);
+      std::stable_sort(indices.begin(), indices.end(), voxelLess);
+
+      // Keep the point nearest the center of each occupied voxel.
+      selectedQueryPoints.clear();
+      size_t runBegin = 0;
+      while(runBegin < numberOfPoints) {
+        size_t bestIndex = indices[runBegin];
+        FloatType bestDistance = std::numeric_limits<FloatType>::max();
+        size_t runEnd = runBegin;
+        for(; runEnd < numberOfPoints
+              && voxelLess.isSameVoxel(indices[runBegin], indices[runEnd]);
+            ++runEnd) {
+          size_t pointIndex = indices[runEnd];
+          FloatType distance(0);
+          for(unsigned int dd = 0; dd < Dimension; ++dd) {
+            FloatType center =
+              (FloatType(keys[pointIndex * Dimension + dd]) + FloatType(0.5))
+              * m_voxelSize;
+            FloatType offset = allQueryPoints[pointIndex][dd] - center;
+            distance += offset * offset;
+          }
+          if(distance < bestDistance) {
+            bestDistance = distance;
+            bestIndex = pointIndex;
+          }
+        }
+        selectedQueryPoints.push_back(allQueryPoints[bestIndex]);
+        runBegin = runEnd;
+      }
+    }
+
   } // namespace computerVision
 
 } // namespace brick
@@ -15,7 +15,9 @@
 
 #include <cstdlib>
 #include <functional>
+#include <utility>
 #include <vector>
+#include <brick/common/threadPool.hh>
 
 
 namespace brick {
@@ -186,6 +188,49 @@ namespace brick {
 
 
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Identifies one branch of a KDTree, along with a lower bound
+      // on the distance from the query point to any point in the
+      // branch.  Used to keep track of branches that have yet to be
+      // searched.
+      template <class FloatType>
+      struct KDTreeBranch {
+        size_t beginIndex;
+        size_t endIndex;
+        unsigned int level;
+        FloatType bound;
+      };
+
+
+      // A search visits branches depth-first, and each level adds at
+      // most one pending branch, so the stack never needs to be
+      // deeper than the number of bits in a size_t, plus a little.
+      const size_t kdTreeMaximumStackSize = 2 * 64 + 2;
+
+
+      // Orders the priority queue of an approximate search so that
+      // the branch with the smallest bound is searched first.
+      template <class FloatType>
+      struct KDTreeBranchGreater {
+        bool operator()(KDTreeBranch<FloatType> const& arg0,
+                        KDTreeBranch<FloatType> const& arg1) const {
+          return arg1.bound < arg0.bound;
+        }
+      };
+
+
+      // Answers a band of the queries passed to the batch versions
+      // of KDTree::findKNearest().  Defined in kdTree_impl.hh.
+      template <unsigned int Dimension, class Type, class FloatType,
+                class Iter>
+      class KDTreeBatchFunctor;
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** This class implements a basic KD-Tree data structure.
      ** Template argument Dimension specifies how many dimensions the
@@ -200,6 +245,15 @@ namespace brick {
      ** currently does not support adding points after construction or
      ** rebalancing.
      **
+     ** The tree has no node objects.  All of the points are stored in
+     ** a single contiguous array, arranged so that the median point
+     ** of each branch sits in the middle of the branch's range, with
+     ** the two sub-branches on either side of it.  Branches
+     ** containing no more than a few points (see the constructor
+     ** argument leafSize) are not subdivided further, and are simply
+     ** scanned when searching.  The tree is built by repeated
+     ** partitioning using std::nth_element(), in O(N*log(N)) time.
+     **
      ** Here's an example of how to use the KDTree class template:
      **
      ** @code
@@ -230,10 +284,24 @@ namespace brick {
     class KDTree {
     public:
 
+      /**
+       * Iterator type for read-only access to the tree elements.
+       */
+      typedef typename std::vector<Type>::const_iterator const_iterator;
+
+
       /**
        * The default constructor creates an empty tree.
+       *
+       * @param leafSize This argument specifies the largest number
+       * of points that will be stored in a single leaf of the tree.
+       * Leaves are searched exhaustively, so small values make for
+       * deeper trees with fewer distance computations per query,
+       * while larger values make for shallower trees with better
+       * memory locality.
        */
-      KDTree();
+      explicit
+      KDTree(size_t leafSize = 8);
 
 
       /**
@@ -249,9 +317,13 @@ namespace brick {
        * @param endIter This argument is an interator pointing one
        * element past the last Type instance in the sequence that is
        * to be inserted into the tree.
+       *
+       * @param leafSize This argument specifies the largest number
+       * of points that will be stored in a single leaf of the tree.
+       * See KDTree(size_t).
        */
       template <class Iter>
-      KDTree(Iter beginIter, Iter endIter);
+      KDTree(Iter beginIter, Iter endIter, size_t leafSize = 8);
 
 
       /**
@@ -324,45 +396,333 @@ namespace brick {
        * between the point for which we're searching and the closest
        * point in the tree.  It will be computed using
        * KDComparator<Dimension, Type>::computeDistance(Type const&,
-       * Type const&).
+       * Type const&).  If the tree is empty, it will be set to
+       * std::numeric_limits<FloatType>::max().
        *
        * @return The return value is a const reference to the closest
-       * point in the tree.
+       * point in the tree.  If the tree is empty, the return value
+       * refers to a default-constructed Type instance.
        */
       Type const&
       findNearest(Type const& point, FloatType& distance) const;
 
 
-      // void
-      // rebalance();
+      /**
+       * This member function works like findNearest(Type const&,
+       * FloatType&), but trades accuracy for speed.  Unexplored
+       * branches are kept in a priority queue and searched in order
+       * of their distance from the query point ("best bin first"),
+       * and the search gives up early according to the two arguments
+       * epsilon and maximumLeafVisits.  This is most useful for
+       * high-dimensional points, such as feature descriptors, for
+       * which the exact search must examine a large fraction of the
+       * tree.  Setting both epsilon and maximumLeafVisits to zero
+       * gives the same result as findNearest(), but more slowly.
+       *
+       * @param point This argument is the Type instance to search
+       * for.
+       *
+       * @param distance This argument is used to return the distance
+       * between point and the tree element that was found, as
+       * computed by KDComparator<Dimension, Type>::computeDistance().
+       * If the tree is empty, it will be set to
+       * std::numeric_limits<FloatType>::max().
+       *
+       * @param epsilon This argument specifies how much error to
+       * tolerate.  Branches that cannot contain a point closer than
+       * distance / (1 + epsilon) are not searched, so the returned
+       * distance is at most (1 + epsilon) times the distance to the
+       * true nearest neighbor.  Note that for the default
+       * KDComparator, distances are squared, so the bound on
+       * Euclidean distance is sqrt(1 + epsilon).
+       *
+       * @param maximumLeafVisits This argument limits the number of
+       * times the search descends from the priority queue to a leaf
+       * of the tree.  The search stops after this many descents, even
+       * if the epsilon bound has not been reached.  Setting this
+       * argument to zero removes the limit.  Smaller values are
+       * faster and less accurate.
+       *
+       * @return The return value is a const reference to the tree
+       * element that was found.  If the tree is empty, the return
+       * value refers to a default-constructed Type instance.
+       */
+      Type const&
+      findNearestApproximate(Type const& point, FloatType& distance,
+                             FloatType epsilon,
+                             size_t maximumLeafVisits = 0) const;
 
 
-    protected:
+      /**
+       * This member function finds the nearest tree element for each
+       * of a sequence of query points.  It is equivalent to calling
+       * findNearest(Type const&, FloatType&) once for each query.
+       *
+       * @param queryBeginIter This argument is a random access
+       * iterator pointing to the first query point.
+       *
+       * @param queryEndIter This argument is a random access iterator
+       * pointing one element past the last query point.
+       *
+       * @param nearestPoints This argument is used to return
+       * pointers to the closest tree element for each query point,
+       * in the same order as the queries.  If the tree is empty, the
+       * pointers will be 0.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances, as computed by
+       * KDComparator<Dimension, Type>::computeDistance().
+       */
+      template <class Iter>
+      void
+      findNearest(Iter queryBeginIter, Iter queryEndIter,
+                  std::vector<Type const*>& nearestPoints,
+                  std::vector<FloatType>& distances) const;
 
+
+      /**
+       * This member function works just like findNearest(Iter, Iter,
+       * std::vector<Type const*>&, std::vector<FloatType>&), but
+       * divides the queries among the threads of the specified
+       * ThreadPool.  The results are identical to those of the
+       * serial version.
+       *
+       * @param queryBeginIter This argument is a random access
+       * iterator pointing to the first query point.
+       *
+       * @param queryEndIter This argument is a random access iterator
+       * pointing one element past the last query point.
+       *
+       * @param nearestPoints This argument is used to return
+       * pointers to the closest tree element for each query point.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances.
+       *
+       * @param threadPool This argument is the ThreadPool that will
+       * answer the queries.
+       */
       template <class Iter>
-      KDTree(Iter beginIter, Iter endIter, size_t vectorSize, size_t level);
+      void
+      findNearest(Iter queryBeginIter, Iter queryEndIter,
+                  std::vector<Type const*>& nearestPoints,
+                  std::vector<FloatType>& distances,
+                  brick::common::ThreadPool& threadPool) const;
+
 
+      /**
+       * This member function finds the k tree elements that are
+       * closest to the specified point.  A bounded priority queue
+       * holds the best k candidates found so far, and branches of the
+       * tree that cannot contain anything closer than the worst of
+       * them are skipped.
+       *
+       * @param point This argument is the Type instance to search
+       * for.
+       *
+       * @param kk This argument specifies how many neighbors to
+       * find.
+       *
+       * @param neighbors This argument is used to return pointers to
+       * the closest min(kk, getSize()) tree elements, sorted from
+       * nearest to farthest.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances, as computed by
+       * KDComparator<Dimension, Type>::computeDistance().
+       *
+       * @return The return value is the number of neighbors found,
+       * which is min(kk, getSize()).
+       */
+      size_t
+      findKNearest(Type const& point, size_t kk,
+                   std::vector<Type const*>& neighbors,
+                   std::vector<FloatType>& distances) const;
 
+
+      /**
+       * This member function finds the kk nearest neighbors of each
+       * of a sequence of query points.  Results are returned in
+       * row-major order: elements [ii * kk ... (ii + 1) * kk - 1] of
+       * the output vectors hold the neighbors of query ii, sorted
+       * from nearest to farthest.  If the tree has fewer than kk
+       * points, the unused slots hold null pointers and distances of
+       * std::numeric_limits<FloatType>::max().
+       *
+       * @param queryBeginIter This argument is a random access
+       * iterator pointing to the first query point.
+       *
+       * @param queryEndIter This argument is a random access iterator
+       * pointing one element past the last query point.
+       *
+       * @param kk This argument specifies how many neighbors to find
+       * for each query.
+       *
+       * @param neighbors This argument is used to return pointers to
+       * the neighbors of each query.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances.
+       */
       template <class Iter>
       void
-      construct(Iter beginIter, Iter endIter, size_t vectorSize, size_t level);
+      findKNearest(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+                   std::vector<Type const*>& neighbors,
+                   std::vector<FloatType>& distances) const;
 
+
+      /**
+       * This member function works just like findKNearest(Iter,
+       * Iter, size_t, std::vector<Type const*>&,
+       * std::vector<FloatType>&), but divides the queries among the
+       * threads of the specified ThreadPool.  The results are
+       * identical to those of the serial version.
+       *
+       * @param queryBeginIter This argument is a random access
+       * iterator pointing to the first query point.
+       *
+       * @param queryEndIter This argument is a random access iterator
+       * pointing one element past the last query point.
+       *
+       * @param kk This argument specifies how many neighbors to find
+       * for each query.
+       *
+       * @param neighbors This argument is used to return pointers to
+       * the neighbors of each query.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances.
+       *
+       * @param threadPool This argument is the ThreadPool that will
+       * answer the queries.
+       */
+      template <class Iter>
       void
-      findNearestIterative(Type const& point,
-                           Type const*& bestPointPtr,
-                           FloatType& bestDistance) const;
+      findKNearest(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+                   std::vector<Type const*>& neighbors,
+                   std::vector<FloatType>& distances,
+                   brick::common::ThreadPool& threadPool) const;
+
+
+      /**
+       * This member function finds every tree element that lies
+       * within the specified distance of a point.
+       *
+       * @param point This argument is the Type instance to search
+       * around.
+       *
+       * @param maximumDistance This argument specifies the search
+       * radius, in the units returned by KDComparator<Dimension,
+       * Type>::computeDistance().  For the default KDComparator,
+       * these are units of squared distance, so to find points
+       * within radius r, pass r * r.  Points at exactly this
+       * distance are included.
+       *
+       * @param neighbors This argument is used to return pointers to
+       * the tree elements that were found, in no particular order.
+       *
+       * @param distances This argument is used to return the
+       * corresponding distances.
+       *
+       * @return The return value is the number of tree elements
+       * found.
+       */
+      size_t
+      findWithinRadius(Type const& point, FloatType maximumDistance,
+                       std::vector<Type const*>& neighbors,
+                       std::vector<FloatType>& distances) const;
+
 
+      /**
+       * This member function returns the number of points in the
+       * tree.
+       *
+       * @return The return value is the number of points passed to
+       * the most recent call to addSamples().
+       */
+      size_t
+      getSize() const {return m_points.size();}
 
+
+      /**
+       * This member function returns an iterator pointing to the
+       * first tree element.  The elements are stored in a single
+       * contiguous array, in an order determined by the tree
+       * structure, and the pointers returned by findKNearest(),
+       * findWithinRadius(), etc., all point into the range [begin(),
+       * end()).  This makes it easy to keep per-element data in a
+       * parallel array, indexed by (pointer - &(*begin())).
+       *
+       * @return The return value is an iterator pointing to the first
+       * tree element.
+       */
+      const_iterator
+      begin() const {return m_points.begin();}
+
+
+      /**
+       * This member function returns an iterator pointing one
+       * element past the last tree element.  See begin().
+       *
+       * @return The return value is an iterator pointing one element
+       * past the last tree element.
+       */
+      const_iterator
+      end() const {return m_points.end();}
+
+
+    protected:
+
+      template <unsigned int Dimension2, class Type2, class FloatType2,
+                class Iter2>
+      friend class privateCode::KDTreeBatchFunctor;
+
+
+      // The candidates of a k-nearest-neighbor search are kept in a
+      // max-heap of (distance, point) pairs.
+      typedef std::pair<FloatType, Type const*> Candidate;
+
+
+      template <class Iter>
       void
-      findNearestRecursive(Type const& point,
+      findBatch(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+                std::vector<Type const*>& neighbors,
+                std::vector<FloatType>& distances,
+                brick::common::ThreadPool* threadPoolPtr) const;
+
+
+      void
+      construct(size_t beginIndex, size_t endIndex, unsigned int level);
+
+
+      bool
+      isLeaf(size_t beginIndex, size_t endIndex) const {
+        return (endIndex - beginIndex) <= m_leafSize;
+      }
+
+
+      void
+      findNearestBestBinFirst(Type const& point, FloatType epsilon,
+                              size_t maximumLeafVisits,
+                              Type const*& bestPointPtr,
+                              FloatType& bestDistance) const;
+
+
+      void
+      findKNearestIterative(Type const& point, size_t kk,
+                            std::vector<Candidate>& candidates) const;
+
+
+      void
+      findNearestIterative(Type const& point,
                            Type const*& bestPointPtr,
                            FloatType& bestDistance) const;
 
 
-      KDComparator<Dimension, Type> m_comparator;
-      Type m_point;
-      KDTree* m_leftChild;
-      KDTree* m_rightChild;
+      std::vector< KDComparator<Dimension, Type> > m_comparators;
+      Type m_defaultPoint;
+      size_t m_leafSize;
+      std::vector<Type> m_points;
     };
 
   } // namespace computerVision
@@ -20,8 +20,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <limits>
-#include <stack>
+#include <utility>
 
 namespace brick {
 
@@ -30,23 +31,30 @@ namespace brick {
 
     template <unsigned int Dimension, class Type, class FloatType>
     KDTree<Dimension, Type, FloatType>::
-    KDTree()
-      : m_comparator(0),
-        m_point(),
-        m_leftChild(0),
-        m_rightChild(0)
-    {}
+    KDTree(size_t leafSize)
+      : m_comparators(),
+        m_defaultPoint(),
+        m_leafSize(leafSize),
+        m_points()
+    {
+      for(unsigned int axis = 0; axis < Dimension; ++axis) {
+        m_comparators.push_back(KDComparator<Dimension, Type>(axis));
+      }
+    }
 
 
     template <unsigned int Dimension, class Type, class FloatType>
     template <class Iter>
     KDTree<Dimension, Type, FloatType>::
-    KDTree(Iter beginIter, Iter endIter)
-      : m_comparator(0),
-        m_point(),
-        m_leftChild(0),
-        m_rightChild(0)
+    KDTree(Iter beginIter, Iter endIter, size_t leafSize)
+      : m_comparators(),
+        m_defaultPoint(),
+        m_leafSize(leafSize),
+        m_points()
     {
+      for(unsigned int axis = 0; axis < Dimension; ++axis) {
+        m_comparators.push_back(KDComparator<Dimension, Type>(axis));
+      }
       this->addSamples(beginIter, endIter);
     }
 
@@ -72,15 +80,8 @@ namespace brick {
       // added in stages, if desired.
       this->clear();
 
-      if(beginIter == endIter) {
-        return;
-      }
-
-      std::vector<Type> pointVector;
-      std::copy(beginIter, endIter, std::back_inserter(pointVector));
-
-      this->construct(pointVector.begin(), pointVector.end(),
-                      pointVector.size(), 0);
+      std::copy(beginIter, endIter, std::back_inserter(m_points));
+      this->construct(0, m_points.size(), 0);
     }
 
 
@@ -90,12 +91,7 @@ namespace brick {
     KDTree<Dimension, Type, FloatType>::
     clear()
     {
-      if(m_leftChild != 0) {
-        delete m_leftChild;
-      }
-      if(m_rightChild != 0) {
-        delete m_rightChild;
-      }
+      m_points.clear();
     }
 
 
@@ -104,21 +100,30 @@ namespace brick {
     KDTree<Dimension, Type, FloatType>::
     find(Type const& point) const
     {
-      if(m_comparator.isEqual(m_point, point)) {
-        return true;
+      size_t beginIndex = 0;
+      size_t endIndex = m_points.size();
+      unsigned int level = 0;
+      while(!this->isLeaf(beginIndex, endIndex)) {
+        size_t medianIndex = beginIndex + (endIndex - beginIndex) / 2;
+        KDComparator<Dimension, Type> const& comparator =
+          m_comparators[level % Dimension];
+        if(comparator.isEqual(m_points[medianIndex], point)) {
+          return true;
+        }
+        if(comparator(point, m_points[medianIndex])) {
+          endIndex = medianIndex;
+        } else {
+          beginIndex = medianIndex + 1;
+        }
+        ++level;
       }
 
-      if(m_comparator(point, m_point)) {
-        if(m_leftChild == 0) {
-          return false;
+      for(size_t ii = beginIndex; ii < endIndex; ++ii) {
+        if(m_comparators[0].isEqual(m_points[ii], point)) {
+          return true;
         }
-        return m_leftChild->find(point);
-      } else {
-        if(m_rightChild == 0) {
-          return false;
-        }
-        return m_rightChild->find(point);
       }
+      return false;
     }
 
 
@@ -128,25 +133,37 @@ namespace brick {
     findNearest(Type const& point, FloatType& distance) const
     {
       distance = std::numeric_limits<FloatType>::max();
-      Type const* bestPointPtr = &m_point;
-      // this->findNearestRecursive(point, bestPointPtr, distance);
+      Type const* bestPointPtr = &m_defaultPoint;
       this->findNearestIterative(point, bestPointPtr, distance);
       return *bestPointPtr;
     }
 
 
-    /* ================ Protected ================= */
+    template <unsigned int Dimension, class Type, class FloatType>
+    Type const&
+    KDTree<Dimension, Type, FloatType>::
+    findNearestApproximate(Type const& point, FloatType& distance,
+                           FloatType epsilon,
+                           size_t maximumLeafVisits) const
+    {
+      Type const* bestPointPtr = &m_defaultPoint;
+      distance = std::numeric_limits<FloatType>::max();
+      this->findNearestBestBinFirst(point, epsilon, maximumLeafVisits,
+                                    bestPointPtr, distance);
+      return *bestPointPtr;
+    }
+
 
     template <unsigned int Dimension, class Type, class FloatType>
     template <class Iter>
+    void
     KDTree<Dimension, Type, FloatType>::
-    KDTree(Iter beginIter, Iter endIter, size_t vectorSize, size_t level)
-      : m_comparator(level % Dimension),
-        m_point(),
-        m_leftChild(0),
-        m_rightChild(0)
+    findNearest(Iter queryBeginIter, Iter queryEndIter,
+                std::vector<Type const*>& nearestPoints,
+                std::vector<FloatType>& distances) const
     {
-      this->construct(beginIter, endIter, vectorSize, level);
+      this->findBatch(queryBeginIter, queryEndIter, 1,
+                      nearestPoints, distances, 0);
     }
 
 
@@ -154,141 +171,504 @@ namespace brick {
     template <class Iter>
     void
     KDTree<Dimension, Type, FloatType>::
-    construct(Iter beginIter, Iter endIter, size_t vectorSize, size_t level)
+    findNearest(Iter queryBeginIter, Iter queryEndIter,
+                std::vector<Type const*>& nearestPoints,
+                std::vector<FloatType>& distances,
+                brick::common::ThreadPool& threadPool) const
     {
-      std::sort(beginIter, endIter, m_comparator);
-      size_t partitionIndex = vectorSize / 2;
+      this->findBatch(queryBeginIter, queryEndIter, 1,
+                      nearestPoints, distances, &threadPool);
+    }
 
-      m_point = *(beginIter + partitionIndex);
 
-      if(vectorSize == 1) {
-        return;
+    template <unsigned int Dimension, class Type, class FloatType>
+    size_t
+    KDTree<Dimension, Type, FloatType>::
+    findKNearest(Type const& point, size_t kk,
+                 std::vector<Type const*>& neighbors,
+                 std::vector<FloatType>& distances) const
+    {
+      std::vector<Candidate> candidates;
+      candidates.reserve(std::min(kk, m_points.size()));
+      this->findKNearestIterative(point, kk, candidates);
+
+      neighbors.resize(candidates.size());
+      distances.resize(candidates.size());
+      for(size_t ii = 0; ii < candidates.size(); ++ii) {
+        distances[ii] = candidates[ii].first;
+        neighbors[ii] = candidates[ii].second;
       }
-      m_leftChild = new KDTree(
-        beginIter, beginIter + partitionIndex,
-        partitionIndex, level + 1);
+      return candidates.size();
+    }
+
 
-      if(vectorSize == 2) {
+    template <unsigned int Dimension, class Type, class FloatType>
+    template <class Iter>
+    void
+    KDTree<Dimension, Type, FloatType>::
+    findKNearest(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+                 std::vector<Type const*>& neighbors,
+                 std::vector<FloatType>& distances) const
+    {
+      this->findBatch(queryBeginIter, queryEndIter, kk,
+                      neighbors, distances, 0);
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    template <class Iter>
+    void
+    KDTree<Dimension, Type, FloatType>::
+    findKNearest(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+                 std::vector<Type const*>& neighbors,
+                 std::vector<FloatType>& distances,
+                 brick::common::ThreadPool& threadPool) const
+    {
+      this->findBatch(queryBeginIter, queryEndIter, kk,
+                      neighbors, distances, &threadPool);
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    size_t
+    KDTree<Dimension, Type, FloatType>::
+    findWithinRadius(Type const& point, FloatType maximumDistance,
+                     std::vector<Type const*>& neighbors,
+                     std::vector<FloatType>& distances) const
+    {
+      neighbors.clear();
+      distances.clear();
+
+      privateCode::KDTreeBranch<FloatType>
+        branchStack[privateCode::kdTreeMaximumStackSize];
+      size_t stackSize = 0;
+      privateCode::KDTreeBranch<FloatType> rootBranch =
+        {0, m_points.size(), 0, FloatType(0)};
+      branchStack[stackSize++] = rootBranch;
+
+      while(stackSize != 0) {
+        privateCode::KDTreeBranch<FloatType> branch = branchStack[--stackSize];
+
+        if(this->isLeaf(branch.beginIndex, branch.endIndex)) {
+          for(size_t ii = branch.beginIndex; ii < branch.endIndex; ++ii) {
+            FloatType myDistance = static_cast<FloatType>(
+              m_comparators[0].computeDistance(point, m_points[ii]));
+            if(myDistance <= maximumDistance) {
+              neighbors.push_back(&(m_points[ii]));
+              distances.push_back(myDistance);
+            }
+          }
+          continue;
+        }
+
+        size_t medianIndex =
+          branch.beginIndex + (branch.endIndex - branch.beginIndex) / 2;
+        Type const& medianPoint = m_points[medianIndex];
+        KDComparator<Dimension, Type> const& comparator =
+          m_comparators[branch.level % Dimension];
+
+        FloatType myDistance = static_cast<FloatType>(
+          comparator.computeDistance(point, medianPoint));
+        if(myDistance <= maximumDistance) {
+          neighbors.push_back(&medianPoint);
+          distances.push_back(myDistance);
+        }
+
+        privateCode::KDTreeBranch<FloatType> leftBranch =
+          {branch.beginIndex, medianIndex, branch.level + 1, FloatType(0)};
+        privateCode::KDTreeBranch<FloatType> rightBranch =
+          {medianIndex + 1, branch.endIndex, branch.level + 1, FloatType(0)};
+        bool isLeft = comparator(point, medianPoint);
+        bool isFarBranchNeeded = !(
+          maximumDistance < static_cast<FloatType>(
+            comparator.getPrimarySeparation(point, medianPoint)));
+        if((isLeft || isFarBranchNeeded)
+           && leftBranch.beginIndex != leftBranch.endIndex) {
+          branchStack[stackSize++] = leftBranch;
+        }
+        if((!isLeft || isFarBranchNeeded)
+           && rightBranch.beginIndex != rightBranch.endIndex) {
+          branchStack[stackSize++] = rightBranch;
+        }
+      }
+      return neighbors.size();
+    }
+
+
+    /* ================ Protected ================= */
+
+    // Arranges m_points[beginIndex ... endIndex - 1] so that the
+    // median point (along the axis associated with level) is in the
+    // middle, with smaller points before it and larger points after
+    // it, and then recursively does the same for each side.  Each
+    // level of the tree costs O(N), for O(N*log(N)) overall.
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    KDTree<Dimension, Type, FloatType>::
+    construct(size_t beginIndex, size_t endIndex, unsigned int level)
+    {
+      // Recurse on the left side only, and loop on the right side,
+      // so that stack depth is bounded by the depth of the tree.
+      while(!this->isLeaf(beginIndex, endIndex)) {
+        size_t medianIndex = beginIndex + (endIndex - beginIndex) / 2;
+        std::nth_element(m_points.begin() + beginIndex,
+                         m_points.begin() + medianIndex,
+                         m_points.begin() + endIndex,
+                         m_comparators[level % Dimension]);
+        this->construct(beginIndex, medianIndex, level + 1);
+        beginIndex = medianIndex + 1;
+        ++level;
+      }
+    }
+
+
+    template <unsigned int Dimension, class Type, class FloatType>
+    template <class Iter>
+    void
+    KDTree<Dimension, Type, FloatType>::
+    findBatch(Iter queryBeginIter, Iter queryEndIter, size_t kk,
+              std::vector<Type const*>& neighbors,
+              std::vector<FloatType>& distances,
+              brick::common::ThreadPool* threadPoolPtr) const
+    {
+      size_t numberOfQueries = queryEndIter - queryBeginIter;
+      neighbors.resize(numberOfQueries * kk);
+      distances.resize(numberOfQueries * kk);
+      if(numberOfQueries == 0 || kk == 0) {
         return;
       }
-      m_rightChild = new KDTree(
-        beginIter + (partitionIndex + 1), endIter,
-        vectorSize - (partitionIndex + 1), level + 1);
+
+      // A few bands per thread keeps the threads busy even if some
+      // parts of the query set are more expensive than others.
+      // Each band writes only its own slice of the output, so the
+      // results don't depend on scheduling.
+      size_t numberOfBands = 1;
+      if(threadPoolPtr != 0) {
+        numberOfBands = std::min(
+          numberOfQueries, 4 * threadPoolPtr->getNumberOfThreads());
+      }
+      privateCode::KDTreeBatchFunctor<Dimension, Type, FloatType, Iter>
+        batchFunctor(*this, queryBeginIter, numberOfQueries, kk,
+                     numberOfBands, neighbors, distances);
+      if(threadPoolPtr != 0 && numberOfBands > 1) {
+        threadPoolPtr->parallelFor(numberOfBands, batchFunctor);
+      } else {
+        batchFunctor(0);
+      }
     }
 
 
+    // Best-bin-first search.  Each iteration pops the most promising
+    // branch from the queue and descends through it to a leaf,
+    // queueing the far side of every split along the way.
     template <unsigned int Dimension, class Type, class FloatType>
     void
     KDTree<Dimension, Type, FloatType>::
-    findNearestIterative(Type const& point,
-                         Type const*& bestPointPtr,
-                         FloatType& bestDistance) const
+    findNearestBestBinFirst(Type const& point, FloatType epsilon,
+                            size_t maximumLeafVisits,
+                            Type const*& bestPointPtr,
+                            FloatType& bestDistance) const
     {
-      // Contents of this stack are std::pairs in which the first
-      // element points to an un-searched tree, and the second element
-      // is a lower bound on the distance from argument point to the
-      // points contained in the un-searched tree.
-      std::stack< std::pair< KDTree<Dimension, Type, FloatType> const*, FloatType> >
-        kdTreeStack;
-      kdTreeStack.push(std::make_pair(this, 0.0));
-
-      while(!(kdTreeStack.empty())) {
-        KDTree<Dimension, Type, FloatType> const* currentTree = kdTreeStack.top().first;
-        FloatType bound = kdTreeStack.top().second;
-        kdTreeStack.pop();
-
-        if(bestDistance < bound) {
-          continue;
+      if(m_points.empty()) {
+        return;
+      }
+      FloatType const boundScale = FloatType(1) + epsilon;
+      privateCode::KDTreeBranchGreater<FloatType> branchGreater;
+
+      std::vector< privateCode::KDTreeBranch<FloatType> > branchQueue;
+      privateCode::KDTreeBranch<FloatType> rootBranch =
+        {0, m_points.size(), 0, FloatType(0)};
+      branchQueue.push_back(rootBranch);
+
+      size_t numberOfLeafVisits = 0;
+      while(!branchQueue.empty()) {
+        std::pop_heap(branchQueue.begin(), branchQueue.end(), branchGreater);
+        privateCode::KDTreeBranch<FloatType> branch = branchQueue.back();
+        branchQueue.pop_back();
+
+        // Every branch left in the queue is at least this far away.
+        if(bestDistance < boundScale * branch.bound) {
+          break;
+        }
+        if(maximumLeafVisits != 0 && numberOfLeafVisits >= maximumLeafVisits) {
+          break;
         }
+        ++numberOfLeafVisits;
+
+        while(true) {
+          if(this->isLeaf(branch.beginIndex, branch.endIndex)) {
+            for(size_t ii = branch.beginIndex; ii < branch.endIndex; ++ii) {
+              FloatType myDistance = static_cast<FloatType>(
+                m_comparators[0].computeDistance(point, m_points[ii]));
+              if(myDistance < bestDistance) {
+                bestDistance = myDistance;
+                bestPointPtr = &(m_points[ii]);
+              }
+            }
+            break;
+          }
 
-        FloatType myDistance = currentTree->m_comparator.computeDistance(
-          point, currentTree->m_point);
-        if(myDistance < bestDistance) {
-          bestDistance = myDistance;
-          bestPointPtr = &currentTree->m_point;
+          size_t medianIndex =
+            branch.beginIndex + (branch.endIndex - branch.beginIndex) / 2;
+          Type const& medianPoint = m_points[medianIndex];
+          KDComparator<Dimension, Type> const& comparator =
+            m_comparators[branch.level % Dimension];
+          FloatType myDistance = static_cast<FloatType>(
+            comparator.computeDistance(point, medianPoint));
+          if(myDistance < bestDistance) {
+            bestDistance = myDistance;
+            bestPointPtr = &medianPoint;
+          }
+
+          // The far branch can be no closer than the branch that
+          // contains it, nor than the splitting plane.
+          privateCode::KDTreeBranch<FloatType> nearBranch =
+            {branch.beginIndex, medianIndex, branch.level + 1, branch.bound};
+          privateCode::KDTreeBranch<FloatType> farBranch =
+            {medianIndex + 1, branch.endIndex, branch.level + 1,
+             std::max(branch.bound, static_cast<FloatType>(
+                        comparator.getPrimarySeparation(point, medianPoint)))};
+          if(!comparator(point, medianPoint)) {
+            std::swap(nearBranch.beginIndex, farBranch.beginIndex);
+            std::swap(nearBranch.endIndex, farBranch.endIndex);
+          }
+          if(!(bestDistance < boundScale * farBranch.bound)
+             && farBranch.beginIndex != farBranch.endIndex) {
+            branchQueue.push_back(farBranch);
+            std::push_heap(branchQueue.begin(), branchQueue.end(),
+                           branchGreater);
+          }
+          if(nearBranch.beginIndex == nearBranch.endIndex) {
+            break;
+          }
+          branch = nearBranch;
         }
+      }
+    }
+
+
+    // Finds the kk points closest to argument point, and returns
+    // them in argument candidates, sorted by increasing distance.
+    template <unsigned int Dimension, class Type, class FloatType>
+    void
+    KDTree<Dimension, Type, FloatType>::
+    findKNearestIterative(Type const& point, size_t kk,
+                          std::vector<Candidate>& candidates) const
+    {
+      candidates.clear();
+      if(kk == 0) {
+        return;
+      }
+
+      // Until we have kk candidates, nothing can be pruned.
+      FloatType worstDistance = std::numeric_limits<FloatType>::max();
+
+      privateCode::KDTreeBranch<FloatType>
+        branchStack[privateCode::kdTreeMaximumStackSize];
+      size_t stackSize = 0;
+      privateCode::KDTreeBranch<FloatType> rootBranch =
+        {0, m_points.size(), 0, FloatType(0)};
+      branchStack[stackSize++] = rootBranch;
 
-        if(currentTree->m_leftChild == 0 && currentTree->m_rightChild == 0) {
+      while(stackSize != 0) {
+        privateCode::KDTreeBranch<FloatType> branch = branchStack[--stackSize];
+        if(worstDistance < branch.bound) {
           continue;
         }
 
-        KDTree* nearChildPtr;
-        KDTree* farChildPtr;
-        bool isLeft = currentTree->m_comparator(point, currentTree->m_point);
-        if(isLeft) {
-          nearChildPtr = currentTree->m_leftChild;
-          farChildPtr = currentTree->m_rightChild;
-        } else {
-          nearChildPtr = currentTree->m_rightChild;
-          farChildPtr = currentTree->m_leftChild;
+        // Leaves are scanned in their entirety.  Internal branches
+        // contribute only their median point.
+        bool isLeafBranch = this->isLeaf(branch.beginIndex, branch.endIndex);
+        size_t medianIndex =
+          branch.beginIndex + (branch.endIndex - branch.beginIndex) / 2;
+        size_t scanBegin = isLeafBranch ? branch.beginIndex : medianIndex;
+        size_t scanEnd = isLeafBranch ? branch.endIndex : medianIndex + 1;
+        for(size_t ii = scanBegin; ii < scanEnd; ++ii) {
+          FloatType myDistance = static_cast<FloatType>(
+            m_comparators[0].computeDistance(point, m_points[ii]));
+          if(candidates.size() < kk) {
+            candidates.push_back(Candidate(myDistance, &(m_points[ii])));
+            std::push_heap(candidates.begin(), candidates.end());
+            if(candidates.size() == kk) {
+              worstDistance = candidates.front().first;
+            }
+          } else if(myDistance < worstDistance) {
+            std::pop_heap(candidates.begin(), candidates.end());
+            candidates.back() = Candidate(myDistance, &(m_points[ii]));
+            std::push_heap(candidates.begin(), candidates.end());
+            worstDistance = candidates.front().first;
+          }
         }
 
-        // Push remote child first, and near child second, so that
-        // near child will be popped first, increasing the chance that
-        // remote child will be eliminated.
-
-        // Only push the remote child if it's plausible that it
-        // contains a closer point than our best so far.  This
-        // duplicates a similar test above. Not sure if it's worth
-        // duplicating the test to avoid the occasional extra
-        // push/pop.
-        if(farChildPtr) {
-          FloatType remoteDistanceLowerBound =
-            currentTree->m_comparator.getPrimarySeparation(
-              point, currentTree->m_point);
-          if(remoteDistanceLowerBound < bestDistance) {
-            kdTreeStack.push(
-              std::make_pair(farChildPtr, remoteDistanceLowerBound));
-          }
+        if(isLeafBranch) {
+          continue;
         }
 
-        if(nearChildPtr) {
-          kdTreeStack.push(std::make_pair(nearChildPtr, 0.0));
+        Type const& medianPoint = m_points[medianIndex];
+        KDComparator<Dimension, Type> const& comparator =
+          m_comparators[branch.level % Dimension];
+
+        privateCode::KDTreeBranch<FloatType> nearBranch =
+          {branch.beginIndex, medianIndex, branch.level + 1, FloatType(0)};
+        privateCode::KDTreeBranch<FloatType> farBranch =
+          {medianIndex + 1, branch.endIndex, branch.level + 1,
+           static_cast<FloatType>(
+             comparator.getPrimarySeparation(point, medianPoint))};
+        if(!comparator(point, medianPoint)) {
+          std::swap(nearBranch.beginIndex, farBranch.beginIndex);
+          std::swap(nearBranch.endIndex, farBranch.endIndex);
+        }
+        if(!(worstDistance < farBranch.bound)
+           && farBranch.beginIndex != farBranch.endIndex) {
+          branchStack[stackSize++] = farBranch;
+        }
+        if(nearBranch.beginIndex != nearBranch.endIndex) {
+          branchStack[stackSize++] = nearBranch;
         }
       }
+
+      std::sort_heap(candidates.begin(), candidates.end());
     }
 
 
     template <unsigned int Dimension, class Type, class FloatType>
     void
     KDTree<Dimension, Type, FloatType>::
-    findNearestRecursive(Type const& point,
+    findNearestIterative(Type const& point,
                          Type const*& bestPointPtr,
                          FloatType& bestDistance) const
     {
-      FloatType myDistance = m_comparator.computeDistance(point, m_point);
-      if(myDistance < bestDistance) {
-        bestDistance = myDistance;
-        bestPointPtr = &m_point;
-      }
+      // Contents of this stack are branches that have yet to be
+      // searched, each with a lower bound on the distance from
+      // argument point to the points it contains.
+      privateCode::KDTreeBranch<FloatType>
+        branchStack[privateCode::kdTreeMaximumStackSize];
+      size_t stackSize = 0;
+      privateCode::KDTreeBranch<FloatType> rootBranch =
+        {0, m_points.size(), 0, FloatType(0)};
+      branchStack[stackSize++] = rootBranch;
+
+      while(stackSize != 0) {
+        privateCode::KDTreeBranch<FloatType> branch = branchStack[--stackSize];
+        if(bestDistance < branch.bound) {
+          continue;
+        }
 
-      if(m_leftChild == 0 && m_rightChild == 0) {
-        return;
-      }
+        if(this->isLeaf(branch.beginIndex, branch.endIndex)) {
+          for(size_t ii = branch.beginIndex; ii < branch.endIndex; ++ii) {
+            FloatType myDistance = static_cast<FloatType>(
+              m_comparators[0].computeDistance(point, m_points[ii]));
+            if(myDistance < bestDistance) {
+              bestDistance = myDistance;
+              bestPointPtr = &(m_points[ii]);
+            }
+          }
+          continue;
+        }
 
-      bool isLeft = m_comparator(point, m_point);
-      FloatType remoteDistanceLowerBound = m_comparator.getPrimarySeparation(
-        point, m_point);
+        size_t medianIndex =
+          branch.beginIndex + (branch.endIndex - branch.beginIndex) / 2;
+        Type const& medianPoint = m_points[medianIndex];
+        KDComparator<Dimension, Type> const& comparator =
+          m_comparators[branch.level % Dimension];
 
-      KDTree* nearChildPtr;
-      KDTree* farChildPtr;
-      if(isLeft) {
-        nearChildPtr = m_leftChild;
-        farChildPtr = m_rightChild;
-      } else {
-        nearChildPtr = m_rightChild;
-        farChildPtr = m_leftChild;
-      }
+        FloatType myDistance = static_cast<FloatType>(
+          comparator.computeDistance(point, medianPoint));
+        if(myDistance < bestDistance) {
+          bestDistance = myDistance;
+          bestPointPtr = &medianPoint;
+        }
 
-      if(nearChildPtr) {
-        nearChildPtr->findNearestRecursive(point, bestPointPtr, bestDistance);
-      }
+        privateCode::KDTreeBranch<FloatType> nearBranch =
+          {branch.beginIndex, medianIndex, branch.level + 1, FloatType(0)};
+        privateCode::KDTreeBranch<FloatType> farBranch =
+          {medianIndex + 1, branch.endIndex, branch.level + 1,
+           static_cast<FloatType>(
+             comparator.getPrimarySeparation(point, medianPoint))};
+        if(!comparator(point, medianPoint)) {
+          std::swap(nearBranch.beginIndex, farBranch.beginIndex);
+          std::swap(nearBranch.endIndex, farBranch.endIndex);
+        }
 
-      if((remoteDistanceLowerBound < bestDistance) && farChildPtr) {
-        farChildPtr->findNearestRecursive(point, bestPointPtr, bestDistance);
+        // Push remote branch first, and near branch second, so that
+        // near branch will be popped first, increasing the chance
+        // that remote branch will be eliminated.  Only push the
+        // remote branch if it's plausible that it contains a closer
+        // point than our best so far.
+        if(farBranch.bound < bestDistance
+           && farBranch.beginIndex != farBranch.endIndex) {
+          branchStack[stackSize++] = farBranch;
+        }
+        if(nearBranch.beginIndex != nearBranch.endIndex) {
+          branchStack[stackSize++] = nearBranch;
+        }
       }
     }
 
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      template <unsigned int Dimension, class Type, class FloatType,
+                class Iter>
+      class KDTreeBatchFunctor {
+      public:
+
+        KDTreeBatchFunctor(KDTree<Dimension, Type, FloatType> const& tree,
+                           Iter queryBeginIter, size_t numberOfQueries,
+                           size_t kk, size_t numberOfBands,
+                           std::vector<Type const*>& neighbors,
+                           std::vector<FloatType>& distances)
+          : m_tree(tree),
+            m_queryBeginIter(queryBeginIter),
+            m_numberOfQueries(numberOfQueries),
+            m_kk(kk),
+            m_numberOfBands(numberOfBands),
+            m_neighbors(neighbors),
+            m_distances(distances) {}
+
+
+        void
+        operator()(size_t band) const
+        {
+          size_t beginIndex = (band * m_numberOfQueries) / m_numberOfBands;
+          size_t endIndex = ((band + 1) * m_numberOfQueries) / m_numberOfBands;
+
+          // The candidate heap is reused for every query in the band.
+          std::vector<typename KDTree<Dimension, Type, FloatType>::Candidate>
+            candidates;
+          candidates.reserve(std::min(m_kk, m_tree.getSize()));
+          for(size_t ii = beginIndex; ii < endIndex; ++ii) {
+            m_tree.findKNearestIterative(
+              *(m_queryBeginIter + ii), m_kk, candidates);
+            size_t outputIndex = ii * m_kk;
+            for(size_t jj = 0; jj < m_kk; ++jj, ++outputIndex) {
+              if(jj < candidates.size()) {
+                m_distances[outputIndex] = candidates[jj].first;
+                m_neighbors[outputIndex] = candidates[jj].second;
+              } else {
+                m_distances[outputIndex] =
+                  std::numeric_limits<FloatType>::max();
+                m_neighbors[outputIndex] = 0;
+              }
+            }
+          }
+        }
+
+      private:
+
+        KDTree<Dimension, Type, FloatType> const& m_tree;
+        Iter m_queryBeginIter;
+        size_t m_numberOfQueries;
+        size_t m_kk;
+        size_t m_numberOfBands;
+        std::vector<Type const*>& m_neighbors;
+        std::vector<FloatType>& m_distances;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
   } // namespace computerVision
 
 } // namespace brick
@@ -0,0 +1,129 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointBudget.cc
+*
+* Source file defining code for reducing the output of the keypoint
+* selectors to a fixed-size, spatially uniform set of keypoints.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <brick/common/exception.hh>
+#include <brick/computerVision/keypointBudget.hh>
+
+namespace brick {
+
+  namespace computerVision {
+
+    KeypointBudget::
+    KeypointBudget()
+      : m_gridColumns(8),
+        m_gridRows(8),
+        m_numberOfKeypoints(0),
+        m_strategy(BRICK_CV_KEYPOINT_BUDGET_ANMS)
+    {
+      // Empty.
+    }
+
+
+    KeypointBudget::
+    KeypointBudget(std::size_t numberOfKeypoints,
+                   KeypointBudgetStrategy strategy,
+                   unsigned int gridRows,
+                   unsigned int gridColumns)
+      : m_gridColumns(gridColumns),
+        m_gridRows(gridRows),
+        m_numberOfKeypoints(numberOfKeypoints),
+        m_strategy(strategy)
+    {
+      if(strategy == BRICK_CV_KEYPOINT_BUDGET_GRID
+         && (gridRows == 0 || gridColumns == 0)) {
+        BRICK_THROW(brick::common::ValueException,
+                    "KeypointBudget::KeypointBudget()",
+                    "Grid dimensions must be greater than zero.");
+      }
+    }
+
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      void
+      selectAnmsSurvivors(std::vector<double> const& rows,
+                          std::vector<double> const& columns,
+                          std::vector<std::size_t> const& order,
+                          double minimumRow, double minimumColumn,
+                          double height, double width,
+                          double radius, std::size_t maximumSurvivors,
+                          std::vector<std::size_t>& survivors)
+      {
+        const std::size_t emptyCell = std::numeric_limits<std::size_t>::max();
+
+        // Any two points in the same cell are closer than radius.
+        double cellSize = radius / std::sqrt(2.0);
+        std::size_t gridRows =
+          static_cast<std::size_t>(height / cellSize) + 1;
+        std::size_t gridColumns =
+          static_cast<std::size_t>(width / cellSize) + 1;
+        std::vector<std::size_t> cells(gridRows * gridColumns, emptyCell);
+        double radiusSquared = radius * radius;
+
+        survivors.clear();
+        for(std::size_t ii = 0; ii < order.size(); ++ii) {
+          std::size_t candidate = order[ii];
+          std::size_t cellRow = std::min(
+            static_cast<std::size_t>((rows[candidate] - minimumRow)
+                                     / cellSize),
+            gridRows - 1);
+          std::size_t cellColumn = std::min(
+            static_cast<std::size_t>((columns[candidate] - minimumColumn)
+                                     / cellSize),
+            gridColumns - 1);
+
+          // Nearby accepted keypoints can be at most two cells away.
+          bool isSuppressed = (cells[cellRow * gridColumns + cellColumn]
+                               != emptyCell);
+          std::size_t startRow = (cellRow >= 2) ? cellRow - 2 : 0;
+          std::size_t stopRow = std::min(cellRow + 3, gridRows);
+          std::size_t startColumn = (cellColumn >= 2) ? cellColumn - 2 : 0;
+          std::size_t stopColumn = std::min(cellColumn + 3, gridColumns);
+          for(std::size_t row = startRow; row < stopRow && !isSuppressed;
+              ++row) {
+            for(std::size_t column = startColumn; column < stopColumn;
+                ++column) {
+              std::size_t neighbor = cells[row * gridColumns + column];
+              if(neighbor != emptyCell) {
+                double rowDistance = rows[neighbor] - rows[candidate];
+                double columnDistance = columns[neighbor] - columns[candidate];
+                if(rowDistance * rowDistance + columnDistance * columnDistance
+                   < radiusSquared) {
+                  isSuppressed = true;
+                  break;
+                }
+              }
+            }
+          }
+          if(isSuppressed) {
+            continue;
+          }
+
+          cells[cellRow * gridColumns + cellColumn] = candidate;
+          survivors.push_back(candidate);
+          if(survivors.size() > maximumSurvivors) {
+            return;
+          }
+        }
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+  } // namespace computerVision
+
+} // namespace brick
@@ -0,0 +1,229 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointBudget.hh
+*
+* Header file declaring code for reducing the output of the keypoint
+* selectors to a fixed-size, spatially uniform set of keypoints.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#ifndef BRICK_COMPUTERVISION_KEYPOINTBUDGET_HH
+#define BRICK_COMPUTERVISION_KEYPOINTBUDGET_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace brick {
+
+  namespace computerVision {
+
+    /**
+     * This enum lists the ways in which KeypointBudget can choose
+     * which keypoints to keep.
+     */
+    enum KeypointBudgetStrategy {
+      /** Keep the best keypoints from each cell of a regular grid.
+          See selectKeypointsByGrid(). */
+      BRICK_CV_KEYPOINT_BUDGET_GRID,
+
+      /** Adaptive non-maximal suppression.  See
+          selectKeypointsAnms(). */
+      BRICK_CV_KEYPOINT_BUDGET_ANMS
+    };
+
+
+    /**
+     ** This class limits the number of keypoints reported by a
+     ** keypoint selector, preferring a set of keypoints that is
+     ** spread evenly across the image over one that is clustered in
+     ** the most textured regions.  The keypoint selectors hold an
+     ** instance of it, which can be set using their
+     ** setKeypointBudget() member functions.
+     **/
+    class KeypointBudget {
+    public:
+
+      /**
+       * The default constructor creates a budget that keeps every
+       * keypoint.
+       */
+      KeypointBudget();
+
+
+      /**
+       * This constructor creates a budget that keeps at most the
+       * specified number of keypoints.
+       *
+       * @param numberOfKeypoints This argument specifies how many
+       * keypoints to keep.  Setting it to zero disables the limit.
+       *
+       * @param strategy This argument specifies how to choose which
+       * keypoints to keep.
+       *
+       * @param gridRows This argument specifies how many rows of
+       * cells to use if strategy is BRICK_CV_KEYPOINT_BUDGET_GRID.
+       * It must be greater than zero.
+       *
+       * @param gridColumns This argument specifies how many columns
+       * of cells to use if strategy is BRICK_CV_KEYPOINT_BUDGET_GRID.
+       * It must be greater than zero.
+       */
+      explicit
+      KeypointBudget(std::size_t numberOfKeypoints,
+                     KeypointBudgetStrategy strategy
+                     = BRICK_CV_KEYPOINT_BUDGET_ANMS,
+                     unsigned int gridRows = 8,
+                     unsigned int gridColumns = 8);
+
+
+      /**
+       * This member function removes keypoints from the input vector
+       * until no more than getNumberOfKeypoints() remain.  The
+       * surviving keypoints retain their original order.
+       *
+       * @param keypoints This argument is the vector of keypoints to
+       * be pruned.  Keypoint must either have public members row
+       * and column, or be a brick::numeric::Index2D.
+       *
+       * @param scores This argument contains one score for each
+       * element of keypoints.  Higher scores are better.
+       */
+      template <class Keypoint, class ScoreType>
+      void
+      apply(std::vector<Keypoint>& keypoints,
+            std::vector<ScoreType> const& scores) const;
+
+
+      /**
+       * This member function returns the number of keypoints to
+       * keep.
+       *
+       * @return The return value is zero if the budget is unlimited.
+       */
+      std::size_t
+      getNumberOfKeypoints() const {return m_numberOfKeypoints;}
+
+
+      /**
+       * This member function returns the strategy used to choose
+       * which keypoints to keep.
+       *
+       * @return The return value is the strategy passed to the
+       * constructor.
+       */
+      KeypointBudgetStrategy
+      getStrategy() const {return m_strategy;}
+
+
+      /**
+       * This member function indicates whether apply() might remove
+       * any keypoints.  Keypoint selectors use it to avoid computing
+       * scores that won't be needed.
+       *
+       * @return The return value is true if the budget is limited,
+       * false otherwise.
+       */
+      bool
+      isLimited() const {return m_numberOfKeypoints != 0;}
+
+    private:
+
+      unsigned int m_gridColumns;
+      unsigned int m_gridRows;
+      std::size_t m_numberOfKeypoints;
+      KeypointBudgetStrategy m_strategy;
+    };
+
+
+    /**
+     * This function selects a fixed number of keypoints by dividing
+     * the bounding box of the keypoints into a regular grid of
+     * cells, ranking the keypoints within each cell by score, and
+     * then keeping all of the rank 0 keypoints, followed by all of
+     * the rank 1 keypoints, and so on until numberOfKeypoints have
+     * been kept.  Within a rank, higher scores are kept first.  The
+     * result is that sparsely populated cells are represented as
+     * well as possible, and densely populated cells are not allowed
+     * to dominate.  The surviving keypoints retain their original
+     * order.  Running time is O(n log n) in the number of keypoints.
+     *
+     * @param keypoints This argument is the vector of keypoints to
+     * be pruned.
+     *
+     * @param scores This argument contains one score for each
+     * element of keypoints.  Higher scores are better.
+     *
+     * @param numberOfKeypoints This argument specifies how many
+     * keypoints to keep.  If keypoints is smaller than this, it is
+     * left unchanged.
+     *
+     * @param gridRows This argument specifies how many rows of cells
+     * to use.  It must be greater than zero.
+     *
+     * @param gridColumns This argument specifies how many columns of
+     * cells to use.  It must be greater than zero.
+     */
+    template <class Keypoint, class ScoreType>
+    void
+    selectKeypointsByGrid(std::vector<Keypoint>& keypoints,
+                          std::vector<ScoreType> const& scores,
+                          std::size_t numberOfKeypoints,
+                          unsigned int gridRows, unsigned int gridColumns);
+
+
+    /**
+     * This function selects a fixed number of keypoints using
+     * adaptive non-maximal suppression [1].  Conceptually, each
+     * keypoint is assigned a suppression radius equal to its
+     * distance from the nearest keypoint with a higher score, and
+     * the keypoints with the largest radii are kept.  This
+     * implementation follows [2], binary searching for a radius r
+     * such that greedily accepting keypoints in order of decreasing
+     * score, while rejecting any within distance r of an already
+     * accepted keypoint, accepts between numberOfKeypoints and 10%
+     * more than that.  The highest scoring numberOfKeypoints of
+     * those are kept.  Each greedy pass uses a grid of cells the
+     * size of r, so the running time is O(n log n) in the number of
+     * keypoints.  The surviving keypoints retain their original
+     * order.
+     *
+     * [1] M. Brown, R. Szeliski, and S. Winder, "Multi-image
+     * matching using multi-scale oriented patches", IEEE Conference
+     * on Computer Vision and Pattern Recognition, Vol 1,
+     * pp. 510-517, 2005.
+     *
+     * [2] O. Bailo, F. Rameau, K. Joo, J. Park, O. Bogdan, and
+     * I. Kweon, "Efficient adaptive non-maximal suppression
+     * algorithms for homogeneous spatial keypoint distribution",
+     * Pattern Recognition Letters, Vol 106, pp. 53-60, 2018.
+     *
+     * @param keypoints This argument is the vector of keypoints to
+     * be pruned.
+     *
+     * @param scores This argument contains one score for each
+     * element of keypoints.  Higher scores are better.
+     *
+     * @param numberOfKeypoints This argument specifies how many
+     * keypoints to keep.  If keypoints is smaller than this, it is
+     * left unchanged.
+     */
+    template <class Keypoint, class ScoreType>
+    void
+    selectKeypointsAnms(std::vector<Keypoint>& keypoints,
+                        std::vector<ScoreType> const& scores,
+                        std::size_t numberOfKeypoints);
+
+  } // namespace computerVision
+
+} // namespace brick
+
+
+// Include file containing definitions of inline and template
+// functions.
+#include <brick/computerVision/keypointBudget_impl.hh>
+
+#endif /* #ifndef BRICK_COMPUTERVISION_KEYPOINTBUDGET_HH */
@@ -0,0 +1,397 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointBudget_impl.hh
+*
+* Header file defining inline and template functions declared in
+* keypointBudget.hh.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#ifndef BRICK_COMPUTERVISION_KEYPOINTBUDGET_IMPL_HH
+#define BRICK_COMPUTERVISION_KEYPOINTBUDGET_IMPL_HH
+
+// This file is included by keypointBudget.hh, and should not be
+// directly included by user code, so no need to include
+// keypointBudget.hh here.
+//
+// #include <brick/computerVision/keypointBudget.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <brick/common/exception.hh>
+#include <brick/computerVision/keypointTiling.hh>
+#include <brick/numeric/index2D.hh>
+
+namespace brick {
+
+  namespace computerVision {
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Most keypoint types have public row and column members.
+      template <class Keypoint>
+      inline double
+      getKeypointRow(Keypoint const& keypoint) {
+        return static_cast<double>(keypoint.row);
+      }
+
+
+      template <class Keypoint>
+      inline double
+      getKeypointColumn(Keypoint const& keypoint) {
+        return static_cast<double>(keypoint.column);
+      }
+
+
+      // KeypointSelectorLepetit reports Index2D instances.
+      inline double
+      getKeypointRow(brick::numeric::Index2D const& keypoint) {
+        return static_cast<double>(keypoint.getRow());
+      }
+
+
+      inline double
+      getKeypointColumn(brick::numeric::Index2D const& keypoint) {
+        return static_cast<double>(keypoint.getColumn());
+      }
+
+
+      // Orders keypoint indices by descending score, then by
+      // position in the input vector.
+      template <class ScoreType>
+      class KeypointScoreLess {
+      public:
+        explicit
+        KeypointScoreLess(std::vector<ScoreType> const& scores)
+          : m_scores(scores) {}
+
+        bool
+        operator()(std::size_t index0, std::size_t index1) const {
+          if(m_scores[index0] != m_scores[index1]) {
+            return m_scores[index0] > m_scores[index1];
+          }
+          return index0 < index1;
+        }
+
+      private:
+        std::vector<ScoreType> const& m_scores;
+      };
+
+
+      // Orders keypoint indices by rank within their grid cell, then
+      // by descending score, then by position in the input vector.
+      template <class ScoreType>
+      class KeypointGridRankLess {
+      public:
+        KeypointGridRankLess(std::vector<ScoreType> const& scores,
+                             std::vector<std::size_t> const& ranks)
+          : m_scores(scores), m_ranks(ranks) {}
+
+        bool
+        operator()(std::size_t index0, std::size_t index1) const {
+          if(m_ranks[index0] != m_ranks[index1]) {
+            return m_ranks[index0] < m_ranks[index1];
+          }
+          if(m_scores[index0] != m_scores[index1]) {
+            return m_scores[index0] > m_scores[index1];
+          }
+          return index0 < index1;
+        }
+
+      private:
+        std::vector<ScoreType> const& m_scores;
+        std::vector<std::size_t> const& m_ranks;
+      };
+
+
+      // Remove the keypoints that aren't flagged in isKept, leaving
+      // the rest in their original order.
+      template <class Keypoint>
+      void
+      keepFlaggedKeypoints(std::vector<Keypoint>& keypoints,
+                           std::vector<bool> const& isKept)
+      {
+        std::size_t outputIndex = 0;
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          if(isKept[ii]) {
+            keypoints[outputIndex] = keypoints[ii];
+            ++outputIndex;
+          }
+        }
+        keypoints.erase(keypoints.begin() + outputIndex, keypoints.end());
+      }
+
+
+      // Fill in the coordinates of each keypoint, and the bounding
+      // box that contains them all.
+      template <class Keypoint>
+      void
+      getKeypointCoordinates(std::vector<Keypoint> const& keypoints,
+                             std::vector<double>& rows,
+                             std::vector<double>& columns,
+                             double& minimumRow, double& minimumColumn,
+                             double& maximumRow, double& maximumColumn)
+      {
+        rows.resize(keypoints.size());
+        columns.resize(keypoints.size());
+        minimumRow = std::numeric_limits<double>::max();
+        minimumColumn = std::numeric_limits<double>::max();
+        maximumRow = -std::numeric_limits<double>::max();
+        maximumColumn = -std::numeric_limits<double>::max();
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          rows[ii] = getKeypointRow(keypoints[ii]);
+          columns[ii] = getKeypointColumn(keypoints[ii]);
+          minimumRow = std::min(minimumRow, rows[ii]);
+          minimumColumn = std::min(minimumColumn, columns[ii]);
+          maximumRow = std::max(maximumRow, rows[ii]);
+          maximumColumn = std::max(maximumColumn, columns[ii]);
+        }
+      }
+
+
+      // Greedily accept keypoints in the specified order, rejecting
+      // any that lie within distance radius of an already accepted
+      // keypoint.  Stops as soon as more than maximumSurvivors have
+      // been accepted.  The grid cells are small enough that each
+      // can hold at most one accepted keypoint, so only a 5x5
+      // neighborhood of cells must be checked for each candidate.
+      void
+      selectAnmsSurvivors(std::vector<double> const& rows,
+                          std::vector<double> const& columns,
+                          std::vector<std::size_t> const& order,
+                          double minimumRow, double minimumColumn,
+                          double height, double width,
+                          double radius, std::size_t maximumSurvivors,
+                          std::vector<std::size_t>& survivors);
+
+    } // namespace privateCode
+    /// @endcond
+
+
+    template <class Keypoint, class ScoreType>
+    void
+    KeypointBudget::
+    apply(std::vector<Keypoint>& keypoints,
+          std::vector<ScoreType> const& scores) const
+    {
+      if(!this->isLimited()) {
+        return;
+      }
+      switch(m_strategy) {
+      case BRICK_CV_KEYPOINT_BUDGET_GRID:
+        selectKeypointsByGrid(keypoints, scores, m_numberOfKeypoints,
+                              m_gridRows, m_gridColumns);
+        break;
+      case BRICK_CV_KEYPOINT_BUDGET_ANMS:
+        selectKeypointsAnms(keypoints, scores, m_numberOfKeypoints);
+        break;
+      }
+    }
+
+
+    template <class Keypoint, class ScoreType>
+    void
+    selectKeypointsByGrid(std::vector<Keypoint>& keypoints,
+                          std::vector<ScoreType> const& scores,
+                          std::size_t numberOfKeypoints,
+                          unsigned int gridRows, unsigned int gridColumns)
+    {
+      if(scores.size() != keypoints.size()) {
+        BRICK_THROW(brick::common::ValueException,
+                    "selectKeypointsByGrid()",
+                    "Argument scores must have one element for each "
+                    "keypoint.");
+      }
+      if(gridRows == 0 || gridColumns == 0) {
+        BRICK_THROW(brick::common::ValueException,
+                    "selectKeypointsByGrid()",
+                    "Grid dimensions must be greater than zero.");
+      }
+      if(keypoints.size() <= numberOfKeypoints) {
+        return;
+      }
+
+      // Figure out which cell each keypoint falls in.
+      std::vector<double> rows;
+      std::vector<double> columns;
+      double minimumRow;
+      double minimumColumn;
+      double maximumRow;
+      double maximumColumn;
+      privateCode::getKeypointCoordinates(
+        keypoints, rows, columns, minimumRow, minimumColumn,
+        maximumRow, maximumColumn);
+      double rowScale = gridRows / std::max(maximumRow - minimumRow, 1.0);
+      double columnScale =
+        gridColumns / std::max(maximumColumn - minimumColumn, 1.0);
+      std::vector<std::size_t> cellIndices(keypoints.size());
+      for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+        std::size_t cellRow = std::min(
+          static_cast<std::size_t>((rows[ii] - minimumRow) * rowScale),
+          static_cast<std::size_t>(gridRows - 1));
+        std::size_t cellColumn = std::min(
+          static_cast<std::size_t>((columns[ii] - minimumColumn)
+                                   * columnScale),
+          static_cast<std::size_t>(gridColumns - 1));
+        cellIndices[ii] = cellRow * gridColumns + cellColumn;
+      }
+
+      // Rank the keypoints within each cell.
+      std::vector<std::size_t> order(keypoints.size());
+      for(std::size_t ii = 0; ii < order.size(); ++ii) {
+        order[ii] = ii;
+      }
+      std::sort(order.begin(), order.end(),
+                privateCode::KeypointTileBudgetLess<ScoreType>(
+                  scores, cellIndices));
+      std::vector<std::size_t> ranks(keypoints.size());
+      std::size_t rank = 0;
+      for(std::size_t ii = 0; ii < order.size(); ++ii) {
+        if(ii == 0 || cellIndices[order[ii]] != cellIndices[order[ii - 1]]) {
+          rank = 0;
+        }
+        ranks[order[ii]] = rank;
+        ++rank;
+      }
+
+      // Keep the best of each cell first, then the second best of
+      // each cell, and so on.
+      std::sort(order.begin(), order.end(),
+                privateCode::KeypointGridRankLess<ScoreType>(scores, ranks));
+      std::vector<bool> isKept(keypoints.size(), false);
+      for(std::size_t ii = 0; ii < numberOfKeypoints; ++ii) {
+        isKept[order[ii]] = true;
+      }
+      privateCode::keepFlaggedKeypoints(keypoints, isKept);
+    }
+
+
+    template <class Keypoint, class ScoreType>
+    void
+    selectKeypointsAnms(std::vector<Keypoint>& keypoints,
+                        std::vector<ScoreType> const& scores,
+                        std::size_t numberOfKeypoints)
+    {
+      // Bisection stops as soon as it finds a radius that admits no
+      // more than this proportion of extra keypoints, or after
+      // maximumIterations steps, whichever comes first.
+      const double tolerance = 0.1;
+      const unsigned int maximumIterations = 32;
+
+      // The smallest radius considered is chosen so that the grid
+      // has no more than this many cells per keypoint.
+      const double maximumCellsPerKeypoint = 16.0;
+
+      if(scores.size() != keypoints.size()) {
+        BRICK_THROW(brick::common::ValueException,
+                    "selectKeypointsAnms()",
+                    "Argument scores must have one element for each "
+                    "keypoint.");
+      }
+      if(keypoints.size() <= numberOfKeypoints) {
+        return;
+      }
+      if(numberOfKeypoints == 0) {
+        keypoints.clear();
+        return;
+      }
+
+      std::vector<double> rows;
+      std::vector<double> columns;
+      double minimumRow;
+      double minimumColumn;
+      double maximumRow;
+      double maximumColumn;
+      privateCode::getKeypointCoordinates(
+        keypoints, rows, columns, minimumRow, minimumColumn,
+        maximumRow, maximumColumn);
+      double height = maximumRow - minimumRow;
+      double width = maximumColumn - minimumColumn;
+
+      // Greedy passes consider the keypoints best first.
+      std::vector<std::size_t> order(keypoints.size());
+      for(std::size_t ii = 0; ii < order.size(); ++ii) {
+        order[ii] = ii;
+      }
+      std::sort(order.begin(), order.end(),
+                privateCode::KeypointScoreLess<ScoreType>(scores));
+
+      // Bracket the radius.  If even the smallest admits too few
+      // keypoints, we'll make up the difference below.  Accepted
+      // keypoints occupy distinct cells of side radius / sqrt(2), so
+      // no radius that leaves fewer than numberOfKeypoints cells in
+      // the bounding box can admit enough of them.  Solving for the
+      // radius at which that happens gives the upper bound.
+      double area = (height + 1.0) * (width + 1.0);
+      double lowerRadius = std::sqrt(
+        2.0 * area / (maximumCellsPerKeypoint * keypoints.size()));
+      double upperRadius = std::sqrt(height * height + width * width) + 1.0;
+      if(numberOfKeypoints > 1) {
+        double scaledHeight = std::sqrt(2.0) * height;
+        double scaledWidth = std::sqrt(2.0) * width;
+        double sum = scaledHeight + scaledWidth;
+        double nMinusOne = static_cast<double>(numberOfKeypoints - 1);
+        upperRadius = std::min(
+          upperRadius,
+          (sum + std::sqrt(sum * sum
+                           + 4.0 * nMinusOne * scaledHeight * scaledWidth))
+          / (2.0 * nMinusOne) + 1.0);
+      }
+      std::size_t maximumSurvivors =
+        numberOfKeypoints
+        + static_cast<std::size_t>(tolerance * numberOfKeypoints);
+      std::vector<std::size_t> survivors;
+      privateCode::selectAnmsSurvivors(
+        rows, columns, order, minimumRow, minimumColumn, height, width,
+        lowerRadius, maximumSurvivors, survivors);
+      if(survivors.size() > maximumSurvivors) {
+        std::vector<std::size_t> candidates;
+        for(unsigned int ii = 0; ii < maximumIterations; ++ii) {
+          double radius = 0.5 * (lowerRadius + upperRadius);
+          privateCode::selectAnmsSurvivors(
+            rows, columns, order, minimumRow, minimumColumn, height, width,
+            radius, maximumSurvivors, candidates);
+          if(candidates.size() >= numberOfKeypoints) {
+            lowerRadius = radius;
+            survivors.swap(candidates);
+            if(survivors.size() <= maximumSurvivors) {
+              break;
+            }
+          } else {
+            upperRadius = radius;
+          }
+        }
+      }
+
+      // Survivors are in order of decreasing score, so truncating
+      // keeps the best of them.
+      std::vector<bool> isKept(keypoints.size(), false);
+      std::size_t numberKept = std::min(survivors.size(), numberOfKeypoints);
+      for(std::size_t ii = 0; ii < numberKept; ++ii) {
+        isKept[survivors[ii]] = true;
+      }
+
+      // If the keypoints are so tightly clustered that the smallest
+      // radius suppressed too many of them, fill the budget with the
+      // best of the suppressed keypoints.
+      for(std::size_t ii = 0;
+          ii < order.size() && numberKept < numberOfKeypoints; ++ii) {
+        if(!isKept[order[ii]]) {
+          isKept[order[ii]] = true;
+          ++numberKept;
+        }
+      }
+      privateCode::keepFlaggedKeypoints(keypoints, isKept);
+    }
+
+  } // namespace computerVision
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_COMPUTERVISION_KEYPOINTBUDGET_IMPL_HH */
@@ -11,10 +11,304 @@
 ***************************************************************************
 */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <numeric>
 #include <brick/common/constants.hh>
 #include <brick/common/mathFunctions.hh>
 #include <brick/computerVision/keypointMatcherFast.hh>
+#include <brick/numeric/simdKernels.hh>
+
+// As in brick/numeric/simdKernels.cc, the vectorized SSD is only
+// compiled for GCC/Clang on x86, and is selected at runtime.
+#if (defined(__x86_64__) || defined(__i386__)) \
+  && defined(__GNUC__) && defined(__SSE2__)
+#define BRICK_COMPUTERVISION_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BRICK_COMPUTERVISION_SIMD_X86 0
+#endif
+
+namespace {
+
+  using brick::common::Int32;
+  using brick::common::UInt8;
+  using brick::computerVision::KeypointFast;
+
+  const unsigned int numberOfFeatures = KeypointFast::numberOfFeatures;
+
+  // Largest number of rotated copies of a query feature vector: one
+  // for each shift from -numberOfFeatures/2 to +numberOfFeatures/2.
+  const unsigned int maximumNumberOfRotations = numberOfFeatures + 1;
+
+
+  // Number of single-sample shifts, in each direction, over which
+  // rotation invariant SSDs are minimized.  We add 1.0 here, rather
+  // than adding 0.5, as in the standard float-to-int conversion,
+  // because we want to round up.  This is just like calling ceil().
+  unsigned int
+  getNumberOfShifts(double expectedRotation)
+  {
+    return static_cast<unsigned int>(std::min(
+      static_cast<unsigned int>(
+        std::fabs(expectedRotation) / brick::common::constants::twoPi
+        * numberOfFeatures) + 1.0,
+      numberOfFeatures / 2.0));
+  }
+
+
+  // Fill rotatedFeatures with 2 * numberOfShifts + 1 circularly
+  // shifted copies of featureVector, numberOfFeatures bytes each,
+  // for shifts from -numberOfShifts to +numberOfShifts.
+  unsigned int
+  getRotatedFeatures(UInt8 const* featureVector, unsigned int numberOfShifts,
+                     UInt8* rotatedFeatures)
+  {
+    unsigned int numberOfRotations = 2 * numberOfShifts + 1;
+    for(unsigned int ii = 0; ii < numberOfRotations; ++ii) {
+      unsigned int offset = numberOfFeatures + ii - numberOfShifts;
+      for(unsigned int jj = 0; jj < numberOfFeatures; ++jj) {
+        rotatedFeatures[ii * numberOfFeatures + jj] =
+          featureVector[(jj + offset) % numberOfFeatures];
+      }
+    }
+    return numberOfRotations;
+  }
+
+
+  Int32
+  computeSSDScalar(UInt8 const* features0, UInt8 const* features1)
+  {
+    Int32 ssd = 0;
+    for(unsigned int ii = 0; ii < numberOfFeatures; ++ii) {
+      Int32 difference = (static_cast<Int32>(features1[ii])
+                          - static_cast<Int32>(features0[ii]));
+      ssd += difference * difference;
+    }
+    return ssd;
+  }
+
+
+  Int32
+  computeMinimumSSDScalar(UInt8 const* rotatedFeatures,
+                          unsigned int numberOfRotations,
+                          UInt8 const* features)
+  {
+    Int32 minimumSsd = std::numeric_limits<Int32>::max();
+    for(unsigned int ii = 0; ii < numberOfRotations; ++ii) {
+      minimumSsd = std::min(
+        minimumSsd,
+        computeSSDScalar(rotatedFeatures + ii * numberOfFeatures, features));
+    }
+    return minimumSsd;
+  }
+
+#if BRICK_COMPUTERVISION_SIMD_X86
+
+  // Differences of 8-bit values fit in 16 bits, and each madd lane
+  // sums two squares of at most 255^2, so the 32-bit partial sums
+  // can't overflow.
+  inline Int32
+  computeSSDSSE2(__m128i const& rotatedLow, __m128i const& rotatedHigh,
+                 __m128i const& featuresLow, __m128i const& featuresHigh)
+  {
+    __m128i differenceLow = _mm_sub_epi16(rotatedLow, featuresLow);
+    __m128i differenceHigh = _mm_sub_epi16(rotatedHigh, featuresHigh);
+    __m128i sums = _mm_add_epi32(
+      _mm_madd_epi16(differenceLow, differenceLow),
+      _mm_madd_epi16(differenceHigh, differenceHigh));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4e));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xb1));
+    return _mm_cvtsi128_si32(sums);
+  }
+
+
+  Int32
+  computeMinimumSSDSSE2(UInt8 const* rotatedFeatures,
+                        unsigned int numberOfRotations,
+                        UInt8 const* features)
+  {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i packed = _mm_loadu_si128(
+      reinterpret_cast<__m128i const*>(features));
+    __m128i featuresLow = _mm_unpacklo_epi8(packed, zero);
+    __m128i featuresHigh = _mm_unpackhi_epi8(packed, zero);
+    Int32 minimumSsd = std::numeric_limits<Int32>::max();
+    for(unsigned int ii = 0; ii < numberOfRotations; ++ii) {
+      packed = _mm_loadu_si128(reinterpret_cast<__m128i const*>(
+        rotatedFeatures + ii * numberOfFeatures));
+      minimumSsd = std::min(
+        minimumSsd,
+        computeSSDSSE2(_mm_unpacklo_epi8(packed, zero),
+                       _mm_unpackhi_epi8(packed, zero),
+                       featuresLow, featuresHigh));
+    }
+    return minimumSsd;
+  }
+
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+
+
+  // Smallest SSD between features and any of the rows of
+  // rotatedFeatures.
+  inline Int32
+  computeMinimumSSD(UInt8 const* rotatedFeatures,
+                    unsigned int numberOfRotations,
+                    UInt8 const* features,
+                    bool isSimd)
+  {
+#if BRICK_COMPUTERVISION_SIMD_X86
+    if(isSimd) {
+      return computeMinimumSSDSSE2(
+        rotatedFeatures, numberOfRotations, features);
+    }
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+    return computeMinimumSSDScalar(
+      rotatedFeatures, numberOfRotations, features);
+  }
+
+
+  bool
+  isSimdEnabled()
+  {
+    return (BRICK_COMPUTERVISION_SIMD_X86
+            && (brick::numeric::getSimdLevel()
+                >= brick::numeric::BRICK_SIMD_SSE2));
+  }
+
+
+  // Number of bands of queries per thread.  Using a few bands per
+  // thread evens out the load, while keeping the number of
+  // per-band reverse match arrays (each the size of the keypoint
+  // table) small.
+  const size_t keypointMatchBandsPerThread = 4;
+
+
+  // For one band of consecutive queries, the best query (and its SSD)
+  // for each stored keypoint, indexed by [isPositive][position in
+  // table].  Within a band, ties go to the earliest query.  Since
+  // taking the minimum is associative, combining bands in order with
+  // the same rule gives the same result for any number of bands.
+  struct KeypointMatchBand {
+    size_t queryBegin;
+    size_t queryEnd;
+    std::vector<Int32> reverseSsds[2];
+    std::vector<size_t> reverseQueries[2];
+  };
+
+
+  // Compares each query in a band with every stored keypoint of the
+  // same polarity, recording the best and second best SSD for each
+  // query, and, if requested, the best query for each stored
+  // keypoint.
+  class KeypointMatchFunctor {
+  public:
+    KeypointMatchFunctor(std::vector<KeypointFast> const& queries,
+                         UInt8 const* const* features,
+                         size_t const* const* indices,
+                         size_t const* numbersOfKeypoints,
+                         unsigned int numberOfShifts,
+                         bool isSimd,
+                         std::vector<Int32>& bestSsds,
+                         std::vector<Int32>& secondSsds,
+                         std::vector<size_t>& bestIndices,
+                         std::vector<KeypointMatchBand>& bands,
+                         bool isReverseMatchRequired)
+      : m_queries(queries), m_features(features), m_indices(indices),
+        m_numbersOfKeypoints(numbersOfKeypoints),
+        m_numberOfShifts(numberOfShifts), m_isSimd(isSimd),
+        m_bestSsds(bestSsds), m_secondSsds(secondSsds),
+        m_bestIndices(bestIndices), m_bands(bands),
+        m_isReverseMatchRequired(isReverseMatchRequired) {}
+
+    void operator()(size_t bandIndex) const {
+      KeypointMatchBand& band = m_bands[bandIndex];
+      if(m_isReverseMatchRequired) {
+        for(unsigned int polarity = 0; polarity < 2; ++polarity) {
+          band.reverseSsds[polarity].assign(
+            m_numbersOfKeypoints[polarity],
+            std::numeric_limits<Int32>::max());
+          band.reverseQueries[polarity].assign(
+            m_numbersOfKeypoints[polarity], 0);
+        }
+      }
+
+      UInt8 rotatedFeatures[maximumNumberOfRotations * numberOfFeatures];
+      for(size_t ii = band.queryBegin; ii < band.queryEnd; ++ii) {
+        unsigned int polarity = m_queries[ii].isPositive ? 1 : 0;
+        unsigned int numberOfRotations = getRotatedFeatures(
+          &(m_queries[ii].featureVector[0]), m_numberOfShifts,
+          rotatedFeatures);
+        Int32* reverseSsds = band.reverseSsds[polarity].data();
+        size_t* reverseQueries = band.reverseQueries[polarity].data();
+
+        UInt8 const* featuresPtr = m_features[polarity];
+        size_t const* indices = m_indices[polarity];
+        Int32 bestSsd = std::numeric_limits<Int32>::max();
+        Int32 secondSsd = std::numeric_limits<Int32>::max();
+        size_t bestIndex = 0;
+        for(size_t jj = 0; jj < m_numbersOfKeypoints[polarity]; ++jj) {
+          Int32 ssd = computeMinimumSSD(
+            rotatedFeatures, numberOfRotations, featuresPtr, m_isSimd);
+          if(ssd < bestSsd) {
+            secondSsd = bestSsd;
+            bestSsd = ssd;
+            bestIndex = jj;
+          } else {
+            // Equal SSDs go to the stored keypoint that came first
+            // in the input to setKeypoints().
+            if(ssd == bestSsd && indices[jj] < indices[bestIndex]) {
+              bestIndex = jj;
+            }
+            if(ssd < secondSsd) {
+              secondSsd = ssd;
+            }
+          }
+          if(m_isReverseMatchRequired && ssd < reverseSsds[jj]) {
+            reverseSsds[jj] = ssd;
+            reverseQueries[jj] = ii;
+          }
+          featuresPtr += numberOfFeatures;
+        }
+        m_bestSsds[ii] = bestSsd;
+        m_secondSsds[ii] = secondSsd;
+        m_bestIndices[ii] = bestIndex;
+      }
+    }
+
+  private:
+    std::vector<KeypointFast> const& m_queries;
+    UInt8 const* const* m_features;
+    size_t const* const* m_indices;
+    size_t const* m_numbersOfKeypoints;
+    unsigned int m_numberOfShifts;
+    bool m_isSimd;
+    std::vector<Int32>& m_bestSsds;
+    std::vector<Int32>& m_secondSsds;
+    std::vector<size_t>& m_bestIndices;
+    std::vector<KeypointMatchBand>& m_bands;
+    bool m_isReverseMatchRequired;
+  };
+
+
+  // Orders keypoint indices by feature vector mean.
+  class KeypointMeanLess {
+  public:
+    explicit KeypointMeanLess(std::vector<double> const& means)
+      : m_means(means) {}
+
+    bool operator()(size_t index0, size_t index1) const {
+      return m_means[index0] < m_means[index1];
+    }
+
+  private:
+    std::vector<double> const& m_means;
+  };
+
+} // namespace
+
+
 
 namespace brick {
 
@@ -24,8 +318,8 @@ namespace brick {
     KeypointMatcherFast::
     KeypointMatcherFast(double expectedRotation)
       : m_expectedRotation(expectedRotation),
-        m_keypointMapNegative(),
-        m_keypointMapPositive()
+        m_keypointTableNegative(),
+        m_keypointTablePositive()
     {
       // Empty.
     }
@@ -45,10 +339,43 @@ namespace brick {
     {
       if(query.isPositive) {
         return this->matchKeypoint(query, bestMatch,
-                                   this->m_keypointMapPositive);
+                                   this->m_keypointTablePositive);
       }
       return this->matchKeypoint(query, bestMatch,
-                                 this->m_keypointMapNegative);
+                                 this->m_keypointTableNegative);
+    }
+
+
+    void
+    KeypointMatcherFast::
+    buildKeypointTable(std::vector<KeypointFast> const& keypoints,
+                       std::vector<std::size_t> const& indices,
+                       KeypointTable& table)
+    {
+      std::vector<double> means(keypoints.size());
+      std::vector<size_t> order(keypoints.size());
+      for(size_t ii = 0; ii < keypoints.size(); ++ii) {
+        means[ii] = this->computeFeatureVectorMean(keypoints[ii]);
+        order[ii] = ii;
+      }
+
+      // Stable sort, so that keypoints with identical means keep
+      // their input order.
+      std::stable_sort(order.begin(), order.end(), KeypointMeanLess(means));
+
+      table.means.resize(keypoints.size());
+      table.keypoints.resize(keypoints.size());
+      table.features.resize(keypoints.size() * numberOfFeatures);
+      table.indices.resize(keypoints.size());
+      for(size_t ii = 0; ii < order.size(); ++ii) {
+        KeypointFast const& keypoint = keypoints[order[ii]];
+        table.means[ii] = means[order[ii]];
+        table.keypoints[ii] = keypoint;
+        table.indices[ii] = indices[order[ii]];
+        std::copy(&(keypoint.featureVector[0]),
+                  &(keypoint.featureVector[0]) + numberOfFeatures,
+                  &(table.features[ii * numberOfFeatures]));
+      }
     }
 
 
@@ -68,13 +395,9 @@ namespace brick {
     computeSSD(KeypointFast const& keypoint0, KeypointFast const& keypoint1)
       const
     {
-      double ssd = 0.0;
-      for(unsigned int ii = 0; ii < KeypointFast::numberOfFeatures; ++ii) {
-        double difference = (keypoint1.featureVector[ii]
-                             - keypoint0.featureVector[ii]);
-        ssd += difference * difference;
-      }
-      return ssd;
+      return static_cast<double>(
+        computeMinimumSSD(&(keypoint0.featureVector[0]), 1,
+                          &(keypoint1.featureVector[0]), isSimdEnabled()));
     }
 
 
@@ -84,151 +407,224 @@ namespace brick {
                                 KeypointFast const& keypoint1,
                                 double expectedRotation) const
     {
-      // We add 1.0 here, rather than adding 0.5, as in the standard
-      // float-to-int conversion, because we want to round up.  This
-      // is just like calling ceil().
-      const unsigned int angleInSamples = std::min(
-        static_cast<unsigned int>(
-          std::fabs(expectedRotation) / common::constants::twoPi
-          * KeypointFast::numberOfFeatures) + 1.0,
-        KeypointFast::numberOfFeatures / 2.0);
-
-      // Inefficient for now...  Compute SSD at each rotation.
-      double minimumSsd = std::numeric_limits<double>::max();
-
-      // For "negative" rotations.
-      for(unsigned int ii = angleInSamples; ii > 0; --ii) {
-        double ssd0 = 0.0;
-
-        // Account for "wrap" at the beginning of the feature vector,
-        // where the first few features of keypoint0 match up with the
-        // last few features of keypoint1.
-        for(unsigned int jj = 0; jj < ii; ++jj) {
-          unsigned int wrappedIndex = KeypointFast::numberOfFeatures - ii;
-          double difference = (keypoint1.featureVector[wrappedIndex + jj]
-                               - keypoint0.featureVector[jj]);
-          ssd0 += difference * difference;
-        }
-
-        // Account for the rest of the feature vector (the "unwrapped" part).
-        for(unsigned int jj = ii; jj < KeypointFast::numberOfFeatures; ++jj) {
-          double difference = (keypoint1.featureVector[jj - ii]
-                               - keypoint0.featureVector[jj]);
-          ssd0 += difference * difference;
-        }
-
-        if(ssd0 < minimumSsd) {
-          minimumSsd = ssd0;
-        }
-      }
-
-      // For zero rotation.
-      {
-        double ssd0 = 0.0;
-        for(unsigned int jj = 0; jj < KeypointFast::numberOfFeatures; ++jj) {
-          double difference = (keypoint1.featureVector[jj]
-                               - keypoint0.featureVector[jj]);
-          ssd0 += difference * difference;
-        }
-        if(ssd0 < minimumSsd) {
-          minimumSsd = ssd0;
-        }
-      }
-
-      // For positive rotation.
-      for(unsigned int ii = angleInSamples; ii > 0; --ii) {
-
-        double ssd0 = 0.0;
-
-        // Account for "wrap" at the beginning of the feature vector,
-        // where the first few features of keypoint1 match up with the
-        // last few features of keypoint0.
-        for(unsigned int jj = 0; jj < ii; ++jj) {
-          unsigned int wrappedIndex = KeypointFast::numberOfFeatures - ii;
-          double difference = (keypoint0.featureVector[wrappedIndex + jj]
-                               - keypoint1.featureVector[jj]);
-          ssd0 += difference * difference;
-        }
-
-        // Account for the rest of the feature vector (the "unwrapped" part).
-        for(unsigned int jj = ii; jj < KeypointFast::numberOfFeatures; ++jj) {
-          double difference = (keypoint0.featureVector[jj - ii]
-                               - keypoint1.featureVector[jj]);
-          ssd0 += difference * difference;
-        }
-
-        if(ssd0 < minimumSsd) {
-          minimumSsd = ssd0;
-        }
-      }
-
-      return minimumSsd;
+      UInt8 rotatedFeatures[maximumNumberOfRotations * numberOfFeatures];
+      unsigned int numberOfRotations = getRotatedFeatures(
+        &(keypoint0.featureVector[0]), getNumberOfShifts(expectedRotation),
+        rotatedFeatures);
+      return static_cast<double>(
+        computeMinimumSSD(rotatedFeatures, numberOfRotations,
+                          &(keypoint1.featureVector[0]), isSimdEnabled()));
     }
 
 
     bool
     KeypointMatcherFast::
     matchKeypoint(KeypointFast const& query, KeypointFast& bestMatch,
-                  std::map<double, KeypointFast> const& keypointMap) const
+                  KeypointTable const& keypointTable) const
     {
       // Sanity check.
-      if(keypointMap.empty()) {
+      if(keypointTable.keypoints.empty()) {
         return false;
       }
 
+      // Rotated copies of the query are computed once, here, rather
+      // than once for each stored keypoint.
+      UInt8 rotatedFeatures[maximumNumberOfRotations * numberOfFeatures];
+      unsigned int numberOfRotations = getRotatedFeatures(
+        &(query.featureVector[0]), getNumberOfShifts(m_expectedRotation),
+        rotatedFeatures);
+      bool isSimd = isSimdEnabled();
+
       // Start by finding the keypoint whose feature vector mean is
       // closest to that of the query point.  This is a good starting
       // point for a linear search.
-      typedef std::map<double, KeypointFast>::const_iterator MapIterator;
+      std::vector<double> const& means = keypointTable.means;
       double featureVectorMean = this->computeFeatureVectorMean(query);
-      MapIterator startIter = keypointMap.lower_bound(featureVectorMean);
+      size_t startIndex = (std::lower_bound(
+                             means.begin(), means.end(), featureVectorMean)
+                           - means.begin());
 
       // Now search forward until we know for sure we're not going to
       // find a better match.  We'll know we've gone far enough when
       // the difference in feature vector means is big enough to
       // guarantee that the new SSD between feature vectors is larger
       // than our best so far.
-      common::Int64 bestSSDSoFar = std::numeric_limits<common::Int64>::max();
-      MapIterator currentIter = startIter;
-      while(currentIter != keypointMap.end()) {
+      Int32 bestSSDSoFar = std::numeric_limits<Int32>::max();
+      size_t bestIndex = 0;
+      for(size_t ii = startIndex; ii < means.size(); ++ii) {
         double differenceInMeans = common::absoluteValue(
-          featureVectorMean - currentIter->first);
+          featureVectorMean - means[ii]);
         double boundOnNewSSD = (differenceInMeans * differenceInMeans
                                 * KeypointFast::numberOfFeatures);
         if(boundOnNewSSD >= bestSSDSoFar) {
           break;
         }
-        double newSSD = this->computeSSDRotationInvariant(
-          query, currentIter->second, m_expectedRotation);
+        Int32 newSSD = computeMinimumSSD(
+          rotatedFeatures, numberOfRotations,
+          &(keypointTable.features[ii * numberOfFeatures]), isSimd);
         if(newSSD < bestSSDSoFar) {
           bestSSDSoFar = newSSD;
-          bestMatch = currentIter->second;
+          bestIndex = ii;
         }
-        ++currentIter;
       }
 
       // Do the search again, but this time go backward, toward the
-      // beginning of the map.
-      currentIter = startIter;
-      while(currentIter != keypointMap.begin()) {
-        --currentIter;
+      // beginning of the table.
+      for(size_t ii = startIndex; ii > 0; --ii) {
         double differenceInMeans = common::absoluteValue(
-          featureVectorMean - currentIter->first);
+          featureVectorMean - means[ii - 1]);
         double boundOnNewSSD = (differenceInMeans * differenceInMeans
                                 * KeypointFast::numberOfFeatures);
         if(boundOnNewSSD >= bestSSDSoFar) {
           break;
         }
-        double newSSD = this->computeSSDRotationInvariant(
-          query, currentIter->second, m_expectedRotation);
+        Int32 newSSD = computeMinimumSSD(
+          rotatedFeatures, numberOfRotations,
+          &(keypointTable.features[(ii - 1) * numberOfFeatures]), isSimd);
         if(newSSD < bestSSDSoFar) {
           bestSSDSoFar = newSSD;
-          bestMatch = currentIter->second;
+          bestIndex = ii - 1;
         }
       }
+      bestMatch = keypointTable.keypoints[bestIndex];
       return true;
     }
 
+
+    double
+    KeypointMatcherFast::
+    matchKeypointBruteForce(KeypointFast const& query,
+                            KeypointFast& bestMatch,
+                            KeypointTable const& keypointTable) const
+    {
+      if(keypointTable.keypoints.empty()) {
+        return std::numeric_limits<double>::max();
+      }
+
+      UInt8 rotatedFeatures[maximumNumberOfRotations * numberOfFeatures];
+      unsigned int numberOfRotations = getRotatedFeatures(
+        &(query.featureVector[0]), getNumberOfShifts(m_expectedRotation),
+        rotatedFeatures);
+      bool isSimd = isSimdEnabled();
+
+      UInt8 const* featuresPtr = &(keypointTable.features[0]);
+      Int32 bestSSDSoFar = std::numeric_limits<Int32>::max();
+      size_t bestIndex = 0;
+      for(size_t ii = 0; ii < keypointTable.keypoints.size(); ++ii) {
+        Int32 newSSD = computeMinimumSSD(
+          rotatedFeatures, numberOfRotations, featuresPtr, isSimd);
+        if(newSSD < bestSSDSoFar) {
+          bestSSDSoFar = newSSD;
+          bestIndex = ii;
+        }
+        featuresPtr += numberOfFeatures;
+      }
+      bestMatch = keypointTable.keypoints[bestIndex];
+      return static_cast<double>(bestSSDSoFar);
+    }
+
+
+    void
+    KeypointMatcherFast::
+    matchKeypoints(std::vector<KeypointFast> const& queries,
+                   std::vector<KeypointMatchFast>& matches,
+                   double maximumRatio,
+                   bool isMutualCheckRequired,
+                   brick::common::ThreadPool* threadPoolPtr) const
+    {
+      // Index 0 refers to negative keypoints, and index 1 to
+      // positive keypoints.
+      KeypointTable const* tables[2] = {
+        &m_keypointTableNegative, &m_keypointTablePositive};
+      UInt8 const* features[2];
+      size_t const* indices[2];
+      size_t numbersOfKeypoints[2];
+      for(unsigned int polarity = 0; polarity < 2; ++polarity) {
+        numbersOfKeypoints[polarity] = tables[polarity]->keypoints.size();
+        features[polarity] = tables[polarity]->features.data();
+        indices[polarity] = tables[polarity]->indices.data();
+      }
+
+      // Compare every query with every stored keypoint.
+      std::vector<Int32> bestSsds(queries.size());
+      std::vector<Int32> secondSsds(queries.size());
+      std::vector<size_t> bestIndices(queries.size());
+      size_t numberOfBands = 1;
+      if(threadPoolPtr != 0) {
+        numberOfBands = (keypointMatchBandsPerThread
+                         * threadPoolPtr->getNumberOfThreads());
+        numberOfBands = std::max(
+          std::min(numberOfBands, queries.size()), static_cast<size_t>(1));
+      }
+      std::vector<KeypointMatchBand> bands(numberOfBands);
+      for(size_t bandIndex = 0; bandIndex < numberOfBands; ++bandIndex) {
+        bands[bandIndex].queryBegin =
+          (bandIndex * queries.size()) / numberOfBands;
+        bands[bandIndex].queryEnd =
+          ((bandIndex + 1) * queries.size()) / numberOfBands;
+      }
+      KeypointMatchFunctor functor(
+        queries, features, indices, numbersOfKeypoints,
+        getNumberOfShifts(m_expectedRotation), isSimdEnabled(),
+        bestSsds, secondSsds, bestIndices, bands, isMutualCheckRequired);
+      if(threadPoolPtr != 0) {
+        threadPoolPtr->parallelFor(numberOfBands, functor);
+      } else {
+        functor(0);
+      }
+
+      // Fold the later bands' reverse matches into the first band's,
+      // in band order, so that ties go to the earliest query, just
+      // as in a serial pass.
+      std::vector<Int32>* reverseSsds = bands[0].reverseSsds;
+      std::vector<size_t>* reverseQueries = bands[0].reverseQueries;
+      if(isMutualCheckRequired) {
+        for(unsigned int polarity = 0; polarity < 2; ++polarity) {
+          for(size_t bandIndex = 1; bandIndex < numberOfBands; ++bandIndex) {
+            KeypointMatchBand const& band = bands[bandIndex];
+            for(size_t jj = 0; jj < numbersOfKeypoints[polarity]; ++jj) {
+              if(band.reverseSsds[polarity][jj] < reverseSsds[polarity][jj]) {
+                reverseSsds[polarity][jj] = band.reverseSsds[polarity][jj];
+                reverseQueries[polarity][jj] =
+                  band.reverseQueries[polarity][jj];
+              }
+            }
+          }
+        }
+      }
+
+      matches.clear();
+      for(size_t ii = 0; ii < queries.size(); ++ii) {
+        unsigned int polarity = queries[ii].isPositive ? 1 : 0;
+        if(numbersOfKeypoints[polarity] == 0) {
+          continue;
+        }
+
+        // SSDs are squared distances, so the ratio of distances is
+        // the square root of the ratio of SSDs.
+        double ratio = 0.0;
+        if(secondSsds[ii] != std::numeric_limits<Int32>::max()) {
+          ratio = (secondSsds[ii] == 0) ? 1.0
+            : std::sqrt(static_cast<double>(bestSsds[ii])
+                        / static_cast<double>(secondSsds[ii]));
+        }
+        if(ratio > maximumRatio) {
+          continue;
+        }
+        if(isMutualCheckRequired
+           && reverseQueries[polarity][bestIndices[ii]] != ii) {
+          continue;
+        }
+
+        KeypointMatchFast match;
+        match.queryIndex = ii;
+        match.keypointIndex = tables[polarity]->indices[bestIndices[ii]];
+        match.ssd = static_cast<double>(bestSsds[ii]);
+        match.ratio = ratio;
+        matches.push_back(match);
+      }
+    }
+
   } // namespace computerVision
 
 } // namespace brick
@@ -14,13 +14,40 @@
 #ifndef BRICK_COMPUTERVISION_KEYPOINTMATCHERFAST_HH
 #define BRICK_COMPUTERVISION_KEYPOINTMATCHERFAST_HH
 
-#include <map>
+#include <cstddef>
+#include <vector>
+#include <brick/common/threadPool.hh>
+#include <brick/common/types.hh>
 #include <brick/computerVision/keypointSelectorFast.hh>
 
 namespace brick {
 
   namespace computerVision {
 
+    /**
+     ** This struct describes one correspondence reported by
+     ** KeypointMatcherFast::matchKeypoints().
+     **/
+    struct KeypointMatchFast {
+      /// Position of the query keypoint in the query sequence.
+      std::size_t queryIndex;
+
+      /// Position of the matching keypoint in the sequence passed to
+      /// KeypointMatcherFast::setKeypoints().
+      std::size_t keypointIndex;
+
+      /// Sum of squared differences between the two feature vectors,
+      /// minimized over the allowed rotations.
+      double ssd;
+
+      /// Lowe's ratio: the feature space distance to the best match
+      /// divided by the distance to the second best match, or 0.0 if
+      /// there is no second best match.  Smaller values indicate
+      /// less ambiguous matches.
+      double ratio;
+    };
+
+
     /**
      ** This class implements Rosten's "FAST" keypoint recognition
      ** algorithm, as as described in [1], with the exception that our
@@ -29,6 +56,11 @@ namespace brick {
      ** elements, and does not short-circuit SSD computations to speed
      ** up the search.
      **
+     ** Stored keypoints are kept in arrays sorted by feature vector
+     ** mean, with the feature vectors packed contiguously, and SSDs
+     ** are computed using 16-bit integer SIMD instructions where
+     ** available (see brick::numeric::getSimdLevel()).
+     **
      ** [1] E. Rosten, and T. Drummond, "Fusing Points and Lines for
      ** High Performance Tracking," International Conference on
      ** Computer Vision, 2005.
@@ -76,6 +108,112 @@ namespace brick {
       matchKeypoint(KeypointFast const& query, KeypointFast& bestMatch) const;
 
 
+      /**
+       * This member function matches each of a sequence of query
+       * keypoints by exhaustively comparing it with every stored
+       * keypoint of the same polarity, skipping the search window
+       * based on feature vector means that is used by
+       * matchKeypoint().  When the means of the stored keypoints are
+       * tightly clustered, so that the window does little pruning,
+       * this is faster because its inner loop is a simple pass over
+       * contiguous feature vectors.  Matches are the same as those
+       * returned by matchKeypoint(), except possibly in the case of
+       * ties.
+       *
+       * @param queryBegin This argument is the beginning of a
+       * sequence of keypoints to be matched.
+       *
+       * @param queryEnd This argument is the end of a sequence of
+       * keypoints to be matched.
+       *
+       * @param bestMatches This argument is used to return the best
+       * match for each query keypoint, in the order of the queries.
+       *
+       * @param ssds This argument is used to return the sum of
+       * squared differences between each query and its best match,
+       * minimized over the allowed rotations.  If there are no stored
+       * keypoints with the same polarity as a query, the
+       * corresponding element of ssds will be
+       * std::numeric_limits<double>::max(), and the corresponding
+       * element of bestMatches will be unchanged.
+       */
+      template <class Iter>
+      void
+      matchKeypointsBruteForce(Iter queryBegin, Iter queryEnd,
+                               std::vector<KeypointFast>& bestMatches,
+                               std::vector<double>& ssds) const;
+
+
+      /**
+       * This member function matches a sequence of query keypoints
+       * against the stored keypoints in a single exhaustive pass,
+       * keeping track of the best and second best stored keypoint
+       * for each query, and of the best query for each stored
+       * keypoint.  Matches are reported only if they pass Lowe's
+       * ratio test and, optionally, a mutual consistency check,
+       * which requires that the query is also the best match for its
+       * stored keypoint.  Ties are resolved in favor of the keypoint
+       * that appears first in its input sequence.
+       *
+       * @param queryBegin This argument is the beginning of a
+       * sequence of keypoints to be matched.
+       *
+       * @param queryEnd This argument is the end of a sequence of
+       * keypoints to be matched.
+       *
+       * @param matches This argument is used to return the accepted
+       * matches, ordered by queryIndex.
+       *
+       * @param maximumRatio This argument specifies the largest
+       * acceptable ratio between the distance to the best match and
+       * the distance to the second best match.  Lowe suggests 0.8.
+       * The default value of 1.0 accepts every best match.
+       *
+       * @param isMutualCheckRequired Set this argument to false to
+       * skip the mutual consistency check.
+       */
+      template <class Iter>
+      void
+      matchKeypoints(Iter queryBegin, Iter queryEnd,
+                     std::vector<KeypointMatchFast>& matches,
+                     double maximumRatio = 1.0,
+                     bool isMutualCheckRequired = true) const;
+
+
+      /**
+       * This member function works just like the serial version of
+       * matchKeypoints(), but divides the queries among the threads
+       * of the specified ThreadPool.  The results are identical to
+       * those of the serial version.
+       *
+       * @param queryBegin This argument is the beginning of a
+       * sequence of keypoints to be matched.
+       *
+       * @param queryEnd This argument is the end of a sequence of
+       * keypoints to be matched.
+       *
+       * @param matches This argument is used to return the accepted
+       * matches, ordered by queryIndex.
+       *
+       * @param maximumRatio This argument specifies the largest
+       * acceptable ratio between the distance to the best match and
+       * the distance to the second best match.
+       *
+       * @param isMutualCheckRequired Set this argument to false to
+       * skip the mutual consistency check.
+       *
+       * @param threadPool This argument is the ThreadPool that will
+       * compute the matches.
+       */
+      template <class Iter>
+      void
+      matchKeypoints(Iter queryBegin, Iter queryEnd,
+                     std::vector<KeypointMatchFast>& matches,
+                     double maximumRatio,
+                     bool isMutualCheckRequired,
+                     brick::common::ThreadPool& threadPool) const;
+
+
       /**
        * Specify the set of keypoints from which to draw matches when
        * member function matchKeypoint() is subsequently called.  All
@@ -95,6 +233,28 @@ namespace brick {
 
     protected:
 
+      // Stored keypoints of one polarity, sorted by feature vector
+      // mean.  The feature vectors are copied into a single array,
+      // KeypointFast::numberOfFeatures bytes per keypoint, so that
+      // they can be compared without touching the rest of each
+      // KeypointFast instance.  Element indices[ii] is the position
+      // of keypoints[ii] in the sequence passed to setKeypoints().
+      struct KeypointTable {
+        std::vector<double> means;
+        std::vector<KeypointFast> keypoints;
+        std::vector<brick::common::UInt8> features;
+        std::vector<std::size_t> indices;
+      };
+
+
+      // Sort keypoints by feature vector mean and store them in
+      // table.
+      void
+      buildKeypointTable(std::vector<KeypointFast> const& keypoints,
+                         std::vector<std::size_t> const& indices,
+                         KeypointTable& table);
+
+
       // Get the mean of the feature vector associated with keypoint.
       double
       computeFeatureVectorMean(KeypointFast const& keypoint) const;
@@ -115,15 +275,31 @@ namespace brick {
                                   KeypointFast const& keypoint1,
                                   double expectedRotation = 0.5) const;
 
-      // Search the specified map of stored keypoints and find the one
-      // most similar to the input "query" keypoint.
+      // Search the specified table of stored keypoints and find the
+      // one most similar to the input "query" keypoint.
       bool
       matchKeypoint(KeypointFast const& query, KeypointFast& bestMatch,
-                    std::map<double, KeypointFast> const& keypointMap) const;
+                    KeypointTable const& keypointTable) const;
+
+      // Compare query with every keypoint in keypointTable.  Returns
+      // the SSD of the best match, or
+      // std::numeric_limits<double>::max() if the table is empty.
+      double
+      matchKeypointBruteForce(KeypointFast const& query,
+                              KeypointFast& bestMatch,
+                              KeypointTable const& keypointTable) const;
+
+      // Non-template implementation of matchKeypoints().
+      void
+      matchKeypoints(std::vector<KeypointFast> const& queries,
+                     std::vector<KeypointMatchFast>& matches,
+                     double maximumRatio,
+                     bool isMutualCheckRequired,
+                     brick::common::ThreadPool* threadPoolPtr) const;
 
       double m_expectedRotation;
-      std::map<double, KeypointFast> m_keypointMapNegative;
-      std::map<double, KeypointFast> m_keypointMapPositive;
+      KeypointTable m_keypointTableNegative;
+      KeypointTable m_keypointTablePositive;
     };
 
   } // namespace computerVision
@@ -19,29 +19,82 @@
 //
 // #include <brick/computerVision/keypointMatcherFast.hh>
 
+#include <iterator>
+
 namespace brick {
 
   namespace computerVision {
 
+    template <class Iter>
+    void
+    KeypointMatcherFast::
+    matchKeypointsBruteForce(Iter queryBegin, Iter queryEnd,
+                             std::vector<KeypointFast>& bestMatches,
+                             std::vector<double>& ssds) const
+    {
+      bestMatches.resize(std::distance(queryBegin, queryEnd));
+      ssds.resize(bestMatches.size());
+      for(size_t ii = 0; queryBegin != queryEnd; ++queryBegin, ++ii) {
+        ssds[ii] = this->matchKeypointBruteForce(
+          *queryBegin, bestMatches[ii],
+          queryBegin->isPositive ? m_keypointTablePositive
+          : m_keypointTableNegative);
+      }
+    }
+
+
+    template <class Iter>
+    void
+    KeypointMatcherFast::
+    matchKeypoints(Iter queryBegin, Iter queryEnd,
+                   std::vector<KeypointMatchFast>& matches,
+                   double maximumRatio,
+                   bool isMutualCheckRequired) const
+    {
+      std::vector<KeypointFast> queries(queryBegin, queryEnd);
+      this->matchKeypoints(queries, matches, maximumRatio,
+                           isMutualCheckRequired, 0);
+    }
+
+
+    template <class Iter>
+    void
+    KeypointMatcherFast::
+    matchKeypoints(Iter queryBegin, Iter queryEnd,
+                   std::vector<KeypointMatchFast>& matches,
+                   double maximumRatio,
+                   bool isMutualCheckRequired,
+                   brick::common::ThreadPool& threadPool) const
+    {
+      std::vector<KeypointFast> queries(queryBegin, queryEnd);
+      this->matchKeypoints(queries, matches, maximumRatio,
+                           isMutualCheckRequired, &threadPool);
+    }
+
+
     template <class Iter>
     void
     KeypointMatcherFast::
     setKeypoints(Iter sequenceBegin, Iter sequenceEnd)
     {
-      m_keypointMapNegative.clear();
-      m_keypointMapPositive.clear();
-      while(sequenceBegin != sequenceEnd) {
-        double featureVectorMean = this->computeFeatureVectorMean(
-          *sequenceBegin);
+      std::vector<KeypointFast> negativeKeypoints;
+      std::vector<KeypointFast> positiveKeypoints;
+      std::vector<std::size_t> negativeIndices;
+      std::vector<std::size_t> positiveIndices;
+      for(std::size_t ii = 0; sequenceBegin != sequenceEnd;
+          ++sequenceBegin, ++ii) {
         if(sequenceBegin->isPositive) {
-          m_keypointMapPositive.insert(
-            std::make_pair(featureVectorMean, *sequenceBegin));
+          positiveKeypoints.push_back(*sequenceBegin);
+          positiveIndices.push_back(ii);
         } else {
-          m_keypointMapNegative.insert(
-            std::make_pair(featureVectorMean, *sequenceBegin));
+          negativeKeypoints.push_back(*sequenceBegin);
+          negativeIndices.push_back(ii);
         }
-        ++sequenceBegin;
       }
+      this->buildKeypointTable(negativeKeypoints, negativeIndices,
+                               m_keypointTableNegative);
+      this->buildKeypointTable(positiveKeypoints, positiveIndices,
+                               m_keypointTablePositive);
     }
 
     // ============== Private member functions below this line ==============
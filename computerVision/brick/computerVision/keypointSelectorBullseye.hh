@@ -16,7 +16,9 @@
 
 #include <limits>
 #include <vector>
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/image.hh>
+#include <brick/computerVision/keypointTiling.hh>
 #include <brick/geometry/bullseye2D.hh>
 #include <brick/numeric/index2D.hh>
 #include <brick/numeric/vector2D.hh>
@@ -61,6 +63,16 @@ namespace brick {
     };
 
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      template <class FloatType>
+      class KeypointSelectorBullseyeTileFunctor;
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** This class template looks for bullseye targets in an input
      ** image.  It does not use a scale space, and operates directly
@@ -72,6 +84,13 @@ namespace brick {
      ** std::vector< KeypointBullseye<double> > keypoints
      **    = myKeypointSelector.getKeypointsGeneralPosition();
      ** @endcode
+     **
+     ** If member function setTiling() or setThreadPool() has been
+     ** called, setImage() evaluates candidate bullseye centers one
+     ** tile at a time, possibly in parallel, and then merges the
+     ** results in the same order as the untiled code, so that
+     ** (absent a per-tile keypoint budget) the selected keypoints
+     ** are identical.
      **/
     template <class FloatType>
     class KeypointSelectorBullseye {
@@ -224,8 +243,50 @@ namespace brick {
                brick::common::UInt32 stopColumn);
 
 
+      /**
+       * This member function makes subsequent calls to setImage()
+       * evaluate candidate bullseyes using the threads of the
+       * specified ThreadPool.  If no tile size has been specified
+       * using setTiling(), tiles of keypointDefaultTileSize rows and
+       * columns are used.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use, which must outlive *this or be replaced by a
+       * subsequent call to setThreadPool().  Pass 0 to process the
+       * image in the calling thread.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr);
+
+
+      /**
+       * This member function makes subsequent calls to setImage()
+       * divide the region of interest into tiles, and optionally
+       * limits the number of bullseyes that any one tile may
+       * contribute.  When a tile has more bullseyes than the limit,
+       * the ones with the best bullseye metric are kept.
+       *
+       * @param tileRows This argument specifies the height of each
+       * tile.  Setting both tileRows and tileColumns to zero
+       * disables tiling, unless a ThreadPool has been set.
+       *
+       * @param tileColumns This argument specifies the width of each
+       * tile.
+       *
+       * @param maximumKeypointsPerTile This argument specifies the
+       * largest number of bullseyes to accept from any one tile.
+       * Setting it to zero disables the limit.
+       */
+      void
+      setTiling(brick::common::UInt32 tileRows,
+                brick::common::UInt32 tileColumns,
+                brick::common::UInt32 maximumKeypointsPerTile = 0);
+
+
     private:
 
+      friend class privateCode::KeypointSelectorBullseyeTileFunctor<FloatType>;
+
       typedef brick::common::Int32 AccumulatedType;
 
       struct ComponentDescription {
@@ -393,6 +454,38 @@ namespace brick {
       }
 
 
+      // Run the cheap tests on a candidate pixel and, if they pass,
+      // fill in keypoint using evaluateBullseyeMetric().  Returns
+      // false if the candidate was rejected without evaluation.
+      bool
+      evaluateCandidate(
+        brick::numeric::Index2D const& candidate,
+        Image<GRAY8> const& inImage,
+        Image<GRAY1> const& edgeImage,
+        brick::numeric::Array2D<FloatType> const& gradientX,
+        brick::numeric::Array2D<FloatType> const& gradientY,
+        FloatType asymmetryThreshold,
+        KeypointBullseye<brick::common::Int32, FloatType>& keypoint) const;
+
+
+      // Evaluate the candidates that fall within one tile, and
+      // enforce the per-tile budget.  Sets the elements of isFound
+      // corresponding to bullseyes that should be passed to
+      // sortedInsert().
+      void
+      evaluateTileCandidates(
+        std::vector<std::size_t> const& candidateIndices,
+        std::vector<brick::numeric::Index2D> const& candidatePoints,
+        Image<GRAY8> const& inImage,
+        Image<GRAY1> const& edgeImage,
+        brick::numeric::Array2D<FloatType> const& gradientX,
+        brick::numeric::Array2D<FloatType> const& gradientY,
+        FloatType asymmetryThreshold,
+        std::vector< KeypointBullseye<brick::common::Int32, FloatType> >&
+          keypoints,
+        std::vector<char>& isFound) const;
+
+
       // Compute a measure of bullseye-ness that's more expensive --
       // and more accurate -- than asymmetry, and Fill out a KeyPoint
       // instance with the corresponding information.
@@ -459,6 +552,11 @@ namespace brick {
       brick::common::UInt32 m_minRadius;
       brick::common::UInt8 m_minDynamicRange;
 
+      brick::common::UInt32 m_maximumKeypointsPerTile;
+      brick::common::ThreadPool* m_threadPoolPtr;
+      brick::common::UInt32 m_tileColumns;
+      brick::common::UInt32 m_tileRows;
+
     };
 
   } // namespace computerVision
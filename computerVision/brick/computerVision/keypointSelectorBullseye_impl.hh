@@ -20,6 +20,7 @@
 //
 // #include <brick/computerVision/keypointSelectorBullseye.hh>
 
+#include <brick/common/exception.hh>
 #include <brick/common/mathFunctions.hh>
 #include <brick/computerVision/canny.hh>
 #include <brick/computerVision/connectedComponents.hh>
@@ -34,6 +35,64 @@ namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Evaluates the candidate bullseyes in one tile.  Each call
+      // works on its own copy of the selector, since
+      // evaluateBullseyeMetric() modifies scratch buffers that are
+      // members of KeypointSelectorBullseye.
+      template <class FloatType>
+      class KeypointSelectorBullseyeTileFunctor {
+      public:
+        typedef KeypointBullseye<brick::common::Int32, FloatType> Keypoint;
+
+        KeypointSelectorBullseyeTileFunctor(
+          KeypointSelectorBullseye<FloatType> const& selector,
+          std::vector< std::vector<std::size_t> > const& tileCandidates,
+          std::vector<brick::numeric::Index2D> const& candidatePoints,
+          Image<GRAY8> const& inImage,
+          Image<GRAY1> const& edgeImage,
+          brick::numeric::Array2D<FloatType> const& gradientX,
+          brick::numeric::Array2D<FloatType> const& gradientY,
+          FloatType asymmetryThreshold,
+          std::vector<Keypoint>& keypoints,
+          std::vector<char>& isFound)
+          : m_selector(selector), m_tileCandidates(tileCandidates),
+            m_candidatePoints(candidatePoints), m_inImage(inImage),
+            m_edgeImage(edgeImage), m_gradientX(gradientX),
+            m_gradientY(gradientY), m_asymmetryThreshold(asymmetryThreshold),
+            m_keypoints(keypoints), m_isFound(isFound) {}
+
+        void
+        operator()(std::size_t tileIndex) const {
+          if(m_tileCandidates[tileIndex].empty()) {
+            return;
+          }
+          KeypointSelectorBullseye<FloatType> worker(m_selector);
+          worker.evaluateTileCandidates(
+            m_tileCandidates[tileIndex], m_candidatePoints, m_inImage,
+            m_edgeImage, m_gradientX, m_gradientY, m_asymmetryThreshold,
+            m_keypoints, m_isFound);
+        }
+
+      private:
+        KeypointSelectorBullseye<FloatType> const& m_selector;
+        std::vector< std::vector<std::size_t> > const& m_tileCandidates;
+        std::vector<brick::numeric::Index2D> const& m_candidatePoints;
+        Image<GRAY8> const& m_inImage;
+        Image<GRAY1> const& m_edgeImage;
+        brick::numeric::Array2D<FloatType> const& m_gradientX;
+        brick::numeric::Array2D<FloatType> const& m_gradientY;
+        FloatType m_asymmetryThreshold;
+        std::vector<Keypoint>& m_keypoints;
+        std::vector<char>& m_isFound;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
     template <class FloatType>
     KeypointSelectorBullseye<FloatType>::
     KeypointSelectorBullseye(brick::common::UInt32 maxNumberOfBullseyes,
@@ -51,7 +110,11 @@ namespace brick {
         m_numberOfTransitions(numberOfTransitions),
         m_maxRadius(maxRadius),
         m_minRadius(minRadius),
-        m_minDynamicRange(10)
+        m_minDynamicRange(10),
+        m_maximumKeypointsPerTile(0),
+        m_threadPoolPtr(0),
+        m_tileColumns(0),
+        m_tileRows(0)
     {
       // Don't crash if the user confuses the min & max arguments.
       if(m_minRadius > m_maxRadius) {
@@ -404,44 +467,65 @@ namespace brick {
       // Test every candidate pixel!
       brick::common::UInt32 totalPixels = 0;
       brick::common::UInt32 testedPixels = 0;
-      for(auto candidateIter = candidatePoints.begin();
-          candidateIter != candidatePoints.end(); ++candidateIter) {
-
-        ++totalPixels;
-        brick::common::UInt32 row = candidateIter->getRow();
-        brick::common::UInt32 column = candidateIter->getColumn();
-
-        // Tailor fiducial size so we don't run off the side of the
-        // image.
-        brick::common::UInt32 minRadius = m_minRadius;
-        brick::common::UInt32 maxRadius = m_maxRadius;
-        if(!this->adjustFiducialSize(minRadius, maxRadius, row, column,
-                                     inImage.rows(), inImage.columns())) {
-          continue;
+      if(m_tileRows == 0 && m_threadPoolPtr == 0) {
+        for(auto candidateIter = candidatePoints.begin();
+            candidateIter != candidatePoints.end(); ++candidateIter) {
+          ++totalPixels;
+          KeypointBullseye<brick::common::Int32, FloatType> keypoint;
+          if(!this->evaluateCandidate(
+               *candidateIter, inImage, edgeImage, gradientX, gradientY,
+               asymmetryThreshold, keypoint)) {
+            continue;
+          }
+          if(keypoint.bullseyeMetric >= 0.0) {
+            this->sortedInsert(keypoint, m_keypointVector,
+                               this->m_minRadius, this->m_maxNumberOfBullseyes);
+          }
+          ++testedPixels;
         }
-
-        // Create a candidate keypoint.
-        KeypointBullseye<brick::common::Int32, FloatType> keypoint(
-          row, column);
-
-        // Member function evaluateBullseyeMetric() is too expensive
-        // to run at every pixel.  Make absolutely sure this could
-        // be a bullseye before proceeding.
-        if(!this->isPlausibleBullseye(
-             keypoint, inImage, minRadius, maxRadius, asymmetryThreshold)) {
-          continue;
+      } else {
+        // Evaluate candidates one tile at a time, and then insert
+        // the survivors in the original candidate order, just as the
+        // untiled code does.
+        KeypointTiling tiling(
+          startRow, startColumn, stopRow, stopColumn,
+          (m_tileRows != 0) ? m_tileRows : keypointDefaultTileSize,
+          (m_tileColumns != 0) ? m_tileColumns : keypointDefaultTileSize);
+        std::vector< std::vector<std::size_t> > tileCandidates(
+          tiling.getNumberOfTiles());
+        for(std::size_t ii = 0; ii < candidatePoints.size(); ++ii) {
+          tileCandidates[tiling.getTileIndex(
+              candidatePoints[ii].getRow(), candidatePoints[ii].getColumn())]
+            .push_back(ii);
+        }
+        std::vector< KeypointBullseye<brick::common::Int32, FloatType> >
+          keypoints(candidatePoints.size());
+        std::vector<char> isFound(candidatePoints.size(), 0);
+
+        privateCode::KeypointSelectorBullseyeTileFunctor<FloatType> functor(
+          *this, tileCandidates, candidatePoints, inImage, edgeImage,
+          gradientX, gradientY, asymmetryThreshold, keypoints, isFound);
+        if(m_threadPoolPtr != 0) {
+          // Tiles share these arrays, and may make shallow copies of
+          // them in different threads.
+          edgeImage.setReferenceCountThreadSafe();
+          gradientX.setReferenceCountThreadSafe();
+          gradientY.setReferenceCountThreadSafe();
+          m_threadPoolPtr->parallelFor(tileCandidates.size(), functor);
+        } else {
+          for(std::size_t tileIndex = 0; tileIndex < tileCandidates.size();
+              ++tileIndex) {
+            functor(tileIndex);
+          }
         }
 
-        // All prescreening passes.  Go ahead with the expensive
-        // bullseye evaluation.
-        this->evaluateBullseyeMetric(keypoint, edgeImage,
-                                     gradientX, gradientY,
-                                     minRadius, maxRadius);
-        if(keypoint.bullseyeMetric >= 0.0) {
-          this->sortedInsert(keypoint, m_keypointVector,
-                             this->m_minRadius, this->m_maxNumberOfBullseyes);
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          if(isFound[ii]) {
+            this->sortedInsert(keypoints[ii], m_keypointVector,
+                               this->m_minRadius, this->m_maxNumberOfBullseyes);
+          }
         }
-        ++testedPixels;
+        totalPixels = candidatePoints.size();
       }
 
 #if CV_KSB_PRINT_STATS
@@ -461,6 +545,34 @@ namespace brick {
     }
 
 
+    template <class FloatType>
+    void
+    KeypointSelectorBullseye<FloatType>::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr)
+    {
+      m_threadPoolPtr = threadPoolPtr;
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorBullseye<FloatType>::
+    setTiling(brick::common::UInt32 tileRows,
+              brick::common::UInt32 tileColumns,
+              brick::common::UInt32 maximumKeypointsPerTile)
+    {
+      if((tileRows == 0) != (tileColumns == 0)) {
+        BRICK_THROW(brick::common::ValueException,
+                    "KeypointSelectorBullseye::setTiling()",
+                    "Arguments tileRows and tileColumns must either both "
+                    "be zero, or both be greater than zero.");
+      }
+      m_tileRows = tileRows;
+      m_tileColumns = tileColumns;
+      m_maximumKeypointsPerTile = maximumKeypointsPerTile;
+    }
+
+
     // ============== Private member functions below this line ==============
 
 
@@ -1229,6 +1341,91 @@ namespace brick {
     // Uses connected components to limit attention to a small
     // number of "candidate" points in the image.
     // TBD(xxx): Make ROI relevant.
+    template <class FloatType>
+    bool
+    KeypointSelectorBullseye<FloatType>::
+    evaluateCandidate(
+      brick::numeric::Index2D const& candidate,
+      Image<GRAY8> const& inImage,
+      Image<GRAY1> const& edgeImage,
+      brick::numeric::Array2D<FloatType> const& gradientX,
+      brick::numeric::Array2D<FloatType> const& gradientY,
+      FloatType asymmetryThreshold,
+      KeypointBullseye<brick::common::Int32, FloatType>& keypoint) const
+    {
+      brick::common::UInt32 row = candidate.getRow();
+      brick::common::UInt32 column = candidate.getColumn();
+
+      // Tailor fiducial size so we don't run off the side of the
+      // image.
+      brick::common::UInt32 minRadius = m_minRadius;
+      brick::common::UInt32 maxRadius = m_maxRadius;
+      if(!this->adjustFiducialSize(minRadius, maxRadius, row, column,
+                                   inImage.rows(), inImage.columns())) {
+        return false;
+      }
+
+      // Create a candidate keypoint.
+      keypoint = KeypointBullseye<brick::common::Int32, FloatType>(
+        row, column);
+
+      // Member function evaluateBullseyeMetric() is too expensive
+      // to run at every pixel.  Make absolutely sure this could
+      // be a bullseye before proceeding.
+      if(!this->isPlausibleBullseye(
+           keypoint, inImage, minRadius, maxRadius, asymmetryThreshold)) {
+        return false;
+      }
+
+      // All prescreening passes.  Go ahead with the expensive
+      // bullseye evaluation.
+      this->evaluateBullseyeMetric(keypoint, edgeImage,
+                                   gradientX, gradientY,
+                                   minRadius, maxRadius);
+      return true;
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorBullseye<FloatType>::
+    evaluateTileCandidates(
+      std::vector<std::size_t> const& candidateIndices,
+      std::vector<brick::numeric::Index2D> const& candidatePoints,
+      Image<GRAY8> const& inImage,
+      Image<GRAY1> const& edgeImage,
+      brick::numeric::Array2D<FloatType> const& gradientX,
+      brick::numeric::Array2D<FloatType> const& gradientY,
+      FloatType asymmetryThreshold,
+      std::vector< KeypointBullseye<brick::common::Int32, FloatType> >&
+        keypoints,
+      std::vector<char>& isFound) const
+    {
+      std::vector<std::size_t> foundIndices;
+      std::vector<FloatType> scores;
+      for(std::size_t ii = 0; ii < candidateIndices.size(); ++ii) {
+        std::size_t candidateIndex = candidateIndices[ii];
+        if(this->evaluateCandidate(
+             candidatePoints[candidateIndex], inImage, edgeImage,
+             gradientX, gradientY, asymmetryThreshold,
+             keypoints[candidateIndex])
+           && keypoints[candidateIndex].bullseyeMetric >= 0.0) {
+          foundIndices.push_back(candidateIndex);
+          scores.push_back(keypoints[candidateIndex].bullseyeMetric);
+        }
+      }
+
+      if(m_maximumKeypointsPerTile != 0) {
+        std::vector<std::size_t> tileIndices(foundIndices.size(), 0);
+        selectBestKeypointsPerTile(foundIndices, scores, tileIndices,
+                                   m_maximumKeypointsPerTile);
+      }
+      for(std::size_t ii = 0; ii < foundIndices.size(); ++ii) {
+        isFound[foundIndices[ii]] = 1;
+      }
+    }
+
+
     template <class FloatType>
     std::vector<brick::numeric::Index2D>
     KeypointSelectorBullseye<FloatType>::
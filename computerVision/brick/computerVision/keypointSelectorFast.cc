@@ -11,16 +11,289 @@
 ***************************************************************************
 */
 
+#include <algorithm>
+#include <cstddef>
+#include <brick/common/exception.hh>
 #include <brick/computerVision/keypointSelectorFast.hh>
+#include <brick/numeric/simdKernels.hh>
+
+// Blocks of pixels are tested using SSE2 or AVX2 only when building
+// with GCC or Clang for x86, which let us compile the AVX2 code
+// without requiring AVX2 for the rest of the library.
+#if (defined(__x86_64__) || defined(__i386__)) \
+  && defined(__GNUC__) && defined(__SSE2__)
+#define BRICK_COMPUTERVISION_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BRICK_COMPUTERVISION_SIMD_X86 0
+#endif
+
+namespace {
+
+  // Row and column offsets of the 16 pixels of the Bresenham circle
+  // of radius 3, starting at the top and proceeding clockwise.  This
+  // is the order used for KeypointFast::featureVector.
+  const int circleRowOffsets[16] = {-3, -3, -2, -1,  0,  1,  2,  3,
+                                     3,  3,  2,  1,  0, -1, -2, -3};
+  const int circleColumnOffsets[16] = {0,  1,  2,  3,  3,  3,  2,  1,
+                                       0, -1, -2, -3, -3, -3, -2, -1};
+
+#if BRICK_COMPUTERVISION_SIMD_X86
+
+  // Each of the functions below tests a block of adjacent pixels,
+  // starting at centerPtr.  Bit ii of positiveMask is set if pixel ii
+  // is brighter than 12 contiguous neighbors (as in
+  // KeypointSelectorFast::testPixel(), the run may not wrap past the
+  // end of the circle) by more than threshold, and bit ii of
+  // negativeMask is set if it's dimmer.  Per-lane "fail" masks are
+  // used throughout, since saturating subtraction leaves zero exactly
+  // where a comparison fails.
+
+  inline __m128i
+  getArcPassSSE2(__m128i const* fails)
+  {
+    // Fail masks for runs of 2, 4, and 8 neighbors, and then for
+    // each of the five possible runs of 12.
+    __m128i pairs[15];
+    __m128i quads[13];
+    __m128i octets[5];
+    for(unsigned int kk = 0; kk < 15; ++kk) {
+      pairs[kk] = _mm_or_si128(fails[kk], fails[kk + 1]);
+    }
+    for(unsigned int kk = 0; kk < 13; ++kk) {
+      quads[kk] = _mm_or_si128(pairs[kk], pairs[kk + 2]);
+    }
+    for(unsigned int kk = 0; kk < 5; ++kk) {
+      octets[kk] = _mm_or_si128(quads[kk], quads[kk + 4]);
+    }
+    __m128i arcFails = _mm_or_si128(octets[0], quads[8]);
+    for(unsigned int kk = 1; kk < 5; ++kk) {
+      arcFails = _mm_and_si128(
+        arcFails, _mm_or_si128(octets[kk], quads[kk + 8]));
+    }
+    return _mm_cmpeq_epi8(arcFails, _mm_setzero_si128());
+  }
+
+
+  void
+  testPixelsSSE2(brick::common::UInt8 const* centerPtr,
+                 std::ptrdiff_t const* offsets,
+                 brick::common::UInt8 threshold,
+                 unsigned int& positiveMask,
+                 unsigned int& negativeMask)
+  {
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const thresholds = _mm_set1_epi8(static_cast<char>(threshold));
+    __m128i const center = _mm_loadu_si128(
+      reinterpret_cast<__m128i const*>(centerPtr));
+
+    // The high-speed pretest: at least three of the four compass
+    // points must pass.  Each fail mask is -1 in lanes that fail, so
+    // the sum is greater than -2 where at most one of them does.
+    __m128i positiveFails[16];
+    __m128i negativeFails[16];
+    for(unsigned int kk = 0; kk < 16; kk += 4) {
+      __m128i neighbors = _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(centerPtr + offsets[kk]));
+      positiveFails[kk] = _mm_cmpeq_epi8(
+        _mm_subs_epu8(_mm_subs_epu8(center, neighbors), thresholds), zero);
+      negativeFails[kk] = _mm_cmpeq_epi8(
+        _mm_subs_epu8(_mm_subs_epu8(neighbors, center), thresholds), zero);
+    }
+    __m128i const minusTwo = _mm_set1_epi8(-2);
+    __m128i positivePretest = _mm_cmpgt_epi8(
+      _mm_add_epi8(_mm_add_epi8(positiveFails[0], positiveFails[4]),
+                   _mm_add_epi8(positiveFails[8], positiveFails[12])),
+      minusTwo);
+    __m128i negativePretest = _mm_cmpgt_epi8(
+      _mm_add_epi8(_mm_add_epi8(negativeFails[0], negativeFails[4]),
+                   _mm_add_epi8(negativeFails[8], negativeFails[12])),
+      minusTwo);
+    if(_mm_movemask_epi8(_mm_or_si128(positivePretest, negativePretest))
+       == 0) {
+      positiveMask = 0;
+      negativeMask = 0;
+      return;
+    }
+
+    // Some pixels survived, so test the rest of the circle.
+    for(unsigned int kk = 0; kk < 16; ++kk) {
+      if(kk % 4 == 0) {
+        continue;
+      }
+      __m128i neighbors = _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(centerPtr + offsets[kk]));
+      positiveFails[kk] = _mm_cmpeq_epi8(
+        _mm_subs_epu8(_mm_subs_epu8(center, neighbors), thresholds), zero);
+      negativeFails[kk] = _mm_cmpeq_epi8(
+        _mm_subs_epu8(_mm_subs_epu8(neighbors, center), thresholds), zero);
+    }
+
+    // As in testPixel(), the negative test is only tried if the
+    // positive pretest fails.
+    __m128i positivePass = _mm_and_si128(
+      positivePretest, getArcPassSSE2(positiveFails));
+    __m128i negativePass = _mm_andnot_si128(
+      positivePretest,
+      _mm_and_si128(negativePretest, getArcPassSSE2(negativeFails)));
+    positiveMask = static_cast<unsigned int>(
+      _mm_movemask_epi8(positivePass));
+    negativeMask = static_cast<unsigned int>(
+      _mm_movemask_epi8(negativePass));
+  }
+
+
+  __attribute__((target("avx2"))) inline __m256i
+  getArcPassAVX2(__m256i const* fails)
+  {
+    __m256i pairs[15];
+    __m256i quads[13];
+    __m256i octets[5];
+    for(unsigned int kk = 0; kk < 15; ++kk) {
+      pairs[kk] = _mm256_or_si256(fails[kk], fails[kk + 1]);
+    }
+    for(unsigned int kk = 0; kk < 13; ++kk) {
+      quads[kk] = _mm256_or_si256(pairs[kk], pairs[kk + 2]);
+    }
+    for(unsigned int kk = 0; kk < 5; ++kk) {
+      octets[kk] = _mm256_or_si256(quads[kk], quads[kk + 4]);
+    }
+    __m256i arcFails = _mm256_or_si256(octets[0], quads[8]);
+    for(unsigned int kk = 1; kk < 5; ++kk) {
+      arcFails = _mm256_and_si256(
+        arcFails, _mm256_or_si256(octets[kk], quads[kk + 8]));
+    }
+    return _mm256_cmpeq_epi8(arcFails, _mm256_setzero_si256());
+  }
+
+
+  __attribute__((target("avx2"))) void
+  testPixelsAVX2(brick::common::UInt8 const* centerPtr,
+                 std::ptrdiff_t const* offsets,
+                 brick::common::UInt8 threshold,
+                 unsigned int& positiveMask,
+                 unsigned int& negativeMask)
+  {
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const thresholds = _mm256_set1_epi8(
+      static_cast<char>(threshold));
+    __m256i const center = _mm256_loadu_si256(
+      reinterpret_cast<__m256i const*>(centerPtr));
+
+    __m256i positiveFails[16];
+    __m256i negativeFails[16];
+    for(unsigned int kk = 0; kk < 16; kk += 4) {
+      __m256i neighbors = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(centerPtr + offsets[kk]));
+      positiveFails[kk] = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(_mm256_subs_epu8(center, neighbors), thresholds),
+        zero);
+      negativeFails[kk] = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(_mm256_subs_epu8(neighbors, center), thresholds),
+        zero);
+    }
+    __m256i const minusTwo = _mm256_set1_epi8(-2);
+    __m256i positivePretest = _mm256_cmpgt_epi8(
+      _mm256_add_epi8(_mm256_add_epi8(positiveFails[0], positiveFails[4]),
+                      _mm256_add_epi8(positiveFails[8], positiveFails[12])),
+      minusTwo);
+    __m256i negativePretest = _mm256_cmpgt_epi8(
+      _mm256_add_epi8(_mm256_add_epi8(negativeFails[0], negativeFails[4]),
+                      _mm256_add_epi8(negativeFails[8], negativeFails[12])),
+      minusTwo);
+    if(_mm256_movemask_epi8(
+         _mm256_or_si256(positivePretest, negativePretest)) == 0) {
+      positiveMask = 0;
+      negativeMask = 0;
+      return;
+    }
+
+    for(unsigned int kk = 0; kk < 16; ++kk) {
+      if(kk % 4 == 0) {
+        continue;
+      }
+      __m256i neighbors = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(centerPtr + offsets[kk]));
+      positiveFails[kk] = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(_mm256_subs_epu8(center, neighbors), thresholds),
+        zero);
+      negativeFails[kk] = _mm256_cmpeq_epi8(
+        _mm256_subs_epu8(_mm256_subs_epu8(neighbors, center), thresholds),
+        zero);
+    }
+
+    __m256i positivePass = _mm256_and_si256(
+      positivePretest, getArcPassAVX2(positiveFails));
+    __m256i negativePass = _mm256_andnot_si256(
+      positivePretest,
+      _mm256_and_si256(negativePretest, getArcPassAVX2(negativeFails)));
+    positiveMask = static_cast<unsigned int>(
+      _mm256_movemask_epi8(positivePass));
+    negativeMask = static_cast<unsigned int>(
+      _mm256_movemask_epi8(negativePass));
+  }
+
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+
+  // Orders keypoints by row, then by column.
+  struct KeypointFastRasterLess {
+    bool
+    operator()(brick::computerVision::KeypointFast const& keypoint0,
+               brick::computerVision::KeypointFast const& keypoint1) const {
+      return ((keypoint0.row < keypoint1.row)
+              || ((keypoint0.row == keypoint1.row)
+                  && (keypoint0.column < keypoint1.column)));
+    }
+  };
+
+} // namespace
+
 
 namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Runs KeypointSelectorFast::detectTileKeypoints() on each
+      // tile, writing the results to per-tile storage.
+      class KeypointSelectorFastTileFunctor {
+      public:
+        KeypointSelectorFastTileFunctor(
+          KeypointSelectorFast const& selector,
+          Image<GRAY8> const& image,
+          KeypointTiling const& tiling,
+          std::vector< std::vector<KeypointFast> >& tileKeypoints)
+          : m_selector(selector), m_image(image), m_tiling(tiling),
+            m_tileKeypoints(tileKeypoints) {}
+
+        void
+        operator()(std::size_t tileIndex) const {
+          m_selector.detectTileKeypoints(
+            m_image, m_tiling, tileIndex, m_tileKeypoints[tileIndex]);
+        }
+
+      private:
+        KeypointSelectorFast const& m_selector;
+        Image<GRAY8> const& m_image;
+        KeypointTiling const& m_tiling;
+        std::vector< std::vector<KeypointFast> >& m_tileKeypoints;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
     KeypointSelectorFast::
     KeypointSelectorFast()
-      : m_keypointVector(),
-        m_threshold(0)
+      : m_keypointBudget(),
+        m_keypointVector(),
+        m_maximumKeypointsPerTile(0),
+        m_threadPoolPtr(0),
+        m_threshold(0),
+        m_tileColumns(0),
+        m_tileRows(0)
     {
       // Empty.
     }
@@ -124,19 +397,36 @@ namespace brick {
                                 stopRow, stopColumn);
       }
 
-      // Test every pixel!
-      KeypointFast keypoint;
-      for(unsigned int row = startRow; row < stopRow; ++row) {
-        for(unsigned int column = startColumn; column < stopColumn;
-            ++column) {
-          if(this->testPixel(inImage, row, column, m_threshold, keypoint)) {
-            m_keypointVector.push_back(keypoint);
-          }
+      if(m_tileRows == 0 && m_threadPoolPtr == 0) {
+        // Test every pixel!
+        this->detectKeypoints(inImage, startRow, startColumn,
+                              stopRow, stopColumn, m_threshold,
+                              m_keypointVector);
+      } else {
+        this->detectKeypointsTiled(inImage, startRow, startColumn,
+                                   stopRow, stopColumn);
+      }
+
+      if(m_keypointBudget.isLimited()
+         && m_keypointVector.size() > m_keypointBudget.getNumberOfKeypoints()) {
+        std::vector<common::Int16> scores(m_keypointVector.size());
+        for(std::size_t ii = 0; ii < m_keypointVector.size(); ++ii) {
+          scores[ii] = this->measurePixelThreshold(
+            inImage, m_keypointVector[ii].row, m_keypointVector[ii].column);
         }
+        m_keypointBudget.apply(m_keypointVector, scores);
       }
     }
 
 
+    void
+    KeypointSelectorFast::
+    setKeypointBudget(KeypointBudget const& budget)
+    {
+      m_keypointBudget = budget;
+    }
+
+
     void
     KeypointSelectorFast::
     setThreshold(brick::common::Int16 threshold)
@@ -145,6 +435,31 @@ namespace brick {
     }
 
 
+    void
+    KeypointSelectorFast::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr)
+    {
+      m_threadPoolPtr = threadPoolPtr;
+    }
+
+
+    void
+    KeypointSelectorFast::
+    setTiling(unsigned int tileRows, unsigned int tileColumns,
+              unsigned int maximumKeypointsPerTile)
+    {
+      if((tileRows == 0) != (tileColumns == 0)) {
+        BRICK_THROW(brick::common::ValueException,
+                    "KeypointSelectorFast::setTiling()",
+                    "Arguments tileRows and tileColumns must either both "
+                    "be zero, or both be greater than zero.");
+      }
+      m_tileRows = tileRows;
+      m_tileColumns = tileColumns;
+      m_maximumKeypointsPerTile = maximumKeypointsPerTile;
+    }
+
+
     void
     KeypointSelectorFast::
     checkAndRepairRegionOfInterest(Image<GRAY8> const& inImage,
@@ -181,6 +496,138 @@ namespace brick {
     }
 
 
+    void
+    KeypointSelectorFast::
+    detectKeypoints(Image<GRAY8> const& image,
+                    unsigned int startRow, unsigned int startColumn,
+                    unsigned int stopRow, unsigned int stopColumn,
+                    common::Int16 threshold,
+                    std::vector<KeypointFast>& keypoints) const
+    {
+#if BRICK_COMPUTERVISION_SIMD_X86
+      // The vectorized tests rely on saturating arithmetic, which
+      // only works for non-negative thresholds.
+      unsigned int blockWidth = 0;
+      numeric::SimdLevel simdLevel = numeric::getSimdLevel();
+      if(threshold >= 0 && simdLevel != numeric::BRICK_SIMD_NONE) {
+        blockWidth = (simdLevel == numeric::BRICK_SIMD_AVX2) ? 32 : 16;
+      }
+      common::UInt8 threshold8 = static_cast<common::UInt8>(
+        std::max(common::Int16(0), std::min(threshold, common::Int16(255))));
+      std::ptrdiff_t offsets[16];
+      for(unsigned int kk = 0; kk < 16; ++kk) {
+        offsets[kk] = (static_cast<std::ptrdiff_t>(circleRowOffsets[kk])
+                       * static_cast<std::ptrdiff_t>(image.getRowStep())
+                       + circleColumnOffsets[kk]);
+      }
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+
+      KeypointFast keypoint;
+      for(unsigned int row = startRow; row < stopRow; ++row) {
+        unsigned int column = startColumn;
+
+#if BRICK_COMPUTERVISION_SIMD_X86
+        for(; blockWidth != 0 && column + blockWidth <= stopColumn;
+            column += blockWidth) {
+          unsigned int positiveMask;
+          unsigned int negativeMask;
+          if(blockWidth == 32) {
+            testPixelsAVX2(&(image(row, column)), offsets, threshold8,
+                           positiveMask, negativeMask);
+          } else {
+            testPixelsSSE2(&(image(row, column)), offsets, threshold8,
+                           positiveMask, negativeMask);
+          }
+
+          // Fill in the keypoints that passed, in column order.
+          unsigned int passMask = positiveMask | negativeMask;
+          while(passMask != 0) {
+            unsigned int ii = __builtin_ctz(passMask);
+            passMask &= passMask - 1;
+            if(this->testPixelDetails(
+                 image, row, column + ii, image(row, column + ii),
+                 threshold, keypoint, ((positiveMask >> ii) & 1) != 0)) {
+              keypoints.push_back(keypoint);
+            }
+          }
+        }
+#endif /* #if BRICK_COMPUTERVISION_SIMD_X86 */
+
+        for(; column < stopColumn; ++column) {
+          if(this->testPixel(image, row, column, threshold, keypoint)) {
+            keypoints.push_back(keypoint);
+          }
+        }
+      }
+    }
+
+
+    void
+    KeypointSelectorFast::
+    detectKeypointsTiled(Image<GRAY8> const& inImage,
+                         unsigned int startRow, unsigned int startColumn,
+                         unsigned int stopRow, unsigned int stopColumn)
+    {
+      // Test every pixel, one tile at a time.
+      KeypointTiling tiling(
+        startRow, startColumn, stopRow, stopColumn,
+        (m_tileRows != 0) ? m_tileRows : keypointDefaultTileSize,
+        (m_tileColumns != 0) ? m_tileColumns : keypointDefaultTileSize);
+      std::vector< std::vector<KeypointFast> > tileKeypoints(
+        tiling.getNumberOfTiles());
+      privateCode::KeypointSelectorFastTileFunctor functor(
+        *this, inImage, tiling, tileKeypoints);
+      if(m_threadPoolPtr != 0) {
+        m_threadPoolPtr->parallelFor(tileKeypoints.size(), functor);
+      } else {
+        for(std::size_t tileIndex = 0; tileIndex < tileKeypoints.size();
+            ++tileIndex) {
+          functor(tileIndex);
+        }
+      }
+
+      // Merge the tiles, restoring the raster order of the untiled
+      // code.
+      for(std::size_t tileIndex = 0; tileIndex < tileKeypoints.size();
+          ++tileIndex) {
+        m_keypointVector.insert(m_keypointVector.end(),
+                                tileKeypoints[tileIndex].begin(),
+                                tileKeypoints[tileIndex].end());
+      }
+      std::sort(m_keypointVector.begin(), m_keypointVector.end(),
+                KeypointFastRasterLess());
+    }
+
+
+    void
+    KeypointSelectorFast::
+    detectTileKeypoints(Image<GRAY8> const& image,
+                        KeypointTiling const& tiling,
+                        std::size_t tileIndex,
+                        std::vector<KeypointFast>& keypoints) const
+    {
+      unsigned int startRow;
+      unsigned int startColumn;
+      unsigned int stopRow;
+      unsigned int stopColumn;
+      tiling.getTile(tileIndex, startRow, startColumn, stopRow, stopColumn);
+      this->detectKeypoints(image, startRow, startColumn, stopRow, stopColumn,
+                            m_threshold, keypoints);
+
+      if(m_maximumKeypointsPerTile != 0
+         && keypoints.size() > m_maximumKeypointsPerTile) {
+        std::vector<common::Int16> scores(keypoints.size());
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          scores[ii] = this->measurePixelThreshold(
+            image, keypoints[ii].row, keypoints[ii].column);
+        }
+        std::vector<std::size_t> tileIndices(keypoints.size(), tileIndex);
+        selectBestKeypointsPerTile(keypoints, scores, tileIndices,
+                                   m_maximumKeypointsPerTile);
+      }
+    }
+
+
     common::Int16
     KeypointSelectorFast::
     measurePixelThreshold(Image<GRAY8> const& image,
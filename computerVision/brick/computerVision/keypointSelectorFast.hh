@@ -16,7 +16,10 @@
 
 #include <limits>
 #include <vector>
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/image.hh>
+#include <brick/computerVision/keypointBudget.hh>
+#include <brick/computerVision/keypointTiling.hh>
 #include <brick/numeric/index2D.hh>
 
 namespace brick {
@@ -33,6 +36,15 @@ namespace brick {
     };
 
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      class KeypointSelectorFastTileFunctor;
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** This class template selects keypoints from an input image
      ** using Rosten's FAST keypoint detector [1,2].  Unlike other
@@ -46,6 +58,24 @@ namespace brick {
      ** [2] E. Rosten and T. Drummond, "Machine learning for
      ** high-speed corner detection", European Conference on Computer
      ** Vision, Vol 1, pp 430-443, 2006.
+     **
+     ** Where SSE2 or AVX2 are available (see
+     ** brick::numeric::getSimdLevel()), setImage() tests 16 or 32
+     ** adjacent pixels at once, and falls back to the per-pixel test
+     ** only for pixels that pass.  The results are identical to those
+     ** of the scalar code.
+     **
+     ** If member function setTiling() or setThreadPool() has been
+     ** called, setImage() divides the region of interest into tiles
+     ** and processes them independently, possibly in parallel.  The
+     ** merged keypoints are sorted into raster order, so that
+     ** (absent a per-tile keypoint budget) they are identical to
+     ** those of the untiled code.
+     **
+     ** If member function setKeypointBudget() has been called,
+     ** setImage() reduces the detected keypoints to a fixed-size,
+     ** spatially uniform set, preferring those with the highest
+     ** contrast.
      **/
     class KeypointSelectorFast {
     public:
@@ -161,8 +191,63 @@ namespace brick {
       setThreshold(brick::common::Int16 threshold);
 
 
+      /**
+       * This member function limits the number of keypoints reported
+       * by subsequent calls to setImage().  When more keypoints are
+       * detected than the budget allows, the budget chooses among
+       * them based on their contrast (see estimateThreshold()).  Any
+       * per-tile limit set using setTiling() is applied first.
+       *
+       * @param budget This argument specifies how many keypoints to
+       * keep, and how to choose them.  Pass a default-constructed
+       * KeypointBudget to disable the limit.
+       */
+      void
+      setKeypointBudget(KeypointBudget const& budget);
+
+
+      /**
+       * This member function makes subsequent calls to setImage()
+       * process tiles using the threads of the specified ThreadPool.
+       * If no tile size has been specified using setTiling(), tiles
+       * of keypointDefaultTileSize rows and columns are used.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use, which must outlive *this or be replaced by a
+       * subsequent call to setThreadPool().  Pass 0 to process the
+       * image in the calling thread.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr);
+
+
+      /**
+       * This member function makes subsequent calls to setImage()
+       * divide the region of interest into tiles, and optionally
+       * limits the number of keypoints reported from each tile.
+       * When a tile has more keypoints than the limit, the ones with
+       * the highest contrast (see estimateThreshold()) are kept.
+       *
+       * @param tileRows This argument specifies the height of each
+       * tile.  Setting both tileRows and tileColumns to zero
+       * disables tiling, unless a ThreadPool has been set.
+       *
+       * @param tileColumns This argument specifies the width of each
+       * tile.
+       *
+       * @param maximumKeypointsPerTile This argument specifies the
+       * largest number of keypoints to report from any one tile.
+       * Setting it to zero disables the limit.
+       */
+      void
+      setTiling(unsigned int tileRows, unsigned int tileColumns,
+                unsigned int maximumKeypointsPerTile = 0);
+
+
     private:
 
+      friend class privateCode::KeypointSelectorFastTileFunctor;
+
       // Make sure bounding box of processing region is sane.
       void
       checkAndRepairRegionOfInterest(Image<GRAY8> const& inImage,
@@ -172,6 +257,22 @@ namespace brick {
                                      unsigned int& stopRow,
                                      unsigned int& stopColumn) const;
 
+      // Test every pixel in the specified region, appending the
+      // keypoints that pass to keypoints, in raster order.
+      void
+      detectKeypoints(Image<GRAY8> const& image,
+                      unsigned int startRow, unsigned int startColumn,
+                      unsigned int stopRow, unsigned int stopColumn,
+                      brick::common::Int16 threshold,
+                      std::vector<KeypointFast>& keypoints) const;
+
+      // Tiled, possibly multithreaded, version of detectKeypoints()
+      // that appends its results to m_keypointVector.
+      void
+      detectKeypointsTiled(Image<GRAY8> const& inImage,
+                           unsigned int startRow, unsigned int startColumn,
+                           unsigned int stopRow, unsigned int stopColumn);
+
       // Find the highest threshold value that would still allow this
       // particular pixel to pass and be selected as a keypoint.
       brick::common::Int16
@@ -196,9 +297,21 @@ namespace brick {
                        KeypointFast& keypoint,
                        bool isPositive) const;
 
+      // Detect keypoints in one tile, and apply the per-tile budget.
+      void
+      detectTileKeypoints(Image<GRAY8> const& image,
+                          KeypointTiling const& tiling,
+                          std::size_t tileIndex,
+                          std::vector<KeypointFast>& keypoints) const;
+
       /* ======== Data members ========= */
+      KeypointBudget m_keypointBudget;
       std::vector<KeypointFast> m_keypointVector;
+      unsigned int m_maximumKeypointsPerTile;
+      brick::common::ThreadPool* m_threadPoolPtr;
       brick::common::Int16 m_threshold;
+      unsigned int m_tileColumns;
+      unsigned int m_tileRows;
     };
 
   } // namespace computerVision
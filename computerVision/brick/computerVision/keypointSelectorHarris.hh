@@ -16,7 +16,10 @@
 
 #include <limits>
 #include <vector>
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/image.hh>
+#include <brick/computerVision/keypointBudget.hh>
+#include <brick/computerVision/keypointTiling.hh>
 #include <brick/numeric/index2D.hh>
 
 namespace brick {
@@ -55,6 +58,19 @@ namespace brick {
     };
 
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      template <class FloatType>
+      class KeypointSelectorHarrisGradientFunctor;
+
+      template <class FloatType>
+      class KeypointSelectorHarrisIndicatorFunctor;
+
+    } // namespace privateCode
+    /// @endcond
+
+
     /**
      ** This class template selects keypoints from an input image
      ** using Harris's and Stephen's keypoint detector [1].  Unlike other
@@ -64,6 +80,18 @@ namespace brick {
      ** [1] C. Harris and M. Stephens, "A combined corner and edge
      ** detector", Proceedings of the 4th Alvey Vision Conference,
      ** pp. 147–151, 1988.
+     **
+     ** If member function setTiling() or setThreadPool() has been
+     ** called, setImage() divides the image into tiles and processes
+     ** them independently, possibly in parallel.  Each tile is
+     ** filtered along with a margin of neighboring pixels wide
+     ** enough that the resulting Harris indicators are identical to
+     ** those of the untiled code.
+     **
+     ** If member function setKeypointBudget() has been called,
+     ** getKeypoints() and getKeypointsGeneralPosition() reduce their
+     ** output to a fixed-size, spatially uniform set, preferring
+     ** keypoints with large Harris indicator values.
      **/
     template <class FloatType>
     class KeypointSelectorHarris {
@@ -146,10 +174,122 @@ namespace brick {
       setImage(Image<GRAY8> const& inImage);
 
 
+      /**
+       * This member function limits the number of keypoints reported
+       * by getKeypoints() and getKeypointsGeneralPosition().  When
+       * more keypoints are detected than the budget allows, the
+       * budget chooses among them based on their Harris indicator
+       * values.  Any per-tile limit set using setTiling() is applied
+       * first.
+       *
+       * @param budget This argument specifies how many keypoints to
+       * keep, and how to choose them.  Pass a default-constructed
+       * KeypointBudget to disable the limit.
+       */
+      void
+      setKeypointBudget(KeypointBudget const& budget);
+
+
+      /**
+       * This member function makes subsequent calls to setImage()
+       * process tiles using the threads of the specified ThreadPool.
+       * If no tile size has been specified using setTiling(), tiles
+       * of keypointDefaultTileSize rows and columns are used.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use, which must outlive *this or be replaced by a
+       * subsequent call to setThreadPool().  Pass 0 to process the
+       * image in the calling thread.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr);
+
+
+      /**
+       * This member function makes subsequent calls to setImage()
+       * divide the image into tiles, and optionally limits the
+       * number of keypoints that getKeypoints() and
+       * getKeypointsGeneralPosition() report from each tile.  When a
+       * tile has more keypoints than the limit, the ones with the
+       * largest Harris indicator values are kept.
+       *
+       * @param tileRows This argument specifies the height of each
+       * tile.  Setting both tileRows and tileColumns to zero
+       * disables tiling, unless a ThreadPool has been set.
+       *
+       * @param tileColumns This argument specifies the width of each
+       * tile.
+       *
+       * @param maximumKeypointsPerTile This argument specifies the
+       * largest number of keypoints to report from any one tile.
+       * Setting it to zero disables the limit.
+       */
+      void
+      setTiling(unsigned int tileRows, unsigned int tileColumns,
+                unsigned int maximumKeypointsPerTile = 0);
+
+
     private:
 
       typedef brick::common::Int32 AccumulatedType;
 
+      friend class privateCode::KeypointSelectorHarrisGradientFunctor<FloatType>;
+      friend class privateCode::KeypointSelectorHarrisIndicatorFunctor<FloatType>;
+
+
+      // Blur the image, and compute the integrated products of
+      // gradients.  Sets corner0 and corner1 to the region over which
+      // the result is valid.
+      void
+      computeIntegratedGradients(
+        Image<GRAY8> const& inImage,
+        brick::numeric::Array2D<AccumulatedType>& gradientXX,
+        brick::numeric::Array2D<AccumulatedType>& gradientXY,
+        brick::numeric::Array2D<AccumulatedType>& gradientYY,
+        brick::numeric::Index2D& corner0,
+        brick::numeric::Index2D& corner1);
+
+
+      // Compute integrated products of gradients within one tile of
+      // the search region, and return the largest of them.
+      void
+      computeTileGradients(Image<GRAY8> const& inImage,
+                           std::size_t tileIndex,
+                           AccumulatedType& maximumValue);
+
+
+      // Rescale integrated products of gradients within one tile of
+      // the search region, and compute Harris indicators there.
+      void
+      computeTileIndicators(std::size_t tileIndex, AccumulatedType divisor);
+
+
+      // Report every pixel in the search region (less a one pixel
+      // border) that is bigger than its neighbors, in reverse raster
+      // order.
+      template <class Iter>
+      void
+      findLocalMaxima(Iter iterator) const;
+
+
+      // Same as findLocalMaxima(), but with subpixel interpolation.
+      template <class Iter>
+      void
+      findLocalMaximaGeneralPosition(Iter iterator) const;
+
+
+      // Enforce the per-tile and overall keypoint budgets.
+      template <class CoordinateType>
+      void
+      selectBestKeypoints(
+        std::vector< KeypointHarris<CoordinateType> >& keypoints) const;
+
+
+      // Tiled version of setImage().
+      void
+      setImageTiled(Image<GRAY8> const& inImage);
+
+
 
       // Slight misnomer.  This actually computes products of
       // gradients within the region defined by corner0 and corner1.
@@ -195,6 +335,15 @@ namespace brick {
       // Parameters of the algorithm itself.
       FloatType m_kappa;
       FloatType m_sigma;
+
+      // Parameters controlling tiled and multithreaded operation,
+      // and the number of keypoints reported.
+      KeypointBudget m_keypointBudget;
+      unsigned int m_maximumKeypointsPerTile;
+      brick::common::ThreadPool* m_threadPoolPtr;
+      unsigned int m_tileColumns;
+      unsigned int m_tileRows;
+      KeypointTiling m_tiling;
     };
 
   } // namespace computerVision
@@ -19,6 +19,9 @@
 //
 // #include <brick/computerVision/keypointSelectorHarris.hh>
 
+#include <algorithm>
+#include <iterator>
+#include <brick/common/exception.hh>
 #include <brick/common/mathFunctions.hh>
 #include <brick/computerVision/imageFilter.hh>
 #include <brick/numeric/bilinearInterpolator.hh>
@@ -33,6 +36,61 @@ namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // The blur, gradient, and integration steps of
+      // KeypointSelectorHarris::setImage() invalidate this many
+      // pixels at each edge of the image.  Tiles are processed along
+      // with a margin of this width.
+      const unsigned int keypointSelectorHarrisMargin = 8;
+
+
+      // Runs the first pass of KeypointSelectorHarris::setImageTiled().
+      template <class FloatType>
+      class KeypointSelectorHarrisGradientFunctor {
+      public:
+        KeypointSelectorHarrisGradientFunctor(
+          KeypointSelectorHarris<FloatType>& selector,
+          Image<GRAY8> const& image,
+          std::vector<brick::common::Int32>& tileMaxima)
+          : m_selector(selector), m_image(image), m_tileMaxima(tileMaxima) {}
+
+        void
+        operator()(std::size_t tileIndex) const {
+          m_selector.computeTileGradients(
+            m_image, tileIndex, m_tileMaxima[tileIndex]);
+        }
+
+      private:
+        KeypointSelectorHarris<FloatType>& m_selector;
+        Image<GRAY8> const& m_image;
+        std::vector<brick::common::Int32>& m_tileMaxima;
+      };
+
+
+      // Runs the second pass of KeypointSelectorHarris::setImageTiled().
+      template <class FloatType>
+      class KeypointSelectorHarrisIndicatorFunctor {
+      public:
+        KeypointSelectorHarrisIndicatorFunctor(
+          KeypointSelectorHarris<FloatType>& selector,
+          brick::common::Int32 divisor)
+          : m_selector(selector), m_divisor(divisor) {}
+
+        void
+        operator()(std::size_t tileIndex) const {
+          m_selector.computeTileIndicators(tileIndex, m_divisor);
+        }
+
+      private:
+        KeypointSelectorHarris<FloatType>& m_selector;
+        brick::common::Int32 m_divisor;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
 
     template <class CoordinateType>
     template <class FloatType>
@@ -58,7 +116,13 @@ namespace brick {
         m_searchRegionCorner0(0, 0),
         m_searchRegionCorner1(0, 0),
         m_kappa(kappa),
-        m_sigma(sigma)
+        m_sigma(sigma),
+        m_keypointBudget(),
+        m_maximumKeypointsPerTile(0),
+        m_threadPoolPtr(0),
+        m_tileColumns(0),
+        m_tileRows(0),
+        m_tiling()
     {
       // Empty.
     }
@@ -87,41 +151,15 @@ namespace brick {
     KeypointSelectorHarris<FloatType>::
     getKeypoints(Iter iterator, FloatType /* threshold */) const
     {
-      // Get bounds on the region of valid pixels for this calculation.
-      unsigned int const startRow    = m_searchRegionCorner0.getRow();
-      unsigned int const stopRow     = m_searchRegionCorner1.getRow();
-      unsigned int const startColumn = m_searchRegionCorner0.getColumn();
-      unsigned int const stopColumn  = m_searchRegionCorner1.getColumn();
-
-      // Iterate over all pixels in the valid region.
-      unsigned int rowStep = m_harrisIndicators.getRowStep();
-      for(unsigned int row = stopRow - 1; row >= startRow; --row) {
-        brick::numeric::Array1D<AccumulatedType> xxRow =
-          m_gradientXX.getRow(row);
-        brick::numeric::Array1D<AccumulatedType> xyRow =
-          m_gradientXY.getRow(row);
-        brick::numeric::Array1D<AccumulatedType> yyRow =
-          m_gradientYY.getRow(row);
-        brick::numeric::Array1D<FloatType> harrisRow =
-          m_harrisIndicators.getRow(row);
-        for(unsigned int column = stopColumn - 1; column >= startColumn;
-            --column) {
-          FloatType* candidatePtr = &(harrisRow[column]);
-          if(// (*candidatePtr > threshold) &&
-            (*candidatePtr > *(candidatePtr + 1))
-             && (*candidatePtr > *(candidatePtr - 1))
-             && (*candidatePtr > *(candidatePtr + rowStep))
-             && (*candidatePtr > *(candidatePtr - rowStep))
-             && (*candidatePtr > *(candidatePtr + rowStep + 1))
-             && (*candidatePtr > *(candidatePtr - rowStep - 1))
-             && (*candidatePtr > *(candidatePtr + rowStep - 1))
-             && (*candidatePtr > *(candidatePtr - rowStep + 1))) {
-            *(iterator++) = KeypointHarris<brick::common::Int32>(
-              row, column, *candidatePtr,
-              xxRow[column], yyRow[column], xyRow[column]);
-          }
-        }
+      if((m_maximumKeypointsPerTile == 0 || m_tiling.getNumberOfTiles() == 0)
+         && !m_keypointBudget.isLimited()) {
+        this->findLocalMaxima(iterator);
+        return;
       }
+      std::vector< KeypointHarris<brick::common::Int32> > keypointVector;
+      this->findLocalMaxima(std::back_inserter(keypointVector));
+      this->selectBestKeypoints(keypointVector);
+      std::copy(keypointVector.begin(), keypointVector.end(), iterator);
     }
 
 
@@ -146,89 +184,122 @@ namespace brick {
     KeypointSelectorHarris<FloatType>::
     getKeypointsGeneralPosition(Iter iterator) const
     {
-      // Sanity check region to make sure shrinking the search region
-      // isn't going to break anything.
-      if(0 == m_searchRegionCorner1.getRow()
-         || 0 == m_searchRegionCorner1.getColumn()) {
+      if((m_maximumKeypointsPerTile == 0 || m_tiling.getNumberOfTiles() == 0)
+         && !m_keypointBudget.isLimited()) {
+        this->findLocalMaximaGeneralPosition(iterator);
         return;
       }
+      std::vector< KeypointHarris<FloatType> > keypointVector;
+      this->findLocalMaximaGeneralPosition(std::back_inserter(keypointVector));
+      this->selectBestKeypoints(keypointVector);
+      std::copy(keypointVector.begin(), keypointVector.end(), iterator);
+    }
 
-      // Get bounds on the region of valid pixels for this
-      // calculation.  Shrink search region by one pixel to allow
-      // non-max suppression.
-      unsigned int const startRow    = m_searchRegionCorner0.getRow() + 1;
-      unsigned int const stopRow     = m_searchRegionCorner1.getRow() - 1;
-      unsigned int const startColumn = m_searchRegionCorner0.getColumn() + 1;
-      unsigned int const stopColumn  = m_searchRegionCorner1.getColumn() - 1;
 
-      // These interpolators will make things easy on us later when
-      // trying to gather information about keypoints in non-integral
-      // positions.
-      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
-        xxInterpolator(m_gradientXX);
-      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
-        xyInterpolator(m_gradientXY);
-      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
-        yyInterpolator(m_gradientYY);
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    setImage(Image<GRAY8> const& inImage)
+    {
+      unsigned int const margin = privateCode::keypointSelectorHarrisMargin;
+      m_tiling = KeypointTiling();
+      if((m_tileRows != 0 || m_threadPoolPtr != 0)
+         && inImage.rows() > 2 * margin && inImage.columns() > 2 * margin) {
+        this->setImageTiled(inImage);
+        return;
+      }
 
-      // Iterate over all pixels in the valid region.
-      unsigned int rowStep = m_harrisIndicators.getRowStep();
-      for(unsigned int row = stopRow - 1; row >= startRow; --row) {
-        brick::numeric::Array1D<AccumulatedType> xxRow =
-          m_gradientXX.getRow(row);
-        brick::numeric::Array1D<AccumulatedType> xyRow =
-          m_gradientXY.getRow(row);
-        brick::numeric::Array1D<AccumulatedType> yyRow =
-          m_gradientYY.getRow(row);
-        brick::numeric::Array1D<FloatType> harrisRow =
-          m_harrisIndicators.getRow(row);
-        for(unsigned int column = stopColumn - 1; column >= startColumn;
-            --column) {
-          FloatType* candidatePtr = &(harrisRow[column]);
-          if((*candidatePtr > *(candidatePtr + 1))
-             && (*candidatePtr > *(candidatePtr - 1))
-             && (*candidatePtr > *(candidatePtr + rowStep))
-             && (*candidatePtr > *(candidatePtr - rowStep))
-             && (*candidatePtr > *(candidatePtr + rowStep + 1))
-             && (*candidatePtr > *(candidatePtr - rowStep - 1))
-             && (*candidatePtr > *(candidatePtr + rowStep - 1))
-             && (*candidatePtr > *(candidatePtr - rowStep + 1))) {
+      // Blur the image, compute products of gradients at each pixel,
+      // and integrate them over a small window.
+      this->computeIntegratedGradients(
+        inImage, m_gradientXX, m_gradientXY, m_gradientYY,
+        m_searchRegionCorner0, m_searchRegionCorner1);
 
-            FloatType rowCoordinate;
-            FloatType columnCoordinate;
-            FloatType extremeValue;
-            if(brick::numeric::subpixelInterpolate(
-                 FloatType(row), FloatType(column),
-                 *(candidatePtr - rowStep - 1), *(candidatePtr - rowStep),
-                 *(candidatePtr - rowStep + 1),
-                 *(candidatePtr - 1), *candidatePtr, *(candidatePtr + 1),
-                 *(candidatePtr + rowStep - 1), *(candidatePtr + rowStep),
-                 *(candidatePtr + rowStep + 1),
-                 rowCoordinate, columnCoordinate, extremeValue)) {
+      // Again we have to worry about overflow.  Rather than guessing,
+      // just search to find the max value, and rescale based on that.
+      // Ideally, this search would be done during the convolution
+      // above.
+      brick::common::Int32 maxVal =
+        brick::numeric::maximum(
+          m_gradientXX.getRegion(m_searchRegionCorner0,
+                                 m_searchRegionCorner1));
+      maxVal = std::max(
+        maxVal, brick::numeric::maximum(
+          m_gradientXY.getRegion(m_searchRegionCorner0,
+                                 m_searchRegionCorner1)));
+      maxVal = std::max(
+        maxVal, brick::numeric::maximum(
+          m_gradientYY.getRegion(m_searchRegionCorner0,
+                                 m_searchRegionCorner1)));
+      brick::common::Int32 divisor = maxVal / 65535 + 1;
 
-              // Sanity check interpolation result, as subpixelInterpolate()
-              // does not do so.
-              if(common::absoluteValue(rowCoordinate - row) < 1.0
-                 && common::absoluteValue(columnCoordinate - column) < 1.0) {
+      // Rescale each of the images.  The exact rescaling factor
+      // doesn't matter too much here, as all of the processing
+      // downstream from here is theoretically scale-independent.  The
+      // bigger divisor is, however, the more precision we lose, so we
+      // want divisor to be small.
+      m_gradientXX.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
+        /= divisor;
+      m_gradientXY.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
+        /= divisor;
+      m_gradientYY.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
+        /= divisor;
 
-                *(iterator++) = KeypointHarris<FloatType>(
-                  rowCoordinate, columnCoordinate, extremeValue,
-                  xxInterpolator(rowCoordinate, columnCoordinate),
-                  xyInterpolator(rowCoordinate, columnCoordinate),
-                  yyInterpolator(rowCoordinate, columnCoordinate));
+      // Compute the Harris indicator for each pixel in the region.
+      this->computeHarrisIndicators(
+        m_gradientXX, m_gradientXY, m_gradientYY, m_harrisIndicators,
+        m_searchRegionCorner0, m_searchRegionCorner1);
+    }
 
-              }
-            }
-          }
-        }
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    setKeypointBudget(KeypointBudget const& budget)
+    {
+      m_keypointBudget = budget;
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr)
+    {
+      m_threadPoolPtr = threadPoolPtr;
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    setTiling(unsigned int tileRows, unsigned int tileColumns,
+              unsigned int maximumKeypointsPerTile)
+    {
+      if((tileRows == 0) != (tileColumns == 0)) {
+        BRICK_THROW(brick::common::ValueException,
+                    "KeypointSelectorHarris::setTiling()",
+                    "Arguments tileRows and tileColumns must either both "
+                    "be zero, or both be greater than zero.");
       }
+      m_tileRows = tileRows;
+      m_tileColumns = tileColumns;
+      m_maximumKeypointsPerTile = maximumKeypointsPerTile;
     }
 
 
+    // ============== Private member functions below this line ==============
+
     template <class FloatType>
     void
     KeypointSelectorHarris<FloatType>::
-    setImage(Image<GRAY8> const& inImage)
+    computeIntegratedGradients(
+      Image<GRAY8> const& inImage,
+      brick::numeric::Array2D<AccumulatedType>& gradientXX,
+      brick::numeric::Array2D<AccumulatedType>& gradientXY,
+      brick::numeric::Array2D<AccumulatedType>& gradientYY,
+      brick::numeric::Index2D& corner0,
+      brick::numeric::Index2D& corner1)
     {
       // Start by blurring the image slightly.  This should be
       // optional in future implementations.  This call makes an
@@ -240,8 +311,8 @@ namespace brick {
       Kernel<brick::common::Int32> gaussian =
         getGaussianKernelBySize<brick::common::Int32>(
           size_t(5), size_t(5), -1.0, -1.0, true, 256, 256);
-      m_searchRegionCorner0.setValue(2, 2);
-      m_searchRegionCorner1.setValue(inImage.rows() - 2, inImage.columns() - 2);
+      corner0.setValue(2, 2);
+      corner1.setValue(inImage.rows() - 2, inImage.columns() - 2);
 
       // Here we do the convolution.  Fortunately, 2D Gaussians are
       // separable, so we can do the row and column convolutions
@@ -266,8 +337,7 @@ namespace brick {
       // window (where the gradient filter extends into no-mans-land)
       // so search region will be reduced slightly by this call.
       this->computeGradients(
-        blurredImage, m_gradientXX, m_gradientXY, m_gradientYY,
-        m_searchRegionCorner0, m_searchRegionCorner1);
+        blurredImage, gradientXX, gradientXY, gradientYY, corner0, corner1);
 
       // To get rotation independent Harris corners, the integration
       // for each pixel needs to be weighted with a circularly
@@ -286,24 +356,20 @@ namespace brick {
       // We need these proxies because otherwise g++ complains about
       // passing an rvalue to initialize non-const reference in the
       // filter*() calls.
-      proxyArray0 = workspace.getRegion(m_searchRegionCorner0,
-                                        m_searchRegionCorner1);
-      proxyArray1 = m_gradientXX.getRegion(m_searchRegionCorner0,
-                                           m_searchRegionCorner1),
+      proxyArray0 = workspace.getRegion(corner0, corner1);
+      proxyArray1 = gradientXX.getRegion(corner0, corner1),
       brick::numeric::filterRows(
         proxyArray0, proxyArray1, gaussian.getRowComponent());
       brick::numeric::filterColumns(
         proxyArray1, proxyArray0, gaussian.getColumnComponent());
 
-      proxyArray1 = m_gradientXY.getRegion(m_searchRegionCorner0,
-                                           m_searchRegionCorner1),
+      proxyArray1 = gradientXY.getRegion(corner0, corner1),
       brick::numeric::filterRows(
         proxyArray0, proxyArray1, gaussian.getRowComponent());
       brick::numeric::filterColumns(
         proxyArray1, proxyArray0, gaussian.getColumnComponent());
 
-      proxyArray1 = m_gradientYY.getRegion(m_searchRegionCorner0,
-                                           m_searchRegionCorner1),
+      proxyArray1 = gradientYY.getRegion(corner0, corner1),
       brick::numeric::filterRows(
         proxyArray0, proxyArray1, gaussian.getRowComponent());
       brick::numeric::filterColumns(
@@ -312,52 +378,13 @@ namespace brick {
       // The size of this filter affects the region of the image for
       // which the Harris corner metric will be valid, so we update
       // the search region here as well.
-      m_searchRegionCorner0.setValue(
-        m_searchRegionCorner0.getRow() + radius,
-        m_searchRegionCorner0.getColumn() + radius);
-      m_searchRegionCorner1.setValue(
-        m_searchRegionCorner1.getRow() - radius,
-        m_searchRegionCorner1.getColumn() - radius);
-
-      // Again we have to worry about overflow.  Rather than guessing,
-      // just search to find the max value, and rescale based on that.
-      // Ideally, this search would be done during the convolution
-      // above.
-      brick::common::Int32 maxVal =
-        brick::numeric::maximum(
-          m_gradientXX.getRegion(m_searchRegionCorner0,
-                                 m_searchRegionCorner1));
-      maxVal = std::max(
-        maxVal, brick::numeric::maximum(
-          m_gradientXY.getRegion(m_searchRegionCorner0,
-                                 m_searchRegionCorner1)));
-      maxVal = std::max(
-        maxVal, brick::numeric::maximum(
-          m_gradientYY.getRegion(m_searchRegionCorner0,
-                                 m_searchRegionCorner1)));
-      brick::common::Int32 divisor = maxVal / 65535 + 1;
-
-      // Rescale each of the images.  The exact rescaling factor
-      // doesn't matter too much here, as all of the processing
-      // downstream from here is theoretically scale-independent.  The
-      // bigger divisor is, however, the more precision we lose, so we
-      // want divisor to be small.
-      m_gradientXX.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
-        /= divisor;
-      m_gradientXY.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
-        /= divisor;
-      m_gradientYY.getRegion(m_searchRegionCorner0, m_searchRegionCorner1)
-        /= divisor;
-
-      // Compute the Harris indicator for each pixel in the region.
-      this->computeHarrisIndicators(
-        m_gradientXX, m_gradientXY, m_gradientYY, m_harrisIndicators,
-        m_searchRegionCorner0, m_searchRegionCorner1);
+      corner0.setValue(corner0.getRow() + radius,
+                       corner0.getColumn() + radius);
+      corner1.setValue(corner1.getRow() - radius,
+                       corner1.getColumn() - radius);
     }
 
 
-    // ============== Private member functions below this line ==============
-
     template <class FloatType>
     void
     KeypointSelectorHarris<FloatType>::
@@ -465,6 +492,11 @@ namespace brick {
       if((harrisIndicators.rows() != gradientXX.rows())
          || (harrisIndicators.columns() != gradientXX.columns())) {
         harrisIndicators.reinit(gradientXX.rows(), gradientXX.columns());
+
+        // Non-maximum suppression compares against the pixels just
+        // outside the region, which are never otherwise written.
+        // Make sure they never win.
+        harrisIndicators = std::numeric_limits<FloatType>::max();
       }
 
       // Iterate over all pixels in the valid region.
@@ -487,6 +519,314 @@ namespace brick {
       }
     }
 
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    computeTileGradients(Image<GRAY8> const& inImage,
+                         std::size_t tileIndex,
+                         AccumulatedType& maximumValue)
+    {
+      unsigned int const margin = privateCode::keypointSelectorHarrisMargin;
+      unsigned int startRow;
+      unsigned int startColumn;
+      unsigned int stopRow;
+      unsigned int stopColumn;
+      m_tiling.getTile(tileIndex, startRow, startColumn, stopRow, stopColumn);
+
+      // Process the tile, plus enough surrounding pixels that the
+      // result is valid over the whole tile.
+      Image<GRAY8> tileImage(stopRow - startRow + 2 * margin,
+                             stopColumn - startColumn + 2 * margin);
+      for(unsigned int row = 0; row < tileImage.rows(); ++row) {
+        for(unsigned int column = 0; column < tileImage.columns(); ++column) {
+          tileImage(row, column) = inImage(
+            startRow - margin + row, startColumn - margin + column);
+        }
+      }
+      brick::numeric::Array2D<AccumulatedType> gradientXX;
+      brick::numeric::Array2D<AccumulatedType> gradientXY;
+      brick::numeric::Array2D<AccumulatedType> gradientYY;
+      brick::numeric::Index2D corner0;
+      brick::numeric::Index2D corner1;
+      this->computeIntegratedGradients(
+        tileImage, gradientXX, gradientXY, gradientYY, corner0, corner1);
+
+      // Copy the valid part of the result into place.
+      maximumValue = std::numeric_limits<AccumulatedType>::min();
+      for(unsigned int row = startRow; row < stopRow; ++row) {
+        for(unsigned int column = startColumn; column < stopColumn;
+            ++column) {
+          unsigned int tileRow = row - startRow + margin;
+          unsigned int tileColumn = column - startColumn + margin;
+          m_gradientXX(row, column) = gradientXX(tileRow, tileColumn);
+          m_gradientXY(row, column) = gradientXY(tileRow, tileColumn);
+          m_gradientYY(row, column) = gradientYY(tileRow, tileColumn);
+          maximumValue = std::max(
+            maximumValue, std::max(gradientXX(tileRow, tileColumn),
+                                   std::max(gradientXY(tileRow, tileColumn),
+                                            gradientYY(tileRow, tileColumn))));
+        }
+      }
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    computeTileIndicators(std::size_t tileIndex, AccumulatedType divisor)
+    {
+      unsigned int startRow;
+      unsigned int startColumn;
+      unsigned int stopRow;
+      unsigned int stopColumn;
+      m_tiling.getTile(tileIndex, startRow, startColumn, stopRow, stopColumn);
+      for(unsigned int row = startRow; row < stopRow; ++row) {
+        for(unsigned int column = startColumn; column < stopColumn;
+            ++column) {
+          m_gradientXX(row, column) /= divisor;
+          m_gradientXY(row, column) /= divisor;
+          m_gradientYY(row, column) /= divisor;
+        }
+      }
+      this->computeHarrisIndicators(
+        m_gradientXX, m_gradientXY, m_gradientYY, m_harrisIndicators,
+        brick::numeric::Index2D(startRow, startColumn),
+        brick::numeric::Index2D(stopRow, stopColumn));
+    }
+
+
+    template <class FloatType>
+    template <class Iter>
+    void
+    KeypointSelectorHarris<FloatType>::
+    findLocalMaxima(Iter iterator) const
+    {
+      // Get bounds on the region of valid pixels for this calculation.
+      unsigned int const startRow    = m_searchRegionCorner0.getRow();
+      unsigned int const stopRow     = m_searchRegionCorner1.getRow();
+      unsigned int const startColumn = m_searchRegionCorner0.getColumn();
+      unsigned int const stopColumn  = m_searchRegionCorner1.getColumn();
+
+      // Iterate over all pixels in the valid region.
+      unsigned int rowStep = m_harrisIndicators.getRowStep();
+      for(unsigned int row = stopRow - 1; row >= startRow; --row) {
+        brick::numeric::Array1D<AccumulatedType> xxRow =
+          m_gradientXX.getRow(row);
+        brick::numeric::Array1D<AccumulatedType> xyRow =
+          m_gradientXY.getRow(row);
+        brick::numeric::Array1D<AccumulatedType> yyRow =
+          m_gradientYY.getRow(row);
+        brick::numeric::Array1D<FloatType> harrisRow =
+          m_harrisIndicators.getRow(row);
+        for(unsigned int column = stopColumn - 1; column >= startColumn;
+            --column) {
+          FloatType* candidatePtr = &(harrisRow[column]);
+          if(// (*candidatePtr > threshold) &&
+            (*candidatePtr > *(candidatePtr + 1))
+             && (*candidatePtr > *(candidatePtr - 1))
+             && (*candidatePtr > *(candidatePtr + rowStep))
+             && (*candidatePtr > *(candidatePtr - rowStep))
+             && (*candidatePtr > *(candidatePtr + rowStep + 1))
+             && (*candidatePtr > *(candidatePtr - rowStep - 1))
+             && (*candidatePtr > *(candidatePtr + rowStep - 1))
+             && (*candidatePtr > *(candidatePtr - rowStep + 1))) {
+            *(iterator++) = KeypointHarris<brick::common::Int32>(
+              row, column, *candidatePtr,
+              xxRow[column], yyRow[column], xyRow[column]);
+          }
+        }
+      }
+    }
+
+
+    template <class FloatType>
+    template <class Iter>
+    void
+    KeypointSelectorHarris<FloatType>::
+    findLocalMaximaGeneralPosition(Iter iterator) const
+    {
+      // Sanity check region to make sure shrinking the search region
+      // isn't going to break anything.
+      if(0 == m_searchRegionCorner1.getRow()
+         || 0 == m_searchRegionCorner1.getColumn()) {
+        return;
+      }
+
+      // Get bounds on the region of valid pixels for this
+      // calculation.  Shrink search region by one pixel to allow
+      // non-max suppression.
+      unsigned int const startRow    = m_searchRegionCorner0.getRow() + 1;
+      unsigned int const stopRow     = m_searchRegionCorner1.getRow() - 1;
+      unsigned int const startColumn = m_searchRegionCorner0.getColumn() + 1;
+      unsigned int const stopColumn  = m_searchRegionCorner1.getColumn() - 1;
+
+      // These interpolators will make things easy on us later when
+      // trying to gather information about keypoints in non-integral
+      // positions.
+      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
+        xxInterpolator(m_gradientXX);
+      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
+        xyInterpolator(m_gradientXY);
+      brick::numeric::BilinearInterpolator<AccumulatedType, FloatType>
+        yyInterpolator(m_gradientYY);
+
+      // Iterate over all pixels in the valid region.
+      unsigned int rowStep = m_harrisIndicators.getRowStep();
+      for(unsigned int row = stopRow - 1; row >= startRow; --row) {
+        brick::numeric::Array1D<AccumulatedType> xxRow =
+          m_gradientXX.getRow(row);
+        brick::numeric::Array1D<AccumulatedType> xyRow =
+          m_gradientXY.getRow(row);
+        brick::numeric::Array1D<AccumulatedType> yyRow =
+          m_gradientYY.getRow(row);
+        brick::numeric::Array1D<FloatType> harrisRow =
+          m_harrisIndicators.getRow(row);
+        for(unsigned int column = stopColumn - 1; column >= startColumn;
+            --column) {
+          FloatType* candidatePtr = &(harrisRow[column]);
+          if((*candidatePtr > *(candidatePtr + 1))
+             && (*candidatePtr > *(candidatePtr - 1))
+             && (*candidatePtr > *(candidatePtr + rowStep))
+             && (*candidatePtr > *(candidatePtr - rowStep))
+             && (*candidatePtr > *(candidatePtr + rowStep + 1))
+             && (*candidatePtr > *(candidatePtr - rowStep - 1))
+             && (*candidatePtr > *(candidatePtr + rowStep - 1))
+             && (*candidatePtr > *(candidatePtr - rowStep + 1))) {
+
+            FloatType rowCoordinate;
+            FloatType columnCoordinate;
+            FloatType extremeValue;
+            if(brick::numeric::subpixelInterpolate(
+                 FloatType(row), FloatType(column),
+                 *(candidatePtr - rowStep - 1), *(candidatePtr - rowStep),
+                 *(candidatePtr - rowStep + 1),
+                 *(candidatePtr - 1), *candidatePtr, *(candidatePtr + 1),
+                 *(candidatePtr + rowStep - 1), *(candidatePtr + rowStep),
+                 *(candidatePtr + rowStep + 1),
+                 rowCoordinate, columnCoordinate, extremeValue)) {
+
+              // Sanity check interpolation result, as subpixelInterpolate()
+              // does not do so.
+              if(common::absoluteValue(rowCoordinate - row) < 1.0
+                 && common::absoluteValue(columnCoordinate - column) < 1.0) {
+
+                *(iterator++) = KeypointHarris<FloatType>(
+                  rowCoordinate, columnCoordinate, extremeValue,
+                  xxInterpolator(rowCoordinate, columnCoordinate),
+                  xyInterpolator(rowCoordinate, columnCoordinate),
+                  yyInterpolator(rowCoordinate, columnCoordinate));
+
+              }
+            }
+          }
+        }
+      }
+    }
+
+
+    template <class FloatType>
+    template <class CoordinateType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    selectBestKeypoints(
+      std::vector< KeypointHarris<CoordinateType> >& keypoints) const
+    {
+      std::vector<CoordinateType> scores(keypoints.size());
+      for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+        scores[ii] = keypoints[ii].value;
+      }
+
+      if(m_maximumKeypointsPerTile != 0 && m_tiling.getNumberOfTiles() != 0) {
+        std::vector<std::size_t> tileIndices(keypoints.size());
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          tileIndices[ii] = m_tiling.getTileIndex(
+            static_cast<int>(keypoints[ii].row),
+            static_cast<int>(keypoints[ii].column));
+        }
+        selectBestKeypointsPerTile(keypoints, scores, tileIndices,
+                                   m_maximumKeypointsPerTile);
+
+        // Pruning changed which score goes with which keypoint.
+        scores.resize(keypoints.size());
+        for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+          scores[ii] = keypoints[ii].value;
+        }
+      }
+
+      m_keypointBudget.apply(keypoints, scores);
+    }
+
+
+    template <class FloatType>
+    void
+    KeypointSelectorHarris<FloatType>::
+    setImageTiled(Image<GRAY8> const& inImage)
+    {
+      unsigned int const margin = privateCode::keypointSelectorHarrisMargin;
+      unsigned int const rows = inImage.rows();
+      unsigned int const columns = inImage.columns();
+      m_searchRegionCorner0.setValue(margin, margin);
+      m_searchRegionCorner1.setValue(rows - margin, columns - margin);
+      m_tiling = KeypointTiling(
+        margin, margin, rows - margin, columns - margin,
+        (m_tileRows != 0) ? m_tileRows : keypointDefaultTileSize,
+        (m_tileColumns != 0) ? m_tileColumns : keypointDefaultTileSize);
+
+      // Size the output arrays here so that the tiles don't have to.
+      if((m_gradientXX.rows() != rows) || (m_gradientXX.columns() != columns)) {
+        m_gradientXX.reinit(rows, columns);
+        m_gradientXY.reinit(rows, columns);
+        m_gradientYY.reinit(rows, columns);
+      }
+      if((m_harrisIndicators.rows() != rows)
+         || (m_harrisIndicators.columns() != columns)) {
+        m_harrisIndicators.reinit(rows, columns);
+        m_harrisIndicators = std::numeric_limits<FloatType>::max();
+      }
+
+      // Tiles take shallow copies of these arrays (for example, in
+      // computeHarrisIndicators()), possibly in different threads.
+      if(m_threadPoolPtr != 0) {
+        m_gradientXX.setReferenceCountThreadSafe();
+        m_gradientXY.setReferenceCountThreadSafe();
+        m_gradientYY.setReferenceCountThreadSafe();
+        m_harrisIndicators.setReferenceCountThreadSafe();
+      }
+
+      // First pass: integrated products of gradients.
+      std::size_t const numberOfTiles = m_tiling.getNumberOfTiles();
+      std::vector<AccumulatedType> tileMaxima(numberOfTiles);
+      privateCode::KeypointSelectorHarrisGradientFunctor<FloatType>
+        gradientFunctor(*this, inImage, tileMaxima);
+      if(m_threadPoolPtr != 0) {
+        m_threadPoolPtr->parallelFor(numberOfTiles, gradientFunctor);
+      } else {
+        for(std::size_t tileIndex = 0; tileIndex < numberOfTiles;
+            ++tileIndex) {
+          gradientFunctor(tileIndex);
+        }
+      }
+
+      // The untiled code rescales based on the largest value over the
+      // whole search region.  Do the same here.
+      AccumulatedType maxVal =
+        *std::max_element(tileMaxima.begin(), tileMaxima.end());
+      AccumulatedType divisor = maxVal / 65535 + 1;
+
+      // Second pass: rescale, and compute Harris indicators.
+      privateCode::KeypointSelectorHarrisIndicatorFunctor<FloatType>
+        indicatorFunctor(*this, divisor);
+      if(m_threadPoolPtr != 0) {
+        m_threadPoolPtr->parallelFor(numberOfTiles, indicatorFunctor);
+      } else {
+        for(std::size_t tileIndex = 0; tileIndex < numberOfTiles;
+            ++tileIndex) {
+          indicatorFunctor(tileIndex);
+        }
+      }
+    }
+
   } // namespace computerVision
 
 } // namespace brick
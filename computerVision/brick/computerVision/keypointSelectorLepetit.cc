@@ -11,15 +11,33 @@
 ***************************************************************************
 */
 
+#include <algorithm>
+#include <brick/common/mathFunctions.hh>
 #include <brick/computerVision/keypointSelectorLepetit.hh>
 
 namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Stand-in for a keypoint that remembers its position in
+      // KeypointSelectorLepetit::m_locationVector.
+      struct KeypointLepetitCandidate {
+        int row;
+        int column;
+        std::size_t index;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
     KeypointSelectorLepetit::
     KeypointSelectorLepetit()
-      : m_levelVector(),
+      : m_keypointBudget(),
+        m_levelVector(),
         m_locationVector(),
         m_thresholdLaplacianMagnitude(0.0),
         m_thresholdPixelSimilarity(0.0)
@@ -51,6 +69,277 @@ namespace brick {
       return m_thresholdPixelSimilarity;
     }
 
+
+    void
+    KeypointSelectorLepetit::
+    setKeypointBudget(KeypointBudget const& budget)
+    {
+      m_keypointBudget = budget;
+    }
+
+
+    // ============== Private member functions below this line ==============
+
+    void
+    KeypointSelectorLepetit::
+    applyKeypointBudget(std::vector<float> const& scores)
+    {
+      // Carry each keypoint's index through the budget so that its
+      // level can be looked up afterward.
+      std::vector<privateCode::KeypointLepetitCandidate> candidates(
+        m_locationVector.size());
+      for(std::size_t ii = 0; ii < candidates.size(); ++ii) {
+        candidates[ii].row = m_locationVector[ii].getRow();
+        candidates[ii].column = m_locationVector[ii].getColumn();
+        candidates[ii].index = ii;
+      }
+      m_keypointBudget.apply(candidates, scores);
+
+      std::vector<float> levelVector(candidates.size());
+      std::vector<brick::numeric::Index2D> locationVector(candidates.size());
+      for(std::size_t ii = 0; ii < candidates.size(); ++ii) {
+        levelVector[ii] = m_levelVector[candidates[ii].index];
+        locationVector[ii] = m_locationVector[candidates[ii].index];
+      }
+      m_levelVector.swap(levelVector);
+      m_locationVector.swap(locationVector);
+    }
+
+
+    void
+    KeypointSelectorLepetit::
+    estimateThresholds(Image<GRAY_FLOAT32> const& image,
+                       float& pixelSimilarityThreshold,
+                       float& laplacianMagnitudeThreshold)
+    {
+      const unsigned int expectedKeypointsPerImage = 300;
+      const unsigned int sparsity = 10;
+      const unsigned int pixelMeasurementRadius = 3;
+
+      // Sparsely sample over entire image to accumulate statistics
+      // about what the normal pixelSimilarity and laplacianMagnitude
+      // are.  Sampling doesn't go all the way to edges because the
+      // stats require a 7x7 window to compute.
+      std::vector<float> pixelSimilarityVector;
+      std::vector<float> laplacianMagnitudeVector;
+      for(unsigned int row = pixelMeasurementRadius;
+          row < image.rows() - pixelMeasurementRadius;
+          row += sparsity) {
+        for(unsigned int column = pixelMeasurementRadius;
+            column < image.columns() - pixelMeasurementRadius;
+            column += sparsity) {
+          float pixelSimilarity = 0.0;
+          float laplacianMagnitude = 0.0;
+          this->measurePixelThresholds(
+            row, column, image, pixelSimilarity, laplacianMagnitude);
+          pixelSimilarityVector.push_back(pixelSimilarity);
+          laplacianMagnitudeVector.push_back(laplacianMagnitude);
+        }
+      }
+
+      // Figure out how many keypoints we can reasonably expect to see
+      // in our sparse vector of samples.
+      unsigned int numPixels = image.size();
+      unsigned int numSamples = pixelSimilarityVector.size();
+      double proportionSampled = double(numSamples) / numPixels;
+      unsigned int numKeypoints = proportionSampled * expectedKeypointsPerImage;
+      numKeypoints = std::min(numKeypoints, numSamples);
+      numKeypoints = std::max(numKeypoints, static_cast<unsigned int>(1));
+      unsigned int numInliers = numSamples - numKeypoints;
+
+      // Sort our two vectors of samples.  This lets us more easily
+      // find threshold values that separate the keypoints from the
+      // non-keypoints.
+      std::sort(pixelSimilarityVector.begin(),
+                pixelSimilarityVector.end());
+      std::sort(laplacianMagnitudeVector.begin(),
+                laplacianMagnitudeVector.end());
+
+      // Discard the largest values of pixelSimilarity and
+      // laplacianMagnitude, as those probably come from actual
+      // keypoints that we accidentally sampled.  Assume that the
+      // remaining values represent "normal" for non-keypoint pixels.
+#if 1
+      pixelSimilarityThreshold = pixelSimilarityVector[numInliers];
+      laplacianMagnitudeThreshold = laplacianMagnitudeVector[numInliers];
+#else
+      // Compute statistics over all of the "inliers" so we can
+      // build a model of what normal pixels look like.
+      float pixelSimilaritySum = 0.0;
+      float laplacianMagnitudeSum = 0.0;
+      float pixelSimilaritySumOfSquares = 0.0;
+      float laplacianMagnitudeSumOfSquares = 0.0;
+      for(unsigned int ii = 0; ii < numInliers; ++ii) {
+        float pixelSimilarity = pixelSimilarityVector[ii];
+        float laplacianMagnitude = laplacianMagnitudeVector[ii];
+        pixelSimilaritySum += pixelSimilarity;
+        pixelSimilaritySumOfSquares += pixelSimilarity * pixelSimilarity;
+        laplacianMagnitudeSum += laplacianMagnitude;
+        laplacianMagnitudeSumOfSquares +=
+          laplacianMagnitude * laplacianMagnitude;
+      }
+      float pixelSimilarityMean = pixelSimilaritySum / numInliers;
+      float laplacianMagnitudeMean = laplacianMagnitudeSum / numInliers;
+      float pixelSimilarityVariance = (
+        pixelSimilaritySumOfSquares / numInliers
+        - pixelSimilarityMean * pixelSimilarityMean);
+      float laplacianMagnitudeVariance = (
+        laplacianMagnitudeSumOfSquares / numInliers
+        - laplacianMagnitudeMean * laplacianMagnitudeMean);
+
+      // Finally, set thresholds at mean + 3*sigma, so that (assuming
+      // Gaussian distribution), we discard most of the inliers.
+      pixelSimilarityThreshold =
+        pixelSimilarityMean + 3.0 * std::sqrt(pixelSimilarityVariance);
+      laplacianMagnitudeThreshold =
+        laplacianMagnitudeMean + 3.0 * std::sqrt(laplacianMagnitudeVariance);
+#endif
+    }
+
+
+    void
+    KeypointSelectorLepetit::
+    measurePixelThresholds(unsigned int row, unsigned int column,
+                           Image<GRAY_FLOAT32> const& image,
+                           float& pixelSimilarity,
+                           float& laplacianMagnitude)
+    {
+      float testValue = image(row, column);
+
+      // Find the value of pixelSimilarity at which this
+      // pixel makes the transition from failing to passing.  That is,
+      // find the highest threshold at which this pixel still passes the
+      // test.  For more information, see member function testPixel().
+      float similarityValues[8];
+      similarityValues[0] = std::max(
+        common::absoluteValue(testValue - image(row, column - 3)),
+        common::absoluteValue(testValue - image(row, column + 3)));
+      similarityValues[1] = std::max(
+        common::absoluteValue(testValue - image(row - 3, column)),
+        common::absoluteValue(testValue - image(row + 3, column)));
+      similarityValues[2] = std::max(
+        common::absoluteValue(testValue - image(row + 2, column + 2)),
+        common::absoluteValue(testValue - image(row - 2, column - 2)));
+      similarityValues[3] = std::max(
+        common::absoluteValue(testValue - image(row - 2, column + 2)),
+        common::absoluteValue(testValue - image(row + 2, column - 2)));
+      similarityValues[4] = std::max(
+        common::absoluteValue(testValue - image(row + 1, column + 3)),
+        common::absoluteValue(testValue - image(row - 1, column - 3)));
+      similarityValues[5] = std::max(
+        common::absoluteValue(testValue - image(row - 3, column + 1)),
+        common::absoluteValue(testValue - image(row + 3, column - 1)));
+      similarityValues[6] = std::max(
+        common::absoluteValue(testValue - image(row + 3, column + 1)),
+        common::absoluteValue(testValue - image(row - 3, column - 1)));
+      similarityValues[7] = std::max(
+        common::absoluteValue(testValue - image(row - 1, column + 3)),
+        common::absoluteValue(testValue - image(row + 1, column -3)));
+
+      // Select the smallest of the measured max values, 'cause that's
+      // the one that would get this pixel thrown out if the threshold
+      // were too high.
+      pixelSimilarity =
+        *(std::min_element(&(similarityValues[0]), &(similarityValues[0]) + 8));
+
+      // Find the Laplacian-of-Gaussian approximation for this pixel.
+      // This is the largest value of laplacianMagnitudeThreshold at
+      // which this pixel would pass the test.
+      float averageBorderValue = (
+        image(row - 3, column - 1) + image(row - 3, column)
+        + image(row - 3, column + 1)
+        + image(row - 2, column - 2) + image(row - 2, column + 2)
+        + image(row - 1, column - 3) + image(row - 1, column + 3)
+        + image(row, column - 3) + image(row, column + 3)
+        + image(row + 1, column - 3) + image(row + 1, column + 3)
+        + image(row + 2, column - 2) + image(row + 2, column + 2)
+        + image(row + 3, column - 1) + image(row + 3, column)
+        + image(row + 3, column + 1)) / 16.0;
+      laplacianMagnitude = brick::common::absoluteValue(
+        testValue - averageBorderValue);
+    }
+
+
+    bool
+    KeypointSelectorLepetit::
+    testPixel(unsigned int row, unsigned int column,
+              Image<GRAY_FLOAT32> const& image,
+              float pixelSimilarityThreshold,
+              float laplacianMagnitudeThreshold)
+    {
+      float testValue = image(row, column);
+
+      // Counting on short-circuit evaluation to save us time here.
+      // This giant if clause passes wnen the current pixel's gray
+      // level is "...close to those of any two diametrically opposed
+      // pixels on ... [the discretized circle surrounding the current
+      // pixel, and is] ... therefore unlikely to be stable ..."
+      //
+      // Following Rosten's FAST feature detector (ICCV '05), we use a
+      // Bresenham circle of radius 3 for the "discretized circle" of
+      // Lepetit's description.
+      if(((common::absoluteValue(testValue - image(row, column - 3))
+           < pixelSimilarityThreshold)
+          && (common::absoluteValue(testValue - image(row, column + 3))
+              < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row - 3, column))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row + 3, column))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row + 2, column + 2))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row - 2, column - 2))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row - 2, column + 2))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row + 2, column - 2))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row + 1, column + 3))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row - 1, column - 3))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row - 3, column + 1))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row + 3, column - 1))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row + 3, column + 1))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row - 3, column - 1))
+                 < pixelSimilarityThreshold))
+         || ((common::absoluteValue(testValue - image(row - 1, column + 3))
+              < pixelSimilarityThreshold)
+             && (common::absoluteValue(testValue - image(row + 1, column -3))
+                 < pixelSimilarityThreshold))) {
+        // Unstable keypoint.  Discard it!
+        return false;
+      }
+
+      // Candidate keypoint passed the "likely to be stable" test.
+      // Now let's see if it's at a location with sufficiently high
+      // approximate LoG value.
+      float averageBorderValue = (
+        image(row - 3, column - 1) + image(row - 3, column)
+        + image(row - 3, column + 1)
+        + image(row - 2, column - 2) + image(row - 2, column + 2)
+        + image(row - 1, column - 3) + image(row - 1, column + 3)
+        + image(row, column - 3) + image(row, column + 3)
+        + image(row + 1, column - 3) + image(row + 1, column + 3)
+        + image(row + 2, column - 2) + image(row + 2, column + 2)
+        + image(row + 3, column - 1) + image(row + 3, column)
+        + image(row + 3, column + 1)) / 16.0;
+      float logApproximation = brick::common::absoluteValue(
+        testValue - averageBorderValue);
+      if(logApproximation <= laplacianMagnitudeThreshold) {
+        // Nope!  Laplacian of Gaussian approximation is too small.
+        // Discard this keypoint candidate.
+        return false;
+      }
+
+      // All tests passed!  Return true to indicate that a new
+      // keypoint should be added at (row, column).
+      return true;
+    }
+
   } // namespace brick
 
 } // namespace computerVision
@@ -16,6 +16,7 @@
 
 #include <vector>
 #include <brick/computerVision/image.hh>
+#include <brick/computerVision/keypointBudget.hh>
 #include <brick/numeric/index2D.hh>
 
 namespace brick {
@@ -59,8 +60,27 @@ namespace brick {
       void
       setImage(Image<Format> const& image);
 
+
+      /**
+       * This member function limits the number of keypoints found by
+       * subsequent calls to setImage().  When more keypoints are
+       * detected than the budget allows, the budget chooses among
+       * them based on their approximate Laplacian magnitude.
+       *
+       * @param budget This argument specifies how many keypoints to
+       * keep, and how to choose them.  Pass a default-constructed
+       * KeypointBudget to disable the limit.
+       */
+      void
+      setKeypointBudget(KeypointBudget const& budget);
+
     private:
 
+      // Prune m_locationVector and m_levelVector, keeping the
+      // keypoints chosen by m_keypointBudget.
+      void
+      applyKeypointBudget(std::vector<float> const& scores);
+
       void
       estimateThresholds(Image<GRAY_FLOAT32> const& image,
                          float& pixelSimilarityThreshold,
@@ -80,6 +100,7 @@ namespace brick {
 
 
 
+      KeypointBudget m_keypointBudget;
       std::vector<float> m_levelVector;
       std::vector<brick::numeric::Index2D> m_locationVector;
       float m_thresholdLaplacianMagnitude;
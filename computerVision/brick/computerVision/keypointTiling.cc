@@ -0,0 +1,108 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointTiling.cc
+*
+* Source file defining support code for the tiled, multithreaded
+* modes of the keypoint selectors.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#include <algorithm>
+#include <brick/common/exception.hh>
+#include <brick/computerVision/keypointTiling.hh>
+
+namespace brick {
+
+  namespace computerVision {
+
+    KeypointTiling::
+    KeypointTiling()
+      : m_startRow(0),
+        m_startColumn(0),
+        m_stopRow(0),
+        m_stopColumn(0),
+        m_tileRows(1),
+        m_tileColumns(1),
+        m_numberOfTileRows(0),
+        m_numberOfTileColumns(0)
+    {
+      // Empty.
+    }
+
+
+    KeypointTiling::
+    KeypointTiling(unsigned int startRow, unsigned int startColumn,
+                   unsigned int stopRow, unsigned int stopColumn,
+                   unsigned int tileRows, unsigned int tileColumns)
+      : m_startRow(startRow),
+        m_startColumn(startColumn),
+        m_stopRow(std::max(startRow, stopRow)),
+        m_stopColumn(std::max(startColumn, stopColumn)),
+        m_tileRows(tileRows),
+        m_tileColumns(tileColumns),
+        m_numberOfTileRows(0),
+        m_numberOfTileColumns(0)
+    {
+      if(tileRows == 0 || tileColumns == 0) {
+        BRICK_THROW(brick::common::ValueException,
+                    "KeypointTiling::KeypointTiling()",
+                    "Tile dimensions must be greater than zero.");
+      }
+      m_numberOfTileRows = (m_stopRow - m_startRow + tileRows - 1) / tileRows;
+      m_numberOfTileColumns =
+        (m_stopColumn - m_startColumn + tileColumns - 1) / tileColumns;
+    }
+
+
+    void
+    KeypointTiling::
+    getTile(std::size_t tileIndex,
+            unsigned int& startRow, unsigned int& startColumn,
+            unsigned int& stopRow, unsigned int& stopColumn) const
+    {
+      if(tileIndex >= this->getNumberOfTiles()) {
+        BRICK_THROW(brick::common::IndexException, "KeypointTiling::getTile()",
+                    "Argument tileIndex is out of range.");
+      }
+      unsigned int tileRow =
+        static_cast<unsigned int>(tileIndex / m_numberOfTileColumns);
+      unsigned int tileColumn =
+        static_cast<unsigned int>(tileIndex % m_numberOfTileColumns);
+      startRow = m_startRow + tileRow * m_tileRows;
+      startColumn = m_startColumn + tileColumn * m_tileColumns;
+      stopRow = std::min(startRow + m_tileRows, m_stopRow);
+      stopColumn = std::min(startColumn + m_tileColumns, m_stopColumn);
+    }
+
+
+    std::size_t
+    KeypointTiling::
+    getTileIndex(int row, int column) const
+    {
+      if(this->getNumberOfTiles() == 0) {
+        return 0;
+      }
+      std::size_t tileRow = 0;
+      if(row > static_cast<int>(m_startRow)) {
+        tileRow = std::min(
+          static_cast<std::size_t>(row - static_cast<int>(m_startRow))
+          / m_tileRows,
+          m_numberOfTileRows - 1);
+      }
+      std::size_t tileColumn = 0;
+      if(column > static_cast<int>(m_startColumn)) {
+        tileColumn = std::min(
+          static_cast<std::size_t>(column - static_cast<int>(m_startColumn))
+          / m_tileColumns,
+          m_numberOfTileColumns - 1);
+      }
+      return tileRow * m_numberOfTileColumns + tileColumn;
+    }
+
+  } // namespace computerVision
+
+} // namespace brick
@@ -0,0 +1,173 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointTiling.hh
+*
+* Header file declaring support code for the tiled, multithreaded
+* modes of the keypoint selectors.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#ifndef BRICK_COMPUTERVISION_KEYPOINTTILING_HH
+#define BRICK_COMPUTERVISION_KEYPOINTTILING_HH
+
+#include <cstddef>
+#include <vector>
+
+namespace brick {
+
+  namespace computerVision {
+
+    /**
+     * Keypoint selectors that are given a ThreadPool, but no explicit
+     * tile size, split the image into square tiles of this many rows
+     * and columns.
+     */
+    const unsigned int keypointDefaultTileSize = 128;
+
+
+    /**
+     ** This class divides a rectangular region of interest into a
+     ** regular grid of tiles.  Tiles are numbered in raster order,
+     ** and the tiles in the last row and column of the grid are
+     ** truncated to fit the region of interest.  The keypoint
+     ** selectors use it to divide work between threads, and to
+     ** enforce per-tile keypoint budgets.
+     **/
+    class KeypointTiling {
+    public:
+
+      /**
+       * The default constructor creates a tiling of an empty region.
+       */
+      KeypointTiling();
+
+
+      /**
+       * This constructor divides the specified region into tiles.
+       *
+       * @param startRow This argument is the first row of the region
+       * of interest.
+       *
+       * @param startColumn This argument is the first column of the
+       * region of interest.
+       *
+       * @param stopRow This argument is one greater than the last row
+       * of the region of interest.
+       *
+       * @param stopColumn This argument is one greater than the last
+       * column of the region of interest.
+       *
+       * @param tileRows This argument specifies the height of each
+       * tile.  It must be greater than zero.
+       *
+       * @param tileColumns This argument specifies the width of each
+       * tile.  It must be greater than zero.
+       */
+      KeypointTiling(unsigned int startRow, unsigned int startColumn,
+                     unsigned int stopRow, unsigned int stopColumn,
+                     unsigned int tileRows, unsigned int tileColumns);
+
+
+      /**
+       * This member function returns the number of tiles in the grid.
+       *
+       * @return The return value is zero if the region of interest
+       * is empty.
+       */
+      std::size_t
+      getNumberOfTiles() const {return m_numberOfTileRows * m_numberOfTileColumns;}
+
+
+      /**
+       * This member function returns the bounds of one tile.
+       *
+       * @param tileIndex This argument specifies which tile, in
+       * raster order.  It must be less than getNumberOfTiles().
+       *
+       * @param startRow This argument is set to the first row of the
+       * tile.
+       *
+       * @param startColumn This argument is set to the first column
+       * of the tile.
+       *
+       * @param stopRow This argument is set to one greater than the
+       * last row of the tile.
+       *
+       * @param stopColumn This argument is set to one greater than
+       * the last column of the tile.
+       */
+      void
+      getTile(std::size_t tileIndex,
+              unsigned int& startRow, unsigned int& startColumn,
+              unsigned int& stopRow, unsigned int& stopColumn) const;
+
+
+      /**
+       * This member function returns the index of the tile that
+       * contains the specified pixel.  Pixels outside the region of
+       * interest are assigned to the nearest tile.
+       *
+       * @param row This argument is the row of the pixel.
+       *
+       * @param column This argument is the column of the pixel.
+       *
+       * @return The return value is the raster-order index of the
+       * tile.
+       */
+      std::size_t
+      getTileIndex(int row, int column) const;
+
+    private:
+
+      unsigned int m_startRow;
+      unsigned int m_startColumn;
+      unsigned int m_stopRow;
+      unsigned int m_stopColumn;
+      unsigned int m_tileRows;
+      unsigned int m_tileColumns;
+      std::size_t m_numberOfTileRows;
+      std::size_t m_numberOfTileColumns;
+    };
+
+
+    /**
+     * This function enforces a per-tile keypoint budget.  It removes
+     * keypoints from the input vector so that no more than
+     * maximumKeypointsPerTile remain in any one tile, keeping those
+     * with the highest scores.  Ties are broken in favor of the
+     * keypoint that appears earlier in the vector.  The surviving
+     * keypoints retain their original order.
+     *
+     * @param keypoints This argument is the vector of keypoints to
+     * be pruned.
+     *
+     * @param scores This argument contains one score for each
+     * element of keypoints.  Higher scores are better.
+     *
+     * @param tileIndices This argument contains one tile index for
+     * each element of keypoints.
+     *
+     * @param maximumKeypointsPerTile This argument specifies how many
+     * keypoints to keep in each tile.
+     */
+    template <class Keypoint, class ScoreType>
+    void
+    selectBestKeypointsPerTile(std::vector<Keypoint>& keypoints,
+                               std::vector<ScoreType> const& scores,
+                               std::vector<std::size_t> const& tileIndices,
+                               std::size_t maximumKeypointsPerTile);
+
+  } // namespace computerVision
+
+} // namespace brick
+
+
+// Include file containing definitions of inline and template
+// functions.
+#include <brick/computerVision/keypointTiling_impl.hh>
+
+#endif /* #ifndef BRICK_COMPUTERVISION_KEYPOINTTILING_HH */
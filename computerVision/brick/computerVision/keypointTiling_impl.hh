@@ -0,0 +1,112 @@
+/**
+***************************************************************************
+* @file brick/computerVision/keypointTiling_impl.hh
+*
+* Header file defining inline and template functions declared in
+* keypointTiling.hh.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+*/
+
+#ifndef BRICK_COMPUTERVISION_KEYPOINTTILING_IMPL_HH
+#define BRICK_COMPUTERVISION_KEYPOINTTILING_IMPL_HH
+
+// This file is included by keypointTiling.hh, and should not be
+// directly included by user code, so no need to include
+// keypointTiling.hh here.
+//
+// #include <brick/computerVision/keypointTiling.hh>
+
+#include <algorithm>
+#include <brick/common/exception.hh>
+
+namespace brick {
+
+  namespace computerVision {
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Orders keypoint indices by tile, then by descending score,
+      // then by position in the input vector.
+      template <class ScoreType>
+      class KeypointTileBudgetLess {
+      public:
+        KeypointTileBudgetLess(std::vector<ScoreType> const& scores,
+                               std::vector<std::size_t> const& tileIndices)
+          : m_scores(scores), m_tileIndices(tileIndices) {}
+
+        bool
+        operator()(std::size_t index0, std::size_t index1) const {
+          if(m_tileIndices[index0] != m_tileIndices[index1]) {
+            return m_tileIndices[index0] < m_tileIndices[index1];
+          }
+          if(m_scores[index0] != m_scores[index1]) {
+            return m_scores[index0] > m_scores[index1];
+          }
+          return index0 < index1;
+        }
+
+      private:
+        std::vector<ScoreType> const& m_scores;
+        std::vector<std::size_t> const& m_tileIndices;
+      };
+
+    } // namespace privateCode
+    /// @endcond
+
+
+    template <class Keypoint, class ScoreType>
+    void
+    selectBestKeypointsPerTile(std::vector<Keypoint>& keypoints,
+                               std::vector<ScoreType> const& scores,
+                               std::vector<std::size_t> const& tileIndices,
+                               std::size_t maximumKeypointsPerTile)
+    {
+      if(scores.size() != keypoints.size()
+         || tileIndices.size() != keypoints.size()) {
+        BRICK_THROW(brick::common::ValueException,
+                    "selectBestKeypointsPerTile()",
+                    "Arguments scores and tileIndices must have one "
+                    "element for each keypoint.");
+      }
+
+      std::vector<std::size_t> order(keypoints.size());
+      for(std::size_t ii = 0; ii < order.size(); ++ii) {
+        order[ii] = ii;
+      }
+      std::sort(order.begin(), order.end(),
+                privateCode::KeypointTileBudgetLess<ScoreType>(
+                  scores, tileIndices));
+
+      // Walk each tile's run of indices, keeping only its head.
+      std::vector<bool> isKept(keypoints.size(), false);
+      std::size_t runLength = 0;
+      for(std::size_t ii = 0; ii < order.size(); ++ii) {
+        if(ii == 0 || tileIndices[order[ii]] != tileIndices[order[ii - 1]]) {
+          runLength = 0;
+        }
+        if(runLength < maximumKeypointsPerTile) {
+          isKept[order[ii]] = true;
+        }
+        ++runLength;
+      }
+
+      std::size_t outputIndex = 0;
+      for(std::size_t ii = 0; ii < keypoints.size(); ++ii) {
+        if(isKept[ii]) {
+          keypoints[outputIndex] = keypoints[ii];
+          ++outputIndex;
+        }
+      }
+      keypoints.erase(keypoints.begin() + outputIndex, keypoints.end());
+    }
+
+  } // namespace computerVision
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_COMPUTERVISION_KEYPOINTTILING_IMPL_HH */
@@ -138,6 +138,23 @@ namespace brick {
       SampleSequenceType
       getSubset(IterType beginIter, IterType endIter);
 
+
+      /**
+       * This member function sets the seed of the random number
+       * generator used by getRandomSample(), so that the sequence of
+       * random samples can be reproduced.  Note that the samples
+       * drawn also depend on the (internal) ordering of the sample
+       * population, which is changed by getRandomSample() and
+       * getSubset().
+       *
+       * @param seed This argument is passed to
+       * brick::random::PseudoRandom::setCurrentSeed().
+       */
+      void
+      setSeed(brick::common::Int64 seed) {
+        m_pseudoRandom.setCurrentSeed(seed);
+      }
+
     private:
 
       brick::random::PseudoRandom m_pseudoRandom;
@@ -13,7 +13,10 @@
 #ifndef BRICK_COMPUTERVISION_RANSACCLASSINTERFACE_HH
 #define BRICK_COMPUTERVISION_RANSACCLASSINTERFACE_HH
 
+#include <atomic>
 #include <vector>
+#include <brick/common/threadPool.hh>
+#include <brick/common/types.hh>
 #include <brick/computerVision/randomSampleSelector.hh>
 
 namespace brick {
@@ -41,6 +44,14 @@ namespace brick {
      ** RansacProblem, below.  For an example, see the file
      ** test/ransacTest.cpp.
      **
+     ** If member function setThreadPool() has been called, random
+     ** samples are drawn and refined in fixed-size batches, each
+     ** using its own copy of the Problem instance, seeded from a
+     ** user-specified seed and the batch index.  Batches are run in
+     ** parallel, and their results are combined in batch order, so
+     ** a given seed gives the same result regardless of the number
+     ** of threads.
+     **
      ** [1] M. Fischler and R. Bolles. Random Sample Consensus: A
      ** Paradigm for Model Fitting with Applications to Image Analysis
      ** and Automated Cartography. Graphics and Image Processing,
@@ -172,14 +183,88 @@ namespace brick {
         m_numberOfRefinements = numberOfRefinements;
       }
 
+
+      /**
+       * This member function makes subsequent calls to getResult()
+       * evaluate random samples in batches, using the threads of the
+       * specified ThreadPool.  Each batch copies the Problem instance
+       * passed to the constructor and calls setSeed() on the copy,
+       * so ProblemType must be copyable, and must provide setSeed()
+       * (as RandomSampleSelector does).  These requirements apply
+       * only to code that calls setThreadPool(); the serial
+       * algorithm doesn't use setSeed().  The copies are made (and
+       * destroyed) on the calling thread, a few batches at a time,
+       * but they may share data with each other and with the
+       * original, as brick arrays and images do.  ProblemType's
+       * member functions must therefore be safe to call
+       * concurrently on different copies.  The result depends only on
+       * the state of that Problem instance, seed, and batchSize.
+       * Note that getConsensusSet() changes the internal ordering of
+       * the Problem instance's sample population.
+       *
+       * As with the serial algorithm, getResult() returns as soon as
+       * a sample gives a consensus set larger than the minimum
+       * consensus size.  When more than one batch succeeds, the
+       * result of the earliest batch is used.  Otherwise, the model
+       * with the largest consensus set is returned, with ties
+       * broken in favor of the earliest batch.
+       *
+       * @param threadPoolPtr This argument points to the ThreadPool
+       * to use.  It is not deleted by *this, and must remain valid
+       * until it is replaced by a subsequent call to setThreadPool().
+       * Pass 0 to return to the serial algorithm.
+       *
+       * @param seed This argument is combined with the index of each
+       * batch to seed that batch's random number generator.
+       *
+       * @param batchSize This argument specifies how many random
+       * samples are evaluated by each batch, and must be greater
+       * than zero.
+       */
+      void
+      setThreadPool(brick::common::ThreadPool* threadPoolPtr,
+                    brick::common::Int64 seed = 0,
+                    size_t batchSize = 16);
+
     protected:
 
+      // Functor that evaluates one batch of random samples.  Member
+      // function estimate() passes it to ThreadPool::parallelFor().
+      class BatchTask;
+
+      // Outcome of one batch of random samples.
+      struct BatchResult {
+        BatchResult() : consensusSetSize(0), isEvaluated(false),
+                        isTerminated(false), model() {}
+
+        size_t consensusSetSize;
+        bool isEvaluated;
+        bool isTerminated;
+        ResultType model;
+      };
+
       void
       computeConsensusSet(ResultType& model, std::vector<bool>& consensusFlags);
 
+      void
+      computeConsensusSet(ProblemType& problem, ResultType& model,
+                          std::vector<bool>& consensusFlags);
+
       bool
       estimate(ResultType& model);
 
+      bool
+      estimateInBatches(ResultType& model);
+
+      void
+      evaluateBatch(size_t batch, ProblemType& problem,
+                    BatchResult& batchResult,
+                    std::atomic<size_t>& firstTerminatedBatch);
+
+      size_t
+      evaluateSample(ProblemType& problem, size_t iteration,
+                     ResultType& model);
+
       bool
       isConverged(std::vector<bool> const& consensusFlags,
                   std::vector<bool>& previousConsensusFlags,
@@ -193,7 +278,17 @@ namespace brick {
       size_t m_numberOfRandomSampleSets;
       int m_numberOfRefinements;
       ProblemType m_problem;
+      size_t m_batchSize;
+      brick::common::Int64 m_seed;
+      brick::common::ThreadPool* m_threadPoolPtr;
       unsigned int m_verbosity;
+
+      // Points to estimateInBatches() after a call to
+      // setThreadPool(), and is zero otherwise.  Calling through this
+      // pointer, rather than calling estimateInBatches() directly,
+      // means the batched code (and its use of ProblemType::setSeed())
+      // is only instantiated for programs that call setThreadPool().
+      bool (Ransac::*m_batchEstimatorPtr)(ResultType& model);
     };
 
 
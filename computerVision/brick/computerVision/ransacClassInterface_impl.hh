@@ -30,6 +30,61 @@ namespace brick {
 
   namespace computerVision {
 
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Derive a well-mixed seed for one batch of random samples
+      // using the splitmix64 finalizer, so that neighboring batches
+      // get unrelated random number streams.  PseudoRandom only uses
+      // the low 47 bits of its seed.
+      inline brick::common::Int64
+      getRansacBatchSeed(brick::common::Int64 seed, size_t batch)
+      {
+        brick::common::UInt64 mix =
+          static_cast<brick::common::UInt64>(seed)
+          + (static_cast<brick::common::UInt64>(batch) + 1)
+          * 0x9e3779b97f4a7c15ULL;
+        mix = (mix ^ (mix >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        mix = (mix ^ (mix >> 27)) * 0x94d049bb133111ebULL;
+        mix = mix ^ (mix >> 31);
+        return static_cast<brick::common::Int64>(mix & 0x00007fffffffffffULL);
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+
+    template <class Problem>
+    class Ransac<Problem>::BatchTask {
+    public:
+      BatchTask(Ransac<Problem>& ransac,
+                std::vector<ProblemType>& problems,
+                size_t firstBatch,
+                std::vector<BatchResult>& batchResults,
+                std::atomic<size_t>& firstTerminatedBatch)
+        : m_batchResults(batchResults),
+          m_firstBatch(firstBatch),
+          m_firstTerminatedBatch(firstTerminatedBatch),
+          m_problems(problems),
+          m_ransac(ransac) {}
+
+      void
+      operator()(size_t index) const {
+        size_t batch = m_firstBatch + index;
+        m_ransac.evaluateBatch(batch, m_problems[index],
+                               m_batchResults[batch],
+                               m_firstTerminatedBatch);
+      }
+
+    private:
+      std::vector<BatchResult>& m_batchResults;
+      size_t m_firstBatch;
+      std::atomic<size_t>& m_firstTerminatedBatch;
+      std::vector<ProblemType>& m_problems;
+      Ransac<Problem>& m_ransac;
+    };
+
+
     // The default constructor currently does nothing.
     template <class Problem>
     Ransac<Problem>::
@@ -42,7 +97,11 @@ namespace brick {
         m_numberOfRandomSampleSets(),
         m_numberOfRefinements(-1),
         m_problem(problem),
-        m_verbosity(verbosity)
+        m_batchSize(16),
+        m_seed(0),
+        m_threadPoolPtr(0),
+        m_verbosity(verbosity),
+        m_batchEstimatorPtr(0)
     {
       size_t sampleSize = m_problem.getSampleSize();
 
@@ -123,28 +182,63 @@ namespace brick {
     }
 
 
+    // This member function makes subsequent calls to getResult()
+    // evaluate random samples in batches, using the threads of the
+    // specified ThreadPool.
+    template <class Problem>
+    void
+    Ransac<Problem>::
+    setThreadPool(brick::common::ThreadPool* threadPoolPtr,
+                  brick::common::Int64 seed,
+                  size_t batchSize)
+    {
+      if(batchSize == 0) {
+        BRICK_THROW(common::ValueException, "Ransac::setThreadPool()",
+                    "Argument batchSize must be greater than zero.");
+      }
+      m_batchSize = batchSize;
+      m_seed = seed;
+      m_threadPoolPtr = threadPoolPtr;
+      m_batchEstimatorPtr = 0;
+      if(threadPoolPtr) {
+        m_batchEstimatorPtr = &Ransac<Problem>::estimateInBatches;
+      }
+    }
+
+
     template <class Problem>
     void
     Ransac<Problem>::
     computeConsensusSet(typename Ransac<Problem>::ResultType& model,
                         std::vector<bool>& consensusFlags)
     {
-      if(m_problem.getInlierStrategy() != BRICK_CV_NAIVE_ERROR_THRESHOLD) {
+      this->computeConsensusSet(m_problem, model, consensusFlags);
+    }
+
+
+    template <class Problem>
+    void
+    Ransac<Problem>::
+    computeConsensusSet(ProblemType& problem,
+                        typename Ransac<Problem>::ResultType& model,
+                        std::vector<bool>& consensusFlags)
+    {
+      if(problem.getInlierStrategy() != BRICK_CV_NAIVE_ERROR_THRESHOLD) {
         BRICK_THROW(brick::common::NotImplementedException,
                     "Ransac::computeConsensusSet()",
                     "Currently only naive error thresholding is supported.");
       }
-      if(consensusFlags.size() != m_problem.getPoolSize()) {
-        consensusFlags.resize(m_problem.getPoolSize());
+      if(consensusFlags.size() != problem.getPoolSize()) {
+        consensusFlags.resize(problem.getPoolSize());
       }
 
       // Apply error function to entire set.
-      typename Problem::SampleSequenceType testSet = m_problem.getPool();
-      std::vector<double> errorMetrics(m_problem.getPoolSize());
-      m_problem.computeError(model, testSet, errorMetrics.begin());
+      typename Problem::SampleSequenceType testSet = problem.getPool();
+      std::vector<double> errorMetrics(problem.getPoolSize());
+      problem.computeError(model, testSet, errorMetrics.begin());
 
       // Find out which samples are within tolerance.
-      double threshold = m_problem.getNaiveErrorThreshold();
+      double threshold = problem.getNaiveErrorThreshold();
       std::transform(
         errorMetrics.begin(), errorMetrics.end(), consensusFlags.begin(),
         std::bind2nd(std::less<double>(), threshold));
@@ -156,60 +250,15 @@ namespace brick {
     Ransac<Problem>::
     estimate(typename Ransac<Problem>::ResultType& model)
     {
+      if(m_batchEstimatorPtr) {
+        return (this->*m_batchEstimatorPtr)(model);
+      }
+
       brick::numeric::MaxRecorder<size_t, ResultType> maxRecorder;
       for(size_t iteration = 0; iteration < m_numberOfRandomSampleSets;
           ++iteration) {
-        if(m_verbosity >= 3) {
-          std::cout << "Ransac: running sample #" << iteration
-                    << " of " << m_numberOfRandomSampleSets << std::endl;
-        }
-
-        // Select samples
-        typename ProblemType::SampleSequenceType trialSet =
-          m_problem.getRandomSample(m_problem.getSampleSize());
-
-        std::vector<bool> consensusFlags(m_problem.getPoolSize());
-        std::vector<bool> previousConsensusFlags(m_problem.getPoolSize(),
-                                                 false);
-
-        // Some problem classes may, for example, retain internal
-        // state during the iterative refinement loop below.  This
-        // call allows those problems to reset that state prior to
-        // starting over with a new random sample.
-        m_problem.beginIteration(iteration);
-
-        size_t consensusSetSize = 0;
-        size_t previousConsensusSetSize = 0;
-        size_t strikes = 0;
-        int refinementCount = 0;
-        while(1) {
-          // Fit the model to the reduced (randomly sampled) set.
-          model = m_problem.estimateModel(trialSet);
-
-          // Identify the consensus set, made up of samples that are
-          // sufficiently consistent with the model estimate.
-          this->computeConsensusSet(model, consensusFlags);
-
-          if(m_verbosity >= 3) {
-            std::cout
-              << "Ransac:   consensus set size is "
-              << std::count(consensusFlags.begin(), consensusFlags.end(), true)
-              << " (vs. " << m_minimumConsensusSize << ")" << std::endl;
-          }
-
-          // See if this iteration has converged yet.
-          if(this->isConverged(consensusFlags, previousConsensusFlags,
-                               consensusSetSize, previousConsensusSetSize,
-                               strikes, refinementCount)) {
-            break;
-          }
-
-          // Not converged yet... loop so we can recompute the model
-          // using the new consensus set.
-          trialSet = m_problem.getSubset(
-            consensusFlags.begin(), consensusFlags.end());
-          ++refinementCount;
-        }
+        size_t consensusSetSize =
+          this->evaluateSample(m_problem, iteration, model);
 
         // OK, we've converged to a "best" result for this iteration.
         // Is it good enough to terminate?
@@ -237,6 +286,166 @@ namespace brick {
     }
 
 
+    template <class Problem>
+    bool
+    Ransac<Problem>::
+    estimateInBatches(typename Ransac<Problem>::ResultType& model)
+    {
+      size_t numberOfBatches =
+        (m_numberOfRandomSampleSets + m_batchSize - 1) / m_batchSize;
+      std::vector<BatchResult> batchResults(numberOfBatches);
+      std::atomic<size_t> firstTerminatedBatch(numberOfBatches);
+
+      // Each batch starts from the same Problem state, and draws
+      // from its own random number stream.  Copying the Problem may
+      // touch reference counts that it shares with m_problem, so
+      // copies are made and destroyed here on the calling thread,
+      // rather than by the workers.  Doing this a few batches at a
+      // time bounds the number of copies alive at once.
+      size_t waveSize = 4 * m_threadPoolPtr->getNumberOfThreads();
+      for(size_t waveBegin = 0;
+          waveBegin < numberOfBatches
+            && firstTerminatedBatch.load() == numberOfBatches;
+          waveBegin += waveSize) {
+        size_t waveEnd = std::min(waveBegin + waveSize, numberOfBatches);
+        std::vector<ProblemType> problems(waveEnd - waveBegin, m_problem);
+        for(size_t batch = waveBegin; batch < waveEnd; ++batch) {
+          problems[batch - waveBegin].setSeed(
+            privateCode::getRansacBatchSeed(m_seed, batch));
+        }
+        BatchTask batchTask(*this, problems, waveBegin, batchResults,
+                            firstTerminatedBatch);
+        m_threadPoolPtr->parallelFor(waveEnd - waveBegin, batchTask);
+      }
+
+      // Batches after the first successful one may have been cut
+      // short, or never started, so they're never consulted.  Otherwise, combine in
+      // batch order so that the thread schedule doesn't matter.
+      brick::numeric::MaxRecorder<size_t, ResultType> maxRecorder;
+      for(size_t batch = 0; batch < numberOfBatches; ++batch) {
+        BatchResult const& batchResult = batchResults[batch];
+        if(batchResult.isTerminated) {
+          model = batchResult.model;
+          return true;
+        }
+        if(batchResult.isEvaluated) {
+          maxRecorder.test(batchResult.consensusSetSize, batchResult.model);
+        }
+      }
+      model = maxRecorder.getPayload();
+
+      if(m_verbosity >= 3) {
+        std::cout
+          << "Ransac: terminating with best consensus set size of "
+          << maxRecorder.getMaximum() << std::endl;
+      }
+      return false;
+    }
+
+
+    template <class Problem>
+    void
+    Ransac<Problem>::
+    evaluateBatch(size_t batch, ProblemType& problem,
+                  BatchResult& batchResult,
+                  std::atomic<size_t>& firstTerminatedBatch)
+    {
+      size_t beginIteration = batch * m_batchSize;
+      size_t endIteration = std::min(beginIteration + m_batchSize,
+                                     m_numberOfRandomSampleSets);
+      ResultType model;
+      for(size_t iteration = beginIteration; iteration < endIteration;
+          ++iteration) {
+        // No need to continue if an earlier batch has already
+        // succeeded, since this batch's result won't be used.
+        if(firstTerminatedBatch.load() < batch) {
+          return;
+        }
+
+        size_t consensusSetSize =
+          this->evaluateSample(problem, iteration, model);
+        if(!batchResult.isEvaluated
+           || consensusSetSize > batchResult.consensusSetSize) {
+          batchResult.consensusSetSize = consensusSetSize;
+          batchResult.isEvaluated = true;
+          batchResult.model = model;
+        }
+
+        if(consensusSetSize > m_minimumConsensusSize) {
+          batchResult.isTerminated = true;
+          size_t previousBatch = firstTerminatedBatch.load();
+          while(batch < previousBatch
+                && !firstTerminatedBatch.compare_exchange_weak(
+                  previousBatch, batch)) {
+            // Empty.
+          }
+          return;
+        }
+      }
+    }
+
+
+    template <class Problem>
+    size_t
+    Ransac<Problem>::
+    evaluateSample(ProblemType& problem, size_t iteration,
+                   typename Ransac<Problem>::ResultType& model)
+    {
+      if(m_verbosity >= 3) {
+        std::cout << "Ransac: running sample #" << iteration
+                  << " of " << m_numberOfRandomSampleSets << std::endl;
+      }
+
+      // Select samples
+      typename ProblemType::SampleSequenceType trialSet =
+        problem.getRandomSample(problem.getSampleSize());
+
+      std::vector<bool> consensusFlags(problem.getPoolSize());
+      std::vector<bool> previousConsensusFlags(problem.getPoolSize(),
+                                               false);
+
+      // Some problem classes may, for example, retain internal
+      // state during the iterative refinement loop below.  This
+      // call allows those problems to reset that state prior to
+      // starting over with a new random sample.
+      problem.beginIteration(iteration);
+
+      size_t consensusSetSize = 0;
+      size_t previousConsensusSetSize = 0;
+      size_t strikes = 0;
+      int refinementCount = 0;
+      while(1) {
+        // Fit the model to the reduced (randomly sampled) set.
+        model = problem.estimateModel(trialSet);
+
+        // Identify the consensus set, made up of samples that are
+        // sufficiently consistent with the model estimate.
+        this->computeConsensusSet(problem, model, consensusFlags);
+
+        if(m_verbosity >= 3) {
+          std::cout
+            << "Ransac:   consensus set size is "
+            << std::count(consensusFlags.begin(), consensusFlags.end(), true)
+            << " (vs. " << m_minimumConsensusSize << ")" << std::endl;
+        }
+
+        // See if this iteration has converged yet.
+        if(this->isConverged(consensusFlags, previousConsensusFlags,
+                             consensusSetSize, previousConsensusSetSize,
+                             strikes, refinementCount)) {
+          break;
+        }
+
+        // Not converged yet... loop so we can recompute the model
+        // using the new consensus set.
+        trialSet = problem.getSubset(
+          consensusFlags.begin(), consensusFlags.end());
+        ++refinementCount;
+      }
+      return consensusSetSize;
+    }
+
+
     template <class Problem>
     bool
     Ransac<Problem>::
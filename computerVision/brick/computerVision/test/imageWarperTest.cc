@@ -10,9 +10,26 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <brick/computerVision/imageWarper.hh>
+#include <brick/numeric/simdKernels.hh>
+#include <brick/random/pseudoRandom.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_COMPUTERVISION_DEVELOPER
+#include <iostream>
+#include <brick/computerVision/cameraIntrinsicsPlumbBob.hh>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
 namespace num = brick::numeric;
 
 namespace brick {
@@ -27,15 +44,102 @@ namespace brick {
       ImageWarperTest();
       ~ImageWarperTest() {}
 
-      void setUp(const std::string& /* testName */) {}
-      void tearDown(const std::string& /* testName */) {}
+      void setUp(const std::string& /* testName */) {
+        m_savedSimdLevel = numeric::getSimdLevel();
+      }
+      void tearDown(const std::string& /* testName */) {
+        numeric::setSimdLevel(m_savedSimdLevel);
+      }
 
       // Tests.
       void testImageWarper();
       void testImageWarperRGB();
+      void testImageWarperCompact();
+      void testImageWarperCompact__gray8();
+      void testImageWarperCompact__rgb8();
+      void testImageWarperGrid();
+      void testImageWarperGrid__nonFinite();
+      void testImageWarperThreadPool();
+      void testLoad__errors();
+      void testSaveLoad();
+      void testWarpImage__outputImage();
+      void testWarpImage__outputROI();
+      void testWarpImage__tiles();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      void timeConstructor();
+      void timeWarpImage();
+      void timeWarpImage__tiles();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
     private:
 
+      // Barrel distortion about the center of the output image,
+      // followed by a shift.  Counts calls if callCountPtr is not 0,
+      // and returns NaN for output columns greater than
+      // nanThreshold.
+      template <class FloatType>
+      struct DistortWarpFunctor {
+        DistortWarpFunctor(FloatType kappa, FloatType centerX,
+                           FloatType centerY, FloatType shift,
+                           size_t* callCountPtr = 0,
+                           FloatType nanThreshold
+                           = std::numeric_limits<FloatType>::max())
+          : m_callCountPtr(callCountPtr),
+            m_center(centerX, centerY),
+            m_kappa(kappa),
+            m_nanThreshold(nanThreshold),
+            m_shift(shift) {}
+
+        num::Vector2D<FloatType>
+        operator()(num::Vector2D<FloatType> const& arg) const {
+          if(m_callCountPtr) {
+            ++(*m_callCountPtr);
+          }
+          if(arg.x() > m_nanThreshold) {
+            FloatType nan = std::numeric_limits<FloatType>::quiet_NaN();
+            return num::Vector2D<FloatType>(nan, nan);
+          }
+          num::Vector2D<FloatType> offset = arg - m_center;
+          FloatType rSquared = offset.x() * offset.x()
+            + offset.y() * offset.y();
+          return (m_center + (FloatType(1) + m_kappa * rSquared) * offset
+                  + num::Vector2D<FloatType>(m_shift, m_shift));
+        }
+
+        size_t* m_callCountPtr;
+        num::Vector2D<FloatType> m_center;
+        FloatType m_kappa;
+        FloatType m_nanThreshold;
+        FloatType m_shift;
+      };
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+      // Maps undistorted output pixels to distorted input pixels by
+      // reverse projecting through the camera model.
+      struct ReverseProjectWarpFunctor {
+        ReverseProjectWarpFunctor(
+          CameraIntrinsicsPlumbBob<common::Float64> const& intrinsics)
+          : m_intrinsics(intrinsics) {}
+
+        num::Vector2D<common::Float64>
+        operator()(num::Vector2D<common::Float64> const& arg) const {
+          num::Vector3D<common::Float64> direction =
+            m_intrinsics.reverseProject(arg).getDirectionVector();
+          return num::Vector2D<common::Float64>(
+            m_intrinsics.getFocalLengthX() * direction.x() / direction.z()
+            + m_intrinsics.getCenterU(),
+            m_intrinsics.getFocalLengthY() * direction.y() / direction.z()
+            + m_intrinsics.getCenterV());
+        }
+
+        CameraIntrinsicsPlumbBob<common::Float64> m_intrinsics;
+      };
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
       template <class FloatType>
       struct ShiftWarpFunctor {
         ShiftWarpFunctor(FloatType xShift, FloatType yShift)
@@ -74,6 +178,29 @@ namespace brick {
       };
 
 
+      // Rotates and scales about the center of the output image.
+      template <class FloatType>
+      struct RotateWarpFunctor {
+        RotateWarpFunctor(FloatType angle, FloatType scale,
+                          FloatType centerX, FloatType centerY)
+          : m_cosine(scale * std::cos(angle)),
+            m_sine(scale * std::sin(angle)),
+            m_center(centerX, centerY) {}
+
+        num::Vector2D<FloatType>
+        operator()(num::Vector2D<FloatType> const& arg) const {
+          num::Vector2D<FloatType> offset = arg - m_center;
+          return m_center + num::Vector2D<FloatType>(
+            m_cosine * offset.x() - m_sine * offset.y(),
+            m_sine * offset.x() + m_cosine * offset.y());
+        }
+
+        FloatType m_cosine;
+        FloatType m_sine;
+        num::Vector2D<FloatType> m_center;
+      };
+
+
       template <ImageFormat Format, class FloatType>
       bool
       isInBounds(num::Vector2D<FloatType> const& coordinate,
@@ -82,6 +209,7 @@ namespace brick {
 
       double m_defaultTolerance;
       float m_defaultFloatTolerance;
+      numeric::SimdLevel m_savedSimdLevel;
 
     }; // class ImageWarperTest
 
@@ -92,10 +220,28 @@ namespace brick {
     ImageWarperTest()
       : brick::test::TestFixture<ImageWarperTest>("ImageWarperTest"),
         m_defaultTolerance(1.0E-10),
-        m_defaultFloatTolerance(1.0E-6)
+        m_defaultFloatTolerance(1.0E-6),
+        m_savedSimdLevel(numeric::BRICK_SIMD_NONE)
     {
       BRICK_TEST_REGISTER_MEMBER(testImageWarper);
       BRICK_TEST_REGISTER_MEMBER(testImageWarperRGB);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperCompact);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperCompact__gray8);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperCompact__rgb8);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperGrid);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperGrid__nonFinite);
+      BRICK_TEST_REGISTER_MEMBER(testImageWarperThreadPool);
+      BRICK_TEST_REGISTER_MEMBER(testLoad__errors);
+      BRICK_TEST_REGISTER_MEMBER(testSaveLoad);
+      BRICK_TEST_REGISTER_MEMBER(testWarpImage__outputImage);
+      BRICK_TEST_REGISTER_MEMBER(testWarpImage__outputROI);
+      BRICK_TEST_REGISTER_MEMBER(testWarpImage__tiles);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeConstructor);
+      BRICK_TEST_REGISTER_MEMBER(timeWarpImage);
+      BRICK_TEST_REGISTER_MEMBER(timeWarpImage__tiles);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -313,6 +459,806 @@ namespace brick {
       }
     }
 
+    void
+    ImageWarperTest::
+    testImageWarperCompact()
+    {
+      // Compact tables should give almost the same answer as full
+      // tables for floating point images.
+      random::PseudoRandom pRandom(1);
+      Image<GRAY_FLOAT64> inputImage(23, 31);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = pRandom.uniform(0.0, 100.0);
+      }
+
+      size_t outputRows = 29;
+      size_t outputColumns = 37;
+      common::Float64 defaultValue = -1.0;
+      RotateWarpFunctor<common::Float64> rotateWarpFunctor(
+        0.3, 0.8, outputColumns / 2.0, outputRows / 2.0);
+      ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+        fullWarper(inputImage.rows(), inputImage.columns(),
+                   outputRows, outputColumns, rotateWarpFunctor);
+      ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+        compactWarper(inputImage.rows(), inputImage.columns(),
+                      outputRows, outputColumns, rotateWarpFunctor,
+                      BRICK_CV_WARPER_TABLE_COMPACT);
+      BRICK_TEST_ASSERT(
+        fullWarper.getTableFormat() == BRICK_CV_WARPER_TABLE_FULL);
+      BRICK_TEST_ASSERT(
+        compactWarper.getTableFormat() == BRICK_CV_WARPER_TABLE_COMPACT);
+
+      Image<GRAY_FLOAT64> fullImage =
+        fullWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+          inputImage, defaultValue);
+      Image<GRAY_FLOAT64> compactImage =
+        compactWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+          inputImage, defaultValue);
+      BRICK_TEST_ASSERT(compactImage.rows() == outputRows);
+      BRICK_TEST_ASSERT(compactImage.columns() == outputColumns);
+
+      // Fractions are quantized to 1/65536 of a pixel, and adjacent
+      // pixels differ by at most 100.
+      size_t numberInBounds = 0;
+      for(size_t ii = 0; ii < fullImage.size(); ++ii) {
+        if(fullImage[ii] == defaultValue) {
+          BRICK_TEST_ASSERT(compactImage[ii] == defaultValue);
+        } else {
+          BRICK_TEST_ASSERT(
+            approximatelyEqual(compactImage[ii], fullImage[ii], 5.0E-3));
+          ++numberInBounds;
+        }
+      }
+      BRICK_TEST_ASSERT(numberInBounds > fullImage.size() / 2);
+
+      // Compact tables can't address huge input images.
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::ValueException,
+        (ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >(
+          65536, 32768, outputRows, outputColumns, rotateWarpFunctor,
+          BRICK_CV_WARPER_TABLE_COMPACT)));
+    }
+
+
+    void
+    ImageWarperTest::
+    testImageWarperCompact__gray8()
+    {
+      random::PseudoRandom pRandom(2);
+      Image<GRAY8> inputImage(41, 53);
+      Image<GRAY_FLOAT64> referenceInput(inputImage.rows(),
+                                         inputImage.columns());
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        referenceInput[ii] = inputImage[ii];
+      }
+
+      // An odd number of output columns exercises the scalar code
+      // at the end of each vectorized pass.
+      size_t outputRows = 47;
+      size_t outputColumns = 61;
+      RotateWarpFunctor<common::Float32> rotateWarpFunctor(
+        -0.7, 0.9, outputColumns / 2.0f, outputRows / 2.0f);
+      ImageWarper< common::Float32, RotateWarpFunctor<common::Float32> >
+        fullWarper(inputImage.rows(), inputImage.columns(),
+                   outputRows, outputColumns, rotateWarpFunctor);
+      ImageWarper< common::Float32, RotateWarpFunctor<common::Float32> >
+        compactWarper(inputImage.rows(), inputImage.columns(),
+                      outputRows, outputColumns, rotateWarpFunctor,
+                      BRICK_CV_WARPER_TABLE_COMPACT);
+      Image<GRAY_FLOAT64> referenceImage =
+        fullWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+          referenceInput, -1.0);
+
+      Image<GRAY8> firstImage;
+      for(int simdLevel = numeric::BRICK_SIMD_NONE;
+          simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+        numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+        Image<GRAY8> outputImage =
+          compactWarper.warpImage<GRAY8, GRAY8>(inputImage, 7);
+
+        // Results should match the floating point warp to within
+        // rounding, and should not depend on SIMD level.
+        for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+          if(referenceImage[ii] < 0.0) {
+            BRICK_TEST_ASSERT(outputImage[ii] == 7);
+          } else {
+            BRICK_TEST_ASSERT(
+              std::fabs(outputImage[ii] - referenceImage[ii]) < 0.51);
+          }
+        }
+        if(simdLevel == numeric::BRICK_SIMD_NONE) {
+          firstImage = outputImage;
+        } else {
+          for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+            BRICK_TEST_ASSERT(outputImage[ii] == firstImage[ii]);
+          }
+        }
+      }
+    }
+
+
+    void
+    ImageWarperTest::
+    testImageWarperCompact__rgb8()
+    {
+      random::PseudoRandom pRandom(3);
+      Image<RGB8> inputImage(41, 53);
+      Image<RGB_FLOAT64> referenceInput(inputImage.rows(),
+                                        inputImage.columns());
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii].red = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        inputImage[ii].green = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        inputImage[ii].blue = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        referenceInput[ii].red = inputImage[ii].red;
+        referenceInput[ii].green = inputImage[ii].green;
+        referenceInput[ii].blue = inputImage[ii].blue;
+      }
+
+      size_t outputRows = 47;
+      size_t outputColumns = 61;
+      RotateWarpFunctor<common::Float32> rotateWarpFunctor(
+        0.4, 1.1, outputColumns / 2.0f, outputRows / 2.0f);
+      ImageWarper< common::Float32, RotateWarpFunctor<common::Float32> >
+        fullWarper(inputImage.rows(), inputImage.columns(),
+                   outputRows, outputColumns, rotateWarpFunctor);
+      ImageWarper< common::Float32, RotateWarpFunctor<common::Float32> >
+        compactWarper(inputImage.rows(), inputImage.columns(),
+                      outputRows, outputColumns, rotateWarpFunctor,
+                      BRICK_CV_WARPER_TABLE_COMPACT);
+      Image<RGB_FLOAT64> referenceImage =
+        fullWarper.warpImage<RGB_FLOAT64, RGB_FLOAT64>(
+          referenceInput, PixelRGBFloat64(-1.0, -1.0, -1.0));
+
+      PixelRGB8 defaultValue(1, 2, 3);
+      Image<RGB8> firstImage;
+      for(int simdLevel = numeric::BRICK_SIMD_NONE;
+          simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+        numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+        Image<RGB8> outputImage =
+          compactWarper.warpImage<RGB8, RGB8>(inputImage, defaultValue);
+
+        for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+          if(referenceImage[ii].red < 0.0) {
+            BRICK_TEST_ASSERT(outputImage[ii] == defaultValue);
+          } else {
+            BRICK_TEST_ASSERT(
+              std::fabs(outputImage[ii].red - referenceImage[ii].red) < 0.51);
+            BRICK_TEST_ASSERT(
+              std::fabs(outputImage[ii].green - referenceImage[ii].green)
+              < 0.51);
+            BRICK_TEST_ASSERT(
+              std::fabs(outputImage[ii].blue - referenceImage[ii].blue)
+              < 0.51);
+          }
+        }
+        if(simdLevel == numeric::BRICK_SIMD_NONE) {
+          firstImage = outputImage;
+        } else {
+          for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+            BRICK_TEST_ASSERT(outputImage[ii] == firstImage[ii]);
+          }
+        }
+      }
+    }
+
+
+    void
+    ImageWarperTest::
+    testImageWarperGrid()
+    {
+      // Warping images whose pixel values are their own coordinates
+      // recovers the input coordinate associated with each output
+      // pixel.
+      Image<GRAY_FLOAT64> xImage(100, 120);
+      Image<GRAY_FLOAT64> yImage(100, 120);
+      for(size_t row = 0; row < xImage.rows(); ++row) {
+        for(size_t column = 0; column < xImage.columns(); ++column) {
+          xImage(row, column) = column;
+          yImage(row, column) = row;
+        }
+      }
+
+      // Strong enough distortion that some cells fail the error
+      // check, but everything maps well inside the input image.
+      size_t outputRows = 61;
+      size_t outputColumns = 83;
+      common::Float64 maximumError = 0.025;
+      size_t exactCallCount = 0;
+      size_t gridCallCount = 0;
+      DistortWarpFunctor<common::Float64> exactFunctor(
+        1.0E-5, outputColumns / 2.0, outputRows / 2.0, 20.0,
+        &exactCallCount);
+      DistortWarpFunctor<common::Float64> gridFunctor(
+        1.0E-5, outputColumns / 2.0, outputRows / 2.0, 20.0,
+        &gridCallCount);
+      ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+        exactWarper(xImage.rows(), xImage.columns(),
+                    outputRows, outputColumns, exactFunctor);
+      ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+        gridWarper(xImage.rows(), xImage.columns(),
+                   outputRows, outputColumns, gridFunctor,
+                   BRICK_CV_WARPER_TABLE_FULL, 0, maximumError, 8);
+      BRICK_TEST_ASSERT(exactCallCount == outputRows * outputColumns);
+      BRICK_TEST_ASSERT(gridCallCount < exactCallCount / 2);
+
+      Image<GRAY_FLOAT64> exactX =
+        exactWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(xImage, -1.0);
+      Image<GRAY_FLOAT64> exactY =
+        exactWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(yImage, -1.0);
+      Image<GRAY_FLOAT64> gridX =
+        gridWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(xImage, -1.0);
+      Image<GRAY_FLOAT64> gridY =
+        gridWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(yImage, -1.0);
+      for(size_t ii = 0; ii < exactX.size(); ++ii) {
+        BRICK_TEST_ASSERT(exactX[ii] >= 0.0);
+        BRICK_TEST_ASSERT(gridX[ii] >= 0.0);
+        common::Float64 dx = gridX[ii] - exactX[ii];
+        common::Float64 dy = gridY[ii] - exactY[ii];
+        BRICK_TEST_ASSERT(std::sqrt(dx * dx + dy * dy)
+                          <= maximumError + m_defaultTolerance);
+      }
+
+      // A generous error bound means no exact evaluation at all.
+      gridCallCount = 0;
+      ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+        looseWarper(xImage.rows(), xImage.columns(),
+                    outputRows, outputColumns, gridFunctor,
+                    BRICK_CV_WARPER_TABLE_FULL, 0, 100.0, 8);
+      size_t numberOfBands = (outputRows + 7) / 8;
+      size_t numberOfCells = (outputColumns + 7) / 8;
+      BRICK_TEST_ASSERT(
+        gridCallCount == numberOfBands * (2 * (numberOfCells + 1)
+                                          + 5 * numberOfCells));
+
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::ValueException,
+        (ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >(
+          xImage.rows(), xImage.columns(), outputRows, outputColumns,
+          gridFunctor, BRICK_CV_WARPER_TABLE_FULL, 0, maximumError, 0)));
+    }
+
+
+    void
+    ImageWarperTest::
+    testImageWarperGrid__nonFinite()
+    {
+      // Cells containing non-finite transform values must be
+      // evaluated exactly, so that the grid doesn't smear valid
+      // coordinates into regions that have none.
+      Image<GRAY_FLOAT64> inputImage(100, 120);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = 1.0;
+      }
+      size_t outputRows = 61;
+      size_t outputColumns = 83;
+      DistortWarpFunctor<common::Float64> functor(
+        1.0E-5, outputColumns / 2.0, outputRows / 2.0, 20.0, 0, 40.5);
+      ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+        gridWarper(inputImage.rows(), inputImage.columns(),
+                   outputRows, outputColumns, functor,
+                   BRICK_CV_WARPER_TABLE_COMPACT, 0, 1.0, 16);
+      Image<GRAY_FLOAT64> outputImage =
+        gridWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(inputImage, -1.0);
+      for(size_t row = 0; row < outputRows; ++row) {
+        for(size_t column = 0; column < outputColumns; ++column) {
+          if(column > 40) {
+            BRICK_TEST_ASSERT(outputImage(row, column) == -1.0);
+          } else {
+            BRICK_TEST_ASSERT(
+              approximatelyEqual(outputImage(row, column), 1.0,
+                                 m_defaultTolerance));
+          }
+        }
+      }
+    }
+
+
+    void
+    ImageWarperTest::
+    testImageWarperThreadPool()
+    {
+      random::PseudoRandom pRandom(4);
+      Image<GRAY_FLOAT64> inputImage(45, 57);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = pRandom.uniform(0.0, 100.0);
+      }
+      size_t outputRows = 53;
+      size_t outputColumns = 67;
+      DistortWarpFunctor<common::Float64> functor(
+        2.0E-4, outputColumns / 2.0, outputRows / 2.0, -3.0);
+
+      // The table should not depend on the number of threads.
+      common::ThreadPool threadPool(3);
+      for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+          tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+        for(int ii = 0; ii < 2; ++ii) {
+          common::Float64 maximumError = (ii == 0) ? 0.0 : 0.1;
+          ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+            serialWarper(inputImage.rows(), inputImage.columns(),
+                         outputRows, outputColumns, functor,
+                         static_cast<ImageWarperTableFormat>(tableFormat),
+                         0, maximumError, 4);
+          ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+            parallelWarper(inputImage.rows(), inputImage.columns(),
+                           outputRows, outputColumns, functor,
+                           static_cast<ImageWarperTableFormat>(tableFormat),
+                           &threadPool, maximumError, 4);
+          Image<GRAY_FLOAT64> serialImage =
+            serialWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+              inputImage, -1.0);
+          Image<GRAY_FLOAT64> parallelImage =
+            parallelWarper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+              inputImage, -1.0);
+          for(size_t jj = 0; jj < serialImage.size(); ++jj) {
+            BRICK_TEST_ASSERT(parallelImage[jj] == serialImage[jj]);
+          }
+        }
+      }
+    }
+
+
+    void
+    ImageWarperTest::
+    testLoad__errors()
+    {
+      typedef ImageWarper< common::Float64, ShiftWarpFunctor<common::Float64> >
+        DoubleWarper;
+      typedef ImageWarper< common::Float32, ShiftWarpFunctor<common::Float32> >
+        FloatWarper;
+      std::string fileName = "/var/tmp/brickImageWarperTest.table";
+      DoubleWarper warper(
+        20, 30, 25, 35, ShiftWarpFunctor<common::Float64>(1.5, 2.5));
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::IOException,
+        warper.load("/var/tmp/brickImageWarperTest.nonexistent"));
+
+      // Not a table file.
+      {
+        std::ofstream outputStream(fileName.c_str(), std::ios::binary);
+        for(unsigned int ii = 0; ii < 1000; ++ii) {
+          outputStream << "garbage";
+        }
+      }
+      BRICK_TEST_ASSERT_EXCEPTION(common::IOException, warper.load(fileName));
+      BRICK_TEST_ASSERT_EXCEPTION(common::IOException,
+                                  warper.load(fileName, false));
+
+      // Full tables depend on NumericType.
+      warper.save(fileName);
+      FloatWarper floatWarper;
+      BRICK_TEST_ASSERT_EXCEPTION(common::IOException,
+                                  floatWarper.load(fileName));
+
+      // Truncated file.
+      {
+        std::ifstream inputStream(fileName.c_str(), std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(inputStream)),
+                             std::istreambuf_iterator<char>());
+        inputStream.close();
+        std::ofstream outputStream(fileName.c_str(), std::ios::binary);
+        outputStream.write(contents.data(), contents.size() - 1);
+      }
+      BRICK_TEST_ASSERT_EXCEPTION(common::IOException, warper.load(fileName));
+      BRICK_TEST_ASSERT_EXCEPTION(common::IOException,
+                                  warper.load(fileName, false));
+
+      // Table entries that refer to pixels outside the input image
+      // should be rejected when the table is read into memory.  We
+      // corrupt the entry for output pixel (5, 5), which maps well
+      // inside the input image.  The first bad index is just past
+      // the last row that has a row below it, and the second is in
+      // the last column.
+      size_t badIndices[] = {19 * 30, 29};
+      for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+          tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+        DoubleWarper formatWarper(
+          20, 30, 25, 35, ShiftWarpFunctor<common::Float64>(1.5, 2.5),
+          static_cast<ImageWarperTableFormat>(tableFormat));
+        formatWarper.save(fileName);
+        std::string contents;
+        {
+          std::ifstream inputStream(fileName.c_str(), std::ios::binary);
+          contents.assign((std::istreambuf_iterator<char>(inputStream)),
+                          std::istreambuf_iterator<char>());
+        }
+        DoubleWarper loadedWarper;
+        loadedWarper.load(fileName, false);
+
+        // Compact entries start with a UInt32 index.  Full entries
+        // hold four weights and then a size_t index.
+        size_t headerSize = privateCode::imageWarperFileHeaderSize;
+        size_t entrySize = (contents.size() - headerSize) / (25 * 35);
+        size_t entryOffset = headerSize + (5 * 35 + 5) * entrySize;
+        for(unsigned int ii = 0; ii < 2; ++ii) {
+          std::string badContents = contents;
+          if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+            common::UInt32 badIndex =
+              static_cast<common::UInt32>(badIndices[ii]);
+            std::memcpy(&(badContents[entryOffset]), &badIndex,
+                        sizeof(badIndex));
+          } else {
+            std::memcpy(&(badContents[entryOffset
+                                      + 4 * sizeof(common::Float64)]),
+                        &(badIndices[ii]), sizeof(size_t));
+          }
+          {
+            std::ofstream outputStream(fileName.c_str(), std::ios::binary);
+            outputStream.write(badContents.data(), badContents.size());
+          }
+          BRICK_TEST_ASSERT_EXCEPTION(common::IOException,
+                                      loadedWarper.load(fileName, false));
+        }
+      }
+      std::remove(fileName.c_str());
+    }
+
+
+    void
+    ImageWarperTest::
+    testSaveLoad()
+    {
+      random::PseudoRandom pRandom(5);
+      Image<GRAY8> inputImage(40, 50);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+      }
+      std::string fileName = "/var/tmp/brickImageWarperTest.table";
+      DistortWarpFunctor<common::Float64> functor(
+        2.0E-4, 22.0, 17.0, 3.0);
+
+      typedef ImageWarper< common::Float64, DistortWarpFunctor<common::Float64> >
+        DoubleWarper;
+      typedef ImageWarper< common::Float32, DistortWarpFunctor<common::Float32> >
+        FloatWarper;
+      for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+          tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+        DoubleWarper warper(
+          inputImage.rows(), inputImage.columns(), 35, 45, functor,
+          static_cast<ImageWarperTableFormat>(tableFormat));
+        Image<GRAY8> referenceImage =
+          warper.warpImage<GRAY8, GRAY8>(inputImage, 0);
+        warper.save(fileName);
+
+        for(int isMemoryMapped = 0; isMemoryMapped < 2; ++isMemoryMapped) {
+          // Copies must keep the table alive after the loaded
+          // warper is gone.
+          DoubleWarper copiedWarper;
+          {
+            DoubleWarper loadedWarper;
+            loadedWarper.load(fileName, isMemoryMapped != 0);
+            BRICK_TEST_ASSERT(loadedWarper.getTableFormat()
+                              == warper.getTableFormat());
+            copiedWarper = loadedWarper;
+          }
+          Image<GRAY8> outputImage =
+            copiedWarper.warpImage<GRAY8, GRAY8>(inputImage, 0);
+          BRICK_TEST_ASSERT(outputImage.rows() == referenceImage.rows());
+          BRICK_TEST_ASSERT(outputImage.columns() == referenceImage.columns());
+          for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+            BRICK_TEST_ASSERT(outputImage[ii] == referenceImage[ii]);
+          }
+
+          // Input dimensions are restored too.
+          BRICK_TEST_ASSERT_EXCEPTION(
+            common::ValueException,
+            (copiedWarper.warpImage<GRAY8, GRAY8>(Image<GRAY8>(41, 50), 0)));
+        }
+
+        // Compact tables can be shared between NumericTypes.
+        if(tableFormat == BRICK_CV_WARPER_TABLE_COMPACT) {
+          FloatWarper floatWarper;
+          floatWarper.load(fileName);
+          Image<GRAY8> outputImage =
+            floatWarper.warpImage<GRAY8, GRAY8>(inputImage, 0);
+          for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+            BRICK_TEST_ASSERT(outputImage[ii] == referenceImage[ii]);
+          }
+        }
+      }
+      std::remove(fileName.c_str());
+    }
+
+
+    void
+    ImageWarperTest::
+    testWarpImage__outputImage()
+    {
+      random::PseudoRandom pRandom(6);
+      Image<GRAY_FLOAT32> inputImage(30, 40);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::Float32>(
+          pRandom.uniform(0.0, 1.0));
+      }
+      RotateWarpFunctor<common::Float32> functor(0.5, 1.0, 17.0, 12.0);
+      ImageWarper< common::Float32, RotateWarpFunctor<common::Float32> >
+        warper(inputImage.rows(), inputImage.columns(), 25, 35, functor);
+      Image<GRAY_FLOAT32> referenceImage =
+        warper.warpImage<GRAY_FLOAT32, GRAY_FLOAT32>(inputImage, -1.0f);
+
+      // The output image is written in place, not reallocated.
+      Image<GRAY_FLOAT32> outputImage(25, 35);
+      common::Float32* dataPtr = outputImage.data();
+      warper.warpImage<GRAY_FLOAT32, GRAY_FLOAT32>(
+        inputImage, outputImage, -1.0f);
+      BRICK_TEST_ASSERT(outputImage.data() == dataPtr);
+      for(size_t ii = 0; ii < outputImage.size(); ++ii) {
+        BRICK_TEST_ASSERT(outputImage[ii] == referenceImage[ii]);
+      }
+
+      Image<GRAY_FLOAT32> wrongSizeImage(25, 36);
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::ValueException,
+        (warper.warpImage<GRAY_FLOAT32, GRAY_FLOAT32>(
+          inputImage, wrongSizeImage, -1.0f)));
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  warper.setTileSize(0, 16));
+    }
+
+
+    void
+    ImageWarperTest::
+    testWarpImage__outputROI()
+    {
+      random::PseudoRandom pRandom(8);
+      Image<GRAY8> inputImage(30, 40);
+      Image<GRAY_FLOAT64> floatImage(30, 40);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        floatImage[ii] = inputImage[ii];
+      }
+
+      // Warping into a region of a larger image should fill in just
+      // that region, even though its rows aren't contiguous.
+      RotateWarpFunctor<common::Float64> functor(0.5, 1.0, 17.0, 12.0);
+      numeric::Index2D corner0(3, 4);
+      numeric::Index2D corner1(3 + 25, 4 + 35);
+      for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+          tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+        ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+          warper(inputImage.rows(), inputImage.columns(), 25, 35, functor,
+                 static_cast<ImageWarperTableFormat>(tableFormat));
+        warper.setTileSize(7, 13);
+        Image<GRAY8> referenceImage =
+          warper.warpImage<GRAY8, GRAY8>(inputImage, 3);
+        Image<GRAY_FLOAT64> referenceFloatImage =
+          warper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(floatImage, -1.0);
+
+        Image<GRAY8> fullImage(40, 50);
+        Image<GRAY_FLOAT64> fullFloatImage(40, 50);
+        fullImage = 255;
+        fullFloatImage = -2.0;
+        Image<GRAY8> outputImage = fullImage.getROI(corner0, corner1);
+        Image<GRAY_FLOAT64> outputFloatImage =
+          fullFloatImage.getROI(corner0, corner1);
+        BRICK_TEST_ASSERT(!outputImage.isContiguous());
+        warper.warpImage<GRAY8, GRAY8>(inputImage, outputImage, 3);
+        warper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(
+          floatImage, outputFloatImage, -1.0);
+
+        for(size_t row = 0; row < fullImage.rows(); ++row) {
+          for(size_t column = 0; column < fullImage.columns(); ++column) {
+            if(row >= 3 && row < 3 + 25 && column >= 4 && column < 4 + 35) {
+              BRICK_TEST_ASSERT(fullImage(row, column)
+                                == referenceImage(row - 3, column - 4));
+              BRICK_TEST_ASSERT(fullFloatImage(row, column)
+                                == referenceFloatImage(row - 3, column - 4));
+            } else {
+              BRICK_TEST_ASSERT(fullImage(row, column) == 255);
+              BRICK_TEST_ASSERT(fullFloatImage(row, column) == -2.0);
+            }
+          }
+        }
+      }
+    }
+
+
+    void
+    ImageWarperTest::
+    testWarpImage__tiles()
+    {
+      random::PseudoRandom pRandom(7);
+      Image<GRAY8> inputImage(50, 60);
+      Image<GRAY_FLOAT64> floatImage(50, 60);
+      for(size_t ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        floatImage[ii] = inputImage[ii];
+      }
+
+      // Results must not depend on tiling or threading.  Tile sizes
+      // that don't divide the image exercise partial tiles.
+      RotateWarpFunctor<common::Float64> functor(1.3, 0.9, 35.0, 27.0);
+      size_t tileRows[] = {16, 1, 7, 100};
+      size_t tileColumns[] = {0, 1, 13, 64};
+      common::ThreadPool threadPool(3);
+      for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+          tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+        ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+          warper(inputImage.rows(), inputImage.columns(), 55, 70, functor,
+                 static_cast<ImageWarperTableFormat>(tableFormat));
+        warper.setTileSize(1000, 0);
+        Image<GRAY8> referenceImage =
+          warper.warpImage<GRAY8, GRAY8>(inputImage, 3);
+        Image<GRAY_FLOAT64> referenceFloatImage =
+          warper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(floatImage, -1.0);
+
+        for(unsigned int ii = 0; ii < 4; ++ii) {
+          for(unsigned int jj = 0; jj < 4; ++jj) {
+            warper.setTileSize(tileRows[ii], tileColumns[jj]);
+            warper.setThreadPool((jj % 2 == 0) ? &threadPool : 0);
+            Image<GRAY8> outputImage =
+              warper.warpImage<GRAY8, GRAY8>(inputImage, 3);
+            Image<GRAY_FLOAT64> outputFloatImage =
+              warper.warpImage<GRAY_FLOAT64, GRAY_FLOAT64>(floatImage, -1.0);
+            for(size_t kk = 0; kk < outputImage.size(); ++kk) {
+              BRICK_TEST_ASSERT(outputImage[kk] == referenceImage[kk]);
+              BRICK_TEST_ASSERT(
+                outputFloatImage[kk] == referenceFloatImage[kk]);
+            }
+          }
+        }
+      }
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    ImageWarperTest::
+    timeConstructor()
+    {
+      // Reverse projection through a distorted camera model is the
+      // expensive case that motivated the grid.
+      typedef CameraIntrinsicsPlumbBob<common::Float64> Intrinsics;
+      Intrinsics intrinsics(1920, 1080, 1400.0, 1400.0, 960.0, 540.0, 0.0,
+                            -0.3, 0.1, 0.0, 0.001, -0.001);
+      ReverseProjectWarpFunctor functor(intrinsics);
+
+      common::ThreadPool threadPool(0);
+      common::Float64 maximumErrors[] = {0.0, 0.0, 0.1, 0.1};
+      common::ThreadPool* threadPools[] = {0, &threadPool, 0, &threadPool};
+      for(unsigned int ii = 0; ii < 4; ++ii) {
+        double time0 = utilities::getCurrentTime();
+        ImageWarper<common::Float64, ReverseProjectWarpFunctor> warper(
+          1080, 1920, 1080, 1920, functor, BRICK_CV_WARPER_TABLE_COMPACT,
+          threadPools[ii], maximumErrors[ii]);
+        double time1 = utilities::getCurrentTime();
+        std::cout << "\nmaximumError " << maximumErrors[ii] << ", "
+                  << (threadPools[ii] ? threadPool.getNumberOfThreads() : 1)
+                  << " threads: " << (time1 - time0)
+                  << " seconds to build a 1920x1080 table." << std::endl;
+      }
+
+      // Compare with reading a saved table.
+      std::string fileName = "/var/tmp/brickImageWarperTest.table";
+      ImageWarper<common::Float64, ReverseProjectWarpFunctor> warper(
+        1080, 1920, 1080, 1920, functor, BRICK_CV_WARPER_TABLE_COMPACT,
+        &threadPool, 0.1);
+      warper.save(fileName);
+      for(int isMemoryMapped = 0; isMemoryMapped < 2; ++isMemoryMapped) {
+        double time0 = utilities::getCurrentTime();
+        ImageWarper<common::Float64, ReverseProjectWarpFunctor> loadedWarper;
+        loadedWarper.load(fileName, isMemoryMapped != 0);
+        double time1 = utilities::getCurrentTime();
+        std::cout << (isMemoryMapped ? "Mapping" : "Reading")
+                  << " a saved table: " << (time1 - time0) << " seconds."
+                  << std::endl;
+      }
+      std::remove(fileName.c_str());
+    }
+
+
+    void
+    ImageWarperTest::
+    timeWarpImage()
+    {
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> grayImage(1080, 1920);
+      Image<RGB8> rgbImage(1080, 1920);
+      for(size_t ii = 0; ii < grayImage.size(); ++ii) {
+        grayImage[ii] = static_cast<common::UInt8>(pRandom.uniformInt(0, 256));
+        rgbImage[ii] = PixelRGB8(grayImage[ii], grayImage[ii] / 2, 255);
+      }
+      RotateWarpFunctor<common::Float64> rotateWarpFunctor(
+        0.1, 0.95, 960.0, 540.0);
+      ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+        fullWarper(1080, 1920, 1080, 1920, rotateWarpFunctor);
+      ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+        compactWarper(1080, 1920, 1080, 1920, rotateWarpFunctor,
+                      BRICK_CV_WARPER_TABLE_COMPACT);
+
+      const unsigned int numberOfFrames = 20;
+      double time0 = utilities::getCurrentTime();
+      for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+        fullWarper.warpImage<GRAY8, GRAY8>(grayImage, 0);
+      }
+      double time1 = utilities::getCurrentTime();
+      std::cout << "\nFull table: "
+                << numberOfFrames / (time1 - time0)
+                << " frames per second for 1920x1080 GRAY8." << std::endl;
+
+      for(int simdLevel = numeric::BRICK_SIMD_NONE;
+          simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+        numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+        time0 = utilities::getCurrentTime();
+        for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+          compactWarper.warpImage<GRAY8, GRAY8>(grayImage, 0);
+        }
+        time1 = utilities::getCurrentTime();
+        for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+          compactWarper.warpImage<RGB8, RGB8>(rgbImage, PixelRGB8(0, 0, 0));
+        }
+        double time2 = utilities::getCurrentTime();
+        std::cout << "Compact table, SIMD level " << simdLevel << ": "
+                  << numberOfFrames / (time1 - time0)
+                  << " frames per second for 1920x1080 GRAY8, "
+                  << numberOfFrames / (time2 - time1)
+                  << " for RGB8." << std::endl;
+      }
+    }
+
+
+
+    void
+    ImageWarperTest::
+    timeWarpImage__tiles()
+    {
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> grayImage(1080, 1920);
+      for(size_t ii = 0; ii < grayImage.size(); ++ii) {
+        grayImage[ii] = static_cast<common::UInt8>(pRandom.uniformInt(0, 256));
+      }
+      Image<GRAY8> outputImage(1080, 1920);
+      common::ThreadPool threadPool(0);
+
+      // A quarter turn makes each output row read a column of the
+      // input, which is the worst case for row-order traversal.
+      common::Float64 angles[] = {0.1, 1.5707963};
+      size_t tileRows[] = {16, 16, 32, 64, 8};
+      size_t tileColumns[] = {0, 64, 32, 64, 128};
+      const unsigned int numberOfFrames = 20;
+      for(unsigned int ii = 0; ii < 2; ++ii) {
+        RotateWarpFunctor<common::Float64> rotateWarpFunctor(
+          angles[ii], 0.95, 960.0, 540.0);
+        for(int tableFormat = BRICK_CV_WARPER_TABLE_FULL;
+            tableFormat <= BRICK_CV_WARPER_TABLE_COMPACT; ++tableFormat) {
+          ImageWarper< common::Float64, RotateWarpFunctor<common::Float64> >
+            warper(1080, 1920, 1080, 1920, rotateWarpFunctor,
+                   static_cast<ImageWarperTableFormat>(tableFormat),
+                   &threadPool);
+          for(unsigned int jj = 0; jj < 5; ++jj) {
+            warper.setTileSize(tileRows[jj], tileColumns[jj]);
+            for(unsigned int kk = 0; kk < 2; ++kk) {
+              warper.setThreadPool(kk ? &threadPool : 0);
+              double time0 = utilities::getCurrentTime();
+              for(unsigned int ll = 0; ll < numberOfFrames; ++ll) {
+                warper.warpImage<GRAY8, GRAY8>(grayImage, outputImage, 0);
+              }
+              double time1 = utilities::getCurrentTime();
+              std::cout << "\nAngle " << angles[ii]
+                        << (tableFormat ? ", compact" : ", full")
+                        << ", " << tileRows[jj] << "x" << tileColumns[jj]
+                        << " tiles, "
+                        << (kk ? threadPool.getNumberOfThreads() : 1)
+                        << " threads: " << numberOfFrames / (time1 - time0)
+                        << " frames per second." << std::flush;
+            }
+          }
+        }
+      }
+      std::cout << std::endl;
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
     template <ImageFormat Format, class FloatType>
     bool
     ImageWarperTest::
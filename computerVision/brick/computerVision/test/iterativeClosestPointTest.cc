@@ -10,16 +10,57 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/iterativeClosestPoint.hh>
 #include <brick/numeric/rotations.hh>
 #include <brick/numeric/vector3D.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_COMPUTERVISION_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
 namespace com = brick::common;
 namespace num = brick::numeric;
 
+
+namespace {
+
+  // Gives the tests access to query point selection.
+  class SelectionTestIcp
+    : public brick::computerVision::IterativeClosestPoint<
+        3, num::Vector3D<double>, double> {
+  public:
+    std::vector< num::Vector3D<double> >
+    select(std::vector< num::Vector3D<double> > const& allQueryPoints) {
+      std::vector< num::Vector3D<double> > selectedQueryPoints;
+      this->m_iterationCount = 0;
+      this->selectQueryPoints(selectedQueryPoints, allQueryPoints);
+      return selectedQueryPoints;
+    }
+  };
+
+
+  bool
+  isLessVector3D(num::Vector3D<double> const& arg0,
+                 num::Vector3D<double> const& arg1)
+  {
+    if(arg0.x() != arg1.x()) {return arg0.x() < arg1.x();}
+    if(arg0.y() != arg1.y()) {return arg0.y() < arg1.y();}
+    return arg0.z() < arg1.z();
+  }
+
+} // namespace
+
 namespace brick {
 
   namespace computerVision {
@@ -37,9 +78,32 @@ namespace brick {
 
       // Tests.
       void testGetTransform();
+      void testRegisterPoints__pointToPlane();
+      void testRegisterPoints__subsampled();
+      void testSelectQueryPoints();
+      void testSetThreadPool();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      // Benchmarks.
+      void timeRegisterPoints();
+      void timeRegisterPoints__pointToPlane();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
     private:
 
+      std::vector< num::Vector3D<double> >
+      getCornerPoints(unsigned int extent, double spacing);
+
+
+      std::vector< num::Vector3D<double> >
+      getSurfacePoints(unsigned int extent, double spacing);
+
+
+      num::Transform3D<double>
+      getObservedFromModel(double roll, double pitch, double yaw,
+                           double tx, double ty, double tz);
+
+
       double m_defaultTolerance;
 
     }; // class IterativeClosestPointTest
@@ -54,6 +118,15 @@ namespace brick {
         m_defaultTolerance(1.0E-5)
     {
       BRICK_TEST_REGISTER_MEMBER(testGetTransform);
+      BRICK_TEST_REGISTER_MEMBER(testRegisterPoints__pointToPlane);
+      BRICK_TEST_REGISTER_MEMBER(testRegisterPoints__subsampled);
+      BRICK_TEST_REGISTER_MEMBER(testSelectQueryPoints);
+      BRICK_TEST_REGISTER_MEMBER(testSetThreadPool);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeRegisterPoints);
+      BRICK_TEST_REGISTER_MEMBER(timeRegisterPoints__pointToPlane);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -175,6 +248,344 @@ namespace brick {
       }
     }
 
+
+
+    void
+    IterativeClosestPointTest::
+    testRegisterPoints__pointToPlane()
+    {
+      // Point-to-plane registration should recover the exact
+      // transform of both a curved surface and a planar scene, in no
+      // more iterations than point-to-point registration.
+      for(int scene = 0; scene < 2; ++scene) {
+        std::vector< num::Vector3D<double> > modelPoints =
+          (scene == 0) ? this->getSurfacePoints(30, 0.3)
+          : this->getCornerPoints(20, 0.25);
+        num::Transform3D<double> observedFromModel =
+          this->getObservedFromModel(0.06, -0.04, 0.05, 0.2, -0.1, 0.15);
+        std::vector< num::Vector3D<double> > observedPoints(
+          modelPoints.size());
+        std::transform(modelPoints.begin(), modelPoints.end(),
+                       observedPoints.begin(),
+                       observedFromModel.getFunctor());
+
+        IterativeClosestPoint<3, num::Vector3D<double>, double> icp;
+        icp.setModelPoints(modelPoints.begin(), modelPoints.end());
+        icp.registerPoints(observedPoints.begin(), observedPoints.end());
+        unsigned int pointToPointIterationCount = icp.getIterationCount();
+
+        icp.setErrorMetric(BRICK_CV_ICP_POINT_TO_PLANE);
+        num::Transform3D<double> modelFromObservedEstimate =
+          icp.registerPoints(observedPoints.begin(), observedPoints.end());
+        BRICK_TEST_ASSERT(
+          icp.getIterationCount() <= pointToPointIterationCount);
+
+        num::Transform3D<double> product =
+          modelFromObservedEstimate * observedFromModel;
+        for(size_t rr = 0; rr < 4; ++rr) {
+          for(size_t cc = 0; cc < 4; ++cc) {
+            BRICK_TEST_ASSERT(
+              com::approximatelyEqual(product(rr, cc), (rr == cc ? 1.0 : 0.0),
+                                      this->m_defaultTolerance));
+          }
+        }
+      }
+    }
+
+
+    void
+    IterativeClosestPointTest::
+    testRegisterPoints__subsampled()
+    {
+      // A dense surface, registered using only a few hundred query
+      // points.  Each strategy should still recover the exact
+      // transform, since every observed point has an exact match in
+      // the model.
+      std::vector< num::Vector3D<double> > modelPoints =
+        this->getSurfacePoints(40, 0.25);
+      num::Transform3D<double> observedFromModel =
+        this->getObservedFromModel(0.05, -0.03, 0.04, 0.1, -0.05, 0.08);
+      std::vector< num::Vector3D<double> > observedPoints(modelPoints.size());
+      std::transform(modelPoints.begin(), modelPoints.end(),
+                     observedPoints.begin(), observedFromModel.getFunctor());
+
+      IcpSelectionStrategy strategies[] = {
+        BRICK_CV_ICP_SELECT_RANDOM, BRICK_CV_ICP_SELECT_NORMAL_SPACE,
+        BRICK_CV_ICP_SELECT_VOXEL_GRID};
+      for(size_t ss = 0; ss < sizeof(strategies) / sizeof(strategies[0]);
+          ++ss) {
+        IterativeClosestPoint<3, num::Vector3D<double>, double> icp;
+        icp.setModelPoints(modelPoints.begin(), modelPoints.end());
+        icp.setQuerySelectionStrategy(strategies[ss], 300, 1.0, 5);
+        num::Transform3D<double> modelFromObservedEstimate =
+          icp.registerPoints(observedPoints.begin(), observedPoints.end());
+        num::Transform3D<double> product =
+          modelFromObservedEstimate * observedFromModel;
+        for(size_t rr = 0; rr < 4; ++rr) {
+          for(size_t cc = 0; cc < 4; ++cc) {
+            BRICK_TEST_ASSERT(
+              com::approximatelyEqual(product(rr, cc), (rr == cc ? 1.0 : 0.0),
+                                      this->m_defaultTolerance));
+          }
+        }
+      }
+    }
+
+
+    void
+    IterativeClosestPointTest::
+    testSelectQueryPoints()
+    {
+      std::vector< num::Vector3D<double> > allPoints =
+        this->getSurfacePoints(30, 0.2);
+      std::vector< num::Vector3D<double> > sortedPoints = allPoints;
+      std::sort(sortedPoints.begin(), sortedPoints.end(), isLessVector3D);
+
+      // Selecting everything is the default.
+      SelectionTestIcp icp;
+      BRICK_TEST_ASSERT(icp.select(allPoints) == allPoints);
+
+      // Random and normal space selection return the requested number
+      // of distinct input points, repeatably.
+      IcpSelectionStrategy strategies[] = {
+        BRICK_CV_ICP_SELECT_RANDOM, BRICK_CV_ICP_SELECT_NORMAL_SPACE};
+      for(size_t ss = 0; ss < 2; ++ss) {
+        icp.setQuerySelectionStrategy(strategies[ss], 100, 0.0, 3);
+        std::vector< num::Vector3D<double> > selectedPoints =
+          icp.select(allPoints);
+        BRICK_TEST_ASSERT(selectedPoints.size() == 100);
+        BRICK_TEST_ASSERT(icp.select(allPoints) == selectedPoints);
+        std::sort(selectedPoints.begin(), selectedPoints.end(),
+                  isLessVector3D);
+        BRICK_TEST_ASSERT(
+          std::adjacent_find(selectedPoints.begin(), selectedPoints.end())
+          == selectedPoints.end());
+        BRICK_TEST_ASSERT(
+          std::includes(sortedPoints.begin(), sortedPoints.end(),
+                        selectedPoints.begin(), selectedPoints.end(),
+                        isLessVector3D));
+
+        icp.setQuerySelectionStrategy(strategies[ss], 5000, 0.0, 3);
+        BRICK_TEST_ASSERT(icp.select(allPoints) == allPoints);
+      }
+
+      // Voxel selection keeps one point per occupied voxel.
+      double const voxelSize = 1.0;
+      icp.setQuerySelectionStrategy(BRICK_CV_ICP_SELECT_VOXEL_GRID, 0,
+                                    voxelSize);
+      std::vector< num::Vector3D<double> > selectedPoints =
+        icp.select(allPoints);
+      std::vector< num::Vector3D<double> > voxels;
+      for(size_t ii = 0; ii < allPoints.size(); ++ii) {
+        voxels.push_back(
+          num::Vector3D<double>(std::floor(allPoints[ii].x() / voxelSize),
+                                std::floor(allPoints[ii].y() / voxelSize),
+                                std::floor(allPoints[ii].z() / voxelSize)));
+      }
+      std::sort(voxels.begin(), voxels.end(), isLessVector3D);
+      voxels.erase(std::unique(voxels.begin(), voxels.end()), voxels.end());
+      BRICK_TEST_ASSERT(selectedPoints.size() == voxels.size());
+      for(size_t ii = 1; ii < selectedPoints.size(); ++ii) {
+        num::Vector3D<double> voxel0(
+          std::floor(selectedPoints[ii - 1].x() / voxelSize),
+          std::floor(selectedPoints[ii - 1].y() / voxelSize),
+          std::floor(selectedPoints[ii - 1].z() / voxelSize));
+        num::Vector3D<double> voxel1(
+          std::floor(selectedPoints[ii].x() / voxelSize),
+          std::floor(selectedPoints[ii].y() / voxelSize),
+          std::floor(selectedPoints[ii].z() / voxelSize));
+        BRICK_TEST_ASSERT(isLessVector3D(voxel0, voxel1));
+      }
+
+      BRICK_TEST_ASSERT_EXCEPTION(
+        com::ValueException,
+        icp.setQuerySelectionStrategy(BRICK_CV_ICP_SELECT_VOXEL_GRID, 0, 0.0));
+    }
+
+
+    void
+    IterativeClosestPointTest::
+    testSetThreadPool()
+    {
+      // Matching in parallel must give exactly the same result as
+      // matching serially, whatever the number of threads.
+      std::vector< num::Vector3D<double> > modelPoints =
+        this->getSurfacePoints(40, 0.25);
+      num::Transform3D<double> observedFromModel =
+        this->getObservedFromModel(-0.04, 0.06, 0.02, -0.1, 0.15, 0.05);
+      std::vector< num::Vector3D<double> > observedPoints(modelPoints.size());
+      std::transform(modelPoints.begin(), modelPoints.end(),
+                     observedPoints.begin(), observedFromModel.getFunctor());
+
+      IterativeClosestPoint<3, num::Vector3D<double>, double> icp;
+      icp.setModelPoints(modelPoints.begin(), modelPoints.end());
+      num::Transform3D<double> serialEstimate =
+        icp.registerPoints(observedPoints.begin(), observedPoints.end());
+      unsigned int serialIterationCount = icp.getIterationCount();
+
+      size_t threadCounts[] = {2, 3, 8};
+      for(size_t tt = 0; tt < sizeof(threadCounts) / sizeof(size_t); ++tt) {
+        com::ThreadPool threadPool(threadCounts[tt]);
+        icp.setThreadPool(&threadPool);
+        num::Transform3D<double> parallelEstimate =
+          icp.registerPoints(observedPoints.begin(), observedPoints.end());
+        icp.setThreadPool(0);
+        BRICK_TEST_ASSERT(icp.getIterationCount() == serialIterationCount);
+        for(size_t rr = 0; rr < 4; ++rr) {
+          for(size_t cc = 0; cc < 4; ++cc) {
+            BRICK_TEST_ASSERT(
+              parallelEstimate(rr, cc) == serialEstimate(rr, cc));
+          }
+        }
+      }
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    IterativeClosestPointTest::
+    timeRegisterPoints()
+    {
+      std::vector< num::Vector3D<double> > modelPoints =
+        this->getSurfacePoints(300, 0.05);
+      num::Transform3D<double> observedFromModel =
+        this->getObservedFromModel(0.02, -0.01, 0.03, 0.05, -0.02, 0.03);
+      std::vector< num::Vector3D<double> > observedPoints(modelPoints.size());
+      std::transform(modelPoints.begin(), modelPoints.end(),
+                     observedPoints.begin(), observedFromModel.getFunctor());
+
+      IcpSelectionStrategy strategies[] = {
+        BRICK_CV_ICP_SELECT_ALL, BRICK_CV_ICP_SELECT_RANDOM,
+        BRICK_CV_ICP_SELECT_NORMAL_SPACE, BRICK_CV_ICP_SELECT_VOXEL_GRID};
+      char const* names[] = {"all", "random", "normal space", "voxel grid"};
+      com::ThreadPool threadPool;
+      for(size_t ss = 0; ss < 4; ++ss) {
+        for(int pass = 0; pass < 2; ++pass) {
+          IterativeClosestPoint<3, num::Vector3D<double>, double> icp;
+          icp.setModelPoints(modelPoints.begin(), modelPoints.end());
+          icp.setQuerySelectionStrategy(strategies[ss], 2000, 0.5);
+          icp.setThreadPool(pass == 0 ? 0 : &threadPool);
+          double t0 = utilities::getCurrentTime();
+          icp.registerPoints(observedPoints.begin(), observedPoints.end());
+          double t1 = utilities::getCurrentTime();
+          std::cout << "\nSelection " << names[ss] << ", "
+                    << (pass == 0 ? 1 : threadPool.getNumberOfThreads())
+                    << " thread(s): ET for registering "
+                    << observedPoints.size() << " points: " << (t1 - t0)
+                    << " (" << icp.getIterationCount() << " iterations)"
+                    << std::endl;
+        }
+      }
+    }
+
+
+
+    void
+    IterativeClosestPointTest::
+    timeRegisterPoints__pointToPlane()
+    {
+      IcpErrorMetric errorMetrics[] = {
+        BRICK_CV_ICP_POINT_TO_POINT, BRICK_CV_ICP_POINT_TO_PLANE};
+      char const* names[] = {"point-to-point", "point-to-plane"};
+      for(int scene = 0; scene < 2; ++scene) {
+        std::vector< num::Vector3D<double> > modelPoints =
+          (scene == 0) ? this->getSurfacePoints(200, 0.05)
+          : this->getCornerPoints(120, 0.05);
+        num::Transform3D<double> observedFromModel =
+          this->getObservedFromModel(0.05, -0.04, 0.06, 0.3, -0.2, 0.1);
+        std::vector< num::Vector3D<double> > observedPoints(
+          modelPoints.size());
+        std::transform(modelPoints.begin(), modelPoints.end(),
+                       observedPoints.begin(),
+                       observedFromModel.getFunctor());
+
+        for(size_t mm = 0; mm < 2; ++mm) {
+          IterativeClosestPoint<3, num::Vector3D<double>, double> icp;
+          icp.setModelPoints(modelPoints.begin(), modelPoints.end());
+          icp.setErrorMetric(errorMetrics[mm]);
+          double t0 = utilities::getCurrentTime();
+          num::Transform3D<double> modelFromObservedEstimate =
+            icp.registerPoints(observedPoints.begin(), observedPoints.end());
+          double t1 = utilities::getCurrentTime();
+          num::Transform3D<double> product =
+            modelFromObservedEstimate * observedFromModel;
+          double residual = 0.0;
+          for(size_t rr = 0; rr < 3; ++rr) {
+            for(size_t cc = 0; cc < 4; ++cc) {
+              residual = std::max(
+                residual, std::fabs(product(rr, cc) - (rr == cc ? 1.0 : 0.0)));
+            }
+          }
+          std::cout << "\n" << (scene == 0 ? "Surface" : "Corner") << ", "
+                    << names[mm] << ": ET for registering "
+                    << observedPoints.size() << " points: " << (t1 - t0)
+                    << " (" << icp.getIterationCount()
+                    << " iterations, residual " << residual << ")"
+                    << std::endl;
+        }
+      }
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
+    // Samples the floor and two walls of a room, meeting at the
+    // origin.
+    std::vector< num::Vector3D<double> >
+    IterativeClosestPointTest::
+    getCornerPoints(unsigned int extent, double spacing)
+    {
+      std::vector< num::Vector3D<double> > points;
+      for(unsigned int ii = 0; ii < extent; ++ii) {
+        for(unsigned int jj = 0; jj < extent; ++jj) {
+          double uValue = (ii + 0.5) * spacing;
+          double vValue = (jj + 0.5) * spacing;
+          points.push_back(num::Vector3D<double>(uValue, vValue, 0.0));
+          points.push_back(num::Vector3D<double>(uValue, 0.0, vValue));
+          points.push_back(num::Vector3D<double>(0.0, uValue, vValue));
+        }
+      }
+      return points;
+    }
+
+
+    // Samples a smooth surface with a mix of flat and curved regions
+    // on a square grid.
+    std::vector< num::Vector3D<double> >
+    IterativeClosestPointTest::
+    getSurfacePoints(unsigned int extent, double spacing)
+    {
+      std::vector< num::Vector3D<double> > points;
+      double size = extent * spacing;
+      for(unsigned int ii = 0; ii < extent; ++ii) {
+        for(unsigned int jj = 0; jj < extent; ++jj) {
+          double xValue = ii * spacing;
+          double yValue = jj * spacing;
+          double zValue = (std::sin(6.0 * xValue / size)
+                           * std::cos(4.0 * yValue / size)
+                           + 0.3 * xValue / size);
+          points.push_back(num::Vector3D<double>(xValue, yValue, zValue));
+        }
+      }
+      return points;
+    }
+
+
+    num::Transform3D<double>
+    IterativeClosestPointTest::
+    getObservedFromModel(double roll, double pitch, double yaw,
+                         double tx, double ty, double tz)
+    {
+      num::Transform3D<double> observedFromModel =
+        num::rollPitchYawToTransform3D<double>(
+          num::Vector3D<double>(roll, pitch, yaw));
+      observedFromModel.setValue(0, 3, tx);
+      observedFromModel.setValue(1, 3, ty);
+      observedFromModel.setValue(2, 3, tz);
+      return observedFromModel;
+    }
+
   } // namespace computerVision
 
 } // namespace brick
@@ -10,17 +10,45 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
+#include <algorithm>
 #include <brick/common/mathFunctions.hh>
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/kdTree.hh>
 #include <brick/numeric/index3D.hh>
 #include <brick/numeric/vector3D.hh>
 #include <brick/numeric/utilities.hh>
+#include <brick/random/pseudoRandom.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_COMPUTERVISION_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
 namespace com = brick::common;
 namespace num = brick::numeric;
 
 
+namespace {
+
+  // Stands in for a high-dimensional feature descriptor.
+  struct Descriptor16 {
+    double values[16];
+
+    double operator[](size_t index) const {return values[index];}
+
+    bool operator==(Descriptor16 const& other) const {
+      return std::equal(values, values + 16, other.values);
+    }
+  };
+
+} // namespace
+
+
 namespace brick {
 
   namespace computerVision {
@@ -40,9 +68,36 @@ namespace brick {
       void testConstructor();
       void testFind();
       void testFindNearest();
+      void testFindNearest__random();
+      void testFindKNearest();
+      void testFindNearestApproximate();
+      void testFindKNearest__batch();
+      void testFindWithinRadius();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      // Benchmarks.
+      void timeConstruction();
+      void timeFindNearestApproximate();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
     private:
 
+      std::vector<double>
+      getSortedDistances(
+        num::Vector3D<double> const& point,
+        std::vector< num::Vector3D<double> > const& candidateVector);
+
+
+      std::vector< num::Vector3D<double> >
+      getRandomPoints(brick::random::PseudoRandom& pRandom,
+                      size_t numberOfPoints, double range);
+
+
+      std::vector<Descriptor16>
+      getRandomDescriptors(brick::random::PseudoRandom& pRandom,
+                           size_t numberOfDescriptors);
+
+
       num::Vector3D<double> const&
       findNearest(num::Vector3D<double> const& point,
                   std::vector< num::Vector3D<double> > const& candidateVector,
@@ -85,6 +140,16 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testConstructor);
       BRICK_TEST_REGISTER_MEMBER(testFind);
       BRICK_TEST_REGISTER_MEMBER(testFindNearest);
+      BRICK_TEST_REGISTER_MEMBER(testFindNearest__random);
+      BRICK_TEST_REGISTER_MEMBER(testFindKNearest);
+      BRICK_TEST_REGISTER_MEMBER(testFindNearestApproximate);
+      BRICK_TEST_REGISTER_MEMBER(testFindKNearest__batch);
+      BRICK_TEST_REGISTER_MEMBER(testFindWithinRadius);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeConstruction);
+      BRICK_TEST_REGISTER_MEMBER(timeFindNearestApproximate);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -200,6 +265,455 @@ namespace brick {
     }
 
 
+    void
+    KDTreeTest::
+    testFindNearest__random()
+    {
+      // Exercise a range of leaf sizes, including degenerate ones,
+      // with a cloud that contains duplicate points.
+      brick::random::PseudoRandom pRandom(1);
+      std::vector< num::Vector3D<double> > inPoints;
+      for(size_t ii = 0; ii < 1000; ++ii) {
+        inPoints.push_back(num::Vector3D<double>(
+                             pRandom.uniform(-10.0, 10.0),
+                             pRandom.uniform(-10.0, 10.0),
+                             pRandom.uniform(-1.0, 1.0)));
+      }
+      for(size_t ii = 0; ii < 50; ++ii) {
+        inPoints.push_back(inPoints[ii * 7]);
+      }
+
+      size_t leafSizes[] = {0, 1, 2, 8, 64, 5000};
+      for(size_t jj = 0; jj < sizeof(leafSizes) / sizeof(size_t); ++jj) {
+        KDTree< 3, num::Vector3D<double> > kdTree(
+          inPoints.begin(), inPoints.end(), leafSizes[jj]);
+        BRICK_TEST_ASSERT(kdTree.getSize() == inPoints.size());
+
+        for(size_t ii = 0; ii < inPoints.size(); ii += 13) {
+          BRICK_TEST_ASSERT(kdTree.find(inPoints[ii]));
+        }
+
+        for(size_t ii = 0; ii < 200; ++ii) {
+          num::Vector3D<double> queryPoint(pRandom.uniform(-12.0, 12.0),
+                                           pRandom.uniform(-12.0, 12.0),
+                                           pRandom.uniform(-2.0, 2.0));
+          double distance;
+          num::Vector3D<double> nearest = this->findNearest(
+            queryPoint, inPoints, distance);
+          double maybeDistance;
+          num::Vector3D<double> maybeNearest = kdTree.findNearest(
+            queryPoint, maybeDistance);
+          BRICK_TEST_ASSERT(
+            com::absoluteValue(distance - maybeDistance) < m_defaultTolerance);
+          BRICK_TEST_ASSERT(
+            com::absoluteValue(
+              num::magnitudeSquared<double>(queryPoint - maybeNearest)
+              - maybeDistance) < m_defaultTolerance);
+        }
+      }
+
+      // Empty trees have nothing to find.
+      KDTree< 3, num::Vector3D<double> > emptyTree;
+      double distance;
+      emptyTree.findNearest(inPoints[0], distance);
+      BRICK_TEST_ASSERT(distance == std::numeric_limits<double>::max());
+      BRICK_TEST_ASSERT(!emptyTree.find(inPoints[0]));
+    }
+
+
+    void
+    KDTreeTest::
+    testFindKNearest()
+    {
+      brick::random::PseudoRandom pRandom(2);
+      std::vector< num::Vector3D<double> > inPoints =
+        this->getRandomPoints(pRandom, 500, 10.0);
+      for(size_t ii = 0; ii < 20; ++ii) {
+        inPoints.push_back(inPoints[ii * 3]);
+      }
+
+      size_t leafSizes[] = {0, 1, 8, 1000};
+      size_t kValues[] = {0, 1, 5, 17, 600};
+      for(size_t jj = 0; jj < sizeof(leafSizes) / sizeof(size_t); ++jj) {
+        KDTree< 3, num::Vector3D<double> > kdTree(
+          inPoints.begin(), inPoints.end(), leafSizes[jj]);
+        for(size_t ii = 0; ii < 50; ++ii) {
+          num::Vector3D<double> queryPoint(pRandom.uniform(-12.0, 12.0),
+                                           pRandom.uniform(-12.0, 12.0),
+                                           pRandom.uniform(-12.0, 12.0));
+          std::vector<double> referenceDistances =
+            this->getSortedDistances(queryPoint, inPoints);
+          for(size_t kk = 0; kk < sizeof(kValues) / sizeof(size_t); ++kk) {
+            std::vector<num::Vector3D<double> const*> neighbors;
+            std::vector<double> distances;
+            size_t numberFound = kdTree.findKNearest(
+              queryPoint, kValues[kk], neighbors, distances);
+            size_t numberExpected = std::min(kValues[kk], inPoints.size());
+            BRICK_TEST_ASSERT(numberFound == numberExpected);
+            BRICK_TEST_ASSERT(neighbors.size() == numberExpected);
+            BRICK_TEST_ASSERT(distances.size() == numberExpected);
+            for(size_t nn = 0; nn < numberFound; ++nn) {
+              BRICK_TEST_ASSERT(
+                com::absoluteValue(distances[nn] - referenceDistances[nn])
+                < m_defaultTolerance);
+              BRICK_TEST_ASSERT(
+                com::absoluteValue(
+                  num::magnitudeSquared<double>(queryPoint - *(neighbors[nn]))
+                  - distances[nn]) < m_defaultTolerance);
+            }
+          }
+        }
+      }
+
+      // Empty trees have no neighbors.
+      KDTree< 3, num::Vector3D<double> > emptyTree;
+      std::vector<num::Vector3D<double> const*> neighbors(3);
+      std::vector<double> distances(3);
+      BRICK_TEST_ASSERT(
+        emptyTree.findKNearest(inPoints[0], 3, neighbors, distances) == 0);
+      BRICK_TEST_ASSERT(neighbors.empty());
+      BRICK_TEST_ASSERT(distances.empty());
+    }
+
+
+    void
+    KDTreeTest::
+    testFindNearestApproximate()
+    {
+      brick::random::PseudoRandom pRandom(5);
+      std::vector<Descriptor16> inPoints =
+        this->getRandomDescriptors(pRandom, 2000);
+      std::vector<Descriptor16> queryPoints =
+        this->getRandomDescriptors(pRandom, 100);
+
+      size_t leafSizes[] = {0, 8};
+      for(size_t jj = 0; jj < sizeof(leafSizes) / sizeof(size_t); ++jj) {
+        KDTree<16, Descriptor16> kdTree(
+          inPoints.begin(), inPoints.end(), leafSizes[jj]);
+        KDComparator<16, Descriptor16> comparator;
+        for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+          double exactDistance;
+          kdTree.findNearest(queryPoints[ii], exactDistance);
+
+          // With no slack and no budget, the search is exact.
+          double distance;
+          Descriptor16 const& nearest = kdTree.findNearestApproximate(
+            queryPoints[ii], distance, 0.0);
+          BRICK_TEST_ASSERT(distance == exactDistance);
+          BRICK_TEST_ASSERT(
+            comparator.computeDistance(queryPoints[ii], nearest) == distance);
+
+          // Otherwise, the error bound must hold.
+          kdTree.findNearestApproximate(queryPoints[ii], distance, 0.5);
+          BRICK_TEST_ASSERT(distance >= exactDistance);
+          BRICK_TEST_ASSERT(distance <= 1.5 * exactDistance);
+
+          // Even a single descent returns a real tree element.
+          Descriptor16 const& guess = kdTree.findNearestApproximate(
+            queryPoints[ii], distance, 0.0, 1);
+          BRICK_TEST_ASSERT(distance >= exactDistance);
+          BRICK_TEST_ASSERT(
+            comparator.computeDistance(queryPoints[ii], guess) == distance);
+          BRICK_TEST_ASSERT(kdTree.find(guess));
+        }
+
+        // Tree elements are always found exactly.
+        for(size_t ii = 0; ii < inPoints.size(); ii += 97) {
+          double distance;
+          kdTree.findNearestApproximate(inPoints[ii], distance, 1.0, 1);
+          BRICK_TEST_ASSERT(distance == 0.0);
+        }
+      }
+
+      KDTree<16, Descriptor16> emptyTree;
+      double distance;
+      emptyTree.findNearestApproximate(inPoints[0], distance, 1.0, 10);
+      BRICK_TEST_ASSERT(distance == std::numeric_limits<double>::max());
+    }
+
+
+    void
+    KDTreeTest::
+    testFindKNearest__batch()
+    {
+      brick::random::PseudoRandom pRandom(3);
+      std::vector< num::Vector3D<double> > inPoints =
+        this->getRandomPoints(pRandom, 2000, 10.0);
+      std::vector< num::Vector3D<double> > queryPoints =
+        this->getRandomPoints(pRandom, 301, 12.0);
+      KDTree< 3, num::Vector3D<double> > kdTree(
+        inPoints.begin(), inPoints.end());
+      com::ThreadPool threadPool(4);
+
+      // Batch nearest neighbor queries must match the single query
+      // interface exactly, whether or not they run in parallel.
+      std::vector<num::Vector3D<double> const*> nearestPoints;
+      std::vector<num::Vector3D<double> const*> parallelNearestPoints;
+      std::vector<double> distances;
+      std::vector<double> parallelDistances;
+      kdTree.findNearest(queryPoints.begin(), queryPoints.end(),
+                         nearestPoints, distances);
+      kdTree.findNearest(queryPoints.begin(), queryPoints.end(),
+                         parallelNearestPoints, parallelDistances,
+                         threadPool);
+      BRICK_TEST_ASSERT(nearestPoints.size() == queryPoints.size());
+      BRICK_TEST_ASSERT(distances.size() == queryPoints.size());
+      BRICK_TEST_ASSERT(nearestPoints == parallelNearestPoints);
+      BRICK_TEST_ASSERT(distances == parallelDistances);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        double distance;
+        num::Vector3D<double> const& nearest =
+          kdTree.findNearest(queryPoints[ii], distance);
+        BRICK_TEST_ASSERT(nearestPoints[ii] == &nearest);
+        BRICK_TEST_ASSERT(distances[ii] == distance);
+      }
+
+      // Batch kNN results are laid out one row per query, and padded
+      // if the tree is too small.
+      size_t const kk = 7;
+      std::vector<num::Vector3D<double> const*> neighbors;
+      std::vector<num::Vector3D<double> const*> parallelNeighbors;
+      kdTree.findKNearest(queryPoints.begin(), queryPoints.end(), kk,
+                          neighbors, distances);
+      kdTree.findKNearest(queryPoints.begin(), queryPoints.end(), kk,
+                          parallelNeighbors, parallelDistances, threadPool);
+      BRICK_TEST_ASSERT(neighbors.size() == queryPoints.size() * kk);
+      BRICK_TEST_ASSERT(neighbors == parallelNeighbors);
+      BRICK_TEST_ASSERT(distances == parallelDistances);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        std::vector<num::Vector3D<double> const*> singleNeighbors;
+        std::vector<double> singleDistances;
+        kdTree.findKNearest(queryPoints[ii], kk, singleNeighbors,
+                            singleDistances);
+        for(size_t nn = 0; nn < kk; ++nn) {
+          BRICK_TEST_ASSERT(neighbors[ii * kk + nn] == singleNeighbors[nn]);
+          BRICK_TEST_ASSERT(distances[ii * kk + nn] == singleDistances[nn]);
+        }
+      }
+
+      KDTree< 3, num::Vector3D<double> > smallTree(
+        inPoints.begin(), inPoints.begin() + 3);
+      smallTree.findKNearest(queryPoints.begin(), queryPoints.begin() + 2, 5,
+                             neighbors, distances, threadPool);
+      BRICK_TEST_ASSERT(neighbors.size() == 10);
+      for(size_t ii = 0; ii < 2; ++ii) {
+        for(size_t nn = 0; nn < 5; ++nn) {
+          BRICK_TEST_ASSERT((neighbors[ii * 5 + nn] == 0) == (nn >= 3));
+          BRICK_TEST_ASSERT(
+            (distances[ii * 5 + nn] == std::numeric_limits<double>::max())
+            == (nn >= 3));
+        }
+      }
+    }
+
+
+    void
+    KDTreeTest::
+    testFindWithinRadius()
+    {
+      brick::random::PseudoRandom pRandom(4);
+      std::vector< num::Vector3D<double> > inPoints =
+        this->getRandomPoints(pRandom, 1000, 10.0);
+
+      size_t leafSizes[] = {0, 1, 8, 2000};
+      double radii[] = {0.0, 0.5, 2.0, 5.0, 100.0};
+      for(size_t jj = 0; jj < sizeof(leafSizes) / sizeof(size_t); ++jj) {
+        KDTree< 3, num::Vector3D<double> > kdTree(
+          inPoints.begin(), inPoints.end(), leafSizes[jj]);
+        for(size_t ii = 0; ii < 30; ++ii) {
+          // Querying at a tree point checks the inclusive boundary.
+          num::Vector3D<double> queryPoint = inPoints[ii * 31];
+          if(ii % 2 != 0) {
+            queryPoint.setValue(pRandom.uniform(-12.0, 12.0),
+                                pRandom.uniform(-12.0, 12.0),
+                                pRandom.uniform(-12.0, 12.0));
+          }
+          std::vector<double> referenceDistances =
+            this->getSortedDistances(queryPoint, inPoints);
+          for(size_t rr = 0; rr < sizeof(radii) / sizeof(double); ++rr) {
+            double maximumDistance = radii[rr] * radii[rr];
+            std::vector<num::Vector3D<double> const*> neighbors;
+            std::vector<double> distances;
+            size_t numberFound = kdTree.findWithinRadius(
+              queryPoint, maximumDistance, neighbors, distances);
+            size_t numberExpected =
+              std::upper_bound(referenceDistances.begin(),
+                               referenceDistances.end(), maximumDistance)
+              - referenceDistances.begin();
+            BRICK_TEST_ASSERT(numberFound == numberExpected);
+            BRICK_TEST_ASSERT(neighbors.size() == numberExpected);
+            BRICK_TEST_ASSERT(distances.size() == numberExpected);
+            for(size_t nn = 0; nn < numberFound; ++nn) {
+              BRICK_TEST_ASSERT(distances[nn] <= maximumDistance);
+              BRICK_TEST_ASSERT(
+                num::magnitudeSquared<double>(queryPoint - *(neighbors[nn]))
+                == distances[nn]);
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            BRICK_TEST_ASSERT(
+              std::unique(neighbors.begin(), neighbors.end())
+              == neighbors.end());
+          }
+        }
+      }
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    KDTreeTest::
+    timeConstruction()
+    {
+      // Roughly the size of a dense ICP model cloud.
+      brick::random::PseudoRandom pRandom(1);
+      std::vector< num::Vector3D<double> > inPoints(500000);
+      for(size_t ii = 0; ii < inPoints.size(); ++ii) {
+        inPoints[ii].setValue(pRandom.uniform(-10.0, 10.0),
+                              pRandom.uniform(-10.0, 10.0),
+                              pRandom.uniform(-10.0, 10.0));
+      }
+      std::vector< num::Vector3D<double> > queryPoints(100000);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        queryPoints[ii].setValue(pRandom.uniform(-10.0, 10.0),
+                                 pRandom.uniform(-10.0, 10.0),
+                                 pRandom.uniform(-10.0, 10.0));
+      }
+
+      size_t leafSizes[] = {1, 4, 8, 16, 32};
+      for(size_t jj = 0; jj < sizeof(leafSizes) / sizeof(size_t); ++jj) {
+        double t0 = utilities::getCurrentTime();
+        KDTree< 3, num::Vector3D<double> > kdTree(
+          inPoints.begin(), inPoints.end(), leafSizes[jj]);
+        double t1 = utilities::getCurrentTime();
+        double checkSum = 0.0;
+        for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+          double distance;
+          kdTree.findNearest(queryPoints[ii], distance);
+          checkSum += distance;
+        }
+        double t2 = utilities::getCurrentTime();
+        std::cout << "\nLeaf size " << leafSizes[jj] << ": ET for building "
+                  << inPoints.size() << " point tree: " << (t1 - t0)
+                  << ", for " << queryPoints.size() << " queries: "
+                  << (t2 - t1) << " (" << checkSum << ")" << std::endl;
+      }
+    }
+
+
+
+    void
+    KDTreeTest::
+    timeFindNearestApproximate()
+    {
+      // Descriptor matching: queries are noisy copies of tree points.
+      brick::random::PseudoRandom pRandom(1);
+      std::vector<Descriptor16> inPoints =
+        this->getRandomDescriptors(pRandom, 100000);
+      std::vector<Descriptor16> queryPoints(10000);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        queryPoints[ii] = inPoints[pRandom.uniformInt(0, 100000)];
+        for(size_t jj = 0; jj < 16; ++jj) {
+          queryPoints[ii].values[jj] += pRandom.normal() * 10.0;
+        }
+      }
+      KDTree<16, Descriptor16> kdTree(inPoints.begin(), inPoints.end());
+
+      std::vector<double> exactDistances(queryPoints.size());
+      double t0 = utilities::getCurrentTime();
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        kdTree.findNearest(queryPoints[ii], exactDistances[ii]);
+      }
+      double t1 = utilities::getCurrentTime();
+      std::cout << "\nExact: ET for " << queryPoints.size() << " queries: "
+                << (t1 - t0) << std::endl;
+
+      double epsilons[] = {0.0, 0.5, 2.0};
+      size_t budgets[] = {1, 4, 16, 64, 256, 0};
+      for(size_t ee = 0; ee < sizeof(epsilons) / sizeof(double); ++ee) {
+        for(size_t bb = 0; bb < sizeof(budgets) / sizeof(size_t); ++bb) {
+          if(epsilons[ee] == 0.0 && budgets[bb] == 0) {
+            continue;
+          }
+          size_t numberCorrect = 0;
+          t0 = utilities::getCurrentTime();
+          for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+            double distance;
+            kdTree.findNearestApproximate(
+              queryPoints[ii], distance, epsilons[ee], budgets[bb]);
+            if(distance == exactDistances[ii]) {
+              ++numberCorrect;
+            }
+          }
+          t1 = utilities::getCurrentTime();
+          std::cout << "Epsilon " << epsilons[ee] << ", leaf visits "
+                    << budgets[bb] << ": ET " << (t1 - t0) << ", recall "
+                    << (double(numberCorrect) / queryPoints.size())
+                    << std::endl;
+        }
+      }
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
+    std::vector<double>
+    KDTreeTest::
+    getSortedDistances(
+      num::Vector3D<double> const& point,
+      std::vector< num::Vector3D<double> > const& candidateVector)
+    {
+      std::vector<double> distances(candidateVector.size());
+      for(size_t ii = 0; ii < candidateVector.size(); ++ii) {
+        distances[ii] =
+          num::magnitudeSquared<double>(point - candidateVector[ii]);
+      }
+      std::sort(distances.begin(), distances.end());
+      return distances;
+    }
+
+
+    std::vector< num::Vector3D<double> >
+    KDTreeTest::
+    getRandomPoints(brick::random::PseudoRandom& pRandom,
+                    size_t numberOfPoints, double range)
+    {
+      std::vector< num::Vector3D<double> > points(numberOfPoints);
+      for(size_t ii = 0; ii < numberOfPoints; ++ii) {
+        points[ii].setValue(pRandom.uniform(-range, range),
+                            pRandom.uniform(-range, range),
+                            pRandom.uniform(-range, range));
+      }
+      return points;
+    }
+
+
+    std::vector<Descriptor16>
+    KDTreeTest::
+    getRandomDescriptors(brick::random::PseudoRandom& pRandom,
+                         size_t numberOfDescriptors)
+    {
+      // Descriptors cluster around a handful of centers, as real
+      // image patches tend to.
+      std::vector<Descriptor16> centers(32);
+      for(size_t ii = 0; ii < centers.size(); ++ii) {
+        for(size_t jj = 0; jj < 16; ++jj) {
+          centers[ii].values[jj] = pRandom.uniform(0.0, 255.0);
+        }
+      }
+      std::vector<Descriptor16> descriptors(numberOfDescriptors);
+      for(size_t ii = 0; ii < numberOfDescriptors; ++ii) {
+        Descriptor16 const& center =
+          centers[pRandom.uniformInt(0, int(centers.size()))];
+        for(size_t jj = 0; jj < 16; ++jj) {
+          descriptors[ii].values[jj] =
+            center.values[jj] + pRandom.normal() * 30.0;
+        }
+      }
+      return descriptors;
+    }
+
+
     num::Vector3D<double> const&
     KDTreeTest::
     findNearest(num::Vector3D<double> const& point,
@@ -0,0 +1,537 @@
+/**
+***************************************************************************
+* @file brick/computerVision/test/keypointBudgetTest.cc
+*
+* Source file defining tests for the KeypointBudget class and the
+* keypoint selection functions that it uses.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <brick/computerVision/keypointBudget.hh>
+#include <brick/computerVision/keypointSelectorLepetit.hh>
+#include <brick/numeric/index2D.hh>
+#include <brick/random/pseudoRandom.hh>
+#include <brick/test/testFixture.hh>
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+namespace brick {
+
+  namespace computerVision {
+
+    class KeypointBudgetTest
+      : public brick::test::TestFixture<KeypointBudgetTest> {
+
+    public:
+
+      // Minimal keypoint type for testing.  The id member lets us
+      // check which keypoints survived.
+      struct TestKeypoint {
+        double row;
+        double column;
+        unsigned int id;
+      };
+
+
+      KeypointBudgetTest();
+      ~KeypointBudgetTest() {}
+
+      void setUp(const std::string& /* testName */) {}
+      void tearDown(const std::string& /* testName */) {}
+
+      // Tests.
+      void testKeypointBudget();
+      void testKeypointSelectorLepetit();
+      void testSelectKeypointsAnms();
+      void testSelectKeypointsAnms__random();
+      void testSelectKeypointsByGrid();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      void timeSelectKeypoints();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+    private:
+
+      // Make a tight cluster of high scoring keypoints in one corner
+      // of a sparse lattice of low scoring keypoints.
+      void
+      getClusteredKeypoints(std::vector<TestKeypoint>& keypoints,
+                            std::vector<double>& scores,
+                            unsigned int clusterSize,
+                            unsigned int latticeRows,
+                            unsigned int latticeColumns);
+
+      // Smallest distance between any two keypoints.
+      double
+      getMinimumSeparation(std::vector<TestKeypoint> const& keypoints);
+
+      // Make uniformly distributed keypoints with random scores.
+      void
+      getRandomKeypoints(random::PseudoRandom& pRandom,
+                         std::vector<TestKeypoint>& keypoints,
+                         std::vector<double>& scores,
+                         unsigned int numberOfKeypoints,
+                         double rows, double columns);
+
+      // Check that output is an in-order subsequence of input.
+      bool
+      isOrderedSubset(std::vector<TestKeypoint> const& output,
+                      std::vector<TestKeypoint> const& input);
+
+    }; // class KeypointBudgetTest
+
+
+    /* ============== Member Function Definititions ============== */
+
+    KeypointBudgetTest::
+    KeypointBudgetTest()
+      : brick::test::TestFixture<KeypointBudgetTest>("KeypointBudgetTest")
+    {
+      BRICK_TEST_REGISTER_MEMBER(testKeypointBudget);
+      BRICK_TEST_REGISTER_MEMBER(testKeypointSelectorLepetit);
+      BRICK_TEST_REGISTER_MEMBER(testSelectKeypointsAnms);
+      BRICK_TEST_REGISTER_MEMBER(testSelectKeypointsAnms__random);
+      BRICK_TEST_REGISTER_MEMBER(testSelectKeypointsByGrid);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeSelectKeypoints);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+    }
+
+
+    void
+    KeypointBudgetTest::
+    testKeypointBudget()
+    {
+      std::vector<TestKeypoint> referenceKeypoints;
+      std::vector<double> scores;
+      this->getClusteredKeypoints(referenceKeypoints, scores, 50, 4, 5);
+
+      // Default constructed budgets keep everything.
+      KeypointBudget unlimitedBudget;
+      BRICK_TEST_ASSERT(!unlimitedBudget.isLimited());
+      BRICK_TEST_ASSERT(unlimitedBudget.getNumberOfKeypoints() == 0);
+      std::vector<TestKeypoint> keypoints = referenceKeypoints;
+      unlimitedBudget.apply(keypoints, scores);
+      BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+
+      // Each strategy should match the corresponding free function.
+      KeypointBudget anmsBudget(21);
+      BRICK_TEST_ASSERT(anmsBudget.isLimited());
+      BRICK_TEST_ASSERT(anmsBudget.getStrategy()
+                        == BRICK_CV_KEYPOINT_BUDGET_ANMS);
+      keypoints = referenceKeypoints;
+      anmsBudget.apply(keypoints, scores);
+      std::vector<TestKeypoint> expectedKeypoints = referenceKeypoints;
+      selectKeypointsAnms(expectedKeypoints, scores, 21);
+      BRICK_TEST_ASSERT(keypoints.size() == expectedKeypoints.size());
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        BRICK_TEST_ASSERT(keypoints[ii].id == expectedKeypoints[ii].id);
+      }
+
+      KeypointBudget gridBudget(12, BRICK_CV_KEYPOINT_BUDGET_GRID, 2, 3);
+      BRICK_TEST_ASSERT(gridBudget.getStrategy()
+                        == BRICK_CV_KEYPOINT_BUDGET_GRID);
+      keypoints = referenceKeypoints;
+      gridBudget.apply(keypoints, scores);
+      expectedKeypoints = referenceKeypoints;
+      selectKeypointsByGrid(expectedKeypoints, scores, 12, 2, 3);
+      BRICK_TEST_ASSERT(keypoints.size() == expectedKeypoints.size());
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        BRICK_TEST_ASSERT(keypoints[ii].id == expectedKeypoints[ii].id);
+      }
+
+      // Index2D keypoints, as reported by KeypointSelectorLepetit,
+      // should work too.
+      std::vector<numeric::Index2D> indices;
+      for(unsigned int ii = 0; ii < referenceKeypoints.size(); ++ii) {
+        indices.push_back(numeric::Index2D(
+                            static_cast<int>(referenceKeypoints[ii].row),
+                            static_cast<int>(referenceKeypoints[ii].column)));
+      }
+      anmsBudget.apply(indices, scores);
+      BRICK_TEST_ASSERT(indices.size() == 21);
+
+      // Bad arguments.
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::ValueException,
+        KeypointBudget(10, BRICK_CV_KEYPOINT_BUDGET_GRID, 0, 3));
+      keypoints = referenceKeypoints;
+      scores.pop_back();
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  anmsBudget.apply(keypoints, scores));
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  gridBudget.apply(keypoints, scores));
+    }
+
+
+    void
+    KeypointBudgetTest::
+    testKeypointSelectorLepetit()
+    {
+      // Random texture gives lots of keypoints at every pyramid level.
+      random::PseudoRandom pRandom(23);
+      Image<GRAY8> inputImage(120, 160);
+      for(unsigned int ii = 0; ii < inputImage.size(); ++ii) {
+        inputImage[ii] = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+      }
+
+      KeypointSelectorLepetit selector;
+      selector.setImage(inputImage);
+      const std::vector<numeric::Index2D> allKeypoints =
+        selector.getKeypoints();
+      const unsigned int numberOfKeypoints = 25;
+      BRICK_TEST_ASSERT(allKeypoints.size() > 2 * numberOfKeypoints);
+
+      // Budgeted keypoints should be a subset of the unbudgeted ones,
+      // in the same order.
+      KeypointBudget anmsBudget(numberOfKeypoints);
+      KeypointBudget gridBudget(
+        numberOfKeypoints, BRICK_CV_KEYPOINT_BUDGET_GRID, 3, 4);
+      KeypointBudget budgets[] = {anmsBudget, gridBudget};
+      for(unsigned int ii = 0; ii < 2; ++ii) {
+        selector.setKeypointBudget(budgets[ii]);
+        selector.setImage(inputImage);
+        std::vector<numeric::Index2D> keypoints = selector.getKeypoints();
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+        std::vector<numeric::Index2D>::const_iterator searchIter =
+          allKeypoints.begin();
+        for(unsigned int jj = 0; jj < keypoints.size(); ++jj) {
+          searchIter = std::find(
+            searchIter, allKeypoints.end(), keypoints[jj]);
+          BRICK_TEST_ASSERT(searchIter != allKeypoints.end());
+          ++searchIter;
+        }
+      }
+
+      // A default-constructed budget removes the limit.
+      selector.setKeypointBudget(KeypointBudget());
+      selector.setImage(inputImage);
+      BRICK_TEST_ASSERT(selector.getKeypoints().size() == allKeypoints.size());
+    }
+
+
+    void
+    KeypointBudgetTest::
+    testSelectKeypointsAnms()
+    {
+      const unsigned int clusterSize = 200;
+      const unsigned int latticeRows = 4;
+      const unsigned int latticeColumns = 5;
+      std::vector<TestKeypoint> referenceKeypoints;
+      std::vector<double> scores;
+      this->getClusteredKeypoints(referenceKeypoints, scores, clusterSize,
+                                  latticeRows, latticeColumns);
+
+      // A simple top-k selection would keep only the cluster.  ANMS
+      // should keep the strongest keypoint of the cluster, plus
+      // every lattice point and the corner point.
+      unsigned int numberOfKeypoints = latticeRows * latticeColumns + 2;
+      std::vector<TestKeypoint> keypoints = referenceKeypoints;
+      selectKeypointsAnms(keypoints, scores, numberOfKeypoints);
+      BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+      BRICK_TEST_ASSERT(this->isOrderedSubset(keypoints, referenceKeypoints));
+      BRICK_TEST_ASSERT(keypoints[0].id == 0);
+      for(unsigned int ii = 1; ii < keypoints.size(); ++ii) {
+        BRICK_TEST_ASSERT(keypoints[ii].id == clusterSize + ii - 1);
+      }
+
+      // Asking for more keypoints than there are should change
+      // nothing, and asking for none should remove all of them.
+      keypoints = referenceKeypoints;
+      selectKeypointsAnms(keypoints, scores, referenceKeypoints.size());
+      BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+      selectKeypointsAnms(keypoints, scores, 0);
+      BRICK_TEST_ASSERT(keypoints.empty());
+
+      // Every keypoint in the same place.  No radius can separate
+      // them, so we should fall back to the best scores.
+      std::vector<TestKeypoint> stackedKeypoints(100);
+      std::vector<double> stackedScores(100);
+      for(unsigned int ii = 0; ii < stackedKeypoints.size(); ++ii) {
+        stackedKeypoints[ii].row = 7.0;
+        stackedKeypoints[ii].column = 11.0;
+        stackedKeypoints[ii].id = ii;
+        stackedScores[ii] = static_cast<double>(ii % 10);
+      }
+      selectKeypointsAnms(stackedKeypoints, stackedScores, 10);
+      BRICK_TEST_ASSERT(stackedKeypoints.size() == 10);
+      for(unsigned int ii = 0; ii < stackedKeypoints.size(); ++ii) {
+        BRICK_TEST_ASSERT(stackedKeypoints[ii].id == 10 * ii + 9);
+      }
+    }
+
+
+    void
+    KeypointBudgetTest::
+    testSelectKeypointsAnms__random()
+    {
+      random::PseudoRandom pRandom(17);
+      for(unsigned int trial = 0; trial < 10; ++trial) {
+        std::vector<TestKeypoint> referenceKeypoints;
+        std::vector<double> scores;
+        this->getRandomKeypoints(pRandom, referenceKeypoints, scores,
+                                 2000, 480.0, 640.0);
+        unsigned int numberOfKeypoints = 50 + 25 * trial;
+
+        std::vector<TestKeypoint> keypoints = referenceKeypoints;
+        selectKeypointsAnms(keypoints, scores, numberOfKeypoints);
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+        BRICK_TEST_ASSERT(
+          this->isOrderedSubset(keypoints, referenceKeypoints));
+
+        // The selected keypoints should be much better spread out
+        // than the same number of top scoring keypoints.
+        std::vector<TestKeypoint> bestKeypoints;
+        std::vector<double> sortedScores = scores;
+        std::sort(sortedScores.begin(), sortedScores.end());
+        double scoreThreshold =
+          sortedScores[sortedScores.size() - numberOfKeypoints];
+        for(unsigned int ii = 0; ii < referenceKeypoints.size(); ++ii) {
+          if(scores[ii] >= scoreThreshold) {
+            bestKeypoints.push_back(referenceKeypoints[ii]);
+          }
+        }
+        BRICK_TEST_ASSERT(this->getMinimumSeparation(keypoints)
+                          > 2.0 * this->getMinimumSeparation(bestKeypoints));
+
+        // Grid selection should at least get the count right.
+        keypoints = referenceKeypoints;
+        selectKeypointsByGrid(keypoints, scores, numberOfKeypoints, 6, 8);
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+        BRICK_TEST_ASSERT(
+          this->isOrderedSubset(keypoints, referenceKeypoints));
+      }
+    }
+
+
+    void
+    KeypointBudgetTest::
+    testSelectKeypointsByGrid()
+    {
+      const unsigned int clusterSize = 100;
+      const unsigned int latticeRows = 4;
+      const unsigned int latticeColumns = 5;
+      std::vector<TestKeypoint> referenceKeypoints;
+      std::vector<double> scores;
+      this->getClusteredKeypoints(referenceKeypoints, scores, clusterSize,
+                                  latticeRows, latticeColumns);
+
+      // With one cell per lattice point, each cell gets one
+      // keypoint.  The cluster shares its cell with the first
+      // lattice point, and wins because its scores are higher.
+      unsigned int numberOfKeypoints = latticeRows * latticeColumns;
+      std::vector<TestKeypoint> keypoints = referenceKeypoints;
+      selectKeypointsByGrid(keypoints, scores, numberOfKeypoints,
+                            latticeRows, latticeColumns);
+      BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+      BRICK_TEST_ASSERT(this->isOrderedSubset(keypoints, referenceKeypoints));
+      BRICK_TEST_ASSERT(keypoints[0].id == 0);
+      for(unsigned int ii = 1; ii < keypoints.size(); ++ii) {
+        BRICK_TEST_ASSERT(keypoints[ii].id == clusterSize + ii);
+      }
+
+      // Once each cell has contributed its best keypoint, the
+      // remainder of the budget goes to second-best keypoints.  Only
+      // the cluster's cell and the corner point's cell have any of
+      // those.  After that come the third-best keypoints, and only
+      // the cluster's cell has any of those.
+      keypoints = referenceKeypoints;
+      selectKeypointsByGrid(keypoints, scores, numberOfKeypoints + 3,
+                            latticeRows, latticeColumns);
+      BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints + 3);
+      for(unsigned int ii = 0; ii < 3; ++ii) {
+        BRICK_TEST_ASSERT(keypoints[ii].id == ii);
+      }
+      BRICK_TEST_ASSERT(keypoints.back().id == referenceKeypoints.back().id);
+
+      // Degenerate arguments.
+      keypoints = referenceKeypoints;
+      selectKeypointsByGrid(keypoints, scores, referenceKeypoints.size(),
+                            latticeRows, latticeColumns);
+      BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+      selectKeypointsByGrid(keypoints, scores, 0, latticeRows, latticeColumns);
+      BRICK_TEST_ASSERT(keypoints.empty());
+      keypoints = referenceKeypoints;
+      BRICK_TEST_ASSERT_EXCEPTION(
+        common::ValueException,
+        selectKeypointsByGrid(keypoints, scores, 10, 0, latticeColumns));
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    KeypointBudgetTest::
+    timeSelectKeypoints()
+    {
+      const unsigned int numberOfTrials = 20;
+      random::PseudoRandom pRandom(1);
+      std::vector<TestKeypoint> referenceKeypoints;
+      std::vector<double> scores;
+      this->getRandomKeypoints(pRandom, referenceKeypoints, scores,
+                               50000, 1080.0, 1920.0);
+
+      double time0 = utilities::getCurrentTime();
+      std::vector<TestKeypoint> keypoints;
+      for(unsigned int ii = 0; ii < numberOfTrials; ++ii) {
+        keypoints = referenceKeypoints;
+        selectKeypointsAnms(keypoints, scores, 1000);
+      }
+      double time1 = utilities::getCurrentTime();
+      for(unsigned int ii = 0; ii < numberOfTrials; ++ii) {
+        keypoints = referenceKeypoints;
+        selectKeypointsByGrid(keypoints, scores, 1000, 16, 16);
+      }
+      double time2 = utilities::getCurrentTime();
+      std::cout << "\nSelecting 1000 of " << referenceKeypoints.size()
+                << " keypoints: ANMS "
+                << 1000.0 * (time1 - time0) / numberOfTrials
+                << " ms, grid "
+                << 1000.0 * (time2 - time1) / numberOfTrials
+                << " ms." << std::endl;
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
+    void
+    KeypointBudgetTest::
+    getClusteredKeypoints(std::vector<TestKeypoint>& keypoints,
+                          std::vector<double>& scores,
+                          unsigned int clusterSize,
+                          unsigned int latticeRows,
+                          unsigned int latticeColumns)
+    {
+      const double latticeSpacing = 100.0;
+      keypoints.clear();
+      scores.clear();
+
+      // The cluster has scores 1000, 999, 998...
+      for(unsigned int ii = 0; ii < clusterSize; ++ii) {
+        TestKeypoint keypoint;
+        keypoint.row = 5.0 + 0.1 * (ii % 10);
+        keypoint.column = 5.0 + 0.1 * (ii / 10);
+        keypoint.id = keypoints.size();
+        keypoints.push_back(keypoint);
+        scores.push_back(1000.0 - ii);
+      }
+
+      // Lattice points all have score 1, and are centered in the
+      // cells of a latticeRows x latticeColumns grid.
+      for(unsigned int row = 0; row < latticeRows; ++row) {
+        for(unsigned int column = 0; column < latticeColumns; ++column) {
+          TestKeypoint keypoint;
+          keypoint.row = latticeSpacing * (row + 0.5);
+          keypoint.column = latticeSpacing * (column + 0.5);
+          keypoint.id = keypoints.size();
+          keypoints.push_back(keypoint);
+          scores.push_back(1.0);
+        }
+      }
+
+      // Stretch the bounding box to a whole number of grid cells.
+      TestKeypoint corner;
+      corner.row = latticeSpacing * latticeRows;
+      corner.column = latticeSpacing * latticeColumns;
+      corner.id = keypoints.size();
+      keypoints.push_back(corner);
+      scores.push_back(0.0);
+    }
+
+
+    double
+    KeypointBudgetTest::
+    getMinimumSeparation(std::vector<TestKeypoint> const& keypoints)
+    {
+      double minimumSeparation = std::numeric_limits<double>::max();
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        for(unsigned int jj = ii + 1; jj < keypoints.size(); ++jj) {
+          double rowDistance = keypoints[ii].row - keypoints[jj].row;
+          double columnDistance = keypoints[ii].column - keypoints[jj].column;
+          minimumSeparation = std::min(
+            minimumSeparation,
+            std::sqrt(rowDistance * rowDistance
+                      + columnDistance * columnDistance));
+        }
+      }
+      return minimumSeparation;
+    }
+
+
+    void
+    KeypointBudgetTest::
+    getRandomKeypoints(random::PseudoRandom& pRandom,
+                       std::vector<TestKeypoint>& keypoints,
+                       std::vector<double>& scores,
+                       unsigned int numberOfKeypoints,
+                       double rows, double columns)
+    {
+      keypoints.resize(numberOfKeypoints);
+      scores.resize(numberOfKeypoints);
+      for(unsigned int ii = 0; ii < numberOfKeypoints; ++ii) {
+        keypoints[ii].row = pRandom.uniform(0.0, rows);
+        keypoints[ii].column = pRandom.uniform(0.0, columns);
+        keypoints[ii].id = ii;
+        scores[ii] = pRandom.uniform(0.0, 1.0);
+      }
+    }
+
+
+    bool
+    KeypointBudgetTest::
+    isOrderedSubset(std::vector<TestKeypoint> const& output,
+                    std::vector<TestKeypoint> const& input)
+    {
+      unsigned int inputIndex = 0;
+      for(unsigned int ii = 0; ii < output.size(); ++ii) {
+        while(inputIndex < input.size()
+              && input[inputIndex].id != output[ii].id) {
+          ++inputIndex;
+        }
+        if(inputIndex == input.size()) {
+          return false;
+        }
+        ++inputIndex;
+      }
+      return true;
+    }
+
+  } // namespace computerVision
+
+} // namespace brick
+
+
+#if 0
+
+int main(int argc, char** argv)
+{
+  brick::computerVision::KeypointBudgetTest currentTest;
+  bool result = currentTest.run();
+  return (result ? 0 : 1);
+}
+
+#else
+
+namespace {
+
+  brick::computerVision::KeypointBudgetTest currentTest;
+
+}
+
+#endif
@@ -10,10 +10,25 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <brick/common/threadPool.hh>
 #include <brick/computerVision/keypointMatcherFast.hh>
-
+#include <brick/numeric/simdKernels.hh>
+#include <brick/random/pseudoRandom.hh>
+#include <brick/test/functors.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_COMPUTERVISION_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
 namespace brick {
 
   namespace computerVision {
@@ -26,22 +41,46 @@ namespace brick {
       KeypointMatcherFastTest();
       ~KeypointMatcherFastTest() {}
 
-      void setUp(const std::string& /* testName */) {}
-      void tearDown(const std::string& /* testName */) {}
+      void setUp(const std::string& /* testName */) {
+        m_savedSimdLevel = numeric::getSimdLevel();
+      }
+      void tearDown(const std::string& /* testName */) {
+        numeric::setSimdLevel(m_savedSimdLevel);
+      }
 
       // Tests.
       void testKeypointMatcherFast();
       void testKeypointMatcherFastRotationInvariant();
       void testKeypointMatcherFastRotationInvariant2();
+      void testMatchKeypoints();
+      void testMatchKeypointsBruteForce();
+      void testSetKeypoints__duplicateMeans();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      void timeMatchKeypoints();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
     private:
 
+      // Straightforward rotation invariant SSD, for checking the
+      // matcher's results.
+      double
+      computeReferenceSSD(KeypointFast const& keypoint0,
+                          KeypointFast const& keypoint1,
+                          unsigned int numberOfShifts);
+
       // Generate test input.
       void
       generateKeypointVectors(std::vector<KeypointFast>& keypoints,
                               std::vector<KeypointFast>& queryPoints);
 
+      // Generate keypoints with uniformly distributed feature vectors.
+      std::vector<KeypointFast>
+      getRandomKeypoints(brick::random::PseudoRandom& pRandom,
+                         size_t numberOfKeypoints);
+
       double m_defaultTolerance;
+      numeric::SimdLevel m_savedSimdLevel;
 
     }; // class KeypointMatcherFastTest
 
@@ -51,11 +90,19 @@ namespace brick {
     KeypointMatcherFastTest::
     KeypointMatcherFastTest()
       : brick::test::TestFixture<KeypointMatcherFastTest>("KeypointMatcherFastTest"),
-        m_defaultTolerance(1.0E-8)
+        m_defaultTolerance(1.0E-8),
+        m_savedSimdLevel(numeric::BRICK_SIMD_NONE)
     {
       BRICK_TEST_REGISTER_MEMBER(testKeypointMatcherFast);
       BRICK_TEST_REGISTER_MEMBER(testKeypointMatcherFastRotationInvariant);
       BRICK_TEST_REGISTER_MEMBER(testKeypointMatcherFastRotationInvariant2);
+      BRICK_TEST_REGISTER_MEMBER(testMatchKeypoints);
+      BRICK_TEST_REGISTER_MEMBER(testMatchKeypointsBruteForce);
+      BRICK_TEST_REGISTER_MEMBER(testSetKeypoints__duplicateMeans);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeMatchKeypoints);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -193,6 +240,349 @@ namespace brick {
     }
 
 
+    void
+    KeypointMatcherFastTest::
+    testMatchKeypoints()
+    {
+      // Half of the queries are noisy copies of stored keypoints, and
+      // the rest are unrelated.
+      brick::random::PseudoRandom pRandom(2);
+      std::vector<KeypointFast> keypoints = this->getRandomKeypoints(
+        pRandom, 300);
+      std::vector<KeypointFast> queryPoints = this->getRandomKeypoints(
+        pRandom, 200);
+      for(size_t ii = 0; ii < queryPoints.size() / 2; ++ii) {
+        queryPoints[ii] = keypoints[(ii * 7) % keypoints.size()];
+        for(unsigned int jj = 0; jj < 16; ++jj) {
+          int value = (queryPoints[ii].featureVector[jj]
+                       + pRandom.uniformInt(-20, 21));
+          queryPoints[ii].featureVector[jj] =
+            static_cast<common::UnsignedInt8>(
+              std::max(0, std::min(255, value)));
+        }
+      }
+
+      // Exhaustively compute reference results.
+      unsigned int const numberOfShifts = 2;
+      double const maximumSsd = std::numeric_limits<double>::max();
+      std::vector<double> bestSsds(queryPoints.size(), maximumSsd);
+      std::vector<double> secondSsds(queryPoints.size(), maximumSsd);
+      std::vector<size_t> bestIndices(queryPoints.size(), 0);
+      std::vector<double> reverseSsds(keypoints.size(), maximumSsd);
+      std::vector<size_t> reverseQueries(keypoints.size(), 0);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        for(size_t jj = 0; jj < keypoints.size(); ++jj) {
+          if(keypoints[jj].isPositive != queryPoints[ii].isPositive) {
+            continue;
+          }
+          double ssd = this->computeReferenceSSD(
+            queryPoints[ii], keypoints[jj], numberOfShifts);
+          if(ssd < bestSsds[ii]) {
+            secondSsds[ii] = bestSsds[ii];
+            bestSsds[ii] = ssd;
+            bestIndices[ii] = jj;
+          } else if(ssd < secondSsds[ii]) {
+            secondSsds[ii] = ssd;
+          }
+          if(ssd < reverseSsds[jj]) {
+            reverseSsds[jj] = ssd;
+            reverseQueries[jj] = ii;
+          }
+        }
+      }
+
+      // Different pool sizes split the queries into different
+      // numbers of bands, which mustn't change the result.
+      brick::common::ThreadPool threadPool0(1);
+      brick::common::ThreadPool threadPool1(3);
+      brick::common::ThreadPool threadPool2(7);
+      brick::common::ThreadPool* threadPools[] = {
+        0, &threadPool0, &threadPool1, &threadPool2};
+      double maximumRatios[] = {1.0, 0.8, 0.5};
+      for(unsigned int ratioIndex = 0; ratioIndex < 3; ++ratioIndex) {
+        for(unsigned int mutualIndex = 0; mutualIndex < 2; ++mutualIndex) {
+          double maximumRatio = maximumRatios[ratioIndex];
+          bool isMutualCheckRequired = (mutualIndex == 1);
+
+          std::vector<KeypointMatchFast> referenceMatches;
+          for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+            double ratio = std::sqrt(bestSsds[ii] / secondSsds[ii]);
+            if(ratio > maximumRatio) {
+              continue;
+            }
+            if(isMutualCheckRequired
+               && reverseQueries[bestIndices[ii]] != ii) {
+              continue;
+            }
+            KeypointMatchFast match;
+            match.queryIndex = ii;
+            match.keypointIndex = bestIndices[ii];
+            match.ssd = bestSsds[ii];
+            match.ratio = ratio;
+            referenceMatches.push_back(match);
+          }
+
+          // The matcher shouldn't care about the order in which the
+          // stored keypoints are sorted internally.  With only two
+          // allowed shifts, the expected rotation is less than
+          // 2 / 16 of a circle.
+          KeypointMatcherFast matcher(0.7);
+          matcher.setKeypoints(keypoints.begin(), keypoints.end());
+          for(unsigned int poolIndex = 0; poolIndex < 4; ++poolIndex) {
+            std::vector<KeypointMatchFast> matches;
+            if(threadPools[poolIndex] == 0) {
+              matcher.matchKeypoints(queryPoints.begin(), queryPoints.end(),
+                                     matches, maximumRatio,
+                                     isMutualCheckRequired);
+            } else {
+              matcher.matchKeypoints(queryPoints.begin(), queryPoints.end(),
+                                     matches, maximumRatio,
+                                     isMutualCheckRequired,
+                                     *(threadPools[poolIndex]));
+            }
+            BRICK_TEST_ASSERT(matches.size() == referenceMatches.size());
+            for(size_t ii = 0; ii < matches.size(); ++ii) {
+              BRICK_TEST_ASSERT(matches[ii].queryIndex
+                                == referenceMatches[ii].queryIndex);
+              BRICK_TEST_ASSERT(matches[ii].keypointIndex
+                                == referenceMatches[ii].keypointIndex);
+              BRICK_TEST_ASSERT(matches[ii].ssd == referenceMatches[ii].ssd);
+              BRICK_TEST_ASSERT(
+                test::approximatelyEqual(
+                  matches[ii].ratio, referenceMatches[ii].ratio,
+                  m_defaultTolerance));
+            }
+          }
+        }
+      }
+
+      // Most of the noisy copies should survive both checks, and
+      // most of the unrelated queries should not.
+      KeypointMatcherFast matcher(0.7);
+      matcher.setKeypoints(keypoints.begin(), keypoints.end());
+      std::vector<KeypointMatchFast> matches;
+      matcher.matchKeypoints(queryPoints.begin(), queryPoints.end(),
+                             matches, 0.8, true);
+      size_t numberOfCorrectMatches = 0;
+      for(size_t ii = 0; ii < matches.size(); ++ii) {
+        if(matches[ii].queryIndex < queryPoints.size() / 2
+           && (matches[ii].keypointIndex
+               == (matches[ii].queryIndex * 7) % keypoints.size())) {
+          ++numberOfCorrectMatches;
+        }
+      }
+      BRICK_TEST_ASSERT(numberOfCorrectMatches > queryPoints.size() / 4);
+      BRICK_TEST_ASSERT(matches.size() - numberOfCorrectMatches
+                        < queryPoints.size() / 8);
+
+      // No stored keypoints means no matches.
+      KeypointMatcherFast emptyMatcher;
+      emptyMatcher.matchKeypoints(queryPoints.begin(), queryPoints.end(),
+                                  matches);
+      BRICK_TEST_ASSERT(matches.empty());
+    }
+
+
+    void
+    KeypointMatcherFastTest::
+    testMatchKeypointsBruteForce()
+    {
+      brick::random::PseudoRandom pRandom(1);
+      std::vector<KeypointFast> keypoints = this->getRandomKeypoints(
+        pRandom, 300);
+      std::vector<KeypointFast> queryPoints = this->getRandomKeypoints(
+        pRandom, 100);
+
+      // Rotations of 0.0 and 1.15 radians allow shifts of up to one
+      // and three elements, respectively.  The final setting allows
+      // every shift.
+      double expectedRotations[] = {0.0, 1.15, 10.0};
+      unsigned int numbersOfShifts[] = {1, 3, 8};
+      for(unsigned int rotationIndex = 0; rotationIndex < 3;
+          ++rotationIndex) {
+        KeypointMatcherFast matcher(expectedRotations[rotationIndex]);
+        matcher.setKeypoints(keypoints.begin(), keypoints.end());
+
+        // The vectorized and scalar SSDs must agree exactly.
+        std::vector<KeypointFast> referenceMatches;
+        std::vector<double> referenceSsds;
+        for(int simdLevel = numeric::BRICK_SIMD_NONE;
+            simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+          numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+          std::vector<KeypointFast> bestMatches;
+          std::vector<double> ssds;
+          matcher.matchKeypointsBruteForce(
+            queryPoints.begin(), queryPoints.end(), bestMatches, ssds);
+          BRICK_TEST_ASSERT(bestMatches.size() == queryPoints.size());
+          BRICK_TEST_ASSERT(ssds.size() == queryPoints.size());
+
+          for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+            // Brute force must find the true minimum.
+            double minimumSsd = std::numeric_limits<double>::max();
+            for(size_t jj = 0; jj < keypoints.size(); ++jj) {
+              if(keypoints[jj].isPositive == queryPoints[ii].isPositive) {
+                minimumSsd = std::min(
+                  minimumSsd, this->computeReferenceSSD(
+                    queryPoints[ii], keypoints[jj],
+                    numbersOfShifts[rotationIndex]));
+              }
+            }
+            BRICK_TEST_ASSERT(ssds[ii] == minimumSsd);
+            BRICK_TEST_ASSERT(
+              bestMatches[ii].isPositive == queryPoints[ii].isPositive);
+            BRICK_TEST_ASSERT(
+              this->computeReferenceSSD(
+                queryPoints[ii], bestMatches[ii],
+                numbersOfShifts[rotationIndex]) == minimumSsd);
+
+            // The windowed search is exact, too, although it may
+            // break ties differently.
+            KeypointFast matchingPoint;
+            BRICK_TEST_ASSERT(
+              matcher.matchKeypoint(queryPoints[ii], matchingPoint));
+            BRICK_TEST_ASSERT(
+              this->computeReferenceSSD(
+                queryPoints[ii], matchingPoint,
+                numbersOfShifts[rotationIndex]) == minimumSsd);
+          }
+
+          if(simdLevel == numeric::BRICK_SIMD_NONE) {
+            referenceMatches = bestMatches;
+            referenceSsds = ssds;
+          } else {
+            for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+              BRICK_TEST_ASSERT(ssds[ii] == referenceSsds[ii]);
+              BRICK_TEST_ASSERT(
+                bestMatches[ii].row == referenceMatches[ii].row);
+              BRICK_TEST_ASSERT(
+                bestMatches[ii].column == referenceMatches[ii].column);
+            }
+          }
+        }
+      }
+
+      // With no stored keypoints of the right polarity, there's no
+      // match.
+      std::vector<KeypointFast> negativeKeypoints;
+      for(size_t ii = 0; ii < keypoints.size(); ++ii) {
+        if(!keypoints[ii].isPositive) {
+          negativeKeypoints.push_back(keypoints[ii]);
+        }
+      }
+      KeypointMatcherFast matcher;
+      matcher.setKeypoints(negativeKeypoints.begin(), negativeKeypoints.end());
+      std::vector<KeypointFast> bestMatches;
+      std::vector<double> ssds;
+      matcher.matchKeypointsBruteForce(
+        queryPoints.begin(), queryPoints.end(), bestMatches, ssds);
+      for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+        if(queryPoints[ii].isPositive) {
+          BRICK_TEST_ASSERT(ssds[ii] == std::numeric_limits<double>::max());
+        } else {
+          BRICK_TEST_ASSERT(ssds[ii] < std::numeric_limits<double>::max());
+        }
+      }
+    }
+
+
+    void
+    KeypointMatcherFastTest::
+    testSetKeypoints__duplicateMeans()
+    {
+      // Two stored keypoints with the same feature vector mean must
+      // both be available for matching.
+      std::vector<KeypointFast> keypoints(2);
+      for(unsigned int jj = 0; jj < 16; ++jj) {
+        keypoints[0].featureVector[jj] = (jj < 8) ? 10 : 30;
+        keypoints[1].featureVector[jj] = (jj < 8) ? 30 : 10;
+      }
+      keypoints[0].row = 0;
+      keypoints[1].row = 1;
+      keypoints[0].isPositive = true;
+      keypoints[1].isPositive = true;
+
+      KeypointMatcherFast matcher;
+      matcher.setKeypoints(keypoints.begin(), keypoints.end());
+      for(unsigned int ii = 0; ii < 2; ++ii) {
+        KeypointFast matchingPoint;
+        BRICK_TEST_ASSERT(matcher.matchKeypoint(keypoints[ii], matchingPoint));
+        BRICK_TEST_ASSERT(matchingPoint.row == keypoints[ii].row);
+      }
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    KeypointMatcherFastTest::
+    timeMatchKeypoints()
+    {
+      // Uniformly random feature vectors have tightly clustered
+      // means, which is the case in which brute force matching
+      // should win.
+      brick::random::PseudoRandom pRandom(1);
+      std::vector<KeypointFast> keypoints = this->getRandomKeypoints(
+        pRandom, 4000);
+      std::vector<KeypointFast> queryPoints = this->getRandomKeypoints(
+        pRandom, 4000);
+      KeypointMatcherFast matcher(0.78);
+      matcher.setKeypoints(keypoints.begin(), keypoints.end());
+
+      for(int simdLevel = numeric::BRICK_SIMD_NONE;
+          simdLevel <= numeric::BRICK_SIMD_SSE2; ++simdLevel) {
+        numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+        std::cout << "\nSIMD level " << numeric::getSimdLevel() << ":\n";
+
+        double t0 = utilities::getCurrentTime();
+        KeypointFast matchingPoint;
+        for(size_t ii = 0; ii < queryPoints.size(); ++ii) {
+          matcher.matchKeypoint(queryPoints[ii], matchingPoint);
+        }
+        double t1 = utilities::getCurrentTime();
+        std::vector<KeypointFast> bestMatches;
+        std::vector<double> ssds;
+        matcher.matchKeypointsBruteForce(
+          queryPoints.begin(), queryPoints.end(), bestMatches, ssds);
+        double t2 = utilities::getCurrentTime();
+        std::vector<KeypointMatchFast> matches;
+        matcher.matchKeypoints(queryPoints.begin(), queryPoints.end(),
+                               matches, 0.8, true);
+        double t3 = utilities::getCurrentTime();
+
+        std::cout << "  ET for " << queryPoints.size() << " x "
+                  << keypoints.size() << " windowed matches: "
+                  << t1 - t0 << "\n"
+                  << "  ET for brute force matches: " << t2 - t1 << "\n"
+                  << "  ET for mutual, ratio tested matches: " << t3 - t2
+                  << std::endl;
+      }
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
+    double
+    KeypointMatcherFastTest::
+    computeReferenceSSD(KeypointFast const& keypoint0,
+                        KeypointFast const& keypoint1,
+                        unsigned int numberOfShifts)
+    {
+      double minimumSsd = std::numeric_limits<double>::max();
+      for(int shift = -static_cast<int>(numberOfShifts);
+          shift <= static_cast<int>(numberOfShifts); ++shift) {
+        double ssd = 0.0;
+        for(int jj = 0; jj < 16; ++jj) {
+          double difference = (
+            static_cast<double>(keypoint0.featureVector[(jj + shift + 16) % 16])
+            - static_cast<double>(keypoint1.featureVector[jj]));
+          ssd += difference * difference;
+        }
+        minimumSsd = std::min(minimumSsd, ssd);
+      }
+      return minimumSsd;
+    }
+
+
     // Generate test input.
     void
     KeypointMatcherFastTest::
@@ -255,6 +645,25 @@ namespace brick {
     }
 
 
+    std::vector<KeypointFast>
+    KeypointMatcherFastTest::
+    getRandomKeypoints(brick::random::PseudoRandom& pRandom,
+                       size_t numberOfKeypoints)
+    {
+      std::vector<KeypointFast> keypoints(numberOfKeypoints);
+      for(size_t ii = 0; ii < numberOfKeypoints; ++ii) {
+        keypoints[ii].row = static_cast<int>(ii);
+        keypoints[ii].column = static_cast<int>(ii);
+        for(unsigned int jj = 0; jj < 16; ++jj) {
+          keypoints[ii].featureVector[jj] =
+            static_cast<common::UnsignedInt8>(pRandom.uniformInt(0, 256));
+        }
+        keypoints[ii].isPositive = (pRandom.uniformInt(0, 2) != 0);
+      }
+      return keypoints;
+    }
+
+
   } // namespace computerVision
 
 } // namespace brick
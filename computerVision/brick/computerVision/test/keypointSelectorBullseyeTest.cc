@@ -18,6 +18,7 @@
 #include <brick/computerVision/utilities.hh>
 #include <brick/computerVision/test/testImages.hh>
 
+#include <brick/common/threadPool.hh>
 #include <brick/test/functors.hh>
 #include <brick/test/testFixture.hh>
 
@@ -45,9 +46,15 @@ namespace brick {
       // Tests.
       void testKeypointSelectorBullseye();
       void testExecutionTime();
+      void testSetImage__tiled();
+      void testSetTiling();
 
     private:
 
+      // Make a 2x2 mosaic of the bullseye test images.
+      Image<GRAY8>
+      getMosaicImage();
+
       double m_defaultTolerance;
 
     }; // class KeypointSelectorBullseyeTest
@@ -62,6 +69,8 @@ namespace brick {
     {
       BRICK_TEST_REGISTER_MEMBER(testKeypointSelectorBullseye);
       // BRICK_TEST_REGISTER_MEMBER(testExecutionTime);
+      BRICK_TEST_REGISTER_MEMBER(testSetImage__tiled);
+      BRICK_TEST_REGISTER_MEMBER(testSetTiling);
     }
 
 
@@ -252,6 +261,120 @@ namespace brick {
                 << t1 - t0 << " seconds" << std::endl;
     }
 
+
+    void
+    KeypointSelectorBullseyeTest::
+    testSetImage__tiled()
+    {
+      Image<GRAY8> inputImage = this->getMosaicImage();
+      const unsigned int numberOfTileSizes = 3;
+      unsigned int tileSizes[numberOfTileSizes][2] = {
+        {1000, 1}, {50, 50}, {97, 130}};
+      common::ThreadPool threadPool(3);
+
+      KeypointSelectorBullseye<double> referenceSelector(8, 15, 5);
+      referenceSelector.setImage(inputImage);
+      std::vector< KeypointBullseye<int> > referenceKeypoints =
+        referenceSelector.getKeypoints();
+      std::vector< KeypointBullseye<double> > referenceKeypointsGP =
+        referenceSelector.getKeypointsGeneralPosition();
+      BRICK_TEST_ASSERT(referenceKeypoints.size() == 4);
+
+      // Tiling, with or without threads, should not change the
+      // result.  The last pass uses the default tile size.
+      for(unsigned int tt = 0; tt <= numberOfTileSizes; ++tt) {
+        for(unsigned int pass = 0; pass < 2; ++pass) {
+          KeypointSelectorBullseye<double> selector(8, 15, 5);
+          if(tt < numberOfTileSizes) {
+            selector.setTiling(tileSizes[tt][0], tileSizes[tt][1]);
+          } else if(pass == 0) {
+            continue;
+          }
+          if(pass == 1) {
+            selector.setThreadPool(&threadPool);
+          }
+          selector.setImage(inputImage);
+          std::vector< KeypointBullseye<int> > keypoints =
+            selector.getKeypoints();
+          std::vector< KeypointBullseye<double> > keypointsGP =
+            selector.getKeypointsGeneralPosition();
+          BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+          BRICK_TEST_ASSERT(keypointsGP.size() == referenceKeypointsGP.size());
+          for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+            BRICK_TEST_ASSERT(keypoints[ii].row == referenceKeypoints[ii].row);
+            BRICK_TEST_ASSERT(keypoints[ii].column
+                              == referenceKeypoints[ii].column);
+            BRICK_TEST_ASSERT(keypoints[ii].bullseyeMetric
+                              == referenceKeypoints[ii].bullseyeMetric);
+            BRICK_TEST_ASSERT(keypointsGP[ii].row
+                              == referenceKeypointsGP[ii].row);
+            BRICK_TEST_ASSERT(keypointsGP[ii].column
+                              == referenceKeypointsGP[ii].column);
+          }
+        }
+      }
+    }
+
+
+    void
+    KeypointSelectorBullseyeTest::
+    testSetTiling()
+    {
+      Image<GRAY8> inputImage = this->getMosaicImage();
+
+      KeypointSelectorBullseye<double> referenceSelector(8, 15, 5);
+      referenceSelector.setImage(inputImage);
+      std::vector< KeypointBullseye<int> > referenceKeypoints =
+        referenceSelector.getKeypoints();
+      BRICK_TEST_ASSERT(referenceKeypoints.size() == 4);
+
+      // Each tile spans one row of the mosaic, and so contains two
+      // bullseyes.  Only the better of the two should survive.
+      common::ThreadPool threadPool(3);
+      KeypointSelectorBullseye<double> selector(8, 15, 5);
+      unsigned int tileRows = inputImage.rows() / 2;
+      selector.setTiling(tileRows, inputImage.columns(), 1);
+      selector.setThreadPool(&threadPool);
+      selector.setImage(inputImage);
+      std::vector< KeypointBullseye<int> > keypoints = selector.getKeypoints();
+      BRICK_TEST_ASSERT(keypoints.size() == 2);
+      BRICK_TEST_ASSERT((keypoints[0].row < static_cast<int>(tileRows))
+                        != (keypoints[1].row < static_cast<int>(tileRows)));
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        bool isTopTile = keypoints[ii].row < static_cast<int>(tileRows);
+        for(unsigned int jj = 0; jj < referenceKeypoints.size(); ++jj) {
+          if((referenceKeypoints[jj].row < static_cast<int>(tileRows))
+             == isTopTile) {
+            BRICK_TEST_ASSERT(referenceKeypoints[jj].bullseyeMetric
+                              <= keypoints[ii].bullseyeMetric);
+          }
+        }
+      }
+
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  selector.setTiling(0, 10));
+    }
+
+
+    Image<GRAY8>
+    KeypointSelectorBullseyeTest::
+    getMosaicImage()
+    {
+      Image<GRAY8> image0 = readPGM8(getBullseyeFileNamePGM0());
+      Image<GRAY8> image1 = readPGM8(getBullseyeFileNamePGM1());
+      Image<GRAY8> mosaic(image0.rows() * 2, image0.columns() * 2);
+      for(unsigned int row = 0; row < image0.rows(); ++row) {
+        for(unsigned int column = 0; column < image0.columns(); ++column) {
+          mosaic(row, column) = image0(row, column);
+          mosaic(row, column + image0.columns()) = image1(row, column);
+          mosaic(row + image0.rows(), column) = image1(row, column);
+          mosaic(row + image0.rows(), column + image0.columns()) =
+            image0(row, column);
+        }
+      }
+      return mosaic;
+    }
+
   } // namespace computerVision
 
 } // namespace brick
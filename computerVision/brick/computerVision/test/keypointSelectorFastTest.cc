@@ -10,10 +10,16 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
 #include <brick/computerVision/imageIO.hh>
 #include <brick/computerVision/keypointSelectorFast.hh>
 #include <brick/computerVision/utilities.hh>
 
+#include <brick/common/threadPool.hh>
+#include <brick/numeric/simdKernels.hh>
 #include <brick/random/pseudoRandom.hh>
 #include <brick/test/testFixture.hh>
 
@@ -34,18 +40,37 @@ namespace brick {
       KeypointSelectorFastTest();
       ~KeypointSelectorFastTest() {}
 
-      void setUp(const std::string& /* testName */) {}
-      void tearDown(const std::string& /* testName */) {}
+      void setUp(const std::string& /* testName */) {
+        m_savedSimdLevel = numeric::getSimdLevel();
+      }
+      void tearDown(const std::string& /* testName */) {
+        numeric::setSimdLevel(m_savedSimdLevel);
+      }
 
       // Tests.
       void testKeypointSelectorFast();
+      void testSetImage__simd();
+      void testSetImage__tiled();
+      void testSetKeypointBudget();
+      void testSetTiling();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      void timeSetImage();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
       // Legacy functions.
       void exerciseKeypointSelectorFast(std::string const& fileName);
 
     private:
 
+      // Make an image full of overlapping rectangles, so that there
+      // are plenty of corners, with a little noise on top.
+      Image<GRAY8>
+      getRectanglesImage(random::PseudoRandom& pRandom,
+                         unsigned int rows, unsigned int columns);
+
       double m_defaultTolerance;
+      numeric::SimdLevel m_savedSimdLevel;
 
     }; // class KeypointSelectorFastTest
 
@@ -55,9 +80,18 @@ namespace brick {
     KeypointSelectorFastTest::
     KeypointSelectorFastTest()
       : brick::test::TestFixture<KeypointSelectorFastTest>("KeypointSelectorFastTest"),
-        m_defaultTolerance(1.0E-8)
+        m_defaultTolerance(1.0E-8),
+        m_savedSimdLevel(numeric::BRICK_SIMD_NONE)
     {
       BRICK_TEST_REGISTER_MEMBER(testKeypointSelectorFast);
+      BRICK_TEST_REGISTER_MEMBER(testSetImage__simd);
+      BRICK_TEST_REGISTER_MEMBER(testSetImage__tiled);
+      BRICK_TEST_REGISTER_MEMBER(testSetKeypointBudget);
+      BRICK_TEST_REGISTER_MEMBER(testSetTiling);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeSetImage);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -122,6 +156,326 @@ namespace brick {
     }
 
 
+    void
+    KeypointSelectorFastTest::
+    testSetImage__simd()
+    {
+      // Odd image dimensions and regions of interest make sure that
+      // the partial blocks at the ends of each row are handled.
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 91, 157);
+
+      // The negative threshold can't be vectorized, and must fall
+      // back to the scalar code.
+      const unsigned int numberOfThresholds = 6;
+      common::Int16 thresholds[numberOfThresholds] = {-3, 0, 5, 20, 60, 300};
+      const unsigned int numberOfRegions = 3;
+      unsigned int regions[numberOfRegions][4] = {
+        {0, 0, 1000, 1000}, {10, 7, 80, 140}, {5, 30, 60, 55}};
+
+      for(unsigned int tt = 0; tt < numberOfThresholds; ++tt) {
+        for(unsigned int rr = 0; rr < numberOfRegions; ++rr) {
+          std::vector<KeypointFast> referenceKeypoints;
+          for(int simdLevel = numeric::BRICK_SIMD_NONE;
+              simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+            numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+            KeypointSelectorFast selector;
+            selector.setThreshold(thresholds[tt]);
+            selector.setImage(inputImage, regions[rr][0], regions[rr][1],
+                              regions[rr][2], regions[rr][3]);
+            std::vector<KeypointFast> keypoints = selector.getKeypoints();
+            if(simdLevel == numeric::BRICK_SIMD_NONE) {
+              referenceKeypoints = keypoints;
+              continue;
+            }
+            BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+            for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+              BRICK_TEST_ASSERT(keypoints[ii].row
+                                == referenceKeypoints[ii].row);
+              BRICK_TEST_ASSERT(keypoints[ii].column
+                                == referenceKeypoints[ii].column);
+              BRICK_TEST_ASSERT(keypoints[ii].isPositive
+                                == referenceKeypoints[ii].isPositive);
+              BRICK_TEST_ASSERT(
+                std::equal(keypoints[ii].featureVector,
+                           keypoints[ii].featureVector + 16,
+                           referenceKeypoints[ii].featureVector));
+            }
+          }
+
+          // Make sure the test isn't vacuous.
+          if(thresholds[tt] >= 0 && thresholds[tt] <= 20 && rr == 0) {
+            BRICK_TEST_ASSERT(referenceKeypoints.size() > 20);
+          }
+        }
+      }
+    }
+
+
+    void
+    KeypointSelectorFastTest::
+    testSetImage__tiled()
+    {
+      random::PseudoRandom pRandom(2);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 91, 157);
+      const unsigned int numberOfRegions = 2;
+      unsigned int regions[numberOfRegions][4] = {
+        {0, 0, 1000, 1000}, {10, 7, 80, 140}};
+      const unsigned int numberOfTileSizes = 3;
+      unsigned int tileSizes[numberOfTileSizes][2] = {{1, 1000}, {16, 16}, {33, 7}};
+      common::ThreadPool threadPool(3);
+
+      for(unsigned int rr = 0; rr < numberOfRegions; ++rr) {
+        KeypointSelectorFast referenceSelector;
+        referenceSelector.setThreshold(10);
+        referenceSelector.setImage(
+          inputImage, regions[rr][0], regions[rr][1],
+          regions[rr][2], regions[rr][3]);
+        std::vector<KeypointFast> referenceKeypoints =
+          referenceSelector.getKeypoints();
+        BRICK_TEST_ASSERT(referenceKeypoints.size() > 20);
+
+        // Tiling, with or without threads, should not change the
+        // result.  The last pass uses the default tile size.
+        for(unsigned int tt = 0; tt <= numberOfTileSizes; ++tt) {
+          for(unsigned int pass = 0; pass < 2; ++pass) {
+            KeypointSelectorFast selector;
+            selector.setThreshold(10);
+            if(tt < numberOfTileSizes) {
+              selector.setTiling(tileSizes[tt][0], tileSizes[tt][1]);
+            } else if(pass == 0) {
+              continue;
+            }
+            if(pass == 1) {
+              selector.setThreadPool(&threadPool);
+            }
+            selector.setImage(inputImage, regions[rr][0], regions[rr][1],
+                              regions[rr][2], regions[rr][3]);
+            std::vector<KeypointFast> keypoints = selector.getKeypoints();
+            BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+            for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+              BRICK_TEST_ASSERT(keypoints[ii].row
+                                == referenceKeypoints[ii].row);
+              BRICK_TEST_ASSERT(keypoints[ii].column
+                                == referenceKeypoints[ii].column);
+              BRICK_TEST_ASSERT(keypoints[ii].isPositive
+                                == referenceKeypoints[ii].isPositive);
+              BRICK_TEST_ASSERT(
+                std::equal(keypoints[ii].featureVector,
+                           keypoints[ii].featureVector + 16,
+                           referenceKeypoints[ii].featureVector));
+            }
+          }
+        }
+      }
+    }
+
+
+    void
+    KeypointSelectorFastTest::
+    testSetKeypointBudget()
+    {
+      random::PseudoRandom pRandom(5);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 150, 200);
+      const unsigned int numberOfKeypoints = 100;
+
+      KeypointSelectorFast referenceSelector;
+      referenceSelector.setThreshold(10);
+      referenceSelector.setImage(inputImage);
+      std::vector<KeypointFast> referenceKeypoints =
+        referenceSelector.getKeypoints();
+      BRICK_TEST_ASSERT(referenceKeypoints.size() > 2 * numberOfKeypoints);
+
+      for(int strategy = BRICK_CV_KEYPOINT_BUDGET_GRID;
+          strategy <= BRICK_CV_KEYPOINT_BUDGET_ANMS; ++strategy) {
+        KeypointBudget budget(
+          numberOfKeypoints, static_cast<KeypointBudgetStrategy>(strategy));
+        KeypointSelectorFast selector;
+        selector.setThreshold(10);
+        selector.setKeypointBudget(budget);
+        selector.setImage(inputImage);
+        std::vector<KeypointFast> keypoints = selector.getKeypoints();
+
+        // The budget should pick exactly numberOfKeypoints of the
+        // unbudgeted keypoints, without disturbing their order.
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+        unsigned int referenceIndex = 0;
+        for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+          while(referenceIndex < referenceKeypoints.size()
+                && (referenceKeypoints[referenceIndex].row
+                    != keypoints[ii].row
+                    || (referenceKeypoints[referenceIndex].column
+                        != keypoints[ii].column))) {
+            ++referenceIndex;
+          }
+          BRICK_TEST_ASSERT(referenceIndex < referenceKeypoints.size());
+          ++referenceIndex;
+        }
+
+        // Tiling without a per-tile limit doesn't change the
+        // detected keypoints, so it shouldn't change the budgeted
+        // ones either.
+        common::ThreadPool threadPool(3);
+        KeypointSelectorFast tiledSelector;
+        tiledSelector.setThreshold(10);
+        tiledSelector.setKeypointBudget(budget);
+        tiledSelector.setThreadPool(&threadPool);
+        tiledSelector.setTiling(40, 50);
+        tiledSelector.setImage(inputImage);
+        std::vector<KeypointFast> tiledKeypoints =
+          tiledSelector.getKeypoints();
+        BRICK_TEST_ASSERT(tiledKeypoints.size() == keypoints.size());
+        for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+          BRICK_TEST_ASSERT(tiledKeypoints[ii].row == keypoints[ii].row);
+          BRICK_TEST_ASSERT(
+            tiledKeypoints[ii].column == keypoints[ii].column);
+        }
+      }
+
+      // Removing the budget should restore the full output.
+      KeypointSelectorFast selector;
+      selector.setThreshold(10);
+      selector.setKeypointBudget(KeypointBudget(numberOfKeypoints));
+      selector.setKeypointBudget(KeypointBudget());
+      selector.setImage(inputImage);
+      BRICK_TEST_ASSERT(
+        selector.getKeypoints().size() == referenceKeypoints.size());
+    }
+
+
+    void
+    KeypointSelectorFastTest::
+    testSetTiling()
+    {
+      random::PseudoRandom pRandom(3);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 91, 157);
+      const unsigned int tileRows = 20;
+      const unsigned int tileColumns = 30;
+      const unsigned int budget = 3;
+
+      KeypointSelectorFast referenceSelector;
+      referenceSelector.setThreshold(10);
+      referenceSelector.setImage(inputImage);
+      std::vector<KeypointFast> referenceKeypoints =
+        referenceSelector.getKeypoints();
+
+      common::ThreadPool threadPool(3);
+      KeypointSelectorFast selector;
+      selector.setThreshold(10);
+      selector.setThreadPool(&threadPool);
+      selector.setTiling(tileRows, tileColumns, budget);
+      selector.setImage(inputImage);
+      std::vector<KeypointFast> keypoints = selector.getKeypoints();
+
+      // Every tile should report min(budget, available) keypoints,
+      // all of which must have been found by the untiled code, in
+      // raster order.
+      KeypointTiling tiling(3, 3, inputImage.rows() - 3,
+                            inputImage.columns() - 3, tileRows, tileColumns);
+      std::vector<unsigned int> availableCounts(tiling.getNumberOfTiles(), 0);
+      std::vector<unsigned int> counts(tiling.getNumberOfTiles(), 0);
+      for(unsigned int ii = 0; ii < referenceKeypoints.size(); ++ii) {
+        ++availableCounts[tiling.getTileIndex(
+            referenceKeypoints[ii].row, referenceKeypoints[ii].column)];
+      }
+      unsigned int referenceIndex = 0;
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        ++counts[tiling.getTileIndex(keypoints[ii].row, keypoints[ii].column)];
+        while(referenceIndex < referenceKeypoints.size()
+              && (referenceKeypoints[referenceIndex].row != keypoints[ii].row
+                  || (referenceKeypoints[referenceIndex].column
+                      != keypoints[ii].column))) {
+          ++referenceIndex;
+        }
+        BRICK_TEST_ASSERT(referenceIndex < referenceKeypoints.size());
+      }
+      for(unsigned int tt = 0; tt < counts.size(); ++tt) {
+        BRICK_TEST_ASSERT(counts[tt] == std::min(budget, availableCounts[tt]));
+      }
+      BRICK_TEST_ASSERT(keypoints.size() < referenceKeypoints.size());
+
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  selector.setTiling(0, 10));
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    KeypointSelectorFastTest::
+    timeSetImage()
+    {
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> inputImage = this->getRectanglesImage(
+        pRandom, 1080, 1920);
+      const unsigned int numberOfFrames = 20;
+      for(int simdLevel = numeric::BRICK_SIMD_NONE;
+          simdLevel <= numeric::getSupportedSimdLevel(); ++simdLevel) {
+        numeric::setSimdLevel(static_cast<numeric::SimdLevel>(simdLevel));
+        KeypointSelectorFast selector;
+        selector.setThreshold(20);
+        double time0 = utilities::getCurrentTime();
+        for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+          selector.setImage(inputImage);
+        }
+        double time1 = utilities::getCurrentTime();
+        std::cout << "\nSIMD level " << simdLevel << ": "
+                  << numberOfFrames / (time1 - time0)
+                  << " frames per second for 1920x1080 GRAY8, "
+                  << selector.getKeypoints().size() << " keypoints."
+                  << std::endl;
+      }
+
+      common::ThreadPool threadPool(0);
+      KeypointSelectorFast selector;
+      selector.setThreshold(20);
+      selector.setThreadPool(&threadPool);
+      double time0 = utilities::getCurrentTime();
+      for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+        selector.setImage(inputImage);
+      }
+      double time1 = utilities::getCurrentTime();
+      std::cout << "\nTiled, " << threadPool.getNumberOfThreads()
+                << " threads: " << numberOfFrames / (time1 - time0)
+                << " frames per second for 1920x1080 GRAY8, "
+                << selector.getKeypoints().size() << " keypoints."
+                << std::endl;
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
+    Image<GRAY8>
+    KeypointSelectorFastTest::
+    getRectanglesImage(random::PseudoRandom& pRandom,
+                       unsigned int rows, unsigned int columns)
+    {
+      Image<GRAY8> image(rows, columns);
+      image = 128;
+      unsigned int numberOfRectangles = rows * columns / 100;
+      for(unsigned int ii = 0; ii < numberOfRectangles; ++ii) {
+        unsigned int row0 = pRandom.uniformInt(0, rows);
+        unsigned int column0 = pRandom.uniformInt(0, columns);
+        unsigned int row1 = std::min(
+          rows, row0 + pRandom.uniformInt(1, 12));
+        unsigned int column1 = std::min(
+          columns, column0 + pRandom.uniformInt(1, 12));
+        common::UInt8 value = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        for(unsigned int row = row0; row < row1; ++row) {
+          for(unsigned int column = column0; column < column1; ++column) {
+            image(row, column) = value;
+          }
+        }
+      }
+      for(unsigned int ii = 0; ii < image.size(); ++ii) {
+        image[ii] = static_cast<common::UInt8>(
+          std::max(0, std::min(255, image[ii] + pRandom.uniformInt(-3, 4))));
+      }
+      return image;
+    }
+
+
     void
     KeypointSelectorFastTest::
     exerciseKeypointSelectorFast(std::string const& fileName)
@@ -10,12 +10,17 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_COMPUTERVISION_DEVELOPER
+#define BRICK_COMPUTERVISION_DEVELOPER 0
+#endif /* #ifndef BRICK_COMPUTERVISION_DEVELOPER */
+
 #include <brick/computerVision/imageIO.hh>
 #include <brick/computerVision/kernels.hh>
 #include <brick/computerVision/keypointSelectorHarris.hh>
 #include <brick/computerVision/utilities.hh>
 #include <brick/computerVision/test/testImages.hh>
 
+#include <brick/common/threadPool.hh>
 #include <brick/random/pseudoRandom.hh>
 #include <brick/test/functors.hh>
 #include <brick/test/testFixture.hh>
@@ -43,6 +48,13 @@ namespace brick {
 
       // Tests.
       void testKeypointSelectorHarris();
+      void testSetImage__tiled();
+      void testSetKeypointBudget();
+      void testSetTiling();
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      void timeSetImage();
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
 
       // Legacy functions.
       void exerciseKeypointSelectorHarris(std::string const& fileName,
@@ -50,6 +62,11 @@ namespace brick {
 
     private:
 
+      // Make an image with plenty of corners in it.
+      Image<GRAY8>
+      getRectanglesImage(random::PseudoRandom& pRandom,
+                         unsigned int rows, unsigned int columns);
+
       double m_defaultTolerance;
 
     }; // class KeypointSelectorHarrisTest
@@ -63,6 +80,13 @@ namespace brick {
         m_defaultTolerance(1.0E-8)
     {
       BRICK_TEST_REGISTER_MEMBER(testKeypointSelectorHarris);
+      BRICK_TEST_REGISTER_MEMBER(testSetImage__tiled);
+      BRICK_TEST_REGISTER_MEMBER(testSetKeypointBudget);
+      BRICK_TEST_REGISTER_MEMBER(testSetTiling);
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeSetImage);
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
     }
 
 
@@ -121,6 +145,232 @@ namespace brick {
     }
 
 
+    void
+    KeypointSelectorHarrisTest::
+    testSetImage__tiled()
+    {
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 97, 131);
+      const unsigned int numberOfTileSizes = 3;
+      unsigned int tileSizes[numberOfTileSizes][2] = {
+        {1, 1000}, {16, 16}, {33, 7}};
+      common::ThreadPool threadPool(3);
+
+      KeypointSelectorHarris<double> referenceSelector;
+      referenceSelector.setImage(inputImage);
+      std::vector< KeypointHarris<common::Int32> > referenceKeypoints =
+        referenceSelector.getKeypoints();
+      std::vector< KeypointHarris<double> > referenceKeypointsGP =
+        referenceSelector.getKeypointsGeneralPosition();
+      BRICK_TEST_ASSERT(referenceKeypoints.size() > 20);
+
+      // Tiling, with or without threads, should not change the
+      // result.  The last pass uses the default tile size.  Reusing
+      // the selector makes sure stale data doesn't leak from one
+      // image to the next.
+      KeypointSelectorHarris<double> selector;
+      selector.setImage(this->getRectanglesImage(pRandom, 97, 131));
+      for(unsigned int tt = 0; tt <= numberOfTileSizes; ++tt) {
+        for(unsigned int pass = 0; pass < 2; ++pass) {
+          if(tt < numberOfTileSizes) {
+            selector.setTiling(tileSizes[tt][0], tileSizes[tt][1]);
+          } else if(pass == 0) {
+            continue;
+          } else {
+            selector.setTiling(0, 0);
+          }
+          selector.setThreadPool((pass == 1) ? &threadPool : 0);
+          selector.setImage(inputImage);
+          std::vector< KeypointHarris<common::Int32> > keypoints =
+            selector.getKeypoints();
+          BRICK_TEST_ASSERT(keypoints.size() == referenceKeypoints.size());
+          for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+            BRICK_TEST_ASSERT(keypoints[ii].row == referenceKeypoints[ii].row);
+            BRICK_TEST_ASSERT(keypoints[ii].column
+                              == referenceKeypoints[ii].column);
+            BRICK_TEST_ASSERT(keypoints[ii].value
+                              == referenceKeypoints[ii].value);
+          }
+          std::vector< KeypointHarris<double> > keypointsGP =
+            selector.getKeypointsGeneralPosition();
+          BRICK_TEST_ASSERT(keypointsGP.size() == referenceKeypointsGP.size());
+          for(unsigned int ii = 0; ii < keypointsGP.size(); ++ii) {
+            BRICK_TEST_ASSERT(keypointsGP[ii].row
+                              == referenceKeypointsGP[ii].row);
+            BRICK_TEST_ASSERT(keypointsGP[ii].column
+                              == referenceKeypointsGP[ii].column);
+            BRICK_TEST_ASSERT(keypointsGP[ii].value
+                              == referenceKeypointsGP[ii].value);
+          }
+        }
+      }
+    }
+
+
+    void
+    KeypointSelectorHarrisTest::
+    testSetKeypointBudget()
+    {
+      random::PseudoRandom pRandom(4);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 150, 200);
+      const unsigned int numberOfKeypoints = 40;
+
+      KeypointSelectorHarris<double> referenceSelector;
+      referenceSelector.setImage(inputImage);
+      std::vector< KeypointHarris<common::Int32> > referenceKeypoints =
+        referenceSelector.getKeypoints();
+      BRICK_TEST_ASSERT(referenceKeypoints.size() > 2 * numberOfKeypoints);
+
+      for(int strategy = BRICK_CV_KEYPOINT_BUDGET_GRID;
+          strategy <= BRICK_CV_KEYPOINT_BUDGET_ANMS; ++strategy) {
+        KeypointSelectorHarris<double> selector;
+        selector.setKeypointBudget(KeypointBudget(
+          numberOfKeypoints, static_cast<KeypointBudgetStrategy>(strategy),
+          4, 4));
+        selector.setImage(inputImage);
+
+        // The budget should pick exactly numberOfKeypoints of the
+        // unbudgeted keypoints, without disturbing their order.
+        std::vector< KeypointHarris<common::Int32> > keypoints =
+          selector.getKeypoints();
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+        unsigned int referenceIndex = 0;
+        for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+          while(referenceIndex < referenceKeypoints.size()
+                && (referenceKeypoints[referenceIndex].row
+                    != keypoints[ii].row
+                    || (referenceKeypoints[referenceIndex].column
+                        != keypoints[ii].column))) {
+            ++referenceIndex;
+          }
+          BRICK_TEST_ASSERT(referenceIndex < referenceKeypoints.size());
+          BRICK_TEST_ASSERT(
+            referenceKeypoints[referenceIndex].value == keypoints[ii].value);
+          ++referenceIndex;
+        }
+
+        std::vector< KeypointHarris<double> > keypointsGP =
+          selector.getKeypointsGeneralPosition();
+        BRICK_TEST_ASSERT(keypointsGP.size() == numberOfKeypoints);
+
+        // The budget applies after any per-tile limit.
+        selector.setTiling(20, 30, 2);
+        selector.setImage(inputImage);
+        keypoints = selector.getKeypoints();
+        BRICK_TEST_ASSERT(keypoints.size() == numberOfKeypoints);
+      }
+    }
+
+
+    void
+    KeypointSelectorHarrisTest::
+    testSetTiling()
+    {
+      random::PseudoRandom pRandom(2);
+      Image<GRAY8> inputImage = this->getRectanglesImage(pRandom, 97, 131);
+      const unsigned int tileRows = 20;
+      const unsigned int tileColumns = 30;
+      const unsigned int budget = 2;
+
+      KeypointSelectorHarris<double> referenceSelector;
+      referenceSelector.setImage(inputImage);
+      std::vector< KeypointHarris<common::Int32> > referenceKeypoints =
+        referenceSelector.getKeypoints();
+
+      common::ThreadPool threadPool(3);
+      KeypointSelectorHarris<double> selector;
+      selector.setThreadPool(&threadPool);
+      selector.setTiling(tileRows, tileColumns, budget);
+      selector.setImage(inputImage);
+      std::vector< KeypointHarris<common::Int32> > keypoints =
+        selector.getKeypoints();
+
+      // Each tile should keep its strongest keypoints, in the
+      // original order.
+      KeypointTiling tiling(8, 8, inputImage.rows() - 8,
+                            inputImage.columns() - 8, tileRows, tileColumns);
+      std::vector< std::vector<double> > tileValues(tiling.getNumberOfTiles());
+      for(unsigned int ii = 0; ii < referenceKeypoints.size(); ++ii) {
+        tileValues[tiling.getTileIndex(
+            referenceKeypoints[ii].row, referenceKeypoints[ii].column)]
+          .push_back(referenceKeypoints[ii].value);
+      }
+      std::vector<unsigned int> counts(tiling.getNumberOfTiles(), 0);
+      unsigned int referenceIndex = 0;
+      for(unsigned int ii = 0; ii < keypoints.size(); ++ii) {
+        std::size_t tileIndex =
+          tiling.getTileIndex(keypoints[ii].row, keypoints[ii].column);
+        ++counts[tileIndex];
+        unsigned int numberOfBetter = 0;
+        for(unsigned int jj = 0; jj < tileValues[tileIndex].size(); ++jj) {
+          if(tileValues[tileIndex][jj] > keypoints[ii].value) {
+            ++numberOfBetter;
+          }
+        }
+        BRICK_TEST_ASSERT(numberOfBetter < budget);
+        while(referenceIndex < referenceKeypoints.size()
+              && (referenceKeypoints[referenceIndex].row != keypoints[ii].row
+                  || (referenceKeypoints[referenceIndex].column
+                      != keypoints[ii].column))) {
+          ++referenceIndex;
+        }
+        BRICK_TEST_ASSERT(referenceIndex < referenceKeypoints.size());
+      }
+      for(unsigned int tt = 0; tt < counts.size(); ++tt) {
+        BRICK_TEST_ASSERT(
+          counts[tt] == std::min(static_cast<std::size_t>(budget),
+                                 tileValues[tt].size()));
+      }
+      BRICK_TEST_ASSERT(keypoints.size() < referenceKeypoints.size());
+
+      std::vector< KeypointHarris<double> > keypointsGP =
+        selector.getKeypointsGeneralPosition();
+      std::vector<unsigned int> countsGP(tiling.getNumberOfTiles(), 0);
+      for(unsigned int ii = 0; ii < keypointsGP.size(); ++ii) {
+        BRICK_TEST_ASSERT(
+          ++countsGP[tiling.getTileIndex(
+              static_cast<int>(keypointsGP[ii].row),
+              static_cast<int>(keypointsGP[ii].column))] <= budget);
+      }
+
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  selector.setTiling(10, 0));
+    }
+
+
+#if BRICK_COMPUTERVISION_DEVELOPER
+
+    void
+    KeypointSelectorHarrisTest::
+    timeSetImage()
+    {
+      random::PseudoRandom pRandom(1);
+      Image<GRAY8> inputImage = this->getRectanglesImage(
+        pRandom, 1080, 1920);
+      const unsigned int numberOfFrames = 10;
+      common::ThreadPool threadPool(0);
+      for(unsigned int pass = 0; pass < 2; ++pass) {
+        KeypointSelectorHarris<double> selector;
+        if(pass == 1) {
+          selector.setThreadPool(&threadPool);
+        }
+        double time0 = utilities::getCurrentTime();
+        for(unsigned int ii = 0; ii < numberOfFrames; ++ii) {
+          selector.setImage(inputImage);
+        }
+        double time1 = utilities::getCurrentTime();
+        std::cout << "\n" << ((pass == 0) ? "Untiled" : "Tiled") << ", "
+                  << ((pass == 0) ? 1 : threadPool.getNumberOfThreads())
+                  << " threads: " << numberOfFrames / (time1 - time0)
+                  << " frames per second for 1920x1080 GRAY8, "
+                  << selector.getKeypoints().size() << " keypoints."
+                  << std::endl;
+      }
+    }
+
+#endif /* #if BRICK_COMPUTERVISION_DEVELOPER */
+
+
     void
     KeypointSelectorHarrisTest::
     exerciseKeypointSelectorHarris(std::string const& fileName,
@@ -186,6 +436,33 @@ namespace brick {
                inputImage.rows(), inputImage.columns(), false);
     }
 
+
+    Image<GRAY8>
+    KeypointSelectorHarrisTest::
+    getRectanglesImage(random::PseudoRandom& pRandom,
+                       unsigned int rows, unsigned int columns)
+    {
+      Image<GRAY8> image(rows, columns);
+      image = 128;
+      unsigned int numberOfRectangles = rows * columns / 400;
+      for(unsigned int ii = 0; ii < numberOfRectangles; ++ii) {
+        unsigned int row0 = pRandom.uniformInt(0, rows);
+        unsigned int column0 = pRandom.uniformInt(0, columns);
+        unsigned int row1 = std::min(
+          rows, row0 + pRandom.uniformInt(4, 20));
+        unsigned int column1 = std::min(
+          columns, column0 + pRandom.uniformInt(4, 20));
+        common::UInt8 value = static_cast<common::UInt8>(
+          pRandom.uniformInt(0, 256));
+        for(unsigned int row = row0; row < row1; ++row) {
+          for(unsigned int column = column0; column < column1; ++column) {
+            image(row, column) = value;
+          }
+        }
+      }
+      return image;
+    }
+
   } // namespace computerVision
 
 } // namespace brick
@@ -14,6 +14,7 @@
 #include <functional>
 #include <brick/computerVision/ransac.hh>
 #include <brick/computerVision/ransacClassInterface.hh>
+#include <brick/common/threadPool.hh>
 #include <brick/numeric/utilities.hh>
 #include <brick/numeric/vector2D.hh>
 #include <brick/random/pseudoRandom.hh>
@@ -41,6 +42,8 @@ namespace brick {
 
       // Tests.
       void testRansac();
+      void testRansac__threadPool();
+      void testRansac__withoutSetSeed();
 
     private:
 
@@ -190,6 +193,73 @@ namespace brick {
     };
 
 
+    // This class provides the Problem interface required by the
+    // serial Ransac algorithm, but not setSeed(), which only the
+    // batched algorithm needs.  It simply forwards to a
+    // LineFittingProblem instance.
+    class UnseededLineFittingProblem
+    {
+    public:
+
+      typedef LineFittingProblem::ModelType ModelType;
+      typedef LineFittingProblem::SampleType SampleType;
+      typedef LineFittingProblem::SampleSequenceType SampleSequenceType;
+
+      template <class IterType>
+      UnseededLineFittingProblem(IterType beginIter, IterType endIter)
+        : m_problem(beginIter, endIter) {}
+
+      void
+      beginIteration(size_t iterationNumber) {
+        m_problem.beginIteration(iterationNumber);
+      }
+
+      template <class IterType>
+      void
+      computeError(ModelType const& model,
+                   SampleSequenceType const& sampleSequence,
+                   IterType outputIter) {
+        m_problem.computeError(model, sampleSequence, outputIter);
+      }
+
+      ModelType
+      estimateModel(SampleSequenceType const& sampleSequence) {
+        return m_problem.estimateModel(sampleSequence);
+      }
+
+      RansacInlierStrategy
+      getInlierStrategy() {return m_problem.getInlierStrategy();}
+
+      double
+      getNaiveErrorThreshold() {return m_problem.getNaiveErrorThreshold();}
+
+      SampleSequenceType
+      getPool() {return m_problem.getPool();}
+
+      size_t
+      getPoolSize() {return m_problem.getPoolSize();}
+
+      SampleSequenceType
+      getRandomSample(size_t sampleSize) {
+        return m_problem.getRandomSample(sampleSize);
+      }
+
+      size_t
+      getSampleSize() {return m_problem.getSampleSize();}
+
+      template <class IterType>
+      SampleSequenceType
+      getSubset(IterType beginIter, IterType endIter) {
+        return m_problem.getSubset(beginIter, endIter);
+      }
+
+    private:
+
+      LineFittingProblem m_problem;
+
+    };
+
+
     /* ============== Member Function Definititions ============== */
 
     RansacTest::
@@ -198,6 +268,8 @@ namespace brick {
         m_defaultTolerance(1.0E-8)
     {
       BRICK_TEST_REGISTER_MEMBER(testRansac);
+      BRICK_TEST_REGISTER_MEMBER(testRansac__threadPool);
+      BRICK_TEST_REGISTER_MEMBER(testRansac__withoutSetSeed);
     }
 
 
@@ -238,6 +310,98 @@ namespace brick {
                                          m_defaultTolerance));
     }
 
+
+
+    void
+    RansacTest::
+    testRansac__threadPool()
+    {
+      // Points near the line y = 0.5 * x + 3, plus uniformly
+      // distributed outliers.
+      rndm::PseudoRandom pRandom(17);
+      std::vector< num::Vector2D<double> > sampleVector;
+      for(size_t ii = 0; ii < 200; ++ii) {
+        double xx = pRandom.uniform(0.0, 100.0);
+        if(ii % 5 < 3) {
+          sampleVector.push_back(num::Vector2D<double>(
+            xx, 0.5 * xx + 3.0 + pRandom.uniform(-0.2, 0.2)));
+        } else {
+          sampleVector.push_back(num::Vector2D<double>(
+            xx, pRandom.uniform(0.0, 60.0)));
+        }
+      }
+      LineFittingProblem lineFittingProblem(
+        sampleVector.begin(), sampleVector.end());
+
+      // The first minimum consensus size lets the search terminate
+      // early, while the second can't be reached, so every random
+      // sample is evaluated.
+      size_t minConsensusSetSizes[] = {100, 1000};
+      size_t numbersOfThreads[] = {1, 2, 3, 4};
+      size_t batchSizes[] = {1, 7, 16};
+      for(size_t ii = 0; ii < 2; ++ii) {
+        for(size_t jj = 0; jj < 3; ++jj) {
+          std::pair<double, double> referenceResult;
+          for(size_t kk = 0; kk < 4; ++kk) {
+            common::ThreadPool threadPool(numbersOfThreads[kk]);
+            Ransac<LineFittingProblem> ransac(
+              lineFittingProblem, minConsensusSetSizes[ii], 0.999, 0.6);
+            ransac.setNumberOfRandomSampleSets(50);
+            ransac.setThreadPool(&threadPool, 12345, batchSizes[jj]);
+            std::pair<double, double> slope_intercept = ransac.getResult();
+            BRICK_TEST_ASSERT(approximatelyEqual(slope_intercept.first, 0.5,
+                                                 0.01));
+            BRICK_TEST_ASSERT(approximatelyEqual(slope_intercept.second, 3.0,
+                                                 0.5));
+
+            // Same seed, same answer, no matter how many threads, or
+            // how many times we ask.
+            if(kk == 0) {
+              referenceResult = slope_intercept;
+            }
+            BRICK_TEST_ASSERT(slope_intercept == referenceResult);
+            BRICK_TEST_ASSERT(ransac.getResult() == referenceResult);
+          }
+        }
+      }
+
+      Ransac<LineFittingProblem> ransac(lineFittingProblem);
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  ransac.setThreadPool(0, 0, 0));
+    }
+
+
+    void
+    RansacTest::
+    testRansac__withoutSetSeed()
+    {
+      // Problem classes that don't provide setSeed() should still
+      // work with the serial algorithm.  Most of this test happens at
+      // compile time.
+      std::vector< num::Vector2D<double> > sampleVector;
+      sampleVector.push_back(num::Vector2D<double>(0.0, 0.0));
+      sampleVector.push_back(num::Vector2D<double>(1.0, 1.0));
+      sampleVector.push_back(num::Vector2D<double>(2.0, 2.0));
+      sampleVector.push_back(num::Vector2D<double>(3.0, 2.0));
+      sampleVector.push_back(num::Vector2D<double>(3.0, 3.0));
+      sampleVector.push_back(num::Vector2D<double>(4.0, 4.0));
+      sampleVector.push_back(num::Vector2D<double>(10.0, 2.0));
+
+      UnseededLineFittingProblem problem(
+        sampleVector.begin(), sampleVector.end());
+      Ransac<UnseededLineFittingProblem> ransac(
+        problem, 5, 1.0 - 1.0E-10, 5.0 / 7.0);
+
+      std::pair<double, double> slope_intercept = ransac.getResult();
+      BRICK_TEST_ASSERT(approximatelyEqual(slope_intercept.first, 1.0,
+                                           m_defaultTolerance));
+      BRICK_TEST_ASSERT(approximatelyEqual(slope_intercept.second, 0.0,
+                                           m_defaultTolerance));
+      BRICK_TEST_ASSERT(ransac.getConsensusSet(slope_intercept).second
+                        - ransac.getConsensusSet(slope_intercept).first
+                        == 5);
+    }
+
   } // namespace computerVision
 
 } // namespace brick
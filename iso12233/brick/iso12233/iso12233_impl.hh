@@ -277,25 +277,23 @@ namespace brick {
       Array1D<FloatType>
       computeSFR(Array1D<FloatType> const& lineSpreadFunction)
       {
-        // Our FFT routine only knows about complex numbers.
-        Array1D<std::complex<FloatType> > complexLSF(lineSpreadFunction.size());
-        std::transform(lineSpreadFunction.begin(), lineSpreadFunction.end(),
-                       complexLSF.begin(),
-                       [](FloatType const& arg0) {
-                         return std::complex<FloatType>(arg0, FloatType(0));
-                       });
-
-        // Here we compute the Discrete Fourier Transform (DFT).
+        // Here we compute the Discrete Fourier Transform (DFT).  The
+        // line spread function is real, so only the first half of the
+        // DFT is computed.
         Array1D<std::complex<FloatType> > dft =
-          brick::numeric::computeFFT(complexLSF);
+          brick::numeric::computeRealFFT(lineSpreadFunction);
 
         // Spacial Frequency Response (SFR) is the normalized modulus of
-        // the DFT.
-        Array1D<FloatType> sfr(dft.size());
+        // the DFT.  The modulus of the DFT of a real signal is
+        // symmetric, so we fill in the second half by reflection.
+        Array1D<FloatType> sfr(lineSpreadFunction.size());
         std::transform(dft.begin(), dft.end(), sfr.begin(),
                        [](std::complex<FloatType> const& arg0) {
                          return std::abs(arg0);
                        });
+        for(std::size_t kk = dft.size(); kk < sfr.size(); ++kk) {
+          sfr[kk] = sfr[sfr.size() - kk];
+        }
 
         // Now normalize so that DC component is 1.0.
         FloatType epsilon = brick::numeric::NumericTraits<FloatType>::epsilon();
@@ -20,8 +20,10 @@
 
 #include <algorithm>
 #include <sstream>
+#include <utility>
 #include <vector>
 #include <brick/common/expect.hh>
+#include <brick/numeric/arrayAllocator.hh>
 #include <brick/numeric/numericTraits.hh>
 
 namespace brick {
@@ -145,7 +147,8 @@ namespace brick {
     template <class Type>
     Array1D<Type>::
     Array1D(const Array1D<Type>& source)
-      : m_size(source.m_size),
+      : Array1DExpression< Type, Array1D<Type> >(),
+        m_size(source.m_size),
         m_dataPtr(source.m_dataPtr),
         m_referenceCount(source.m_referenceCount)
     {
@@ -153,6 +156,35 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array1D<Type>::
+    Array1D(Array1D<Type>&& source) noexcept
+      : Array1DExpression< Type, Array1D<Type> >(),
+        m_size(source.m_size),
+        m_dataPtr(source.m_dataPtr),
+        m_referenceCount(std::move(source.m_referenceCount))
+    {
+      source.m_size = 0;
+      source.m_dataPtr = 0;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array1D<Type>::
+    Array1D(const Array1DExpression<Type, Derived>& expression)
+      : Array1DExpression< Type, Array1D<Type> >(),
+        m_size(0),
+        m_dataPtr(0),
+        m_referenceCount(0)
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+      this->allocate(node.getSize());
+      privateCode::evaluateArray1DNode(node, m_dataPtr);
+    }
+
+
     template <class Type>
     Array1D<Type>::
     Array1D(size_t arraySize, Type* const dataPtr)
@@ -243,6 +275,27 @@ namespace brick {
     }
 
 
+    template <class Type> template <class Derived>
+    void
+    Array1D<Type>::
+    copy(const Array1DExpression<Type, Derived>& expression)
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+      if(node.getSize() != m_size) {
+        std::ostringstream message;
+        message << "Mismatched array sizes. Source array has "
+                << node.getSize() << " elements, while destination array has "
+                << m_size << " elements.";
+        BRICK_THROW(common::ValueException,
+                    "Array1D::copy(const Array1DExpression&)",
+                    message.str().c_str());
+      }
+      privateCode::evaluateArray1DNode(node, m_dataPtr);
+    }
+
+
     template <class Type> template <class Type2>
     void
     Array1D<Type>::
@@ -381,6 +434,50 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array1D<Type>& Array1D<Type>::
+    operator=(Array1D<Type>&& source) noexcept
+    {
+      // Check for self-assignment
+      if(&source != this) {
+        this->deAllocate();
+        m_size = source.m_size;
+        m_dataPtr = source.m_dataPtr;
+        m_referenceCount = std::move(source.m_referenceCount);
+        source.m_size = 0;
+        source.m_dataPtr = 0;
+      }
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array1D<Type>&
+    Array1D<Type>::
+    operator=(const Array1DExpression<Type, Derived>& expression)
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+
+      // If nobody else can see our data, and it's already the right
+      // size, there's no need to allocate.  References to our own
+      // data inside the expression are handled by
+      // evaluateArray1DNode().
+      if(node.getSize() == m_size
+         && m_referenceCount.isCounted() && !m_referenceCount.isShared()) {
+        privateCode::evaluateArray1DNode(node, m_dataPtr);
+      } else {
+        // Evaluate before releasing our current data, in case the
+        // expression refers to it.
+        Array1D<Type> result(node.getSize());
+        privateCode::evaluateArray1DNode(node, result.m_dataPtr);
+        *this = result;
+      }
+      return *this;
+    }
+
+
     template <class Type> template <class Type2>
     Array1D<Type>&
     Array1D<Type>::
@@ -502,6 +599,86 @@ namespace brick {
     }
 
 
+    template <class Type> template <class Derived>
+    Array1D<Type>&
+    Array1D<Type>::
+    operator+=(const Array1DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray1DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array1DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Array1D<Type>, Derived, privateCode::ExpressionPlus>::ResultType
+        NodeType;
+      privateCode::evaluateArray1DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array1D::operator+=()"),
+        m_dataPtr);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array1D<Type>&
+    Array1D<Type>::
+    operator-=(const Array1DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray1DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array1DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Array1D<Type>, Derived, privateCode::ExpressionMinus>::ResultType
+        NodeType;
+      privateCode::evaluateArray1DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array1D::operator-=()"),
+        m_dataPtr);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array1D<Type>&
+    Array1D<Type>::
+    operator*=(const Array1DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray1DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array1DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Array1D<Type>, Derived, privateCode::ExpressionMultiplies>::ResultType
+        NodeType;
+      privateCode::evaluateArray1DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array1D::operator*=()"),
+        m_dataPtr);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array1D<Type>&
+    Array1D<Type>::
+    operator/=(const Array1DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray1DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array1DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Array1D<Type>, Derived, privateCode::ExpressionDivides>::ResultType
+        NodeType;
+      privateCode::evaluateArray1DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array1D::operator/=()"),
+        m_dataPtr);
+      return *this;
+    }
+
+
     template <class Type>
     Array1D<Type>&
     Array1D<Type>::
@@ -537,9 +714,9 @@ namespace brick {
       // for a zero size array.
       m_size = arraySize;
       if(m_size > 0) {
-        // Allocate data storage.  new() should throw an exception if
-        // we run out of memory.
-        m_dataPtr = new Type[m_size];
+        // Allocate data storage through the current ArrayAllocator,
+        // which throws std::bad_alloc if we run out of memory.
+        m_dataPtr = privateCode::allocateArrayStorage<Type>(m_size);
 
         // Set reference count to show that exactly one Array is pointing
         // to this data.
@@ -573,18 +750,17 @@ namespace brick {
     void Array1D<Type>::
     deAllocate()
     {
-      // Are we responsible for deallocating the contents of this array?
-      if(m_referenceCount.isCounted()) {
-        // If yes, are we currently the only array pointing to this data?
-        if(!m_referenceCount.isShared()) {
-          // If yes, then delete the data.
-          delete[] m_dataPtr;
-        }
+      // If we are responsible for deallocating the contents of this
+      // array, and were the last array pointing to this data, then
+      // delete the data.  Releasing and testing in one step keeps
+      // this correct when other threads are releasing copies at the
+      // same time.
+      if(m_referenceCount.release()) {
+        privateCode::releaseArrayStorage(m_dataPtr);
       }
-      // Abandon our pointers to data.  Reference would take care of
-      // itself, but it's cleaner conceptually to wipe it here, rather
-      // than waiting for a subsequent call to ~ReferenceCount() or
-      // ReferenceCount.allocate().
+      // Abandon our pointers to data.  The release() call above has
+      // already left m_referenceCount uncounted, but it's cleaner
+      // conceptually to reset it explicitly here.
       m_dataPtr = 0;
       m_size = 0;
       m_referenceCount.reset(0);
@@ -592,149 +768,155 @@ namespace brick {
 
     /* Non-member functions which should maybe wind up in a different file. */
 
-    template <class Type>
-    Array1D<Type> operator+(const Array1D<Type>& array0,
-                            const Array1D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array1DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionPlus>::ResultType
+    operator+(const Array1DExpression<Type, Derived0>& array0,
+              const Array1DExpression<Type, Derived1>& array1)
     {
-      if(array0.size() != array1.size()) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 has " << array0.size()
-                << " elements, while array1 has " << array1.size()
-                << " elements.";
-        BRICK_THROW(common::ValueException, "Array1D::operator+()", message.str().c_str());
-      }
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), array1.begin(),
-                     result.begin(), std::plus<Type>());
-      return result;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionPlus>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array1D::operator+()");
     }
 
 
-    template <class Type>
-    Array1D<Type> operator-(const Array1D<Type>& array0,
-                            const Array1D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array1DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMinus>::ResultType
+    operator-(const Array1DExpression<Type, Derived0>& array0,
+              const Array1DExpression<Type, Derived1>& array1)
     {
-      if(array0.size() != array1.size()) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 has " << array0.size()
-                << " elements, while array1 has " << array1.size()
-                << " elements.";
-        BRICK_THROW(common::ValueException, "Array1D::operator-()", message.str().c_str());
-      }
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), array1.begin(),
-                     result.begin(), std::minus<Type>());
-      return result;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionMinus>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array1D::operator-()");
     }
 
 
-    template <class Type>
-    Array1D<Type> operator*(const Array1D<Type>& array0,
-                            const Array1D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array1DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMultiplies>::ResultType
+    operator*(const Array1DExpression<Type, Derived0>& array0,
+              const Array1DExpression<Type, Derived1>& array1)
     {
-      if(array0.size() != array1.size()) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 has " << array0.size()
-                << " elements, while array1 has " << array1.size()
-                << " elements.";
-        BRICK_THROW(common::ValueException, "Array1D::operator*()", message.str().c_str());
-      }
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), array1.begin(),
-                     result.begin(), std::multiplies<Type>());
-      return result;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionMultiplies>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array1D::operator*()");
     }
 
 
-    template <class Type>
-    Array1D<Type> operator/(const Array1D<Type>& array0,
-                            const Array1D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array1DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionDivides>::ResultType
+    operator/(const Array1DExpression<Type, Derived0>& array0,
+              const Array1DExpression<Type, Derived1>& array1)
     {
-      if(array0.size() != array1.size()) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 has " << array0.size()
-                << " elements, while array1 has " << array1.size()
-                << " elements.";
-        BRICK_THROW(common::ValueException, "Array1D::operator/()", message.str().c_str());
-      }
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), array1.begin(),
-                     result.begin(), std::divides<Type>());
-      return result;
+      typedef typename privateCode::Array1DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionDivides>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array1D::operator/()");
     }
 
 
-    template <class Type>
-    Array1D<Type> operator+(const Array1D<Type>& array0, Type scalar)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, false>::ResultType
+    operator+(const Array1DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind2nd(std::plus<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionPlus, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    Array1D<Type> operator-(const Array1D<Type>& array0, Type scalar)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, false>::ResultType
+    operator-(const Array1DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind2nd(std::minus<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionMinus, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    Array1D<Type> operator*(const Array1D<Type>& array0, Type scalar)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, false>::ResultType
+    operator*(const Array1DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind2nd(std::multiplies<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionMultiplies, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    Array1D<Type> operator/(const Array1D<Type>& array0, Type scalar)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, false>::ResultType
+    operator/(const Array1DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind2nd(std::divides<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionDivides, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    inline Array1D<Type> operator+(Type scalar, const Array1D<Type>& array0)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, true>::ResultType
+    operator+(Type scalar, const Array1DExpression<Type, Derived>& array0)
     {
-      return array0 + scalar;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionPlus, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    Array1D<Type> operator-(Type scalar, const Array1D<Type>& array0)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, true>::ResultType
+    operator-(Type scalar, const Array1DExpression<Type, Derived>& array0)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind1st(std::minus<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionMinus, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    inline Array1D<Type> operator*(Type scalar, const Array1D<Type>& array0)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, true>::ResultType
+    operator*(Type scalar, const Array1DExpression<Type, Derived>& array0)
     {
-      return array0 * scalar;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionMultiplies, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
-    template <class Type>
-    Array1D<Type> operator/(Type scalar, const Array1D<Type>& array0)
+    template <class Type, class Derived>
+    inline typename privateCode::Array1DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, true>::ResultType
+    operator/(Type scalar, const Array1DExpression<Type, Derived>& array0)
     {
-      Array1D<Type> result(array0.size());
-      std::transform(array0.begin(), array0.end(), result.begin(),
-                     std::bind1st(std::divides<Type>(), scalar));
-      return result;
+      typedef typename privateCode::Array1DScalarResult<
+        Type, Derived, privateCode::ExpressionDivides, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
 
@@ -807,6 +989,55 @@ namespace brick {
     }
 
 
+    template <class Type, class Derived>
+    Array1D<bool>
+    operator==(const Array1DExpression<Type, Derived>& array0, const Type arg)
+    {
+      return Array1D<Type>(array0) == arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array1D<bool>
+    operator>(const Array1DExpression<Type, Derived>& array0, const Type arg)
+    {
+      return Array1D<Type>(array0) > arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array1D<bool>
+    operator>=(const Array1DExpression<Type, Derived>& array0, const Type arg)
+    {
+      return Array1D<Type>(array0) >= arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array1D<bool>
+    operator<(const Array1DExpression<Type, Derived>& array0, const Type arg)
+    {
+      return Array1D<Type>(array0) < arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array1D<bool>
+    operator<=(const Array1DExpression<Type, Derived>& array0, const Type arg)
+    {
+      return Array1D<Type>(array0) <= arg;
+    }
+
+
+    template <class Type, class Derived0, class Derived1>
+    Array1D<bool>
+    operator==(const Array1DExpression<Type, Derived0>& array0,
+               const Array1DExpression<Type, Derived1>& array1)
+    {
+      return Array1D<Type>(array0) == Array1D<Type>(array1);
+    }
+
+
     template <class Type>
     std::ostream& operator<<(std::ostream& stream, const Array1D<Type>& array0)
     {
@@ -831,6 +1062,16 @@ namespace brick {
       return stream;
     }
 
+    // Outputs a text representation of an elementwise arithmetic
+    // expression to a std::ostream.
+    template <class Type, class Derived>
+    std::ostream&
+    operator<<(std::ostream& stream,
+               const Array1DExpression<Type, Derived>& array0)
+    {
+      return stream << Array1D<Type>(array0);
+    }
+
     // Sets the value of an Array1D instance from a std::istream.
     template <class Type>
     std::istream& operator>>(std::istream& inputStream, Array1D<Type>& array0)
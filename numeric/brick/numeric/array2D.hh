@@ -19,6 +19,7 @@
 #include <iostream>
 #include <brick/common/exception.hh>
 #include <brick/numeric/array1D.hh>
+#include <brick/numeric/arrayExpression.hh>
 #include <brick/numeric/index2D.hh>
 
 namespace brick {
@@ -52,9 +53,15 @@ namespace brick {
      ** The advantage of the first form is that it doesn't involve allocating
      ** memory.  The advantage of the second form is that there's no error if
      ** array1 and array2 have different shapes.
+     **
+     ** Elementwise arithmetic operators, such as operator+(), are
+     ** evaluated lazily.  Please see the documentation of
+     ** Array1DExpression for details.
      **/
     template <class Type>
-    class Array2D {
+    class Array2D
+      : public Array2DExpression< Type, Array2D<Type> >
+    {
     public:
 
       /* ******** Public typedefs ******** */
@@ -145,6 +152,29 @@ namespace brick {
       Array2D(const Array2D<Type> &source);
 
 
+      /**
+       * The move constructor takes over the data and reference count
+       * of source, without touching the count, and leaves source
+       * empty.
+       *
+       * @param source The Array2D<> instance to be moved from.
+       */
+      Array2D(Array2D<Type>&& source) noexcept;
+
+
+      /**
+       * This constructor evaluates an elementwise arithmetic
+       * expression, such as (array0 * array1 + array2), into a newly
+       * allocated array, visiting each element only once.  It is not
+       * explicit, so expressions can be passed directly to functions
+       * that accept Array2D arguments.
+       *
+       * @param expression The expression to be evaluated.
+       */
+      template <class Derived>
+      Array2D(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Construct an array around external data.  Arrays constructed in
        * this way will not implement reference counting, and will not
@@ -332,6 +362,23 @@ namespace brick {
       copy(const Array2D<Type2>& source);
 
 
+      /**
+       * Evaluates an elementwise arithmetic expression, such as
+       * (array0 * array1 + array2), directly into the existing
+       * storage of *this.  It is an error if the expression does not
+       * have the same size as *this.  As with copy(const Array2D&),
+       * the number of rows and columns need not match exactly,
+       * as long as their product is right, and both *this and the
+       * arrays in the expression have contiguous rows.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @exception ValueException thrown when array sizes do not match.
+       */
+      template <class Derived> void
+      copy(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Copies elements from dataPtr.  There must be valid data at all
        * addresses from dataPtr to (dataPtr + this->size());
@@ -810,6 +857,28 @@ namespace brick {
       isReferenceCounted() const {return m_referenceCount.isCounted();}
 
 
+      /**
+       * Selects whether the reference count shared by *this and its
+       * shallow copies is updated using atomic operations (see
+       * common::ReferenceCount::setThreadSafe()).  Call this before
+       * handing shallow copies of the array to other threads, so that
+       * the copies can be made and destroyed concurrently.  This
+       * protects only the bookkeeping, not the array elements, and
+       * lasts until the array is reinitialized.  Building with
+       * BRICK_COMMON_THREADSAFE_REFERENCECOUNT set to a nonzero value
+       * makes every array thread-safe in this sense.  This member
+       * function has no effect on arrays that are not reference
+       * counted.
+       *
+       * @param isThreadSafe This argument specifies whether the count
+       * should use atomic operations.
+       */
+      void
+      setReferenceCountThreadSafe(bool isThreadSafe=true) {
+        m_referenceCount.setThreadSafe(isThreadSafe);
+      }
+
+
       /**
        * Returns an Array1D, with size equal to this->getSize(), which
        * references the same data as *this.  In other words, ravel()
@@ -1093,6 +1162,37 @@ namespace brick {
       operator=(const Array2D<Type>& source);
 
 
+      /**
+       * Move assignment releases the data currently referenced by
+       * *this, then takes over the data and reference count of
+       * source, leaving source empty.
+       *
+       * @param source The Array2D instance to be moved from.
+       *
+       * @return Reference to *this.
+       */
+      Array2D<Type>&
+      operator=(Array2D<Type>&& source) noexcept;
+
+
+      /**
+       * Evaluates an elementwise arithmetic expression, such as
+       * (array0 * array1 + array2), and assigns the result to *this.
+       * If *this already has the right shape, and does not share its
+       * data with any other array, the result is written directly
+       * into the existing storage, and no memory is allocated.
+       * Otherwise, *this is pointed at newly allocated storage, just
+       * as if a newly constructed array had been assigned to it.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @return Reference to *this.
+       */
+      template <class Derived>
+      Array2D<Type>&
+      operator=(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Assign value to every element in the array.
        *
@@ -1258,6 +1358,23 @@ namespace brick {
       operator+=(Type arg);
 
 
+      /**
+       * Increments each element of *this by the value of the
+       * corresponding element of an elementwise arithmetic
+       * expression.  The expression is evaluated on the fly, without
+       * allocating a temporary array.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @exception ValueException thrown when array sizes differ.
+       *
+       * @return Reference to *this.
+       */
+      template <class Derived>
+      Array2D<Type>&
+      operator+=(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Decrements each element of *this by a constant.
        *
@@ -1269,6 +1386,23 @@ namespace brick {
       operator-=(Type arg);
 
 
+      /**
+       * Decrements each element of *this by the value of the
+       * corresponding element of an elementwise arithmetic
+       * expression.  The expression is evaluated on the fly, without
+       * allocating a temporary array.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @exception ValueException thrown when array sizes differ.
+       *
+       * @return Reference to *this.
+       */
+      template <class Derived>
+      Array2D<Type>&
+      operator-=(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Multiplies each element of *this by a constant.
        *
@@ -1280,6 +1414,23 @@ namespace brick {
       operator*=(Type arg);
 
 
+      /**
+       * Multiplies each element of *this by the value of the
+       * corresponding element of an elementwise arithmetic
+       * expression.  The expression is evaluated on the fly, without
+       * allocating a temporary array.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @exception ValueException thrown when array sizes differ.
+       *
+       * @return Reference to *this.
+       */
+      template <class Derived>
+      Array2D<Type>&
+      operator*=(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * Divides each element of *this by a constant.
        *
@@ -1291,6 +1442,23 @@ namespace brick {
       operator/=(Type arg);
 
 
+      /**
+       * Divides each element of *this by the value of the
+       * corresponding element of an elementwise arithmetic
+       * expression.  The expression is evaluated on the fly, without
+       * allocating a temporary array.
+       *
+       * @param expression The expression to be evaluated.
+       *
+       * @exception ValueException thrown when array sizes differ.
+       *
+       * @return Reference to *this.
+       */
+      template <class Derived>
+      Array2D<Type>&
+      operator/=(const Array2DExpression<Type, Derived>& expression);
+
+
       /**
        * For integral Types, left-shifts each element of *this by the
        * specified number of bits.  This is equivalent to multiplying
@@ -1462,175 +1630,289 @@ namespace brick {
 
 
     /**
-     * Elementwise addition of Array2D instances.
+     * This function returns an array that is the same size as its
+     * argument, and in which the value of each element is the square
+     * root of the corresponding element of an elementwise arithmetic
+     * expression.
+     *
+     * @param array0 The expression to be evaluated, after which the
+     * square root calculation will be performed for each element.
      *
-     * @param array0 First argument for addition.
+     * @return An array of square root values.
+     */
+    template <class Type, class Derived>
+    Array2D<Type>
+    squareRoot(const Array2DExpression<Type, Derived>& array0);
+
+
+    /**
+     * This function is an alias for
+     * squareRoot(const Array2DExpression&), above.
      *
-     * @param array1 Second argument for addition.
+     * @param array0 The expression to be evaluated, after which the
+     * square root calculation will be performed for each element.
+     *
+     * @return An array of square root values.
+     */
+    template <class Type, class Derived>
+    inline Array2D<Type>
+    sqrt(const Array2DExpression<Type, Derived>& array0);
+
+
+    /**
+     * Elementwise addition of Array2D instances.  The addition is not
+     * performed immediately.  Instead, the return value records the
+     * operation so that it can be combined with other elementwise
+     * operations, and then evaluated in a single pass when it is
+     * assigned to an Array2D.
+     *
+     * @param array0 First argument for addition.  This may be an
+     * Array2D, or the result of another elementwise operation.
+     *
+     * @param array1 Second argument for addition.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
      * @exception ValueException thrown when array sizes differ.
      *
-     * @return Array2D instance in which the value of each element is
-     * the sum of the values of the corresponding elements of the two
-     * Array2D arguments.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the sum of the values of the
+     * corresponding elements of the two arguments.
      */
-    template <class Type>
-    Array2D<Type>
-    operator+(const Array2D<Type>& array0,
-              const Array2D<Type>& array1);
+    template <class Type, class Derived0, class Derived1>
+    typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionPlus>::ResultType
+    operator+(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1);
 
 
     /**
-     * Elementwise subtraction of Array2D instances.
+     * Elementwise subtraction of Array2D instances.  The subtraction is not
+     * performed immediately.  Instead, the return value records the
+     * operation so that it can be combined with other elementwise
+     * operations, and then evaluated in a single pass when it is
+     * assigned to an Array2D.
      *
-     * @param array0 First argument for subtraction.
+     * @param array0 First argument for subtraction.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
-     * @param array1 Second argument for subtraction.
+     * @param array1 Second argument for subtraction.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
      * @exception ValueException thrown when array sizes differ.
      *
-     * @return Array2D instance in which the value of each element is
-     * the difference of the values of the corresponding elements of the two
-     * Array2D arguments.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the difference of the values of the
+     * corresponding elements of the two arguments.
      */
-    template <class Type>
-    Array2D<Type>
-    operator-(const Array2D<Type>& array0,
-              const Array2D<Type>& array1);
+    template <class Type, class Derived0, class Derived1>
+    typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMinus>::ResultType
+    operator-(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1);
 
 
     /**
-     * Elementwise multiplication of Array2D instances.
+     * Elementwise multiplication of Array2D instances.  The multiplication is not
+     * performed immediately.  Instead, the return value records the
+     * operation so that it can be combined with other elementwise
+     * operations, and then evaluated in a single pass when it is
+     * assigned to an Array2D.
      *
-     * @param array0 First argument for multiplication.
+     * @param array0 First argument for multiplication.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
-     * @param array1 Second argument for multiplication.
+     * @param array1 Second argument for multiplication.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
      * @exception ValueException thrown when array sizes differ.
      *
-     * @return Array2D instance in which the value of each element is
-     * the product of the values of the corresponding elements of the two
-     * Array2D arguments.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the product of the values of the
+     * corresponding elements of the two arguments.
      */
-    template <class Type>
-    Array2D<Type>
-    operator*(const Array2D<Type>& array0,
-              const Array2D<Type>& array1);
+    template <class Type, class Derived0, class Derived1>
+    typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMultiplies>::ResultType
+    operator*(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1);
 
 
     /**
-     * Elementwise division of Array2D instances.
+     * Elementwise division of Array2D instances.  The division is not
+     * performed immediately.  Instead, the return value records the
+     * operation so that it can be combined with other elementwise
+     * operations, and then evaluated in a single pass when it is
+     * assigned to an Array2D.
      *
-     * @param array0 First argument for division.
+     * @param array0 First argument for division.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
-     * @param array1 Second argument for division.
+     * @param array1 Second argument for division.  This may be an
+     * Array2D, or the result of another elementwise operation.
      *
      * @exception ValueException thrown when array sizes differ.
      *
-     * @return Array2D instance in which the value of each element is
-     * the dividend of the values of the corresponding elements of the two
-     * Array2D arguments.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the quotient of the values of the
+     * corresponding elements of the two arguments.
      */
-    template <class Type>
-    Array2D<Type>
-    operator/(const Array2D<Type>& array0,
-              const Array2D<Type>& array1);
+    template <class Type, class Derived0, class Derived1>
+    typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionDivides>::ResultType
+    operator/(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1);
 
 
     /**
-     * Addition of Array2D and scalar.
+     * Addition of Array2D and scalar.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
-     * @param array0 Array2D argument of the addition.
+     * @param array0 Array2D argument of the addition.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
      * @param scalar Scalar argument of the addition.
      *
-     * @return Array2D instance in which the value of each element is
-     * the sum of the corresponding element of the Array2D argument and
-     * the scalar argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the sum of the corresponding
+     * element of the Array2D argument and the scalar argument.
      */
-    template <class Type>
-    Array2D<Type>
-    operator+(const Array2D<Type>& array0, Type scalar);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, false>::ResultType
+    operator+(const Array2DExpression<Type, Derived>& array0, Type scalar);
 
 
     /**
-     * Subtraction of Array2D and scalar.
+     * Subtraction of Array2D and scalar.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
-     * @param array0 Array2D argument of the subtraction.
+     * @param array0 Array2D argument of the subtraction.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
      * @param scalar Scalar argument of the subtraction.
      *
-     * @return Array2D instance in which the value of each element is
-     * the difference of the corresponding element of the Array2D
-     * argument and the scalar argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the difference of the corresponding
+     * element of the Array2D argument and the scalar argument.
      */
-    template <class Type>
-    Array2D<Type>
-    operator-(const Array2D<Type>& array0, Type scalar);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, false>::ResultType
+    operator-(const Array2DExpression<Type, Derived>& array0, Type scalar);
 
 
     /**
-     * Multiplication of Array2D and scalar.
+     * Multiplication of Array2D and scalar.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
-     * @param array0 Array2D argument of the multiplication.
+     * @param array0 Array2D argument of the multiplication.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
      * @param scalar Scalar argument of the multiplication.
      *
-     * @return Array2D instance in which the value of each element is
-     * the product of the corresponding element of the Array2D argument
-     * and the scalar argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the product of the corresponding
+     * element of the Array2D argument and the scalar argument.
      */
-    template <class Type>
-    Array2D<Type>
-    operator*(const Array2D<Type>& array0, Type scalar);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, false>::ResultType
+    operator*(const Array2DExpression<Type, Derived>& array0, Type scalar);
 
 
     /**
-     * Division of Array2D and scalar.
+     * Division of Array2D and scalar.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
-     * @param array0 Array2D argument of the division.
+     * @param array0 Array2D argument of the division.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
      * @param scalar Scalar argument of the division.
      *
-     * @return Array2D instance in which the value of each element is
-     * the difference of the corresponding element of the Array2D
-     * argument and the scalar argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the quotient of the corresponding
+     * element of the Array2D argument and the scalar argument.
      */
-    template <class Type>
-    Array2D<Type>
-    operator/(const Array2D<Type>& array0, Type scalar);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, false>::ResultType
+    operator/(const Array2DExpression<Type, Derived>& array0, Type scalar);
 
 
     /**
-     * Addition of scalar and Array2D.
+     * Addition of scalar and Array2D.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
      * @param scalar Scalar argument of the addition.
      *
-     * @param array0 Array2D argument of the addition.
+     * @param array0 Array2D argument of the addition.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
-     * @return Array2D instance in which the value of each element is
-     * the sum of the scalar argument and the corresponding element of
-     * the Array2D argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the sum of the scalar argument
+     * and the corresponding element of the Array2D argument.
      */
-    template <class Type>
-    inline Array2D<Type>
-    operator+(Type scalar, const Array2D<Type>& array0);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, true>::ResultType
+    operator+(Type scalar, const Array2DExpression<Type, Derived>& array0);
+
+
+    /**
+     * Subtraction of scalar and Array2D.  Like the elementwise
+     * operators, this operator is evaluated lazily.
+     *
+     * @param scalar Scalar argument of the subtraction.
+     *
+     * @param array0 Array2D argument of the subtraction.  This may be an
+     * Array2D, or the result of an elementwise operation.
+     *
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the difference of the scalar argument
+     * and the corresponding element of the Array2D argument.
+     */
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, true>::ResultType
+    operator-(Type scalar, const Array2DExpression<Type, Derived>& array0);
 
 
     /**
-     * Multiplication of scalar and Array2D.
+     * Multiplication of scalar and Array2D.  Like the elementwise
+     * operators, this operator is evaluated lazily.
      *
      * @param scalar Scalar argument of the multiplication.
      *
-     * @param array0 Array2D argument of the multiplication.
+     * @param array0 Array2D argument of the multiplication.  This may be an
+     * Array2D, or the result of an elementwise operation.
      *
-     * @return Array2D instance in which the value of each element is
-     * the product of the scalar argument and the corresponding element
-     * of the Array2D argument.
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the product of the scalar argument
+     * and the corresponding element of the Array2D argument.
      */
-    template <class Type>
-    inline Array2D<Type>
-    operator*(Type scalar, const Array2D<Type>& array0);
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, true>::ResultType
+    operator*(Type scalar, const Array2DExpression<Type, Derived>& array0);
+
+
+    /**
+     * Division of scalar and Array2D.  Like the elementwise
+     * operators, this operator is evaluated lazily.
+     *
+     * @param scalar Scalar argument of the division.
+     *
+     * @param array0 Array2D argument of the division.  This may be an
+     * Array2D, or the result of an elementwise operation.
+     *
+     * @return Expression which evaluates to an Array2D in which the
+     * value of each element is the quotient of the scalar argument
+     * and the corresponding element of the Array2D argument.
+     */
+    template <class Type, class Derived>
+    typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, true>::ResultType
+    operator/(Type scalar, const Array2DExpression<Type, Derived>& array0);
 
 
     /**
@@ -1732,6 +2014,115 @@ namespace brick {
     operator<=(const Array2D<Type>& array0, Type arg);
 
 
+    /**
+     * Elementwise comparison of an elementwise arithmetic expression
+     * with a constant.  The expression is evaluated before the
+     * comparison.
+     *
+     * @param array0 The expression to be compared.
+     *
+     * @param arg Value to which the elements of array0 should be
+     * compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding element of array0 is equal to arg.
+     */
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator==(const Array2DExpression<Type, Derived>& array0,
+               const Type arg);
+
+
+    /**
+     * Elementwise comparison of two arrays, either of which may be
+     * an elementwise arithmetic expression.  Expressions are
+     * evaluated before the comparison.
+     *
+     * @param array0 The first array or expression to be compared.
+     *
+     * @param array1 The second array or expression to be compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding elements of array0 and array1 are equal.
+     */
+    template <class Type, class Derived0, class Derived1>
+    Array2D<bool>
+    operator==(const Array2DExpression<Type, Derived0>& array0,
+               const Array2DExpression<Type, Derived1>& array1);
+
+
+    /**
+     * Elementwise comparison of an elementwise arithmetic expression
+     * with a constant.  The expression is evaluated before the
+     * comparison.
+     *
+     * @param array0 The expression to be compared.
+     *
+     * @param arg Value to which the elements of array0 should be
+     * compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding element of array0 is greater than arg.
+     */
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator>(const Array2DExpression<Type, Derived>& array0, Type arg);
+
+
+    /**
+     * Elementwise comparison of an elementwise arithmetic expression
+     * with a constant.  The expression is evaluated before the
+     * comparison.
+     *
+     * @param array0 The expression to be compared.
+     *
+     * @param arg Value to which the elements of array0 should be
+     * compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding element of array0 is less than arg.
+     */
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator<(const Array2DExpression<Type, Derived>& array0, Type arg);
+
+
+    /**
+     * Elementwise comparison of an elementwise arithmetic expression
+     * with a constant.  The expression is evaluated before the
+     * comparison.
+     *
+     * @param array0 The expression to be compared.
+     *
+     * @param arg Value to which the elements of array0 should be
+     * compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding element of array0 is greater than or equal to arg.
+     */
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator>=(const Array2DExpression<Type, Derived>& array0, Type arg);
+
+
+    /**
+     * Elementwise comparison of an elementwise arithmetic expression
+     * with a constant.  The expression is evaluated before the
+     * comparison.
+     *
+     * @param array0 The expression to be compared.
+     *
+     * @param arg Value to which the elements of array0 should be
+     * compared.
+     *
+     * @return An Array2D<bool> in which each element has value "true"
+     * if the corresponding element of array0 is less than or equal to arg.
+     */
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator<=(const Array2DExpression<Type, Derived>& array0, Type arg);
+
+
     /**
      * Outputs a text representation of an Array2D instance to a
      * std::ostream.  The output format looks like this:
@@ -1755,6 +2146,26 @@ namespace brick {
     operator<<(std::ostream& stream, const Array2D<Type>& array0);
 
 
+    /**
+     * Outputs a text representation of an elementwise arithmetic
+     * expression to a std::ostream.  The expression is evaluated,
+     * and the result is formatted as described for
+     * operator<<(std::ostream&, const Array2D<Type>&), above.
+     *
+     * @param stream Reference to the the output stream.
+     *
+     * @param array0 const Reference to the expression to be output.
+     *
+     * @exception IOException on invalid stream.
+     *
+     * @return Reference to output stream.
+     */
+    template <class Type, class Derived>
+    std::ostream&
+    operator<<(std::ostream& stream,
+               const Array2DExpression<Type, Derived>& array0);
+
+
     /**
      * Sets the value of an Array2D instance from a std::istream.
      * The input format is as described for
@@ -21,10 +21,12 @@
 #include <algorithm>
 #include <functional>
 #include <sstream>
+#include <utility>
 #include <vector>
 #include <brick/common/expect.hh>
 #include <brick/common/functional.hh>
 #include <brick/numeric/functional.hh>
+#include <brick/numeric/arrayAllocator.hh>
 #include <brick/numeric/numericTraits.hh>
 
 namespace brick {
@@ -163,7 +165,8 @@ namespace brick {
     template <class Type>
     Array2D<Type>::
     Array2D(const Array2D<Type>& source)
-      : m_rows(source.m_rows),
+      : Array2DExpression< Type, Array2D<Type> >(),
+        m_rows(source.m_rows),
         m_columns(source.m_columns),
         m_rowStep(source.m_rowStep),
         m_size(source.m_size),
@@ -175,6 +178,47 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array2D<Type>::
+    Array2D(Array2D<Type>&& source) noexcept
+      : Array2DExpression< Type, Array2D<Type> >(),
+        m_rows(source.m_rows),
+        m_columns(source.m_columns),
+        m_rowStep(source.m_rowStep),
+        m_size(source.m_size),
+        m_storageSize(source.m_storageSize),
+        m_dataPtr(source.m_dataPtr),
+        m_referenceCount(std::move(source.m_referenceCount))
+    {
+      source.m_rows = 0;
+      source.m_columns = 0;
+      source.m_rowStep = 0;
+      source.m_size = 0;
+      source.m_storageSize = 0;
+      source.m_dataPtr = 0;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array2D<Type>::
+    Array2D(const Array2DExpression<Type, Derived>& expression)
+      : Array2DExpression< Type, Array2D<Type> >(),
+        m_rows(0),
+        m_columns(0),
+        m_rowStep(0),
+        m_size(0),
+        m_storageSize(0),
+        m_dataPtr(0),
+        m_referenceCount(0)
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+      this->allocate(node.getRows(), node.getColumns(), 0);
+      privateCode::evaluateArray2DNode(node, m_dataPtr, m_rowStep);
+    }
+
+
     /* Here's a constructor for getting image data into the array */
     /* cheaply. */
     template <class Type>
@@ -341,6 +385,38 @@ namespace brick {
     }
 
 
+    template <class Type> template <class Derived>
+    void
+    Array2D<Type>::
+    copy(const Array2DExpression<Type, Derived>& expression)
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+      const size_t sourceSize = node.getRows() * node.getColumns();
+      const bool isSameShape = (node.getRows() == m_rows
+                                && node.getColumns() == m_columns);
+      if(sourceSize != m_size
+         || !(isSameShape || (this->isContiguous() && node.isContiguous()))) {
+        std::ostringstream message;
+        message << "Mismatched array sizes. Source array is "
+                << node.getRows() << " x " << node.getColumns()
+                << ", while destination array is "
+                << m_rows << " x " << m_columns << ".";
+        BRICK_THROW(common::ValueException,
+                    "Array2D::copy(const Array2DExpression&)",
+                    message.str().c_str());
+      }
+      if(isSameShape) {
+        privateCode::evaluateArray2DNode(node, m_dataPtr, m_rowStep);
+      } else {
+        for(size_t index = 0; index < m_size; ++index) {
+          m_dataPtr[index] = node.getElement(index);
+        }
+      }
+    }
+
+
     template <class Type> template <class Type2>
     void Array2D<Type>::
     copy(const Type2* dataPtr)
@@ -674,6 +750,60 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array2D<Type>& Array2D<Type>::
+    operator=(Array2D<Type>&& source) noexcept
+    {
+      // Check for self-assignment
+      if(&source != this) {
+        this->deAllocate();
+        m_rows = source.m_rows;
+        m_columns = source.m_columns;
+        m_rowStep = source.m_rowStep;
+        m_size = source.m_size;
+        m_storageSize = source.m_storageSize;
+        m_dataPtr = source.m_dataPtr;
+        m_referenceCount = std::move(source.m_referenceCount);
+        source.m_rows = 0;
+        source.m_columns = 0;
+        source.m_rowStep = 0;
+        source.m_size = 0;
+        source.m_storageSize = 0;
+        source.m_dataPtr = 0;
+      }
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array2D<Type>&
+    Array2D<Type>::
+    operator=(const Array2DExpression<Type, Derived>& expression)
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+
+      // If nobody else can see our data, and it's already the right
+      // shape, there's no need to allocate.  References to our own
+      // data inside the expression are handled by
+      // evaluateArray2DNode().
+      if(node.getRows() == m_rows
+         && node.getColumns() == m_columns
+         && m_referenceCount.isCounted() && !m_referenceCount.isShared()) {
+        privateCode::evaluateArray2DNode(node, m_dataPtr, m_rowStep);
+      } else {
+        // Evaluate before releasing our current data, in case the
+        // expression refers to it.
+        Array2D<Type> result(node.getRows(), node.getColumns());
+        privateCode::evaluateArray2DNode(node, result.m_dataPtr,
+                                         result.m_rowStep);
+        *this = result;
+      }
+      return *this;
+    }
+
+
     template <class Type> template <class Type2>
     Array2D<Type>&
     Array2D<Type>::
@@ -812,6 +942,86 @@ namespace brick {
     }
 
 
+    template <class Type> template <class Derived>
+    Array2D<Type>&
+    Array2D<Type>::
+    operator+=(const Array2DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray2DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array2DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Array2D<Type>, Derived, privateCode::ExpressionPlus>::ResultType
+        NodeType;
+      privateCode::evaluateArray2DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array2D::operator+=()"),
+        m_dataPtr, m_rowStep);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array2D<Type>&
+    Array2D<Type>::
+    operator-=(const Array2DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray2DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array2DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Array2D<Type>, Derived, privateCode::ExpressionMinus>::ResultType
+        NodeType;
+      privateCode::evaluateArray2DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array2D::operator-=()"),
+        m_dataPtr, m_rowStep);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array2D<Type>&
+    Array2D<Type>::
+    operator*=(const Array2DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray2DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array2DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Array2D<Type>, Derived, privateCode::ExpressionMultiplies>::ResultType
+        NodeType;
+      privateCode::evaluateArray2DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array2D::operator*=()"),
+        m_dataPtr, m_rowStep);
+      return *this;
+    }
+
+
+    template <class Type> template <class Derived>
+    Array2D<Type>&
+    Array2D<Type>::
+    operator/=(const Array2DExpression<Type, Derived>& expression)
+    {
+      // Elements of *this may also appear in the expression.
+      // evaluateArray2DNode() copes with this, using a temporary
+      // array if the expression reads *this at a different offset.
+      typedef privateCode::Array2DReferenceNode<Type> ReferenceType;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Array2D<Type>, Derived, privateCode::ExpressionDivides>::ResultType
+        NodeType;
+      privateCode::evaluateArray2DNode(
+        NodeType(ReferenceType(*this), expression.getDerived(),
+                 "Array2D::operator/=()"),
+        m_dataPtr, m_rowStep);
+      return *this;
+    }
+
+
     template <class Type>
     Array2D<Type>&
     Array2D<Type>::
@@ -906,9 +1116,9 @@ namespace brick {
       m_size = m_rows * m_columns;
       m_storageSize = m_rows * m_rowStep;
       if(m_storageSize > 0) {
-        // Allocate data storage.  new() should throw an exception if
-        // we run out of memory.
-        m_dataPtr = new Type[m_storageSize];
+        // Allocate data storage through the current ArrayAllocator,
+        // which throws std::bad_alloc if we run out of memory.
+        m_dataPtr = privateCode::allocateArrayStorage<Type>(m_storageSize);
 
         // Set reference count to show that exactly one Array is pointing
         // to this data.
@@ -975,18 +1185,17 @@ namespace brick {
     void Array2D<Type>::
     deAllocate()
     {
-      // Are we responsible for deallocating the contents of this array?
-      if(m_referenceCount.isCounted()) {
-        // If yes, are we currently the only array pointing to this data?
-        if(!m_referenceCount.isShared()) {
-          // If yes, then delete the data.
-          delete[] m_dataPtr;
-        }
-      }
-      // Abandon our pointers to data.  Reference would take care of
-      // itself, but it's cleaner conceptually to wipe it here, rather
-      // than waiting for a subsequent call to ~ReferenceCount() or
-      // ReferenceCount.allocate().
+      // If we are responsible for deallocating the contents of this
+      // array, and were the last array pointing to this data, then
+      // delete the data.  Releasing and testing in one step keeps
+      // this correct when other threads are releasing copies at the
+      // same time.
+      if(m_referenceCount.release()) {
+        privateCode::releaseArrayStorage(m_dataPtr);
+      }
+      // Abandon our pointers to data.  The release() call above has
+      // already left m_referenceCount uncounted, but it's cleaner
+      // conceptually to reset it explicitly here.
       m_dataPtr = 0;
       m_size = 0;
       m_storageSize = 0;
@@ -1029,214 +1238,171 @@ namespace brick {
     }
 
 
-    template <class Type>
-    Array2D<Type> operator+(const Array2D<Type>& array0,
-                            const Array2D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionPlus>::ResultType
+    operator+(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1)
     {
-      if((array0.rows() != array1.rows())
-         || (array0.columns() != array1.columns())) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 is " << array0.rows()
-                << " x " << array0.columns() << ", while array1 is "
-                << array1.rows() << " x " << array1.columns() << ".";
-        BRICK_THROW(common::ValueException, "Array2D::operator+()",
-                    message.str().c_str());
-      }
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionPlus>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array2D::operator+()");
+    }
 
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous() && array1.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), array1.begin(),
-                       result.begin(), std::plus<Type>());
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> in0Row = array0.getRow(row);
-          Array1D<Type> in1Row = array1.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(in0Row.begin(), in0Row.end(), in1Row.begin(),
-                         outRow.begin(), std::plus<Type>());
-        }
-      }
-      return result;
+
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMinus>::ResultType
+    operator-(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1)
+    {
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionMinus>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array2D::operator-()");
     }
 
 
-    template <class Type>
-    Array2D<Type> operator-(const Array2D<Type>& array0,
-                            const Array2D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionMultiplies>::ResultType
+    operator*(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1)
     {
-      if((array0.rows() != array1.rows())
-         || (array0.columns() != array1.columns())) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 is " << array0.rows()
-                << " x " << array0.columns() << ", while array1 is "
-                << array1.rows() << " x " << array1.columns() << ".";
-        BRICK_THROW(common::ValueException, "Array2D::operator-()",
-                    message.str().c_str());
-      }
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous() && array1.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), array1.begin(),
-                       result.begin(), std::minus<Type>());
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> in0Row = array0.getRow(row);
-          Array1D<Type> in1Row = array1.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(in0Row.begin(), in0Row.end(), in1Row.begin(),
-                         outRow.begin(), std::minus<Type>());
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionMultiplies>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array2D::operator*()");
     }
 
 
-    template <class Type>
-    Array2D<Type> operator*(const Array2D<Type>& array0,
-                            const Array2D<Type>& array1)
+    template <class Type, class Derived0, class Derived1>
+    inline typename privateCode::Array2DBinaryResult<
+      Type, Derived0, Derived1, privateCode::ExpressionDivides>::ResultType
+    operator/(const Array2DExpression<Type, Derived0>& array0,
+              const Array2DExpression<Type, Derived1>& array1)
     {
-      if((array0.rows() != array1.rows())
-         || (array0.columns() != array1.columns())) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 is " << array0.rows()
-                << " x " << array0.columns() << ", while array1 is "
-                << array1.rows() << " x " << array1.columns() << ".";
-        BRICK_THROW(common::ValueException, "Array2D::operator*()", message.str().c_str());
-      }
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous() && array1.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), array1.begin(),
-                       result.begin(), std::multiplies<Type>());
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> in0Row = array0.getRow(row);
-          Array1D<Type> in1Row = array1.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(in0Row.begin(), in0Row.end(), in1Row.begin(),
-                         outRow.begin(), std::multiplies<Type>());
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DBinaryResult<
+        Type, Derived0, Derived1, privateCode::ExpressionDivides>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), array1.getDerived(),
+                        "Array2D::operator/()");
     }
 
-    template <class Type>
-    Array2D<Type> operator/(const Array2D<Type>& array0,
-                            const Array2D<Type>& array1)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, false>::ResultType
+    operator+(const Array2DExpression<Type, Derived>& array0, Type scalar)
     {
-      if((array0.rows() != array1.rows())
-         || (array0.columns() != array1.columns())) {
-        std::ostringstream message;
-        message << "Array sizes do not match.  Array0 is " << array0.rows()
-                << " x " << array0.columns() << ", while array1 is "
-                << array1.rows() << " x " << array1.columns() << ".";
-        BRICK_THROW(common::ValueException, "Array2D::operator/()",
-                    message.str().c_str());
-      }
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous() && array1.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), array1.begin(),
-                       result.begin(), std::divides<Type>());
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> in0Row = array0.getRow(row);
-          Array1D<Type> in1Row = array1.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(in0Row.begin(), in0Row.end(), in1Row.begin(),
-                         outRow.begin(), std::divides<Type>());
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionPlus, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    Array2D<Type> operator+(const Array2D<Type>& array0, Type scalar)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, false>::ResultType
+    operator-(const Array2DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), result.begin(),
-                       std::bind2nd(std::plus<Type>(), scalar));
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> inRow = array0.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(inRow.begin(), inRow.end(), outRow.begin(),
-                         std::bind2nd(std::plus<Type>(), scalar));
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionMinus, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    Array2D<Type> operator-(const Array2D<Type>& array0, Type scalar)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, false>::ResultType
+    operator*(const Array2DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), result.begin(),
-                       std::bind2nd(std::minus<Type>(), scalar));
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> inRow = array0.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(inRow.begin(), inRow.end(), outRow.begin(),
-                         std::bind2nd(std::minus<Type>(), scalar));
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionMultiplies, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    Array2D<Type> operator*(const Array2D<Type>& array0, Type scalar)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, false>::ResultType
+    operator/(const Array2DExpression<Type, Derived>& array0, Type scalar)
     {
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), result.begin(),
-                       std::bind2nd(std::multiplies<Type>(), scalar));
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> inRow = array0.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(inRow.begin(), inRow.end(), outRow.begin(),
-                         std::bind2nd(std::multiplies<Type>(), scalar));
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionDivides, false>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    Array2D<Type> operator/(const Array2D<Type>& array0, Type scalar)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionPlus, true>::ResultType
+    operator+(Type scalar, const Array2DExpression<Type, Derived>& array0)
     {
-      Array2D<Type> result(array0.rows(), array0.columns(),
-                           array0.getRowStep());
-      if(array0.isContiguous()) {
-        std::transform(array0.begin(), array0.end(), result.begin(),
-                       std::bind2nd(std::divides<Type>(), scalar));
-      } else {
-        for(unsigned int row = 0; row < array0.rows(); ++row) {
-          Array1D<Type> inRow = array0.getRow(row);
-          Array1D<Type> outRow = result.getRow(row);
-          std::transform(inRow.begin(), inRow.end(), outRow.begin(),
-                         std::bind2nd(std::divides<Type>(), scalar));
-        }
-      }
-      return result;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionPlus, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    inline Array2D<Type> operator+(Type scalar, const Array2D<Type>& array0)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMinus, true>::ResultType
+    operator-(Type scalar, const Array2DExpression<Type, Derived>& array0)
     {
-      return array0 + scalar;
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionMinus, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
     }
 
-    template <class Type>
-    inline Array2D<Type> operator*(Type scalar, const Array2D<Type>& array0)
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionMultiplies, true>::ResultType
+    operator*(Type scalar, const Array2DExpression<Type, Derived>& array0)
+    {
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionMultiplies, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
+    }
+
+
+    template <class Type, class Derived>
+    inline typename privateCode::Array2DScalarResult<
+      Type, Derived, privateCode::ExpressionDivides, true>::ResultType
+    operator/(Type scalar, const Array2DExpression<Type, Derived>& array0)
+    {
+      typedef typename privateCode::Array2DScalarResult<
+        Type, Derived, privateCode::ExpressionDivides, true>::ResultType
+        ResultType;
+      return ResultType(array0.getDerived(), scalar);
+    }
+
+
+    template <class Type, class Derived>
+    inline Array2D<Type>
+    sqrt(const Array2DExpression<Type, Derived>& array0)
+    {
+      return squareRoot(Array2D<Type>(array0));
+    }
+
+
+    template <class Type, class Derived>
+    Array2D<Type>
+    squareRoot(const Array2DExpression<Type, Derived>& array0)
     {
-      return array0 * scalar;
+      return squareRoot(Array2D<Type>(array0));
     }
 
 
@@ -1362,6 +1528,56 @@ namespace brick {
       return result;
     }
 
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator==(const Array2DExpression<Type, Derived>& array0,
+               const Type arg)
+    {
+      return Array2D<Type>(array0) == arg;
+    }
+
+
+    template <class Type, class Derived0, class Derived1>
+    Array2D<bool>
+    operator==(const Array2DExpression<Type, Derived0>& array0,
+               const Array2DExpression<Type, Derived1>& array1)
+    {
+      return Array2D<Type>(array0) == Array2D<Type>(array1);
+    }
+
+
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator>(const Array2DExpression<Type, Derived>& array0, Type arg)
+    {
+      return Array2D<Type>(array0) > arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator<(const Array2DExpression<Type, Derived>& array0, Type arg)
+    {
+      return Array2D<Type>(array0) < arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator>=(const Array2DExpression<Type, Derived>& array0, Type arg)
+    {
+      return Array2D<Type>(array0) >= arg;
+    }
+
+
+    template <class Type, class Derived>
+    Array2D<bool>
+    operator<=(const Array2DExpression<Type, Derived>& array0, Type arg)
+    {
+      return Array2D<Type>(array0) <= arg;
+    }
+
+
     template <class Type>
     std::ostream& operator<<(std::ostream& stream, const Array2D<Type>& array0)
     {
@@ -1387,6 +1603,17 @@ namespace brick {
     }
 
 
+    // Outputs a text representation of an elementwise arithmetic
+    // expression to a std::ostream.
+    template <class Type, class Derived>
+    std::ostream&
+    operator<<(std::ostream& stream,
+               const Array2DExpression<Type, Derived>& array0)
+    {
+      return stream << Array2D<Type>(array0);
+    }
+
+
     template <class Type>
     std::istream& operator>>(std::istream& inputStream, Array2D<Type>& array0)
     {
@@ -117,6 +117,15 @@ namespace brick {
        */
       Array3D(const Array3D<Type> &source);
 
+      /**
+       * The move constructor takes over the data and reference count
+       * of source, without touching the count, and leaves source
+       * empty.
+       *
+       * @param source Array which is to be moved from.
+       */
+      Array3D(Array3D<Type>&& source) noexcept;
+
       /**
        * Construct an array around external data.  Arrays constructed
        * in this way will not implement reference counting, and will
@@ -553,6 +562,17 @@ namespace brick {
       Array3D<Type>&
       operator=(const Array3D<Type>& source);
 
+      /**
+       * Move assignment releases the data currently referenced by
+       * *this, then takes over the data and reference count of
+       * source, leaving source empty.
+       *
+       * @param source The Array3D instance to be moved from.
+       * @return Reference to *this.
+       */
+      Array3D<Type>&
+      operator=(Array3D<Type>&& source) noexcept;
+
       /**
        * Assign value to every element in the array.
        *
@@ -22,6 +22,8 @@
 #include <sstream>
 #include <numeric>
 #include <functional>
+#include <utility>
+#include <brick/numeric/arrayAllocator.hh>
 #include <brick/numeric/numericTraits.hh>
 
 namespace brick {
@@ -174,6 +176,29 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array3D<Type>::
+    Array3D(Array3D<Type>&& source) noexcept
+      : m_shape0(source.m_shape0),
+        m_shape1(source.m_shape1),
+        m_shape2(source.m_shape2),
+        m_shape1Times2(source.m_shape1Times2),
+        m_size(source.m_size),
+        m_dataPtr(source.m_dataPtr),
+        m_refCountPtr(source.m_refCountPtr),
+        m_isAllocated(source.m_isAllocated)
+    {
+      source.m_shape0 = 0;
+      source.m_shape1 = 0;
+      source.m_shape2 = 0;
+      source.m_shape1Times2 = 0;
+      source.m_size = 0;
+      source.m_dataPtr = 0;
+      source.m_refCountPtr = 0;
+      source.m_isAllocated = false;
+    }
+
+
     /* Here's a constructor for getting image data into the array */
     /* cheaply. */
     template <class Type>
@@ -504,6 +529,34 @@ namespace brick {
     }
 
 
+    template <class Type>
+    Array3D<Type>& Array3D<Type>::
+    operator=(Array3D<Type>&& source) noexcept
+    {
+      // Check for self-assignment
+      if(&source != this) {
+        this->deAllocate();
+        m_shape0 = source.m_shape0;
+        m_shape1 = source.m_shape1;
+        m_shape2 = source.m_shape2;
+        m_shape1Times2 = source.m_shape1Times2;
+        m_size = source.m_size;
+        m_dataPtr = source.m_dataPtr;
+        m_refCountPtr = source.m_refCountPtr;
+        m_isAllocated = source.m_isAllocated;
+        source.m_shape0 = 0;
+        source.m_shape1 = 0;
+        source.m_shape2 = 0;
+        source.m_shape1Times2 = 0;
+        source.m_size = 0;
+        source.m_dataPtr = 0;
+        source.m_refCountPtr = 0;
+        source.m_isAllocated = false;
+      }
+      return *this;
+    }
+
+
     template <class Type>
     Array3D<Type>& Array3D<Type>::
     operator=(Type value)
@@ -632,8 +685,10 @@ namespace brick {
       m_shape1Times2  = m_shape1 * m_shape2;
       m_size = m_shape0 * m_shape1 * m_shape2;
       if(m_shape0 > 0 && m_shape1 > 0 && m_shape2 > 0) {
-        m_dataPtr = new Type[m_size]; // should throw an exeption
-        m_refCountPtr = new size_t;	 // if we're out of memory.
+        // The current ArrayAllocator throws std::bad_alloc if we're
+        // out of memory.
+        m_dataPtr = privateCode::allocateArrayStorage<Type>(m_size);
+        m_refCountPtr = new size_t;
         *m_refCountPtr = 1;
         m_isAllocated = true;
         return;
@@ -709,7 +764,7 @@ namespace brick {
     {
       if(m_isAllocated == true) {
         if(--(*m_refCountPtr) == 0) {
-          delete[] m_dataPtr;
+          privateCode::releaseArrayStorage(m_dataPtr);
           delete m_refCountPtr;
           m_isAllocated = false;
           m_dataPtr = 0;
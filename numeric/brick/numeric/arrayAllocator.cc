@@ -0,0 +1,311 @@
+/**
+***************************************************************************
+* @file brick/numeric/arrayAllocator.cc
+*
+* Source file defining the memory allocators used by Array1D,
+* Array2D, and Array3D.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+#include <brick/numeric/arrayAllocator.hh>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+  // Blocks of up to 64MB are pooled.  This comfortably covers
+  // multi-channel floating point images at common video resolutions.
+  const size_t maximumPooledSizeLog2 = 26;
+  const size_t maximumPooledSize = size_t(1) << maximumPooledSizeLog2;
+
+  // Smallest blocks handed out by the pool.
+  const size_t minimumPooledSizeLog2 = 6;
+  const size_t minimumPooledSize = size_t(1) << minimumPooledSizeLog2;
+
+  // One class for blocks of up to minimumPooledSize bytes, then four
+  // classes per power of two.
+  const size_t numberOfSizeClasses =
+    1 + (maximumPooledSizeLog2 - minimumPooledSizeLog2) * 4;
+
+  // Each thread keeps at most this many bytes in its free lists.
+  const size_t maximumCachedBytes = size_t(256) << 20;
+
+
+  void*
+  allocateAligned(size_t numberOfBytes)
+  {
+#ifdef _WIN32
+    void* blockPtr = _aligned_malloc(
+      numberOfBytes, brick::numeric::arrayStorageAlignment);
+    if(blockPtr == 0) {
+      throw std::bad_alloc();
+    }
+#else
+    void* blockPtr = 0;
+    if(posix_memalign(&blockPtr, brick::numeric::arrayStorageAlignment,
+                      numberOfBytes) != 0) {
+      throw std::bad_alloc();
+    }
+#endif
+    return blockPtr;
+  }
+
+
+  void
+  releaseAligned(void* blockPtr)
+  {
+#ifdef _WIN32
+    _aligned_free(blockPtr);
+#else
+    free(blockPtr);
+#endif
+  }
+
+
+  // Returns the index of the size class for a request of
+  // numberOfBytes bytes, and sets classSize to the size of the
+  // blocks in that class.  Classes above the first are spaced at
+  // quarter powers of two: for 2^p < numberOfBytes <= 2^(p+1), the
+  // class sizes are 5, 6, 7, and 8 times 2^(p-2).
+  size_t
+  getSizeClass(size_t numberOfBytes, size_t& classSize)
+  {
+    if(numberOfBytes <= minimumPooledSize) {
+      classSize = minimumPooledSize;
+      return 0;
+    }
+    size_t log2Size = 0;
+    for(size_t remainder = numberOfBytes - 1; remainder > 1;
+        remainder >>= 1) {
+      ++log2Size;
+    }
+    const size_t step = size_t(1) << (log2Size - 2);
+    const size_t numberOfSteps = (numberOfBytes + step - 1) / step;
+    classSize = numberOfSteps * step;
+    return (1 + (log2Size - minimumPooledSizeLog2) * 4
+            + (numberOfSteps - 5));
+  }
+
+
+  // Set when the calling thread's cache has been destroyed, so that
+  // arrays released during thread (or program) shutdown bypass it.
+  thread_local bool t_isThreadCacheDestroyed = false;
+
+
+  // Free lists of the calling thread, indexed by size class.
+  class ThreadCache {
+  public:
+    ThreadCache() : m_cachedBytes(0) {}
+
+    ~ThreadCache() {
+      this->release();
+      t_isThreadCacheDestroyed = true;
+    }
+
+    void* pop(size_t sizeClass, size_t classSize) {
+      std::vector<void*>& freeList = m_freeLists[sizeClass];
+      if(freeList.empty()) {
+        return 0;
+      }
+      void* blockPtr = freeList.back();
+      freeList.pop_back();
+      m_cachedBytes -= classSize;
+      return blockPtr;
+    }
+
+    bool push(void* blockPtr, size_t sizeClass, size_t classSize) {
+      if(m_cachedBytes + classSize > maximumCachedBytes) {
+        return false;
+      }
+      try {
+        m_freeLists[sizeClass].push_back(blockPtr);
+      } catch(const std::bad_alloc&) {
+        return false;
+      }
+      m_cachedBytes += classSize;
+      return true;
+    }
+
+    void release() {
+      for(size_t sizeClass = 0; sizeClass < numberOfSizeClasses;
+          ++sizeClass) {
+        std::vector<void*>& freeList = m_freeLists[sizeClass];
+        for(size_t ii = 0; ii < freeList.size(); ++ii) {
+          releaseAligned(freeList[ii]);
+        }
+        freeList.clear();
+      }
+      m_cachedBytes = 0;
+    }
+
+    size_t getCachedBytes() const {return m_cachedBytes;}
+
+  private:
+    std::vector<void*> m_freeLists[numberOfSizeClasses];
+    size_t m_cachedBytes;
+  };
+
+
+  ThreadCache*
+  getThreadCache()
+  {
+    if(t_isThreadCacheDestroyed) {
+      return 0;
+    }
+    thread_local ThreadCache threadCache;
+    return &threadCache;
+  }
+
+
+  std::atomic<brick::numeric::ArrayAllocator*>&
+  getArrayAllocatorStorage()
+  {
+    static std::atomic<brick::numeric::ArrayAllocator*> allocatorPtr(
+      &brick::numeric::getAlignedArrayAllocator());
+    return allocatorPtr;
+  }
+
+} // namespace
+
+
+namespace brick {
+
+  namespace numeric {
+
+    void*
+    AlignedArrayAllocator::
+    allocate(size_t numberOfBytes)
+    {
+      return allocateAligned(numberOfBytes);
+    }
+
+
+    void
+    AlignedArrayAllocator::
+    deallocate(void* blockPtr, size_t /* numberOfBytes */)
+    {
+      releaseAligned(blockPtr);
+    }
+
+
+    void*
+    PoolArrayAllocator::
+    allocate(size_t numberOfBytes)
+    {
+      if(numberOfBytes > maximumPooledSize) {
+        return allocateAligned(numberOfBytes);
+      }
+      size_t classSize;
+      const size_t sizeClass = getSizeClass(numberOfBytes, classSize);
+      ThreadCache* cachePtr = getThreadCache();
+      if(cachePtr != 0) {
+        void* blockPtr = cachePtr->pop(sizeClass, classSize);
+        if(blockPtr != 0) {
+          return blockPtr;
+        }
+      }
+      return allocateAligned(classSize);
+    }
+
+
+    void
+    PoolArrayAllocator::
+    deallocate(void* blockPtr, size_t numberOfBytes)
+    {
+      if(numberOfBytes <= maximumPooledSize) {
+        size_t classSize;
+        const size_t sizeClass = getSizeClass(numberOfBytes, classSize);
+        ThreadCache* cachePtr = getThreadCache();
+        if(cachePtr != 0 && cachePtr->push(blockPtr, sizeClass, classSize)) {
+          return;
+        }
+      }
+      releaseAligned(blockPtr);
+    }
+
+
+    void
+    PoolArrayAllocator::
+    releaseThreadCache()
+    {
+      ThreadCache* cachePtr = getThreadCache();
+      if(cachePtr != 0) {
+        cachePtr->release();
+      }
+    }
+
+
+    size_t
+    PoolArrayAllocator::
+    getThreadCacheSize()
+    {
+      ThreadCache* cachePtr = getThreadCache();
+      return (cachePtr != 0) ? cachePtr->getCachedBytes() : 0;
+    }
+
+
+    size_t
+    PoolArrayAllocator::
+    getMaximumPooledSize()
+    {
+      return maximumPooledSize;
+    }
+
+
+    size_t
+    PoolArrayAllocator::
+    getMaximumCachedBytes()
+    {
+      return maximumCachedBytes;
+    }
+
+
+    ArrayAllocator&
+    getArrayAllocator()
+    {
+      return *(getArrayAllocatorStorage().load(std::memory_order_acquire));
+    }
+
+
+    ArrayAllocator*
+    setArrayAllocator(ArrayAllocator* allocatorPtr)
+    {
+      if(allocatorPtr == 0) {
+        allocatorPtr = &getAlignedArrayAllocator();
+      }
+      return getArrayAllocatorStorage().exchange(
+        allocatorPtr, std::memory_order_acq_rel);
+    }
+
+
+    ArrayAllocator&
+    getAlignedArrayAllocator()
+    {
+      // Deliberately leaked, so that arrays destroyed during static
+      // destruction can still release their memory.
+      static ArrayAllocator* allocatorPtr = new AlignedArrayAllocator;
+      return *allocatorPtr;
+    }
+
+
+    ArrayAllocator&
+    getPoolArrayAllocator()
+    {
+      // Deliberately leaked, so that arrays destroyed during static
+      // destruction can still release their memory.
+      static ArrayAllocator* allocatorPtr = new PoolArrayAllocator;
+      return *allocatorPtr;
+    }
+
+  } // namespace numeric
+
+} // namespace brick
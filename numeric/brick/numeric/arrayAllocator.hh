@@ -0,0 +1,302 @@
+/**
+***************************************************************************
+* @file brick/numeric/arrayAllocator.hh
+*
+* Header file declaring the memory allocators used by Array1D,
+* Array2D, and Array3D.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_NUMERIC_ARRAYALLOCATOR_HH
+#define BRICK_NUMERIC_ARRAYALLOCATOR_HH
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace brick {
+
+  namespace numeric {
+
+    /**
+     ** The first element of every array allocated by Array1D, Array2D,
+     ** or Array3D (and therefore by computerVision::Image) is aligned
+     ** to this many bytes, so that vectorized code can use aligned
+     ** loads and stores, and so that arrays never share a cache line
+     ** with unrelated data.
+     **/
+    const size_t arrayStorageAlignment = 64;
+
+
+    /**
+     ** The ArrayAllocator class is the interface through which the
+     ** numeric array classes obtain and release memory.  The
+     ** allocator in use is selected at runtime by
+     ** setArrayAllocator(), and applies to every array allocated
+     ** after the call.  Each block remembers the allocator that
+     ** produced it, so blocks are always returned to the right
+     ** allocator, even if the setting changes in the meantime.
+     **
+     ** Subclasses must return memory aligned to at least
+     ** arrayStorageAlignment bytes, must be safe to call from several
+     ** threads at once, and must outlive every block they hand out.
+     **/
+    class ArrayAllocator {
+    public:
+
+      /**
+       * Destructor.
+       */
+      virtual
+      ~ArrayAllocator() {}
+
+
+      /**
+       * Allocates a block of memory.
+       *
+       * @param numberOfBytes This argument specifies the required
+       * size of the block.
+       *
+       * @return The return value points to the start of a block of at
+       * least numberOfBytes bytes, aligned to arrayStorageAlignment.
+       * On failure, std::bad_alloc is thrown.
+       */
+      virtual void*
+      allocate(size_t numberOfBytes) = 0;
+
+
+      /**
+       * Releases a block previously returned by allocate().
+       *
+       * @param blockPtr This argument is the pointer returned by
+       * allocate().
+       *
+       * @param numberOfBytes This argument must match the argument
+       * passed to allocate() when the block was created.
+       */
+      virtual void
+      deallocate(void* blockPtr, size_t numberOfBytes) = 0;
+    };
+
+
+    /**
+     ** This allocator obtains each block directly from the system
+     ** heap, aligned to arrayStorageAlignment bytes.  It is the
+     ** default.
+     **/
+    class AlignedArrayAllocator : public ArrayAllocator {
+    public:
+
+      virtual void*
+      allocate(size_t numberOfBytes);
+
+      virtual void
+      deallocate(void* blockPtr, size_t numberOfBytes);
+    };
+
+
+    /**
+     ** This allocator keeps freed blocks in per-thread free lists,
+     ** sorted into size classes, and hands them out again to later
+     ** requests of similar size.  Code that allocates the same sized
+     ** temporaries over and over, such as per-frame image
+     ** processing, then stops calling the system allocator at all
+     ** once the first frame has been processed.
+     **
+     ** Sizes are rounded up to one of four classes per power of two,
+     ** so no more than a quarter of each block is wasted.  Blocks
+     ** larger than getMaximumPooledSize() bypass the pool.  A block
+     ** freed by a thread other than the one that allocated it simply
+     ** joins the freeing thread's free lists.  Each thread caches at
+     ** most getMaximumCachedBytes() bytes; beyond that, freed blocks
+     ** are returned to the system.  The cache of each thread is
+     ** released when the thread exits.
+     **
+     ** The free lists are shared by all PoolArrayAllocator instances.
+     **/
+    class PoolArrayAllocator : public ArrayAllocator {
+    public:
+
+      virtual void*
+      allocate(size_t numberOfBytes);
+
+      virtual void
+      deallocate(void* blockPtr, size_t numberOfBytes);
+
+
+      /**
+       * Returns every block cached by the calling thread to the
+       * system.
+       */
+      static void
+      releaseThreadCache();
+
+
+      /**
+       * Reports how much memory is cached by the calling thread.
+       *
+       * @return The return value is the total size, in bytes, of the
+       * blocks in the calling thread's free lists.
+       */
+      static size_t
+      getThreadCacheSize();
+
+
+      /**
+       * Reports the size of the largest block that will be pooled.
+       *
+       * @return The return value is a size in bytes.
+       */
+      static size_t
+      getMaximumPooledSize();
+
+
+      /**
+       * Reports the limit on the amount of memory cached by each
+       * thread.
+       *
+       * @return The return value is a size in bytes.
+       */
+      static size_t
+      getMaximumCachedBytes();
+    };
+
+
+    /**
+     * This function returns the allocator used by the numeric array
+     * classes to allocate new arrays.
+     *
+     * @return The return value is a reference to the current
+     * allocator.
+     */
+    ArrayAllocator&
+    getArrayAllocator();
+
+
+    /**
+     * This function changes the allocator used by the numeric array
+     * classes.  The setting is global, and affects arrays allocated
+     * by every thread after the call.  Arrays allocated before the
+     * call continue to use the allocator that created them.
+     *
+     * @param allocatorPtr This argument points to the new allocator,
+     * which must outlive every array allocated using it.  Passing 0
+     * restores the default, getAlignedArrayAllocator().
+     *
+     * @return The return value points to the previous allocator.
+     */
+    ArrayAllocator*
+    setArrayAllocator(ArrayAllocator* allocatorPtr);
+
+
+    /**
+     * This function returns a process-wide instance of
+     * AlignedArrayAllocator, which is never destroyed.
+     *
+     * @return The return value is a reference to the allocator.
+     */
+    ArrayAllocator&
+    getAlignedArrayAllocator();
+
+
+    /**
+     * This function returns a process-wide instance of
+     * PoolArrayAllocator, which is never destroyed.  To have all
+     * subsequent arrays use the pool, call
+     *
+     * @code
+     *   setArrayAllocator(&getPoolArrayAllocator());
+     * @endcode
+     *
+     * @return The return value is a reference to the allocator.
+     */
+    ArrayAllocator&
+    getPoolArrayAllocator();
+
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Every array block starts with this header, padded to
+      // arrayStorageAlignment bytes, so that the block can be
+      // released correctly by whichever array happens to hold the
+      // last reference to it.
+      struct ArrayStorageHeader {
+        ArrayAllocator* allocatorPtr;
+        size_t numberOfBytes;
+        size_t numberOfElements;
+      };
+
+
+      // Allocates and default-initializes storage for
+      // numberOfElements elements of type Type, just as
+      // new Type[numberOfElements] would, but using the current
+      // ArrayAllocator.
+      template <class Type>
+      Type*
+      allocateArrayStorage(size_t numberOfElements)
+      {
+        if(numberOfElements
+           > ((std::numeric_limits<size_t>::max() - arrayStorageAlignment)
+              / sizeof(Type))) {
+          throw std::bad_alloc();
+        }
+        const size_t numberOfBytes =
+          arrayStorageAlignment + numberOfElements * sizeof(Type);
+        ArrayAllocator* allocatorPtr = &getArrayAllocator();
+        char* blockPtr =
+          static_cast<char*>(allocatorPtr->allocate(numberOfBytes));
+
+        ArrayStorageHeader* headerPtr = new(blockPtr) ArrayStorageHeader;
+        headerPtr->allocatorPtr = allocatorPtr;
+        headerPtr->numberOfBytes = numberOfBytes;
+        headerPtr->numberOfElements = numberOfElements;
+
+        Type* dataPtr =
+          reinterpret_cast<Type*>(blockPtr + arrayStorageAlignment);
+        size_t elementIndex = 0;
+        try {
+          for(; elementIndex < numberOfElements; ++elementIndex) {
+            new(dataPtr + elementIndex) Type;
+          }
+        } catch(...) {
+          while(elementIndex != 0) {
+            dataPtr[--elementIndex].~Type();
+          }
+          allocatorPtr->deallocate(blockPtr, numberOfBytes);
+          throw;
+        }
+        return dataPtr;
+      }
+
+
+      // Destroys the elements of, and releases, storage returned by
+      // allocateArrayStorage().
+      template <class Type>
+      void
+      releaseArrayStorage(Type* dataPtr)
+      {
+        char* blockPtr =
+          reinterpret_cast<char*>(dataPtr) - arrayStorageAlignment;
+        ArrayStorageHeader* headerPtr =
+          reinterpret_cast<ArrayStorageHeader*>(blockPtr);
+        for(size_t elementIndex = 0;
+            elementIndex < headerPtr->numberOfElements; ++elementIndex) {
+          dataPtr[elementIndex].~Type();
+        }
+        headerPtr->allocatorPtr->deallocate(
+          blockPtr, headerPtr->numberOfBytes);
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+  } // namespace numeric
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_NUMERIC_ARRAYALLOCATOR_HH */
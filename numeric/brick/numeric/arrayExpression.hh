@@ -0,0 +1,764 @@
+/**
+***************************************************************************
+* @file brick/numeric/arrayExpression.hh
+*
+* Header file declaring the expression templates that implement lazy
+* elementwise arithmetic for Array1D and Array2D.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_NUMERIC_ARRAYEXPRESSION_HH
+#define BRICK_NUMERIC_ARRAYEXPRESSION_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <brick/common/exception.hh>
+
+namespace brick {
+
+  namespace numeric {
+
+    // Forward declarations.
+    template <class Type> class Array1D;
+    template <class Type> class Array2D;
+
+
+    /**
+     ** The Array1DExpression class template is the common base of
+     ** Array1D and of every unevaluated elementwise arithmetic
+     ** expression involving Array1D instances.  Operators such as
+     ** operator+(const Array1DExpression&, const Array1DExpression&)
+     ** don't compute anything.  Instead, they return a lightweight
+     ** object that records the operation, and the whole expression
+     ** is evaluated in a single pass when it is assigned to an
+     ** Array1D.  This way, an expression such as
+     **
+     ** @code
+     **   result = array0 * array1 + array2 * 2.0;
+     ** @endcode
+     **
+     ** touches each element of each array exactly once, and
+     ** allocates no temporary arrays at all.
+     **
+     ** Expression objects refer to the data of their operands, but
+     ** don't share ownership of it, so they should not outlive the
+     ** statement in which they are created.  In particular, don't
+     ** store them using C++11 "auto".
+     **
+     ** Expressions provide the read-only part of the Array1D
+     ** interface (size(), operator[](), and so on), so code such as
+     ** (array0 + array1)[0] continues to work.  Elements accessed
+     ** this way are computed on the fly, and copy() evaluates the
+     ** whole expression into a new Array1D.
+     **
+     ** If an expression reads memory that overlaps the array it is
+     ** assigned to, other than element-for-element (for example,
+     ** through an Array1D constructed from a pointer into the same
+     ** buffer at a different offset), it is first evaluated into a
+     ** temporary array, so the result is the same as if each
+     ** operation had allocated its own output.
+     **
+     ** Template argument Type is the element type of the expression,
+     ** and template argument Derived is the type of the class that
+     ** inherits from Array1DExpression.
+     **/
+    template <class Type, class Derived>
+    class Array1DExpression {
+    public:
+
+      /**
+       ** Typedef for value_type describes the elements of the
+       ** expression.
+       **/
+      typedef Type value_type;
+
+      /**
+       * Returns a reference to *this, cast to the type of the
+       * derived class.
+       *
+       * @return The return value is a reference to the derived class.
+       */
+      const Derived&
+      getDerived() const {return static_cast<const Derived&>(*this);}
+
+
+      /**
+       * Evaluates the expression into a newly allocated array.
+       *
+       * @return An Array1D containing the value of the expression.
+       */
+      Array1D<Type>
+      copy() const;
+
+
+      /**
+       * Returns the number of elements in the expression.
+       *
+       * @return Number of elements.
+       */
+      size_t
+      size() const;
+
+
+      /**
+       * Computes one element of the expression.
+       *
+       * @param index Indicates which element to compute.
+       *
+       * @return The value of the selected element.
+       */
+      Type
+      operator()(size_t index) const {return (*this)[index];}
+
+
+      /**
+       * Computes one element of the expression.
+       *
+       * @param index Indicates which element to compute.
+       *
+       * @return The value of the selected element.
+       */
+      Type
+      operator[](size_t index) const;
+    };
+
+
+    /**
+     ** The Array2DExpression class template is the common base of
+     ** Array2D and of every unevaluated elementwise arithmetic
+     ** expression involving Array2D instances.  Please see the
+     ** documentation of Array1DExpression for more information.
+     **/
+    template <class Type, class Derived>
+    class Array2DExpression {
+    public:
+
+      /**
+       ** Typedef for value_type describes the elements of the
+       ** expression.
+       **/
+      typedef Type value_type;
+
+      /**
+       * Returns a reference to *this, cast to the type of the
+       * derived class.
+       *
+       * @return The return value is a reference to the derived class.
+       */
+      const Derived&
+      getDerived() const {return static_cast<const Derived&>(*this);}
+
+
+      /**
+       * Returns the number of columns in the expression.
+       *
+       * @return Number of columns.
+       */
+      size_t
+      columns() const;
+
+
+      /**
+       * Evaluates the expression into a newly allocated array.
+       *
+       * @return An Array2D containing the value of the expression.
+       */
+      Array2D<Type>
+      copy() const;
+
+
+      /**
+       * Returns the number of rows in the expression.
+       *
+       * @return Number of rows.
+       */
+      size_t
+      rows() const;
+
+
+      /**
+       * Returns the number of elements in the expression.  This is
+       * the product of rows() and columns().
+       *
+       * @return Number of elements.
+       */
+      size_t
+      size() const {return this->rows() * this->columns();}
+
+
+      /**
+       * Evaluates the expression, and computes its matrix transpose.
+       *
+       * @return An Array2D containing the transposed value of the
+       * expression.
+       */
+      Array2D<Type>
+      transpose() const;
+
+
+      /**
+       * Computes one element of the expression, treating it as a
+       * 1D array in raster order.
+       *
+       * @param index Indicates which element to compute.
+       *
+       * @return The value of the selected element.
+       */
+      Type
+      operator()(size_t index) const {return (*this)[index];}
+
+
+      /**
+       * Computes one element of the expression.
+       *
+       * @param row Indicates the row of the element to compute.
+       *
+       * @param column Indicates the column of the element to compute.
+       *
+       * @return The value of the selected element.
+       */
+      Type
+      operator()(size_t row, size_t column) const;
+
+
+      /**
+       * Computes one element of the expression, treating it as a
+       * 1D array in raster order.
+       *
+       * @param index Indicates which element to compute.
+       *
+       * @return The value of the selected element.
+       */
+      Type
+      operator[](size_t index) const;
+    };
+
+
+    /// @cond privateCode
+    namespace privateCode {
+
+      // Returns true if the memory ranges [begin0, end0) and [begin1,
+      // end1) have any elements in common.
+      template <class Type>
+      inline bool
+      isOverlapping(const Type* begin0, const Type* end0,
+                    const Type* begin1, const Type* end1)
+      {
+        std::less<const Type*> isLess;
+        return isLess(begin0, end1) && isLess(begin1, end0);
+      }
+
+
+      // Elementwise operations used by the expression nodes below.
+      struct ExpressionPlus {
+        template <class Type>
+        static Type apply(const Type& arg0, const Type& arg1) {
+          return arg0 + arg1;
+        }
+      };
+
+      struct ExpressionMinus {
+        template <class Type>
+        static Type apply(const Type& arg0, const Type& arg1) {
+          return arg0 - arg1;
+        }
+      };
+
+      struct ExpressionMultiplies {
+        template <class Type>
+        static Type apply(const Type& arg0, const Type& arg1) {
+          return arg0 * arg1;
+        }
+      };
+
+      struct ExpressionDivides {
+        template <class Type>
+        static Type apply(const Type& arg0, const Type& arg1) {
+          return arg0 / arg1;
+        }
+      };
+
+
+      // Leaf of a 1D expression tree.  Refers to the data of an
+      // Array1D without sharing ownership.
+      template <class Type>
+      class Array1DReferenceNode
+        : public Array1DExpression<Type, Array1DReferenceNode<Type> >
+      {
+      public:
+        Array1DReferenceNode(const Array1D<Type>& array)
+          : m_dataPtr(array.data()), m_size(array.size()) {}
+
+        Type getElement(size_t index) const {return m_dataPtr[index];}
+        size_t getSize() const {return m_size;}
+
+        // Returns true if this leaf reads any of the size elements
+        // starting at outputPtr, other than element-for-element.
+        bool isAliased(const Type* outputPtr, size_t size) const {
+          return (m_dataPtr != outputPtr
+                  && isOverlapping(m_dataPtr, m_dataPtr + m_size,
+                                   outputPtr, outputPtr + size));
+        }
+
+      private:
+        const Type* m_dataPtr;
+        size_t m_size;
+      };
+
+
+      // Maps the argument of an operator to the node type that
+      // represents it in an expression tree.  Expression nodes
+      // represent themselves, and are copied by value.
+      template <class Type, class Derived>
+      struct Array1DNodeTraits {
+        typedef Derived NodeType;
+      };
+
+      template <class Type>
+      struct Array1DNodeTraits< Type, Array1D<Type> > {
+        typedef Array1DReferenceNode<Type> NodeType;
+      };
+
+
+      // Interior node of a 1D expression tree, combining two
+      // same-sized operands elementwise.
+      template <class Type, class Operand0, class Operand1, class Operation>
+      class Array1DBinaryNode
+        : public Array1DExpression<
+            Type, Array1DBinaryNode<Type, Operand0, Operand1, Operation> >
+      {
+      public:
+        Array1DBinaryNode(const Operand0& operand0, const Operand1& operand1,
+                          const char* functionName)
+          : m_operand0(operand0), m_operand1(operand1)
+        {
+          if(operand0.getSize() != operand1.getSize()) {
+            std::ostringstream message;
+            message << "Array sizes do not match.  Array0 has "
+                    << operand0.getSize() << " elements, while array1 has "
+                    << operand1.getSize() << " elements.";
+            BRICK_THROW(common::ValueException, functionName,
+                        message.str().c_str());
+          }
+        }
+
+        Type getElement(size_t index) const {
+          return Operation::apply(m_operand0.getElement(index),
+                                  m_operand1.getElement(index));
+        }
+
+        size_t getSize() const {return m_operand0.getSize();}
+
+        bool isAliased(const Type* outputPtr, size_t size) const {
+          return (m_operand0.isAliased(outputPtr, size)
+                  || m_operand1.isAliased(outputPtr, size));
+        }
+
+      private:
+        Operand0 m_operand0;
+        Operand1 m_operand1;
+      };
+
+
+      // Interior node of a 1D expression tree, combining each
+      // element of an operand with a scalar.  If IsScalarFirst is
+      // true, the scalar is the left hand argument of the operation.
+      template <class Type, class Operand, class Operation,
+                bool IsScalarFirst>
+      class Array1DScalarNode
+        : public Array1DExpression<
+            Type, Array1DScalarNode<Type, Operand, Operation, IsScalarFirst> >
+      {
+      public:
+        Array1DScalarNode(const Operand& operand, const Type& scalar)
+          : m_operand(operand), m_scalar(scalar) {}
+
+        Type getElement(size_t index) const {
+          return (IsScalarFirst
+                  ? Operation::apply(m_scalar, m_operand.getElement(index))
+                  : Operation::apply(m_operand.getElement(index), m_scalar));
+        }
+
+        size_t getSize() const {return m_operand.getSize();}
+
+        bool isAliased(const Type* outputPtr, size_t size) const {
+          return m_operand.isAliased(outputPtr, size);
+        }
+
+      private:
+        Operand m_operand;
+        Type m_scalar;
+      };
+
+
+      // Computes the return types of the 1D arithmetic operators.
+      template <class Type, class Derived0, class Derived1, class Operation>
+      struct Array1DBinaryResult {
+        typedef Array1DBinaryNode<
+          Type,
+          typename Array1DNodeTraits<Type, Derived0>::NodeType,
+          typename Array1DNodeTraits<Type, Derived1>::NodeType,
+          Operation> ResultType;
+      };
+
+      template <class Type, class Derived, class Operation,
+                bool IsScalarFirst>
+      struct Array1DScalarResult {
+        typedef Array1DScalarNode<
+          Type, typename Array1DNodeTraits<Type, Derived>::NodeType,
+          Operation, IsScalarFirst> ResultType;
+      };
+
+
+      // Writes every element of a 1D expression to outputPtr, in a
+      // single pass.  If the expression reads any of the output
+      // elements other than element-for-element, then writing one
+      // output element could change the value of another, so the
+      // expression is evaluated into a temporary array first.
+      template <class Type, class Node>
+      inline void
+      evaluateArray1DNode(const Node& node, Type* outputPtr)
+      {
+        const size_t size = node.getSize();
+        if(node.isAliased(outputPtr, size)) {
+          Array1D<Type> temporary(node);
+          std::copy(temporary.data(), temporary.data() + size, outputPtr);
+          return;
+        }
+        for(size_t index = 0; index < size; ++index) {
+          outputPtr[index] = node.getElement(index);
+        }
+      }
+
+
+      // Leaf of a 2D expression tree.  Refers to the data of an
+      // Array2D without sharing ownership.
+      template <class Type>
+      class Array2DReferenceNode
+        : public Array2DExpression<Type, Array2DReferenceNode<Type> >
+      {
+      public:
+        Array2DReferenceNode(const Array2D<Type>& array)
+          : m_dataPtr(array.data()), m_rows(array.rows()),
+            m_columns(array.columns()), m_rowStep(array.getRowStep()) {}
+
+        Type getElement(size_t index) const {return m_dataPtr[index];}
+
+        Type getElement(size_t row, size_t column) const {
+          return m_dataPtr[row * m_rowStep + column];
+        }
+
+        size_t getColumns() const {return m_columns;}
+        size_t getRows() const {return m_rows;}
+        bool isContiguous() const {return m_columns == m_rowStep;}
+
+        // Returns true if this leaf reads any of the memory spanned
+        // by a rows x columns output array starting at outputPtr,
+        // other than element-for-element.
+        bool isAliased(const Type* outputPtr, size_t rows, size_t columns,
+                       size_t rowStep) const {
+          if(m_dataPtr == outputPtr && m_rowStep == rowStep) {
+            return false;
+          }
+          if(m_rows == 0 || m_columns == 0 || rows == 0 || columns == 0) {
+            return false;
+          }
+          return isOverlapping(
+            m_dataPtr, m_dataPtr + (m_rows - 1) * m_rowStep + m_columns,
+            outputPtr, outputPtr + (rows - 1) * rowStep + columns);
+        }
+
+      private:
+        const Type* m_dataPtr;
+        size_t m_rows;
+        size_t m_columns;
+        size_t m_rowStep;
+      };
+
+
+      // Maps the argument of an operator to the node type that
+      // represents it in an expression tree.  Expression nodes
+      // represent themselves, and are copied by value.
+      template <class Type, class Derived>
+      struct Array2DNodeTraits {
+        typedef Derived NodeType;
+      };
+
+      template <class Type>
+      struct Array2DNodeTraits< Type, Array2D<Type> > {
+        typedef Array2DReferenceNode<Type> NodeType;
+      };
+
+
+      // Interior node of a 2D expression tree, combining two
+      // same-shaped operands elementwise.
+      template <class Type, class Operand0, class Operand1, class Operation>
+      class Array2DBinaryNode
+        : public Array2DExpression<
+            Type, Array2DBinaryNode<Type, Operand0, Operand1, Operation> >
+      {
+      public:
+        Array2DBinaryNode(const Operand0& operand0, const Operand1& operand1,
+                          const char* functionName)
+          : m_operand0(operand0), m_operand1(operand1)
+        {
+          if((operand0.getRows() != operand1.getRows())
+             || (operand0.getColumns() != operand1.getColumns())) {
+            std::ostringstream message;
+            message << "Array sizes do not match.  Array0 is "
+                    << operand0.getRows() << " x " << operand0.getColumns()
+                    << ", while array1 is " << operand1.getRows()
+                    << " x " << operand1.getColumns() << ".";
+            BRICK_THROW(common::ValueException, functionName,
+                        message.str().c_str());
+          }
+        }
+
+        Type getElement(size_t index) const {
+          return Operation::apply(m_operand0.getElement(index),
+                                  m_operand1.getElement(index));
+        }
+
+        Type getElement(size_t row, size_t column) const {
+          return Operation::apply(m_operand0.getElement(row, column),
+                                  m_operand1.getElement(row, column));
+        }
+
+        size_t getColumns() const {return m_operand0.getColumns();}
+        size_t getRows() const {return m_operand0.getRows();}
+
+        bool isContiguous() const {
+          return m_operand0.isContiguous() && m_operand1.isContiguous();
+        }
+
+        bool isAliased(const Type* outputPtr, size_t rows, size_t columns,
+                       size_t rowStep) const {
+          return (m_operand0.isAliased(outputPtr, rows, columns, rowStep)
+                  || m_operand1.isAliased(outputPtr, rows, columns, rowStep));
+        }
+
+      private:
+        Operand0 m_operand0;
+        Operand1 m_operand1;
+      };
+
+
+      // Interior node of a 2D expression tree, combining each
+      // element of an operand with a scalar.  If IsScalarFirst is
+      // true, the scalar is the left hand argument of the operation.
+      template <class Type, class Operand, class Operation,
+                bool IsScalarFirst>
+      class Array2DScalarNode
+        : public Array2DExpression<
+            Type, Array2DScalarNode<Type, Operand, Operation, IsScalarFirst> >
+      {
+      public:
+        Array2DScalarNode(const Operand& operand, const Type& scalar)
+          : m_operand(operand), m_scalar(scalar) {}
+
+        Type getElement(size_t index) const {
+          return (IsScalarFirst
+                  ? Operation::apply(m_scalar, m_operand.getElement(index))
+                  : Operation::apply(m_operand.getElement(index), m_scalar));
+        }
+
+        Type getElement(size_t row, size_t column) const {
+          return (IsScalarFirst
+                  ? Operation::apply(
+                    m_scalar, m_operand.getElement(row, column))
+                  : Operation::apply(
+                    m_operand.getElement(row, column), m_scalar));
+        }
+
+        size_t getColumns() const {return m_operand.getColumns();}
+        size_t getRows() const {return m_operand.getRows();}
+        bool isContiguous() const {return m_operand.isContiguous();}
+
+        bool isAliased(const Type* outputPtr, size_t rows, size_t columns,
+                       size_t rowStep) const {
+          return m_operand.isAliased(outputPtr, rows, columns, rowStep);
+        }
+
+      private:
+        Operand m_operand;
+        Type m_scalar;
+      };
+
+
+      // Computes the return types of the 2D arithmetic operators.
+      template <class Type, class Derived0, class Derived1, class Operation>
+      struct Array2DBinaryResult {
+        typedef Array2DBinaryNode<
+          Type,
+          typename Array2DNodeTraits<Type, Derived0>::NodeType,
+          typename Array2DNodeTraits<Type, Derived1>::NodeType,
+          Operation> ResultType;
+      };
+
+      template <class Type, class Derived, class Operation,
+                bool IsScalarFirst>
+      struct Array2DScalarResult {
+        typedef Array2DScalarNode<
+          Type, typename Array2DNodeTraits<Type, Derived>::NodeType,
+          Operation, IsScalarFirst> ResultType;
+      };
+
+
+      // Writes every element of a 2D expression to the array
+      // starting at outputPtr, in a single pass.  When neither the
+      // expression nor the output has padding at the ends of its
+      // rows, the elements are visited with a single flat index.  As
+      // with evaluateArray1DNode(), expressions that read the output
+      // other than element-for-element are evaluated into a
+      // temporary array first.
+      template <class Type, class Node>
+      inline void
+      evaluateArray2DNode(const Node& node, Type* outputPtr,
+                          size_t outputRowStep)
+      {
+        const size_t rows = node.getRows();
+        const size_t columns = node.getColumns();
+        if(node.isAliased(outputPtr, rows, columns, outputRowStep)) {
+          Array2D<Type> temporary(node);
+          for(size_t row = 0; row < rows; ++row) {
+            std::copy(temporary.data() + row * temporary.getRowStep(),
+                      temporary.data() + row * temporary.getRowStep()
+                      + columns,
+                      outputPtr + row * outputRowStep);
+          }
+          return;
+        }
+        if(node.isContiguous() && outputRowStep == columns) {
+          const size_t size = rows * columns;
+          for(size_t index = 0; index < size; ++index) {
+            outputPtr[index] = node.getElement(index);
+          }
+          return;
+        }
+        for(size_t row = 0; row < rows; ++row) {
+          Type* rowPtr = outputPtr + row * outputRowStep;
+          for(size_t column = 0; column < columns; ++column) {
+            rowPtr[column] = node.getElement(row, column);
+          }
+        }
+      }
+
+    } // namespace privateCode
+    /// @endcond
+
+
+    // Evaluates the expression into a newly allocated array.
+    template <class Type, class Derived>
+    Array1D<Type>
+    Array1DExpression<Type, Derived>::
+    copy() const
+    {
+      return Array1D<Type>(*this);
+    }
+
+
+    // Returns the number of elements in the expression.
+    template <class Type, class Derived>
+    size_t
+    Array1DExpression<Type, Derived>::
+    size() const
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      return NodeType(this->getDerived()).getSize();
+    }
+
+
+    // Computes one element of the expression.
+    template <class Type, class Derived>
+    Type
+    Array1DExpression<Type, Derived>::
+    operator[](size_t index) const
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      return NodeType(this->getDerived()).getElement(index);
+    }
+
+
+    // Returns the number of columns in the expression.
+    template <class Type, class Derived>
+    size_t
+    Array2DExpression<Type, Derived>::
+    columns() const
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      return NodeType(this->getDerived()).getColumns();
+    }
+
+
+    // Evaluates the expression into a newly allocated array.
+    template <class Type, class Derived>
+    Array2D<Type>
+    Array2DExpression<Type, Derived>::
+    copy() const
+    {
+      return Array2D<Type>(*this);
+    }
+
+
+    // Returns the number of rows in the expression.
+    template <class Type, class Derived>
+    size_t
+    Array2DExpression<Type, Derived>::
+    rows() const
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      return NodeType(this->getDerived()).getRows();
+    }
+
+
+    // Evaluates the expression, and computes its matrix transpose.
+    template <class Type, class Derived>
+    Array2D<Type>
+    Array2DExpression<Type, Derived>::
+    transpose() const
+    {
+      return Array2D<Type>(*this).transpose();
+    }
+
+
+    // Computes one element of the expression.
+    template <class Type, class Derived>
+    Type
+    Array2DExpression<Type, Derived>::
+    operator()(size_t row, size_t column) const
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      return NodeType(this->getDerived()).getElement(row, column);
+    }
+
+
+    // Computes one element of the expression, treating it as a 1D
+    // array in raster order.
+    template <class Type, class Derived>
+    Type
+    Array2DExpression<Type, Derived>::
+    operator[](size_t index) const
+    {
+      typedef typename privateCode::Array2DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(this->getDerived());
+      const size_t columns = node.getColumns();
+      return node.getElement(index / columns, index % columns);
+    }
+
+  } // namespace numeric
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_NUMERIC_ARRAYEXPRESSION_HH */
@@ -34,6 +34,23 @@ namespace brick {
       BRICK_CONVOLVE_ROI_FULL
     };
 
+
+    /**
+     ** This enum selects the algorithm used to compute 2D
+     ** convolutions and correlations.  BRICK_CONVOLVE_METHOD_DIRECT
+     ** always evaluates the full 2D kernel at each output element.
+     ** BRICK_CONVOLVE_METHOD_AUTO inspects the kernel and chooses a
+     ** faster algorithm when one applies, at the cost of small
+     ** differences in floating point rounding.
+     ** BRICK_CONVOLVE_METHOD_FFT always multiplies in the frequency
+     ** domain, which is much faster for large kernels.
+     **/
+    enum ConvolutionMethod {
+      BRICK_CONVOLVE_METHOD_DIRECT,
+      BRICK_CONVOLVE_METHOD_AUTO,
+      BRICK_CONVOLVE_METHOD_FFT
+    };
+
   } // namespace numeric
 
 } // namespace brick
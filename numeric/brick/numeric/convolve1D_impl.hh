@@ -24,6 +24,7 @@
 #include <brick/common/functional.hh> // for clip()
 #include <brick/common/functional.hh> // for clip()
 #include <brick/numeric/numericTraits.hh>
+#include <brick/numeric/simdKernels.hh>
 
 namespace brick {
 
@@ -54,6 +55,45 @@ namespace brick {
       }
 
 
+      // These overloads let correlate1DCommon() hand the most
+      // common type combinations off to the vectorized kernels in
+      // simdKernels.hh.  The generic version simply reports that no
+      // vectorized implementation is available.
+      template <class OutputType, class KernelType, class SignalType>
+      inline bool
+      correlate1DVectorized(const Array1D<KernelType>& /* kernel */,
+			    const SignalType* /* signalPtr */,
+			    size_t /* count */,
+			    OutputType* /* resultPtr */)
+      {
+	return false;
+      }
+
+
+      inline bool
+      correlate1DVectorized(const Array1D<common::Float32>& kernel,
+			    const common::Float32* signalPtr,
+			    size_t count,
+			    common::Float32* resultPtr)
+      {
+	correlateTaps(resultPtr, signalPtr, 1, kernel.data(), kernel.size(),
+		      count);
+	return true;
+      }
+
+
+      inline bool
+      correlate1DVectorized(const Array1D<common::Int32>& kernel,
+			    const common::UInt8* signalPtr,
+			    size_t count,
+			    common::Int32* resultPtr)
+      {
+	correlateTaps(resultPtr, signalPtr, 1, kernel.data(), kernel.size(),
+		      count);
+	return true;
+      }
+
+
       template <class OutputType, class KernelType, class SignalType>
       void
       correlate1DCommon(
@@ -62,6 +102,13 @@ namespace brick {
 	typename Array1D<SignalType>::const_iterator signalEnd,
 	typename Array1D<OutputType>::iterator resultIterator)
       {
+	if(signalEnd > signalBegin
+	   && correlate1DVectorized(kernel, signalBegin,
+				    static_cast<size_t>(signalEnd - signalBegin),
+				    resultIterator)) {
+	  return;
+	}
+
         typedef typename Array1D<SignalType>::const_iterator SignalIterator;
         typedef typename Array1D<KernelType>::const_iterator KernelIterator;
 
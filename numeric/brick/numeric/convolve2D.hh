@@ -13,6 +13,8 @@
 #ifndef BRICK_NUMERIC_CONVOLVE2D_HH
 #define BRICK_NUMERIC_CONVOLVE2D_HH
 
+#include <brick/common/threadPool.hh>
+#include <brick/numeric/array1D.hh>
 #include <brick/numeric/array2D.hh>
 #include <brick/numeric/convolutionStrategy.hh>
 #include <brick/numeric/index2D.hh>
@@ -65,6 +67,187 @@ namespace brick {
 	       const FillType& fillValue);
 
 
+    /**
+     * This function works just like the corresponding serial version
+     * of convolve2D(), but splits the output into bands of rows and
+     * computes the bands concurrently using the threads of the
+     * specified ThreadPool.  The result is identical to that of the
+     * serial version for all convolution strategies.
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       const FillType& fillValue,
+	       brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       const FillType& fillValue,
+	       brick::common::ThreadPool& threadPool);
+
+
+    /**
+     * This function works just like the corresponding version of
+     * convolve2D() that has no method argument, but allows the
+     * caller to select the algorithm used.  If argument method is
+     * BRICK_CONVOLVE_METHOD_AUTO and the kernel is separable (that
+     * is, if it is the outer product of a column vector and a row
+     * vector) and has at least 25 elements, then the much
+     * cheaper convolve2DSeparable() is used.  Otherwise, AUTO compares
+     * rough operation counts and multiplies in the frequency domain
+     * if that is expected to be faster than the direct method, which
+     * is typically the case for kernels larger than about 9x9.  If
+     * argument method is BRICK_CONVOLVE_METHOD_FFT, the frequency
+     * domain is always used.  FFT results differ from the direct
+     * method by floating point roundoff; integer outputs are rounded
+     * to the nearest value.
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       const FillType& fillValue,
+	       ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       const FillType& fillValue,
+	       ConvolutionMethod method);
+
+
+    /**
+     * This function convolves a signal with the separable 2D kernel
+     * formed by the outer product of columnKernel and rowKernel.
+     * That is, kernel(rr, cc) == columnKernel[rr] * rowKernel[cc].
+     * The result is the same (except for floating point rounding) as
+     * calling convolve2D() with the full 2D kernel, but the cost per
+     * output element is proportional to (rowKernel.size() +
+     * columnKernel.size()) rather than their product.  All
+     * ConvolutionStrategy values are supported, with the same
+     * semantics as for convolve2D().
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy = BRICK_CONVOLVE_PAD_RESULT,
+			ConvolutionROI roi = BRICK_CONVOLVE_ROI_SAME);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			ConvolutionROI roi,
+			const FillType& fillValue);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1,
+			const FillType& fillValue);
+
+
     /** Unstable: interface subject to change. **/
     template <class OutputType, class AccumulatorType,
 	      class KernelType, class SignalType>
@@ -109,6 +292,215 @@ namespace brick {
 		const FillType& fillValue);
 
 
+    /**
+     * This function works just like the corresponding serial version
+     * of correlate2D(), but splits the output into bands of rows and
+     * computes the bands concurrently using the threads of the
+     * specified ThreadPool.  The result is identical to that of the
+     * serial version for all convolution strategies.
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		const FillType& fillValue,
+		brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		brick::common::ThreadPool& threadPool);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		const FillType& fillValue,
+		brick::common::ThreadPool& threadPool);
+
+
+    /**
+     * This function works just like the corresponding version of
+     * correlate2D() that has no method argument, but allows the
+     * caller to select the algorithm used.  If argument method is
+     * BRICK_CONVOLVE_METHOD_AUTO and the kernel is separable (that
+     * is, if it is the outer product of a column vector and a row
+     * vector) and has at least 25 elements, then the much
+     * cheaper correlate2DSeparable() is used.  Otherwise, AUTO compares
+     * rough operation counts and multiplies in the frequency domain
+     * if that is expected to be faster than the direct method, which
+     * is typically the case for kernels larger than about 9x9.  If
+     * argument method is BRICK_CONVOLVE_METHOD_FFT, the frequency
+     * domain is always used.  FFT results differ from the direct
+     * method by floating point roundoff; integer outputs are rounded
+     * to the nearest value.
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		const FillType& fillValue,
+		ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		ConvolutionMethod method);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		const FillType& fillValue,
+		ConvolutionMethod method);
+
+
+    /**
+     * This function correlates a signal with the separable 2D kernel
+     * formed by the outer product of columnKernel and rowKernel.
+     * That is, kernel(rr, cc) == columnKernel[rr] * rowKernel[cc].
+     * See convolve2DSeparable() for more information.
+     *
+     * Unstable: interface subject to change.
+     **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy = BRICK_CONVOLVE_PAD_RESULT,
+			 ConvolutionROI roi = BRICK_CONVOLVE_ROI_SAME);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 ConvolutionROI roi,
+			 const FillType& fillValue);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 const Index2D& corner0,
+			 const Index2D& corner1);
+
+
+    /** Unstable: interface subject to change. **/
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 const Index2D& corner0,
+			 const Index2D& corner1,
+			 const FillType& fillValue);
+
+
+    /**
+     * This function tests whether a 2D kernel is separable (has rank
+     * 1), and if so, decomposes it into a column kernel and a row
+     * kernel such that kernel(rr, cc) == columnKernel[rr] *
+     * rowKernel[cc].  For floating point kernel types, the
+     * decomposition is accepted if every reconstructed element is
+     * within a few epsilon (relative to the largest kernel element)
+     * of the original.  For integral kernel types, the decomposition
+     * must be exact, and integral factors are preferred, so that
+     * (for example) an integer Sobel kernel separates into [1, 2, 1]
+     * and [-1, 0, 1].
+     *
+     * @param kernel This argument is the kernel to be tested.
+     *
+     * @param columnKernel If kernel is separable, this argument is
+     * used to return the column factor, which will have
+     * kernel.rows() elements.
+     *
+     * @param rowKernel If kernel is separable, this argument is used
+     * to return the row factor, which will have kernel.columns()
+     * elements.
+     *
+     * @return The return value is true if kernel is separable, false
+     * otherwise.  If the return value is false, columnKernel and
+     * rowKernel are not modified.
+     */
+    template <class KernelType>
+    bool
+    separateKernel2D(const Array2D<KernelType>& kernel,
+		     Array1D<KernelType>& columnKernel,
+		     Array1D<KernelType>& rowKernel);
+
+
   } // namespace numeric
 
 } // namespace brick
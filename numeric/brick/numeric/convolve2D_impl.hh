@@ -19,8 +19,13 @@
 // #include <brick/numeric/convolve2D.hh>
 
 #include <algorithm> // For std::reverse_copy()
+#include <cmath>
+#include <complex>
+#include <limits>
 #include <numeric> // For std::partial_sum()
 #include <brick/common/functional.hh>
+#include <brick/numeric/fft.hh>
+#include <brick/numeric/filter.hh>
 #include <brick/numeric/numericTraits.hh>
 #include <brick/numeric/stencil2D.hh>
 
@@ -632,11 +637,10 @@ namespace brick {
 	}
 
 	// Fill in the middle of the image.
-	Index2D newCorner0(kRowOverTwo, kColOverTwo);
-	Index2D newCorner1(static_cast<int>(signal.rows()) - kRowOverTwo,
-			   static_cast<int>(signal.columns()) - kColOverTwo);
-	Index2D resultCorner0(static_cast<int>(kernel.rows()) - 1,
-			      static_cast<int>(kernel.columns()) - 1);
+	Index2D newCorner0(clippedTransitionRow0, clippedTransitionColumn0);
+	Index2D newCorner1(clippedTransitionRow1, clippedTransitionColumn1);
+	Index2D resultCorner0(clippedTransitionRow0 - startRow,
+			      clippedTransitionColumn0 - startColumn);
         correlate2DCommon<OutputType, AccumulatorType, KernelType, SignalType>(
 	  kernel, signal, result, newCorner0, newCorner1, resultCorner0);
         return result;
@@ -851,11 +855,10 @@ namespace brick {
 	}
 
 	// Fill in the middle of the image.
-	Index2D newCorner0(kRowOverTwo, kColOverTwo);
-	Index2D newCorner1(static_cast<int>(signal.rows()) - kRowOverTwo,
-			   static_cast<int>(signal.columns()) - kColOverTwo);
-	Index2D resultCorner0(static_cast<int>(kernel.rows()) - 1,
-			      static_cast<int>(kernel.columns()) - 1);
+	Index2D newCorner0(clippedTransitionRow0, clippedTransitionColumn0);
+	Index2D newCorner1(clippedTransitionRow1, clippedTransitionColumn1);
+	Index2D resultCorner0(clippedTransitionRow0 - startRow,
+			      clippedTransitionColumn0 - startColumn);
         correlate2DCommon<OutputType, AccumulatorType, KernelType, SignalType>(
 	  kernel, signal, result, newCorner0, newCorner1, resultCorner0);
         return result;
@@ -1073,11 +1076,10 @@ namespace brick {
 	}
 
 	// Fill in the middle of the image.
-	Index2D newCorner0(kRowOverTwo, kColOverTwo);
-	Index2D newCorner1(static_cast<int>(signal.rows()) - kRowOverTwo,
-			   static_cast<int>(signal.columns()) - kColOverTwo);
-	Index2D resultCorner0(static_cast<int>(kernel.rows()) - 1,
-			      static_cast<int>(kernel.columns()) - 1);
+	Index2D newCorner0(clippedTransitionRow0, clippedTransitionColumn0);
+	Index2D newCorner1(clippedTransitionRow1, clippedTransitionColumn1);
+	Index2D resultCorner0(clippedTransitionRow0 - startRow,
+			      clippedTransitionColumn0 - startColumn);
         correlate2DCommon<OutputType, AccumulatorType, KernelType, SignalType>(
 	  kernel, signal, result, newCorner0, newCorner1, resultCorner0);
         return result;
@@ -1263,7 +1265,7 @@ namespace brick {
 
 	// Fill in areas along bottom of image.
         while(row < stopRow) {
-	  int donorRow = row - outputRow - static_cast<int>(signal.rows());
+	  int donorRow = outputRow - static_cast<int>(signal.rows());
 
 	  if(donorRow >= 0) {
 	    std::copy(result.rowBegin(donorRow), result.rowEnd(donorRow),
@@ -1368,11 +1370,10 @@ namespace brick {
 	}
 
 	// Fill in the middle of the image.
-	Index2D newCorner0(kRowOverTwo, kColOverTwo);
-	Index2D newCorner1(static_cast<int>(signal.rows()) - kRowOverTwo,
-			   static_cast<int>(signal.columns()) - kColOverTwo);
-	Index2D resultCorner0(static_cast<int>(kernel.rows()) - 1,
-			      static_cast<int>(kernel.columns()) - 1);
+	Index2D newCorner0(clippedTransitionRow0, clippedTransitionColumn0);
+	Index2D newCorner1(clippedTransitionRow1, clippedTransitionColumn1);
+	Index2D resultCorner0(clippedTransitionRow0 - startRow,
+			      clippedTransitionColumn0 - startColumn);
         correlate2DCommon<OutputType, AccumulatorType, KernelType, SignalType>(
 	  kernel, signal, result, newCorner0, newCorner1, resultCorner0);
         return result;
@@ -1392,6 +1393,744 @@ namespace brick {
       }
 
 
+      // Returns the index of the element of a signal of length size
+      // that is used for (possibly out-of-bounds) index, or -1 if the
+      // strategy pads out-of-bounds elements with a constant.
+      inline int
+      mapPaddedIndex(int index, int size, ConvolutionStrategy strategy)
+      {
+	if(index >= 0 && index < size) {
+	  return index;
+	}
+	switch(strategy) {
+	case BRICK_CONVOLVE_REFLECT_SIGNAL:
+	{
+	  // Reflection repeats the signal with period 2 * size, and
+	  // duplicates the border elements: ... 1 0 | 0 1 2 ... .
+	  int period = 2 * size;
+	  int position = index % period;
+	  if(position < 0) {
+	    position += period;
+	  }
+	  return (position < size) ? position : (period - 1 - position);
+	}
+	case BRICK_CONVOLVE_WRAP_SIGNAL:
+	{
+	  int position = index % size;
+	  return (position < 0) ? (position + size) : position;
+	}
+	default:
+	  break;
+	}
+	return -1;
+      }
+
+
+      // Computes the "valid" correlation of paddedSignal with the
+      // separable kernel described by rowKernel and columnKernel,
+      // using one pass over the columns and one over the rows.
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType>
+      Array2D<OutputType>
+      correlate2DSeparableValid(const Array1D<KernelType>& rowKernel,
+				const Array1D<KernelType>& columnKernel,
+				const Array2D<SignalType>& paddedSignal)
+      {
+	const size_t outputRows =
+	  paddedSignal.rows() - columnKernel.size() + 1;
+	const size_t outputColumns =
+	  paddedSignal.columns() - rowKernel.size() + 1;
+	const size_t rowOffset = columnKernel.size() / 2;
+	const size_t columnOffset = rowKernel.size() / 2;
+
+	// The filter functions do their arithmetic in the precision
+	// of the kernel, so promote the kernels to AccumulatorType.
+	Array1D<AccumulatorType> rowKernelAcc(rowKernel.size());
+	std::copy(rowKernel.begin(), rowKernel.end(), rowKernelAcc.begin());
+	Array1D<AccumulatorType> columnKernelAcc(columnKernel.size());
+	std::copy(columnKernel.begin(), columnKernel.end(),
+		  columnKernelAcc.begin());
+
+	// Vertical pass.  Only rows [rowOffset, rowOffset +
+	// outputRows) of columnResult are valid after this call.
+	Array2D<AccumulatorType> columnResult(
+	  paddedSignal.rows(), paddedSignal.columns());
+	filterColumns(columnResult, paddedSignal, columnKernelAcc);
+
+	// Horizontal pass, restricted to the valid rows.  Only columns
+	// [columnOffset, columnOffset + outputColumns) of rowResult
+	// are valid after this call.
+	Array2D<AccumulatorType> validRows(
+	  outputRows, paddedSignal.columns(), columnResult.data(rowOffset, 0));
+	Array2D<AccumulatorType> rowResult(
+	  outputRows, paddedSignal.columns());
+	filterRows(rowResult, validRows, rowKernelAcc);
+
+	Array2D<OutputType> result(outputRows, outputColumns);
+	for(size_t row = 0; row < outputRows; ++row) {
+	  typename Array2D<AccumulatorType>::const_iterator inIter =
+	    rowResult.rowBegin(row) + columnOffset;
+	  typename Array2D<OutputType>::iterator outIter = result.rowBegin(row);
+	  typename Array2D<OutputType>::iterator outEnd = result.rowEnd(row);
+	  while(outIter != outEnd) {
+	    *outIter = static_cast<OutputType>(*inIter);
+	    ++inIter;
+	    ++outIter;
+	  }
+	}
+	return result;
+      }
+
+
+      // Builds a copy of the part of signal that contributes to the
+      // output region [corner0, corner1), extended by kRowOverTwo
+      // rows and kColOverTwo columns on each side, with the
+      // out-of-bounds elements filled according to strategy.
+      template <class SignalType>
+      Array2D<SignalType>
+      getPaddedSignal(const Array2D<SignalType>& signal,
+		      ConvolutionStrategy strategy,
+		      const Index2D& corner0,
+		      const Index2D& corner1,
+		      int kRowOverTwo,
+		      int kColOverTwo,
+		      const SignalType& padValue)
+      {
+	const int signalRows = static_cast<int>(signal.rows());
+	const int signalColumns = static_cast<int>(signal.columns());
+	const int paddedRow0 = corner0.getRow() - kRowOverTwo;
+	const int paddedColumn0 = corner0.getColumn() - kColOverTwo;
+	Array2D<SignalType> paddedSignal(
+	  corner1.getRow() - corner0.getRow() + 2 * kRowOverTwo,
+	  corner1.getColumn() - corner0.getColumn() + 2 * kColOverTwo);
+	std::vector<int> columnIndices(paddedSignal.columns());
+	for(size_t column = 0; column < paddedSignal.columns(); ++column) {
+	  columnIndices[column] = mapPaddedIndex(
+	    paddedColumn0 + static_cast<int>(column), signalColumns, strategy);
+	}
+	for(size_t row = 0; row < paddedSignal.rows(); ++row) {
+	  const int signalRow = mapPaddedIndex(
+	    paddedRow0 + static_cast<int>(row), signalRows, strategy);
+	  typename Array2D<SignalType>::iterator outIter =
+	    paddedSignal.rowBegin(row);
+	  if(signalRow < 0) {
+	    std::fill(outIter, paddedSignal.rowEnd(row), padValue);
+	    continue;
+	  }
+	  typename Array2D<SignalType>::const_iterator inIter =
+	    signal.rowBegin(signalRow);
+	  for(size_t column = 0; column < paddedSignal.columns(); ++column) {
+	    *outIter = ((columnIndices[column] < 0)
+			? padValue : inIter[columnIndices[column]]);
+	    ++outIter;
+	  }
+	}
+	return paddedSignal;
+      }
+
+
+      // Implements every ConvolutionStrategy in terms of a functor
+      // that computes only the "valid" part of a correlation (the
+      // part for which the kernel lies entirely within its input).
+      // This is shared by the separable and FFT code paths, neither
+      // of which can cheaply handle borders on the fly.
+      template <class OutputType, class SignalType, class ValidCorrelator>
+      Array2D<OutputType>
+      correlate2DViaValid(const ValidCorrelator& validCorrelator,
+			  size_t kernelRows,
+			  size_t kernelColumns,
+			  const Array2D<SignalType>& signal,
+			  ConvolutionStrategy strategy,
+			  const Index2D& corner0,
+			  const Index2D& corner1,
+			  const OutputType& resultFillValue,
+			  const SignalType& signalFillValue)
+      {
+	const int kRowOverTwo = static_cast<int>(kernelRows) / 2;
+	const int kColOverTwo = static_cast<int>(kernelColumns) / 2;
+	const int signalRows = static_cast<int>(signal.rows());
+	const int signalColumns = static_cast<int>(signal.columns());
+
+	switch(strategy) {
+	case BRICK_CONVOLVE_TRUNCATE_RESULT:
+	  return validCorrelator(signal);
+	  break;
+	case BRICK_CONVOLVE_PAD_RESULT:
+	{
+	  Array2D<OutputType> validResult = validCorrelator(signal);
+	  Array2D<OutputType> result(corner1.getRow() - corner0.getRow(),
+				     corner1.getColumn() - corner0.getColumn());
+	  result = resultFillValue;
+	  const int row0 = std::max(corner0.getRow(), kRowOverTwo);
+	  const int row1 = std::min(corner1.getRow(), signalRows - kRowOverTwo);
+	  const int column0 = std::max(corner0.getColumn(), kColOverTwo);
+	  const int column1 = std::min(corner1.getColumn(),
+				       signalColumns - kColOverTwo);
+	  for(int row = row0; row < row1; ++row) {
+	    std::copy(validResult.rowBegin(row - kRowOverTwo)
+		      + (column0 - kColOverTwo),
+		      validResult.rowBegin(row - kRowOverTwo)
+		      + (column1 - kColOverTwo),
+		      result.rowBegin(row - corner0.getRow())
+		      + (column0 - corner0.getColumn()));
+	  }
+	  return result;
+	  break;
+	}
+	case BRICK_CONVOLVE_PAD_SIGNAL:
+	case BRICK_CONVOLVE_ZERO_PAD_SIGNAL:
+	case BRICK_CONVOLVE_REFLECT_SIGNAL:
+	case BRICK_CONVOLVE_WRAP_SIGNAL:
+	{
+	  // Build an explicitly padded copy of the part of the
+	  // signal that contributes to the requested region, and then
+	  // compute the valid correlation of that.
+	  const SignalType padValue =
+	    (strategy == BRICK_CONVOLVE_PAD_SIGNAL)
+	    ? signalFillValue : static_cast<SignalType>(0);
+	  return validCorrelator(
+	    getPaddedSignal(signal, strategy, corner0, corner1,
+			    kRowOverTwo, kColOverTwo, padValue));
+	  break;
+	}
+	default:
+	  BRICK_THROW(brick::common::LogicException, "correlate2DViaValid()",
+		      "Illegal value for strategy argument.");
+	  break;
+	}
+	return Array2D<OutputType>();
+      }
+
+
+      template <class OutputType, class AccumulatorType, class KernelType>
+      class SeparableValidCorrelator {
+      public:
+	SeparableValidCorrelator(const Array1D<KernelType>& rowKernel,
+				 const Array1D<KernelType>& columnKernel)
+	  : m_rowKernel(rowKernel), m_columnKernel(columnKernel) {}
+
+	template <class SignalType>
+	Array2D<OutputType>
+	operator()(const Array2D<SignalType>& paddedSignal) const {
+	  return correlate2DSeparableValid<
+	    OutputType, AccumulatorType, KernelType, SignalType>(
+	      m_rowKernel, m_columnKernel, paddedSignal);
+	}
+
+      private:
+	const Array1D<KernelType>& m_rowKernel;
+	const Array1D<KernelType>& m_columnKernel;
+      };
+
+
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType>
+      Array2D<OutputType>
+      correlate2DSeparableCommon(const Array1D<KernelType>& rowKernel,
+				 const Array1D<KernelType>& columnKernel,
+				 const Array2D<SignalType>& signal,
+				 ConvolutionStrategy strategy,
+				 const Index2D& corner0,
+				 const Index2D& corner1,
+				 const OutputType& resultFillValue,
+				 const SignalType& signalFillValue)
+      {
+	if(columnKernel.size() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2DSeparable()",
+		      "Argument columnKernel must have an odd number of "
+		      "elements.");
+	}
+	if(rowKernel.size() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2DSeparable()",
+		      "Argument rowKernel must have an odd number of "
+		      "elements.");
+	}
+	if(columnKernel.size() > signal.rows()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2DSeparable()",
+		      "Argument columnKernel must not have more elements "
+		      "than argument signal has rows.");
+	}
+	if(rowKernel.size() > signal.columns()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2DSeparable()",
+		      "Argument rowKernel must not have more elements "
+		      "than argument signal has columns.");
+	}
+
+	SeparableValidCorrelator<OutputType, AccumulatorType, KernelType>
+	  validCorrelator(rowKernel, columnKernel);
+	return correlate2DViaValid<OutputType, SignalType>(
+	  validCorrelator, columnKernel.size(), rowKernel.size(), signal,
+	  strategy, corner0, corner1, resultFillValue, signalFillValue);
+      }
+
+
+      // Converts a value computed by the FFT code path to OutputType.
+      // FFT results carry a little roundoff error, so integral
+      // outputs are rounded rather than truncated.
+      template <class OutputType>
+      inline OutputType
+      convertFFTResult(double value)
+      {
+	if(std::numeric_limits<OutputType>::is_integer) {
+	  return static_cast<OutputType>(
+	    (value < 0.0) ? (value - 0.5) : (value + 0.5));
+	}
+	return static_cast<OutputType>(value);
+      }
+
+
+      // Computes the "valid" correlation of paddedSignal with kernel
+      // by pointwise multiplication in the frequency domain.  The
+      // transform is circular, but only needs to be as large as
+      // paddedSignal, since none of the valid outputs wrap around.
+      template <class OutputType, class KernelType, class SignalType>
+      Array2D<OutputType>
+      correlate2DFFTValid(const Array2D<KernelType>& kernel,
+			  const Array2D<SignalType>& paddedSignal)
+      {
+	typedef std::complex<double> ComplexType;
+	const size_t outputRows = paddedSignal.rows() - kernel.rows() + 1;
+	const size_t outputColumns =
+	  paddedSignal.columns() - kernel.columns() + 1;
+	const size_t fftRows = getEfficientFFTSize(paddedSignal.rows());
+	const size_t fftColumns = getEfficientFFTSize(paddedSignal.columns());
+
+	// Both inputs are real, so we transform them together as the
+	// real and imaginary parts of a single complex array, Z = S + iK.
+	Array2D<ComplexType> spectrum(fftRows, fftColumns);
+	spectrum = ComplexType(0.0, 0.0);
+	for(size_t row = 0; row < paddedSignal.rows(); ++row) {
+	  std::copy(paddedSignal.rowBegin(row), paddedSignal.rowEnd(row),
+		    spectrum.rowBegin(row));
+	}
+	for(size_t row = 0; row < kernel.rows(); ++row) {
+	  typename Array2D<KernelType>::const_iterator inIter =
+	    kernel.rowBegin(row);
+	  typename Array2D<ComplexType>::iterator outIter =
+	    spectrum.rowBegin(row);
+	  for(size_t column = 0; column < kernel.columns(); ++column) {
+	    outIter->imag(static_cast<double>(*inIter));
+	    ++inIter;
+	    ++outIter;
+	  }
+	}
+	FFTPlan2D<ComplexType> forwardPlan(fftRows, fftColumns);
+	forwardPlan.execute(spectrum);
+
+	// The spectra of S and K are conjugate symmetric, so they can
+	// be separated using the element at the negated frequency:
+	// S[f] = (Z[f] + conj(Z[-f])) / 2 and K[f] = (Z[f] - conj(Z[-f])) / 2i.
+	// Correlation with a real kernel is multiplication by conj(K).
+	// The product is conjugate symmetric too, so each pair of
+	// elements (f, -f) is handled once.
+	for(size_t row = 0; row < fftRows; ++row) {
+	  const size_t reflectedRow = (fftRows - row) % fftRows;
+	  if(reflectedRow < row) {
+	    continue;
+	  }
+	  for(size_t column = 0; column < fftColumns; ++column) {
+	    const size_t reflectedColumn = (fftColumns - column) % fftColumns;
+	    if(reflectedRow == row && reflectedColumn < column) {
+	      continue;
+	    }
+	    ComplexType& zz = spectrum(row, column);
+	    ComplexType& zzReflected = spectrum(reflectedRow, reflectedColumn);
+	    const ComplexType signalTerm = 0.5 * (zz + std::conj(zzReflected));
+	    const ComplexType difference = 0.5 * (zz - std::conj(zzReflected));
+	    const ComplexType kernelTerm(difference.imag(), -difference.real());
+	    const ComplexType product(
+	      signalTerm.real() * kernelTerm.real()
+	      + signalTerm.imag() * kernelTerm.imag(),
+	      signalTerm.imag() * kernelTerm.real()
+	      - signalTerm.real() * kernelTerm.imag());
+	    zz = product;
+	    zzReflected = std::conj(product);
+	  }
+	}
+	FFTPlan2D<ComplexType> inversePlan(fftRows, fftColumns, true);
+	inversePlan.execute(spectrum);
+
+	const double scale = 1.0 / static_cast<double>(fftRows * fftColumns);
+	Array2D<OutputType> result(outputRows, outputColumns);
+	for(size_t row = 0; row < outputRows; ++row) {
+	  typename Array2D<ComplexType>::const_iterator inIter =
+	    spectrum.rowBegin(row);
+	  typename Array2D<OutputType>::iterator outIter = result.rowBegin(row);
+	  typename Array2D<OutputType>::iterator outEnd = result.rowEnd(row);
+	  while(outIter != outEnd) {
+	    *outIter = convertFFTResult<OutputType>(inIter->real() * scale);
+	    ++inIter;
+	    ++outIter;
+	  }
+	}
+	return result;
+      }
+
+
+      template <class OutputType, class KernelType>
+      class FFTValidCorrelator {
+      public:
+	FFTValidCorrelator(const Array2D<KernelType>& kernel)
+	  : m_kernel(kernel) {}
+
+	template <class SignalType>
+	Array2D<OutputType>
+	operator()(const Array2D<SignalType>& paddedSignal) const {
+	  return correlate2DFFTValid<OutputType, KernelType, SignalType>(
+	    m_kernel, paddedSignal);
+	}
+
+      private:
+	const Array2D<KernelType>& m_kernel;
+      };
+
+
+      template <class OutputType, class KernelType, class SignalType>
+      Array2D<OutputType>
+      correlate2DFFTCommon(const Array2D<KernelType>& kernel,
+			   const Array2D<SignalType>& signal,
+			   ConvolutionStrategy strategy,
+			   const Index2D& corner0,
+			   const Index2D& corner1,
+			   const OutputType& resultFillValue,
+			   const SignalType& signalFillValue)
+      {
+	if(kernel.rows() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must have an odd number of rows.");
+	}
+	if(kernel.columns() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must have an odd number of columns.");
+	}
+	if(kernel.rows() > signal.rows()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must not have more rows than "
+		      "argument signal.");
+	}
+	if(kernel.columns() > signal.columns()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must not have more columns than "
+		      "argument signal.");
+	}
+
+	FFTValidCorrelator<OutputType, KernelType> validCorrelator(kernel);
+	return correlate2DViaValid<OutputType, SignalType>(
+	  validCorrelator, kernel.rows(), kernel.columns(), signal,
+	  strategy, corner0, corner1, resultFillValue, signalFillValue);
+      }
+
+
+      // Returns true if, for argument method, the caller should use
+      // the FFT code path to compute the region [corner0, corner1).
+      template <class KernelType>
+      bool
+      selectFFT(const Array2D<KernelType>& kernel,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		ConvolutionMethod method)
+      {
+	if(method == BRICK_CONVOLVE_METHOD_FFT) {
+	  return true;
+	}
+	if(method != BRICK_CONVOLVE_METHOD_AUTO) {
+	  return false;
+	}
+
+	// Compare rough operation counts.  The direct method costs
+	// one multiply-add per kernel element per output element.
+	// The FFT method costs two 2D transforms, each about
+	// N*log2(N) complex butterflies, where N is the (padded)
+	// transform size.  The constant below was measured using
+	// timeCorrelate2D_fft() in convolve2DTest.cc, and absorbs the
+	// difference in cost between a butterfly and a multiply-add.
+	const double fftCostPerButterfly = 3.0;
+	const double outputRows =
+	  static_cast<double>(corner1.getRow() - corner0.getRow());
+	const double outputColumns =
+	  static_cast<double>(corner1.getColumn() - corner0.getColumn());
+	const double directCost =
+	  outputRows * outputColumns * static_cast<double>(kernel.size());
+	const double fftSize = static_cast<double>(
+	  getEfficientFFTSize(
+	    static_cast<size_t>(outputRows) + kernel.rows() - 1)
+	  * getEfficientFFTSize(
+	    static_cast<size_t>(outputColumns) + kernel.columns() - 1));
+	const double fftCost =
+	  2.0 * fftCostPerButterfly * fftSize * std::log(fftSize) / std::log(2.0);
+	return fftCost < directCost;
+      }
+
+
+      template <class KernelType>
+      Array1D<KernelType>
+      reverseKernel(const Array1D<KernelType>& kernel) {
+	Array1D<KernelType> reversedKernel(kernel.size());
+	std::reverse_copy(kernel.begin(), kernel.end(), reversedKernel.begin());
+	return reversedKernel;
+      }
+
+
+      // Returns true if, for argument method, the caller should use
+      // the separable code path.  If so, the two factors of kernel
+      // are returned through columnKernel and rowKernel.
+      template <class KernelType>
+      bool
+      selectSeparable(const Array2D<KernelType>& kernel,
+		      ConvolutionMethod method,
+		      Array1D<KernelType>& columnKernel,
+		      Array1D<KernelType>& rowKernel)
+      {
+	if(method != BRICK_CONVOLVE_METHOD_AUTO) {
+	  return false;
+	}
+
+	// For small kernels, the cost of building the padded signal
+	// and the intermediate array outweighs the savings.  Timing
+	// shows the crossover to be somewhere between 9 and 25 elements.
+	if(kernel.rows() < 3 || kernel.columns() < 3
+	   || kernel.rows() * kernel.columns() < 25) {
+	  return false;
+	}
+	return separateKernel2D(kernel, columnKernel, rowKernel);
+      }
+
+
+      // Tag type used by the row-parallel correlate2D() overloads to
+      // indicate that the caller did not supply a fill value.
+      struct Correlate2DNoFillValue {};
+
+
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType>
+      inline Array2D<OutputType>
+      correlate2DSerial(const Array2D<KernelType>& kernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1,
+			const Correlate2DNoFillValue& /* fillValue */)
+      {
+	return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	  kernel, signal, strategy, corner0, corner1);
+      }
+
+
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType, class FillType>
+      inline Array2D<OutputType>
+      correlate2DSerial(const Array2D<KernelType>& kernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1,
+			const FillType& fillValue)
+      {
+	return correlate2D<OutputType, AccumulatorType, KernelType, SignalType,
+			   FillType>(
+	  kernel, signal, strategy, corner0, corner1, fillValue);
+      }
+
+
+      inline void
+      getCorrelate2DCorners(size_t kernelRows,
+			    size_t kernelColumns,
+			    size_t signalRowsArg,
+			    size_t signalColumnsArg,
+			    ConvolutionROI roi,
+			    Index2D& corner0,
+			    Index2D& corner1)
+      {
+	const int kRowOverTwo = static_cast<int>(kernelRows) / 2;
+	const int kColOverTwo = static_cast<int>(kernelColumns) / 2;
+	const int signalRows = static_cast<int>(signalRowsArg);
+	const int signalColumns = static_cast<int>(signalColumnsArg);
+	switch(roi) {
+	case BRICK_CONVOLVE_ROI_SAME:
+	  corner0.setValue(0, 0);
+	  corner1.setValue(signalRows, signalColumns);
+	  break;
+	case BRICK_CONVOLVE_ROI_VALID:
+	  corner0.setValue(kRowOverTwo, kColOverTwo);
+	  corner1.setValue(signalRows - kRowOverTwo,
+			   signalColumns - kColOverTwo);
+	  break;
+	case BRICK_CONVOLVE_ROI_FULL:
+	  corner0.setValue(-kRowOverTwo, -kColOverTwo);
+	  corner1.setValue(signalRows + kRowOverTwo,
+			   signalColumns + kColOverTwo);
+	  break;
+	default:
+	  BRICK_THROW(brick::common::LogicException, "getCorrelate2DCorners()",
+		      "Illegal value for roi argument.");
+	  break;
+	}
+      }
+
+
+      template <class KernelType, class SignalType>
+      void
+      getCorrelate2DCorners(const Array2D<KernelType>& kernel,
+			    const Array2D<SignalType>& signal,
+			    ConvolutionROI roi,
+			    Index2D& corner0,
+			    Index2D& corner1)
+      {
+	getCorrelate2DCorners(kernel.rows(), kernel.columns(),
+			      signal.rows(), signal.columns(),
+			      roi, corner0, corner1);
+      }
+
+
+      /**
+       ** This functor computes one horizontal band of the output of
+       ** correlate2D() by calling the serial implementation, and
+       ** copies the band into the appropriate rows of the full
+       ** result.  Bands never overlap, so instances can be safely
+       ** invoked concurrently for different band indices.
+       **/
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType, class FillType>
+      class Correlate2DBandFunctor {
+      public:
+
+	Correlate2DBandFunctor(const Array2D<KernelType>& kernel,
+			       const Array2D<SignalType>& signal,
+			       ConvolutionStrategy strategy,
+			       const Index2D& corner0,
+			       const Index2D& corner1,
+			       const FillType& fillValue,
+			       size_t numberOfBands,
+			       Array2D<OutputType>& result)
+	  : m_kernel(kernel),
+	    m_signal(signal),
+	    m_strategy(strategy),
+	    m_corner0(corner0),
+	    m_corner1(corner1),
+	    m_fillValue(fillValue),
+	    m_numberOfBands(numberOfBands),
+	    m_result(result) {}
+
+
+	void
+	operator()(size_t band) const {
+	  const size_t row0 = (band * m_result.rows()) / m_numberOfBands;
+	  const size_t row1 = ((band + 1) * m_result.rows()) / m_numberOfBands;
+	  if(row1 == row0) {
+	    return;
+	  }
+
+	  Array2D<OutputType> bandResult;
+	  if(m_strategy == BRICK_CONVOLVE_TRUNCATE_RESULT) {
+	    // This strategy ignores the corners, and always computes
+	    // the "valid" region of the signal, so we run it on just
+	    // the rows of signal that contribute to this band.  Note
+	    // that bandSignal does not own its data.
+	    Array2D<SignalType> bandSignal(
+	      row1 - row0 + m_kernel.rows() - 1, m_signal.columns(),
+	      const_cast<SignalType*>(m_signal.rowBegin(row0)),
+	      m_signal.getRowStep());
+	    bandResult = correlate2DSerial<OutputType, AccumulatorType>(
+	      m_kernel, bandSignal, m_strategy, m_corner0, m_corner1,
+	      m_fillValue);
+	  } else {
+	    Index2D bandCorner0(m_corner0.getRow() + static_cast<int>(row0),
+				m_corner0.getColumn());
+	    Index2D bandCorner1(m_corner0.getRow() + static_cast<int>(row1),
+				m_corner1.getColumn());
+	    bandResult = correlate2DSerial<OutputType, AccumulatorType>(
+	      m_kernel, m_signal, m_strategy, bandCorner0, bandCorner1,
+	      m_fillValue);
+	  }
+
+	  for(size_t row = row0; row < row1; ++row) {
+	    std::copy(bandResult.rowBegin(row - row0),
+		      bandResult.rowEnd(row - row0),
+		      m_result.rowBegin(row));
+	  }
+	}
+
+      private:
+
+	const Array2D<KernelType>& m_kernel;
+	const Array2D<SignalType>& m_signal;
+	ConvolutionStrategy m_strategy;
+	Index2D m_corner0;
+	Index2D m_corner1;
+	const FillType& m_fillValue;
+	size_t m_numberOfBands;
+	Array2D<OutputType>& m_result;
+      };
+
+
+      template <class OutputType, class AccumulatorType,
+		class KernelType, class SignalType, class FillType>
+      Array2D<OutputType>
+      correlate2DRowBands(const Array2D<KernelType>& kernel,
+			  const Array2D<SignalType>& signal,
+			  ConvolutionStrategy strategy,
+			  const Index2D& corner0,
+			  const Index2D& corner1,
+			  const FillType& fillValue,
+			  brick::common::ThreadPool& threadPool)
+      {
+	// Argument checking happens before we start any threads, so
+	// that errors are reported just as for the serial version.
+	if(kernel.rows() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must have an odd number of rows.");
+	}
+	if(kernel.columns() % 2 != 1) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must have an odd number of columns.");
+	}
+	if(kernel.rows() > signal.rows()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must not have more rows than "
+		      "argument signal.");
+	}
+	if(kernel.columns() > signal.columns()) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "Argument kernel must not have more columns than "
+		      "argument signal.");
+	}
+
+	size_t outputRows;
+	size_t outputColumns;
+	if(strategy == BRICK_CONVOLVE_TRUNCATE_RESULT) {
+	  outputRows = signal.rows() - kernel.rows() + 1;
+	  outputColumns = signal.columns() - kernel.columns() + 1;
+	} else {
+	  if(corner1.getRow() < corner0.getRow()
+	     || corner1.getColumn() < corner0.getColumn()) {
+	    BRICK_THROW(brick::common::ValueException, "correlate2D()",
+			"Argument corner0 must be above and to the left "
+			"of argument corner1.");
+	  }
+	  outputRows = corner1.getRow() - corner0.getRow();
+	  outputColumns = corner1.getColumn() - corner0.getColumn();
+	}
+
+	// A few bands per thread helps balance the load, since bands
+	// near the image border can be more expensive than bands in
+	// the middle.
+	const size_t numberOfBands = std::min(
+	  outputRows, 4 * threadPool.getNumberOfThreads());
+	if(numberOfBands <= 1) {
+	  return correlate2DSerial<OutputType, AccumulatorType>(
+	    kernel, signal, strategy, corner0, corner1, fillValue);
+	}
+
+	Array2D<OutputType> result(outputRows, outputColumns);
+	Correlate2DBandFunctor<OutputType, AccumulatorType,
+			       KernelType, SignalType, FillType> bandFunctor(
+	  kernel, signal, strategy, corner0, corner1, fillValue,
+	  numberOfBands, result);
+	threadPool.parallelFor(numberOfBands, bandFunctor);
+	return result;
+      }
+
+
     } // namespace privateCode
     /// @endcond
 
@@ -1680,6 +2419,542 @@ namespace brick {
       return Array2D<OutputType>();
     }
 
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       brick::common::ThreadPool& threadPool)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, roi, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       const FillType& fillValue,
+	       brick::common::ThreadPool& threadPool)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, roi, fillValue, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       brick::common::ThreadPool& threadPool)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, corner0, corner1, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       const FillType& fillValue,
+	       brick::common::ThreadPool& threadPool)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, corner0, corner1, fillValue,
+	threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		brick::common::ThreadPool& threadPool)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(kernel, signal, roi, corner0, corner1);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	kernel, signal, strategy, corner0, corner1, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		const FillType& fillValue,
+		brick::common::ThreadPool& threadPool)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(kernel, signal, roi, corner0, corner1);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	kernel, signal, strategy, corner0, corner1, fillValue, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		brick::common::ThreadPool& threadPool)
+    {
+      if(strategy == BRICK_CONVOLVE_PAD_RESULT
+	 || strategy == BRICK_CONVOLVE_PAD_SIGNAL) {
+        BRICK_THROW(brick::common::ValueException, "correlate2D()",
+                  "The specified convolution strategy requires that a "
+		  "fill value be specified.");
+      }
+      return privateCode::correlate2DRowBands<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  kernel, signal, strategy, corner0, corner1,
+	  privateCode::Correlate2DNoFillValue(), threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		const FillType& fillValue,
+		brick::common::ThreadPool& threadPool)
+    {
+      return privateCode::correlate2DRowBands<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  kernel, signal, strategy, corner0, corner1, fillValue, threadPool);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       ConvolutionMethod method)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, roi, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       ConvolutionROI roi,
+	       const FillType& fillValue,
+	       ConvolutionMethod method)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, roi, fillValue, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       ConvolutionMethod method)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, corner0, corner1, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2D(const Array2D<KernelType>& kernel,
+	       const Array2D<SignalType>& signal,
+	       ConvolutionStrategy strategy,
+	       const Index2D& corner0,
+	       const Index2D& corner1,
+	       const FillType& fillValue,
+	       ConvolutionMethod method)
+    {
+      Array2D<KernelType> reversedKernel = privateCode::reverseKernel(kernel);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	reversedKernel, signal, strategy, corner0, corner1, fillValue, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			ConvolutionROI roi)
+    {
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  privateCode::reverseKernel(rowKernel),
+	  privateCode::reverseKernel(columnKernel), signal, strategy, roi);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			ConvolutionROI roi,
+			const FillType& fillValue)
+    {
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType, FillType>(
+	  privateCode::reverseKernel(rowKernel),
+	  privateCode::reverseKernel(columnKernel), signal, strategy, roi,
+	  fillValue);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1)
+    {
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  privateCode::reverseKernel(rowKernel),
+	  privateCode::reverseKernel(columnKernel), signal, strategy,
+	  corner0, corner1);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    inline Array2D<OutputType>
+    convolve2DSeparable(const Array1D<KernelType>& rowKernel,
+			const Array1D<KernelType>& columnKernel,
+			const Array2D<SignalType>& signal,
+			ConvolutionStrategy strategy,
+			const Index2D& corner0,
+			const Index2D& corner1,
+			const FillType& fillValue)
+    {
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType, FillType>(
+	  privateCode::reverseKernel(rowKernel),
+	  privateCode::reverseKernel(columnKernel), signal, strategy,
+	  corner0, corner1, fillValue);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		ConvolutionMethod method)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(kernel, signal, roi, corner0, corner1);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	kernel, signal, strategy, corner0, corner1, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		ConvolutionROI roi,
+		const FillType& fillValue,
+		ConvolutionMethod method)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(kernel, signal, roi, corner0, corner1);
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	kernel, signal, strategy, corner0, corner1, fillValue, method);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		ConvolutionMethod method)
+    {
+      Array1D<KernelType> columnKernel;
+      Array1D<KernelType> rowKernel;
+      if(privateCode::selectSeparable(kernel, method, columnKernel, rowKernel)) {
+	return correlate2DSeparable<
+	  OutputType, AccumulatorType, KernelType, SignalType>(
+	    rowKernel, columnKernel, signal, strategy, corner0, corner1);
+      }
+      if(privateCode::selectFFT(kernel, corner0, corner1, method)) {
+	if(strategy == BRICK_CONVOLVE_PAD_RESULT
+	   || strategy == BRICK_CONVOLVE_PAD_SIGNAL) {
+	  BRICK_THROW(brick::common::ValueException, "correlate2D()",
+		      "The specified convolution strategy requires that a "
+		      "fill value be specified.");
+	}
+	return privateCode::correlate2DFFTCommon<
+	  OutputType, KernelType, SignalType>(
+	    kernel, signal, strategy, corner0, corner1,
+	    static_cast<OutputType>(0), static_cast<SignalType>(0));
+      }
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType>(
+	kernel, signal, strategy, corner0, corner1);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2D(const Array2D<KernelType>& kernel,
+		const Array2D<SignalType>& signal,
+		ConvolutionStrategy strategy,
+		const Index2D& corner0,
+		const Index2D& corner1,
+		const FillType& fillValue,
+		ConvolutionMethod method)
+    {
+      Array1D<KernelType> columnKernel;
+      Array1D<KernelType> rowKernel;
+      if(privateCode::selectSeparable(kernel, method, columnKernel, rowKernel)) {
+	return correlate2DSeparable<
+	  OutputType, AccumulatorType, KernelType, SignalType, FillType>(
+	    rowKernel, columnKernel, signal, strategy, corner0, corner1,
+	    fillValue);
+      }
+      if(privateCode::selectFFT(kernel, corner0, corner1, method)) {
+	return privateCode::correlate2DFFTCommon<
+	  OutputType, KernelType, SignalType>(
+	    kernel, signal, strategy, corner0, corner1,
+	    static_cast<OutputType>(fillValue),
+	    static_cast<SignalType>(fillValue));
+      }
+      return correlate2D<OutputType, AccumulatorType, KernelType, SignalType,
+			 FillType>(
+	kernel, signal, strategy, corner0, corner1, fillValue);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 ConvolutionROI roi)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(
+	columnKernel.size(), rowKernel.size(), signal.rows(), signal.columns(),
+	roi, corner0, corner1);
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  rowKernel, columnKernel, signal, strategy, corner0, corner1);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 ConvolutionROI roi,
+			 const FillType& fillValue)
+    {
+      Index2D corner0;
+      Index2D corner1;
+      privateCode::getCorrelate2DCorners(
+	columnKernel.size(), rowKernel.size(), signal.rows(), signal.columns(),
+	roi, corner0, corner1);
+      return correlate2DSeparable<
+	OutputType, AccumulatorType, KernelType, SignalType, FillType>(
+	  rowKernel, columnKernel, signal, strategy, corner0, corner1,
+	  fillValue);
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 const Index2D& corner0,
+			 const Index2D& corner1)
+    {
+      if(strategy == BRICK_CONVOLVE_PAD_RESULT
+	 || strategy == BRICK_CONVOLVE_PAD_SIGNAL) {
+        BRICK_THROW(brick::common::ValueException, "correlate2DSeparable()",
+                  "The specified convolution strategy requires that a "
+		  "fill value be specified.");
+      }
+      return privateCode::correlate2DSeparableCommon<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  rowKernel, columnKernel, signal, strategy, corner0, corner1,
+	  static_cast<OutputType>(0), static_cast<SignalType>(0));
+    }
+
+
+    template <class OutputType, class AccumulatorType,
+	      class KernelType, class SignalType, class FillType>
+    Array2D<OutputType>
+    correlate2DSeparable(const Array1D<KernelType>& rowKernel,
+			 const Array1D<KernelType>& columnKernel,
+			 const Array2D<SignalType>& signal,
+			 ConvolutionStrategy strategy,
+			 const Index2D& corner0,
+			 const Index2D& corner1,
+			 const FillType& fillValue)
+    {
+      return privateCode::correlate2DSeparableCommon<
+	OutputType, AccumulatorType, KernelType, SignalType>(
+	  rowKernel, columnKernel, signal, strategy, corner0, corner1,
+	  static_cast<OutputType>(fillValue), static_cast<SignalType>(fillValue));
+    }
+
+
+    template <class KernelType>
+    bool
+    separateKernel2D(const Array2D<KernelType>& kernel,
+		     Array1D<KernelType>& columnKernel,
+		     Array1D<KernelType>& rowKernel)
+    {
+      if(kernel.size() == 0) {
+	return false;
+      }
+
+      // Choose a pivot element.  For floating point types, the
+      // largest element gives the best conditioned division.  For
+      // integral types, we use the smallest nonzero element, since
+      // that's the only choice that can give integral factors.
+      const bool isIntegral = std::numeric_limits<KernelType>::is_integer;
+      const KernelType zero = static_cast<KernelType>(0);
+      size_t pivotRow = 0;
+      size_t pivotColumn = 0;
+      KernelType pivotMagnitude = zero;
+      KernelType maxMagnitude = zero;
+      for(size_t row = 0; row < kernel.rows(); ++row) {
+	for(size_t column = 0; column < kernel.columns(); ++column) {
+	  KernelType element = kernel(row, column);
+	  KernelType magnitude = (element < zero) ? -element : element;
+	  if(magnitude > maxMagnitude) {
+	    maxMagnitude = magnitude;
+	  }
+	  if(magnitude == zero) {
+	    continue;
+	  }
+	  if(pivotMagnitude == zero
+	     || (isIntegral && magnitude < pivotMagnitude)
+	     || (!isIntegral && magnitude > pivotMagnitude)) {
+	    pivotMagnitude = magnitude;
+	    pivotRow = row;
+	    pivotColumn = column;
+	  }
+	}
+      }
+      if(pivotMagnitude == zero) {
+	// All-zero kernels aren't worth special-casing.
+	return false;
+      }
+
+      // Tentative factors: the pivot row, and the pivot column
+      // scaled so that their outer product reproduces the pivot.
+      const KernelType pivot = kernel(pivotRow, pivotColumn);
+      Array1D<KernelType> candidateRow(kernel.columns());
+      std::copy(kernel.rowBegin(pivotRow), kernel.rowEnd(pivotRow),
+		candidateRow.begin());
+      Array1D<KernelType> candidateColumn(kernel.rows());
+      for(size_t row = 0; row < kernel.rows(); ++row) {
+	candidateColumn[row] = kernel(row, pivotColumn) / pivot;
+      }
+
+      // Check that the outer product reproduces the kernel.
+      const KernelType tolerance =
+	static_cast<KernelType>(16) * std::numeric_limits<KernelType>::epsilon()
+	* maxMagnitude;
+      for(size_t row = 0; row < kernel.rows(); ++row) {
+	for(size_t column = 0; column < kernel.columns(); ++column) {
+	  KernelType element = kernel(row, column);
+	  KernelType product = candidateColumn[row] * candidateRow[column];
+	  KernelType difference =
+	    (element > product) ? (element - product) : (product - element);
+	  if(difference > tolerance) {
+	    return false;
+	  }
+	}
+      }
+
+      columnKernel = candidateColumn;
+      rowKernel = candidateRow;
+      return true;
+    }
+
   } // namespace numeric
 
 } // namespace brick
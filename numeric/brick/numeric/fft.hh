@@ -18,28 +18,494 @@
 #ifndef BRICK_NUMERIC_FFT_HH
 #define BRICK_NUMERIC_FFT_HH
 
+#include <complex>
+#include <cstddef>
+#include <vector>
 #include <brick/numeric/array1D.hh>
+#include <brick/numeric/array2D.hh>
 
 namespace brick {
 
   namespace numeric {
 
+    namespace privateCode {
+
+      /**
+       ** This class template holds the precomputed tables for an
+       ** iterative, mixed-radix (2, 3, 4, and 5) decimation-in-time
+       ** FFT.  It is an implementation detail of FFTPlan, and only
+       ** handles lengths that have no prime factors other than 2, 3,
+       ** and 5.
+       **/
+      template <class ComplexType>
+      class MixedRadixFFT {
+      public:
+
+        MixedRadixFFT();
+
+        MixedRadixFFT(std::size_t size, bool isInverse);
+
+        static bool
+        isFactorable(std::size_t size);
+
+        std::size_t
+        getSize() const {return m_permutation.size();}
+
+        void
+        transform(ComplexType const* inputSignal,
+                  ComplexType* outputSignal) const;
+
+        void
+        transformInPlace(ComplexType* signal, ComplexType* workspace) const;
+
+      private:
+
+        struct Stage {
+          std::size_t radix;
+          std::size_t span;
+          std::size_t twiddleOffset;
+        };
+
+        void
+        computeButterflies(ComplexType* signal) const;
+
+        bool m_isInverse;
+        bool m_isSelfInversePermutation;
+        std::vector<std::size_t> m_permutation;
+        std::vector<Stage> m_stages;
+        std::vector<ComplexType> m_twiddles;
+      };
+
+    } // namespace privateCode
+
+
+    /**
+     ** Warning: this interface is not yet stable.
+     **
+     ** This class template precomputes everything needed to compute
+     ** discrete Fourier transforms of one particular length, so that
+     ** repeated transforms of same-length signals do no setup work
+     ** and no memory allocation.  Lengths whose prime factors are all
+     ** 2, 3, or 5 are computed using an iterative mixed-radix
+     ** Cooley-Tukey algorithm.  All other lengths are computed using
+     ** Bluestein's algorithm, which re-expresses the transform as a
+     ** convolution that can be evaluated with a longer mixed-radix
+     ** transform.  Either way, the cost is O(N*log(N)).
+     **
+     ** Template argument ComplexType is normally std::complex<float>
+     ** or std::complex<double>.  Tables are computed in double
+     ** precision regardless.
+     **
+     ** An FFTPlan instance keeps scratch space internally, so a single
+     ** instance must not be used by more than one thread at a time.
+     ** Copies are independent, so give each thread its own copy.
+     **
+     ** Example:
+     **
+     ** @code
+     **   FFTPlan< std::complex<double> > plan(signal.size());
+     **   for(...) {
+     **     plan.execute(signal);    // Transforms signal in place.
+     **   }
+     ** @endcode
+     **/
+    template <class ComplexType>
+    class FFTPlan {
+    public:
+
+      /**
+       * The default constructor creates a plan for zero-length
+       * signals.
+       */
+      FFTPlan();
+
+
+      /**
+       * This constructor computes the tables needed to transform
+       * signals of the specified length.
+       *
+       * @param size This argument specifies the number of elements
+       * in the signals to be transformed.
+       *
+       * @param isInverse If this argument is true, the plan computes
+       * the inverse transform, which differs from the forward
+       * transform only in the sign of the complex exponent.  Note
+       * that the inverse transform is not normalized, so
+       * transforming and then inverse transforming a signal
+       * multiplies it by size.
+       */
+      explicit
+      FFTPlan(std::size_t size, bool isInverse = false);
+
+
+      /**
+       * This member function returns the signal length for which the
+       * plan was constructed.
+       *
+       * @return The return value is the number of elements in each
+       * transformed signal.
+       */
+      std::size_t
+      getSize() const {return m_size;}
+
+
+      /**
+       * This member function indicates the direction of the
+       * transform.
+       *
+       * @return The return value is true if the plan computes the
+       * inverse transform, false otherwise.
+       */
+      bool
+      isInverse() const {return m_isInverse;}
+
+
+      /**
+       * This member function transforms a signal in place.
+       *
+       * @param signal This argument is the signal to be transformed.
+       * It must have exactly getSize() elements.
+       */
+      void
+      execute(Array1D<ComplexType>& signal);
+
+
+      /**
+       * This member function transforms a signal into a
+       * caller-supplied buffer.
+       *
+       * @param inputSignal This argument is the signal to be
+       * transformed.  It must have exactly getSize() elements.
+       *
+       * @param outputSignal This argument will be filled with the
+       * transform of inputSignal.  If it does not already have
+       * getSize() elements, it will be reinitialized.  It may share
+       * data with inputSignal.
+       */
+      void
+      execute(Array1D<ComplexType> const& inputSignal,
+              Array1D<ComplexType>& outputSignal);
+
+
+      /**
+       * This member function transforms a contiguous block of
+       * getSize() elements in place.
+       *
+       * @param signal This argument points to the first element of
+       * the signal to be transformed.
+       */
+      void
+      execute(ComplexType* signal);
+
+
+      /**
+       * This member function transforms a contiguous block of
+       * getSize() elements into a second contiguous block.
+       *
+       * @param inputSignal This argument points to the first element
+       * of the signal to be transformed.
+       *
+       * @param outputSignal This argument points to the first element
+       * of the buffer into which the result will be written.  It may
+       * be equal to inputSignal, but the two blocks must not
+       * otherwise overlap.
+       */
+      void
+      execute(ComplexType const* inputSignal, ComplexType* outputSignal);
+
+    private:
+
+      void
+      executeBluestein(ComplexType const* inputSignal,
+                       ComplexType* outputSignal);
+
+      std::size_t m_size;
+      bool m_isInverse;
+      bool m_isBluestein;
+      privateCode::MixedRadixFFT<ComplexType> m_transform;
+
+      // These are used only by Bluestein's algorithm.
+      std::vector<ComplexType> m_chirp;
+      std::vector<ComplexType> m_chirpSpectrum;
+
+      std::vector<ComplexType> m_workspace;
+    };
+
+
+    /**
+     ** Warning: this interface is not yet stable.
+     **
+     ** This class template computes discrete Fourier transforms of
+     ** real-valued signals, and the corresponding inverse transforms.
+     ** The spectrum of a real signal of length N is conjugate
+     ** symmetric, so only its first (N / 2 + 1) elements are stored.
+     ** For even N, the transform packs the even and odd samples into
+     ** the real and imaginary parts of a complex signal of length N /
+     ** 2, transforms that with an FFTPlan, and then untangles the two
+     ** half-size spectra, which costs roughly half as much as a
+     ** complex transform of length N.  Odd lengths fall back to a
+     ** complex transform of length N.
+     **
+     ** Template argument FloatType is normally float or double.
+     **
+     ** As with FFTPlan, an instance must not be used by more than one
+     ** thread at a time, but copies are independent.
+     **/
+    template <class FloatType>
+    class RealFFTPlan {
+    public:
+
+      /** Convenience typedef for the spectrum element type. */
+      typedef std::complex<FloatType> ComplexType;
+
+
+      /**
+       * The default constructor creates a plan for zero-length
+       * signals.
+       */
+      RealFFTPlan();
+
+
+      /**
+       * This constructor computes the tables needed to transform
+       * real signals of the specified length, in both directions.
+       *
+       * @param size This argument specifies the number of elements
+       * in each real-valued signal.
+       */
+      explicit
+      RealFFTPlan(std::size_t size);
+
+
+      /**
+       * This member function returns the signal length for which the
+       * plan was constructed.
+       *
+       * @return The return value is the number of real elements in
+       * each signal.
+       */
+      std::size_t
+      getSize() const {return m_size;}
+
+
+      /**
+       * This member function returns the number of spectrum elements
+       * produced by the forward transform, and consumed by the
+       * inverse transform.
+       *
+       * @return The return value is (getSize() / 2 + 1), or zero if
+       * getSize() is zero.
+       */
+      std::size_t
+      getSpectrumSize() const {return (m_size == 0) ? 0 : (m_size / 2 + 1);}
+
+
+      /**
+       * This member function computes the forward transform of a real
+       * signal.
+       *
+       * @param inputSignal This argument is the signal to be
+       * transformed.  It must have exactly getSize() elements.
+       *
+       * @param spectrum This argument will be filled with the first
+       * getSpectrumSize() elements of the DFT of inputSignal.  The
+       * remaining elements can be recovered using the identity
+       * X[N - k] = conj(X[k]).  If spectrum does not already have
+       * getSpectrumSize() elements, it will be reinitialized.
+       */
+      void
+      execute(Array1D<FloatType> const& inputSignal,
+              Array1D<ComplexType>& spectrum);
+
+
+      /**
+       * This member function computes the inverse transform of a
+       * conjugate-symmetric spectrum, producing a real signal.  As
+       * with FFTPlan, the inverse is not normalized, so a forward
+       * transform followed by an inverse transform multiplies the
+       * signal by getSize().
+       *
+       * @param spectrum This argument is the first getSpectrumSize()
+       * elements of the spectrum to be inverted.  The imaginary parts
+       * of the DC element (and the Nyquist element, for even
+       * lengths) are ignored.
+       *
+       * @param outputSignal This argument will be filled with the
+       * inverse transform.  If it does not already have getSize()
+       * elements, it will be reinitialized.
+       */
+      void
+      execute(Array1D<ComplexType> const& spectrum,
+              Array1D<FloatType>& outputSignal);
+
+
+      /**
+       * This member function works just like execute(Array1D const&,
+       * Array1D&), but operates on contiguous buffers.
+       *
+       * @param inputSignal This argument points to getSize() real
+       * input elements.
+       *
+       * @param spectrum This argument points to space for
+       * getSpectrumSize() output elements.
+       */
+      void
+      execute(FloatType const* inputSignal, ComplexType* spectrum);
+
+
+      /**
+       * This member function works just like execute(Array1D const&,
+       * Array1D&) for inverse transforms, but operates on contiguous
+       * buffers.
+       *
+       * @param spectrum This argument points to getSpectrumSize()
+       * input elements.
+       *
+       * @param outputSignal This argument points to space for
+       * getSize() real output elements.
+       */
+      void
+      execute(ComplexType const* spectrum, FloatType* outputSignal);
+
+    private:
+
+      std::size_t m_size;
+      FFTPlan<ComplexType> m_forwardPlan;
+      FFTPlan<ComplexType> m_inversePlan;
+
+      // For even sizes, m_twiddles[k] is exp(-2 * pi * i * k / N),
+      // for 0 <= k < N / 2.
+      std::vector<ComplexType> m_twiddles;
+      std::vector<ComplexType> m_workspace;
+    };
+
+
+    /**
+     ** Warning: this interface is not yet stable.
+     **
+     ** This class template computes 2D discrete Fourier transforms of
+     ** Array2D instances of one particular shape.  Each row is
+     ** transformed in place, and then the columns are transformed in
+     ** narrow bands, each of which is transposed into a scratch
+     ** buffer in cache-sized blocks, transformed as (now contiguous)
+     ** rows, and transposed back.  Element (u, v) of the result is the Fourier coefficient
+     ** for vertical frequency 2*pi*u/rows and horizontal frequency
+     ** 2*pi*v/columns.
+     **
+     ** As with FFTPlan, an instance must not be used by more than one
+     ** thread at a time, but copies are independent.
+     **/
+    template <class ComplexType>
+    class FFTPlan2D {
+    public:
+
+      /**
+       * The default constructor creates a plan for empty arrays.
+       */
+      FFTPlan2D();
+
+
+      /**
+       * This constructor computes the tables needed to transform
+       * arrays of the specified shape.
+       *
+       * @param rows This argument specifies the number of rows in
+       * the arrays to be transformed.
+       *
+       * @param columns This argument specifies the number of columns
+       * in the arrays to be transformed.
+       *
+       * @param isInverse If this argument is true, the plan computes
+       * the (unnormalized) inverse transform.  Transforming and then
+       * inverse transforming multiplies the array by (rows * columns).
+       */
+      FFTPlan2D(std::size_t rows, std::size_t columns, bool isInverse = false);
+
+
+      /**
+       * This member function returns the number of rows in the
+       * arrays the plan transforms.
+       *
+       * @return The return value is the row count.
+       */
+      std::size_t
+      getRows() const {return m_columnPlan.getSize();}
+
+
+      /**
+       * This member function returns the number of columns in the
+       * arrays the plan transforms.
+       *
+       * @return The return value is the column count.
+       */
+      std::size_t
+      getColumns() const {return m_rowPlan.getSize();}
+
+
+      /**
+       * This member function indicates the direction of the
+       * transform.
+       *
+       * @return The return value is true if the plan computes the
+       * inverse transform, false otherwise.
+       */
+      bool
+      isInverse() const {return m_rowPlan.isInverse();}
+
+
+      /**
+       * This member function transforms a 2D signal in place.
+       *
+       * @param signal This argument is the array to be transformed.
+       * It must have getRows() rows and getColumns() columns.
+       */
+      void
+      execute(Array2D<ComplexType>& signal);
+
+
+      /**
+       * This member function transforms a 2D signal into a
+       * caller-supplied buffer.
+       *
+       * @param inputSignal This argument is the array to be
+       * transformed.  It must have getRows() rows and getColumns()
+       * columns.
+       *
+       * @param outputSignal This argument will be filled with the
+       * transform of inputSignal.  If it does not already have the
+       * right shape, it will be reinitialized.  It may share data
+       * with inputSignal.
+       */
+      void
+      execute(Array2D<ComplexType> const& inputSignal,
+              Array2D<ComplexType>& outputSignal);
+
+    private:
+
+      // m_rowPlan transforms individual rows, so its length is
+      // getColumns(), and m_columnPlan transforms individual
+      // columns.
+      FFTPlan<ComplexType> m_rowPlan;
+      FFTPlan<ComplexType> m_columnPlan;
+      std::vector<ComplexType> m_transposeBuffer;
+    };
+
+
     /**
      * Warning: this interface is not yet stable.
      *
-     * This function currently implements an un-optimized version of
-     * the Cooley-Tukey radix-2 recursive decimation-in-time FFT
-     * algorithm.  Over time it may grow to dispatch to other FFT
-     * algorithms as well, based on the input signal or a
-     * configuration argument.
+     * This function computes the discrete Fourier transform of a
+     * signal of any length.  It simply constructs an FFTPlan and
+     * executes it once, so code that transforms many signals of the
+     * same length should construct and reuse an FFTPlan directly.
      *
      * The goal here isn't to make an FFT implementation that competes
      * with with the more optimized versions available, just to have a
      * quick and easy FFT for use when other libraries aren't handy.
      *
      * @param inputSignal This argument is the complex-valued signal
-     * from which to compute the Fourier transform.  For now, the
-     * number of elements in this sequence must be a power of two.
+     * from which to compute the Fourier transform.  Lengths with no
+     * prime factors other than 2, 3, and 5 are fastest.
      *
      * @return The return value is the Discrete Fourier transform of
      * argument inputSignal.  Assuming there are N elements in
@@ -54,6 +520,60 @@ namespace brick {
     Array1D<ComplexType>
     computeFFT(Array1D<ComplexType> const& inputSignal);
 
+
+    /**
+     * Warning: this interface is not yet stable.
+     *
+     * This function computes the 2D discrete Fourier transform of an
+     * array of any shape.  It simply constructs an FFTPlan2D and
+     * executes it once.
+     *
+     * @param inputSignal This argument is the complex-valued array to
+     * be transformed.
+     *
+     * @return The return value is the transform, with the same shape
+     * as inputSignal.
+     */
+    template <class ComplexType>
+    Array2D<ComplexType>
+    computeFFT2D(Array2D<ComplexType> const& inputSignal);
+
+
+    /**
+     * Warning: this interface is not yet stable.
+     *
+     * This function computes the discrete Fourier transform of a
+     * real-valued signal of any length.  It simply constructs a
+     * RealFFTPlan and executes it once.
+     *
+     * @param inputSignal This argument is the signal to be
+     * transformed.
+     *
+     * @return The return value holds the first (N / 2 + 1) elements
+     * of the transform, where N is the length of inputSignal.  The
+     * remaining elements are the complex conjugates of these, in
+     * reverse order.
+     */
+    template <class FloatType>
+    Array1D< std::complex<FloatType> >
+    computeRealFFT(Array1D<FloatType> const& inputSignal);
+
+
+    /**
+     * This function returns the smallest signal length, not less
+     * than its argument, that FFTPlan can transform without
+     * resorting to Bluestein's algorithm.  That is, the smallest
+     * length of the form (2^a * 3^b * 5^c).  Padding signals to this
+     * length is a good way to speed up FFT-based convolution.
+     *
+     * @param minimumSize This argument specifies the smallest
+     * acceptable length.
+     *
+     * @return The return value is the recommended transform length.
+     */
+    inline std::size_t
+    getEfficientFFTSize(std::size_t minimumSize);
+
   } // namespace numeric
 
 } // namespace brick
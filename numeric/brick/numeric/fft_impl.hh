@@ -19,6 +19,8 @@
 //
 // #include <brick/numeric/fft.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <brick/common/constants.hh>
 #include <brick/common/exception.hh>
 #include <brick/common/mathFunctions.hh>
@@ -29,122 +31,848 @@ namespace brick {
 
     namespace privateCode {
 
+      // Returns exp(i * angle), computed in double precision.
       template <class ComplexType>
-      Array1D<ComplexType>
-      computeRadix2Twiddles(std::size_t const count)
+      inline ComplexType
+      getUnitPhasor(double angle)
       {
         typedef typename ComplexType::value_type FloatType;
-        Array1D<ComplexType> twiddleFactors(count);
-        for(std::size_t ii = 0; ii < count; ++ii) {
-          FloatType exponent(ii * (-brick::common::constants::twoPi / count));
-          twiddleFactors[ii] = ComplexType(
-            brick::common::cosine(exponent),
-            brick::common::sine(exponent));
+        return ComplexType(static_cast<FloatType>(brick::common::cosine(angle)),
+                           static_cast<FloatType>(brick::common::sine(angle)));
+      }
+
+
+      // Complex multiplication without the NaN/Inf recovery that
+      // std::complex does by default, which is many times slower and
+      // irrelevant to us.
+      template <class ComplexType>
+      inline ComplexType
+      multiplyComplex(ComplexType const& arg0, ComplexType const& arg1)
+      {
+        return ComplexType(
+          arg0.real() * arg1.real() - arg0.imag() * arg1.imag(),
+          arg0.real() * arg1.imag() + arg0.imag() * arg1.real());
+      }
+
+
+      // Returns arg0 * i if sign is positive, or arg0 * -i otherwise.
+      template <class ComplexType>
+      inline ComplexType
+      multiplyByI(ComplexType const& arg0, bool isPositive)
+      {
+        return (isPositive
+                ? ComplexType(-arg0.imag(), arg0.real())
+                : ComplexType(arg0.imag(), -arg0.real()));
+      }
+
+
+      template <class ComplexType>
+      MixedRadixFFT<ComplexType>::
+      MixedRadixFFT()
+        : m_isInverse(false),
+          m_isSelfInversePermutation(true),
+          m_permutation(),
+          m_stages(),
+          m_twiddles()
+      {
+        // Empty.
+      }
+
+
+      template <class ComplexType>
+      MixedRadixFFT<ComplexType>::
+      MixedRadixFFT(std::size_t size, bool isInverse)
+        : m_isInverse(isInverse),
+          m_isSelfInversePermutation(true),
+          m_permutation(size),
+          m_stages(),
+          m_twiddles()
+      {
+        if(!isFactorable(size)) {
+          BRICK_THROW(brick::common::ValueException,
+                      "MixedRadixFFT::MixedRadixFFT()",
+                      "Argument size must have no prime factors other "
+                      "than 2, 3, and 5.");
+        }
+        double const sign = isInverse ? 1.0 : -1.0;
+        double const twoPi = brick::common::constants::twoPi;
+
+        // Factor size, preferring radix 4 since its butterfly needs
+        // no multiplications.
+        std::vector<std::size_t> factors;
+        std::size_t remainder = (size == 0) ? 1 : size;
+        while(remainder % 4 == 0) {factors.push_back(4); remainder /= 4;}
+        while(remainder % 2 == 0) {factors.push_back(2); remainder /= 2;}
+        while(remainder % 3 == 0) {factors.push_back(3); remainder /= 3;}
+        while(remainder % 5 == 0) {factors.push_back(5); remainder /= 5;}
+
+        // The first factor is the radix of the final (outermost)
+        // butterfly stage.  Working inward, each factor splits the
+        // input into interleaved subsequences.  The permutation
+        // table records where each input element lands when all
+        // of the subsequences have been laid out contiguously,
+        // which is the generalization of bit reversal to mixed
+        // radices.
+        if(size != 0) {
+          m_permutation[0] = 0;
+          std::size_t blockSize = 1;
+          std::size_t stride = size;
+          for(std::size_t ff = factors.size(); ff > 0; --ff) {
+            std::size_t radix = factors[ff - 1];
+            stride /= radix;
+            for(std::size_t jj = 1; jj < radix; ++jj) {
+              for(std::size_t kk = 0; kk < blockSize; ++kk) {
+                m_permutation[jj * blockSize + kk] =
+                  m_permutation[kk] + jj * stride;
+              }
+            }
+            blockSize *= radix;
+          }
+        }
+        for(std::size_t ii = 0; ii < size; ++ii) {
+          if(m_permutation[m_permutation[ii]] != ii) {
+            m_isSelfInversePermutation = false;
+            break;
+          }
+        }
+
+        // Butterfly stages run from the innermost factor outward.
+        // Each stage combines radix blocks of span elements, and
+        // needs (radix - 1) twiddle factors per element of a block.
+        std::size_t span = 1;
+        for(std::size_t ff = factors.size(); ff > 0; --ff) {
+          Stage stage;
+          stage.radix = factors[ff - 1];
+          stage.span = span;
+          stage.twiddleOffset = m_twiddles.size();
+          std::size_t const combinedSpan = span * stage.radix;
+          for(std::size_t kk = 0; kk < span; ++kk) {
+            for(std::size_t jj = 1; jj < stage.radix; ++jj) {
+              m_twiddles.push_back(getUnitPhasor<ComplexType>(
+                sign * twoPi * static_cast<double>(jj * kk)
+                / static_cast<double>(combinedSpan)));
+            }
+          }
+          m_stages.push_back(stage);
+          span = combinedSpan;
         }
-        return twiddleFactors;
       }
 
 
+      template <class ComplexType>
       bool
-      isPowerOfTwo(std::size_t signalLength)
+      MixedRadixFFT<ComplexType>::
+      isFactorable(std::size_t size)
       {
-        double exponent = std::log(double(signalLength)) / std::log(2.0);
-        int integerExponent = static_cast<int>(exponent + 0.5);
-        std::size_t checkValue = std::size_t(1) << integerExponent;
-        return checkValue == signalLength;
+        if(size == 0) {
+          return true;
+        }
+        while(size % 2 == 0) {size /= 2;}
+        while(size % 3 == 0) {size /= 3;}
+        while(size % 5 == 0) {size /= 5;}
+        return size == 1;
       }
 
 
       template <class ComplexType>
       void
-      recursiveRadix2FFT(Array1D<ComplexType>& result,
-                         std::size_t const outputIndex,
-                         Array1D<ComplexType> const& inputSignal,
-                         std::size_t const inputIndex,
-                         std::size_t const count,
-                         std::size_t const stride,
-                         Array1D<ComplexType> const& twiddleFactors)
+      MixedRadixFFT<ComplexType>::
+      transform(ComplexType const* inputSignal,
+                ComplexType* outputSignal) const
       {
-        // Handle the trivial case.
-        if(count == 1) {
-          result[outputIndex] = inputSignal[inputIndex];
+        std::size_t const size = m_permutation.size();
+        for(std::size_t ii = 0; ii < size; ++ii) {
+          outputSignal[ii] = inputSignal[m_permutation[ii]];
+        }
+        this->computeButterflies(outputSignal);
+      }
+
+
+      template <class ComplexType>
+      void
+      MixedRadixFFT<ComplexType>::
+      transformInPlace(ComplexType* signal, ComplexType* workspace) const
+      {
+        std::size_t const size = m_permutation.size();
+        if(m_isSelfInversePermutation) {
+          // The permutation is a set of disjoint swaps (as it is
+          // whenever the sequence of radices is a palindrome, for
+          // example when size is a power of four), so no scratch
+          // space is needed.
+          for(std::size_t ii = 0; ii < size; ++ii) {
+            if(m_permutation[ii] > ii) {
+              std::swap(signal[ii], signal[m_permutation[ii]]);
+            }
+          }
+          this->computeButterflies(signal);
           return;
         }
+        std::copy(signal, signal + size, workspace);
+        this->transform(workspace, signal);
+      }
 
-        // Divide and conquer.
-        std::size_t countOver2 = count / 2;
-        std::size_t strideTimes2 = stride * 2;
 
-        // Compute the FFT of the even elements.
-        recursiveRadix2FFT(result, outputIndex,
-                           inputSignal, inputIndex,
-                           countOver2, strideTimes2, twiddleFactors);
+      template <class ComplexType>
+      void
+      MixedRadixFFT<ComplexType>::
+      computeButterflies(ComplexType* signal) const
+      {
+        typedef typename ComplexType::value_type FloatType;
+        std::size_t const size = m_permutation.size();
+        bool const isPositive = m_isInverse;
+
+        // sin(2*pi/3), with the sign of the transform exponent.
+        double const signedUnit = isPositive ? 1.0 : -1.0;
+        FloatType const sine3 = static_cast<FloatType>(
+          signedUnit * 0.86602540378443864676);
+        FloatType const half = static_cast<FloatType>(0.5);
+
+        // cos(2*pi/5), cos(4*pi/5), and the corresponding sines, again
+        // with the sign of the transform exponent.
+        FloatType const cosine5a = static_cast<FloatType>(
+          brick::common::cosine(brick::common::constants::twoPi / 5.0));
+        FloatType const cosine5b = static_cast<FloatType>(
+          brick::common::cosine(2.0 * brick::common::constants::twoPi / 5.0));
+        FloatType const sine5a = static_cast<FloatType>(
+          signedUnit
+          * brick::common::sine(brick::common::constants::twoPi / 5.0));
+        FloatType const sine5b = static_cast<FloatType>(
+          signedUnit
+          * brick::common::sine(2.0 * brick::common::constants::twoPi / 5.0));
+
+        for(std::size_t ss = 0; ss < m_stages.size(); ++ss) {
+          Stage const& stage = m_stages[ss];
+          std::size_t const span = stage.span;
+          std::size_t const combinedSpan = span * stage.radix;
+          ComplexType const* const twiddles = &(m_twiddles[stage.twiddleOffset]);
+
+          for(std::size_t base = 0; base < size; base += combinedSpan) {
+            ComplexType* const block = signal + base;
+            switch(stage.radix) {
+            case 2:
+              for(std::size_t kk = 0; kk < span; ++kk) {
+                ComplexType const b0 = block[kk];
+                ComplexType const b1 =
+                  multiplyComplex(block[kk + span], twiddles[kk]);
+                block[kk] = b0 + b1;
+                block[kk + span] = b0 - b1;
+              }
+              break;
+            case 3:
+              for(std::size_t kk = 0; kk < span; ++kk) {
+                ComplexType const* const tw = twiddles + 2 * kk;
+                ComplexType const b0 = block[kk];
+                ComplexType const b1 =
+                  multiplyComplex(block[kk + span], tw[0]);
+                ComplexType const b2 =
+                  multiplyComplex(block[kk + 2 * span], tw[1]);
+                ComplexType const sum = b1 + b2;
+                ComplexType const difference = b1 - b2;
+                ComplexType const t0 = b0 - half * sum;
+                ComplexType const t1(-sine3 * difference.imag(),
+                                     sine3 * difference.real());
+                block[kk] = b0 + sum;
+                block[kk + span] = t0 + t1;
+                block[kk + 2 * span] = t0 - t1;
+              }
+              break;
+            case 4:
+              for(std::size_t kk = 0; kk < span; ++kk) {
+                ComplexType const* const tw = twiddles + 3 * kk;
+                ComplexType const b0 = block[kk];
+                ComplexType const b1 =
+                  multiplyComplex(block[kk + span], tw[0]);
+                ComplexType const b2 =
+                  multiplyComplex(block[kk + 2 * span], tw[1]);
+                ComplexType const b3 =
+                  multiplyComplex(block[kk + 3 * span], tw[2]);
+                ComplexType const t0 = b0 + b2;
+                ComplexType const t1 = b0 - b2;
+                ComplexType const t2 = b1 + b3;
+                ComplexType const t3 = multiplyByI(b1 - b3, isPositive);
+                block[kk] = t0 + t2;
+                block[kk + span] = t1 + t3;
+                block[kk + 2 * span] = t0 - t2;
+                block[kk + 3 * span] = t1 - t3;
+              }
+              break;
+            default:
+              // Radix 5.  Pairing terms with conjugate roots of unity
+              // leaves only real multiplications.
+              for(std::size_t kk = 0; kk < span; ++kk) {
+                ComplexType const* const tw = twiddles + 4 * kk;
+                ComplexType const b0 = block[kk];
+                ComplexType const b1 =
+                  multiplyComplex(block[kk + span], tw[0]);
+                ComplexType const b2 =
+                  multiplyComplex(block[kk + 2 * span], tw[1]);
+                ComplexType const b3 =
+                  multiplyComplex(block[kk + 3 * span], tw[2]);
+                ComplexType const b4 =
+                  multiplyComplex(block[kk + 4 * span], tw[3]);
+                ComplexType const t1 = b1 + b4;
+                ComplexType const t2 = b2 + b3;
+                ComplexType const t3 = b1 - b4;
+                ComplexType const t4 = b2 - b3;
+                ComplexType const a1 = b0 + cosine5a * t1 + cosine5b * t2;
+                ComplexType const a2 = b0 + cosine5b * t1 + cosine5a * t2;
+                ComplexType const d1 = sine5a * t3 + sine5b * t4;
+                ComplexType const d2 = sine5b * t3 - sine5a * t4;
+                ComplexType const e1(-d1.imag(), d1.real());
+                ComplexType const e2(-d2.imag(), d2.real());
+                block[kk] = b0 + t1 + t2;
+                block[kk + span] = a1 + e1;
+                block[kk + 2 * span] = a2 + e2;
+                block[kk + 3 * span] = a2 - e2;
+                block[kk + 4 * span] = a1 - e1;
+              }
+              break;
+            }
+          }
+        }
+      }
+
 
-        // Compute the FFT of the odd elements.
-        recursiveRadix2FFT(result, outputIndex + countOver2,
-                           inputSignal, inputIndex + stride,
-                           countOver2, strideTimes2, twiddleFactors);
 
-        // Apply a frequency-dependent phase shift ("twiddle factor")
-        // to the odd FFT, and combine with the Even FFT to get the
-        // whole.
-        for(std::size_t ii = 0; ii < countOver2; ++ii) {
-          std::size_t evenIndex = outputIndex + ii;
-          std::size_t oddIndex = evenIndex + countOver2;
+      // Number of columns that FFTPlan2D transposes and transforms
+      // together.
+      std::size_t const fftTransposeBandWidth = 16;
 
-          ComplexType& evenPart = result[evenIndex];
-          ComplexType& oddPart = result[oddIndex];
 
-          ComplexType temp0 = evenPart;
-          ComplexType temp1 = twiddleFactors[ii * stride] * oddPart;
-          evenPart = temp0 + temp1;
-          oddPart = temp0 - temp1;
+      // Copies the transpose of the rows x columns array at input
+      // into output, working in square tiles so that both the reads
+      // and the writes stay within a few cache lines at a time.
+      template <class Type>
+      void
+      transposeBlocked(Type const* input,
+                       std::size_t rows,
+                       std::size_t columns,
+                       std::size_t inputRowStep,
+                       Type* output,
+                       std::size_t outputRowStep)
+      {
+        std::size_t const blockSize = 16;
+        for(std::size_t row0 = 0; row0 < rows; row0 += blockSize) {
+          std::size_t const row1 = std::min(row0 + blockSize, rows);
+          for(std::size_t column0 = 0; column0 < columns;
+              column0 += blockSize) {
+            std::size_t const column1 = std::min(column0 + blockSize, columns);
+            for(std::size_t row = row0; row < row1; ++row) {
+              Type const* inPtr = input + row * inputRowStep + column0;
+              Type* outPtr = output + column0 * outputRowStep + row;
+              for(std::size_t column = column0; column < column1; ++column) {
+                *outPtr = *inPtr;
+                ++inPtr;
+                outPtr += outputRowStep;
+              }
+            }
+          }
         }
       }
 
     } // namespace privateCode
 
 
+    template <class ComplexType>
+    FFTPlan<ComplexType>::
+    FFTPlan()
+      : m_size(0),
+        m_isInverse(false),
+        m_isBluestein(false),
+        m_transform(),
+        m_chirp(),
+        m_chirpSpectrum(),
+        m_workspace()
+    {
+      // Empty.
+    }
+
+
+    template <class ComplexType>
+    FFTPlan<ComplexType>::
+    FFTPlan(std::size_t size, bool isInverse)
+      : m_size(size),
+        m_isInverse(isInverse),
+        m_isBluestein(
+          !privateCode::MixedRadixFFT<ComplexType>::isFactorable(size)),
+        m_transform(),
+        m_chirp(),
+        m_chirpSpectrum(),
+        m_workspace()
+    {
+      if(!m_isBluestein) {
+        m_transform = privateCode::MixedRadixFFT<ComplexType>(size, isInverse);
+        m_workspace.resize(size);
+        return;
+      }
+
+      // Bluestein's algorithm rewrites n*k as (n^2 + k^2 - (k-n)^2)/2,
+      // which turns the length-N DFT into a chirp modulation, a
+      // convolution with a chirp, and a second chirp modulation.
+      // The convolution is computed circularly using a forward
+      // mixed-radix transform of length M >= 2N - 1.
+      std::size_t const transformSize = getEfficientFFTSize(2 * size - 1);
+      m_transform = privateCode::MixedRadixFFT<ComplexType>(
+        transformSize, false);
+
+      // Chirp factors are exp(+/- i * pi * n^2 / N).  Reducing n^2
+      // modulo 2N before converting to floating point keeps the
+      // phase accurate for large n.
+      double const sign = isInverse ? 1.0 : -1.0;
+      unsigned long long const period = 2ULL * size;
+      m_chirp.resize(size);
+      for(std::size_t nn = 0; nn < size; ++nn) {
+        unsigned long long const phaseIndex =
+          (static_cast<unsigned long long>(nn) * nn) % period;
+        m_chirp[nn] = privateCode::getUnitPhasor<ComplexType>(
+          sign * brick::common::constants::pi
+          * static_cast<double>(phaseIndex) / static_cast<double>(size));
+      }
+
+      // The convolution kernel is conj(chirp), wrapped around so
+      // that negative offsets land at the end of the buffer.  We
+      // fold the 1/M normalization of the inverse transform into its
+      // spectrum.
+      typedef typename ComplexType::value_type FloatType;
+      FloatType const scale =
+        static_cast<FloatType>(1.0 / static_cast<double>(transformSize));
+      std::vector<ComplexType> kernel(transformSize, ComplexType(0, 0));
+      kernel[0] = std::conj(m_chirp[0]);
+      for(std::size_t nn = 1; nn < size; ++nn) {
+        kernel[nn] = std::conj(m_chirp[nn]);
+        kernel[transformSize - nn] = kernel[nn];
+      }
+      m_chirpSpectrum.resize(transformSize);
+      m_transform.transform(&(kernel[0]), &(m_chirpSpectrum[0]));
+      for(std::size_t ii = 0; ii < transformSize; ++ii) {
+        m_chirpSpectrum[ii] *= scale;
+      }
+
+      m_workspace.resize(2 * transformSize);
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan<ComplexType>::
+    execute(Array1D<ComplexType>& signal)
+    {
+      if(signal.size() != m_size) {
+        BRICK_THROW(brick::common::ValueException, "FFTPlan::execute()",
+                    "Argument signal has the wrong number of elements.");
+      }
+      if(m_size != 0) {
+        this->execute(signal.data());
+      }
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan<ComplexType>::
+    execute(Array1D<ComplexType> const& inputSignal,
+            Array1D<ComplexType>& outputSignal)
+    {
+      if(inputSignal.size() != m_size) {
+        BRICK_THROW(brick::common::ValueException, "FFTPlan::execute()",
+                    "Argument inputSignal has the wrong number of elements.");
+      }
+      if(outputSignal.size() != m_size) {
+        outputSignal.reinit(m_size);
+      }
+      if(m_size != 0) {
+        this->execute(inputSignal.data(), outputSignal.data());
+      }
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan<ComplexType>::
+    execute(ComplexType* signal)
+    {
+      if(m_isBluestein) {
+        this->executeBluestein(signal, signal);
+      } else {
+        m_transform.transformInPlace(signal, &(m_workspace[0]));
+      }
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan<ComplexType>::
+    execute(ComplexType const* inputSignal, ComplexType* outputSignal)
+    {
+      if(inputSignal == outputSignal) {
+        this->execute(outputSignal);
+      } else if(m_isBluestein) {
+        this->executeBluestein(inputSignal, outputSignal);
+      } else {
+        m_transform.transform(inputSignal, outputSignal);
+      }
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan<ComplexType>::
+    executeBluestein(ComplexType const* inputSignal,
+                     ComplexType* outputSignal)
+    {
+      std::size_t const transformSize = m_chirpSpectrum.size();
+      ComplexType* const buffer = &(m_workspace[0]);
+      ComplexType* const scratch = buffer + transformSize;
+
+      // Modulate and zero-pad.
+      for(std::size_t nn = 0; nn < m_size; ++nn) {
+        buffer[nn] = privateCode::multiplyComplex(inputSignal[nn], m_chirp[nn]);
+      }
+      std::fill(buffer + m_size, buffer + transformSize, ComplexType(0, 0));
+
+      // Convolve with the chirp.  The inverse transform is computed
+      // as conj(DFT(conj(x))), and the conjugations are folded into
+      // the pointwise multiplication and the final modulation.
+      m_transform.transformInPlace(buffer, scratch);
+      for(std::size_t ii = 0; ii < transformSize; ++ii) {
+        buffer[ii] = std::conj(
+          privateCode::multiplyComplex(buffer[ii], m_chirpSpectrum[ii]));
+      }
+      m_transform.transformInPlace(buffer, scratch);
+
+      // Demodulate.
+      for(std::size_t kk = 0; kk < m_size; ++kk) {
+        outputSignal[kk] = privateCode::multiplyComplex(
+          std::conj(buffer[kk]), m_chirp[kk]);
+      }
+    }
+
+
+    template <class FloatType>
+    RealFFTPlan<FloatType>::
+    RealFFTPlan()
+      : m_size(0),
+        m_forwardPlan(),
+        m_inversePlan(),
+        m_twiddles(),
+        m_workspace()
+    {
+      // Empty.
+    }
+
+
+    template <class FloatType>
+    RealFFTPlan<FloatType>::
+    RealFFTPlan(std::size_t size)
+      : m_size(size),
+        m_forwardPlan(),
+        m_inversePlan(),
+        m_twiddles(),
+        m_workspace()
+    {
+      if(size == 0) {
+        return;
+      }
+      if(size % 2 != 0) {
+        m_forwardPlan = FFTPlan<ComplexType>(size, false);
+        m_inversePlan = FFTPlan<ComplexType>(size, true);
+        m_workspace.resize(size);
+        return;
+      }
+      std::size_t const halfSize = size / 2;
+      m_forwardPlan = FFTPlan<ComplexType>(halfSize, false);
+      m_inversePlan = FFTPlan<ComplexType>(halfSize, true);
+      m_twiddles.resize(halfSize);
+      for(std::size_t kk = 0; kk < halfSize; ++kk) {
+        m_twiddles[kk] = privateCode::getUnitPhasor<ComplexType>(
+          -brick::common::constants::twoPi * static_cast<double>(kk)
+          / static_cast<double>(size));
+      }
+      m_workspace.resize(halfSize);
+    }
+
+
+    template <class FloatType>
+    void
+    RealFFTPlan<FloatType>::
+    execute(Array1D<FloatType> const& inputSignal,
+            Array1D<ComplexType>& spectrum)
+    {
+      if(inputSignal.size() != m_size) {
+        BRICK_THROW(brick::common::ValueException, "RealFFTPlan::execute()",
+                    "Argument inputSignal has the wrong number of elements.");
+      }
+      if(spectrum.size() != this->getSpectrumSize()) {
+        spectrum.reinit(this->getSpectrumSize());
+      }
+      if(m_size != 0) {
+        this->execute(inputSignal.data(), spectrum.data());
+      }
+    }
+
+
+    template <class FloatType>
+    void
+    RealFFTPlan<FloatType>::
+    execute(Array1D<ComplexType> const& spectrum,
+            Array1D<FloatType>& outputSignal)
+    {
+      if(spectrum.size() != this->getSpectrumSize()) {
+        BRICK_THROW(brick::common::ValueException, "RealFFTPlan::execute()",
+                    "Argument spectrum has the wrong number of elements.");
+      }
+      if(outputSignal.size() != m_size) {
+        outputSignal.reinit(m_size);
+      }
+      if(m_size != 0) {
+        this->execute(spectrum.data(), outputSignal.data());
+      }
+    }
+
+
+    template <class FloatType>
+    void
+    RealFFTPlan<FloatType>::
+    execute(FloatType const* inputSignal, ComplexType* spectrum)
+    {
+      ComplexType* const buffer = &(m_workspace[0]);
+      if(m_size % 2 != 0) {
+        for(std::size_t nn = 0; nn < m_size; ++nn) {
+          buffer[nn] = ComplexType(inputSignal[nn], FloatType(0));
+        }
+        m_forwardPlan.execute(buffer);
+        std::copy(buffer, buffer + this->getSpectrumSize(), spectrum);
+        return;
+      }
+
+      // Transform the even samples (as real parts) and odd samples
+      // (as imaginary parts) together.
+      std::size_t const halfSize = m_size / 2;
+      for(std::size_t nn = 0; nn < halfSize; ++nn) {
+        buffer[nn] = ComplexType(inputSignal[2 * nn], inputSignal[2 * nn + 1]);
+      }
+      m_forwardPlan.execute(buffer);
+
+      // Because the even and odd sequences are real, their spectra
+      // E and O are conjugate symmetric, and can be separated from
+      // Z = E + iO using Z[M - k].  Then X[k] = E[k] + W^k O[k].
+      FloatType const half(0.5);
+      spectrum[0] = ComplexType(buffer[0].real() + buffer[0].imag(),
+                                FloatType(0));
+      spectrum[halfSize] = ComplexType(buffer[0].real() - buffer[0].imag(),
+                                       FloatType(0));
+      for(std::size_t kk = 1; kk < halfSize; ++kk) {
+        ComplexType const zz = buffer[kk];
+        ComplexType const zzReflected = std::conj(buffer[halfSize - kk]);
+        ComplexType const evenPart = half * (zz + zzReflected);
+        ComplexType const difference = half * (zz - zzReflected);
+        ComplexType const oddPart(difference.imag(), -difference.real());
+        spectrum[kk] = evenPart + privateCode::multiplyComplex(
+          m_twiddles[kk], oddPart);
+      }
+    }
+
+
+    template <class FloatType>
+    void
+    RealFFTPlan<FloatType>::
+    execute(ComplexType const* spectrum, FloatType* outputSignal)
+    {
+      ComplexType* const buffer = &(m_workspace[0]);
+      if(m_size % 2 != 0) {
+        buffer[0] = ComplexType(spectrum[0].real(), FloatType(0));
+        for(std::size_t kk = 1; kk < this->getSpectrumSize(); ++kk) {
+          buffer[kk] = spectrum[kk];
+          buffer[m_size - kk] = std::conj(spectrum[kk]);
+        }
+        m_inversePlan.execute(buffer);
+        for(std::size_t nn = 0; nn < m_size; ++nn) {
+          outputSignal[nn] = buffer[nn].real();
+        }
+        return;
+      }
+
+      // Reverse the untangling done by the forward transform.  We
+      // skip the factors of one half, which makes the result come out
+      // scaled by N rather than N / 2, consistent with FFTPlan.
+      std::size_t const halfSize = m_size / 2;
+      FloatType const dcTerm = spectrum[0].real();
+      FloatType const nyquistTerm = spectrum[halfSize].real();
+      buffer[0] = ComplexType(dcTerm + nyquistTerm, dcTerm - nyquistTerm);
+      for(std::size_t kk = 1; kk < halfSize; ++kk) {
+        ComplexType const xx = spectrum[kk];
+        ComplexType const xxReflected = std::conj(spectrum[halfSize - kk]);
+        ComplexType const evenPart = xx + xxReflected;
+        ComplexType const oddPart = privateCode::multiplyComplex(
+          xx - xxReflected, std::conj(m_twiddles[kk]));
+        buffer[kk] = ComplexType(evenPart.real() - oddPart.imag(),
+                                 evenPart.imag() + oddPart.real());
+      }
+      m_inversePlan.execute(buffer);
+      for(std::size_t nn = 0; nn < halfSize; ++nn) {
+        outputSignal[2 * nn] = buffer[nn].real();
+        outputSignal[2 * nn + 1] = buffer[nn].imag();
+      }
+    }
+
+
+    template <class ComplexType>
+    FFTPlan2D<ComplexType>::
+    FFTPlan2D()
+      : m_rowPlan(),
+        m_columnPlan(),
+        m_transposeBuffer()
+    {
+      // Empty.
+    }
+
+
+    template <class ComplexType>
+    FFTPlan2D<ComplexType>::
+    FFTPlan2D(std::size_t rows, std::size_t columns, bool isInverse)
+      : m_rowPlan(columns, isInverse),
+        m_columnPlan(rows, isInverse),
+        m_transposeBuffer(
+          rows * std::min(columns, privateCode::fftTransposeBandWidth))
+    {
+      // Empty.
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan2D<ComplexType>::
+    execute(Array2D<ComplexType>& signal)
+    {
+      std::size_t const rows = this->getRows();
+      std::size_t const columns = this->getColumns();
+      if(signal.rows() != rows || signal.columns() != columns) {
+        BRICK_THROW(brick::common::ValueException, "FFTPlan2D::execute()",
+                    "Argument signal has the wrong shape.");
+      }
+      if(rows == 0 || columns == 0) {
+        return;
+      }
+
+      for(std::size_t row = 0; row < rows; ++row) {
+        m_rowPlan.execute(signal.rowBegin(row));
+      }
+
+      // Transform the columns a band at a time.  Each band is
+      // transposed into a scratch buffer, so that its columns are
+      // contiguous, and then transposed back.  Narrow bands keep the
+      // scratch buffer in cache, while still reading whole cache
+      // lines from each row.
+      std::size_t const rowStep = signal.getRowStep();
+      ComplexType* const transposed = &(m_transposeBuffer[0]);
+      for(std::size_t column0 = 0; column0 < columns;
+          column0 += privateCode::fftTransposeBandWidth) {
+        std::size_t const bandWidth = std::min(
+          privateCode::fftTransposeBandWidth, columns - column0);
+        ComplexType* const bandStart = signal.data() + column0;
+        privateCode::transposeBlocked(bandStart, rows, bandWidth, rowStep,
+                                      transposed, rows);
+        for(std::size_t column = 0; column < bandWidth; ++column) {
+          m_columnPlan.execute(transposed + column * rows);
+        }
+        privateCode::transposeBlocked(transposed, bandWidth, rows, rows,
+                                      bandStart, rowStep);
+      }
+    }
+
+
+    template <class ComplexType>
+    void
+    FFTPlan2D<ComplexType>::
+    execute(Array2D<ComplexType> const& inputSignal,
+            Array2D<ComplexType>& outputSignal)
+    {
+      if(inputSignal.rows() != this->getRows()
+         || inputSignal.columns() != this->getColumns()) {
+        BRICK_THROW(brick::common::ValueException, "FFTPlan2D::execute()",
+                    "Argument inputSignal has the wrong shape.");
+      }
+      if(outputSignal.data() != inputSignal.data()) {
+        if(outputSignal.rows() != inputSignal.rows()
+           || outputSignal.columns() != inputSignal.columns()) {
+          outputSignal.reinit(inputSignal.rows(), inputSignal.columns());
+        }
+        // Note that rowEnd() includes any padding at the end of the
+        // row, so we can't use it here.
+        for(std::size_t row = 0; row < inputSignal.rows(); ++row) {
+          std::copy(inputSignal.rowBegin(row),
+                    inputSignal.rowBegin(row) + inputSignal.columns(),
+                    outputSignal.rowBegin(row));
+        }
+      }
+      this->execute(outputSignal);
+    }
+
+
     template <class ComplexType>
     Array1D<ComplexType>
     computeFFT(Array1D<ComplexType> const& inputSignal)
     {
-      if(not privateCode::isPowerOfTwo(inputSignal.size())) {
-        BRICK_THROW(brick::common::NotImplementedException,
-                    "computeFFT()",
-                    "Length of index signal must currently be a power of two.");
-      }
-
-      // This code implements the recursive radix-2 decimation-in-time
-      // algorithm of Cooley and Tukey.  This algorithm recognizes
-      // that the naive FFT calculation (which is O(N^2), where N
-      // is the number of elements of the input signal), can be
-      // written as the sum of two sub-FFTs.  The first of these is
-      // the FFT of the even elements of the input sequence, and the
-      // second is the FFT of the odd elements of the input sequence,
-      // with a frequency-dependent phase offset.  These phase offsets
-      // are traditionally called "twiddle factors," and are computed
-      // up-front.
-      //
-      // These two sub-FFTs have half as many elements (each) as the
-      // whole FFT.  FFTs are periodic, though, so only N/2 FFT values
-      // need be computed for each sub-FFT.  Repeating this trick for
-      // each sub-FFT gives a recursive algorithm with O(N*log(N))
-      // complexity.
+      // This code used to implement the recursive radix-2
+      // decimation-in-time algorithm of Cooley and Tukey directly.
+      // FFTPlan implements the same idea iteratively, generalized to
+      // radices 3 and 5, and falls back to Bluestein's algorithm for
+      // lengths with other prime factors.
+      FFTPlan<ComplexType> plan(inputSignal.size());
       Array1D<ComplexType> result(inputSignal.size());
-      std::size_t inputIndex = 0;
-      std::size_t outputIndex = 0;
-      std::size_t inputStride = 1;
-      std::size_t count = inputSignal.size();
-      Array1D<ComplexType> twiddleFactors =
-        privateCode::computeRadix2Twiddles<ComplexType>(count);
-      privateCode::recursiveRadix2FFT(
-        result, outputIndex, inputSignal, inputIndex, count, inputStride,
-        twiddleFactors);
+      plan.execute(inputSignal, result);
+      return result;
+    }
+
+
+    template <class ComplexType>
+    Array2D<ComplexType>
+    computeFFT2D(Array2D<ComplexType> const& inputSignal)
+    {
+      FFTPlan2D<ComplexType> plan(inputSignal.rows(), inputSignal.columns());
+      Array2D<ComplexType> result(inputSignal.rows(), inputSignal.columns());
+      plan.execute(inputSignal, result);
+      return result;
+    }
+
 
+    template <class FloatType>
+    Array1D< std::complex<FloatType> >
+    computeRealFFT(Array1D<FloatType> const& inputSignal)
+    {
+      RealFFTPlan<FloatType> plan(inputSignal.size());
+      Array1D< std::complex<FloatType> > result(plan.getSpectrumSize());
+      plan.execute(inputSignal, result);
       return result;
     }
 
+
+    inline std::size_t
+    getEfficientFFTSize(std::size_t minimumSize)
+    {
+      // Enumerate 2^a * 3^b * 5^c, keeping the smallest candidate
+      // that is large enough.
+      if(minimumSize <= 1) {
+        return 1;
+      }
+      std::size_t bestSize = 1;
+      while(bestSize < minimumSize) {
+        bestSize *= 2;
+      }
+      for(std::size_t power5 = 1; power5 < bestSize; power5 *= 5) {
+        for(std::size_t power35 = power5; power35 < bestSize; power35 *= 3) {
+          std::size_t candidate = power35;
+          while(candidate < minimumSize) {
+            candidate *= 2;
+          }
+          if(candidate < bestSize) {
+            bestSize = candidate;
+          }
+        }
+      }
+      return bestSize;
+    }
+
   } // namespace numeric
 
 } // namespace brick
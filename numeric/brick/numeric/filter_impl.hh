@@ -18,6 +18,7 @@
 //
 // #include <brick/numeric/filter.hh>
 
+#include <brick/numeric/simdKernels.hh>
 
 namespace brick {
 
@@ -558,6 +559,115 @@ namespace brick {
         }
       }
 
+
+      // These overloads let filterColumns() and filterRows() hand
+      // the most common type combinations off to the vectorized
+      // kernels in simdKernels.hh.  The generic versions simply
+      // report that no vectorized implementation is available.
+      template<class InputType, class OutputType, class KernelType>
+      inline bool
+      filterColumnsVectorized(
+        Array2D<OutputType>& /* outputArray */,
+        Array2D<InputType> const& /* inputArray */,
+        Array1D<KernelType> const& /* kernel */)
+      {
+        return false;
+      }
+
+
+      template<class InputType, class OutputType, class KernelType>
+      inline bool
+      filterRowsVectorized(
+        Array2D<OutputType>& /* outputArray */,
+        Array2D<InputType> const& /* inputArray */,
+        Array1D<KernelType> const& /* kernel */)
+      {
+        return false;
+      }
+
+
+      template<class InputType, class OutputType>
+      inline bool
+      filterColumnsVectorizedCommon(
+        Array2D<OutputType>& outputArray,
+        Array2D<InputType> const& inputArray,
+        Array1D<OutputType> const& kernel)
+      {
+        if(kernel.size() > inputArray.rows()) {
+          return true;
+        }
+        size_t const startRow = kernel.size() / 2;
+        size_t const stopRow = inputArray.rows() - startRow;
+        for(size_t row = startRow; row < stopRow; ++row) {
+          correlateTaps(outputArray.data(row, 0),
+                        inputArray.data(row - startRow, 0),
+                        static_cast<std::ptrdiff_t>(inputArray.getRowStep()),
+                        kernel.data(), kernel.size(), inputArray.columns());
+        }
+        return true;
+      }
+
+
+      template<class InputType, class OutputType>
+      inline bool
+      filterRowsVectorizedCommon(
+        Array2D<OutputType>& outputArray,
+        Array2D<InputType> const& inputArray,
+        Array1D<OutputType> const& kernel)
+      {
+        if(kernel.size() > inputArray.columns()) {
+          return true;
+        }
+        size_t const startColumn = kernel.size() / 2;
+        size_t const numberOfOutputs = inputArray.columns() - kernel.size() + 1;
+        for(size_t row = 0; row < inputArray.rows(); ++row) {
+          correlateTaps(outputArray.data(row, startColumn),
+                        inputArray.data(row, 0), 1,
+                        kernel.data(), kernel.size(), numberOfOutputs);
+        }
+        return true;
+      }
+
+
+      inline bool
+      filterColumnsVectorized(
+        Array2D<common::Float32>& outputArray,
+        Array2D<common::Float32> const& inputArray,
+        Array1D<common::Float32> const& kernel)
+      {
+        return filterColumnsVectorizedCommon(outputArray, inputArray, kernel);
+      }
+
+
+      inline bool
+      filterColumnsVectorized(
+        Array2D<common::Int32>& outputArray,
+        Array2D<common::UInt8> const& inputArray,
+        Array1D<common::Int32> const& kernel)
+      {
+        return filterColumnsVectorizedCommon(outputArray, inputArray, kernel);
+      }
+
+
+      inline bool
+      filterRowsVectorized(
+        Array2D<common::Float32>& outputArray,
+        Array2D<common::Float32> const& inputArray,
+        Array1D<common::Float32> const& kernel)
+      {
+        return filterRowsVectorizedCommon(outputArray, inputArray, kernel);
+      }
+
+
+      inline bool
+      filterRowsVectorized(
+        Array2D<common::Int32>& outputArray,
+        Array2D<common::UInt8> const& inputArray,
+        Array1D<common::Int32> const& kernel)
+      {
+        return filterRowsVectorizedCommon(outputArray, inputArray, kernel);
+      }
+
     } // namespace privateCode
 
     template<class InputType, class OutputType, class KernelType>
@@ -581,6 +691,12 @@ namespace brick {
                     "Argument kernel must have an odd number of elements.");
       }
 
+      // Common type combinations have hand-vectorized implementations.
+      if(privateCode::filterColumnsVectorized(
+           outputArray, inputArray, kernel)) {
+        return;
+      }
+
       switch(kernel.size()) {
       case 3:
         privateCode::filterColumns_3(outputArray, inputArray, kernel);
@@ -631,6 +747,12 @@ namespace brick {
                     "Argument kernel must have an odd number of elements.");
       }
 
+      // Common type combinations have hand-vectorized implementations.
+      if(privateCode::filterRowsVectorized(
+           outputArray, inputArray, kernel)) {
+        return;
+      }
+
       switch(kernel.size()) {
       case 3:
         privateCode::filterRows_3(outputArray, inputArray, kernel);
@@ -0,0 +1,387 @@
+/**
+***************************************************************************
+* @file brick/numeric/simdKernels.cc
+*
+* Source file defining vectorized inner loops used by the filtering
+* and convolution routines.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#include <atomic>
+#include <limits>
+#include <brick/numeric/simdKernels.hh>
+
+// The vectorized code paths use GCC/Clang function target attributes,
+// so that the rest of the library can be compiled for the baseline
+// instruction set, with AVX2 selected at runtime.  Other compilers
+// and architectures get only the scalar code.
+#if (defined(__x86_64__) || defined(__i386__)) \
+  && defined(__GNUC__) && defined(__SSE2__)
+#define BRICK_NUMERIC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define BRICK_NUMERIC_SIMD_X86 0
+#endif
+
+namespace brick {
+
+  namespace numeric {
+
+    namespace {
+
+      // This function holds the current setting of setSimdLevel().
+      std::atomic<int>&
+      getSimdLevelStorage()
+      {
+        static std::atomic<int> simdLevel(
+          static_cast<int>(getSupportedSimdLevel()));
+        return simdLevel;
+      }
+
+
+      template <class OutputType, class InputType, class KernelType>
+      void
+      correlateTapsScalar(OutputType* output,
+                          InputType const* input,
+                          std::ptrdiff_t tapStride,
+                          KernelType const* kernel,
+                          std::size_t kernelSize,
+                          std::size_t count)
+      {
+        for(std::size_t ii = 0; ii < count; ++ii) {
+          OutputType accumulator = static_cast<OutputType>(0);
+          InputType const* inPtr = input + ii;
+          for(std::size_t kk = 0; kk < kernelSize; ++kk) {
+            accumulator += kernel[kk] * static_cast<OutputType>(*inPtr);
+            inPtr += tapStride;
+          }
+          output[ii] = accumulator;
+        }
+      }
+
+#if BRICK_NUMERIC_SIMD_X86
+
+      void
+      correlateTapsSSE2(common::Float32* output,
+                        common::Float32 const* input,
+                        std::ptrdiff_t tapStride,
+                        common::Float32 const* kernel,
+                        std::size_t kernelSize,
+                        std::size_t count)
+      {
+        // Two registers per iteration hide some of the add latency.
+        std::size_t ii = 0;
+        for(; ii + 8 <= count; ii += 8) {
+          __m128 accumulator0 = _mm_setzero_ps();
+          __m128 accumulator1 = _mm_setzero_ps();
+          common::Float32 const* inPtr = input + ii;
+          for(std::size_t kk = 0; kk < kernelSize; ++kk) {
+            __m128 coefficient = _mm_set1_ps(kernel[kk]);
+            accumulator0 = _mm_add_ps(
+              accumulator0, _mm_mul_ps(coefficient, _mm_loadu_ps(inPtr)));
+            accumulator1 = _mm_add_ps(
+              accumulator1, _mm_mul_ps(coefficient, _mm_loadu_ps(inPtr + 4)));
+            inPtr += tapStride;
+          }
+          _mm_storeu_ps(output + ii, accumulator0);
+          _mm_storeu_ps(output + ii + 4, accumulator1);
+        }
+        correlateTapsScalar(output + ii, input + ii, tapStride,
+                            kernel, kernelSize, count - ii);
+      }
+
+
+      // Returns true if every kernel coefficient fits in 16 bits, so
+      // that the pmaddwd instruction can be used.
+      bool
+      isInt16Kernel(common::Int32 const* kernel, std::size_t kernelSize)
+      {
+        for(std::size_t kk = 0; kk < kernelSize; ++kk) {
+          if(kernel[kk] < std::numeric_limits<common::Int16>::min()
+             || kernel[kk] > std::numeric_limits<common::Int16>::max()) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+
+      // Packs two 16-bit kernel coefficients into each 32-bit lane,
+      // in the order expected by pmaddwd.
+      common::Int32
+      packCoefficientPair(common::Int32 coefficient0,
+                          common::Int32 coefficient1)
+      {
+        common::UInt32 low =
+          static_cast<common::UInt32>(coefficient0) & 0xffffu;
+        common::UInt32 high = static_cast<common::UInt32>(coefficient1) << 16;
+        return static_cast<common::Int32>(high | low);
+      }
+
+
+      void
+      correlateTapsSSE2(common::Int32* output,
+                        common::UInt8 const* input,
+                        std::ptrdiff_t tapStride,
+                        common::Int32 const* kernel,
+                        std::size_t kernelSize,
+                        std::size_t count)
+      {
+        // SSE2 has no 32-bit multiply, so we interleave the 16-bit
+        // pixels from pairs of taps and let pmaddwd compute
+        // (kernel[kk] * p0 + kernel[kk + 1] * p1) in each 32-bit lane.
+        // This only works if the kernel fits in 16 bits.
+        if(!isInt16Kernel(kernel, kernelSize)) {
+          correlateTapsScalar(output, input, tapStride,
+                              kernel, kernelSize, count);
+          return;
+        }
+
+        __m128i const zero = _mm_setzero_si128();
+        std::size_t ii = 0;
+        for(; ii + 8 <= count; ii += 8) {
+          __m128i accumulator0 = _mm_setzero_si128();
+          __m128i accumulator1 = _mm_setzero_si128();
+          common::UInt8 const* inPtr = input + ii;
+          std::size_t kk = 0;
+          for(; kk < kernelSize; kk += 2) {
+            common::Int32 coefficient1 = 0;
+            __m128i pixels1 = zero;
+            if(kk + 1 < kernelSize) {
+              coefficient1 = kernel[kk + 1];
+              pixels1 = _mm_unpacklo_epi8(
+                _mm_loadl_epi64(
+                  reinterpret_cast<__m128i const*>(inPtr + tapStride)), zero);
+            }
+            __m128i pixels0 = _mm_unpacklo_epi8(
+              _mm_loadl_epi64(reinterpret_cast<__m128i const*>(inPtr)), zero);
+            __m128i coefficients = _mm_set1_epi32(
+              packCoefficientPair(kernel[kk], coefficient1));
+            accumulator0 = _mm_add_epi32(
+              accumulator0,
+              _mm_madd_epi16(_mm_unpacklo_epi16(pixels0, pixels1),
+                             coefficients));
+            accumulator1 = _mm_add_epi32(
+              accumulator1,
+              _mm_madd_epi16(_mm_unpackhi_epi16(pixels0, pixels1),
+                             coefficients));
+            inPtr += 2 * tapStride;
+          }
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(output + ii),
+                           accumulator0);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(output + ii + 4),
+                           accumulator1);
+        }
+        correlateTapsScalar(output + ii, input + ii, tapStride,
+                            kernel, kernelSize, count - ii);
+      }
+
+
+      __attribute__((target("avx2")))
+      void
+      correlateTapsAVX2(common::Float32* output,
+                        common::Float32 const* input,
+                        std::ptrdiff_t tapStride,
+                        common::Float32 const* kernel,
+                        std::size_t kernelSize,
+                        std::size_t count)
+      {
+        // Note that we deliberately avoid FMA instructions, so that
+        // results match the scalar code exactly.
+        std::size_t ii = 0;
+        for(; ii + 16 <= count; ii += 16) {
+          __m256 accumulator0 = _mm256_setzero_ps();
+          __m256 accumulator1 = _mm256_setzero_ps();
+          common::Float32 const* inPtr = input + ii;
+          for(std::size_t kk = 0; kk < kernelSize; ++kk) {
+            __m256 coefficient = _mm256_set1_ps(kernel[kk]);
+            accumulator0 = _mm256_add_ps(
+              accumulator0,
+              _mm256_mul_ps(coefficient, _mm256_loadu_ps(inPtr)));
+            accumulator1 = _mm256_add_ps(
+              accumulator1,
+              _mm256_mul_ps(coefficient, _mm256_loadu_ps(inPtr + 8)));
+            inPtr += tapStride;
+          }
+          _mm256_storeu_ps(output + ii, accumulator0);
+          _mm256_storeu_ps(output + ii + 8, accumulator1);
+        }
+        correlateTapsSSE2(output + ii, input + ii, tapStride,
+                          kernel, kernelSize, count - ii);
+      }
+
+
+      __attribute__((target("avx2")))
+      void
+      correlateTapsAVX2(common::Int32* output,
+                        common::UInt8 const* input,
+                        std::ptrdiff_t tapStride,
+                        common::Int32 const* kernel,
+                        std::size_t kernelSize,
+                        std::size_t count)
+      {
+        std::size_t ii = 0;
+        if(isInt16Kernel(kernel, kernelSize)) {
+          // Same pmaddwd trick as the SSE2 version.  Note that the
+          // unpack instructions operate within 128-bit lanes, so
+          // accumulator0 holds outputs 0-3 and 8-11, and accumulator1
+          // holds outputs 4-7 and 12-15.
+          for(; ii + 16 <= count; ii += 16) {
+            __m256i accumulator0 = _mm256_setzero_si256();
+            __m256i accumulator1 = _mm256_setzero_si256();
+            common::UInt8 const* inPtr = input + ii;
+            for(std::size_t kk = 0; kk < kernelSize; kk += 2) {
+              common::Int32 coefficient1 = 0;
+              __m256i pixels1 = _mm256_setzero_si256();
+              if(kk + 1 < kernelSize) {
+                coefficient1 = kernel[kk + 1];
+                pixels1 = _mm256_cvtepu8_epi16(
+                  _mm_loadu_si128(
+                    reinterpret_cast<__m128i const*>(inPtr + tapStride)));
+              }
+              __m256i pixels0 = _mm256_cvtepu8_epi16(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(inPtr)));
+              __m256i coefficients = _mm256_set1_epi32(
+                packCoefficientPair(kernel[kk], coefficient1));
+              accumulator0 = _mm256_add_epi32(
+                accumulator0,
+                _mm256_madd_epi16(_mm256_unpacklo_epi16(pixels0, pixels1),
+                                  coefficients));
+              accumulator1 = _mm256_add_epi32(
+                accumulator1,
+                _mm256_madd_epi16(_mm256_unpackhi_epi16(pixels0, pixels1),
+                                  coefficients));
+              inPtr += 2 * tapStride;
+            }
+            _mm256_storeu_si256(
+              reinterpret_cast<__m256i*>(output + ii),
+              _mm256_permute2x128_si256(accumulator0, accumulator1, 0x20));
+            _mm256_storeu_si256(
+              reinterpret_cast<__m256i*>(output + ii + 8),
+              _mm256_permute2x128_si256(accumulator0, accumulator1, 0x31));
+          }
+        } else {
+          for(; ii + 16 <= count; ii += 16) {
+            __m256i accumulator0 = _mm256_setzero_si256();
+            __m256i accumulator1 = _mm256_setzero_si256();
+            common::UInt8 const* inPtr = input + ii;
+            for(std::size_t kk = 0; kk < kernelSize; ++kk) {
+              __m256i coefficient = _mm256_set1_epi32(kernel[kk]);
+              __m256i pixels0 = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<__m128i const*>(inPtr)));
+              __m256i pixels1 = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64(reinterpret_cast<__m128i const*>(inPtr + 8)));
+              accumulator0 = _mm256_add_epi32(
+                accumulator0, _mm256_mullo_epi32(pixels0, coefficient));
+              accumulator1 = _mm256_add_epi32(
+                accumulator1, _mm256_mullo_epi32(pixels1, coefficient));
+              inPtr += tapStride;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + ii),
+                                accumulator0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + ii + 8),
+                                accumulator1);
+          }
+        }
+        correlateTapsScalar(output + ii, input + ii, tapStride,
+                            kernel, kernelSize, count - ii);
+      }
+
+#endif /* #if BRICK_NUMERIC_SIMD_X86 */
+
+    } // namespace
+
+
+    SimdLevel
+    getSupportedSimdLevel()
+    {
+#if BRICK_NUMERIC_SIMD_X86
+      if(__builtin_cpu_supports("avx2")) {
+        return BRICK_SIMD_AVX2;
+      }
+      return BRICK_SIMD_SSE2;
+#else
+      return BRICK_SIMD_NONE;
+#endif
+    }
+
+
+    SimdLevel
+    getSimdLevel()
+    {
+      return static_cast<SimdLevel>(getSimdLevelStorage().load());
+    }
+
+
+    SimdLevel
+    setSimdLevel(SimdLevel level)
+    {
+      SimdLevel supportedLevel = getSupportedSimdLevel();
+      if(level > supportedLevel) {
+        level = supportedLevel;
+      }
+      getSimdLevelStorage().store(static_cast<int>(level));
+      return level;
+    }
+
+
+    void
+    correlateTaps(common::Float32* output,
+                  common::Float32 const* input,
+                  std::ptrdiff_t tapStride,
+                  common::Float32 const* kernel,
+                  std::size_t kernelSize,
+                  std::size_t count)
+    {
+      switch(getSimdLevel()) {
+#if BRICK_NUMERIC_SIMD_X86
+      case BRICK_SIMD_AVX2:
+        correlateTapsAVX2(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+      case BRICK_SIMD_SSE2:
+        correlateTapsSSE2(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+#endif /* #if BRICK_NUMERIC_SIMD_X86 */
+      default:
+        correlateTapsScalar(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+      }
+    }
+
+
+    void
+    correlateTaps(common::Int32* output,
+                  common::UInt8 const* input,
+                  std::ptrdiff_t tapStride,
+                  common::Int32 const* kernel,
+                  std::size_t kernelSize,
+                  std::size_t count)
+    {
+      switch(getSimdLevel()) {
+#if BRICK_NUMERIC_SIMD_X86
+      case BRICK_SIMD_AVX2:
+        correlateTapsAVX2(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+      case BRICK_SIMD_SSE2:
+        correlateTapsSSE2(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+#endif /* #if BRICK_NUMERIC_SIMD_X86 */
+      default:
+        correlateTapsScalar(
+          output, input, tapStride, kernel, kernelSize, count);
+        break;
+      }
+    }
+
+  } // namespace numeric
+
+} // namespace brick
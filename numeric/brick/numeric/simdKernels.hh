@@ -0,0 +1,153 @@
+/**
+***************************************************************************
+* @file brick/numeric/simdKernels.hh
+*
+* Header file declaring vectorized inner loops used by the filtering
+* and convolution routines.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_NUMERIC_SIMDKERNELS_HH
+#define BRICK_NUMERIC_SIMDKERNELS_HH
+
+#include <cstddef>
+#include <brick/common/types.hh>
+
+namespace brick {
+
+  namespace numeric {
+
+    /**
+     ** This enum identifies the instruction sets that can be used by
+     ** the vectorized kernels declared in this file.  Levels are
+     ** ordered, so that each one implies support for all of the
+     ** levels that precede it.
+     **/
+    enum SimdLevel {
+      BRICK_SIMD_NONE,
+      BRICK_SIMD_SSE2,
+      BRICK_SIMD_AVX2
+    };
+
+
+    /**
+     * This function reports the most capable instruction set that
+     * both the compiler and the CPU executing the program support.
+     *
+     * @return The return value is the highest usable SimdLevel.
+     */
+    SimdLevel
+    getSupportedSimdLevel();
+
+
+    /**
+     * This function reports the instruction set currently used by
+     * correlateTaps().  Unless setSimdLevel() has been called, this is
+     * the same as getSupportedSimdLevel().
+     *
+     * @return The return value is the SimdLevel in use.
+     */
+    SimdLevel
+    getSimdLevel();
+
+
+    /**
+     * This function restricts the instruction set used by
+     * correlateTaps(), and is mostly useful for testing and
+     * benchmarking.  Requests for levels beyond
+     * getSupportedSimdLevel() are silently clamped.  The setting is
+     * global, and takes effect for all threads.
+     *
+     * @param level This argument specifies the most capable
+     * instruction set that may be used.
+     *
+     * @return The return value is the level actually selected.
+     */
+    SimdLevel
+    setSimdLevel(SimdLevel level);
+
+
+    /**
+     * This function is the inner loop shared by filterRows(),
+     * filterColumns(), and correlate1D().  It computes count
+     * correlations of a kernel with evenly spaced input taps:
+     *
+     * @code
+     *   output[ii] = sum_kk (kernel[kk] * input[ii + kk * tapStride])
+     * @endcode
+     *
+     * The sum is accumulated in order of increasing kk, and no fused
+     * multiply-add instructions are used, so the result is bit-for-bit
+     * identical regardless of which SimdLevel is selected.
+     *
+     * @param output This argument points to the first of count
+     * output elements.
+     *
+     * @param input This argument points to the first input element
+     * used in computing output[0].
+     *
+     * @param tapStride This argument specifies the distance, in
+     * elements, between successive input taps.  Use 1 for filtering
+     * along a row, or the row step of the input array for filtering
+     * along a column.
+     *
+     * @param kernel This argument points to the first of kernelSize
+     * kernel coefficients.
+     *
+     * @param kernelSize This argument specifies the number of kernel
+     * coefficients.
+     *
+     * @param count This argument specifies how many output elements
+     * to compute.
+     */
+    void
+    correlateTaps(common::Float32* output,
+                  common::Float32 const* input,
+                  std::ptrdiff_t tapStride,
+                  common::Float32 const* kernel,
+                  std::size_t kernelSize,
+                  std::size_t count);
+
+
+    /**
+     * This function works just like the floating point version of
+     * correlateTaps(), but accumulates 8-bit unsigned input with a
+     * 32-bit integer kernel.  With SSE2 alone, the vectorized path
+     * requires every kernel coefficient to fit in 16 bits, and falls
+     * back to scalar code otherwise.
+     *
+     * @param output This argument points to the first of count
+     * output elements.
+     *
+     * @param input This argument points to the first input element
+     * used in computing output[0].
+     *
+     * @param tapStride This argument specifies the distance, in
+     * elements, between successive input taps.
+     *
+     * @param kernel This argument points to the first of kernelSize
+     * kernel coefficients.
+     *
+     * @param kernelSize This argument specifies the number of kernel
+     * coefficients.
+     *
+     * @param count This argument specifies how many output elements
+     * to compute.
+     */
+    void
+    correlateTaps(common::Int32* output,
+                  common::UInt8 const* input,
+                  std::ptrdiff_t tapStride,
+                  common::Int32 const* kernel,
+                  std::size_t kernelSize,
+                  std::size_t count);
+
+  } // namespace numeric
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_NUMERIC_SIMDKERNELS_HH */
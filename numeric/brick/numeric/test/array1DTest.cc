@@ -11,8 +11,10 @@
 **/
 
 #include <math.h>
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <utility>
 #include <brick/numeric/array1D.hh>
 #include <brick/test/functors.hh>
 
@@ -88,6 +90,7 @@ namespace brick {
       void testConstructor__size_t();
       void testConstructor__string();
       void testConstructor__Array1D();
+      void testConstructor__Array1DMove();
       void testConstructor__size_t__TypePtr();
       void testConstructor__size_t__TypePtr__ReferenceCount();
       void testDestructor();
@@ -108,6 +111,7 @@ namespace brick {
       void testReinit();
       void testSize();
       void testAssignmentOperator__Array1D();
+      void testAssignmentOperator__Array1DMove();
       void testAssignmentOperator__Type();
       void testApplicationOperator();
       void testApplicationOperatorConst();
@@ -117,6 +121,11 @@ namespace brick {
       // C++11 tests.
       void testInitializerList();
 
+      // Tests of non-member functions.
+      void testExpression();
+      void testExpression__aliasing();
+      void testExpression__arrayInterface();
+
 
     private:
       size_t m_defaultArraySize;
@@ -156,6 +165,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__string);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__Array1D);
+      BRICK_TEST_REGISTER_MEMBER(testConstructor__Array1DMove);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__TypePtr);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__TypePtr__ReferenceCount);
       BRICK_TEST_REGISTER_MEMBER(testDestructor);
@@ -176,6 +186,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testReinit);
       BRICK_TEST_REGISTER_MEMBER(testSize);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array1D);
+      BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array1DMove);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Type);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperator);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperatorConst);
@@ -184,6 +195,9 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testOutputOperator);
       BRICK_TEST_REGISTER_MEMBER(testInputOperator);
       BRICK_TEST_REGISTER_MEMBER(testInitializerList);
+      BRICK_TEST_REGISTER_MEMBER(testExpression);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__aliasing);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__arrayInterface);
 
 
       // Set up fibonacci data for tests.
@@ -329,6 +343,31 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array1DTest<Type>::
+    testConstructor__Array1DMove()
+    {
+      // The move constructor should take over the data of its
+      // argument, leaving the argument empty.
+      Array1D<Type> array0(m_fibonacciString);
+      Type* dataPtr = array0.data();
+      Array1D<Type> array1(std::move(array0));
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 1);
+      BRICK_TEST_ASSERT(!array0.isReferenceCounted());
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // The moved-from array must still be usable.
+      array0 = array1;
+      BRICK_TEST_ASSERT(array0.data() == dataPtr);
+    }
+
+
     template <class Type>
     void
     Array1DTest<Type>::
@@ -659,6 +698,40 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array1DTest<Type>::
+    testAssignmentOperator__Array1DMove()
+    {
+      // Move assignment releases the old data of the target, and
+      // takes over the data of the source.
+      Array1D<Type> array0(m_fibonacciString);
+      Array1D<Type> array2 = array0;
+      Type* dataPtr = array0.data();
+      Array1D<Type> array1(m_squaresString);
+      array1 = std::move(array0);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 2);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // Self-move must leave the array intact.
+      Array1D<Type>& alias = array1;
+      array1 = std::move(alias);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+
+      // Moving from a temporary.
+      array1 = Array1D<Type>(m_squaresString);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_squaresCArray));
+      BRICK_TEST_ASSERT(std::equal(array2.begin(), array2.end(),
+                                   m_fibonacciCArray));
+    }
+
+
     template <class Type>
     void
     Array1DTest<Type>::
@@ -765,6 +838,163 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array1DTest<Type>::
+    testExpression()
+    {
+      const Array1D<Type> array0(m_fibonacciString);
+      const Array1D<Type> array1(m_squaresString);
+      const Type one = static_cast<Type>(1);
+      const Type two = static_cast<Type>(2);
+
+      // A compound expression should give the same answer as the
+      // element-by-element computation.
+      Array1D<Type> result = array0 * array1 + array1 * two - one / array0;
+      BRICK_TEST_ASSERT(result.size() == m_defaultArraySize);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(
+          result[index] == (m_fibonacciCArray[index] * m_squaresCArray[index]
+                            + m_squaresCArray[index] * two
+                            - one / m_fibonacciCArray[index]));
+      }
+
+      // Assigning to an unshared array of the right size should
+      // reuse its storage, even if the array appears in the
+      // expression.
+      Type* dataPtr = result.data();
+      result = (result - array1 * two) / array0;
+      BRICK_TEST_ASSERT(result.data() == dataPtr);
+
+      // Assigning to an array that shares its data must not modify
+      // the other arrays that point to the same data.
+      Array1D<Type> alias = result;
+      result = array0 - array1;
+      BRICK_TEST_ASSERT(result.data() != dataPtr);
+      BRICK_TEST_ASSERT(alias.data() == dataPtr);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(
+          result[index] == m_fibonacciCArray[index] - m_squaresCArray[index]);
+        BRICK_TEST_ASSERT(
+          alias[index] == ((m_fibonacciCArray[index] * m_squaresCArray[index]
+                            + m_squaresCArray[index] * two
+                            - one / m_fibonacciCArray[index]
+                            - m_squaresCArray[index] * two)
+                           / m_fibonacciCArray[index]));
+      }
+
+      // Compound assignment and copy() evaluate in place.
+      result += two * array0;
+      result.copy(result * (array1 + one));
+      BRICK_TEST_ASSERT(result.data() != dataPtr);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(
+          result[index] == ((m_fibonacciCArray[index] - m_squaresCArray[index]
+                             + two * m_fibonacciCArray[index])
+                            * (m_squaresCArray[index] + one)));
+      }
+
+      // Mismatched sizes should be caught as soon as the expression
+      // is built.
+      const Array1D<Type> shortArray(m_defaultArraySize - 1);
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  array0 * two + shortArray);
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  result -= shortArray * two);
+    }
+
+
+    template <class Type>
+    void
+    Array1DTest<Type>::
+    testExpression__aliasing()
+    {
+      // Arrays that view the same buffer at different offsets must
+      // give the same results as if each operation had been
+      // computed into its own temporary array.
+      const size_t size = m_defaultArraySize - 1;
+      Array1D<Type> array1(size);
+      std::copy(m_squaresCArray, m_squaresCArray + size, array1.begin());
+      Array1D<Type> buffer(m_fibonacciString);
+      Array1D<Type> later(size, buffer.data() + 1);
+      Array1D<Type> earlier(size, buffer.data());
+      later += earlier * array1;
+      BRICK_TEST_ASSERT(buffer[0] == m_fibonacciCArray[0]);
+      for(size_t index = 0; index < size; ++index) {
+        BRICK_TEST_ASSERT(
+          later[index] == (m_fibonacciCArray[index + 1]
+                           + m_fibonacciCArray[index] * array1[index]));
+      }
+
+      buffer.copy(Array1D<Type>(m_fibonacciString));
+      earlier.copy(later - array1);
+      BRICK_TEST_ASSERT(buffer[size] == m_fibonacciCArray[size]);
+      for(size_t index = 0; index < size; ++index) {
+        BRICK_TEST_ASSERT(
+          earlier[index] == m_fibonacciCArray[index + 1] - array1[index]);
+      }
+
+      // Reading *this element-for-element is still done in place.
+      buffer.copy(Array1D<Type>(m_fibonacciString));
+      Type* dataPtr = buffer.data();
+      buffer = buffer * buffer + buffer;
+      BRICK_TEST_ASSERT(buffer.data() == dataPtr);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(
+          buffer[index] == (m_fibonacciCArray[index] * m_fibonacciCArray[index]
+                            + m_fibonacciCArray[index]));
+      }
+    }
+
+
+    template <class Type>
+    void
+    Array1DTest<Type>::
+    testExpression__arrayInterface()
+    {
+      // Expressions should support the read-only parts of the Array1D
+      // interface, as did the temporary arrays returned by the
+      // arithmetic operators before they became lazy.
+      const Array1D<Type> array0(m_fibonacciString);
+      const Array1D<Type> array1(m_squaresString);
+      const Array1D<Type> referenceArray = array0 + array1;
+      BRICK_TEST_ASSERT((array0 + array1).size() == m_defaultArraySize);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT((array0 + array1)[index] == referenceArray[index]);
+        BRICK_TEST_ASSERT((array0 + array1)(index) == referenceArray[index]);
+      }
+      Array1D<Type> copiedArray = (array0 + array1).copy();
+      BRICK_TEST_ASSERT(copiedArray.size() == m_defaultArraySize);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(copiedArray[index] == referenceArray[index]);
+      }
+
+      std::ostringstream expressionStream;
+      std::ostringstream referenceStream;
+      expressionStream << array0 + array1;
+      referenceStream << referenceArray;
+      BRICK_TEST_ASSERT(expressionStream.str() == referenceStream.str());
+
+      const Type zero = static_cast<Type>(0);
+      const Type threshold = array1[m_defaultArraySize / 2];
+      Array1D<bool> equalFlags = (array0 + array1) == referenceArray;
+      Array1D<bool> scalarEqualFlags = (array1 + zero) == threshold;
+      Array1D<bool> greaterFlags = (array1 + zero) > threshold;
+      Array1D<bool> greaterEqualFlags = (array1 + zero) >= threshold;
+      Array1D<bool> lessFlags = (array1 + zero) < threshold;
+      Array1D<bool> lessEqualFlags = (array1 + zero) <= threshold;
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        const Type value = array1[index];
+        BRICK_TEST_ASSERT(equalFlags[index]);
+        BRICK_TEST_ASSERT(scalarEqualFlags[index] == (value == threshold));
+        BRICK_TEST_ASSERT(greaterFlags[index] == (value > threshold));
+        BRICK_TEST_ASSERT(greaterEqualFlags[index] == (value >= threshold));
+        BRICK_TEST_ASSERT(lessFlags[index] == (value < threshold));
+        BRICK_TEST_ASSERT(lessEqualFlags[index] == (value <= threshold));
+      }
+    }
+
+
   } // namespace numeric
 
 } // namespace brick
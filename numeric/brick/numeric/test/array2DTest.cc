@@ -10,14 +10,55 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_NUMERIC_DEVELOPER
+#define BRICK_NUMERIC_DEVELOPER 0
+#endif /* #ifndef BRICK_NUMERIC_DEVELOPER */
+
 #include <math.h>
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <utility>
 // #include <brick/numeric/utilities.hh>
+#include <brick/common/threadPool.hh>
 #include <brick/numeric/array2D.hh>
 #include <brick/numeric/test/arrayTestCommon.hh>
 #include <brick/test/functors.hh>
 
+#if BRICK_NUMERIC_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+namespace {
+
+  // Makes and discards shallow copies of a shared array, as a
+  // pipeline stage handing images to its successor would.
+  template <class Type>
+  class ShallowCopier {
+  public:
+    ShallowCopier(brick::numeric::Array2D<Type> const& source,
+                  size_t numberOfCopies)
+      : m_source(source), m_numberOfCopies(numberOfCopies) {}
+
+    void operator()(size_t /* taskIndex */) const {
+      brick::numeric::Array2D<Type> keeper;
+      for(size_t ii = 0; ii < m_numberOfCopies; ++ii) {
+        brick::numeric::Array2D<Type> copy0(m_source);
+        brick::numeric::Array2D<Type> copy1 = copy0;
+        if(ii % 3 == 0) {
+          keeper = copy1;
+        }
+      }
+    }
+
+  private:
+    brick::numeric::Array2D<Type> const& m_source;
+    size_t m_numberOfCopies;
+  };
+
+} // namespace
+
 namespace brick {
 
   namespace numeric {
@@ -91,6 +132,7 @@ namespace brick {
       void testConstructor__size_t__size_t__size_t();
       void testConstructor__string();
       void testConstructor__Array2D();
+      void testConstructor__Array2DMove();
       void testConstructor__size_t__size_t__TypePtr();
       void testDestructor();
       void testBegin();
@@ -117,11 +159,13 @@ namespace brick {
       void testRow();
       void testRowConst();
       void testRows();
+      void testSetReferenceCountThreadSafe();
       void testShape();
       void testShape__size_t();
       void testSize();
       void testTranspose();
       void testAssignmentOperator__Array2D();
+      void testAssignmentOperator__Array2DMove();
       void testAssignmentOperator__Type();
       void testApplicationOperator__size_t();
       void testApplicationOperatorConst__size_t();
@@ -134,9 +178,20 @@ namespace brick {
       void testInitializerList();
 
       // Tests of non-member functions.
+      void testExpression__assignment();
+      void testExpression__compound();
+      void testExpression__nonContiguous();
+      void testExpression__aliasing();
+      void testExpression__arrayInterface();
       void testSquareRoot__Array2D();
       void testSqrt__Array2D();
 
+#if BRICK_NUMERIC_DEVELOPER
+      // Benchmarks.
+      void timeExpression();
+      void timeReferenceCount();
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
 
     private:
 
@@ -183,6 +238,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__size_t__size_t);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__string);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__Array2D);
+      BRICK_TEST_REGISTER_MEMBER(testConstructor__Array2DMove);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__size_t__TypePtr);
       BRICK_TEST_REGISTER_MEMBER(testDestructor);
       BRICK_TEST_REGISTER_MEMBER(testBegin);
@@ -209,11 +265,13 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testRow);
       BRICK_TEST_REGISTER_MEMBER(testRowConst);
       BRICK_TEST_REGISTER_MEMBER(testRows);
+      BRICK_TEST_REGISTER_MEMBER(testSetReferenceCountThreadSafe);
       BRICK_TEST_REGISTER_MEMBER(testShape);
       BRICK_TEST_REGISTER_MEMBER(testShape__size_t);
       BRICK_TEST_REGISTER_MEMBER(testSize);
       BRICK_TEST_REGISTER_MEMBER(testTranspose);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array2D);
+      BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array2DMove);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Type);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperator__size_t);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperatorConst__size_t);
@@ -224,9 +282,19 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testInitializerList);
 
       // Tests of non-member functions.
+      BRICK_TEST_REGISTER_MEMBER(testExpression__assignment);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__compound);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__nonContiguous);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__aliasing);
+      BRICK_TEST_REGISTER_MEMBER(testExpression__arrayInterface);
       BRICK_TEST_REGISTER_MEMBER(testSquareRoot__Array2D);
       BRICK_TEST_REGISTER_MEMBER(testSqrt__Array2D);
 
+#if BRICK_NUMERIC_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeExpression);
+      BRICK_TEST_REGISTER_MEMBER(timeReferenceCount);
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
 
       // Set up fibonacci data for tests.
       m_fibonacciCArray = new Type[m_defaultArraySize];
@@ -428,6 +496,33 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testConstructor__Array2DMove()
+    {
+      // The move constructor should take over the data of its
+      // argument, leaving the argument empty.
+      Array2D<Type> array0(m_fibonacciString);
+      Type* dataPtr = array0.data();
+      Array2D<Type> array1(std::move(array0));
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(array1.columns() == m_defaultArrayColumns);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 1);
+      BRICK_TEST_ASSERT(!array0.isReferenceCounted());
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // The moved-from array must still be usable.
+      array0 = array1;
+      BRICK_TEST_ASSERT(array0.data() == dataPtr);
+    }
+
+
     template <class Type>
     void
     Array2DTest<Type>::
@@ -965,6 +1060,44 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testSetReferenceCountThreadSafe()
+    {
+      Array2D<Type> array0(
+        m_defaultArrayRows, m_defaultArrayColumns, m_fibonacciCArray);
+      array0.setReferenceCountThreadSafe();
+      BRICK_TEST_ASSERT(array0.getReferenceCount().isThreadSafe()
+                        == array0.isReferenceCounted());
+
+      Array2D<Type> array1(m_defaultArrayRows, m_defaultArrayColumns);
+      Array2D<Type> array2 = array1;
+      BRICK_TEST_ASSERT(
+        array1.getReferenceCount().isThreadSafe()
+        == (BRICK_COMMON_THREADSAFE_REFERENCECOUNT != 0));
+      array1.setReferenceCountThreadSafe();
+
+      // The setting is shared with every shallow copy.
+      BRICK_TEST_ASSERT(array2.getReferenceCount().isThreadSafe());
+      Array2D<Type> array3 = array2;
+      BRICK_TEST_ASSERT(array3.getReferenceCount().isThreadSafe());
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 3);
+      array2 = Array2D<Type>();
+      array3 = Array2D<Type>();
+
+      // Copies made and destroyed concurrently by several threads
+      // must leave the count exactly where it started.
+      common::ThreadPool threadPool(4);
+      threadPool.parallelFor(16, ShallowCopier<Type>(array1, 2000));
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 1);
+      BRICK_TEST_ASSERT(!array1.getReferenceCount().isShared());
+
+      array1.setReferenceCountThreadSafe(false);
+      BRICK_TEST_ASSERT(!array1.getReferenceCount().isThreadSafe());
+    }
+
+
     template <class Type>
     void
     Array2DTest<Type>::
@@ -1049,6 +1182,42 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testAssignmentOperator__Array2DMove()
+    {
+      // Move assignment releases the old data of the target, and
+      // takes over the data of the source.
+      Array2D<Type> array0(m_fibonacciString);
+      Array2D<Type> array2 = array0;
+      Type* dataPtr = array0.data();
+      Array2D<Type> array1(m_squaresString);
+      array1 = std::move(array0);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(array1.columns() == m_defaultArrayColumns);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(array1.getReferenceCount().getCount() == 2);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // Self-move must leave the array intact.
+      Array2D<Type>& alias = array1;
+      array1 = std::move(alias);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+
+      // Moving from a temporary.
+      array1 = Array2D<Type>(m_squaresString);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_squaresCArray));
+      BRICK_TEST_ASSERT(std::equal(array2.begin(), array2.end(),
+                                   m_fibonacciCArray));
+    }
+
+
     template <class Type>
     void
     Array2DTest<Type>::
@@ -1191,6 +1360,293 @@ namespace brick {
 
     // General test of square root is not performed, since square root
     // only makes sense for certain types.
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testExpression__assignment()
+    {
+      const Array2D<Type> array0(m_fibonacciString);
+      const Array2D<Type> array1(m_squaresString);
+      const Type two = static_cast<Type>(2);
+
+      // Assigning to an unshared array of the right shape should
+      // reuse its storage.
+      Array2D<Type> result(m_defaultArrayRows, m_defaultArrayColumns);
+      Type* dataPtr = result.data();
+      result = array0 * array1 + array1 * two;
+      BRICK_TEST_ASSERT(result.data() == dataPtr);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        BRICK_TEST_ASSERT(
+          result[index0] == (m_fibonacciCArray[index0]
+                             * m_squaresCArray[index0]
+                             + m_squaresCArray[index0] * two));
+      }
+
+      // The destination may appear in the expression.
+      result = result - array0 * array1;
+      BRICK_TEST_ASSERT(result.data() == dataPtr);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        BRICK_TEST_ASSERT(result[index0] == m_squaresCArray[index0] * two);
+      }
+
+      // Assigning to an array that shares its data must not modify
+      // the other arrays that point to the same data.
+      Array2D<Type> alias = result;
+      result = array0 + array1;
+      BRICK_TEST_ASSERT(result.data() != dataPtr);
+      BRICK_TEST_ASSERT(alias.data() == dataPtr);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        BRICK_TEST_ASSERT(alias[index0] == m_squaresCArray[index0] * two);
+        BRICK_TEST_ASSERT(
+          result[index0] == m_fibonacciCArray[index0] + m_squaresCArray[index0]);
+      }
+
+      // Assigning to an array of the wrong shape reallocates.
+      Array2D<Type> empty;
+      empty = two * array0 - array1 / two;
+      BRICK_TEST_ASSERT(empty.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(empty.columns() == m_defaultArrayColumns);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        BRICK_TEST_ASSERT(
+          empty[index0] == (two * m_fibonacciCArray[index0]
+                            - m_squaresCArray[index0] / two));
+      }
+
+      // copy() evaluates into existing storage.
+      Array2D<Type> target(m_defaultArrayRows, m_defaultArrayColumns);
+      dataPtr = target.data();
+      target.copy(array0 - array1);
+      BRICK_TEST_ASSERT(target.data() == dataPtr);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        BRICK_TEST_ASSERT(
+          target[index0] == m_fibonacciCArray[index0] - m_squaresCArray[index0]);
+      }
+    }
+
+
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testExpression__compound()
+    {
+      const Array2D<Type> array0(m_fibonacciString);
+      const Array2D<Type> array1(m_squaresString);
+      const Type one = static_cast<Type>(1);
+      const Type three = static_cast<Type>(3);
+
+      // A compound expression should give the same answer as the
+      // element-by-element computation.
+      const Array2D<Type> result =
+        (array0 + array1) * three - one / (array0 + one) + array1 / array0;
+      BRICK_TEST_ASSERT(result.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(result.columns() == m_defaultArrayColumns);
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        Type element0 = m_fibonacciCArray[index0];
+        Type element1 = m_squaresCArray[index0];
+        BRICK_TEST_ASSERT(
+          result[index0] == ((element0 + element1) * three
+                             - one / (element0 + one)
+                             + element1 / element0));
+      }
+
+      // Compound assignment operators accept expressions too.
+      Array2D<Type> accumulator = array1.copy();
+      accumulator += array0 * three;
+      accumulator -= array1 - array0;
+      accumulator *= array0 + one;
+      for(size_t index0 = 0; index0 < m_defaultArraySize; ++index0) {
+        Type element0 = m_fibonacciCArray[index0];
+        Type element1 = m_squaresCArray[index0];
+        BRICK_TEST_ASSERT(
+          accumulator[index0] == ((element1 + element0 * three
+                                   - (element1 - element0))
+                                  * (element0 + one)));
+      }
+
+      // Mismatched shapes should be caught as soon as the expression
+      // is built.
+      const Array2D<Type> transposed = array0.transpose();
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  array0 + array1 * transposed);
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  accumulator += transposed * three);
+    }
+
+
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testExpression__nonContiguous()
+    {
+      // Arrays with padding at the ends of their rows must be
+      // evaluated row by row.
+      const Array2D<Type> array0(m_fibonacciString);
+      Array2D<Type> padded(m_defaultArrayRows, m_defaultArrayColumns,
+                           m_defaultArrayColumns + 3);
+      std::fill(padded.data(), padded.data() + padded.getStorageSize(),
+                static_cast<Type>(0));
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          padded(row, column) = m_squaresCArray[
+            row * m_defaultArrayColumns + column];
+        }
+      }
+
+      Array2D<Type> result = array0 * padded + padded;
+      BRICK_TEST_ASSERT(result.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(result.columns() == m_defaultArrayColumns);
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          size_t index0 = row * m_defaultArrayColumns + column;
+          BRICK_TEST_ASSERT(
+            result(row, column) == (m_fibonacciCArray[index0]
+                                    * m_squaresCArray[index0]
+                                    + m_squaresCArray[index0]));
+        }
+      }
+
+      // Writing into the padded array must leave the padding alone.
+      Type* dataPtr = padded.data();
+      padded = array0 + padded;
+      BRICK_TEST_ASSERT(padded.data() == dataPtr);
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns + 3; ++column) {
+          size_t index0 = row * m_defaultArrayColumns + column;
+          Type expectedValue = static_cast<Type>(0);
+          if(column < m_defaultArrayColumns) {
+            expectedValue = m_fibonacciCArray[index0] + m_squaresCArray[index0];
+          }
+          BRICK_TEST_ASSERT(
+            dataPtr[row * (m_defaultArrayColumns + 3) + column]
+            == expectedValue);
+        }
+      }
+    }
+
+
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testExpression__aliasing()
+    {
+      // Arrays that view the same buffer at different offsets must
+      // give the same results as if each operation had been
+      // computed into its own temporary array.  Here the two views
+      // share a row step, but are offset by one column.
+      const size_t rowStep = m_defaultArrayColumns + 1;
+      const Array2D<Type> array1(m_squaresString);
+      Array2D<Type> reference(m_defaultArrayRows, rowStep);
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < rowStep; ++column) {
+          reference(row, column) = m_fibonacciCArray[
+            (row * rowStep + column) % m_defaultArraySize];
+        }
+      }
+      Array2D<Type> buffer = reference.copy();
+      Array2D<Type> left(m_defaultArrayRows, m_defaultArrayColumns,
+                         buffer.data(), rowStep);
+      Array2D<Type> right(m_defaultArrayRows, m_defaultArrayColumns,
+                          buffer.data() + 1, rowStep);
+      right += left * array1;
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        BRICK_TEST_ASSERT(buffer(row, 0) == reference(row, 0));
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          BRICK_TEST_ASSERT(
+            right(row, column) == (reference(row, column + 1)
+                                   + reference(row, column)
+                                   * array1(row, column)));
+        }
+      }
+
+      // Offsetting by a whole row should work, too.
+      buffer.copy(reference);
+      Array2D<Type> upper(m_defaultArrayRows - 1, m_defaultArrayColumns,
+                          buffer.data(), rowStep);
+      Array2D<Type> lower(m_defaultArrayRows - 1, m_defaultArrayColumns,
+                          buffer.data() + rowStep, rowStep);
+      lower.copy(upper - lower);
+      for(size_t row = 0; row + 1 < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          BRICK_TEST_ASSERT(
+            lower(row, column) == (reference(row, column)
+                                   - reference(row + 1, column)));
+        }
+      }
+    }
+
+
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    testExpression__arrayInterface()
+    {
+      // Expressions should support the read-only parts of the Array2D
+      // interface, as did the temporary arrays returned by the
+      // arithmetic operators before they became lazy.
+      const Array2D<Type> array0(m_fibonacciString);
+      const Array2D<Type> array1(m_squaresString);
+      const Array2D<Type> referenceArray = array0 + array1;
+      BRICK_TEST_ASSERT((array0 + array1).rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT((array0 + array1).columns() == m_defaultArrayColumns);
+      BRICK_TEST_ASSERT((array0 + array1).size() == m_defaultArraySize);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT((array0 + array1)[index] == referenceArray[index]);
+        BRICK_TEST_ASSERT((array0 + array1)(index) == referenceArray[index]);
+      }
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          BRICK_TEST_ASSERT((array0 + array1)(row, column)
+                            == referenceArray(row, column));
+        }
+      }
+
+      Array2D<Type> copiedArray = (array0 + array1).copy();
+      Array2D<Type> transposedArray = (array0 + array1).transpose();
+      BRICK_TEST_ASSERT(copiedArray.rows() == m_defaultArrayRows);
+      BRICK_TEST_ASSERT(copiedArray.columns() == m_defaultArrayColumns);
+      BRICK_TEST_ASSERT(transposedArray.rows() == m_defaultArrayColumns);
+      BRICK_TEST_ASSERT(transposedArray.columns() == m_defaultArrayRows);
+      for(size_t row = 0; row < m_defaultArrayRows; ++row) {
+        for(size_t column = 0; column < m_defaultArrayColumns; ++column) {
+          BRICK_TEST_ASSERT(copiedArray(row, column)
+                            == referenceArray(row, column));
+          BRICK_TEST_ASSERT(transposedArray(column, row)
+                            == referenceArray(row, column));
+        }
+      }
+
+      std::ostringstream expressionStream;
+      std::ostringstream referenceStream;
+      expressionStream << array0 + array1;
+      referenceStream << referenceArray;
+      BRICK_TEST_ASSERT(expressionStream.str() == referenceStream.str());
+
+      const Type zero = static_cast<Type>(0);
+      const Type threshold = array1[m_defaultArraySize / 2];
+      Array2D<bool> equalFlags = (array0 + array1) == referenceArray;
+      Array2D<bool> scalarEqualFlags = (array1 + zero) == threshold;
+      Array2D<bool> greaterFlags = (array1 + zero) > threshold;
+      Array2D<bool> greaterEqualFlags = (array1 + zero) >= threshold;
+      Array2D<bool> lessFlags = (array1 + zero) < threshold;
+      Array2D<bool> lessEqualFlags = (array1 + zero) <= threshold;
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        const Type value = array1[index];
+        BRICK_TEST_ASSERT(equalFlags[index]);
+        BRICK_TEST_ASSERT(scalarEqualFlags[index] == (value == threshold));
+        BRICK_TEST_ASSERT(greaterFlags[index] == (value > threshold));
+        BRICK_TEST_ASSERT(greaterEqualFlags[index] == (value >= threshold));
+        BRICK_TEST_ASSERT(lessFlags[index] == (value < threshold));
+        BRICK_TEST_ASSERT(lessEqualFlags[index] == (value <= threshold));
+      }
+
+      Array2D<Type> rootArray = sqrt(array1 + zero);
+      Array2D<Type> referenceRootArray = sqrt(array1);
+      for(size_t index = 0; index < m_defaultArraySize; ++index) {
+        BRICK_TEST_ASSERT(rootArray[index] == referenceRootArray[index]);
+      }
+    }
+
+
     template <class Type>
     void
     Array2DTest<Type>::
@@ -1263,6 +1719,93 @@ namespace brick {
       }
     }
 
+
+#if BRICK_NUMERIC_DEVELOPER
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    timeExpression()
+    {
+      const size_t rows = 1000;
+      const size_t columns = 1000;
+      const unsigned int iterations = 20;
+      Array2D<Type> array0(rows, columns);
+      Array2D<Type> array1(rows, columns);
+      Array2D<Type> array2(rows, columns);
+      for(size_t index0 = 0; index0 < array0.size(); ++index0) {
+        array0[index0] = static_cast<Type>(index0 % 7);
+        array1[index0] = static_cast<Type>(index0 % 11);
+        array2[index0] = static_cast<Type>(index0 % 13);
+      }
+      const Type two = static_cast<Type>(2);
+      Array2D<Type> result(rows, columns);
+
+      // Reference: the same computation with one temporary per
+      // operation, which is what the operators used to do.
+      double t0 = utilities::getCurrentTime();
+      for(unsigned int jj = 0; jj < iterations; ++jj) {
+        Array2D<Type> product0 = array0.copy();
+        product0 *= array1;
+        Array2D<Type> product1 = array2.copy();
+        product1 *= two;
+        Array2D<Type> sum0 = product0.copy();
+        sum0 += product1;
+        result = sum0;
+      }
+      double t1 = utilities::getCurrentTime();
+      for(unsigned int jj = 0; jj < iterations; ++jj) {
+        result = array0 * array1 + array2 * two;
+      }
+      double t2 = utilities::getCurrentTime();
+      std::cout << "\nAverage ET for " << rows << "x" << columns
+                << " array0 * array1 + array2 * 2, with temporaries: "
+                << (t1 - t0) / iterations
+                << ", fused: " << (t2 - t1) / iterations << std::endl;
+    }
+
+
+    template <class Type>
+    void
+    Array2DTest<Type>::
+    timeReferenceCount()
+    {
+      // Shallow copies are what get handed from one pipeline stage
+      // to the next, so this is the cost that thread-safe counting
+      // adds to every such handoff.
+      const unsigned int iterations = 10000000;
+      for(int pass = 0; pass < 2; ++pass) {
+        Array2D<Type> array0(480, 640);
+        array0.setReferenceCountThreadSafe(pass == 1);
+        Array2D<Type> array1;
+        double t0 = utilities::getCurrentTime();
+        for(unsigned int jj = 0; jj < iterations; ++jj) {
+          Array2D<Type> array2(array0);
+          array1 = array2;
+        }
+        double t1 = utilities::getCurrentTime();
+        std::cout << "\nAverage ET for copy construction plus assignment, "
+                  << (pass == 0 ? "plain" : "thread-safe") << " count: "
+                  << (t1 - t0) / iterations << std::endl;
+      }
+
+      // Contended case: all threads copy the same array.
+      for(int pass = 0; pass < 2; ++pass) {
+        Array2D<Type> array0(480, 640);
+        array0.setReferenceCountThreadSafe(true);
+        common::ThreadPool threadPool(pass == 0 ? 1 : 4);
+        double t0 = utilities::getCurrentTime();
+        threadPool.parallelFor(
+          threadPool.getNumberOfThreads(),
+          ShallowCopier<Type>(array0, iterations / 10));
+        double t1 = utilities::getCurrentTime();
+        std::cout << "ET for " << iterations / 10
+                  << " thread-safe copy pairs per thread, "
+                  << threadPool.getNumberOfThreads() << " thread(s): "
+                  << (t1 - t0) << std::endl;
+      }
+    }
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
   } // namespace numeric
 
 } // namespace brick
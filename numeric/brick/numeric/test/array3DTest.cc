@@ -13,6 +13,7 @@
 #include <math.h>
 #include <iomanip>
 #include <sstream>
+#include <utility>
 #include <brick/common/functional.hh>
 #include <brick/numeric/utilities.hh>
 #include <brick/numeric/array3D.hh>
@@ -90,6 +91,7 @@ namespace brick {
       void testConstructor__size_t__size_t__size_t();
       void testConstructor__string();
       void testConstructor__Array3D();
+      void testConstructor__Array3DMove();
       void testConstructor__size_t__size_t__size_t__TypePtr();
       void testDestructor();
       void testBegin();
@@ -118,6 +120,7 @@ namespace brick {
       void testSlice();
       void testSliceConst();
       void testAssignmentOperator__Array3D();
+      void testAssignmentOperator__Array3DMove();
       void testAssignmentOperator__Type();
       void testApplicationOperator__size_t();
       void testApplicationOperatorConst__size_t();
@@ -174,6 +177,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__size_t__size_t);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__string);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__Array3D);
+      BRICK_TEST_REGISTER_MEMBER(testConstructor__Array3DMove);
       BRICK_TEST_REGISTER_MEMBER(testConstructor__size_t__size_t__size_t__TypePtr);
       BRICK_TEST_REGISTER_MEMBER(testDestructor);
       BRICK_TEST_REGISTER_MEMBER(testBegin);
@@ -202,6 +206,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testSlice);
       BRICK_TEST_REGISTER_MEMBER(testSliceConst);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array3D);
+      BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Array3DMove);
       BRICK_TEST_REGISTER_MEMBER(testAssignmentOperator__Type);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperator__size_t);
       BRICK_TEST_REGISTER_MEMBER(testApplicationOperatorConst__size_t);
@@ -400,6 +405,32 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array3DTest<Type>::
+    testConstructor__Array3DMove()
+    {
+      // The move constructor should take over the data of its
+      // argument, leaving the argument empty.
+      Array3D<Type> array0(m_fibonacciString);
+      Type* dataPtr = array0.data();
+      Array3D<Type> array1(std::move(array0));
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.shape0() == m_defaultArrayShape0);
+      BRICK_TEST_ASSERT(array1.shape1() == m_defaultArrayShape1);
+      BRICK_TEST_ASSERT(array1.shape2() == m_defaultArrayShape2);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // The moved-from array must still be usable.
+      array0 = array1;
+      BRICK_TEST_ASSERT(array0.data() == dataPtr);
+    }
+
+
     template <class Type>
     void
     Array3DTest<Type>::
@@ -964,6 +995,42 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Array3DTest<Type>::
+    testAssignmentOperator__Array3DMove()
+    {
+      // Move assignment releases the old data of the target, and
+      // takes over the data of the source.
+      Array3D<Type> array0(m_fibonacciString);
+      Array3D<Type> array2 = array0;
+      Type* dataPtr = array0.data();
+      Array3D<Type> array1(m_squaresString);
+      array1 = std::move(array0);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+      BRICK_TEST_ASSERT(array1.shape0() == m_defaultArrayShape0);
+      BRICK_TEST_ASSERT(array1.shape1() == m_defaultArrayShape1);
+      BRICK_TEST_ASSERT(array1.shape2() == m_defaultArrayShape2);
+      BRICK_TEST_ASSERT(array1.size() == m_defaultArraySize);
+      BRICK_TEST_ASSERT(array0.size() == 0);
+      BRICK_TEST_ASSERT(array0.data() == 0);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_fibonacciCArray));
+
+      // Self-move must leave the array intact.
+      Array3D<Type>& alias = array1;
+      array1 = std::move(alias);
+      BRICK_TEST_ASSERT(array1.data() == dataPtr);
+
+      // Moving from a temporary.
+      array1 = Array3D<Type>(m_squaresString);
+      BRICK_TEST_ASSERT(std::equal(array1.begin(), array1.end(),
+                                   m_squaresCArray));
+      BRICK_TEST_ASSERT(std::equal(array2.begin(), array2.end(),
+                                   m_fibonacciCArray));
+    }
+
+
     template <class Type>
     void
     Array3DTest<Type>::
@@ -0,0 +1,307 @@
+/**
+***************************************************************************
+* @file brick/numeric/test/arrayAllocatorTest.cc
+*
+* Source file defining tests for the allocators declared in
+* brick/numeric/arrayAllocator.hh.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_NUMERIC_DEVELOPER
+#define BRICK_NUMERIC_DEVELOPER 0
+#endif /* #ifndef BRICK_NUMERIC_DEVELOPER */
+
+#include <brick/numeric/array1D.hh>
+#include <brick/numeric/array2D.hh>
+#include <brick/numeric/array3D.hh>
+#include <brick/numeric/arrayAllocator.hh>
+#include <brick/test/testFixture.hh>
+
+#if BRICK_NUMERIC_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+namespace {
+
+  // Forwards to the aligned allocator, keeping count of the blocks
+  // it has handed out.
+  class CountingArrayAllocator : public brick::numeric::ArrayAllocator {
+  public:
+    CountingArrayAllocator() : m_numberOfBlocks(0) {}
+
+    virtual void* allocate(size_t numberOfBytes) {
+      ++m_numberOfBlocks;
+      return brick::numeric::getAlignedArrayAllocator().allocate(
+        numberOfBytes);
+    }
+
+    virtual void deallocate(void* blockPtr, size_t numberOfBytes) {
+      --m_numberOfBlocks;
+      brick::numeric::getAlignedArrayAllocator().deallocate(
+        blockPtr, numberOfBytes);
+    }
+
+    int getNumberOfBlocks() const {return m_numberOfBlocks;}
+
+  private:
+    int m_numberOfBlocks;
+  };
+
+
+  // Keeps track of how many instances currently exist.
+  class CountedElement {
+  public:
+    CountedElement() : m_value(7) {++s_numberOfInstances;}
+    CountedElement(const CountedElement& other)
+      : m_value(other.m_value) {++s_numberOfInstances;}
+    ~CountedElement() {--s_numberOfInstances;}
+
+    int getValue() const {return m_value;}
+
+    static int s_numberOfInstances;
+
+  private:
+    int m_value;
+  };
+
+  int CountedElement::s_numberOfInstances = 0;
+
+
+  template <class Type>
+  bool
+  isAligned(const Type* dataPtr)
+  {
+    return (reinterpret_cast<size_t>(dataPtr)
+            % brick::numeric::arrayStorageAlignment) == 0;
+  }
+
+} // namespace
+
+
+namespace brick {
+
+  namespace numeric {
+
+    class ArrayAllocatorTest
+      : public brick::test::TestFixture<ArrayAllocatorTest> {
+
+    public:
+
+      ArrayAllocatorTest();
+      ~ArrayAllocatorTest() {}
+
+      void setUp(const std::string& /* testName */) {
+        setArrayAllocator(0);
+        PoolArrayAllocator::releaseThreadCache();
+      }
+      void tearDown(const std::string& /* testName */) {
+        setArrayAllocator(0);
+        PoolArrayAllocator::releaseThreadCache();
+      }
+
+      // Tests.
+      void testAlignment();
+      void testElementLifetime();
+      void testPoolArrayAllocator();
+      void testSetArrayAllocator();
+
+#if BRICK_NUMERIC_DEVELOPER
+      void timeAllocation();
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+    }; // class ArrayAllocatorTest
+
+
+    /* ============== Member Function Definititions ============== */
+
+    ArrayAllocatorTest::
+    ArrayAllocatorTest()
+      : brick::test::TestFixture<ArrayAllocatorTest>("ArrayAllocatorTest")
+    {
+      BRICK_TEST_REGISTER_MEMBER(testAlignment);
+      BRICK_TEST_REGISTER_MEMBER(testElementLifetime);
+      BRICK_TEST_REGISTER_MEMBER(testPoolArrayAllocator);
+      BRICK_TEST_REGISTER_MEMBER(testSetArrayAllocator);
+
+#if BRICK_NUMERIC_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeAllocation);
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+    }
+
+
+    void
+    ArrayAllocatorTest::
+    testAlignment()
+    {
+      for(int pass = 0; pass < 2; ++pass) {
+        if(pass == 1) {
+          setArrayAllocator(&getPoolArrayAllocator());
+        }
+        for(size_t size = 1; size < 300; size += 37) {
+          Array1D<char> array0(size);
+          Array2D<float> array1(size, 3);
+          Array3D<double> array2(2, size, 5);
+          BRICK_TEST_ASSERT(isAligned(array0.data()));
+          BRICK_TEST_ASSERT(isAligned(array1.data()));
+          BRICK_TEST_ASSERT(isAligned(array2.data()));
+        }
+      }
+    }
+
+
+    void
+    ArrayAllocatorTest::
+    testElementLifetime()
+    {
+      // Elements must be constructed and destroyed just as they
+      // would be by new[] and delete[], including when the last
+      // reference to the data is held by an array of a different
+      // dimensionality.
+      {
+        Array2D<CountedElement> array0(3, 4);
+        BRICK_TEST_ASSERT(CountedElement::s_numberOfInstances == 12);
+        BRICK_TEST_ASSERT(array0(2, 3).getValue() == 7);
+        Array1D<CountedElement> array1 = array0.ravel();
+        array0 = Array2D<CountedElement>();
+        BRICK_TEST_ASSERT(CountedElement::s_numberOfInstances == 12);
+      }
+      BRICK_TEST_ASSERT(CountedElement::s_numberOfInstances == 0);
+
+      {
+        Array3D<CountedElement> array0(2, 3, 4);
+        BRICK_TEST_ASSERT(CountedElement::s_numberOfInstances == 24);
+      }
+      BRICK_TEST_ASSERT(CountedElement::s_numberOfInstances == 0);
+    }
+
+
+    void
+    ArrayAllocatorTest::
+    testPoolArrayAllocator()
+    {
+      setArrayAllocator(&getPoolArrayAllocator());
+      BRICK_TEST_ASSERT(PoolArrayAllocator::getThreadCacheSize() == 0);
+
+      // A released buffer should be handed straight back to the next
+      // request of the same size class.
+      float* dataPtr = 0;
+      {
+        Array2D<float> frame(480, 640);
+        dataPtr = frame.data();
+      }
+      size_t cacheSize = PoolArrayAllocator::getThreadCacheSize();
+      BRICK_TEST_ASSERT(cacheSize >= 480 * 640 * sizeof(float));
+      BRICK_TEST_ASSERT(cacheSize <= 480 * 640 * sizeof(float) * 5 / 4 + 64);
+      {
+        Array2D<float> frame(480, 639);
+        BRICK_TEST_ASSERT(frame.data() == dataPtr);
+        BRICK_TEST_ASSERT(PoolArrayAllocator::getThreadCacheSize() == 0);
+      }
+
+      // Small and odd sized requests go to their own classes.
+      for(size_t size = 1; size < 5000; size = size * 3 + 1) {
+        Array1D<char> array0(size);
+        char* smallPtr = array0.data();
+        array0 = Array1D<char>();
+        Array1D<char> array1(size);
+        BRICK_TEST_ASSERT(array1.data() == smallPtr);
+      }
+
+      // Blocks should still be released correctly after the pool is
+      // no longer the current allocator.
+      Array1D<double> survivor(1000);
+      setArrayAllocator(0);
+      survivor = Array1D<double>(10);
+      BRICK_TEST_ASSERT(PoolArrayAllocator::getThreadCacheSize() > 0);
+      PoolArrayAllocator::releaseThreadCache();
+      BRICK_TEST_ASSERT(PoolArrayAllocator::getThreadCacheSize() == 0);
+    }
+
+
+    void
+    ArrayAllocatorTest::
+    testSetArrayAllocator()
+    {
+      BRICK_TEST_ASSERT(&getArrayAllocator() == &getAlignedArrayAllocator());
+
+      CountingArrayAllocator countingAllocator;
+      ArrayAllocator* previousPtr = setArrayAllocator(&countingAllocator);
+      BRICK_TEST_ASSERT(previousPtr == &getAlignedArrayAllocator());
+      BRICK_TEST_ASSERT(&getArrayAllocator() == &countingAllocator);
+      {
+        Array1D<int> array0(10);
+        Array2D<int> array1(3, 3);
+        Array2D<int> array2;
+        BRICK_TEST_ASSERT(countingAllocator.getNumberOfBlocks() == 2);
+
+        // Restoring the default must not strand the blocks that were
+        // allocated by countingAllocator.
+        previousPtr = setArrayAllocator(0);
+        BRICK_TEST_ASSERT(previousPtr == &countingAllocator);
+        array2 = Array2D<int>(4, 4);
+        BRICK_TEST_ASSERT(countingAllocator.getNumberOfBlocks() == 2);
+        array1 = array2;
+        BRICK_TEST_ASSERT(countingAllocator.getNumberOfBlocks() == 1);
+      }
+      BRICK_TEST_ASSERT(countingAllocator.getNumberOfBlocks() == 0);
+    }
+
+
+#if BRICK_NUMERIC_DEVELOPER
+
+    void
+    ArrayAllocatorTest::
+    timeAllocation()
+    {
+      // Simulates per-frame temporaries: a few full-size buffers are
+      // allocated, touched, and released for each frame.
+      const unsigned int iterations = 200;
+      for(int pass = 0; pass < 2; ++pass) {
+        setArrayAllocator(pass == 0 ? &getAlignedArrayAllocator()
+                          : &getPoolArrayAllocator());
+        double t0 = utilities::getCurrentTime();
+        for(unsigned int jj = 0; jj < iterations; ++jj) {
+          Array2D<float> frame0(1080, 1920);
+          Array2D<float> frame1(1080, 1920);
+          Array2D<common::UInt8> mask(1080, 1920);
+          frame0(jj % 1080, 0) = 1.0f;
+          frame1(jj % 1080, 1) = 1.0f;
+          mask(jj % 1080, 2) = 1;
+        }
+        double t1 = utilities::getCurrentTime();
+        std::cout << "\nAverage ET for three 1920x1080 temporaries, "
+                  << (pass == 0 ? "aligned" : "pool") << " allocator: "
+                  << (t1 - t0) / iterations << std::endl;
+      }
+    }
+
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+  } // namespace numeric
+
+} // namespace brick
+
+
+#if 0
+
+int main(int argc, char** argv)
+{
+  brick::numeric::ArrayAllocatorTest currentTest;
+  bool result = currentTest.run();
+  return (result ? 0 : 1);
+}
+
+#else
+
+namespace {
+
+  brick::numeric::ArrayAllocatorTest currentTest;
+
+}
+
+#endif
@@ -10,10 +10,21 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_NUMERIC_DEVELOPER
+#define BRICK_NUMERIC_DEVELOPER 0
+#endif /* #ifndef BRICK_NUMERIC_DEVELOPER */
+
+#include <limits>
 #include <brick/common/functional.hh>
+#include <brick/common/threadPool.hh>
 #include <brick/numeric/convolve2D.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_NUMERIC_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
 namespace brick {
 
   namespace numeric {
@@ -47,9 +58,27 @@ namespace brick {
       void testCorrelate2D_zeroPadSignal();
       void testCorrelate2D_reflectSignal();
       void testCorrelate2D_wrapSignal();
+      void testConvolve2D_parallel();
+      void testCorrelate2D_parallel();
+      void testConvolve2D_separable();
+      void testCorrelate2D_separable();
+      void testConvolve2D_fft();
+      void testCorrelate2D_fft();
+      void testCorrelate2D_method();
+      void testSeparateKernel2D();
+
+#if BRICK_NUMERIC_DEVELOPER
+      void timeCorrelate2D_parallel();
+      void timeCorrelate2D_separable();
+      void timeCorrelate2D_fft();
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
 
     private:
 
+      Array2D<Type> getLargeSignal(size_t rows, size_t columns);
+      Array2D<Type> getOuterProduct(const Array1D<Type>& columnKernel,
+				    const Array1D<Type>& rowKernel);
+
       template <class Type2>
       bool equivalent(const Array2D<Type2>& arg0,
 		      const Array2D<Type2>& arg1,
@@ -59,6 +88,7 @@ namespace brick {
       Array2D<Type> m_convolve2DKernel;
       Array2D<Type> m_correlate2DKernel;
       Type m_defaultTolerance;
+      Type m_fftTolerance;
       Type m_fillValue;
       Array2D<Type> m_signal;
       Array2D<Type> m_result_truncateResult;
@@ -89,6 +119,7 @@ namespace brick {
 			    " [0, 5, 1],"
 			    " [2, 4, 6]]"),
 	m_defaultTolerance(static_cast<Type>(1.0E-6)),
+	m_fftTolerance(static_cast<Type>(1.0E-2)),
 	m_fillValue(static_cast<Type>(3)),
 	m_signal("[[1, 2, 3, 4, 5, 6],"
 		 " [2, 3, 4, 5, 6, 7],"
@@ -179,6 +210,20 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_zeroPadSignal);
       BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_reflectSignal);
       BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_wrapSignal);
+      BRICK_TEST_REGISTER_MEMBER(testConvolve2D_parallel);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_parallel);
+      BRICK_TEST_REGISTER_MEMBER(testConvolve2D_separable);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_separable);
+      BRICK_TEST_REGISTER_MEMBER(testConvolve2D_fft);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_fft);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate2D_method);
+      BRICK_TEST_REGISTER_MEMBER(testSeparateKernel2D);
+
+#if BRICK_NUMERIC_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeCorrelate2D_parallel);
+      BRICK_TEST_REGISTER_MEMBER(timeCorrelate2D_separable);
+      BRICK_TEST_REGISTER_MEMBER(timeCorrelate2D_fft);
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
     }
 
 
@@ -342,6 +387,517 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testConvolve2D_parallel()
+    {
+      // Parallel results should exactly match serial results, so we
+      // use zero tolerance here.
+      Array2D<Type> signal = this->getLargeSignal(41, 23);
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t numberOfThreads = 1; numberOfThreads < 5; ++numberOfThreads) {
+	brick::common::ThreadPool threadPool(numberOfThreads);
+	for(size_t ii = 0; ii < 3; ++ii) {
+	  Array2D<Type> reference = convolve2D<Type, Type>(
+	    m_convolve2DKernel, signal, BRICK_CONVOLVE_PAD_RESULT, rois[ii],
+	    m_fillValue);
+	  Array2D<Type> result = convolve2D<Type, Type>(
+	    m_convolve2DKernel, signal, BRICK_CONVOLVE_PAD_RESULT, rois[ii],
+	    m_fillValue, threadPool);
+	  BRICK_TEST_ASSERT(
+	    this->equivalent(result, reference, static_cast<Type>(0)));
+
+	  reference = convolve2D<Type, Type>(
+	    m_convolve2DKernel, signal, BRICK_CONVOLVE_WRAP_SIGNAL, rois[ii]);
+	  result = convolve2D<Type, Type>(
+	    m_convolve2DKernel, signal, BRICK_CONVOLVE_WRAP_SIGNAL, rois[ii],
+	    threadPool);
+	  BRICK_TEST_ASSERT(
+	    this->equivalent(result, reference, static_cast<Type>(0)));
+	}
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testCorrelate2D_parallel()
+    {
+      // Parallel results should exactly match serial results, so we
+      // use zero tolerance here.
+      Array2D<Type> signal = this->getLargeSignal(41, 23);
+      ConvolutionStrategy strategies[] = {BRICK_CONVOLVE_TRUNCATE_RESULT,
+					  BRICK_CONVOLVE_PAD_RESULT,
+					  BRICK_CONVOLVE_PAD_SIGNAL,
+					  BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+					  BRICK_CONVOLVE_REFLECT_SIGNAL,
+					  BRICK_CONVOLVE_WRAP_SIGNAL};
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t numberOfThreads = 1; numberOfThreads < 5; ++numberOfThreads) {
+	brick::common::ThreadPool threadPool(numberOfThreads);
+	for(size_t ii = 0; ii < 6; ++ii) {
+	  for(size_t jj = 0; jj < 3; ++jj) {
+	    Array2D<Type> reference = correlate2D<Type, Type>(
+	      m_correlate2DKernel, signal, strategies[ii], rois[jj],
+	      m_fillValue);
+	    Array2D<Type> result = correlate2D<Type, Type>(
+	      m_correlate2DKernel, signal, strategies[ii], rois[jj],
+	      m_fillValue, threadPool);
+	    BRICK_TEST_ASSERT(
+	      this->equivalent(result, reference, static_cast<Type>(0)));
+
+	    if(strategies[ii] != BRICK_CONVOLVE_PAD_RESULT
+	       && strategies[ii] != BRICK_CONVOLVE_PAD_SIGNAL) {
+	      result = correlate2D<Type, Type>(
+		m_correlate2DKernel, signal, strategies[ii], rois[jj],
+		threadPool);
+	      BRICK_TEST_ASSERT(
+		this->equivalent(result, reference, static_cast<Type>(0)));
+	    }
+	  }
+	}
+
+	// Arbitrary corners, including some that extend off the edge
+	// of the signal.
+	Index2D corner0(-1, 2);
+	Index2D corner1(39, 25);
+	Array2D<Type> reference = correlate2D<Type, Type>(
+	  m_correlate2DKernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	  corner0, corner1);
+	Array2D<Type> result = correlate2D<Type, Type>(
+	  m_correlate2DKernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	  corner0, corner1, threadPool);
+	BRICK_TEST_ASSERT(
+	  this->equivalent(result, reference, static_cast<Type>(0)));
+
+	// Missing fill value should be reported just as for the
+	// serial version.
+	BRICK_TEST_ASSERT_EXCEPTION(
+	  brick::common::ValueException,
+	  (correlate2D<Type, Type>(m_correlate2DKernel, signal,
+				   BRICK_CONVOLVE_PAD_RESULT,
+				   BRICK_CONVOLVE_ROI_SAME, threadPool)));
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testConvolve2D_separable()
+    {
+      // All of the arithmetic is on small integers, so the
+      // separable results should exactly match the direct results,
+      // even for floating point types.
+      Array2D<Type> signal = this->getLargeSignal(19, 23);
+      Array1D<Type> columnKernel("[1, -2, 3]");
+      Array1D<Type> rowKernel("[2, 0, 1, 4, -1]");
+      Array2D<Type> kernel = this->getOuterProduct(columnKernel, rowKernel);
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t ii = 0; ii < 3; ++ii) {
+	Array2D<Type> reference = convolve2D<Type, Type>(
+	  kernel, signal, BRICK_CONVOLVE_PAD_RESULT, rois[ii], m_fillValue);
+	Array2D<Type> result = convolve2DSeparable<Type, Type>(
+	  rowKernel, columnKernel, signal, BRICK_CONVOLVE_PAD_RESULT, rois[ii],
+	  m_fillValue);
+	BRICK_TEST_ASSERT(
+	  this->equivalent(result, reference, static_cast<Type>(0)));
+
+	reference = convolve2D<Type, Type>(
+	  kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL, rois[ii]);
+	result = convolve2DSeparable<Type, Type>(
+	  rowKernel, columnKernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	  rois[ii]);
+	BRICK_TEST_ASSERT(
+	  this->equivalent(result, reference, static_cast<Type>(0)));
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testCorrelate2D_separable()
+    {
+      Array2D<Type> signal = this->getLargeSignal(19, 23);
+      Array1D<Type> columnKernel("[1, -2, 3]");
+      Array1D<Type> rowKernel("[2, 0, 1, 4, -1]");
+      Array2D<Type> kernel = this->getOuterProduct(columnKernel, rowKernel);
+      ConvolutionStrategy strategies[] = {BRICK_CONVOLVE_TRUNCATE_RESULT,
+					  BRICK_CONVOLVE_PAD_RESULT,
+					  BRICK_CONVOLVE_PAD_SIGNAL,
+					  BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+					  BRICK_CONVOLVE_REFLECT_SIGNAL,
+					  BRICK_CONVOLVE_WRAP_SIGNAL};
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t ii = 0; ii < 6; ++ii) {
+	for(size_t jj = 0; jj < 3; ++jj) {
+	  Array2D<Type> reference = correlate2D<Type, Type>(
+	    kernel, signal, strategies[ii], rois[jj], m_fillValue);
+	  Array2D<Type> result = correlate2DSeparable<Type, Type>(
+	    rowKernel, columnKernel, signal, strategies[ii], rois[jj],
+	    m_fillValue);
+	  BRICK_TEST_ASSERT(
+	    this->equivalent(result, reference, static_cast<Type>(0)));
+
+	  if(strategies[ii] != BRICK_CONVOLVE_PAD_RESULT
+	     && strategies[ii] != BRICK_CONVOLVE_PAD_SIGNAL) {
+	    result = correlate2DSeparable<Type, Type>(
+	      rowKernel, columnKernel, signal, strategies[ii], rois[jj]);
+	    BRICK_TEST_ASSERT(
+	      this->equivalent(result, reference, static_cast<Type>(0)));
+	  }
+	}
+      }
+
+      // Arbitrary corners within the ROI_FULL region.
+      Index2D corner0(-1, 1);
+      Index2D corner1(20, 24);
+      for(size_t ii = 2; ii < 6; ++ii) {
+	Array2D<Type> reference = correlate2D<Type, Type>(
+	  kernel, signal, strategies[ii], corner0, corner1, m_fillValue);
+	Array2D<Type> result = correlate2DSeparable<Type, Type>(
+	  rowKernel, columnKernel, signal, strategies[ii], corner0, corner1,
+	  m_fillValue);
+	BRICK_TEST_ASSERT(
+	  this->equivalent(result, reference, static_cast<Type>(0)));
+      }
+
+      // Argument checking should match correlate2D().
+      BRICK_TEST_ASSERT_EXCEPTION(
+	brick::common::ValueException,
+	(correlate2DSeparable<Type, Type>(rowKernel, columnKernel, signal,
+					  BRICK_CONVOLVE_PAD_SIGNAL,
+					  BRICK_CONVOLVE_ROI_SAME)));
+      Array1D<Type> evenKernel("[1, 2]");
+      BRICK_TEST_ASSERT_EXCEPTION(
+	brick::common::ValueException,
+	(correlate2DSeparable<Type, Type>(evenKernel, columnKernel, signal,
+					  BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+					  BRICK_CONVOLVE_ROI_SAME)));
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testConvolve2D_fft()
+    {
+      Array2D<Type> signal = this->getLargeSignal(19, 23);
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t jj = 0; jj < 3; ++jj) {
+	Array2D<Type> reference = convolve2D<Type, Type>(
+	  m_convolve2DKernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL, rois[jj]);
+	Array2D<Type> result = convolve2D<Type, Type>(
+	  m_convolve2DKernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL, rois[jj],
+	  BRICK_CONVOLVE_METHOD_FFT);
+	BRICK_TEST_ASSERT(this->equivalent(result, reference, m_fftTolerance));
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testCorrelate2D_fft()
+    {
+      // The FFT path should agree with the direct path for every
+      // strategy and ROI, and for kernels of various shapes.  Integer
+      // results are rounded, so should match exactly.
+      Array2D<Type> signal = this->getLargeSignal(19, 23);
+      Array2D<Type> kernels[] = {m_correlate2DKernel,
+				 this->getLargeSignal(9, 11),
+				 this->getLargeSignal(19, 1)};
+      ConvolutionStrategy strategies[] = {BRICK_CONVOLVE_TRUNCATE_RESULT,
+					  BRICK_CONVOLVE_PAD_RESULT,
+					  BRICK_CONVOLVE_PAD_SIGNAL,
+					  BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+					  BRICK_CONVOLVE_REFLECT_SIGNAL,
+					  BRICK_CONVOLVE_WRAP_SIGNAL};
+      ConvolutionROI rois[] = {BRICK_CONVOLVE_ROI_SAME,
+			       BRICK_CONVOLVE_ROI_VALID,
+			       BRICK_CONVOLVE_ROI_FULL};
+      for(size_t kk = 0; kk < 3; ++kk) {
+	for(size_t ii = 0; ii < 6; ++ii) {
+	  for(size_t jj = 0; jj < 3; ++jj) {
+	    Array2D<Type> reference = correlate2D<Type, Type>(
+	      kernels[kk], signal, strategies[ii], rois[jj], m_fillValue);
+	    Array2D<Type> result = correlate2D<Type, Type>(
+	      kernels[kk], signal, strategies[ii], rois[jj], m_fillValue,
+	      BRICK_CONVOLVE_METHOD_FFT);
+	    BRICK_TEST_ASSERT(
+	      this->equivalent(result, reference, m_fftTolerance));
+
+	    if(strategies[ii] != BRICK_CONVOLVE_PAD_RESULT
+	       && strategies[ii] != BRICK_CONVOLVE_PAD_SIGNAL) {
+	      result = correlate2D<Type, Type>(
+		kernels[kk], signal, strategies[ii], rois[jj],
+		BRICK_CONVOLVE_METHOD_FFT);
+	      BRICK_TEST_ASSERT(
+		this->equivalent(result, reference, m_fftTolerance));
+	    }
+	  }
+	}
+      }
+
+      // Arbitrary corners within the ROI_FULL region.
+      Index2D corner0(-1, 1);
+      Index2D corner1(20, 24);
+      for(size_t ii = 2; ii < 6; ++ii) {
+	Array2D<Type> reference = correlate2D<Type, Type>(
+	  m_correlate2DKernel, signal, strategies[ii], corner0, corner1,
+	  m_fillValue);
+	Array2D<Type> result = correlate2D<Type, Type>(
+	  m_correlate2DKernel, signal, strategies[ii], corner0, corner1,
+	  m_fillValue, BRICK_CONVOLVE_METHOD_FFT);
+	BRICK_TEST_ASSERT(this->equivalent(result, reference, m_fftTolerance));
+      }
+
+      // Argument checking should match the direct path.
+      Array2D<Type> evenKernel(4, 3);
+      evenKernel = static_cast<Type>(1);
+      BRICK_TEST_ASSERT_EXCEPTION(
+	brick::common::ValueException,
+	(correlate2D<Type, Type>(evenKernel, signal,
+				 BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+				 BRICK_CONVOLVE_ROI_SAME,
+				 BRICK_CONVOLVE_METHOD_FFT)));
+      BRICK_TEST_ASSERT_EXCEPTION(
+	brick::common::ValueException,
+	(correlate2D<Type, Type>(m_correlate2DKernel, signal,
+				 BRICK_CONVOLVE_PAD_SIGNAL,
+				 BRICK_CONVOLVE_ROI_SAME,
+				 BRICK_CONVOLVE_METHOD_FFT)));
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testCorrelate2D_method()
+    {
+      Array2D<Type> signal = this->getLargeSignal(19, 23);
+      Array1D<Type> columnKernel("[1, -2, 3, 0, 1]");
+      Array1D<Type> rowKernel("[2, 0, 1, 4, -1]");
+      Array2D<Type> separableKernel =
+	this->getOuterProduct(columnKernel, rowKernel);
+
+      // Both a separable and a non-separable kernel should give the
+      // same answer regardless of the selected method.  For floating
+      // point types, the factors of the separable kernel need not be
+      // integers, so we allow a little roundoff error.
+      Type tolerance = static_cast<Type>(1.0E-3);
+      Array2D<Type> kernels[] = {separableKernel, m_correlate2DKernel};
+      for(size_t ii = 0; ii < 2; ++ii) {
+	Array2D<Type> reference = correlate2D<Type, Type>(
+	  kernels[ii], signal, BRICK_CONVOLVE_WRAP_SIGNAL,
+	  BRICK_CONVOLVE_ROI_FULL);
+	Array2D<Type> result = correlate2D<Type, Type>(
+	  kernels[ii], signal, BRICK_CONVOLVE_WRAP_SIGNAL,
+	  BRICK_CONVOLVE_ROI_FULL, BRICK_CONVOLVE_METHOD_AUTO);
+	BRICK_TEST_ASSERT(this->equivalent(result, reference, tolerance));
+	result = correlate2D<Type, Type>(
+	  kernels[ii], signal, BRICK_CONVOLVE_WRAP_SIGNAL,
+	  BRICK_CONVOLVE_ROI_FULL, BRICK_CONVOLVE_METHOD_DIRECT);
+	BRICK_TEST_ASSERT(
+	  this->equivalent(result, reference, static_cast<Type>(0)));
+
+	reference = convolve2D<Type, Type>(
+	  kernels[ii], signal, BRICK_CONVOLVE_PAD_RESULT,
+	  BRICK_CONVOLVE_ROI_SAME, m_fillValue);
+	result = convolve2D<Type, Type>(
+	  kernels[ii], signal, BRICK_CONVOLVE_PAD_RESULT,
+	  BRICK_CONVOLVE_ROI_SAME, m_fillValue, BRICK_CONVOLVE_METHOD_AUTO);
+	BRICK_TEST_ASSERT(this->equivalent(result, reference, tolerance));
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    testSeparateKernel2D()
+    {
+      Array1D<Type> columnKernel;
+      Array1D<Type> rowKernel;
+
+      // A rank-1 kernel should be recovered exactly.
+      Array1D<Type> referenceColumn("[1, 2, 1]");
+      Array1D<Type> referenceRow("[-1, 0, 1, 3, 2]");
+      Array2D<Type> sobelLike =
+	this->getOuterProduct(referenceColumn, referenceRow);
+      BRICK_TEST_ASSERT(separateKernel2D(sobelLike, columnKernel, rowKernel));
+      BRICK_TEST_ASSERT(columnKernel.size() == referenceColumn.size());
+      BRICK_TEST_ASSERT(rowKernel.size() == referenceRow.size());
+      BRICK_TEST_ASSERT(
+	this->equivalent(this->getOuterProduct(columnKernel, rowKernel),
+			 sobelLike, static_cast<Type>(0)));
+
+      // Integer kernels should factor into integer kernels.
+      if(std::numeric_limits<Type>::is_integer) {
+	Type scale = columnKernel[0];
+	for(size_t ii = 0; ii < columnKernel.size(); ++ii) {
+	  BRICK_TEST_ASSERT(columnKernel[ii] == scale * referenceColumn[ii]);
+	}
+      }
+
+      // The test fixture's kernel is full rank, and the outputs
+      // should be left alone when separation fails.
+      Array1D<Type> columnCopy = columnKernel.copy();
+      BRICK_TEST_ASSERT(
+	!separateKernel2D(m_correlate2DKernel, columnKernel, rowKernel));
+      BRICK_TEST_ASSERT(columnKernel.size() == columnCopy.size());
+
+      // All-zero kernels are reported as non-separable.
+      Array2D<Type> zeroKernel(3, 3);
+      zeroKernel = static_cast<Type>(0);
+      BRICK_TEST_ASSERT(!separateKernel2D(zeroKernel, columnKernel, rowKernel));
+    }
+
+
+#if BRICK_NUMERIC_DEVELOPER
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    timeCorrelate2D_parallel()
+    {
+      unsigned int const iterations = 10;
+      Array2D<Type> signal = this->getLargeSignal(1000, 1000);
+      Array2D<Type> kernel(7, 7);
+      kernel = static_cast<Type>(1);
+
+      size_t maxThreads = brick::common::ThreadPool::getDefault()
+	.getNumberOfThreads();
+      double serialTime = 0.0;
+      for(size_t numberOfThreads = 1; numberOfThreads <= maxThreads;
+	  ++numberOfThreads) {
+	brick::common::ThreadPool threadPool(numberOfThreads);
+	double t0 = utilities::getCurrentTime();
+	for(unsigned int jj = 0; jj < iterations; ++jj) {
+	  correlate2D<Type, Type>(
+	    kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	    BRICK_CONVOLVE_ROI_SAME, threadPool);
+	}
+	double t1 = utilities::getCurrentTime();
+	double elapsedTime = (t1 - t0) / iterations;
+	if(numberOfThreads == 1) {
+	  serialTime = elapsedTime;
+	}
+	std::cout << "\nAverage ET for correlate2D() with " << numberOfThreads
+		  << " thread(s): " << elapsedTime << " (speedup "
+		  << serialTime / elapsedTime << ")" << std::endl;
+      }
+    }
+
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    timeCorrelate2D_separable()
+    {
+      unsigned int const iterations = 10;
+      Array2D<Type> signal = this->getLargeSignal(1000, 1000);
+      for(size_t kernelSize = 3; kernelSize < 16; kernelSize += 4) {
+	Array2D<Type> kernel(kernelSize, kernelSize);
+	kernel = static_cast<Type>(1);
+
+	double t0 = utilities::getCurrentTime();
+	for(unsigned int jj = 0; jj < iterations; ++jj) {
+	  correlate2D<Type, Type>(
+	    kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	    BRICK_CONVOLVE_ROI_SAME, BRICK_CONVOLVE_METHOD_DIRECT);
+	}
+	double t1 = utilities::getCurrentTime();
+	for(unsigned int jj = 0; jj < iterations; ++jj) {
+	  correlate2D<Type, Type>(
+	    kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	    BRICK_CONVOLVE_ROI_SAME, BRICK_CONVOLVE_METHOD_AUTO);
+	}
+	double t2 = utilities::getCurrentTime();
+	std::cout << "\nAverage ET for " << kernelSize << "x" << kernelSize
+		  << " correlate2D(), direct: " << (t1 - t0) / iterations
+		  << ", separable: " << (t2 - t1) / iterations << std::endl;
+      }
+    }
+
+    template <class Type>
+    void
+    Convolve2DTest<Type>::
+    timeCorrelate2D_fft()
+    {
+      unsigned int const iterations = 3;
+      Array2D<Type> signal = this->getLargeSignal(500, 500);
+      for(size_t kernelSize = 5; kernelSize < 40; kernelSize += 6) {
+	Array2D<Type> kernel = this->getLargeSignal(kernelSize, kernelSize);
+
+	double t0 = utilities::getCurrentTime();
+	for(unsigned int jj = 0; jj < iterations; ++jj) {
+	  correlate2D<Type, Type>(
+	    kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	    BRICK_CONVOLVE_ROI_SAME, BRICK_CONVOLVE_METHOD_DIRECT);
+	}
+	double t1 = utilities::getCurrentTime();
+	for(unsigned int jj = 0; jj < iterations; ++jj) {
+	  correlate2D<Type, Type>(
+	    kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL,
+	    BRICK_CONVOLVE_ROI_SAME, BRICK_CONVOLVE_METHOD_FFT);
+	}
+	double t2 = utilities::getCurrentTime();
+	bool isFFTSelected = privateCode::selectFFT(
+	  kernel, Index2D(0, 0), Index2D(500, 500),
+	  BRICK_CONVOLVE_METHOD_AUTO);
+	std::cout << "\nAverage ET for " << kernelSize << "x" << kernelSize
+		  << " correlate2D(), direct: " << (t1 - t0) / iterations
+		  << ", fft: " << (t2 - t1) / iterations
+		  << (isFFTSelected ? " (AUTO selects fft)" : "") << std::endl;
+      }
+    }
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+
+    template <class Type>
+    Array2D<Type>
+    Convolve2DTest<Type>::
+    getLargeSignal(size_t rows, size_t columns)
+    {
+      Array2D<Type> signal(rows, columns);
+      for(size_t rr = 0; rr < rows; ++rr) {
+	for(size_t cc = 0; cc < columns; ++cc) {
+	  signal(rr, cc) = static_cast<Type>((rr * 7 + cc * 13) % 17);
+	}
+      }
+      return signal;
+    }
+
+
+    template <class Type>
+    Array2D<Type>
+    Convolve2DTest<Type>::
+    getOuterProduct(const Array1D<Type>& columnKernel,
+		    const Array1D<Type>& rowKernel)
+    {
+      Array2D<Type> kernel(columnKernel.size(), rowKernel.size());
+      for(size_t rr = 0; rr < columnKernel.size(); ++rr) {
+	for(size_t cc = 0; cc < rowKernel.size(); ++cc) {
+	  kernel(rr, cc) = columnKernel[rr] * rowKernel[cc];
+	}
+      }
+      return kernel;
+    }
+
+
     template <class Type>
     template <class Type2>
     bool
@@ -10,13 +10,24 @@
 ***************************************************************************
 **/
 
+#ifndef BRICK_NUMERIC_DEVELOPER
+#define BRICK_NUMERIC_DEVELOPER 0
+#endif /* #ifndef BRICK_NUMERIC_DEVELOPER */
+
+#include <algorithm>
 #include <complex>
+#include <limits>
 
 #include <brick/common/functional.hh>
 #include <brick/numeric/fft.hh>
 #include <brick/numeric/numericTraits.hh>
 #include <brick/test/testFixture.hh>
 
+#if BRICK_NUMERIC_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
 namespace brick {
 
   namespace numeric {
@@ -33,12 +44,40 @@ namespace brick {
       void tearDown(const std::string& /* testName */) {}
 
       // Tests.
-      void testComputeFFT_radix2();
+      void testComputeFFT_arbitraryLength();
       void testComputeFFT_result();
       void testComputeFFT_singleFrequency();
+      void testComputeFFT2D();
+      void testComputeRealFFT();
+      void testFFTPlan_float();
+      void testFFTPlan_inverse();
+      void testFFTPlan_outOfPlace();
+      void testFFTPlan2D_inverse();
+      void testFFTPlan2D_padded();
+      void testRealFFTPlan_inverse();
+      void testGetEfficientFFTSize();
+
+#if BRICK_NUMERIC_DEVELOPER
+      void timeFFTPlan();
+      void timeFFTPlan2D();
+      void timeRealFFTPlan();
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
 
     private:
 
+      Array1D< std::complex<double> >
+      computeNaiveDFT(Array1D< std::complex<double> > const& inputSignal,
+                      bool isInverse = false);
+
+      Array1D< std::complex<double> >
+      getTestSignal(std::size_t signalLength);
+
+      Array2D< std::complex<double> >
+      getTestSignal2D(std::size_t rows, std::size_t columns);
+
+      double
+      getMaximumDifference(Array1D< std::complex<double> > const& arg0,
+                           Array1D< std::complex<double> > const& arg1);
 
 
       double m_defaultTolerance;
@@ -56,20 +95,46 @@ namespace brick {
         m_relaxedTolerance(1.0E-5)
     {
       // Register all tests.
-      BRICK_TEST_REGISTER_MEMBER(testComputeFFT_radix2);
+      BRICK_TEST_REGISTER_MEMBER(testComputeFFT_arbitraryLength);
       BRICK_TEST_REGISTER_MEMBER(testComputeFFT_result);
       BRICK_TEST_REGISTER_MEMBER(testComputeFFT_singleFrequency);
+      BRICK_TEST_REGISTER_MEMBER(testComputeFFT2D);
+      BRICK_TEST_REGISTER_MEMBER(testComputeRealFFT);
+      BRICK_TEST_REGISTER_MEMBER(testFFTPlan_float);
+      BRICK_TEST_REGISTER_MEMBER(testFFTPlan_inverse);
+      BRICK_TEST_REGISTER_MEMBER(testFFTPlan_outOfPlace);
+      BRICK_TEST_REGISTER_MEMBER(testFFTPlan2D_inverse);
+      BRICK_TEST_REGISTER_MEMBER(testFFTPlan2D_padded);
+      BRICK_TEST_REGISTER_MEMBER(testRealFFTPlan_inverse);
+      BRICK_TEST_REGISTER_MEMBER(testGetEfficientFFTSize);
+
+#if BRICK_NUMERIC_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeFFTPlan);
+      BRICK_TEST_REGISTER_MEMBER(timeFFTPlan2D);
+      BRICK_TEST_REGISTER_MEMBER(timeRealFFTPlan);
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
     }
 
 
     void
     FFTTest::
-    testComputeFFT_radix2()
+    testComputeFFT_arbitraryLength()
     {
-      Array1D< std::complex<double> > inputSignal(96);
-      inputSignal = 0.0;
-      BRICK_TEST_ASSERT_EXCEPTION(common::NotImplementedException,
-                                  computeFFT(inputSignal));
+      // Every length from 0 through 64 exercises each radix, their
+      // combinations, and Bluestein's algorithm for the rest.  The
+      // longer lengths include large primes and a mixed-radix size.
+      std::size_t const longLengths[] = {96, 97, 243, 625, 1000, 1009};
+      for(std::size_t ii = 0; ii < 65 + 6; ++ii) {
+        std::size_t signalLength = (ii < 65) ? ii : longLengths[ii - 65];
+        Array1D< std::complex<double> > inputSignal =
+          this->getTestSignal(signalLength);
+        Array1D< std::complex<double> > reference =
+          this->computeNaiveDFT(inputSignal);
+        Array1D< std::complex<double> > fft = computeFFT(inputSignal);
+        BRICK_TEST_ASSERT(fft.size() == signalLength);
+        BRICK_TEST_ASSERT(this->getMaximumDifference(fft, reference)
+                          < this->m_defaultTolerance * (signalLength + 1));
+      }
     }
 
 
@@ -266,6 +331,510 @@ namespace brick {
         }
       }
     }
+
+    void
+    FFTTest::
+    testComputeFFT2D()
+    {
+      // Compare with transforming each row and then each column
+      // using computeFFT().  Shapes include non-square, odd, prime,
+      // and degenerate cases, and sizes larger than the transpose
+      // block size.
+      std::size_t const shapes[][2] = {
+        {1, 1}, {1, 8}, {8, 1}, {4, 6}, {7, 5}, {17, 40}, {33, 64}};
+      for(std::size_t ii = 0; ii < 7; ++ii) {
+        std::size_t const rows = shapes[ii][0];
+        std::size_t const columns = shapes[ii][1];
+        Array2D< std::complex<double> > inputSignal =
+          this->getTestSignal2D(rows, columns);
+        Array2D< std::complex<double> > reference(rows, columns);
+        for(std::size_t row = 0; row < rows; ++row) {
+          Array1D< std::complex<double> > rowSignal =
+            computeFFT(inputSignal.getRow(row));
+          std::copy(rowSignal.begin(), rowSignal.end(),
+                    reference.rowBegin(row));
+        }
+        for(std::size_t column = 0; column < columns; ++column) {
+          Array1D< std::complex<double> > columnSignal(rows);
+          for(std::size_t row = 0; row < rows; ++row) {
+            columnSignal[row] = reference(row, column);
+          }
+          columnSignal = computeFFT(columnSignal);
+          for(std::size_t row = 0; row < rows; ++row) {
+            reference(row, column) = columnSignal[row];
+          }
+        }
+
+        Array2D< std::complex<double> > result = computeFFT2D(inputSignal);
+        BRICK_TEST_ASSERT(result.rows() == rows);
+        BRICK_TEST_ASSERT(result.columns() == columns);
+        BRICK_TEST_ASSERT(
+          this->getMaximumDifference(result.ravel(), reference.ravel())
+          < this->m_defaultTolerance * rows * columns);
+      }
+    }
+
+
+    void
+    FFTTest::
+    testComputeRealFFT()
+    {
+      // The half spectrum should match the complex transform, for
+      // both even and odd lengths.
+      std::size_t const lengths[] = {1, 2, 3, 8, 10, 15, 64, 97, 100, 1024};
+      for(std::size_t ii = 0; ii < 10; ++ii) {
+        std::size_t const signalLength = lengths[ii];
+        Array1D< std::complex<double> > complexSignal =
+          this->getTestSignal(signalLength);
+        Array1D<double> realSignal(signalLength);
+        for(std::size_t jj = 0; jj < signalLength; ++jj) {
+          realSignal[jj] = complexSignal[jj].real();
+          complexSignal[jj] = std::complex<double>(realSignal[jj], 0.0);
+        }
+        Array1D< std::complex<double> > reference = computeFFT(complexSignal);
+        Array1D< std::complex<double> > spectrum = computeRealFFT(realSignal);
+        BRICK_TEST_ASSERT(spectrum.size() == signalLength / 2 + 1);
+        for(std::size_t jj = 0; jj < spectrum.size(); ++jj) {
+          BRICK_TEST_ASSERT(std::abs(spectrum[jj] - reference[jj])
+                            < this->m_defaultTolerance * signalLength);
+        }
+      }
+      BRICK_TEST_ASSERT(computeRealFFT(Array1D<double>()).size() == 0);
+
+      // Single precision.
+      Array1D<float> floatSignal(60);
+      Array1D< std::complex<double> > complexSignal(60);
+      for(std::size_t jj = 0; jj < floatSignal.size(); ++jj) {
+        floatSignal[jj] = static_cast<float>((jj * 7) % 11) - 5.0f;
+        complexSignal[jj] = std::complex<double>(floatSignal[jj], 0.0);
+      }
+      Array1D< std::complex<double> > reference = computeFFT(complexSignal);
+      Array1D< std::complex<float> > floatSpectrum =
+        computeRealFFT(floatSignal);
+      for(std::size_t jj = 0; jj < floatSpectrum.size(); ++jj) {
+        std::complex<double> value(floatSpectrum[jj].real(),
+                                   floatSpectrum[jj].imag());
+        BRICK_TEST_ASSERT(std::abs(value - reference[jj])
+                          < this->m_relaxedTolerance * 60);
+      }
+    }
+
+
+
+    void
+    FFTTest::
+    testFFTPlan_float()
+    {
+      typedef std::complex<float> ComplexFloat;
+      std::size_t const lengths[] = {64, 60, 31};
+      for(std::size_t ii = 0; ii < 3; ++ii) {
+        Array1D< std::complex<double> > inputSignal =
+          this->getTestSignal(lengths[ii]);
+        Array1D< std::complex<double> > reference =
+          this->computeNaiveDFT(inputSignal);
+
+        Array1D<ComplexFloat> signal(lengths[ii]);
+        for(std::size_t jj = 0; jj < signal.size(); ++jj) {
+          signal[jj] = ComplexFloat(static_cast<float>(inputSignal[jj].real()),
+                                    static_cast<float>(inputSignal[jj].imag()));
+        }
+        FFTPlan<ComplexFloat> plan(lengths[ii]);
+        plan.execute(signal);
+        for(std::size_t jj = 0; jj < signal.size(); ++jj) {
+          std::complex<double> value(signal[jj].real(), signal[jj].imag());
+          BRICK_TEST_ASSERT(std::abs(value - reference[jj])
+                            < this->m_relaxedTolerance * lengths[ii]);
+        }
+      }
+    }
+
+
+    void
+    FFTTest::
+    testFFTPlan_inverse()
+    {
+      std::size_t const lengths[] = {1, 2, 45, 64, 97, 120, 1024};
+      for(std::size_t ii = 0; ii < 7; ++ii) {
+        std::size_t signalLength = lengths[ii];
+        Array1D< std::complex<double> > inputSignal =
+          this->getTestSignal(signalLength);
+        FFTPlan< std::complex<double> > forwardPlan(signalLength);
+        FFTPlan< std::complex<double> > inversePlan(signalLength, true);
+        BRICK_TEST_ASSERT(forwardPlan.getSize() == signalLength);
+        BRICK_TEST_ASSERT(!forwardPlan.isInverse());
+        BRICK_TEST_ASSERT(inversePlan.isInverse());
+
+        // The inverse plan should match the naive inverse DFT.
+        Array1D< std::complex<double> > signal = inputSignal.copy();
+        inversePlan.execute(signal);
+        BRICK_TEST_ASSERT(
+          this->getMaximumDifference(
+            signal, this->computeNaiveDFT(inputSignal, true))
+          < this->m_defaultTolerance * signalLength);
+
+        // Forward then inverse should reproduce the signal, scaled
+        // by signalLength.  Running the plans twice checks that no
+        // state leaks from one call to the next.
+        for(std::size_t jj = 0; jj < 2; ++jj) {
+          signal = inputSignal.copy();
+          forwardPlan.execute(signal);
+          inversePlan.execute(signal);
+          for(std::size_t kk = 0; kk < signalLength; ++kk) {
+            signal[kk] /= static_cast<double>(signalLength);
+          }
+          BRICK_TEST_ASSERT(this->getMaximumDifference(signal, inputSignal)
+                            < this->m_defaultTolerance);
+        }
+      }
+    }
+
+
+    void
+    FFTTest::
+    testFFTPlan_outOfPlace()
+    {
+      std::size_t const lengths[] = {64, 90, 53};
+      for(std::size_t ii = 0; ii < 3; ++ii) {
+        std::size_t signalLength = lengths[ii];
+        Array1D< std::complex<double> > inputSignal =
+          this->getTestSignal(signalLength);
+        Array1D< std::complex<double> > inputCopy = inputSignal.copy();
+        Array1D< std::complex<double> > reference =
+          this->computeNaiveDFT(inputSignal);
+
+        // Output into a separate buffer should leave the input
+        // unchanged, and should resize the output if necessary.
+        FFTPlan< std::complex<double> > plan(signalLength);
+        Array1D< std::complex<double> > outputSignal;
+        plan.execute(inputSignal, outputSignal);
+        BRICK_TEST_ASSERT(outputSignal.size() == signalLength);
+        BRICK_TEST_ASSERT(this->getMaximumDifference(outputSignal, reference)
+                          < this->m_defaultTolerance * signalLength);
+        BRICK_TEST_ASSERT(
+          this->getMaximumDifference(inputSignal, inputCopy) == 0.0);
+
+        // Output that aliases the input is handled as in-place.
+        Array1D< std::complex<double> > alias = inputSignal;
+        plan.execute(inputSignal, alias);
+        BRICK_TEST_ASSERT(this->getMaximumDifference(inputSignal, reference)
+                          < this->m_defaultTolerance * signalLength);
+
+        // Copies of a plan are independent.
+        FFTPlan< std::complex<double> > planCopy(plan);
+        Array1D< std::complex<double> > copyOutput(signalLength);
+        planCopy.execute(inputCopy, copyOutput);
+        BRICK_TEST_ASSERT(this->getMaximumDifference(copyOutput, reference)
+                          < this->m_defaultTolerance * signalLength);
+
+        Array1D< std::complex<double> > wrongSize(signalLength + 1);
+        BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                    plan.execute(wrongSize));
+      }
+    }
+
+
+    void
+    FFTTest::
+    testFFTPlan2D_inverse()
+    {
+      std::size_t const rows = 12;
+      std::size_t const columns = 35;
+      Array2D< std::complex<double> > inputSignal =
+        this->getTestSignal2D(rows, columns);
+      FFTPlan2D< std::complex<double> > forwardPlan(rows, columns);
+      FFTPlan2D< std::complex<double> > inversePlan(rows, columns, true);
+      BRICK_TEST_ASSERT(forwardPlan.getRows() == rows);
+      BRICK_TEST_ASSERT(forwardPlan.getColumns() == columns);
+      BRICK_TEST_ASSERT(!forwardPlan.isInverse());
+      BRICK_TEST_ASSERT(inversePlan.isInverse());
+
+      Array2D< std::complex<double> > spectrum;
+      forwardPlan.execute(inputSignal, spectrum);
+      BRICK_TEST_ASSERT(
+        this->getMaximumDifference(spectrum.ravel(),
+                                   computeFFT2D(inputSignal).ravel())
+        < this->m_defaultTolerance);
+      inversePlan.execute(spectrum);
+      spectrum /= std::complex<double>(static_cast<double>(rows * columns));
+      BRICK_TEST_ASSERT(
+        this->getMaximumDifference(spectrum.ravel(), inputSignal.ravel())
+        < this->m_defaultTolerance);
+
+      Array2D< std::complex<double> > wrongShape(columns, rows);
+      BRICK_TEST_ASSERT_EXCEPTION(common::ValueException,
+                                  forwardPlan.execute(wrongShape));
+    }
+
+
+    void
+    FFTTest::
+    testFFTPlan2D_padded()
+    {
+      // Input arrays with padding at the ends of their rows, such as
+      // those returned by getRegion(), should work both in place and
+      // out of place.
+      Array2D< std::complex<double> > fullSignal =
+        this->getTestSignal2D(15, 15);
+      Array2D< std::complex<double> > region =
+        fullSignal.getRegion(Index2D(1, 2), Index2D(13, 12));
+      BRICK_TEST_ASSERT(region.rows() == 12);
+      BRICK_TEST_ASSERT(region.columns() == 10);
+      BRICK_TEST_ASSERT(region.getRowStep() == 15);
+      Array2D< std::complex<double> > contiguousRegion(12, 10);
+      contiguousRegion.copy(region);
+      Array2D< std::complex<double> > referenceSpectrum =
+        computeFFT2D(contiguousRegion);
+
+      FFTPlan2D< std::complex<double> > plan(12, 10);
+      Array2D< std::complex<double> > spectrum;
+      plan.execute(region, spectrum);
+      BRICK_TEST_ASSERT(spectrum.rows() == 12);
+      BRICK_TEST_ASSERT(spectrum.columns() == 10);
+      BRICK_TEST_ASSERT(
+        this->getMaximumDifference(spectrum.ravel(),
+                                   referenceSpectrum.ravel())
+        < this->m_defaultTolerance);
+
+      Array2D< std::complex<double> > untouchedSignal = fullSignal.copy();
+      plan.execute(region);
+      contiguousRegion.copy(region);
+      BRICK_TEST_ASSERT(
+        this->getMaximumDifference(contiguousRegion.ravel(),
+                                   referenceSpectrum.ravel())
+        < this->m_defaultTolerance);
+      for(std::size_t row = 0; row < 15; ++row) {
+        for(std::size_t column = 0; column < 15; ++column) {
+          if(row < 1 || row >= 13 || column < 2 || column >= 12) {
+            BRICK_TEST_ASSERT(fullSignal(row, column)
+                              == untouchedSignal(row, column));
+          }
+        }
+      }
+    }
+
+
+    void
+    FFTTest::
+    testRealFFTPlan_inverse()
+    {
+      std::size_t const lengths[] = {1, 2, 9, 16, 30, 97};
+      for(std::size_t ii = 0; ii < 6; ++ii) {
+        std::size_t const signalLength = lengths[ii];
+        Array1D<double> inputSignal(signalLength);
+        for(std::size_t jj = 0; jj < signalLength; ++jj) {
+          inputSignal[jj] = double((jj * 5 + 2) % 7) - 3.0;
+        }
+        RealFFTPlan<double> plan(signalLength);
+        BRICK_TEST_ASSERT(plan.getSize() == signalLength);
+        BRICK_TEST_ASSERT(plan.getSpectrumSize() == signalLength / 2 + 1);
+
+        // Round trip twice, to check that no state leaks between
+        // calls.
+        for(std::size_t jj = 0; jj < 2; ++jj) {
+          Array1D< std::complex<double> > spectrum;
+          Array1D<double> outputSignal;
+          plan.execute(inputSignal, spectrum);
+          plan.execute(spectrum, outputSignal);
+          BRICK_TEST_ASSERT(outputSignal.size() == signalLength);
+          for(std::size_t kk = 0; kk < signalLength; ++kk) {
+            BRICK_TEST_ASSERT(
+              approximatelyEqual(outputSignal[kk] / signalLength,
+                                 inputSignal[kk], this->m_defaultTolerance));
+          }
+        }
+      }
+    }
+
+
+
+    void
+    FFTTest::
+    testGetEfficientFFTSize()
+    {
+      BRICK_TEST_ASSERT(getEfficientFFTSize(0) == 1);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(1) == 1);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(7) == 8);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(11) == 12);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(97) == 100);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(513) == 540);
+      BRICK_TEST_ASSERT(getEfficientFFTSize(1024) == 1024);
+      for(std::size_t ii = 2; ii < 2000; ++ii) {
+        std::size_t size = getEfficientFFTSize(ii);
+        BRICK_TEST_ASSERT(size >= ii);
+        while(size % 2 == 0) {size /= 2;}
+        while(size % 3 == 0) {size /= 3;}
+        while(size % 5 == 0) {size /= 5;}
+        BRICK_TEST_ASSERT(size == 1);
+      }
+    }
+
+
+#if BRICK_NUMERIC_DEVELOPER
+    void
+    FFTTest::
+    timeFFTPlan()
+    {
+      std::size_t const lengths[] = {1024, 1000, 1009, 4096};
+      for(std::size_t ii = 0; ii < 4; ++ii) {
+        std::size_t const iterations = 2000;
+        Array1D< std::complex<double> > signal =
+          this->getTestSignal(lengths[ii]);
+
+        double t0 = utilities::getCurrentTime();
+        for(std::size_t jj = 0; jj < iterations; ++jj) {
+          signal = computeFFT(signal);
+        }
+        double t1 = utilities::getCurrentTime();
+        FFTPlan< std::complex<double> > plan(lengths[ii]);
+        for(std::size_t jj = 0; jj < iterations; ++jj) {
+          plan.execute(signal);
+        }
+        double t2 = utilities::getCurrentTime();
+        std::cout << "\nAverage ET for length " << lengths[ii]
+                  << " FFT, computeFFT(): " << (t1 - t0) / iterations
+                  << ", FFTPlan::execute(): " << (t2 - t1) / iterations
+                  << std::endl;
+      }
+    }
+
+
+    void
+    FFTTest::
+    timeFFTPlan2D()
+    {
+      std::size_t const iterations = 10;
+      std::size_t const sizes[] = {512, 1000};
+      for(std::size_t ii = 0; ii < 2; ++ii) {
+        Array2D< std::complex<double> > signal =
+          this->getTestSignal2D(sizes[ii], sizes[ii]);
+
+        // For comparison, transform the columns by copying each one
+        // out individually.
+        FFTPlan< std::complex<double> > rowPlan(sizes[ii]);
+        Array1D< std::complex<double> > columnBuffer(sizes[ii]);
+        double t0 = utilities::getCurrentTime();
+        for(std::size_t jj = 0; jj < iterations; ++jj) {
+          for(std::size_t row = 0; row < signal.rows(); ++row) {
+            rowPlan.execute(signal.rowBegin(row));
+          }
+          for(std::size_t column = 0; column < signal.columns(); ++column) {
+            for(std::size_t row = 0; row < signal.rows(); ++row) {
+              columnBuffer[row] = signal(row, column);
+            }
+            rowPlan.execute(columnBuffer);
+            for(std::size_t row = 0; row < signal.rows(); ++row) {
+              signal(row, column) = columnBuffer[row];
+            }
+          }
+        }
+        double t1 = utilities::getCurrentTime();
+        FFTPlan2D< std::complex<double> > plan(sizes[ii], sizes[ii]);
+        for(std::size_t jj = 0; jj < iterations; ++jj) {
+          plan.execute(signal);
+        }
+        double t2 = utilities::getCurrentTime();
+        std::cout << "\nAverage ET for " << sizes[ii] << "x" << sizes[ii]
+                  << " 2D FFT, column-by-column: " << (t1 - t0) / iterations
+                  << ", FFTPlan2D::execute(): " << (t2 - t1) / iterations
+                  << std::endl;
+      }
+    }
+
+
+    void
+    FFTTest::
+    timeRealFFTPlan()
+    {
+      std::size_t const iterations = 2000;
+      std::size_t const signalLength = 4096;
+      Array1D< std::complex<double> > complexSignal =
+        this->getTestSignal(signalLength);
+      Array1D<double> realSignal(signalLength);
+      for(std::size_t ii = 0; ii < signalLength; ++ii) {
+        realSignal[ii] = complexSignal[ii].real();
+      }
+      Array1D< std::complex<double> > spectrum;
+
+      FFTPlan< std::complex<double> > complexPlan(signalLength);
+      double t0 = utilities::getCurrentTime();
+      for(std::size_t ii = 0; ii < iterations; ++ii) {
+        complexPlan.execute(complexSignal, spectrum);
+      }
+      double t1 = utilities::getCurrentTime();
+      RealFFTPlan<double> realPlan(signalLength);
+      for(std::size_t ii = 0; ii < iterations; ++ii) {
+        realPlan.execute(realSignal, spectrum);
+      }
+      double t2 = utilities::getCurrentTime();
+      std::cout << "\nAverage ET for length " << signalLength
+                << " FFT, complex: " << (t1 - t0) / iterations
+                << ", real: " << (t2 - t1) / iterations << std::endl;
+    }
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+
+    Array1D< std::complex<double> >
+    FFTTest::
+    computeNaiveDFT(Array1D< std::complex<double> > const& inputSignal,
+                    bool isInverse)
+    {
+      double const sign = isInverse ? 1.0 : -1.0;
+      std::size_t const signalLength = inputSignal.size();
+      Array1D< std::complex<double> > result(signalLength);
+      for(std::size_t kk = 0; kk < signalLength; ++kk) {
+        result[kk] = std::complex<double>(0.0, 0.0);
+        for(std::size_t nn = 0; nn < signalLength; ++nn) {
+          double theta = (sign * brick::common::constants::twoPi
+                          * double((kk * nn) % signalLength) / signalLength);
+          result[kk] += inputSignal[nn] * std::complex<double>(
+            brick::common::cosine(theta), brick::common::sine(theta));
+        }
+      }
+      return result;
+    }
+
+
+    Array1D< std::complex<double> >
+    FFTTest::
+    getTestSignal(std::size_t signalLength)
+    {
+      Array1D< std::complex<double> > signal(signalLength);
+      for(std::size_t ii = 0; ii < signalLength; ++ii) {
+        signal[ii] = std::complex<double>(
+          double((ii * 7 + 3) % 11) / 11.0 - 0.5,
+          double((ii * 5 + 1) % 13) / 13.0 - 0.5);
+      }
+      return signal;
+    }
+
+
+    Array2D< std::complex<double> >
+    FFTTest::
+    getTestSignal2D(std::size_t rows, std::size_t columns)
+    {
+      Array1D< std::complex<double> > flatSignal =
+        this->getTestSignal(rows * columns + 3);
+      Array2D< std::complex<double> > signal(rows, columns);
+      std::copy(flatSignal.begin() + 3, flatSignal.end(), signal.begin());
+      return signal;
+    }
+
+
+    double
+    FFTTest::
+    getMaximumDifference(Array1D< std::complex<double> > const& arg0,
+                         Array1D< std::complex<double> > const& arg1)
+    {
+      if(arg0.size() != arg1.size()) {
+        return std::numeric_limits<double>::max();
+      }
+      double maximumDifference = 0.0;
+      for(std::size_t ii = 0; ii < arg0.size(); ++ii) {
+        maximumDifference = std::max(maximumDifference,
+                                     std::abs(arg0[ii] - arg1[ii]));
+      }
+      return maximumDifference;
+    }
     
   } //  namespace numeric
 
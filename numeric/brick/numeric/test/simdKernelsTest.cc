@@ -0,0 +1,508 @@
+/**
+***************************************************************************
+* @file brick/numeric/test/simdKernelsTest.cc
+*
+* Source file defining tests for functions declared in
+* brick/numeric/simdKernels.hh.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_NUMERIC_DEVELOPER
+#define BRICK_NUMERIC_DEVELOPER 0
+#endif /* #ifndef BRICK_NUMERIC_DEVELOPER */
+
+#include <vector>
+#include <brick/numeric/convolve1D.hh>
+#include <brick/numeric/filter.hh>
+#include <brick/numeric/simdKernels.hh>
+#include <brick/test/testFixture.hh>
+
+#if BRICK_NUMERIC_DEVELOPER
+#include <iostream>
+#include <brick/utilities/timeUtilities.hh>
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+namespace brick {
+
+  namespace numeric {
+
+    class SimdKernelsTest
+      : public brick::test::TestFixture<SimdKernelsTest> {
+
+    public:
+
+      SimdKernelsTest();
+      ~SimdKernelsTest() {}
+
+      void setUp(const std::string& /* testName */) {
+        m_savedSimdLevel = getSimdLevel();
+      }
+      void tearDown(const std::string& /* testName */) {
+        setSimdLevel(m_savedSimdLevel);
+      }
+
+      // Tests.
+      void testSetSimdLevel();
+      void testCorrelateTaps_float();
+      void testCorrelateTaps_uint8();
+      void testCorrelate1D_float();
+      void testCorrelate1D_uint8();
+      void testFilterColumns_float();
+      void testFilterColumns_uint8();
+      void testFilterRows_float();
+      void testFilterRows_uint8();
+
+#if BRICK_NUMERIC_DEVELOPER
+      void timeFilterRows();
+      void timeFilterColumns();
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+    private:
+
+      template <class Type>
+      Array2D<Type>
+      getSignal(size_t rows, size_t columns);
+
+      template <class Type>
+      Array1D<Type>
+      getKernel(size_t size);
+
+      template <class Type>
+      bool
+      isEqual(const Array2D<Type>& array0, const Array2D<Type>& array1);
+
+      SimdLevel m_savedSimdLevel;
+
+    }; // class SimdKernelsTest
+
+
+    /* ============== Member Function Definititions ============== */
+
+    SimdKernelsTest::
+    SimdKernelsTest()
+      : brick::test::TestFixture<SimdKernelsTest>("SimdKernelsTest"),
+        m_savedSimdLevel(BRICK_SIMD_NONE)
+    {
+      BRICK_TEST_REGISTER_MEMBER(testSetSimdLevel);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelateTaps_float);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelateTaps_uint8);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate1D_float);
+      BRICK_TEST_REGISTER_MEMBER(testCorrelate1D_uint8);
+      BRICK_TEST_REGISTER_MEMBER(testFilterColumns_float);
+      BRICK_TEST_REGISTER_MEMBER(testFilterColumns_uint8);
+      BRICK_TEST_REGISTER_MEMBER(testFilterRows_float);
+      BRICK_TEST_REGISTER_MEMBER(testFilterRows_uint8);
+
+#if BRICK_NUMERIC_DEVELOPER
+      BRICK_TEST_REGISTER_MEMBER(timeFilterRows);
+      BRICK_TEST_REGISTER_MEMBER(timeFilterColumns);
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+    }
+
+
+    void
+    SimdKernelsTest::
+    testSetSimdLevel()
+    {
+      SimdLevel supportedLevel = getSupportedSimdLevel();
+      BRICK_TEST_ASSERT(setSimdLevel(BRICK_SIMD_NONE) == BRICK_SIMD_NONE);
+      BRICK_TEST_ASSERT(getSimdLevel() == BRICK_SIMD_NONE);
+
+      // Requests beyond what the hardware supports are clamped.
+      BRICK_TEST_ASSERT(setSimdLevel(BRICK_SIMD_AVX2) == supportedLevel);
+      BRICK_TEST_ASSERT(getSimdLevel() == supportedLevel);
+    }
+
+
+    void
+    SimdKernelsTest::
+    testCorrelateTaps_float()
+    {
+      // Every SimdLevel must give bit-for-bit identical results, so
+      // we compare against the scalar code with no tolerance.  Odd
+      // counts and strides exercise the leftover-element paths.
+      std::vector<common::Float32> input(4096);
+      for(size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<common::Float32>((ii * 37) % 101) / 7.0f - 5.0f;
+      }
+      Array1D<common::Float32> kernel = this->getKernel<common::Float32>(13);
+
+      for(size_t kernelSize = 1; kernelSize <= kernel.size(); kernelSize += 2) {
+        for(size_t count = 0; count < 70; count += 3) {
+          std::ptrdiff_t strides[] = {1, 5, 97};
+          for(size_t ss = 0; ss < 3; ++ss) {
+            std::vector<common::Float32> reference(count + 1, -1.0f);
+            setSimdLevel(BRICK_SIMD_NONE);
+            correlateTaps(&(reference[0]), &(input[0]), strides[ss],
+                          kernel.data(), kernelSize, count);
+
+            for(int level = BRICK_SIMD_SSE2; level <= BRICK_SIMD_AVX2;
+                ++level) {
+              std::vector<common::Float32> result(count + 1, -1.0f);
+              setSimdLevel(static_cast<SimdLevel>(level));
+              correlateTaps(&(result[0]), &(input[0]), strides[ss],
+                            kernel.data(), kernelSize, count);
+
+              // The trailing sentinel checks for overruns.
+              BRICK_TEST_ASSERT(result == reference);
+            }
+          }
+        }
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    testCorrelateTaps_uint8()
+    {
+      std::vector<common::UInt8> input(4096);
+      for(size_t ii = 0; ii < input.size(); ++ii) {
+        input[ii] = static_cast<common::UInt8>((ii * 97) % 256);
+      }
+
+      // Include a kernel that doesn't fit in 16 bits, which the SSE2
+      // code has to treat specially.
+      Array1D<common::Int32> smallKernel("[3, -1, 255, 7, -300, 12, 1]");
+      Array1D<common::Int32> largeKernel("[3, -1, 70000, 7, -300, 12, 1]");
+      Array1D<common::Int32> kernels[] = {smallKernel, largeKernel};
+
+      for(size_t kk = 0; kk < 2; ++kk) {
+        for(size_t count = 0; count < 70; count += 3) {
+          std::ptrdiff_t strides[] = {1, 5, 97};
+          for(size_t ss = 0; ss < 3; ++ss) {
+            std::vector<common::Int32> reference(count + 1, -1);
+            setSimdLevel(BRICK_SIMD_NONE);
+            correlateTaps(&(reference[0]), &(input[0]), strides[ss],
+                          kernels[kk].data(), kernels[kk].size(), count);
+
+            for(int level = BRICK_SIMD_SSE2; level <= BRICK_SIMD_AVX2;
+                ++level) {
+              std::vector<common::Int32> result(count + 1, -1);
+              setSimdLevel(static_cast<SimdLevel>(level));
+              correlateTaps(&(result[0]), &(input[0]), strides[ss],
+                            kernels[kk].data(), kernels[kk].size(), count);
+              BRICK_TEST_ASSERT(result == reference);
+            }
+          }
+        }
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    testCorrelate1D_float()
+    {
+      Array2D<common::Float32> signal2D =
+        this->getSignal<common::Float32>(1, 1000);
+      Array1D<common::Float32> signal(signal2D.columns(), signal2D.data());
+      Array1D<common::Float32> kernel = this->getKernel<common::Float32>(9);
+
+      setSimdLevel(BRICK_SIMD_NONE);
+      Array1D<common::Float32> reference = correlate1D<common::Float32>(
+        kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL, BRICK_CONVOLVE_ROI_SAME);
+
+      setSimdLevel(BRICK_SIMD_AVX2);
+      Array1D<common::Float32> result = correlate1D<common::Float32>(
+        kernel, signal, BRICK_CONVOLVE_REFLECT_SIGNAL, BRICK_CONVOLVE_ROI_SAME);
+
+      BRICK_TEST_ASSERT(result.size() == reference.size());
+      BRICK_TEST_ASSERT(
+        std::equal(result.begin(), result.end(), reference.begin()));
+    }
+
+
+    void
+    SimdKernelsTest::
+    testCorrelate1D_uint8()
+    {
+      Array2D<common::UInt8> signal2D =
+        this->getSignal<common::UInt8>(1, 1000);
+      Array1D<common::UInt8> signal(signal2D.columns(), signal2D.data());
+      Array1D<common::Int32> kernel = this->getKernel<common::Int32>(9);
+
+      // Compute a reference result with a type combination that has
+      // no vectorized implementation.
+      Array1D<common::Int32> wideSignal(signal.size());
+      std::copy(signal.begin(), signal.end(), wideSignal.begin());
+      Array1D<common::Int32> reference = correlate1D<common::Int32>(
+        kernel, wideSignal, BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+        BRICK_CONVOLVE_ROI_FULL);
+
+      Array1D<common::Int32> result = correlate1D<common::Int32>(
+        kernel, signal, BRICK_CONVOLVE_ZERO_PAD_SIGNAL,
+        BRICK_CONVOLVE_ROI_FULL);
+
+      BRICK_TEST_ASSERT(result.size() == reference.size());
+      BRICK_TEST_ASSERT(
+        std::equal(result.begin(), result.end(), reference.begin()));
+    }
+
+
+    void
+    SimdKernelsTest::
+    testFilterColumns_float()
+    {
+      for(size_t kernelSize = 1; kernelSize < 15; kernelSize += 2) {
+        Array2D<common::Float32> signal =
+          this->getSignal<common::Float32>(37, 53);
+        Array1D<common::Float32> kernel =
+          this->getKernel<common::Float32>(kernelSize);
+
+        setSimdLevel(BRICK_SIMD_NONE);
+        Array2D<common::Float32> reference(signal.rows(), signal.columns());
+        reference = 0.0f;
+        filterColumns(reference, signal, kernel);
+
+        setSimdLevel(BRICK_SIMD_AVX2);
+        Array2D<common::Float32> result(signal.rows(), signal.columns());
+        result = 0.0f;
+        filterColumns(result, signal, kernel);
+
+        BRICK_TEST_ASSERT(this->isEqual(result, reference));
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    testFilterColumns_uint8()
+    {
+      for(size_t kernelSize = 1; kernelSize < 15; kernelSize += 2) {
+        Array2D<common::UInt8> signal = this->getSignal<common::UInt8>(37, 53);
+        Array1D<common::Int32> kernel =
+          this->getKernel<common::Int32>(kernelSize);
+
+        // Reference is computed by hand, since the generic code path
+        // isn't reachable for this type combination.
+        Array2D<common::Int32> reference(signal.rows(), signal.columns());
+        reference = 0;
+        size_t offset = kernelSize / 2;
+        for(size_t rr = offset; rr < signal.rows() - offset; ++rr) {
+          for(size_t cc = 0; cc < signal.columns(); ++cc) {
+            common::Int32 element = 0;
+            for(size_t ii = 0; ii < kernelSize; ++ii) {
+              element += kernel[ii] * signal(rr + ii - offset, cc);
+            }
+            reference(rr, cc) = element;
+          }
+        }
+
+        Array2D<common::Int32> result(signal.rows(), signal.columns());
+        result = 0;
+        filterColumns(result, signal, kernel);
+
+        BRICK_TEST_ASSERT(this->isEqual(result, reference));
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    testFilterRows_float()
+    {
+      for(size_t kernelSize = 1; kernelSize < 15; kernelSize += 2) {
+        Array2D<common::Float32> signal =
+          this->getSignal<common::Float32>(37, 53);
+        Array1D<common::Float32> kernel =
+          this->getKernel<common::Float32>(kernelSize);
+
+        setSimdLevel(BRICK_SIMD_NONE);
+        Array2D<common::Float32> reference(signal.rows(), signal.columns());
+        reference = 0.0f;
+        filterRows(reference, signal, kernel);
+
+        setSimdLevel(BRICK_SIMD_AVX2);
+        Array2D<common::Float32> result(signal.rows(), signal.columns());
+        result = 0.0f;
+        filterRows(result, signal, kernel);
+
+        BRICK_TEST_ASSERT(this->isEqual(result, reference));
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    testFilterRows_uint8()
+    {
+      for(size_t kernelSize = 1; kernelSize < 15; kernelSize += 2) {
+        Array2D<common::UInt8> signal = this->getSignal<common::UInt8>(37, 53);
+        Array1D<common::Int32> kernel =
+          this->getKernel<common::Int32>(kernelSize);
+
+        Array2D<common::Int32> reference(signal.rows(), signal.columns());
+        reference = 0;
+        size_t offset = kernelSize / 2;
+        for(size_t rr = 0; rr < signal.rows(); ++rr) {
+          for(size_t cc = offset; cc < signal.columns() - offset; ++cc) {
+            common::Int32 element = 0;
+            for(size_t ii = 0; ii < kernelSize; ++ii) {
+              element += kernel[ii] * signal(rr, cc + ii - offset);
+            }
+            reference(rr, cc) = element;
+          }
+        }
+
+        Array2D<common::Int32> result(signal.rows(), signal.columns());
+        result = 0;
+        filterRows(result, signal, kernel);
+
+        BRICK_TEST_ASSERT(this->isEqual(result, reference));
+      }
+    }
+
+
+#if BRICK_NUMERIC_DEVELOPER
+
+    void
+    SimdKernelsTest::
+    timeFilterRows()
+    {
+      unsigned int const iterations = 100;
+      Array2D<common::Float32> signalF = this->getSignal<common::Float32>(
+        480, 640);
+      Array2D<common::UInt8> signalU = this->getSignal<common::UInt8>(
+        480, 640);
+      Array2D<common::Float32> resultF(signalF.rows(), signalF.columns());
+      Array2D<common::Int32> resultU(signalU.rows(), signalU.columns());
+
+      for(int level = BRICK_SIMD_NONE; level <= getSupportedSimdLevel();
+          ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        for(size_t kernelSize = 3; kernelSize < 15; kernelSize += 4) {
+          Array1D<common::Float32> kernelF =
+            this->getKernel<common::Float32>(kernelSize);
+          Array1D<common::Int32> kernelU =
+            this->getKernel<common::Int32>(kernelSize);
+
+          double t0 = utilities::getCurrentTime();
+          for(unsigned int jj = 0; jj < iterations; ++jj) {
+            filterRows(resultF, signalF, kernelF);
+          }
+          double t1 = utilities::getCurrentTime();
+          for(unsigned int jj = 0; jj < iterations; ++jj) {
+            filterRows(resultU, signalU, kernelU);
+          }
+          double t2 = utilities::getCurrentTime();
+
+          std::cout << "\nAverage ET for filterRows() at SIMD level " << level
+                    << ", kernel size " << kernelSize
+                    << ": float " << (t1 - t0) / iterations
+                    << ", uint8 " << (t2 - t1) / iterations << std::endl;
+        }
+      }
+    }
+
+
+    void
+    SimdKernelsTest::
+    timeFilterColumns()
+    {
+      unsigned int const iterations = 100;
+      Array2D<common::Float32> signalF = this->getSignal<common::Float32>(
+        480, 640);
+      Array2D<common::UInt8> signalU = this->getSignal<common::UInt8>(
+        480, 640);
+      Array2D<common::Float32> resultF(signalF.rows(), signalF.columns());
+      Array2D<common::Int32> resultU(signalU.rows(), signalU.columns());
+
+      for(int level = BRICK_SIMD_NONE; level <= getSupportedSimdLevel();
+          ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        for(size_t kernelSize = 3; kernelSize < 15; kernelSize += 4) {
+          Array1D<common::Float32> kernelF =
+            this->getKernel<common::Float32>(kernelSize);
+          Array1D<common::Int32> kernelU =
+            this->getKernel<common::Int32>(kernelSize);
+
+          double t0 = utilities::getCurrentTime();
+          for(unsigned int jj = 0; jj < iterations; ++jj) {
+            filterColumns(resultF, signalF, kernelF);
+          }
+          double t1 = utilities::getCurrentTime();
+          for(unsigned int jj = 0; jj < iterations; ++jj) {
+            filterColumns(resultU, signalU, kernelU);
+          }
+          double t2 = utilities::getCurrentTime();
+
+          std::cout << "\nAverage ET for filterColumns() at SIMD level "
+                    << level << ", kernel size " << kernelSize
+                    << ": float " << (t1 - t0) / iterations
+                    << ", uint8 " << (t2 - t1) / iterations << std::endl;
+        }
+      }
+    }
+
+#endif /* #if BRICK_NUMERIC_DEVELOPER */
+
+
+    template <class Type>
+    Array2D<Type>
+    SimdKernelsTest::
+    getSignal(size_t rows, size_t columns)
+    {
+      Array2D<Type> signal(rows, columns);
+      for(size_t rr = 0; rr < rows; ++rr) {
+        for(size_t cc = 0; cc < columns; ++cc) {
+          signal(rr, cc) = static_cast<Type>((rr * 31 + cc * 17) % 251);
+        }
+      }
+      return signal;
+    }
+
+
+    template <class Type>
+    Array1D<Type>
+    SimdKernelsTest::
+    getKernel(size_t size)
+    {
+      Array1D<Type> source("[2, -1, 8, 5, 3, 0, -2, 10, 1, 1, 4, -5, 1, 6]");
+      Array1D<Type> kernel(size);
+      std::copy(source.begin(), source.begin() + size, kernel.begin());
+      return kernel;
+    }
+
+
+    template <class Type>
+    bool
+    SimdKernelsTest::
+    isEqual(const Array2D<Type>& array0, const Array2D<Type>& array1)
+    {
+      if(array0.rows() != array1.rows()) {
+        return false;
+      }
+      if(array0.columns() != array1.columns()) {
+        return false;
+      }
+      return std::equal(array0.begin(), array0.end(), array1.begin());
+    }
+
+  } // namespace numeric
+
+} // namespace brick
+
+
+#if 0
+
+int main(int argc, char** argv)
+{
+  brick::numeric::SimdKernelsTest currentTest;
+  bool result = currentTest.run();
+  return (result ? 0 : 1);
+}
+
+#else
+
+namespace {
+
+  brick::numeric::SimdKernelsTest currentTest;
+
+}
+
+#endif
@@ -58,6 +58,7 @@ namespace brick {
       void testCompress0();
       void testCompress1();
       void testCount();
+      void testExpressionOverloads();
       void testGetCentroid();
       void testGetMeanAndCovariance();
       void testMaximum();
@@ -121,6 +122,7 @@ namespace brick {
       BRICK_TEST_REGISTER_MEMBER(testCompress0);
       BRICK_TEST_REGISTER_MEMBER(testCompress1);
       BRICK_TEST_REGISTER_MEMBER(testCount);
+      BRICK_TEST_REGISTER_MEMBER(testExpressionOverloads);
       BRICK_TEST_REGISTER_MEMBER(testGetCentroid);
       BRICK_TEST_REGISTER_MEMBER(testGetMeanAndCovariance);
       BRICK_TEST_REGISTER_MEMBER(testMaximum);
@@ -556,6 +558,103 @@ namespace brick {
     }
 
 
+    template <class Type>
+    void
+    UtilitiesTest<Type>::
+    testExpressionOverloads()
+    {
+      // Functions that deduce their element type from Array arguments
+      // should also accept elementwise arithmetic expressions, giving
+      // the same answer as if the expression had been evaluated first.
+      Array1D<Type> array0("[3, -1, 4, 1, -5, 9]");
+      Array1D<Type> array1("[2, 7, -1, 8, 2, 8]");
+      Array1D<Type> array2("[1, 4, 1, 4, 2, 1]");
+      Array2D<Type> matrix0("[[-2, -1, -10],"
+                            " [5, 2, 3],"
+                            " [10, 0, -2],"
+                            " [1, 2, 2]]");
+      Array2D<Type> matrix1("[[1, 0, 4],"
+                            " [2, 3, -1],"
+                            " [0, 0, 1],"
+                            " [5, 1, 1]]");
+      Array1D<Type> vector0("[1, -2, 3]");
+      Array1D<Type> vector1("[2, 0, 1]");
+      Array1D<Type> vector2("[1, 2, 0, -1]");
+      Array1D<Type> vector3("[0, 1, 1, 3]");
+      Array1D<Type> difference = array0 - array1;
+      Array1D<Type> total = array0 + array1;
+      Array2D<Type> matrixSum = matrix0 + matrix1;
+      const Type tolerance = static_cast<Type>(m_defaultTolerance);
+
+      BRICK_TEST_ASSERT(
+        dot<double>(array0 - array1, array2)
+        == dot<double>(difference, array2));
+      BRICK_TEST_ASSERT(
+        dot<double>(array2, array0 - array1)
+        == dot<double>(array2, difference));
+      BRICK_TEST_ASSERT(
+        magnitude<double>(array0 - array1) == magnitude<double>(difference));
+      BRICK_TEST_ASSERT(
+        magnitudeSquared<double>(array0 - array1)
+        == magnitudeSquared<double>(difference));
+      BRICK_TEST_ASSERT(
+        sum<double>(array0 + array1) == sum<double>(total));
+      BRICK_TEST_ASSERT(
+        mean<double>(array0 + array1) == mean<double>(total));
+      BRICK_TEST_ASSERT(
+        rms<double>(array0 + array1) == rms<double>(total));
+      BRICK_TEST_ASSERT(
+        (variance<Type, double>(array0 + array1)
+         == variance<Type, double>(total)));
+      BRICK_TEST_ASSERT(maximum(array0 + array1) == maximum(total));
+      BRICK_TEST_ASSERT(minimum(array0 + array1) == minimum(total));
+      BRICK_TEST_ASSERT(argmax(array0 - array1) == argmax(difference));
+      BRICK_TEST_ASSERT(argmin(array0 - array1) == argmin(difference));
+      BRICK_TEST_ASSERT(
+        equivalent(abs(array0 - array1), abs(difference), tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(argsort(array0 - array1), argsort(difference),
+                   static_cast<size_t>(0)));
+      BRICK_TEST_ASSERT(
+        equivalent(outerProduct<Type>(array0 - array1, array2),
+                   outerProduct<Type>(difference, array2), tolerance));
+
+      BRICK_TEST_ASSERT(maximum(matrix0 + matrix1) == maximum(matrixSum));
+      BRICK_TEST_ASSERT(
+        argmax2D(matrix0 + matrix1) == argmax2D(matrixSum));
+      BRICK_TEST_ASSERT(
+        argmin2D(matrix0 + matrix1) == argmin2D(matrixSum));
+      BRICK_TEST_ASSERT(
+        sum<double>(matrix0 + matrix1, Index2D(2, 1), Index2D(4, 3))
+        == sum<double>(matrixSum, Index2D(2, 1), Index2D(4, 3)));
+      BRICK_TEST_ASSERT(
+        equivalent(abs(matrix0 + matrix1), abs(matrixSum), tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(axisSum<Type>(matrix0 + matrix1, 0),
+                   axisSum<Type>(matrixSum, 0), tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(axisMaximum(matrix0 + matrix1, 1),
+                   axisMaximum(matrixSum, 1), tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(axisMinimum(matrix0 + matrix1, 1),
+                   axisMinimum(matrixSum, 1), tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(matrixMultiply<Type>((matrix0 + matrix1).transpose(),
+                                        matrix0 - matrix1),
+                   matrixMultiply<Type>(matrixSum.transpose(),
+                                        matrix0 - matrix1),
+                   tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(matrixMultiply<Type>(matrix0 + matrix1, vector0 - vector1),
+                   matrixMultiply<Type>(matrixSum, vector0 - vector1),
+                   tolerance));
+      BRICK_TEST_ASSERT(
+        equivalent(matrixMultiply<Type>(vector2 + vector3, matrix0 + matrix1),
+                   matrixMultiply<Type>(vector2 + vector3, matrixSum),
+                   tolerance));
+    }
+
+
     template <class Type>
     void
     UtilitiesTest<Type>::
@@ -41,6 +41,16 @@ namespace brick {
     abs(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to abs(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    Array1D<Type>
+    abs(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns an array of the same size and element type
      * as its input argument, in which each element is set to the
@@ -58,6 +68,16 @@ namespace brick {
     abs(Array2D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to abs(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    Array2D<Type>
+    abs(Array2DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns true if each element of its argument is
      * false, and returns false otherwise.
@@ -129,6 +149,16 @@ namespace brick {
     argmax(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to argmax(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline size_t
+    argmax(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns the index of the largest element of its input
      * sequence.  This function is equivalent to the quantity
@@ -216,6 +246,16 @@ namespace brick {
     argmax2D(Array2D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to argmax2D(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Index2D
+    argmax2D(Array2DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns an Index2D instance indicating which is
      * the largest element of its input array, where largeness is
@@ -254,6 +294,16 @@ namespace brick {
     argmin(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to argmin(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline size_t
+    argmin(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns the index of the smallest element of its
      * input array, where smallness is defined by the second argument.
@@ -290,6 +340,16 @@ namespace brick {
     argmin2D(Array2D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to argmin2D(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Index2D
+    argmin2D(Array2DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns an Index2D instance indicating which is
      * the smallest element of its input array, where smallness is
@@ -327,6 +387,16 @@ namespace brick {
     argsort(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to argsort(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    Array1D<size_t>
+    argsort(Array1DExpression<Type, Derived> const& array0);
+
+
 //   /**
 //    * This function returns an array of indices, result, so that the
 //    * sequence (array0[result[0]], array0[result[1]],
@@ -381,6 +451,17 @@ namespace brick {
     inline Array1D<Type>
     axisMaximum(Array2D<Type> const& array0, size_t axis);
 
+
+    /**
+     * This function is equivalent to axisMaximum(), above, except that
+     * it accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Array1D<Type>
+    axisMaximum(Array2DExpression<Type, Derived> const& array0,
+                size_t axis);
+
     /**
      * This function returns an Array1D in which each element has the
      * value of the largest element in one row or column of the input
@@ -449,6 +530,17 @@ namespace brick {
     inline Array1D<Type>
     axisMinimum(Array2D<Type> const& array0, size_t axis);
 
+
+    /**
+     * This function is equivalent to axisMinimum(), above, except that
+     * it accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Array1D<Type>
+    axisMinimum(Array2DExpression<Type, Derived> const& array0,
+                size_t axis);
+
     /**
      * This function returns an Array1D in which each element has the
      * value of the smallest element in one row or column of the input
@@ -517,6 +609,16 @@ namespace brick {
     axisSum(Array2D<Type> const& array0, size_t axis);
 
 
+    /**
+     * This function is equivalent to axisSum(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class ResultType, class Type, class Derived>
+    inline Array1D<ResultType>
+    axisSum(Array2DExpression<Type, Derived> const& array0, size_t axis);
+
+
     /**
      * This function returns an Array1D in which each element has the
      * sum of one row or column of the input Array2D.  The sum is taken
@@ -726,6 +828,18 @@ namespace brick {
     dot(Array1D<Type0> const& array0, Array1D<Type1> const& array1);
 
 
+    /**
+     * This function is equivalent to dot(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    inline Type2
+    dot(Array1DExpression<Type0, Derived0> const& array0,
+        Array1DExpression<Type1, Derived1> const& array1);
+
+
     /**
      * This function computes the inner product of two Vector2D instances.
      *
@@ -946,6 +1060,16 @@ namespace brick {
     ln(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to ln(), above, except that it accepts
+     * elementwise arithmetic expressions, such as (array0 - array1),
+     * which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    Array1D<Type>
+    ln(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns an array in which each element is the
      * natural logarithm of the corresponding element of its input.
@@ -960,6 +1084,16 @@ namespace brick {
     ln(Array2D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to ln(), above, except that it accepts
+     * elementwise arithmetic expressions, such as (array0 - array1),
+     * which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    Array2D<Type>
+    ln(Array2DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns an Array2D instance in which the value of
      * each element is the logical not of the corresponding element of
@@ -997,6 +1131,16 @@ namespace brick {
     inline Type1
     magnitude(Array1D<Type0> const& array0);
 
+
+    /**
+     * This function is equivalent to magnitude(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    magnitude(Array1DExpression<Type0, Derived> const& array0);
+
     /**
      * This function computes the magnitude of its input argument.  That
      * is, it computes the square root of the sum of the squares of the
@@ -1039,6 +1183,16 @@ namespace brick {
     magnitudeSquared(Array1D<Type0> const& array0);
 
 
+    /**
+     * This function is equivalent to magnitudeSquared(), above, except
+     * that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    magnitudeSquared(Array1DExpression<Type0, Derived> const& array0);
+
+
     /**
      * This function computes the square of the magnitude of its input
      * argument.  That is, it computes the sum of the squares of the
@@ -1097,6 +1251,18 @@ namespace brick {
                    Array2D<Type1> const& matrix0);
 
 
+    /**
+     * This function is equivalent to matrixMultiply(), above, except
+     * that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array1D<Type2>
+    matrixMultiply(Array1DExpression<Type0, Derived0> const& vector0,
+                   Array2DExpression<Type1, Derived1> const& matrix0);
+
+
     /**
      * This function computes a matrix * vector product.  Assuming the
      * first argument, matrix0, represents a matrix, and the and the
@@ -1123,6 +1289,18 @@ namespace brick {
                    Array1D<Type1> const& vector0);
 
 
+    /**
+     * This function is equivalent to matrixMultiply(), above, except
+     * that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array1D<Type2>
+    matrixMultiply(Array2DExpression<Type0, Derived0> const& matrix0,
+                   Array1DExpression<Type1, Derived1> const& vector0);
+
+
     /**
      * This function computes a matrix * matrix product.  That is,
      * the elements of the resulting array are the dot products of the
@@ -1146,6 +1324,18 @@ namespace brick {
                    Array2D<Type1> const& matrix1);
 
 
+    /**
+     * This function is equivalent to matrixMultiply(), above, except
+     * that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array2D<Type2>
+    matrixMultiply(Array2DExpression<Type0, Derived0> const& matrix0,
+                   Array2DExpression<Type1, Derived1> const& matrix1);
+
+
     // The next function is commented out because some environments use
     // #define directives for min() and max(), which don't obey
     // namespaces, and makes the code not compile if we define our own
@@ -1179,6 +1369,16 @@ namespace brick {
     maximum(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to maximum(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Type
+    maximum(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns a copy of the largest element in the input
      * Array1D instance, where largeness is defined by the return value
@@ -1217,6 +1417,16 @@ namespace brick {
     maximum(Array2D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to maximum(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Type
+    maximum(Array2DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns a copy of the largest element in the input
      * Array2D instance, where largeness is defined by the return value
@@ -1272,6 +1482,16 @@ namespace brick {
     mean(Array1D<Type0> const& array0);
 
 
+    /**
+     * This function is equivalent to mean(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    mean(Array1DExpression<Type0, Derived> const& array0);
+
+
     // The next function is commented out because some environments use
     // #define directives for min() and max(), which don't obey
     // namespaces, and makes the code not compile if we define our own
@@ -1305,6 +1525,16 @@ namespace brick {
     minimum(Array1D<Type> const& array0);
 
 
+    /**
+     * This function is equivalent to minimum(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type, class Derived>
+    inline Type
+    minimum(Array1DExpression<Type, Derived> const& array0);
+
+
     /**
      * This function returns a copy of the smallest element in the input
      * Array1D instance, where largeness is defined by the return value
@@ -1391,6 +1621,17 @@ namespace brick {
                           Array1D<Type> const& signal1);
 
 
+    /**
+     * This function is equivalent to normalizedCorrelation(), above,
+     * except that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type, class Derived0, class Derived1>
+    Type2
+    normalizedCorrelation(Array1DExpression<Type, Derived0> const& signal0,
+                          Array1DExpression<Type, Derived1> const& signal1);
+
+
     /**
      * This function returns an Array1D of the specified size and type
      * in which the value of every element is initialized to 1.
@@ -1443,6 +1684,18 @@ namespace brick {
     outerProduct(Array1D<Type0> const& array0, Array1D<Type1> const& array1);
 
 
+    /**
+     * This function is equivalent to outerProduct(), above, except that
+     * it accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type0, class Type1,
+              class Derived0, class Derived1>
+    Array2D<Type2>
+    outerProduct(Array1DExpression<Type0, Derived0> const& array0,
+                 Array1DExpression<Type1, Derived1> const& array1);
+
+
     /**
      * This function returns an Array1D in which the first element has
      * value equal to argument "start," and each subsequent element has
@@ -1544,6 +1797,16 @@ namespace brick {
     rms(Array1D<Type0> const& array0);
 
 
+    /**
+     * This function is equivalent to rms(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type1, class Type0, class Derived>
+    Type1
+    rms(Array1DExpression<Type0, Derived> const& array0);
+
+
     /**
      * rowIndices(rows, columns): Returns an Array2D in which each
      * element contains the index of its row.  For example:
@@ -1731,6 +1994,16 @@ namespace brick {
     standardDeviation(Array1D<Type0> const& array0);
 
 
+    /**
+     * This function is equivalent to standardDeviation(), above, except
+     * that it accepts elementwise arithmetic expressions, such as
+     * (array0 - array1), which are evaluated before the computation.
+     */
+    template <class Type0, class Type1, class Derived>
+    inline Type1
+    standardDeviation(Array1DExpression<Type0, Derived> const& array0);
+
+
     /**
      * This function computes the sum of the elements of its argument.
      * The summation is accumulated into a variable of type Type2,
@@ -1746,6 +2019,23 @@ namespace brick {
     sum(Array1D<Type> const& array0);
 
 
+    /**
+     * This function computes the sum of the elements of an
+     * elementwise arithmetic expression, such as (array0 * array1).
+     * The expression is evaluated on the fly, so no temporary array
+     * is allocated.  The summation is accumulated into a variable of
+     * type Type2, allowing the user to control the precision of the
+     * internal summation.
+     *
+     * @param expression This argument is the expression to be summed.
+     *
+     * @return The summation of all the elements of expression.
+     */
+    template <class Type2, class Type, class Derived>
+    Type2
+    sum(Array1DExpression<Type, Derived> const& expression);
+
+
     /**
      * This function computes the sum of those elements of its
      * argument which lie within a rectangular region of interest.
@@ -1774,6 +2064,18 @@ namespace brick {
         Index2D const& lowerRightCorner);
 
 
+    /**
+     * This function is equivalent to sum(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type2, class Type, class Derived>
+    Type2
+    sum(Array2DExpression<Type, Derived> const& array0,
+        Index2D const& upperLeftCorner,
+        Index2D const& lowerRightCorner);
+
+
     /**
      * This function returns an array made up of only those elements
      * of dataArray that correspond to indices in indexArray.  For
@@ -1909,6 +2211,16 @@ namespace brick {
     variance(Array1D<Type0> const& array0);
 
 
+    /**
+     * This function is equivalent to variance(), above, except that it
+     * accepts elementwise arithmetic expressions, such as (array0 -
+     * array1), which are evaluated before the computation.
+     */
+    template <class Type0, class Type1, class Derived>
+    inline Type1
+    variance(Array1DExpression<Type0, Derived> const& array0);
+
+
     /**
      * This function returns an Array1D of the specified size and type
      * in which the value of every element is zero.
@@ -1639,6 +1639,23 @@ namespace brick {
     }
 
 
+    // This function computes the sum of the elements of an
+    // elementwise arithmetic expression.
+    template <class Type2, class Type, class Derived>
+    Type2
+    sum(Array1DExpression<Type, Derived> const& expression)
+    {
+      typedef typename privateCode::Array1DNodeTraits<Type, Derived>::NodeType
+        NodeType;
+      const NodeType node(expression.getDerived());
+      Type2 result = static_cast<Type2>(0);
+      for(size_t index = 0; index < node.getSize(); ++index) {
+        result += node.getElement(index);
+      }
+      return result;
+    }
+
+
     // This function computes the sum of those elements of its
     // argument which lie within a rectangular region of interest.
     template <class Type2, class Type>
@@ -1775,6 +1792,279 @@ namespace brick {
       return result;
     }
 
+    // Overload of abs(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    Array1D<Type>
+    abs(Array1DExpression<Type, Derived> const& array0)
+    {
+      return abs(Array1D<Type>(array0));
+    }
+
+
+    // Overload of abs(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    Array2D<Type>
+    abs(Array2DExpression<Type, Derived> const& array0)
+    {
+      return abs(Array2D<Type>(array0));
+    }
+
+
+    // Overload of argmax(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline size_t
+    argmax(Array1DExpression<Type, Derived> const& array0)
+    {
+      return argmax(Array1D<Type>(array0));
+    }
+
+
+    // Overload of argmax2D(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Index2D
+    argmax2D(Array2DExpression<Type, Derived> const& array0)
+    {
+      return argmax2D(Array2D<Type>(array0));
+    }
+
+
+    // Overload of argmin(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline size_t
+    argmin(Array1DExpression<Type, Derived> const& array0)
+    {
+      return argmin(Array1D<Type>(array0));
+    }
+
+
+    // Overload of argmin2D(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Index2D
+    argmin2D(Array2DExpression<Type, Derived> const& array0)
+    {
+      return argmin2D(Array2D<Type>(array0));
+    }
+
+
+    // Overload of argsort(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    Array1D<size_t>
+    argsort(Array1DExpression<Type, Derived> const& array0)
+    {
+      return argsort(Array1D<Type>(array0));
+    }
+
+
+    // Overload of axisMaximum(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Array1D<Type>
+    axisMaximum(Array2DExpression<Type, Derived> const& array0,
+                size_t axis)
+    {
+      return axisMaximum(Array2D<Type>(array0), axis);
+    }
+
+
+    // Overload of axisMinimum(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Array1D<Type>
+    axisMinimum(Array2DExpression<Type, Derived> const& array0,
+                size_t axis)
+    {
+      return axisMinimum(Array2D<Type>(array0), axis);
+    }
+
+
+    // Overload of axisSum(), for elementwise arithmetic expressions.
+    template <class ResultType, class Type, class Derived>
+    inline Array1D<ResultType>
+    axisSum(Array2DExpression<Type, Derived> const& array0, size_t axis)
+    {
+      return axisSum<ResultType>(Array2D<Type>(array0), axis);
+    }
+
+
+    // Overload of dot(), for elementwise arithmetic expressions.
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    inline Type2
+    dot(Array1DExpression<Type0, Derived0> const& array0,
+        Array1DExpression<Type1, Derived1> const& array1)
+    {
+      return dot<Type2>(Array1D<Type0>(array0), Array1D<Type1>(array1));
+    }
+
+
+    // Overload of ln(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    Array1D<Type>
+    ln(Array1DExpression<Type, Derived> const& array0)
+    {
+      return ln(Array1D<Type>(array0));
+    }
+
+
+    // Overload of ln(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    Array2D<Type>
+    ln(Array2DExpression<Type, Derived> const& array0)
+    {
+      return ln(Array2D<Type>(array0));
+    }
+
+
+    // Overload of magnitude(), for elementwise arithmetic expressions.
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    magnitude(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return magnitude<Type1>(Array1D<Type0>(array0));
+    }
+
+
+    // Overload of magnitudeSquared(), for elementwise arithmetic expressions.
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    magnitudeSquared(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return magnitudeSquared<Type1>(Array1D<Type0>(array0));
+    }
+
+
+    // Overload of matrixMultiply(), for elementwise arithmetic expressions.
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array1D<Type2>
+    matrixMultiply(Array1DExpression<Type0, Derived0> const& vector0,
+                   Array2DExpression<Type1, Derived1> const& matrix0)
+    {
+      return matrixMultiply<Type2>(Array1D<Type0>(vector0),
+                                  Array2D<Type1>(matrix0));
+    }
+
+
+    // Overload of matrixMultiply(), for elementwise arithmetic expressions.
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array1D<Type2>
+    matrixMultiply(Array2DExpression<Type0, Derived0> const& matrix0,
+                   Array1DExpression<Type1, Derived1> const& vector0)
+    {
+      return matrixMultiply<Type2>(Array2D<Type0>(matrix0),
+                                  Array1D<Type1>(vector0));
+    }
+
+
+    // Overload of matrixMultiply(), for elementwise arithmetic expressions.
+    template <class Type2, class Type1, class Type0,
+              class Derived0, class Derived1>
+    Array2D<Type2>
+    matrixMultiply(Array2DExpression<Type0, Derived0> const& matrix0,
+                   Array2DExpression<Type1, Derived1> const& matrix1)
+    {
+      return matrixMultiply<Type2>(Array2D<Type0>(matrix0),
+                                  Array2D<Type1>(matrix1));
+    }
+
+
+    // Overload of maximum(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Type
+    maximum(Array1DExpression<Type, Derived> const& array0)
+    {
+      return maximum(Array1D<Type>(array0));
+    }
+
+
+    // Overload of maximum(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Type
+    maximum(Array2DExpression<Type, Derived> const& array0)
+    {
+      return maximum(Array2D<Type>(array0));
+    }
+
+
+    // Overload of mean(), for elementwise arithmetic expressions.
+    template <class Type1, class Type0, class Derived>
+    inline Type1
+    mean(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return mean<Type1>(Array1D<Type0>(array0));
+    }
+
+
+    // Overload of minimum(), for elementwise arithmetic expressions.
+    template <class Type, class Derived>
+    inline Type
+    minimum(Array1DExpression<Type, Derived> const& array0)
+    {
+      return minimum(Array1D<Type>(array0));
+    }
+
+
+    // Overload of normalizedCorrelation(), for elementwise arithmetic
+    // expressions.
+    template <class Type2, class Type, class Derived0, class Derived1>
+    Type2
+    normalizedCorrelation(Array1DExpression<Type, Derived0> const& signal0,
+                          Array1DExpression<Type, Derived1> const& signal1)
+    {
+      return normalizedCorrelation<Type2>(Array1D<Type>(signal0),
+                                           Array1D<Type>(signal1));
+    }
+
+
+    // Overload of outerProduct(), for elementwise arithmetic expressions.
+    template <class Type2, class Type0, class Type1,
+              class Derived0, class Derived1>
+    Array2D<Type2>
+    outerProduct(Array1DExpression<Type0, Derived0> const& array0,
+                 Array1DExpression<Type1, Derived1> const& array1)
+    {
+      return outerProduct<Type2>(Array1D<Type0>(array0),
+                                Array1D<Type1>(array1));
+    }
+
+
+    // Overload of rms(), for elementwise arithmetic expressions.
+    template <class Type1, class Type0, class Derived>
+    Type1
+    rms(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return rms<Type1>(Array1D<Type0>(array0));
+    }
+
+
+    // Overload of standardDeviation(), for elementwise arithmetic expressions.
+    template <class Type0, class Type1, class Derived>
+    inline Type1
+    standardDeviation(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return standardDeviation<Type0, Type1>(Array1D<Type0>(array0));
+    }
+
+
+    // Overload of sum(), for elementwise arithmetic expressions.
+    template <class Type2, class Type, class Derived>
+    Type2
+    sum(Array2DExpression<Type, Derived> const& array0,
+        Index2D const& upperLeftCorner,
+        Index2D const& lowerRightCorner)
+    {
+      return sum<Type2>(Array2D<Type>(array0), upperLeftCorner,
+                        lowerRightCorner);
+    }
+
+
+    // Overload of variance(), for elementwise arithmetic expressions.
+    template <class Type0, class Type1, class Derived>
+    inline Type1
+    variance(Array1DExpression<Type0, Derived> const& array0)
+    {
+      return variance<Type0, Type1>(Array1D<Type0>(array0));
+    }
+
   } // namespace numeric
 
 } // namespace brick
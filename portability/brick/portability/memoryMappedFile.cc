@@ -0,0 +1,249 @@
+/**
+***************************************************************************
+* @file brick/portability/memoryMappedFile.cc
+*
+* Source file defining a portable wrapper around read-only memory
+* mapped files.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#include <brick/portability/memoryMappedFile.hh>
+
+/* ===================== Common includes ===================== */
+
+#include <sstream>
+#include <brick/common/exception.hh>
+
+/* ===================== End common includes ===================== */
+
+#ifdef _WIN32
+
+/* ===================== Windows includes ===================== */
+
+#include <windows.h>
+
+/* ===================== End Windows includes ===================== */
+
+#else /* #ifdef _WIN32 */
+
+/* ===================== Linux includes ===================== */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ===================== End Linux includes ===================== */
+
+#endif /* #ifdef _WIN32 */
+
+
+/* ===================== Common code ===================== */
+
+namespace brick {
+
+  namespace portability {
+
+    MemoryMappedFile::
+    MemoryMappedFile()
+      : m_dataPtr(0),
+        m_referenceCount(0),
+        m_size(0)
+    {
+      // Empty.
+    }
+
+
+    MemoryMappedFile::
+    MemoryMappedFile(MemoryMappedFile const& other)
+      : m_dataPtr(other.m_dataPtr),
+        m_referenceCount(other.m_referenceCount),
+        m_size(other.m_size)
+    {
+      // Empty.
+    }
+
+
+    MemoryMappedFile::
+    ~MemoryMappedFile()
+    {
+      this->release();
+    }
+
+
+    MemoryMappedFile&
+    MemoryMappedFile::
+    operator=(MemoryMappedFile const& other)
+    {
+      if(&other != this) {
+        this->release();
+        m_dataPtr = other.m_dataPtr;
+        m_referenceCount = other.m_referenceCount;
+        m_size = other.m_size;
+      }
+      return *this;
+    }
+
+  } // namespace portability
+
+} // namespace brick
+
+/* ===================== End common code ===================== */
+
+
+#ifdef _WIN32
+
+/* ===================== Windows code ===================== */
+
+namespace brick {
+
+  namespace portability {
+
+    MemoryMappedFile::
+    MemoryMappedFile(std::string const& fileName)
+      : m_dataPtr(0),
+        m_referenceCount(0),
+        m_size(0)
+    {
+      HANDLE fileHandle = CreateFileA(
+        fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, 0);
+      if(fileHandle == INVALID_HANDLE_VALUE) {
+        std::ostringstream message;
+        message << "Couldn't open file " << fileName << " for reading.";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      LARGE_INTEGER fileSize;
+      if(!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        std::ostringstream message;
+        message << "Couldn't get the size of file " << fileName << ".";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      if(fileSize.QuadPart == 0) {
+        CloseHandle(fileHandle);
+        return;
+      }
+
+      // The view keeps the file open, so both handles can be closed
+      // as soon as it exists.
+      HANDLE mappingHandle = CreateFileMappingA(
+        fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+      void* dataPtr = 0;
+      if(mappingHandle != 0) {
+        dataPtr = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mappingHandle);
+      }
+      CloseHandle(fileHandle);
+      if(dataPtr == 0) {
+        std::ostringstream message;
+        message << "Couldn't map file " << fileName << " into memory.";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      m_dataPtr = dataPtr;
+      m_size = static_cast<std::size_t>(fileSize.QuadPart);
+      m_referenceCount.reset(1, true);
+    }
+
+
+    void
+    MemoryMappedFile::
+    release()
+    {
+      if(m_referenceCount.release() && m_dataPtr != 0) {
+        UnmapViewOfFile(m_dataPtr);
+      }
+      m_dataPtr = 0;
+      m_size = 0;
+      m_referenceCount.reset(0);
+    }
+
+  } // namespace portability
+
+} // namespace brick
+
+/* ===================== End Windows code ===================== */
+
+#else /* #ifdef _WIN32 */
+
+/* ===================== Linux code ===================== */
+
+namespace brick {
+
+  namespace portability {
+
+    MemoryMappedFile::
+    MemoryMappedFile(std::string const& fileName)
+      : m_dataPtr(0),
+        m_referenceCount(0),
+        m_size(0)
+    {
+      int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+      if(fileDescriptor < 0) {
+        std::ostringstream message;
+        message << "Couldn't open file " << fileName << " for reading.";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      struct stat statBuf;
+      if(fstat(fileDescriptor, &statBuf) != 0) {
+        close(fileDescriptor);
+        std::ostringstream message;
+        message << "Couldn't get the size of file " << fileName << ".";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      if(statBuf.st_size == 0) {
+        close(fileDescriptor);
+        return;
+      }
+
+      // The mapping keeps the file open, so the descriptor can be
+      // closed as soon as it exists.
+      std::size_t size = static_cast<std::size_t>(statBuf.st_size);
+      void* dataPtr = mmap(0, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+      close(fileDescriptor);
+      if(dataPtr == MAP_FAILED) {
+        std::ostringstream message;
+        message << "Couldn't map file " << fileName << " into memory.";
+        BRICK_THROW(brick::common::IOException,
+                    "MemoryMappedFile::MemoryMappedFile()",
+                    message.str().c_str());
+      }
+      m_dataPtr = dataPtr;
+      m_size = size;
+      m_referenceCount.reset(1, true);
+    }
+
+
+    void
+    MemoryMappedFile::
+    release()
+    {
+      if(m_referenceCount.release() && m_dataPtr != 0) {
+        munmap(const_cast<void*>(m_dataPtr), m_size);
+      }
+      m_dataPtr = 0;
+      m_size = 0;
+      m_referenceCount.reset(0);
+    }
+
+  } // namespace portability
+
+} // namespace brick
+
+/* ===================== End Linux code ===================== */
+
+#endif /* #ifdef _WIN32 */
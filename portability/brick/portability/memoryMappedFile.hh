@@ -0,0 +1,116 @@
+/**
+***************************************************************************
+* @file brick/portability/memoryMappedFile.hh
+*
+* Header file declaring a portable wrapper around read-only memory
+* mapped files.
+*
+* Copyright (C) 2026 David LaRose, dlr@davidlarose.com
+* See accompanying file, LICENSE.TXT, for details.
+*
+***************************************************************************
+**/
+
+#ifndef BRICK_PORTABILITY_MEMORYMAPPEDFILE_HH
+#define BRICK_PORTABILITY_MEMORYMAPPEDFILE_HH
+
+#include <cstddef>
+#include <string>
+#include <brick/common/referenceCount.hh>
+
+namespace brick {
+
+  namespace portability {
+
+    /**
+     ** This class maps the contents of a file into memory, read-only.
+     ** The mapping is shared, so every process that maps the same
+     ** file sees the same physical pages.  Copies of a
+     ** MemoryMappedFile instance share the mapping, which is released
+     ** when the last copy is destroyed.  Copies may be made and
+     ** destroyed concurrently by different threads.
+     **/
+    class MemoryMappedFile {
+    public:
+
+      /**
+       * The default constructor creates an instance that maps
+       * nothing.
+       */
+      MemoryMappedFile();
+
+
+      /**
+       * This constructor maps the specified file.
+       *
+       * @param fileName This argument is the name of the file to be
+       * mapped.  It must exist and be readable.  Changing the file
+       * while it is mapped has undefined results.
+       */
+      explicit
+      MemoryMappedFile(std::string const& fileName);
+
+
+      /**
+       * The copy constructor shares the mapping with other.
+       *
+       * @param other This argument is the instance to be copied.
+       */
+      MemoryMappedFile(MemoryMappedFile const& other);
+
+
+      /**
+       * The destructor releases the mapping if this is the last
+       * instance using it.
+       */
+      ~MemoryMappedFile();
+
+
+      /**
+       * The assignment operator releases the current mapping, if
+       * any, and shares the mapping of other.
+       *
+       * @param other This argument is the instance to be copied.
+       *
+       * @return The return value is a reference to *this.
+       */
+      MemoryMappedFile&
+      operator=(MemoryMappedFile const& other);
+
+
+      /**
+       * This member function returns the address of the first byte
+       * of the file.  The address is aligned to at least the system
+       * page size.
+       *
+       * @return The return value is the address of the mapped data,
+       * or 0 if nothing is mapped, or the file is empty.
+       */
+      void const*
+      getData() const {return m_dataPtr;}
+
+
+      /**
+       * This member function returns the size of the mapped file.
+       *
+       * @return The return value is the number of bytes that can be
+       * read starting at getData().
+       */
+      std::size_t
+      getSize() const {return m_size;}
+
+    private:
+
+      void
+      release();
+
+      void const* m_dataPtr;
+      brick::common::ReferenceCount m_referenceCount;
+      std::size_t m_size;
+    };
+
+  } // namespace portability
+
+} // namespace brick
+
+#endif /* #ifndef BRICK_PORTABILITY_MEMORYMAPPEDFILE_HH */